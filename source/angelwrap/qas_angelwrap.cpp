@@ -31,8 +31,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <list>
 
+// number of allocations made by the script engines, for profiling
+static unsigned int qasNumAllocations;
+
 static void *qasAlloc( size_t size )
 {
+	qasNumAllocations++;
 	return QAS_Malloc( size );
 }
 
@@ -51,6 +55,9 @@ typedef std::map<asIScriptEngine *, qasContextList> qasEngineContextMap;
 
 qasEngineContextMap contexts;
 
+// contexts owned by the caller, never handed out by qasAcquireContext
+qasEngineContextMap privateContexts;
+
 // ============================================================================
 
 static void qasMessageCallback( const asSMessageInfo *msg )
@@ -138,29 +145,35 @@ asIScriptEngine *qasCreateEngine( bool *asMaxPortability )
 	return engine;
 }
 
-void qasReleaseEngine( asIScriptEngine *engine )
+static void qasReleaseEngineContexts( qasEngineContextMap &ctxMap, asIScriptEngine *engine )
 {
-	if( !engine )
+	qasEngineContextMap::iterator it = ctxMap.find( engine );
+	if( it == ctxMap.end() )
 		return;
 
-	// release all contexts linked to this engine
-	qasContextList &ctxList = contexts[engine];
-	for( qasContextList::iterator it = ctxList.begin(); it != ctxList.end(); it++ )
+	qasContextList &ctxList = it->second;
+	for( qasContextList::iterator ctxIt = ctxList.begin(); ctxIt != ctxList.end(); ctxIt++ )
 	{
-		asIScriptContext *ctx = *it;
+		asIScriptContext *ctx = *ctxIt;
 		ctx->Release();
 	}
-	ctxList.clear();
 
-	qasEngineContextMap::iterator it = contexts.find( engine );
-	if( it != contexts.end() ) {
-		contexts.erase( it );
-	}
+	ctxMap.erase( it );
+}
+
+void qasReleaseEngine( asIScriptEngine *engine )
+{
+	if( !engine )
+		return;
+
+	// release all contexts linked to this engine
+	qasReleaseEngineContexts( contexts, engine );
+	qasReleaseEngineContexts( privateContexts, engine );
 
 	engine->Release();
 }
 
-static asIScriptContext *qasCreateContext( asIScriptEngine *engine )
+static asIScriptContext *qasNewContext( asIScriptEngine *engine, qasEngineContextMap &ctxMap )
 {
 	asIScriptContext *ctx;
 	int error;
@@ -186,20 +199,31 @@ static asIScriptContext *qasCreateContext( asIScriptEngine *engine )
 		return NULL;
 	}
 
-	qasContextList &ctxList = contexts[engine];
+	qasContextList &ctxList = ctxMap[engine];
 	ctxList.push_back( ctx );
 
 	return ctx;
 }
 
+/*
+* qasCreateContext
+*
+* Creates a new context which is never shared through qasAcquireContext, so the
+* caller may keep it prepared between calls. Free it with qasReleaseContext.
+*/
+asIScriptContext *qasCreateContext( asIScriptEngine *engine )
+{
+	return qasNewContext( engine, privateContexts );
+}
+
 void qasReleaseContext( asIScriptContext *ctx )
 {
 	if( !ctx )
 		return;
 
 	asIScriptEngine *engine = ctx->GetEngine();
-	qasContextList &ctxList = contexts[engine];
-	ctxList.remove( ctx );
+	contexts[engine].remove( ctx );
+	privateContexts[engine].remove( ctx );
 
 	ctx->Release();
 }
@@ -219,7 +243,7 @@ asIScriptContext *qasAcquireContext( asIScriptEngine *engine )
 	}
 
 	// if no context was available, create a new one
-	return qasCreateContext( engine );
+	return qasNewContext( engine, contexts );
 }
 
 asIScriptContext *qasGetActiveContext( void )
@@ -227,6 +251,11 @@ asIScriptContext *qasGetActiveContext( void )
 	return asGetActiveContext();
 }
 
+unsigned int qasGetAllocationCount( void )
+{
+	return qasNumAllocations;
+}
+
 /*************************************
 * Array tools
 **************************************/
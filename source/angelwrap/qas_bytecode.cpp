@@ -0,0 +1,283 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "qas_precompiled.h"
+
+// compiled modules are cached on disk, so that scripts which didn't change don't
+// have to be parsed and compiled on every map load
+
+#define QAS_BYTECODE_MAGIC		"QASB"
+#define QAS_BYTECODE_VERSION	1
+
+typedef struct
+{
+	char magic[4];
+	int version;
+	uint64_t key;
+} qasByteCodeHeader_t;
+
+// ============================================================================
+
+#define QAS_HASH_OFFSET_BASIS	UINT64_C( 0xcbf29ce484222325 )
+#define QAS_HASH_PRIME			UINT64_C( 0x100000001b3 )
+
+/*
+* qasHash
+*
+* 64-bit FNV-1a
+*/
+static uint64_t qasHash( uint64_t hash, const void *data, size_t len )
+{
+	const uint8_t *p = ( const uint8_t * )data;
+
+	while( len-- ) {
+		hash ^= *p++;
+		hash *= QAS_HASH_PRIME;
+	}
+	return hash;
+}
+
+static inline uint64_t qasHashString( uint64_t hash, const char *str )
+{
+	// include the terminating zero so that "ab"+"c" differs from "a"+"bc"
+	return str ? qasHash( hash, str, strlen( str ) + 1 ) : qasHash( hash, "", 1 );
+}
+
+static inline uint64_t qasHashFunction( uint64_t hash, const asIScriptFunction *func )
+{
+	return func ? qasHashString( hash, func->GetDeclaration( true, true, true ) ) : hash;
+}
+
+/*
+* qasEngineSignature
+*
+* Hashes everything the application has registered with the engine. Saved bytecode
+* refers to the registered interface by name, so any change to it has to invalidate
+* the cache, even if scripts themselves stay the same.
+*/
+static uint64_t qasEngineSignature( asIScriptEngine *engine )
+{
+	asUINT i, j;
+	uint64_t hash = QAS_HASH_OFFSET_BASIS;
+
+	hash = qasHashString( hash, asGetLibraryVersion() );
+	hash = qasHashString( hash, asGetLibraryOptions() );
+
+	for( i = 0; i < engine->GetObjectTypeCount(); i++ ) {
+		asIObjectType *type = engine->GetObjectTypeByIndex( i );
+		asDWORD flags = type->GetFlags();
+		asUINT size = type->GetSize();
+
+		hash = qasHashString( hash, type->GetNamespace() );
+		hash = qasHashString( hash, type->GetName() );
+		hash = qasHash( hash, &flags, sizeof( flags ) );
+		hash = qasHash( hash, &size, sizeof( size ) );
+
+		for( j = 0; j < type->GetFactoryCount(); j++ )
+			hash = qasHashFunction( hash, type->GetFactoryByIndex( j ) );
+		for( j = 0; j < type->GetBehaviourCount(); j++ )
+			hash = qasHashFunction( hash, type->GetBehaviourByIndex( j, NULL ) );
+		for( j = 0; j < type->GetMethodCount(); j++ )
+			hash = qasHashFunction( hash, type->GetMethodByIndex( j ) );
+		for( j = 0; j < type->GetPropertyCount(); j++ )
+			hash = qasHashString( hash, type->GetPropertyDeclaration( j, true ) );
+	}
+
+	for( i = 0; i < engine->GetGlobalFunctionCount(); i++ )
+		hash = qasHashFunction( hash, engine->GetGlobalFunctionByIndex( i ) );
+
+	for( i = 0; i < engine->GetFuncdefCount(); i++ )
+		hash = qasHashFunction( hash, engine->GetFuncdefByIndex( i ) );
+
+	for( i = 0; i < engine->GetGlobalPropertyCount(); i++ ) {
+		const char *name, *nameSpace;
+		int typeId;
+		bool isConst;
+
+		if( engine->GetGlobalPropertyByIndex( i, &name, &nameSpace, &typeId, &isConst ) < 0 )
+			continue;
+
+		hash = qasHashString( hash, nameSpace );
+		hash = qasHashString( hash, name );
+		hash = qasHashString( hash, engine->GetTypeDeclaration( typeId, true ) );
+		hash = qasHash( hash, &isConst, sizeof( isConst ) );
+	}
+
+	for( i = 0; i < engine->GetEnumCount(); i++ ) {
+		int enumTypeId;
+		const char *enumName = engine->GetEnumByIndex( i, &enumTypeId );
+
+		hash = qasHashString( hash, enumName );
+		for( j = 0; j < (asUINT)engine->GetEnumValueCount( enumTypeId ); j++ ) {
+			int value;
+			hash = qasHashString( hash, engine->GetEnumValueByIndex( enumTypeId, j, &value ) );
+			hash = qasHash( hash, &value, sizeof( value ) );
+		}
+	}
+
+	for( i = 0; i < engine->GetTypedefCount(); i++ ) {
+		int typeId;
+		hash = qasHashString( hash, engine->GetTypedefByIndex( i, &typeId ) );
+		hash = qasHashString( hash, engine->GetTypeDeclaration( typeId, true ) );
+	}
+
+	return hash;
+}
+
+/*
+* qasByteCodeKey
+*
+* Returns a key that identifies a module built from the given script sections in the given engine.
+*/
+uint64_t qasByteCodeKey( asIScriptEngine *engine, unsigned int numSections, const char **names, const char **sections )
+{
+	unsigned int i;
+	uint64_t hash;
+
+	if( !engine )
+		return 0;
+
+	hash = qasEngineSignature( engine );
+
+	hash = qasHash( hash, &numSections, sizeof( numSections ) );
+	for( i = 0; i < numSections; i++ ) {
+		hash = qasHashString( hash, names ? names[i] : NULL );
+		hash = qasHashString( hash, sections[i] );
+	}
+
+	return hash;
+}
+
+// ============================================================================
+
+class qasFileStream : public asIBinaryStream
+{
+	int filenum;
+	bool error;
+
+public:
+	qasFileStream( int filenum_ ) : filenum( filenum_ ), error( false ) {}
+
+	bool HasError( void ) const { return error; }
+
+	void Read( void *ptr, asUINT size )
+	{
+		if( error )
+			return;
+
+		if( trap_FS_Read( ptr, size, filenum ) != (int)size ) {
+			// AngelScript doesn't check for read errors, so feed it zeros and fail afterwards
+			memset( ptr, 0, size );
+			error = true;
+		}
+	}
+
+	void Write( const void *ptr, asUINT size )
+	{
+		if( error )
+			return;
+
+		if( trap_FS_Write( ptr, size, filenum ) != (int)size )
+			error = true;
+	}
+};
+
+/*
+* qasLoadByteCode
+*
+* Loads the module from the cache file if the file has been saved for the same key.
+*/
+bool qasLoadByteCode( asIScriptModule *module, const char *filename, uint64_t key )
+{
+	int filenum;
+	int length, error;
+	qasByteCodeHeader_t header;
+
+	if( !module || !key )
+		return false;
+
+	length = trap_FS_FOpenFile( filename, &filenum, FS_READ|FS_CACHE );
+	if( length == -1 )
+		return false;
+
+	if( length <= (int)sizeof( header )
+		|| trap_FS_Read( &header, sizeof( header ), filenum ) != (int)sizeof( header )
+		|| memcmp( header.magic, QAS_BYTECODE_MAGIC, sizeof( header.magic ) )
+		|| header.version != QAS_BYTECODE_VERSION
+		|| header.key != key ) {
+		trap_FS_FCloseFile( filenum );
+		return false;
+	}
+
+	qasFileStream stream( filenum );
+	error = module->LoadByteCode( &stream );
+
+	trap_FS_FCloseFile( filenum );
+
+	if( error < 0 || stream.HasError() ) {
+		QAS_Printf( S_COLOR_YELLOW "Failed to load bytecode from %s\n", filename );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* qasSaveByteCode
+*/
+bool qasSaveByteCode( asIScriptModule *module, const char *filename, uint64_t key )
+{
+	int filenum;
+	int error;
+	qasByteCodeHeader_t header;
+
+	if( !module || !key )
+		return false;
+
+	if( trap_FS_FOpenFile( filename, &filenum, FS_WRITE|FS_CACHE ) == -1 ) {
+		QAS_Printf( S_COLOR_YELLOW "Could not open %s for writing\n", filename );
+		return false;
+	}
+
+	// write an invalid header first so that a partially written file is never loaded
+	memset( &header, 0, sizeof( header ) );
+	trap_FS_Write( &header, sizeof( header ), filenum );
+
+	qasFileStream stream( filenum );
+	error = module->SaveByteCode( &stream );
+
+	if( error >= 0 && !stream.HasError() ) {
+		memcpy( header.magic, QAS_BYTECODE_MAGIC, sizeof( header.magic ) );
+		header.version = QAS_BYTECODE_VERSION;
+		header.key = key;
+
+		trap_FS_Seek( filenum, 0, FS_SEEK_SET );
+		trap_FS_Write( &header, sizeof( header ), filenum );
+	}
+
+	trap_FS_FCloseFile( filenum );
+
+	if( error < 0 || stream.HasError() ) {
+		QAS_Printf( S_COLOR_YELLOW "Failed to save bytecode to %s\n", filename );
+		return false;
+	}
+
+	return true;
+}
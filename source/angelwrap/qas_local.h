@@ -74,9 +74,11 @@ void QAS_Error( const char *format, ... );
 /******* C++ objects *******/
 asIScriptEngine *qasCreateEngine( bool *asMaxPortability );
 asIScriptContext *qasAcquireContext( asIScriptEngine *engine );
+asIScriptContext *qasCreateContext( asIScriptEngine *engine );
 void qasReleaseContext( asIScriptContext *ctx );
 void qasReleaseEngine( asIScriptEngine *engine );
 asIScriptContext *qasGetActiveContext( void );
+unsigned int qasGetAllocationCount( void );
 
 // array tools
 CScriptArrayInterface *qasCreateArrayCpp( unsigned int length, void *ot );
@@ -95,4 +97,9 @@ void qasReleaseDictionaryCpp( CScriptDictionaryInterface *dict );
 CScriptAnyInterface *qasCreateAnyCpp( asIScriptEngine *engine );
 void qasReleaseAnyCpp( CScriptAnyInterface *any );
 
+// bytecode cache
+uint64_t qasByteCodeKey( asIScriptEngine *engine, unsigned int numSections, const char **names, const char **sections );
+bool qasLoadByteCode( asIScriptModule *module, const char *filename, uint64_t key );
+bool qasSaveByteCode( asIScriptModule *module, const char *filename, uint64_t key );
+
 #endif // __QAS_LOCAL_H__
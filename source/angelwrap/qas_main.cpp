@@ -39,8 +39,10 @@ void QAS_InitAngelExport( void )
 	angelExport.asReleaseEngine = qasReleaseEngine;
 
 	angelExport.asAcquireContext = qasAcquireContext;
+	angelExport.asCreateContext = qasCreateContext;
 	angelExport.asReleaseContext = qasReleaseContext;
 	angelExport.asGetActiveContext = qasGetActiveContext;
+	angelExport.asGetAllocationCount = qasGetAllocationCount;
 
 	angelExport.asStringFactoryBuffer = qasStringFactoryBuffer;
 	angelExport.asStringRelease = qasStringRelease;
@@ -54,6 +56,10 @@ void QAS_InitAngelExport( void )
 
 	angelExport.asCreateAnyCpp = qasCreateAnyCpp;
 	angelExport.asReleaseAnyCpp = qasReleaseAnyCpp;
+
+	angelExport.asByteCodeKey = qasByteCodeKey;
+	angelExport.asLoadByteCode = qasLoadByteCode;
+	angelExport.asSaveByteCode = qasSaveByteCode;
 }
 
 int QAS_API( void )
@@ -21,7 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef __QAS_PUBLIC_H__
 #define __QAS_PUBLIC_H__
 
-#define	ANGELWRAP_API_VERSION   14
+#define	ANGELWRAP_API_VERSION   16
 
 typedef struct
 {
@@ -46,6 +46,13 @@ typedef struct
 	void ( *Cmd_RemoveCommand )( const char *cmd_name );
 	void ( *Cmd_ExecuteText )( int exec_when, const char *text );
 
+	// filesystem access for the bytecode cache
+	int ( *FS_FOpenFile )( const char *filename, int *filenum, int mode );
+	int ( *FS_Read )( void *buffer, size_t len, int file );
+	int ( *FS_Write )( const void *buffer, size_t len, int file );
+	int ( *FS_Seek )( int file, int offset, int whence );
+	void ( *FS_FCloseFile )( int file );
+
 	// managed memory allocation
 	struct mempool_s *( *Mem_AllocPool )( const char *name, const char *filename, int fileline );
 	void *( *Mem_Alloc )( struct mempool_s *pool, size_t size, const char *filename, int fileline );
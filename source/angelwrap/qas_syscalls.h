@@ -102,6 +102,31 @@ static inline void trap_Cmd_ExecuteText( int exec_when, char *text )
 	ANGELWRAP_IMPORT.Cmd_ExecuteText( exec_when, text );
 }
 
+static inline int trap_FS_FOpenFile( const char *filename, int *filenum, int mode )
+{
+	return ANGELWRAP_IMPORT.FS_FOpenFile( filename, filenum, mode );
+}
+
+static inline int trap_FS_Read( void *buffer, size_t len, int file )
+{
+	return ANGELWRAP_IMPORT.FS_Read( buffer, len, file );
+}
+
+static inline int trap_FS_Write( const void *buffer, size_t len, int file )
+{
+	return ANGELWRAP_IMPORT.FS_Write( buffer, len, file );
+}
+
+static inline int trap_FS_Seek( int file, int offset, int whence )
+{
+	return ANGELWRAP_IMPORT.FS_Seek( file, offset, whence );
+}
+
+static inline void trap_FS_FCloseFile( int file )
+{
+	ANGELWRAP_IMPORT.FS_FCloseFile( file );
+}
+
 static inline struct mempool_s *trap_MemAllocPool( const char *name, const char *filename, int fileline )
 {
 	return ANGELWRAP_IMPORT.Mem_AllocPool( name, filename, fileline );
@@ -206,7 +206,15 @@ void CG_ConfigString( int i, const char *s )
 */
 static void CG_SC_Scoreboard( void )
 {
-	SCR_UpdateScoreboardMessage( trap_Cmd_Argv( 1 ) );
+	// demos recorded before scoreboard deltas
+	if( trap_Cmd_Argc() < 5 )
+	{
+		SCR_UpdateScoreboardMessage( trap_Cmd_Argv( 1 ) );
+		return;
+	}
+
+	SCR_ParseScoreboardMessage( strtoul( trap_Cmd_Argv( 1 ), NULL, 10 ), strtoul( trap_Cmd_Argv( 2 ), NULL, 10 ),
+		atoi( trap_Cmd_Argv( 3 ) ) != 0, trap_Cmd_Argv( 4 ) );
 }
 
 /*
@@ -315,9 +315,51 @@ static int CG_GetStunned( const void *parameter )
 	return cg.predictedPlayerState.pmove.stats[PM_STAT_STUN];
 }
 
+#define MAX_HUD_CVARS 32
+
+static struct
+{
+	const char *name;
+	cvar_t *var;
+} cg_hudCvars[MAX_HUD_CVARS];
+static int cg_numHudCvars;
+
+/*
+* CG_HudCvar
+*
+* HUD scripts read the same few cvars every frame, so keep their cvar_t pointers
+* instead of looking them up by name each time. Names are the static strings
+* from the references table, so comparing pointers is enough.
+*/
+static cvar_t *CG_HudCvar( const char *name )
+{
+	int i;
+	cvar_t *var;
+
+	for( i = 0; i < cg_numHudCvars; i++ )
+	{
+		if( cg_hudCvars[i].name == name )
+			return cg_hudCvars[i].var;
+	}
+
+	// not registered yet, try again next time
+	var = trap_Cvar_Get( name, NULL, 0 );
+	if( !var )
+		return NULL;
+
+	if( cg_numHudCvars < MAX_HUD_CVARS )
+	{
+		cg_hudCvars[cg_numHudCvars].name = name;
+		cg_hudCvars[cg_numHudCvars].var = var;
+		cg_numHudCvars++;
+	}
+	return var;
+}
+
 static int CG_GetCvar( const void *parameter )
 {
-	return trap_Cvar_Value( (const char *)parameter );
+	const cvar_t *var = CG_HudCvar( (const char *)parameter );
+	return var ? var->value : 0;
 }
 
 static int CG_GetDamageIndicatorDirValue( const void *parameter )
@@ -404,19 +446,21 @@ static int CG_IsDemoPlaying( const void *parameter )
 
 static int CG_DownloadInProgress( const void *parameter )
 {
-	const char *str;
+	const cvar_t *var = CG_HudCvar( "cl_download_name" );
 
-	str = trap_Cvar_String( "cl_download_name" );
-	if( str[0] )
+	if( var && var->string[0] )
 		return 1;
 	return 0;
 }
 
 static int CG_GetShowItemTimers( const void *parameter )
 {
+	const cvar_t *var = CG_HudCvar( (const char *)parameter );
+	int value = var ? var->integer : 0;
+
 	if( cgs.tv )
-		return (int)trap_Cvar_Value( (char *)parameter ) & 2;
-	return (int)trap_Cvar_Value( (char *)parameter ) & 1;
+		return value & 2;
+	return value & 1;
 }
 
 static int CG_GetItemTimer( const void *parameter )
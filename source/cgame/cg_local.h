@@ -868,6 +868,7 @@ void CG_ScoresOn_f( void );
 void CG_ScoresOff_f( void );
 bool CG_ExecuteScoreboardTemplateLayout( char *s );
 void SCR_UpdateScoreboardMessage( const char *string );
+void SCR_ParseScoreboardMessage( unsigned int baseline, unsigned int sequence, bool more, const char *string );
 void SCR_UpdatePlayerStatsMessage( const char *string );
 bool CG_IsScoreboardShown( void );
 
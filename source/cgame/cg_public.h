@@ -43,7 +43,7 @@ typedef void ( *fdrawchar_t )( int x, int y, int w, int h, float s1, float t1, f
 
 // cg_public.h -- client game dll information visible to engine
 
-#define	CGAME_API_VERSION   99
+#define	CGAME_API_VERSION   100
 
 //
 // structs and variables shared with the main engine
@@ -146,6 +146,8 @@ typedef struct
 
 	void ( *GetConfigString )( int i, char *str, int size );
 	unsigned int ( *Milliseconds )( void );
+	void ( *Prof_Begin )( const char *name );
+	void ( *Prof_End )( void );
 	bool ( *DownloadRequest )( const char *filename, bool requestpak );
 
 	unsigned int (* Hash_BlockChecksum )( const uint8_t * data, size_t len );
@@ -213,7 +213,30 @@ static int SCB_DrawPlayerStats( int x, int y, struct qfontface_s *font )
 // player scoreboards
 // ====================================================
 
-static char scoreboardString[MAX_STRING_CHARS];
+static char scoreboardString[SCOREBOARD_MSG_MAXSIZE];
+static unsigned int scoreboardSeq;		// sequence number of scoreboardString, the baseline of deltas
+										// the game numbers scoreboards for all clients from one counter,
+										// so deltas meant for another POV never match it
+
+// chunks of the scoreboard message being received
+static char scoreboardPending[SCOREBOARD_MSG_MAXSIZE];
+static unsigned int scoreboardPendingSeq;
+static bool scoreboardPendingOverflow;
+static bool scoreboardRequested;
+
+#define SCR_MAX_TOKENS	( SCOREBOARD_MSG_MAXSIZE / 2 )
+
+typedef struct
+{
+	char buffer[SCOREBOARD_MSG_MAXSIZE];
+	int numTokens;
+	const char *tokens[SCR_MAX_TOKENS];
+	int numRows;
+	int rows[SCR_MAX_TOKENS + 1];	// first token of each row, the last one ends the list
+} scr_scoreboardtokens_t;
+
+static scr_scoreboardtokens_t scbBaseline, scbDelta;
+static const char *scbRow[SCR_MAX_TOKENS];
 
 /*
 * SCR_ParseToken
@@ -1037,6 +1060,171 @@ void SCR_UpdateScoreboardMessage( const char *string )
 	Q_strncpyz( scoreboardString, string, sizeof( scoreboardString ) );
 }
 
+/*
+* SCR_TokenizeScoreboard
+*/
+static void SCR_TokenizeScoreboard( scr_scoreboardtokens_t *scb, const char *string )
+{
+	char *p;
+
+	Q_strncpyz( scb->buffer, string, sizeof( scb->buffer ) );
+	scb->numTokens = 0;
+	scb->numRows = 0;
+
+	p = scb->buffer;
+	while( scb->numTokens < SCR_MAX_TOKENS )
+	{
+		while( *p && *p <= ' ' )
+			*p++ = '\0';
+		if( !*p )
+			break;
+
+		if( *p == '&' )
+			scb->rows[scb->numRows++] = scb->numTokens;
+
+		if( scb->numRows )
+			scb->tokens[scb->numTokens++] = p;
+
+		while( *p > ' ' )
+			p++;
+	}
+
+	scb->rows[scb->numRows] = scb->numTokens;
+}
+
+/*
+* SCR_AppendScoreboardTokens
+*/
+static void SCR_AppendScoreboardTokens( char *string, size_t *len, const char **tokens, int numTokens )
+{
+	int i;
+	size_t tokenlen;
+
+	for( i = 0; i < numTokens; i++ )
+	{
+		tokenlen = strlen( tokens[i] );
+		if( *len + tokenlen + 1 >= SCOREBOARD_MSG_MAXSIZE )
+			return;
+
+		memcpy( string + *len, tokens[i], tokenlen );
+		*len += tokenlen;
+		string[( *len )++] = ' ';
+		string[*len] = '\0';
+	}
+}
+
+/*
+* SCR_ApplyScoreboardDelta
+*
+* See G_SendScoreboardMessage for the format of deltas.
+*/
+static void SCR_ApplyScoreboardDelta( const char *baseline, const char *delta, char *string )
+{
+	int i, j, k, n;
+	int first, last, baseFirst, numTokens;
+	const char *op;
+	size_t len;
+
+	SCR_TokenizeScoreboard( &scbBaseline, baseline );
+	SCR_TokenizeScoreboard( &scbDelta, delta );
+
+	len = 0;
+	string[0] = '\0';
+
+	for( i = 0; i < scbDelta.numRows; i++ )
+	{
+		first = scbDelta.rows[i];
+		last = scbDelta.rows[i+1];
+		op = scbDelta.tokens[first];
+
+		if( op[1] == '=' )
+		{
+			// unchanged rows
+			k = atoi( op + 2 );
+			op = strchr( op, ',' );
+			n = op ? atoi( op + 1 ) : 0;
+
+			for( j = k; j >= 0 && j < k + n && j < scbBaseline.numRows; j++ )
+			{
+				baseFirst = scbBaseline.rows[j];
+				SCR_AppendScoreboardTokens( string, &len, scbBaseline.tokens + baseFirst, scbBaseline.rows[j+1] - baseFirst );
+			}
+		}
+		else if( op[1] == '~' )
+		{
+			// changed values of a row
+			k = atoi( op + 2 );
+			if( k < 0 || k >= scbBaseline.numRows )
+				continue;
+
+			baseFirst = scbBaseline.rows[k];
+			numTokens = scbBaseline.rows[k+1] - baseFirst;
+			memcpy( scbRow, scbBaseline.tokens + baseFirst, numTokens * sizeof( *scbRow ) );
+
+			for( j = first + 1; j + 1 < last; j += 2 )
+			{
+				n = atoi( scbDelta.tokens[j] );
+				if( n > 0 && n < numTokens )
+					scbRow[n] = scbDelta.tokens[j+1];
+			}
+
+			SCR_AppendScoreboardTokens( string, &len, scbRow, numTokens );
+		}
+		else
+		{
+			SCR_AppendScoreboardTokens( string, &len, scbDelta.tokens + first, last - first );
+		}
+	}
+}
+
+/*
+* SCR_ParseScoreboardMessage
+*
+* Handles a chunk of a scoreboard message, which is applied once the last one is received.
+*/
+void SCR_ParseScoreboardMessage( unsigned int baseline, unsigned int sequence, bool more, const char *string )
+{
+	size_t len;
+	static char newString[SCOREBOARD_MSG_MAXSIZE];
+
+	if( sequence != scoreboardPendingSeq )
+	{
+		scoreboardPendingSeq = sequence;
+		scoreboardPending[0] = '\0';
+		scoreboardPendingOverflow = false;
+	}
+
+	len = strlen( scoreboardPending );
+	if( len + strlen( string ) >= sizeof( scoreboardPending ) )
+		scoreboardPendingOverflow = true;
+	else
+		Q_strncpyz( scoreboardPending + len, string, sizeof( scoreboardPending ) - len );
+
+	if( more )
+		return;
+
+	scoreboardPendingSeq = 0;
+
+	if( scoreboardPendingOverflow || ( baseline && baseline != scoreboardSeq ) )
+	{
+		// we don't have the baseline, e.g. after the demo has started recording or the
+		// chased player has changed, wait for the next full update in demos and multiview
+		if( !scoreboardRequested && !cgs.demoPlaying && !cg.frame.multipov && !cgs.tv )
+		{
+			trap_Cmd_ExecuteText( EXEC_NOW, "scbreq" );
+			scoreboardRequested = true;
+		}
+		return;
+	}
+
+	if( !baseline )
+		scoreboardRequested = false;
+
+	SCR_ApplyScoreboardDelta( baseline ? scoreboardString : "", scoreboardPending, newString );
+	Q_strncpyz( scoreboardString, newString, sizeof( scoreboardString ) );
+	scoreboardSeq = sequence;
+}
+
 /*
 * SCR_UpdatePlayerStatsMessage
 */
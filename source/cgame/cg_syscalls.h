@@ -242,6 +242,16 @@ static inline unsigned int trap_Milliseconds( void )
 	return CGAME_IMPORT.Milliseconds();
 }
 
+static inline void trap_Prof_Begin( const char *name )
+{
+	CGAME_IMPORT.Prof_Begin( name );
+}
+
+static inline void trap_Prof_End( void )
+{
+	CGAME_IMPORT.Prof_End();
+}
+
 static inline bool trap_DownloadRequest( const char *filename, bool requestpak )
 {
 	return CGAME_IMPORT.DownloadRequest( filename, requestpak == true ? true : false ) == true;
@@ -1135,6 +1135,7 @@ void CG_RenderView( float frameTime, float realFrameTime, int realTime, unsigned
 	else
 		CG_SetupViewDef( &cg.view, VIEWDEF_PLAYERVIEW, flipped );
 
+	trap_Prof_Begin( "cg_addentities" );
 	CG_LerpEntities();  // interpolate packet entities positions
 
 	CG_CalcViewWeapon( &cg.weapon );
@@ -1150,6 +1151,7 @@ void CG_RenderView( float frameTime, float realFrameTime, int realTime, unsigned
 	CG_AddDecals();
 	CG_AddPolys();
 	CG_AddLightStyles();
+	trap_Prof_End();
 
 #ifndef PUBLIC_BUILD
 	CG_AddTest();
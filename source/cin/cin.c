@@ -48,7 +48,6 @@ typedef struct
 	void ( *shutdown )( cinematics_t *cin );
 	void ( *reset )( cinematics_t *cin );
 	bool ( *need_next_frame )( cinematics_t *cin );
-	uint8_t *( *read_next_frame )( cinematics_t *cin, bool *redraw );
 	cin_yuv_t *( *read_next_frame_yuv )( cinematics_t *cin, bool *redraw );
 } cin_type_t;
 
@@ -62,11 +61,6 @@ static const cin_type_t cin_types[] =
 		Theora_Shutdown_CIN,
 		Theora_Reset_CIN,
 		Theora_NeedNextFrame_CIN,
-#ifdef THEORA_SOFTWARE_YUV2RGB
-		Theora_ReadNextFrame_CIN,
-#else
-		NULL,
-#endif
 		Theora_ReadNextFrameYUV_CIN
 	},
 
@@ -78,7 +72,6 @@ static const cin_type_t cin_types[] =
 		RoQ_Shutdown_CIN,
 		RoQ_Reset_CIN,
 		RoQ_NeedNextFrame_CIN,
-		NULL,
 		RoQ_ReadNextFrameYUV_CIN
 	},
 
@@ -90,13 +83,389 @@ static const cin_type_t cin_types[] =
 		NULL,
 		NULL,
 		NULL,
-		NULL,
 		NULL
 	}
 };
 
 // =====================================================================
 
+#define CIN_DECODEAHEAD_FRAMES		4
+#define CIN_DECODEAHEAD_MAX_LAG		500		// rebase the clock if we fall further behind than this
+
+enum
+{
+	CIN_SLOT_FREE,
+	CIN_SLOT_DECODING,
+	CIN_SLOT_READY,
+	CIN_SLOT_SHOWN
+};
+
+typedef struct
+{
+	int state;
+	unsigned int time;			// presentation time, relative to cin->start_time
+	cin_yuv_t yuv;
+	uint8_t *data;
+	size_t size;
+} cin_frameslot_t;
+
+typedef struct cin_decodeahead_s
+{
+	struct qthread_s *thread;
+	struct qmutex_s *lock;
+	struct qcondvar_s *slot_freed;		// worker waits on this
+	struct qcondvar_s *slot_filled;		// CIN_Preroll waits on this
+
+	volatile bool quit;
+	bool eos;
+	unsigned int num_frames;			// frames decoded since the last reset, including duplicates
+
+	// playback clock, cin->start_time and cin->cur_time belong to the decoder
+	unsigned int start_time;
+	unsigned int cur_time;
+
+	cin_frameslot_t slots[CIN_DECODEAHEAD_FRAMES];
+	cin_frameslot_t *shown;
+} cin_decodeahead_t;
+
+/*
+* CIN_DecodeNextFrame
+*
+* Advances the decoder clock by exactly one frame and decodes it,
+* regardless of real time. Returns NULL at the end of stream.
+*/
+static cin_yuv_t *CIN_DecodeNextFrame( cinematics_t *cin, bool *redraw )
+{
+	const cin_type_t *type = &cin_types[cin->type];
+
+	cin->cur_time = cin->start_time + (unsigned int)( ( cin->frame + 1 ) * 1000.0 / cin->framerate ) + 1;
+	cin->s_samples_length = 0;
+
+	*redraw = false;
+	if( !type->need_next_frame( cin ) ) {
+		return NULL;
+	}
+	return type->read_next_frame_yuv( cin, redraw );
+}
+
+/*
+* CIN_CopyFrameToSlot
+*/
+static void CIN_CopyFrameToSlot( cinematics_t *cin, const cin_yuv_t *cyuv, cin_frameslot_t *slot )
+{
+	int i, row;
+	size_t size;
+	uint8_t *dst;
+
+	size = 0;
+	for( i = 0; i < 3; i++ ) {
+		size += (size_t)abs( cyuv->yuv[i].stride ) * cyuv->yuv[i].height;
+	}
+
+	if( size > slot->size ) {
+		if( slot->data ) {
+			CIN_Free( slot->data );
+		}
+		slot->data = CIN_Alloc( cin->mempool, size );
+		slot->size = size;
+	}
+
+	slot->yuv = *cyuv;
+
+	// planes may be stored bottom-up (negative stride), flip them on copy
+	dst = slot->data;
+	for( i = 0; i < 3; i++ ) {
+		const cin_img_plane_t *src = &cyuv->yuv[i];
+		const int stride = abs( src->stride );
+
+		for( row = 0; row < src->height; row++ ) {
+			memcpy( dst + row * stride, src->data + row * src->stride, stride );
+		}
+
+		slot->yuv.yuv[i].data = dst;
+		slot->yuv.yuv[i].stride = stride;
+		dst += stride * src->height;
+	}
+}
+
+/*
+* CIN_DecodeAheadThread
+*/
+static void *CIN_DecodeAheadThread( void *param )
+{
+	int i;
+	bool redraw;
+	cin_yuv_t *cyuv;
+	cin_frameslot_t *slot;
+	cinematics_t *cin = param;
+	cin_decodeahead_t *da = cin->decodeahead;
+	const cin_type_t *type = &cin_types[cin->type];
+
+	trap_Mutex_Lock( da->lock );
+
+	while( !da->quit ) {
+		slot = NULL;
+		if( !da->eos ) {
+			for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+				if( da->slots[i].state == CIN_SLOT_FREE ) {
+					slot = &da->slots[i];
+					break;
+				}
+			}
+		}
+
+		if( !slot ) {
+			trap_CondVar_Wait( da->slot_freed, da->lock, Q_THREADS_WAIT_INFINITE );
+			continue;
+		}
+
+		slot->state = CIN_SLOT_DECODING;
+		trap_Mutex_Unlock( da->lock );
+
+		// duplicate frames only advance the clock
+		do {
+			cyuv = CIN_DecodeNextFrame( cin, &redraw );
+			if( !cyuv && ( cin->flags & CIN_LOOP ) && cin->frame ) {
+				type->reset( cin );
+				cin->frame = 0;
+				cyuv = CIN_DecodeNextFrame( cin, &redraw );
+			}
+			if( cyuv ) {
+				da->num_frames++;
+			}
+		} while( cyuv && !redraw && !da->quit );
+
+		if( cyuv ) {
+			CIN_CopyFrameToSlot( cin, cyuv, slot );
+			slot->time = (unsigned int)( ( da->num_frames - 1 ) * 1000.0 / cin->framerate );
+		}
+
+		trap_Mutex_Lock( da->lock );
+
+		if( cyuv ) {
+			slot->state = CIN_SLOT_READY;
+		}
+		else {
+			slot->state = CIN_SLOT_FREE;
+			da->eos = true;
+		}
+
+		trap_CondVar_Wake( da->slot_filled );
+	}
+
+	trap_Mutex_Unlock( da->lock );
+
+	return NULL;
+}
+
+/*
+* CIN_StartDecodeAhead
+*/
+static void CIN_StartDecodeAhead( cinematics_t *cin, unsigned int start_time )
+{
+	cin_decodeahead_t *da = cin->decodeahead;
+
+	if( !da ) {
+		da = CIN_Alloc( cin->mempool, sizeof( *da ) );
+		memset( da, 0, sizeof( *da ) );
+		da->lock = trap_Mutex_Create();
+		da->slot_freed = trap_CondVar_Create();
+		da->slot_filled = trap_CondVar_Create();
+		cin->decodeahead = da;
+	}
+
+	da->quit = false;
+	da->eos = false;
+	da->num_frames = 0;
+	da->shown = NULL;
+	da->start_time = da->cur_time = start_time;
+
+	da->thread = trap_Thread_Create( CIN_DecodeAheadThread, cin );
+}
+
+/*
+* CIN_StopDecodeAhead
+*/
+static void CIN_StopDecodeAhead( cinematics_t *cin )
+{
+	int i;
+	cin_decodeahead_t *da = cin->decodeahead;
+
+	if( !da || !da->thread ) {
+		return;
+	}
+
+	trap_Mutex_Lock( da->lock );
+	da->quit = true;
+	trap_CondVar_Wake( da->slot_freed );
+	trap_Mutex_Unlock( da->lock );
+
+	trap_Thread_Join( da->thread );
+	da->thread = NULL;
+
+	for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+		da->slots[i].state = CIN_SLOT_FREE;
+	}
+	da->shown = NULL;
+}
+
+/*
+* CIN_FreeDecodeAhead
+*/
+static void CIN_FreeDecodeAhead( cinematics_t *cin )
+{
+	int i;
+	cin_decodeahead_t *da = cin->decodeahead;
+
+	if( !da ) {
+		return;
+	}
+
+	CIN_StopDecodeAhead( cin );
+
+	for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+		if( da->slots[i].data ) {
+			CIN_Free( da->slots[i].data );
+		}
+	}
+
+	trap_CondVar_Destroy( &da->slot_filled );
+	trap_CondVar_Destroy( &da->slot_freed );
+	trap_Mutex_Destroy( &da->lock );
+
+	CIN_Free( da );
+	cin->decodeahead = NULL;
+}
+
+/*
+* CIN_FindDecodedFrame
+*
+* Returns the newest ready frame that is due at the current time.
+* Must be called with the lock held.
+*/
+static cin_frameslot_t *CIN_FindDecodedFrame( cinematics_t *cin )
+{
+	int i;
+	unsigned int now;
+	cin_frameslot_t *slot, *best = NULL;
+	cin_decodeahead_t *da = cin->decodeahead;
+
+	if( da->cur_time < da->start_time ) {
+		return NULL;
+	}
+
+	now = da->cur_time - da->start_time;
+	for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+		slot = &da->slots[i];
+		if( slot->state != CIN_SLOT_READY || slot->time > now ) {
+			continue;
+		}
+		if( !best || slot->time > best->time ) {
+			best = slot;
+		}
+	}
+
+	return best;
+}
+
+/*
+* CIN_ReadDecodedFrame
+*/
+static cin_yuv_t *CIN_ReadDecodedFrame( cinematics_t *cin, bool *redraw )
+{
+	int i;
+	bool eos;
+	cin_frameslot_t *slot;
+	cin_decodeahead_t *da = cin->decodeahead;
+
+	*redraw = false;
+
+	trap_Mutex_Lock( da->lock );
+
+	slot = CIN_FindDecodedFrame( cin );
+	if( slot ) {
+		// release the previous frame and everything older than the new one
+		for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+			if( ( da->slots[i].state == CIN_SLOT_READY && da->slots[i].time < slot->time ) 
+				|| da->slots[i].state == CIN_SLOT_SHOWN ) {
+				da->slots[i].state = CIN_SLOT_FREE;
+			}
+		}
+
+		slot->state = CIN_SLOT_SHOWN;
+		da->shown = slot;
+		*redraw = true;
+
+		// the decoder can't keep up, skip ahead instead of playing in slow motion
+		if( da->cur_time - da->start_time > slot->time + CIN_DECODEAHEAD_MAX_LAG ) {
+			da->start_time = da->cur_time - slot->time;
+		}
+
+		trap_CondVar_Wake( da->slot_freed );
+	}
+
+	slot = da->shown;
+	eos = da->eos;
+	for( i = 0; i < CIN_DECODEAHEAD_FRAMES && eos; i++ ) {
+		if( da->slots[i].state == CIN_SLOT_READY ) {
+			eos = false;
+		}
+	}
+
+	trap_Mutex_Unlock( da->lock );
+
+	if( eos && !*redraw ) {
+		return NULL;
+	}
+
+	return slot ? &slot->yuv : NULL;
+}
+
+/*
+* CIN_Preroll
+*
+* Blocks until up to numFrames frames have been decoded ahead and restarts
+* the playback clock. Returns the number of frames available.
+*/
+unsigned int CIN_Preroll( cinematics_t *cin, unsigned int numFrames )
+{
+	int i;
+	unsigned int numReady = 0;
+	cin_decodeahead_t *da;
+
+	if( !cin || !cin->decodeahead ) {
+		return 0;
+	}
+
+	da = cin->decodeahead;
+	numFrames = min( numFrames, CIN_DECODEAHEAD_FRAMES );
+
+	trap_Mutex_Lock( da->lock );
+
+	while( true ) {
+		numReady = 0;
+		for( i = 0; i < CIN_DECODEAHEAD_FRAMES; i++ ) {
+			if( da->slots[i].state == CIN_SLOT_READY ) {
+				numReady++;
+			}
+		}
+
+		if( numReady >= numFrames || da->eos ) {
+			break;
+		}
+
+		trap_CondVar_Wait( da->slot_filled, da->lock, Q_THREADS_WAIT_INFINITE );
+	}
+
+	da->start_time = da->cur_time = trap_Milliseconds();
+
+	trap_Mutex_Unlock( da->lock );
+
+	return numReady;
+}
+
+// =====================================================================
+
 /*
 * CIN_Open
 */
@@ -129,6 +498,10 @@ cinematics_t *CIN_Open( const char *name, unsigned int start_time,
 	cin->flags = 0;
 	cin->flags = flags;
 
+	if( flags & CIN_DECODEAHEAD ) {
+		cin->flags |= CIN_NOAUDIO;
+	}
+
 	if( trap_FS_IsUrl( name ) )
 	{
 		cin->type = CIN_TYPE_THEORA;
@@ -201,6 +574,10 @@ cinematics_t *CIN_Open( const char *name, unsigned int start_time,
 	load_msec = trap_Milliseconds() - load_msec;
 	cin->start_time = cin->cur_time = start_time + load_msec;
 
+	if( cin->flags & CIN_DECODEAHEAD ) {
+		CIN_StartDecodeAhead( cin, cin->start_time );
+	}
+
 	return cin;
 }
 
@@ -238,6 +615,18 @@ bool CIN_NeedNextFrame( cinematics_t *cin, unsigned int curtime )
 
 	type = &cin_types[cin->type];
 
+	if( cin->decodeahead ) {
+		bool need;
+		cin_decodeahead_t *da = cin->decodeahead;
+
+		trap_Mutex_Lock( da->lock );
+		da->cur_time = curtime;
+		need = da->eos || CIN_FindDecodedFrame( cin ) != NULL;
+		trap_Mutex_Unlock( da->lock );
+
+		return need;
+	}
+
 	cin->cur_time = curtime;
 	cin->s_samples_length = CIN_GetRawSamplesLengthFromListeners( cin );
 
@@ -247,6 +636,28 @@ bool CIN_NeedNextFrame( cinematics_t *cin, unsigned int curtime )
 	return type->need_next_frame( cin );
 }
 
+/*
+* CIN_FrameToRGBA
+*/
+static uint8_t *CIN_FrameToRGBA( cinematics_t *cin, const cin_yuv_t *cyuv, bool redraw )
+{
+	size_t size = cyuv->width * cyuv->height * 4;
+
+	if( size > cin->vid_buffer_size ) {
+		if( cin->vid_buffer ) {
+			CIN_Free( cin->vid_buffer );
+		}
+		cin->vid_buffer = CIN_Alloc( cin->mempool, size );
+		cin->vid_buffer_size = size;
+		redraw = true;
+	}
+
+	if( redraw ) {
+		CIN_YUVToRGBA( cyuv, cin->vid_buffer );
+	}
+	return cin->vid_buffer;
+}
+
 /*
 * CIN_ReadNextFrame_
 */
@@ -254,7 +665,7 @@ static uint8_t *CIN_ReadNextFrame_( cinematics_t *cin, int *width, int *height,
 	int *aspect_numerator, int *aspect_denominator, bool *redraw, bool yuv )
 {
 	int i;
-	uint8_t *frame = NULL;
+	cin_yuv_t *cyuv = NULL;
 	const cin_type_t *type;
 	bool redraw_ = false;
 
@@ -263,30 +674,43 @@ static uint8_t *CIN_ReadNextFrame_( cinematics_t *cin, int *width, int *height,
 
 	type = &cin_types[cin->type];
 
-	cin->haveAudio = false;
+	if( cin->decodeahead )
+	{
+		cyuv = CIN_ReadDecodedFrame( cin, &redraw_ );
 
-	for( i = 0; i < 2; i++ )
+		if( width )
+			*width = cyuv ? cyuv->width : 0;
+		if( height )
+			*height = cyuv ? cyuv->height : 0;
+	}
+	else
 	{
-		redraw_ = false;
-		if( yuv ) {
-			frame = ( uint8_t * )type->read_next_frame_yuv( cin, &redraw_ );
-		}
-		else {
-			frame = type->read_next_frame( cin, &redraw_ );
+		cin->haveAudio = false;
+
+		for( i = 0; i < 2; i++ )
+		{
+			redraw_ = false;
+			cyuv = type->read_next_frame_yuv( cin, &redraw_ );
+			if( cyuv || !( cin->flags & CIN_LOOP ) )
+				break;
+
+			// try again from the beginning if looping
+			type->reset( cin );
+			cin->frame = 0;
+			cin->start_time = cin->cur_time;
 		}
-		if( frame || !( cin->flags & CIN_LOOP ) )
-			break;
 
-		// try again from the beginning if looping
-		type->reset( cin );
-		cin->frame = 0;
-		cin->start_time = cin->cur_time;
+		if( width )
+			*width = cin->width;
+		if( height )
+			*height = cin->height;
+
+		if( cin->haveAudio ) {
+			CIN_ClearRawSamplesListeners( cin );
+			cin->haveAudio = false;
+		}
 	}
 
-	if( width )
-		*width = cin->width;
-	if( height )
-		*height = cin->height;
 	if( aspect_numerator )
 		*aspect_numerator = cin->aspect_numerator;
 	if( aspect_denominator )
@@ -294,12 +718,13 @@ static uint8_t *CIN_ReadNextFrame_( cinematics_t *cin, int *width, int *height,
 	if( redraw )
 		*redraw = redraw_;
 
-	if( cin->haveAudio ) {
-		CIN_ClearRawSamplesListeners( cin );
-		cin->haveAudio = false;
+	if( !cyuv ) {
+		return NULL;
 	}
-
-	return frame;
+	if( yuv ) {
+		return ( uint8_t * )cyuv;
+	}
+	return CIN_FrameToRGBA( cin, cyuv, redraw_ );
 }
 
 /*
@@ -350,6 +775,10 @@ bool CIN_AddRawSamplesListener( cinematics_t *cin, void *listener,
 	if( cin->flags & CIN_NOAUDIO ) {
 		return false;
 	}
+	if( cin->decodeahead ) {
+		// listeners can't be called from the decoder thread
+		return false;
+	}
 
 	for( i = 0; i < cin->num_listeners; i++ ) {
 		if( cin->listeners[i].listener == listener 
@@ -417,10 +846,18 @@ void CIN_Reset( cinematics_t *cin, unsigned int cur_time )
 
 	type = &cin_types[cin->type];
 
+	if( cin->decodeahead ) {
+		CIN_StopDecodeAhead( cin );
+	}
+
 	type->reset( cin );
 	cin->frame = 0;
 	cin->cur_time = cur_time;
 	cin->start_time = cur_time;
+
+	if( cin->decodeahead ) {
+		CIN_StartDecodeAhead( cin, cur_time );
+	}
 }
 
 /*
@@ -439,6 +876,8 @@ void CIN_Close( cinematics_t *cin )
 	mempool = cin->mempool;
 	assert( mempool != NULL );
 
+	CIN_FreeDecodeAhead( cin );
+
 	type = &cin_types[cin->type];
 	type->shutdown( cin );
 
@@ -472,3 +911,107 @@ void CIN_Close( cinematics_t *cin )
 	CIN_Free( cin );
 	CIN_FreePool( &mempool );
 }
+
+/*
+* CIN_BenchmarkFile
+*/
+static void CIN_BenchmarkFile( const char *name )
+{
+	bool redraw;
+	cin_yuv_t *cyuv;
+	cinematics_t *cin;
+	unsigned int numFrames = 0, numDups = 0;
+	uint64_t t, decodeTime = 0, convertTime = 0;
+	uint8_t *rgba = NULL;
+	size_t rgbaSize = 0;
+
+	cin = CIN_Open( name, trap_Milliseconds(), CIN_NOAUDIO, NULL, NULL );
+	if( !cin ) {
+		Com_Printf( "Couldn't open %s\n", name );
+		return;
+	}
+
+	while( true ) {
+		t = trap_Microseconds();
+		cyuv = CIN_DecodeNextFrame( cin, &redraw );
+		decodeTime += trap_Microseconds() - t;
+
+		if( !cyuv ) {
+			break;
+		}
+		if( !redraw ) {
+			numDups++;
+			continue;
+		}
+
+		if( (size_t)cyuv->width * cyuv->height * 4 > rgbaSize ) {
+			if( rgba ) {
+				CIN_Free( rgba );
+			}
+			rgbaSize = cyuv->width * cyuv->height * 4;
+			rgba = CIN_Alloc( cin->mempool, rgbaSize );
+		}
+
+		t = trap_Microseconds();
+		CIN_YUVToRGBA( cyuv, rgba );
+		convertTime += trap_Microseconds() - t;
+
+		numFrames++;
+	}
+
+	if( rgba ) {
+		CIN_Free( rgba );
+	}
+
+	if( numFrames ) {
+		Com_Printf( "%s: %ix%i, %u frames (%u dups), decode %.3f ms/frame, rgba %.3f ms/frame, %.1f fps\n", 
+			CIN_FileName( cin ), cin->width, cin->height, numFrames, numDups, 
+			decodeTime / 1000.0 / numFrames, convertTime / 1000.0 / numFrames, 
+			numFrames * 1000000.0 / ( decodeTime + convertTime + 1 ) );
+	}
+	else {
+		Com_Printf( "%s: no frames decoded\n", CIN_FileName( cin ) );
+	}
+
+	CIN_Close( cin );
+}
+
+/*
+* CIN_Benchmark_f
+*
+* Decodes every frame of a cinematic as fast as possible, separately
+* timing the decoder and the software colour conversion.
+*/
+void CIN_Benchmark_f( void )
+{
+	int i, j, numFiles;
+	size_t len;
+	char buf[4096], path[MAX_QPATH], ext[16];
+	const char *s, *t;
+	const cin_type_t *type;
+
+	if( trap_Cmd_Argc() > 1 ) {
+		for( i = 1; i < trap_Cmd_Argc(); i++ ) {
+			CIN_BenchmarkFile( trap_Cmd_Argv( i ) );
+		}
+		return;
+	}
+
+	// no arguments, benchmark everything in the video directory
+	// note that CIN_Open uses strtok, so split the extensions by hand
+	for( type = cin_types; type->extensions; type++ ) {
+		for( s = type->extensions; *s; s = t ) {
+			t = strchr( s, ' ' );
+			len = t ? (size_t)( t - s ) : strlen( s );
+			Q_strncpyz( ext, s, min( len + 1, sizeof( ext ) ) );
+			t = t ? t + 1 : s + len;
+
+			numFiles = trap_FS_GetFileList( "video", ext, buf, sizeof( buf ), 0, 0 );
+			for( i = 0, j = 0; i < numFiles && j < (int)sizeof( buf ); i++ ) {
+				Q_snprintfz( path, sizeof( path ), "video/%s", buf + j );
+				j += strlen( buf + j ) + 1;
+				CIN_BenchmarkFile( path );
+			}
+		}
+	}
+}
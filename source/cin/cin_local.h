@@ -71,7 +71,8 @@ typedef struct cinematics_s
 
 	bool	yuv;
 
-	uint8_t		*vid_buffer;
+	uint8_t		*vid_buffer;		// RGBA frame for CIN_ReadNextFrame
+	size_t		vid_buffer_size;
 
 	bool	haveAudio;			// only valid for the current frame
 	int			num_listeners;
@@ -80,6 +81,8 @@ typedef struct cinematics_s
 	int			type;
 	void		*fdata;				// format-dependent data
 	struct mempool_s *mempool;
+
+	struct cin_decodeahead_s *decodeahead;	// CIN_DECODEAHEAD worker state
 } cinematics_t;
 
 void Com_DPrintf( const char *format, ... );
@@ -116,6 +119,15 @@ unsigned int CIN_GetRawSamplesLengthFromListeners( cinematics_t *cin );
 
 void CIN_Reset( cinematics_t *cin, unsigned int cur_time );
 
+unsigned int CIN_Preroll( cinematics_t *cin, unsigned int numFrames );
+
+void CIN_Benchmark_f( void );
+
+//
+// cin_yuv.c
+//
+void CIN_YUVToRGBA( const cin_yuv_t *cyuv, uint8_t *out );
+
 void CIN_Close( cinematics_t *cin );
 
 #endif
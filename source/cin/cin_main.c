@@ -40,6 +40,8 @@ bool CIN_Init( bool verbose )
 
 	Theora_LoadTheoraLibraries();
 
+	trap_Cmd_AddCommand( "cinbenchmark", CIN_Benchmark_f );
+
 	return true;
 }
 
@@ -48,6 +50,8 @@ bool CIN_Init( bool verbose )
 */
 void CIN_Shutdown( bool verbose )
 {
+	trap_Cmd_RemoveCommand( "cinbenchmark" );
+
 	Theora_UnloadTheoraLibraries();
 
 	CIN_FreePool( &cinPool );
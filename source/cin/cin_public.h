@@ -24,14 +24,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // cin_public.h -- cinematics playback as a separate dll, making the engine
 // container- and format- agnostic
 
-#define	CIN_API_VERSION				8
+#define	CIN_API_VERSION				9
 
 #define CIN_LOOP					1
 #define CIN_NOAUDIO					2
+#define CIN_DECODEAHEAD				4		// decode frames in advance on a separate thread, no audio
 
 //===============================================================
 
 struct cinematics_s;
+struct qthread_s;
+struct qmutex_s;
+struct qcondvar_s;
 
 typedef struct {
 	// MUST MATCH ref_img_plane_t
@@ -134,6 +138,18 @@ typedef struct
 	void ( *Mem_Free )( void *data, const char *filename, int fileline );
 	void ( *Mem_FreePool )( struct mempool_s **pool, const char *filename, int fileline );
 	void ( *Mem_EmptyPool )( struct mempool_s *pool, const char *filename, int fileline );
+
+	// multithreading
+	struct qthread_s *( *Thread_Create )( void *(*routine) (void*), void *param );
+	void ( *Thread_Join )( struct qthread_s *thread );
+	struct qmutex_s *( *Mutex_Create )( void );
+	void ( *Mutex_Destroy )( struct qmutex_s **mutex );
+	void ( *Mutex_Lock )( struct qmutex_s *mutex );
+	void ( *Mutex_Unlock )( struct qmutex_s *mutex );
+	struct qcondvar_s *( *CondVar_Create )( void );
+	void ( *CondVar_Destroy )( struct qcondvar_s **cond );
+	bool ( *CondVar_Wait )( struct qcondvar_s *cond, struct qmutex_s *mutex, unsigned int timeout_msec );
+	void ( *CondVar_Wake )( struct qcondvar_s *cond );
 } cin_import_t;
 
 //
@@ -154,6 +170,7 @@ typedef struct
 	uint8_t *( *ReadNextFrame )( struct cinematics_s *cin, int *width, int *height, int *aspect_numerator, int *aspect_denominator, bool *redraw );
 	cin_yuv_t *( *ReadNextFrameYUV )( struct cinematics_s *cin, int *width, int *height, int *aspect_numerator, int *aspect_denominator, bool *redraw );
 	bool ( *AddRawSamplesListener )( struct cinematics_s *cin, void *listener, cin_raw_samples_cb_t rs, cin_get_raw_samples_cb_t grs );
+	unsigned int ( *Preroll )( struct cinematics_s *cin, unsigned int numFrames );
 	void ( *Reset )( struct cinematics_s *cin, unsigned int cur_time );
 	void ( *Close )( struct cinematics_s *cin );
 	const char *( *FileName )( struct cinematics_s *cin );
@@ -556,8 +556,12 @@ cin_yuv_t *RoQ_ReadNextFrameYUV_CIN( cinematics_t *cin, bool *redraw )
 			RoQ_ReadInfo( cin );
 		else if( (chunk->id == RoQ_SOUND_MONO || chunk->id == RoQ_SOUND_STEREO) )
 		{
-			assert( cin->num_listeners != 0 );
-			RoQ_ReadAudio( cin );
+			if( cin->flags & CIN_NOAUDIO ) {
+				RoQ_SkipChunk( cin );
+			} else {
+				assert( cin->num_listeners != 0 );
+				RoQ_ReadAudio( cin );
+			}
 		}
 		else if( chunk->id == RoQ_QUAD_VQ ) {
 			*redraw = true;
@@ -44,6 +44,7 @@ QF_DLL_EXPORT cin_export_t *GetCinematicsAPI( cin_import_t *import )
 	globals.ReadNextFrame = &CIN_ReadNextFrame;
 	globals.ReadNextFrameYUV = &CIN_ReadNextFrameYUV;
 	globals.AddRawSamplesListener = &CIN_AddRawSamplesListener;
+	globals.Preroll = &CIN_Preroll;
 	globals.Reset = &CIN_Reset;
 	globals.Close = &CIN_Close;
 	globals.FileName = &CIN_FileName;
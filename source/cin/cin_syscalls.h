@@ -197,6 +197,57 @@ static inline void trap_MemEmptyPool( struct mempool_s *pool, const char *filena
 	CIN_IMPORT.Mem_EmptyPool( pool, filename, fileline );
 }
 
+// multithreading
+static inline struct qthread_s *trap_Thread_Create( void *(*routine) (void*), void *param )
+{
+	return CIN_IMPORT.Thread_Create( routine, param );
+}
+
+static inline void trap_Thread_Join( struct qthread_s *thread )
+{
+	CIN_IMPORT.Thread_Join( thread );
+}
+
+static inline struct qmutex_s *trap_Mutex_Create( void )
+{
+	return CIN_IMPORT.Mutex_Create();
+}
+
+static inline void trap_Mutex_Destroy( struct qmutex_s **mutex )
+{
+	CIN_IMPORT.Mutex_Destroy( mutex );
+}
+
+static inline void trap_Mutex_Lock( struct qmutex_s *mutex )
+{
+	CIN_IMPORT.Mutex_Lock( mutex );
+}
+
+static inline void trap_Mutex_Unlock( struct qmutex_s *mutex )
+{
+	CIN_IMPORT.Mutex_Unlock( mutex );
+}
+
+static inline struct qcondvar_s *trap_CondVar_Create( void )
+{
+	return CIN_IMPORT.CondVar_Create();
+}
+
+static inline void trap_CondVar_Destroy( struct qcondvar_s **cond )
+{
+	CIN_IMPORT.CondVar_Destroy( cond );
+}
+
+static inline bool trap_CondVar_Wait( struct qcondvar_s *cond, struct qmutex_s *mutex, unsigned int timeout_msec )
+{
+	return CIN_IMPORT.CondVar_Wait( cond, mutex, timeout_msec );
+}
+
+static inline void trap_CondVar_Wake( struct qcondvar_s *cond )
+{
+	CIN_IMPORT.CondVar_Wake( cond );
+}
+
 static inline void *trap_LoadLibrary( char *name, dllfunc_t *funcs )
 {
 	return CIN_IMPORT.Sys_LoadLibrary( name, funcs );
@@ -23,7 +23,6 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "cin_local.h"
 
-//#define THEORA_SOFTWARE_YUV2RGB
 #define THEORA_FILE_EXTENSIONS ".ogg .ogv"
 
 void Theora_UnloadTheoraLibraries( void );
@@ -34,7 +33,6 @@ bool Theora_HasOggAudio_CIN( cinematics_t *cin );
 void Theora_Shutdown_CIN( cinematics_t *cin );
 void Theora_Reset_CIN( cinematics_t *cin );
 bool Theora_NeedNextFrame_CIN( cinematics_t *cin );
-uint8_t *Theora_ReadNextFrame_CIN( cinematics_t *cin, bool *redraw );
 cin_yuv_t *Theora_ReadNextFrameYUV_CIN( cinematics_t *cin, bool *redraw );
 
 #endif
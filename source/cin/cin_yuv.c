@@ -0,0 +1,215 @@
+/*
+Copyright (C) 2012 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// cin_yuv.c: software YCbCr to RGBA conversion
+
+#include "cin_local.h"
+
+#if defined( HAVE_SSE2 )
+#include <emmintrin.h>
+#elif defined( HAVE_NEON )
+#include <arm_neon.h>
+#endif
+
+// 16.16 fixed point coefficients, taken from http://www.gamedev.ru/code/articles/?id=4252&page=3
+#define YUV_CR_R	113443
+#define YUV_CR_G	45744
+#define YUV_CB_G	22020
+#define YUV_CB_B	113508
+
+/*
+* CIN_YUVToRGBARow_Generic
+*/
+static void CIN_YUVToRGBARow_Generic( const uint8_t *y, const uint8_t *u, const uint8_t *v,
+	int hshift, int start, int width, uint8_t *out )
+{
+	int x, cu, cv, r, g, b, c;
+
+	out += start * 4;
+	for( x = start; x < width; x++, out += 4 ) {
+		c = y[x];
+		cu = u[x >> hshift] - 128;
+		cv = v[x >> hshift] - 128;
+
+		r = c + ( ( YUV_CR_R * cv + 32768 ) >> 16 );
+		g = c - ( ( YUV_CR_G * cv + 32768 ) >> 16 ) - ( ( YUV_CB_G * cu + 32768 ) >> 16 );
+		b = c + ( ( YUV_CB_B * cu + 32768 ) >> 16 );
+
+		out[0] = bound( 0, r, 255 );
+		out[1] = bound( 0, g, 255 );
+		out[2] = bound( 0, b, 255 );
+		out[3] = 255;
+	}
+}
+
+#if defined( HAVE_SSE2 )
+
+/*
+* CIN_YUVToRGBARow
+*
+* 8 pixels at a time. Chroma is scaled by 4 so that the coefficients,
+* divided by 4, fit into signed 16 bits for _mm_mulhi_epi16. Results
+* are within 2 of the generic version due to truncation.
+*/
+static void CIN_YUVToRGBARow( const uint8_t *y, const uint8_t *u, const uint8_t *v,
+	int hshift, int width, uint8_t *out )
+{
+	int x;
+	int32_t u4, v4;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16( 128 );
+	const __m128i alpha = _mm_set1_epi8( (char)255 );
+	const __m128i crr = _mm_set1_epi16( (YUV_CR_R + 2) >> 2 );
+	const __m128i crg = _mm_set1_epi16( (YUV_CR_G + 2) >> 2 );
+	const __m128i cbg = _mm_set1_epi16( (YUV_CB_G + 2) >> 2 );
+	const __m128i cbb = _mm_set1_epi16( (YUV_CB_B + 2) >> 2 );
+	__m128i yy, uu, vv, r, g, b, rg, ba;
+
+	for( x = 0; x + 8 <= width; x += 8 ) {
+		yy = _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i * )( y + x ) ), zero );
+
+		if( hshift ) {
+			memcpy( &u4, u + ( x >> 1 ), 4 );
+			memcpy( &v4, v + ( x >> 1 ), 4 );
+			uu = _mm_unpacklo_epi8( _mm_cvtsi32_si128( u4 ), zero );
+			vv = _mm_unpacklo_epi8( _mm_cvtsi32_si128( v4 ), zero );
+			uu = _mm_unpacklo_epi16( uu, uu );
+			vv = _mm_unpacklo_epi16( vv, vv );
+		}
+		else {
+			uu = _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i * )( u + x ) ), zero );
+			vv = _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i * )( v + x ) ), zero );
+		}
+
+		uu = _mm_slli_epi16( _mm_sub_epi16( uu, bias ), 2 );
+		vv = _mm_slli_epi16( _mm_sub_epi16( vv, bias ), 2 );
+
+		r = _mm_add_epi16( yy, _mm_mulhi_epi16( vv, crr ) );
+		g = _mm_sub_epi16( yy, _mm_add_epi16( _mm_mulhi_epi16( vv, crg ), _mm_mulhi_epi16( uu, cbg ) ) );
+		b = _mm_add_epi16( yy, _mm_mulhi_epi16( uu, cbb ) );
+
+		// saturate to 0..255
+		r = _mm_packus_epi16( r, r );
+		g = _mm_packus_epi16( g, g );
+		b = _mm_packus_epi16( b, b );
+
+		rg = _mm_unpacklo_epi8( r, g );
+		ba = _mm_unpacklo_epi8( b, alpha );
+		_mm_storeu_si128( ( __m128i * )( out + x * 4 ), _mm_unpacklo_epi16( rg, ba ) );
+		_mm_storeu_si128( ( __m128i * )( out + x * 4 + 16 ), _mm_unpackhi_epi16( rg, ba ) );
+	}
+
+	CIN_YUVToRGBARow_Generic( y, u, v, hshift, x, width, out );
+}
+
+#elif defined( HAVE_NEON )
+
+/*
+* CIN_YUVToRGBARow
+*
+* 8 pixels at a time, see the SSE2 version above.
+*/
+static void CIN_YUVToRGBARow( const uint8_t *y, const uint8_t *u, const uint8_t *v,
+	int hshift, int width, uint8_t *out )
+{
+	int x;
+	uint8x8_t u8, v8;
+	int16x8_t yy, uu, vv, r, g, b;
+	uint8x8x4_t rgba;
+	const int16x8_t bias = vdupq_n_s16( 128 );
+
+	rgba.val[3] = vdup_n_u8( 255 );
+
+	for( x = 0; x + 8 <= width; x += 8 ) {
+		yy = vreinterpretq_s16_u16( vmovl_u8( vld1_u8( y + x ) ) );
+
+		if( hshift ) {
+			uint32_t u4, v4;
+			uint8x8x2_t uz, vz;
+
+			memcpy( &u4, u + ( x >> 1 ), 4 );
+			memcpy( &v4, v + ( x >> 1 ), 4 );
+			u8 = vcreate_u8( u4 );
+			v8 = vcreate_u8( v4 );
+			uz = vzip_u8( u8, u8 );
+			vz = vzip_u8( v8, v8 );
+			u8 = uz.val[0];
+			v8 = vz.val[0];
+		}
+		else {
+			u8 = vld1_u8( u + x );
+			v8 = vld1_u8( v + x );
+		}
+
+		uu = vshlq_n_s16( vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( u8 ) ), bias ), 2 );
+		vv = vshlq_n_s16( vsubq_s16( vreinterpretq_s16_u16( vmovl_u8( v8 ) ), bias ), 2 );
+
+		// vqdmulhq_n_s16 returns ( a * b * 2 ) >> 16, hence the coefficients divided by 8
+		r = vaddq_s16( yy, vqdmulhq_n_s16( vv, (YUV_CR_R + 4) >> 3 ) );
+		g = vsubq_s16( yy, vaddq_s16( vqdmulhq_n_s16( vv, (YUV_CR_G + 4) >> 3 ), vqdmulhq_n_s16( uu, (YUV_CB_G + 4) >> 3 ) ) );
+		b = vaddq_s16( yy, vqdmulhq_n_s16( uu, (YUV_CB_B + 4) >> 3 ) );
+
+		rgba.val[0] = vqmovun_s16( r );
+		rgba.val[1] = vqmovun_s16( g );
+		rgba.val[2] = vqmovun_s16( b );
+		vst4_u8( out + x * 4, rgba );
+	}
+
+	CIN_YUVToRGBARow_Generic( y, u, v, hshift, x, width, out );
+}
+
+#else
+
+/*
+* CIN_YUVToRGBARow
+*/
+static void CIN_YUVToRGBARow( const uint8_t *y, const uint8_t *u, const uint8_t *v,
+	int hshift, int width, uint8_t *out )
+{
+	CIN_YUVToRGBARow_Generic( y, u, v, hshift, 0, width, out );
+}
+
+#endif
+
+/*
+* CIN_YUVToRGBA
+*
+* Converts the visible part of a YCbCr frame to tightly packed RGBA. Chroma
+* subsampling (4:2:0, 4:2:2 or 4:4:4) is deduced from the plane dimensions.
+*/
+void CIN_YUVToRGBA( const cin_yuv_t *cyuv, uint8_t *out )
+{
+	int row;
+	const cin_img_plane_t *py = &cyuv->yuv[0], *pu = &cyuv->yuv[1], *pv = &cyuv->yuv[2];
+	const int hshift = pu->width < py->width ? 1 : 0;
+	const int vshift = pu->height < py->height ? 1 : 0;
+	const int outStride = cyuv->width * 4;
+
+	for( row = 0; row < cyuv->height; row++, out += outStride ) {
+		const int yrow = cyuv->y_offset + row;
+		const int crow = yrow >> vshift;
+
+		CIN_YUVToRGBARow(
+			py->data + py->stride * yrow + cyuv->x_offset,
+			pu->data + pu->stride * crow + ( cyuv->x_offset >> hshift ),
+			pv->data + pv->stride * crow + ( cyuv->x_offset >> hshift ),
+			hshift, cyuv->width, out );
+	}
+}
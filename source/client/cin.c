@@ -137,6 +137,17 @@ void CIN_LoadLibrary( bool verbose )
 	import.Mem_FreePool = &CL_CinModule_MemFreePool;
 	import.Mem_EmptyPool = &CL_CinModule_MemEmptyPool;
 
+	import.Thread_Create = QThread_Create;
+	import.Thread_Join = QThread_Join;
+	import.Mutex_Create = QMutex_Create;
+	import.Mutex_Destroy = QMutex_Destroy;
+	import.Mutex_Lock = QMutex_Lock;
+	import.Mutex_Unlock = QMutex_Unlock;
+	import.CondVar_Create = QCondVar_Create;
+	import.CondVar_Destroy = QCondVar_Destroy;
+	import.CondVar_Wait = QCondVar_Wait;
+	import.CondVar_Wake = QCondVar_Wake;
+
 	// load dynamic library
 	cin_export = NULL;
 	if( verbose ) {
@@ -283,6 +294,14 @@ bool CIN_AddRawSamplesListener( struct cinematics_s *cin, void *listener,
 	return false;
 }
 
+unsigned int CIN_Preroll( struct cinematics_s *cin, unsigned int numFrames )
+{
+	if( cin_export ) {
+		return cin_export->Preroll( cin, numFrames );
+	}
+	return 0;
+}
+
 void CIN_Reset( struct cinematics_s *cin, unsigned int cur_time )
 {
 	if( cin_export ) {
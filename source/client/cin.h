@@ -41,6 +41,8 @@ ref_yuv_t *CIN_ReadNextFrameYUV( struct cinematics_s *cin, int *width, int *heig
 bool CIN_AddRawSamplesListener( struct cinematics_s *cin, void *listener,
 	cin_raw_samples_cb_t rs, cin_get_raw_samples_cb_t grs );
 
+unsigned int CIN_Preroll( struct cinematics_s *cin, unsigned int numFrames );
+
 void CIN_Reset( struct cinematics_s *cin, unsigned int cur_time );
 
 void CIN_Close( struct cinematics_s *cin );
@@ -37,7 +37,11 @@ void CL_WriteDemoMessage( msg_t *msg )
 	}
 
 	// the first eight bytes are just packet sequencing stuff
-	SNAP_RecordDemoMessage( cls.demo.file, msg, 8 );
+	if( !SNAP_WriteDemoMessage( cls.demo.writer, msg, 8 ) )
+	{
+		Com_Printf( "Error: Failed to write the demo, stopping recording\n" );
+		CL_Stop_f();
+	}
 }
 
 /*
@@ -68,7 +72,12 @@ void CL_Stop_f( void )
 		return;
 	}
 
-	// finish up
+	// finish up, an incomplete demo is not worth keeping
+	if( !SNAP_DestroyDemoWriter( &cls.demo.writer ) && !cancel )
+	{
+		Com_Printf( "Error: Demo recording is incomplete, discarding it\n" );
+		cancel = true;
+	}
 	SNAP_StopDemoRecording( cls.demo.file );
 
 	// write some meta information about the match/demo
@@ -184,6 +193,7 @@ void CL_Record_f( void )
 
 	// store the name in case we need it later
 	cls.demo.filename = name;
+	cls.demo.writer = SNAP_CreateDemoWriter( cls.demo.file );
 	cls.demo.recording = true;
 	cls.demo.basetime = cls.demo.duration = cls.demo.time = 0;
 	cls.demo.name = ZoneCopyString( demoname );
@@ -447,6 +447,8 @@ void CL_GameModule_Init( void )
 
 	import.GetConfigString = CL_GameModule_GetConfigString;
 	import.Milliseconds = Sys_Milliseconds;
+	import.Prof_Begin = Prof_Begin;
+	import.Prof_End = Prof_End;
 	import.DownloadRequest = CL_DownloadRequest;
 
 	import.NET_GetUserCmd = CL_GameModule_NET_GetUserCmd;
@@ -685,8 +687,12 @@ bool CL_GameModule_NewSnapshot( int pendingSnapshot )
 void CL_GameModule_RenderView( float stereo_separation )
 {
 	if( cge && cls.cgameActive )
+	{
+		Prof_Begin( "cgame" );
 		cge->RenderView( cls.frametime, cls.realframetime, cls.realtime, cl.serverTime, stereo_separation, 
-		cl_extrapolate->integer && !cls.demo.playing ? cl_extrapolationTime->integer : 0, cl_flip->integer != 0 );
+			cl_extrapolate->integer && !cls.demo.playing ? cl_extrapolationTime->integer : 0, cl_flip->integer != 0 );
+		Prof_End();
+	}
 }
 
 /*
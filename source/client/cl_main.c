@@ -79,6 +79,8 @@ cvar_t *cl_downloads_from_web_timeout;
 cvar_t *cl_download_allow_modules;
 cvar_t *cl_checkForUpdate;
 
+// registered by qcommon
+static cvar_handle_t cl_timescale = CVAR_HANDLE( "timescale" );
 
 static char cl_nextString[MAX_STRING_CHARS];
 static char cl_connectChain[MAX_STRING_CHARS];
@@ -1499,6 +1501,10 @@ static unsigned int CL_LoadMap( const char *name )
 
 	assert( !cl.cms );
 
+	// measured by CL_MapLoaded
+	cl.maploadsize = Mem_TotalSize();
+	Mem_ResetPeakSize();
+
 	// if local server is running, share the collision model,
 	// increasing the ref counter
 	if( Com_ServerState() ) {
@@ -1530,6 +1536,22 @@ static unsigned int CL_LoadMap( const char *name )
 	return map_checksum;
 }
 
+/*
+* CL_MapLoaded
+*
+* Called once the cgame has registered the world model. The renderer has loaded
+* it from the same copy of the file as the collision map, which can go now.
+*/
+static void CL_MapLoaded( void )
+{
+	if( cl.cms )
+		CM_ReleaseMapFile( cl.cms );
+
+	Com_DPrintf( "Map loaded: %u KiB peak heap over the %u KiB before loading, %u KiB kept\n",
+		(unsigned)( ( Mem_PeakSize() - min( Mem_PeakSize(), cl.maploadsize ) ) >> 10 ), (unsigned)( cl.maploadsize >> 10 ),
+		(unsigned)( ( Mem_TotalSize() - min( Mem_TotalSize(), cl.maploadsize ) ) >> 10 ) );
+}
+
 void CL_RequestNextDownload( void )
 {
 	char tempname[MAX_CONFIGSTRING_CHARS + 4];
@@ -1731,6 +1753,7 @@ void CL_RequestNextDownload( void )
 
 	// load client game module
 	CL_GameModule_Init();
+	CL_MapLoaded();
 	CL_AddReliableCommand( va( "begin %i\n", precache_spawncount ) );
 
 	CL_Mumble_Link();
@@ -1753,6 +1776,7 @@ void CL_Precache_f( void )
 			CL_LoadMap( cl.configstrings[CS_WORLDMODEL] );
 
 			CL_GameModule_Init();
+			CL_MapLoaded();
 		}
 		else
 		{
@@ -2557,6 +2581,7 @@ static void CL_NetFrame( int realmsec, int gamemsec )
 		CL_ReadDemoPackets(); // fetch results from demo file
 	}
 	CL_ReadPackets(); // fetch results from server
+	CL_SendDownloadAck();
 
 	// send packets to server
 	if( cls.netchan.unsentFragments )
@@ -2567,6 +2592,7 @@ static void CL_NetFrame( int realmsec, int gamemsec )
 	// resend a connection request if necessary
 	CL_CheckForResend();
 	CL_CheckDownloadTimeout();
+	CL_CheckGamestateTimeout();
 
 	CL_ServerListFrame();
 }
@@ -2614,7 +2640,7 @@ void CL_Frame( int realmsec, int gamemsec )
 		// fixed time for next frame
 		if( cls.demo.avi_video )
 		{
-			gamemsec = ( 1000.0 / (double)cl_demoavi_fps->integer ) * Cvar_Value( "timescale" );
+			gamemsec = ( 1000.0 / (double)cl_demoavi_fps->integer ) * Cvar_HandleValue( &cl_timescale );
 			if( gamemsec < 1 )
 				gamemsec = 1;
 		}
@@ -20,10 +20,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // cl_parse.c  -- parse a message received from the server
 
 #include "client.h"
+#include "../qcommon/compression.h"
 
 static void CL_InitServerDownload( const char *filename, int size, unsigned checksum, bool allow_localhttpdownload,
-							const char *url, bool initial );
+							const char *url, bool windowed, bool initial );
 void CL_StopServerDownload( void );
+static void CL_FreeGamestate( void );
+static void CL_RequestGamestate( int offset );
 
 //=============================================================================
 
@@ -119,7 +122,7 @@ bool CL_DownloadRequest( const char *filename, bool requestpak )
 	cls.download.requestname = Mem_ZoneMalloc( sizeof( char ) * ( strlen( filename ) + 1 ) );
 	Q_strncpyz( cls.download.requestname, filename, sizeof( char ) * ( strlen( filename ) + 1 ) );
 	cls.download.timeout = Sys_Milliseconds() + 5000;
-	CL_AddReliableCommand( va( "download %i \"%s\"", requestpak, filename ) );
+	CL_AddReliableCommand( va( "download %i \"%s\" 1", requestpak, filename ) ); // 1: we can do windowed transfers
 
 	return true;
 }
@@ -305,10 +308,11 @@ static void CL_WebDownloadDoneCb( int status, const char *contentType, void *pri
 		unsigned checksum = download.checksum;
 		char *url = ZoneCopyString( download.web_url );
 		bool allow_localhttp = download.web_local_http;
+		bool windowed = download.windowed;
 
 		cls.download.cancelled = true; // remove the temp file
 		CL_StopServerDownload();
-		CL_InitServerDownload( filename, size, checksum, allow_localhttp, url, false );
+		CL_InitServerDownload( filename, size, checksum, allow_localhttp, url, windowed, false );
 		
 		Mem_Free( filename );
 		Mem_Free( url );
@@ -345,13 +349,82 @@ static size_t CL_WebDownloadReadCb( const void *buf, size_t numb, float percenta
 	return stop ? !numb : write;
 }
 
+/*
+* CL_AddDownloadAck
+*/
+static void CL_AddDownloadAck( void )
+{
+	CL_AddReliableCommand( va( "dlack \"%s\" %i %u", cls.download.name, cls.download.window.base, cls.download.window.mask ) );
+	cls.download.ackpending = false;
+}
+
+/*
+* CL_SendDownloadAck
+* 
+* Acknowledges the blocks of a windowed download received this frame.
+* Acks are cumulative, so they are held back while too many reliable
+* commands are still unacknowledged by the server.
+*/
+void CL_SendDownloadAck( void )
+{
+	if( !cls.download.ackpending || !cls.download.filenum || !cls.download.windowed )
+		return;
+
+	if( cls.reliableSequence - cls.reliableAcknowledge >= MAX_RELIABLE_COMMANDS / 2 )
+		return;
+
+	CL_AddDownloadAck();
+}
+
+/*
+* CL_PreallocateDownload
+* 
+* Grows the temporary file to its full size, so that windowed downloads can
+* write blocks in any order. A partial file left by a sequential download is
+* resumed, a full size one may have holes from an interrupted windowed
+* download, so it's started over.
+*/
+static bool CL_PreallocateDownload( void )
+{
+	static const uint8_t zeros[4096];
+	size_t offset, block;
+
+	offset = cls.download.offset;
+	if( offset >= cls.download.size )
+	{
+		FS_FCloseFile( cls.download.filenum );
+		offset = 0;
+		if( FS_FOpenBaseFile( cls.download.tempname, &cls.download.filenum, FS_WRITE ) == -1 || !cls.download.filenum )
+			return false;
+	}
+
+	cls.download.offset = cls.download.baseoffset = offset;
+
+	for( ; offset < cls.download.size; offset += block )
+	{
+		block = min( sizeof( zeros ), cls.download.size - offset );
+		FS_Write( zeros, block, cls.download.filenum );
+	}
+	FS_FCloseFile( cls.download.filenum );
+
+	if( FS_FOpenBaseFile( cls.download.tempname, &cls.download.filenum, FS_READ|FS_UPDATE ) != (int)cls.download.size )
+	{
+		if( cls.download.filenum )
+			FS_FCloseFile( cls.download.filenum );
+		cls.download.filenum = 0;
+		return false;
+	}
+
+	return true;
+}
+
 /*
 * CL_InitDownload
 * 
 * Hanldles server's initdownload message, starts web or server download if possible
 */
 static void CL_InitServerDownload( const char *filename, int size, unsigned checksum, bool allow_localhttpdownload,
-							  const char *url, bool initial )
+							  const char *url, bool windowed, bool initial )
 {
 	int alloc_size;
 	bool modules_download = false;
@@ -534,6 +607,8 @@ static void CL_InitServerDownload( const char *filename, int size, unsigned chec
 	cls.download.timestart = Sys_Milliseconds();
 	cls.download.offset = 0;
 	cls.download.baseoffset = 0;
+	cls.download.windowed = windowed;
+	cls.download.ackpending = false;
 	cls.download.pending_reconnect = false;
 
 	Cvar_ForceSet( "cl_download_name", COM_FileBase( filename ) );
@@ -627,6 +702,22 @@ static void CL_InitServerDownload( const char *filename, int size, unsigned chec
 	cls.download.timeout = Sys_Milliseconds() + 3000;
 	cls.download.retries = 0;
 
+	if( cls.download.windowed )
+	{
+		if( !CL_PreallocateDownload() )
+		{
+			Com_Printf( "Can't download, couldn't allocate %s\n", cls.download.tempname );
+			CL_DownloadDone();
+			return;
+		}
+
+		// the first ack tells the server where to start
+		DLWindow_InitReceiver( &cls.download.window, cls.download.size, cls.download.offset );
+		cls.download.offset = cls.download.baseoffset = cls.download.window.bytes;
+		CL_AddDownloadAck();
+		return;
+	}
+
 	CL_AddReliableCommand( va( "nextdl \"%s\" %i", cls.download.name, cls.download.offset ) );
 }
 
@@ -640,6 +731,7 @@ static void CL_InitDownload_f( void )
 	int size;
 	unsigned checksum;
 	bool allow_localhttpdownload;
+	bool windowed;
 	
 	// ignore download commands coming from demo files
 	if( cls.demo.playing )
@@ -651,8 +743,9 @@ static void CL_InitDownload_f( void )
 	checksum = strtoul( Cmd_Argv( 3 ), NULL, 10 );
 	allow_localhttpdownload = ( atoi( Cmd_Argv( 4 ) ) != 0 ) && cls.httpbaseurl != NULL;
 	url = Cmd_Argv( 5 );
+	windowed = atoi( Cmd_Argv( 6 ) ) != 0;
 	
-	CL_InitServerDownload( filename, size, checksum, allow_localhttpdownload, url, true );
+	CL_InitServerDownload( filename, size, checksum, allow_localhttpdownload, url, windowed, true );
 }
 
 /*
@@ -687,6 +780,8 @@ void CL_StopServerDownload( void )
 	cls.download.timeout = 0;
 	cls.download.retries = 0;
 	cls.download.web = false;
+	cls.download.windowed = false;
+	cls.download.ackpending = false;
 
 	Cvar_ForceSet( "cl_download_name", "" );
 	Cvar_ForceSet( "cl_download_percent", "0" );
@@ -707,6 +802,11 @@ static void CL_RetryDownload( void )
 		CL_AddReliableCommand( va( "nextdl \"%s\" %i", cls.download.name, -2 ) );
 		CL_DownloadDone();
 	}
+	else if( cls.download.windowed )
+	{
+		cls.download.timeout = Sys_Milliseconds() + 3000;
+		CL_AddDownloadAck();
+	}
 	else
 	{
 		cls.download.timeout = Sys_Milliseconds() + 3000;
@@ -833,28 +933,49 @@ static void CL_ParseDownload( msg_t *msg )
 		return;
 	}
 
-	if( cls.download.offset != offset )
+	if( cls.download.windowed )
 	{
-		Com_Printf( "Error: Download message for wrong position\n" );
+		// blocks may arrive out of order or more than once
+		if( !DLWindow_ReceiveBlock( &cls.download.window, offset, size ) )
+		{
+			msg->readcount += size;
+			return;
+		}
+
+		FS_Seek( cls.download.filenum, offset, FS_SEEK_SET );
+		FS_Write( msg->data + msg->readcount, size, cls.download.filenum );
 		msg->readcount += size;
-		CL_RetryDownload();
-		return;
+		cls.download.offset = cls.download.window.bytes;
+	}
+	else
+	{
+		if( cls.download.offset != offset )
+		{
+			Com_Printf( "Error: Download message for wrong position\n" );
+			msg->readcount += size;
+			CL_RetryDownload();
+			return;
+		}
+
+		FS_Write( msg->data + msg->readcount, size, cls.download.filenum );
+		msg->readcount += size;
+		cls.download.offset += size;
 	}
 
-	FS_Write( msg->data + msg->readcount, size, cls.download.filenum );
-	msg->readcount += size;
-	cls.download.offset += size;
 	cls.download.percent = (double)cls.download.offset / (double)cls.download.size;
 	clamp( cls.download.percent, 0, 1 );
 
 	Cvar_ForceSet( "cl_download_percent", va( "%.1f", cls.download.percent * 100 ) );
 
-	if( cls.download.offset < cls.download.size )
+	if( cls.download.windowed ? !DLWindow_ReceiverDone( &cls.download.window ) : cls.download.offset < cls.download.size )
 	{
 		cls.download.timeout = Sys_Milliseconds() + 3000;
 		cls.download.retries = 0;
 
-		CL_AddReliableCommand( va( "nextdl \"%s\" %i", cls.download.name, cls.download.offset ) );
+		if( cls.download.windowed )
+			cls.download.ackpending = true;
+		else
+			CL_AddReliableCommand( va( "nextdl \"%s\" %i", cls.download.name, cls.download.offset ) );
 	}
 	else
 	{
@@ -1007,7 +1128,15 @@ static void CL_ParseServerData( msg_t *msg )
 	//assert( numpure == 0 );
 
 	// get the configstrings request
-	CL_AddReliableCommand( va( "configstrings %i 0", cl.servercount ) );
+	CL_FreeGamestate();
+	if( ( sv_bitflags & SV_BITFLAGS_GAMESTATE ) && !cls.demo.playing )
+	{
+		CL_RequestGamestate( 0 );
+	}
+	else
+	{
+		CL_AddReliableCommand( va( "configstrings %i 0", cl.servercount ) );
+	}
 
 	old_sv_pure = cls.sv_pure;
 	cls.sv_pure = ( sv_bitflags & SV_BITFLAGS_PURE ) != 0;
@@ -1199,6 +1328,250 @@ static void CL_UpdateConfigString( int idx, const char *s )
 	CL_GameModule_ConfigString( idx, s );
 }
 
+/*
+
+BULK GAMESTATE
+
+*/
+
+#define GAMESTATE_TIMEOUT	1000
+
+static struct
+{
+	bool pending;
+	unsigned int requesttime;       // since serverdata
+	unsigned int time;              // last request or chunk
+	int spawncount, id;
+	int size, rawsize;
+	int numchunks, numreceived;
+	uint8_t *data;
+	uint8_t *chunks;                // received flags
+	uint8_t csupdated[MAX_CONFIGSTRINGS/8]; // configstrings received as commands in the meantime
+} cl_gamestate;
+
+/*
+* CL_FreeGamestate
+*/
+static void CL_FreeGamestate( void )
+{
+	if( cl_gamestate.data )
+		Mem_ZoneFree( cl_gamestate.data );
+	memset( &cl_gamestate, 0, sizeof( cl_gamestate ) );
+}
+
+/*
+* CL_RequestGamestate
+*/
+static void CL_RequestGamestate( int offset )
+{
+	if( !cl_gamestate.pending )
+	{
+		cl_gamestate.pending = true;
+		cl_gamestate.requesttime = Sys_Milliseconds();
+	}
+	cl_gamestate.time = Sys_Milliseconds();
+
+	CL_AddReliableCommand( va( "gamestate %i %i", cl.servercount, offset ) );
+}
+
+/*
+* CL_RequestMissingGamestate
+*
+* Asks the server to resend the chunks we don't have, as a hex mask
+* starting from the first missing one
+*/
+static void CL_RequestMissingGamestate( void )
+{
+	int i, first, bits;
+	char mask[( GAMESTATE_MAX_CHUNKS + 3 ) / 4 + 1];
+	size_t len;
+
+	if( !cl_gamestate.data )
+	{
+		CL_RequestGamestate( 0 );
+		return;
+	}
+
+	for( first = 0; first < cl_gamestate.numchunks; first++ )
+	{
+		if( !cl_gamestate.chunks[first] )
+			break;
+	}
+
+	len = 0;
+	for( i = first; i < cl_gamestate.numchunks && len < sizeof( mask ) - 1; i += 4 )
+	{
+		bits = ( !cl_gamestate.chunks[i] ? 1 : 0 )
+			| ( i + 1 < cl_gamestate.numchunks && !cl_gamestate.chunks[i + 1] ? 2 : 0 )
+			| ( i + 2 < cl_gamestate.numchunks && !cl_gamestate.chunks[i + 2] ? 4 : 0 )
+			| ( i + 3 < cl_gamestate.numchunks && !cl_gamestate.chunks[i + 3] ? 8 : 0 );
+		mask[len++] = "0123456789abcdef"[bits];
+	}
+	mask[len] = '\0';
+
+	cl_gamestate.time = Sys_Milliseconds();
+
+	CL_AddReliableCommand( va( "gamestate %i %i %i %s", cl.servercount, first * GAMESTATE_CHUNK_SIZE,
+		cl_gamestate.id, mask ) );
+}
+
+/*
+* CL_CheckGamestateTimeout
+*/
+void CL_CheckGamestateTimeout( void )
+{
+	if( !cl_gamestate.pending )
+		return;
+
+	if( cls.state < CA_CONNECTED )
+	{
+		CL_FreeGamestate();
+		return;
+	}
+
+	if( Sys_Milliseconds() > cl_gamestate.time + GAMESTATE_TIMEOUT )
+	{
+		Com_DPrintf( "Gamestate timed out, %i of %i chunks received\n", cl_gamestate.numreceived, cl_gamestate.numchunks );
+		CL_RequestMissingGamestate();
+	}
+}
+
+/*
+* CL_ApplyGamestate
+*/
+static void CL_ApplyGamestate( void )
+{
+	int idx;
+	uLongf rawsize;
+	uint8_t *raw;
+	msg_t msg;
+	const char *s;
+
+	rawsize = cl_gamestate.rawsize;
+	raw = Mem_TempMalloc( rawsize );
+
+	if( qzuncompress( raw, &rawsize, cl_gamestate.data, cl_gamestate.size ) != Z_OK || rawsize != (uLongf)cl_gamestate.rawsize )
+	{
+		Mem_TempFree( raw );
+		CL_FreeGamestate();
+
+		// start over the old way
+		Com_Printf( "Bad gamestate, requesting configstrings\n" );
+		CL_AddReliableCommand( va( "configstrings %i 0", cl.servercount ) );
+		return;
+	}
+
+	MSG_Init( &msg, raw, rawsize );
+	msg.cursize = rawsize;
+
+	while( ( idx = MSG_ReadShort( &msg ) ) != -1 )
+	{
+		if( idx < 0 || idx >= MAX_CONFIGSTRINGS || msg.readcount > msg.cursize )
+			Com_Error( ERR_DROP, "CL_ApplyGamestate: bad configstring index" );
+
+		s = MSG_ReadString( &msg );
+
+		// a newer value has already been received as a command
+		if( cl_gamestate.csupdated[idx>>3] & ( 1<<( idx&7 ) ) )
+			continue;
+		CL_UpdateConfigString( idx, s );
+	}
+
+	while( MSG_ReadByte( &msg ) == svc_spawnbaseline )
+		SNAP_ParseBaseline( &msg, cl_baselines );
+
+	Mem_TempFree( raw );
+
+	Com_DPrintf( "Gamestate received in %u msec, %i bytes (%i compressed)\n",
+		Sys_Milliseconds() - cl_gamestate.requesttime, cl_gamestate.rawsize, cl_gamestate.size );
+
+	CL_FreeGamestate();
+
+	Cmd_TokenizeString( va( "precache %i", cl.servercount ) );
+	CL_Precache_f();
+}
+
+/*
+* CL_ParseGamestate
+*/
+static void CL_ParseGamestate( msg_t *msg, int len )
+{
+	int spawncount, id, size, rawsize, offset, chunk;
+	size_t end;
+
+	end = msg->readcount + len;
+	if( len < 20 )
+		goto skip;
+
+	spawncount = MSG_ReadLong( msg );
+	id = MSG_ReadLong( msg );
+	size = MSG_ReadLong( msg );
+	rawsize = MSG_ReadLong( msg );
+	offset = MSG_ReadLong( msg );
+	len -= 20;
+
+	// stale or unrequested
+	if( !cl_gamestate.pending || spawncount != cl.servercount )
+		goto skip;
+
+	// the server couldn't build it
+	if( !size )
+	{
+		msg->readcount = end;
+		CL_FreeGamestate();
+		CL_AddReliableCommand( va( "configstrings %i 0", cl.servercount ) );
+		return;
+	}
+
+	if( size <= 0 || rawsize <= 0 || rawsize > (int)GAMESTATE_MAX_SIZE || size > rawsize + rawsize / 100 + 64
+		|| offset < 0 || offset % GAMESTATE_CHUNK_SIZE || offset >= size || len <= 0
+		|| len != min( size - offset, GAMESTATE_CHUNK_SIZE ) )
+	{
+		Com_Printf( "CL_ParseGamestate: bad chunk\n" );
+		goto skip;
+	}
+
+	// the server rebuilt the gamestate, start over
+	if( !cl_gamestate.data || cl_gamestate.spawncount != spawncount || cl_gamestate.id != id )
+	{
+		if( cl_gamestate.data )
+			Mem_ZoneFree( cl_gamestate.data );
+
+		cl_gamestate.spawncount = spawncount;
+		cl_gamestate.id = id;
+		cl_gamestate.size = size;
+		cl_gamestate.rawsize = rawsize;
+		cl_gamestate.numchunks = ( size + GAMESTATE_CHUNK_SIZE - 1 ) / GAMESTATE_CHUNK_SIZE;
+		cl_gamestate.numreceived = 0;
+		cl_gamestate.data = Mem_ZoneMalloc( size + cl_gamestate.numchunks );
+		cl_gamestate.chunks = cl_gamestate.data + size;
+	}
+
+	cl_gamestate.time = Sys_Milliseconds();
+
+	chunk = offset / GAMESTATE_CHUNK_SIZE;
+	if( cl_gamestate.chunks[chunk] )
+		goto skip;
+
+	MSG_ReadData( msg, cl_gamestate.data + offset, len );
+	cl_gamestate.chunks[chunk] = 1;
+	cl_gamestate.numreceived++;
+
+	if( cl_gamestate.numreceived == cl_gamestate.numchunks )
+	{
+		msg->readcount = end;
+		CL_ApplyGamestate();
+		return;
+	}
+
+	// the server sends chunks in order, so holes before the last one are losses
+	if( chunk == cl_gamestate.numchunks - 1 )
+		CL_RequestMissingGamestate();
+
+skip:
+	msg->readcount = end;
+}
+
 /*
 * CL_ParseConfigstringCommand
 */
@@ -1217,6 +1590,9 @@ static void CL_ParseConfigstringCommand( void )
 		idx = atoi( Cmd_Argv( i ) );
 		s = Cmd_Argv( i + 1 );
 
+		if( cl_gamestate.pending && idx >= 0 && idx < MAX_CONFIGSTRINGS )
+			cl_gamestate.csupdated[idx>>3] |= 1<<( idx&7 );
+
 		CL_UpdateConfigString( idx, s );
 	}
 }
@@ -1439,6 +1815,9 @@ void CL_ParseServerMessage( msg_t *msg )
 
 				switch( ext )
 				{
+				case SVC_EXT_GAMESTATE:
+					CL_ParseGamestate( msg, len );
+					break;
 				default:
 					// unsupported
 					MSG_SkipData( msg, len );
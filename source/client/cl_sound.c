@@ -259,6 +259,9 @@ void CL_SoundModule_Init( bool verbose )
 	import.Sys_Milliseconds = Sys_Milliseconds;
 	import.Sys_Sleep = Sys_Sleep;
 
+	import.Prof_Begin = Prof_Begin;
+	import.Prof_End = Prof_End;
+
 	import.Sys_LoadLibrary = Com_LoadSysLibrary;
 	import.Sys_UnloadLibrary = Com_UnloadLibrary;
 
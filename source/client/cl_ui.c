@@ -299,6 +299,8 @@ void CL_UIModule_Init( void )
 
 	import.Milliseconds = Sys_Milliseconds;
 	import.Microseconds = Sys_Microseconds;
+	import.Prof_Begin = Prof_Begin;
+	import.Prof_End = Prof_End;
 
 	import.AsyncStream_UrlEncode = AsyncStream_UrlEncode;
 	import.AsyncStream_UrlDecode = AsyncStream_UrlDecode;
@@ -406,9 +408,13 @@ void CL_UIModule_TouchAllAssets( void )
 void CL_UIModule_Refresh( bool backGround, bool showCursor )
 {
 	if( uie )
+	{
+		Prof_Begin( "ui" );
 		uie->Refresh( cls.realtime, Com_ClientState(), Com_ServerState(), 
 			cls.demo.playing, cls.demo.name, cls.demo.paused, Q_rint(cls.demo.time/1000.0f), 
 			backGround, showCursor );
+		Prof_End();
+	}
 }
 
 /*
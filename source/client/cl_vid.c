@@ -314,7 +314,13 @@ static void VID_RefModule_MemEmptyPool( mempool_t *pool, const char *filename, i
 
 static struct cinematics_s *VID_RefModule_CIN_Open( const char *name, unsigned int start_time, bool *yuv, float *framerate )
 {
-	return CIN_Open( name, start_time, CIN_LOOP, yuv, framerate );
+	struct cinematics_s *cin;
+
+	// video surfaces don't play sound, so decode them ahead on a separate thread
+	// and wait for the first couple of frames while we are still loading
+	cin = CIN_Open( name, start_time, CIN_LOOP|CIN_DECODEAHEAD, yuv, framerate );
+	CIN_Preroll( cin, 2 );
+	return cin;
 }
 
 /*
@@ -338,6 +344,9 @@ static bool VID_LoadRefresh( const char *name )
 	import.Sys_Microseconds = &Sys_Microseconds;
 	import.Sys_Sleep = &Sys_Sleep;
 
+	import.Prof_Begin = &Prof_Begin;
+	import.Prof_End = &Prof_End;
+
 	import.Com_LoadSysLibrary = Com_LoadSysLibrary;
 	import.Com_UnloadLibrary = Com_UnloadLibrary;
 	import.Com_LibraryProcAddress = Com_LibraryProcAddress;
@@ -380,6 +389,8 @@ static bool VID_LoadRefresh( const char *name )
 	import.FS_WriteDirectory = &FS_WriteDirectory;
 	import.FS_MediaDirectory = &FS_MediaDirectory;
 	import.FS_AddFileToMedia = &FS_AddFileToMedia;
+	import.FS_LoadMappedFile = &FS_LoadMappedFile;
+	import.FS_FreeMappedFile = &FS_FreeMappedFile;
 
 	import.CIN_Open = &VID_RefModule_CIN_Open;
 	import.CIN_NeedNextFrame = &CIN_NeedNextFrame;
@@ -90,6 +90,7 @@ typedef struct
 	uint8_t *frames_areabits;
 
 	cmodel_state_t *cms;
+	size_t maploadsize;				// allocated memory before the map started loading
 
 	// the client maintains its own idea of view angles, which are
 	// sent to the server each frame.  It is cleared to 0 upon entering each level.
@@ -163,6 +164,9 @@ typedef struct
 	size_t offset;
 	int retries;
 	size_t baseoffset;				// for download speed calculation when resuming downloads
+	bool windowed;					// blocks may arrive in any order, we acknowledge them with dlack
+	bool ackpending;
+	dlwindow_receiver_t window;
 
 	// web download
 	bool web;
@@ -186,6 +190,7 @@ typedef struct
 	bool paused;		// A boolean to test if demo is paused -- PLX
 
 	int file;
+	snap_demowriter_t *writer;	// writes the messages on a separate thread
 	char *filename;
 
 	time_t localtime;		// time of day of demo recording
@@ -588,6 +593,8 @@ void CL_DownloadCancel_f( void );
 void CL_DownloadDone( void );
 void CL_RequestNextDownload( void );
 void CL_CheckDownloadTimeout( void );
+void CL_CheckGamestateTimeout( void );
+void CL_SendDownloadAck( void );
 
 //
 // cl_screen.c
@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 // snd_public.h -- sound dll information visible to engine
 
-#define	SOUND_API_VERSION   39
+#define	SOUND_API_VERSION   40
 
 #define	ATTN_NONE 0
 
@@ -81,6 +81,9 @@ typedef struct
 	unsigned int ( *Sys_Milliseconds )( void );
 	void ( *Sys_Sleep )( unsigned int milliseconds );
 
+	void ( *Prof_Begin )( const char *name );
+	void ( *Prof_End )( void );
+
 	void *( *Sys_LoadLibrary )( const char *name, dllfunc_t *funcs );
 	void ( *Sys_UnloadLibrary )( void **lib );
 
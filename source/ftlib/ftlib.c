@@ -965,6 +965,9 @@ void FTLIB_FreeFonts( bool verbose )
 	qfontfamily_t *qfamily, *nextqfamily;
 	qfontface_t *qface, *nextqface;
 
+	// cached string layouts point to the glyphs
+	FTLIB_FreeLayoutCache();
+
 	// unload all font families
 	for( qfamily = fontFamilies; qfamily; qfamily = nextqfamily ) {
 		nextqfamily = qfamily->next;
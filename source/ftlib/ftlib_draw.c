@@ -24,7 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 static fdrawchar_t drawCharIntercept = NULL;
 
 //===============================================================================
-//STRINGS HELPERS
+//FONT METRICS
 //===============================================================================
 
 /*
@@ -41,165 +41,498 @@ static int FTLIB_GrabChar( const char **pstr, wchar_t *wc, int *colorindex, int
 	return Q_GrabWCharFromColorString( pstr, wc, colorindex );
 }
 
+//===============================================================================
+//LAYOUT CACHE
+//===============================================================================
+
+// Most strings are drawn unchanged frame after frame, so instead of decoding them
+// and looking up each glyph every time, the glyph runs are cached per font and flags,
+// together with line breaks for wrapped strings.
+
+#define FTLIB_LAYOUT_CACHE_SIZE		512
+#define FTLIB_LAYOUT_HASH_SIZE		256
+#define FTLIB_LAYOUT_FLAGS			( TEXTDRAWFLAG_NO_COLORS|TEXTDRAWFLAG_KERNING )
+
+typedef struct
+{
+	qglyph_t *glyph;			// NULL for line breaks
+	wchar_t num;
+	short kerning;				// to the previous glyph in the run
+	short colorindex;			// set right before this glyph, -1 if none
+	unsigned int offset;		// of the character in the string
+} ftlib_runglyph_t;
+
+typedef struct
+{
+	int first;					// first glyph in the run
+	int numChars;				// number of glyphs to draw
+	int width;
+	int colorindex;				// color of the first glyph, -1 for the default one
+} ftlib_runline_t;
+
+typedef struct ftlib_layout_s
+{
+	unsigned int hash;
+	qfontface_t *font;
+	int flags;
+	int wrapwidth;				// 0 for single line runs, which stop at the first line break
+
+	char *str;
+	size_t len, strSize;
+
+	ftlib_runglyph_t *glyphs;
+	int numGlyphs, maxGlyphs;
+	unsigned int end;			// offset where single line parsing stopped
+
+	ftlib_runline_t *lines;
+	int numLines, maxLines;
+
+	struct ftlib_layout_s *prev, *next;
+	struct ftlib_layout_s *hashNext;
+} ftlib_layout_t;
+
+static ftlib_layout_t layouts[FTLIB_LAYOUT_CACHE_SIZE];
+static ftlib_layout_t layouts_headnode;		// most recently used first
+static ftlib_layout_t *layouts_hash[FTLIB_LAYOUT_HASH_SIZE];
+static bool layouts_initialized = false;
+
 /*
-* FTLIB_FontSize
+* FTLIB_InitLayoutCache
 */
-size_t FTLIB_FontSize( qfontface_t *font )
+static void FTLIB_InitLayoutCache( void )
 {
-	if( !font ) {
-		return 0;
+	int i;
+
+	memset( layouts_hash, 0, sizeof( layouts_hash ) );
+
+	layouts_headnode.prev = layouts_headnode.next = &layouts_headnode;
+	for( i = 0; i < FTLIB_LAYOUT_CACHE_SIZE; i++ ) {
+		layouts[i].font = NULL;
+		layouts[i].prev = &layouts_headnode;
+		layouts[i].next = layouts_headnode.next;
+		layouts[i].next->prev = &layouts[i];
+		layouts_headnode.next = &layouts[i];
 	}
-	return font->size;
+
+	layouts_initialized = true;
 }
 
 /*
-* FTLIB_FontHeight
+* FTLIB_FreeLayoutCache
+*
+* Called when fonts are freed, as cached runs point to their glyphs.
 */
-size_t FTLIB_FontHeight( qfontface_t *font )
+void FTLIB_FreeLayoutCache( void )
 {
-	if( !font ) {
-		return 0;
+	int i;
+	ftlib_layout_t *layout;
+
+	if( !layouts_initialized ) {
+		return;
 	}
-	return font->height;
+
+	for( i = 0, layout = layouts; i < FTLIB_LAYOUT_CACHE_SIZE; i++, layout++ ) {
+		if( layout->str ) {
+			FTLIB_Free( layout->str );
+		}
+		if( layout->glyphs ) {
+			FTLIB_Free( layout->glyphs );
+		}
+		if( layout->lines ) {
+			FTLIB_Free( layout->lines );
+		}
+		memset( layout, 0, sizeof( *layout ) );
+	}
+
+	layouts_initialized = false;
 }
 
 /*
-* FTLIB_strWidth
-* doesn't count invisible characters. Counts up to given length, if any.
+* FTLIB_GrowBuffer
 */
-size_t FTLIB_strWidth( const char *str, qfontface_t *font, size_t maxlen, int flags )
+static void *FTLIB_GrowBuffer( void *buf, int *maxElems, int numElems, size_t elemSize )
 {
-	const char *s = str, *olds;
-	size_t width = 0;
-	wchar_t num, prev_num = 0;
-	qglyph_t *glyph, *prev_glyph = NULL;
-	renderString_f renderString;
-	getKerning_f getKerning;
-	bool hasKerning;
+	if( numElems <= *maxElems ) {
+		return buf;
+	}
 
-	if( !str || !font )
-		return 0;
+	*maxElems = ALIGN( numElems, 64 );
+	if( !buf ) {
+		return FTLIB_Alloc( ftlibPool, *maxElems * elemSize );
+	}
+	return FTLIB_Realloc( buf, *maxElems * elemSize );
+}
+
+/*
+* FTLIB_BuildRun
+*
+* Decodes the string into glyphs, rendering the missing ones.
+*/
+static void FTLIB_BuildRun( ftlib_layout_t *layout )
+{
+	const char *s = layout->str, *olds;
+	int gc, colorindex = 0, pendingcolor = -1;
+	wchar_t num;
+	qfontface_t *font = layout->font;
+	qglyph_t *glyph, *prev_glyph = NULL;
+	ftlib_runglyph_t *rg;
+	bool hasKerning = ( layout->flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
 
-	renderString = font->f->renderString;
-	getKerning = font->f->getKerning;
-	hasKerning = ( flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
+	layout->numGlyphs = 0;
 
-	while( *s && *s != '\n' )
+	while( 1 )
 	{
-		if( maxlen && (size_t)( s - str ) >= maxlen )  // stop counting at desired len
-			return width;
-
 		olds = s;
-
-		switch( FTLIB_GrabChar( &s, &num, NULL, flags ) )
+		gc = FTLIB_GrabChar( &s, &num, &colorindex, layout->flags );
+		if( gc == GRABCHAR_CHAR )
 		{
-		case GRABCHAR_CHAR:
-			if( num < ' ' )
-				break;
-
-			glyph = FTLIB_GetGlyph( font, num );
-			if( !glyph )
+			if( num == '\n' )
 			{
-				num = FTLIB_REPLACEMENT_GLYPH;
-				glyph = FTLIB_GetGlyph( font, num );
+				if( !layout->wrapwidth )
+					break;
+				glyph = NULL;
 			}
+			else
+			{
+				if( num < ' ' )
+					continue;
 
-			if( !glyph->shader )
-				renderString( font, olds );
-
-			if( prev_num && hasKerning )
-				width += getKerning( font, prev_glyph, glyph );
+				glyph = FTLIB_GetGlyph( font, num );
+				if( !glyph )
+				{
+					num = FTLIB_REPLACEMENT_GLYPH;
+					glyph = FTLIB_GetGlyph( font, num );
+				}
 
-			width += glyph->x_advance;
+				if( !glyph->shader )
+					font->f->renderString( font, olds );
+			}
 
-			prev_num = num;
+			layout->glyphs = FTLIB_GrowBuffer( layout->glyphs, &layout->maxGlyphs, layout->numGlyphs + 1, sizeof( *rg ) );
+			rg = &layout->glyphs[layout->numGlyphs++];
+			rg->glyph = glyph;
+			rg->num = num;
+			rg->kerning = 0;
+			if( hasKerning && glyph && prev_glyph )
+				rg->kerning = font->f->getKerning( font, prev_glyph, glyph );
+			rg->colorindex = pendingcolor;
+			rg->offset = olds - layout->str;
+
+			pendingcolor = -1;
 			prev_glyph = glyph;
+		}
+		else if( gc == GRABCHAR_COLOR )
+		{
+			assert( ( unsigned )colorindex < MAX_S_COLORS );
+			pendingcolor = colorindex;
+		}
+		else if( gc == GRABCHAR_END )
 			break;
-
-		case GRABCHAR_COLOR:
-			break;
-
-		case GRABCHAR_END:
-			return width;
-
-		default:
+		else
 			assert( 0 );
-		}
 	}
 
-	return width;
+	layout->end = s - layout->str;
 }
 
 /*
-* FTLIB_StrlenForWidth
-* returns the len allowed for the string to fit inside a given width when using a given font.
+* FTLIB_WrapRun
+*
+* Splits the run into lines no wider than wrapwidth, breaking at spaces when possible.
 */
-size_t FTLIB_StrlenForWidth( const char *str, qfontface_t *font, size_t maxwidth, int flags )
+static void FTLIB_WrapRun( ftlib_layout_t *layout )
 {
-	const char *s, *olds;
-	size_t width = 0;
-	int gc;
-	int advance = 0;
-	wchar_t num, prev_num = 0;
-	qglyph_t *glyph, *prev_glyph = NULL;
-	renderString_f renderString;
-	getKerning_f getKerning;
-	bool hasKerning;
+	int i = 0;
+	bool ended = false; // whether there are no more lines
+	const ftlib_runglyph_t *rg;
+	int glyph_width;
+	bool prev;
+	int maxwidth = layout->wrapwidth;
+	ftlib_runline_t *rl;
 
-	if( !str || !font )
-		return 0;
+	// words
+	int word = 0; // beginning of the current word
+	int word_chars, space_chars; // length of the current word and number of spaces before it
+	int word_width, space_width; // width of the current word and the spaces before it
+	int word_color = -1; // starting color of the current word
+	bool in_space; // whether currently in a sequence of spaces
+
+	// lines
+	int line = 0; // beginning of the line
+	int line_chars; // number of characters to draw in this line
+	int line_width; // width of the current line
+	int line_color, line_next_color = -1; // first color in the line
 
-	renderString = font->f->renderString;
-	getKerning = font->f->getKerning;
-	hasKerning = ( flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
+	layout->numLines = 0;
 
-	for( s = str; s; )
+	do
 	{
-		olds = s;
-		gc = FTLIB_GrabChar( &s, &num, NULL, flags );
-		if( gc == GRABCHAR_CHAR )
+		// reset
+		word_chars = space_chars = 0;
+		word_width = space_width = 0;
+		in_space = true; // assume starting from a whitespace so preceding whitespaces can be skipped
+		line_chars = 0;
+		line_width = 0;
+		line_color = line_next_color;
+
+		// find where to wrap
+		prev = false;
+		for( ; ; i++ )
 		{
-			if( num == '\n' )
+			if( i >= layout->numGlyphs )
+			{
+				ended = true;
 				break;
+			}
 
-			if( num < ' ' )
-				continue;
+			rg = &layout->glyphs[i];
+			if( rg->colorindex >= 0 )
+			{
+				line_next_color = rg->colorindex;
+				if( !line_chars && !word_chars )
+					line_color = line_next_color;
+			}
 
-			glyph = FTLIB_GetGlyph( font, num );
-			if( !glyph )
+			if( !rg->glyph )
 			{
-				num = FTLIB_REPLACEMENT_GLYPH;
-				glyph = FTLIB_GetGlyph( font, num );
+				if( !word_chars )
+					space_chars = space_width = 0;
+				line_next_color = -1;
+				i++;
+				break;
 			}
 
-			if( !glyph->shader )
-				renderString( font, olds );
+			if( Q_IsBreakingSpaceChar( rg->num ) )
+			{
+				if( in_space )
+				{
+					if( !line_chars )
+						continue; // skip preceding whitespaces in a line
+				}
+				else
+				{
+					in_space = true;
 
-			advance = glyph->x_advance;
-			if( hasKerning && prev_num ) {
-				advance += getKerning( font, prev_glyph, glyph );
+					// reached the space without wrapping - send the current word to the line
+					line_chars += space_chars + word_chars;
+					word_chars = space_chars = 0;
+					line_width += space_width + word_width;
+					word_width = space_width = 0;
+				}
+				space_chars++;
+				if( prev )
+					space_width += rg->kerning;
+				space_width += rg->glyph->x_advance;
 			}
-
-			if( maxwidth && ( ( width + advance ) > maxwidth ) )
+			else
 			{
-				s = olds;
-				break;
+				in_space = false;
+
+				glyph_width = rg->glyph->x_advance;
+				if( prev )
+					glyph_width += rg->kerning;
+
+				if( !word_chars )
+				{
+					word = i;
+					word_color = line_next_color;
+				}
+
+				if( line_chars )
+				{
+					// wrap after the previous word, ignoring spaces between the words
+					if( ( line_width + space_width + word_width + glyph_width ) > maxwidth )
+					{
+						i = word;
+						line_next_color = word_color;
+						word_chars = space_chars = 0;
+						word_width = space_width = 0;
+						break;
+					}
+				}
+				else
+				{
+					line = word;
+					if( word_chars ) // always draw at least 1 character in a line
+					{
+						if( ( word_width + glyph_width ) > maxwidth )
+							break;
+					}
+				}
+
+				word_chars++;
+				word_width += glyph_width;
 			}
 
-			width += advance;
+			prev = true;
+		}
+		// add the remaining part of the word
+		line_chars += space_chars + word_chars;
+		line_width += space_width + word_width;
+
+		layout->lines = FTLIB_GrowBuffer( layout->lines, &layout->maxLines, layout->numLines + 1, sizeof( *rl ) );
+		rl = &layout->lines[layout->numLines++];
+		rl->first = line;
+		rl->numChars = line_chars;
+		rl->width = line_width;
+		rl->colorindex = line_color;
+	} while( !ended );
+}
 
-			prev_num = num;
-			prev_glyph = glyph;
+/*
+* FTLIB_GetLayout
+*
+* Returns the cached layout of the string, building it if needed. Wrapped layouts are
+* split into lines up to wrapwidth, otherwise only the first line of the string is laid out.
+*/
+static ftlib_layout_t *FTLIB_GetLayout( const char *str, qfontface_t *font, int flags, int wrapwidth )
+{
+	const char *s;
+	unsigned int hash = 0x811c9dc5;
+	size_t len;
+	ftlib_layout_t *layout, **prevHash;
+
+	if( !layouts_initialized ) {
+		FTLIB_InitLayoutCache();
+	}
+
+	flags &= FTLIB_LAYOUT_FLAGS;
+
+	// FNV-1a
+	for( s = str; *s; s++ ) {
+		hash = ( hash ^ ( uint8_t )*s ) * 0x01000193;
+	}
+	len = s - str;
+	hash ^= ( unsigned int )( ( uintptr_t )font >> 4 ) + ( flags << 24 ) + wrapwidth;
+
+	for( layout = layouts_hash[hash % FTLIB_LAYOUT_HASH_SIZE]; layout; layout = layout->hashNext ) {
+		if( layout->hash == hash && layout->font == font && layout->flags == flags && layout->wrapwidth == wrapwidth
+			&& layout->len == len && !memcmp( layout->str, str, len ) ) {
+			break;
 		}
-		else if( gc == GRABCHAR_COLOR )
-			continue;
-		else if( gc == GRABCHAR_END )
+	}
+
+	if( !layout ) {
+		// reuse the least recently used one
+		layout = layouts_headnode.prev;
+
+		if( layout->font ) {
+			for( prevHash = &layouts_hash[layout->hash % FTLIB_LAYOUT_HASH_SIZE]; *prevHash != layout; prevHash = &( *prevHash )->hashNext );
+			*prevHash = layout->hashNext;
+		}
+
+		if( len + 1 > layout->strSize ) {
+			if( layout->str ) {
+				FTLIB_Free( layout->str );
+			}
+			layout->strSize = ALIGN( len + 1, 64 );
+			layout->str = FTLIB_Alloc( ftlibPool, layout->strSize );
+		}
+		memcpy( layout->str, str, len + 1 );
+		layout->len = len;
+
+		layout->hash = hash;
+		layout->font = font;
+		layout->flags = flags;
+		layout->wrapwidth = wrapwidth;
+		layout->hashNext = layouts_hash[hash % FTLIB_LAYOUT_HASH_SIZE];
+		layouts_hash[hash % FTLIB_LAYOUT_HASH_SIZE] = layout;
+
+		FTLIB_BuildRun( layout );
+		if( wrapwidth ) {
+			FTLIB_WrapRun( layout );
+		}
+	}
+
+	// move to the front of the list
+	layout->prev->next = layout->next;
+	layout->next->prev = layout->prev;
+	layout->prev = &layouts_headnode;
+	layout->next = layouts_headnode.next;
+	layout->next->prev = layout;
+	layouts_headnode.next = layout;
+
+	return layout;
+}
+
+//===============================================================================
+//STRINGS HELPERS
+//===============================================================================
+
+/*
+* FTLIB_FontSize
+*/
+size_t FTLIB_FontSize( qfontface_t *font )
+{
+	if( !font ) {
+		return 0;
+	}
+	return font->size;
+}
+
+/*
+* FTLIB_FontHeight
+*/
+size_t FTLIB_FontHeight( qfontface_t *font )
+{
+	if( !font ) {
+		return 0;
+	}
+	return font->height;
+}
+
+/*
+* FTLIB_strWidth
+* doesn't count invisible characters. Counts up to given length, if any.
+*/
+size_t FTLIB_strWidth( const char *str, qfontface_t *font, size_t maxlen, int flags )
+{
+	int i;
+	size_t width = 0;
+	const ftlib_layout_t *layout;
+	const ftlib_runglyph_t *rg;
+
+	if( !str || !font )
+		return 0;
+
+	layout = FTLIB_GetLayout( str, font, flags, 0 );
+
+	for( i = 0, rg = layout->glyphs; i < layout->numGlyphs; i++, rg++ )
+	{
+		if( maxlen && rg->offset >= maxlen )  // stop counting at desired len
 			break;
-		else
-			assert( 0 );
+		width += rg->kerning + rg->glyph->x_advance;
+	}
+
+	return width;
+}
+
+/*
+* FTLIB_StrlenForWidth
+* returns the len allowed for the string to fit inside a given width when using a given font.
+*/
+size_t FTLIB_StrlenForWidth( const char *str, qfontface_t *font, size_t maxwidth, int flags )
+{
+	int i;
+	size_t width = 0;
+	int advance;
+	const ftlib_layout_t *layout;
+	const ftlib_runglyph_t *rg;
+
+	if( !str || !font )
+		return 0;
+
+	layout = FTLIB_GetLayout( str, font, flags, 0 );
+
+	for( i = 0, rg = layout->glyphs; i < layout->numGlyphs; i++, rg++ )
+	{
+		advance = rg->glyph->x_advance + rg->kerning;
+		if( maxwidth && ( ( width + advance ) > maxwidth ) )
+			return rg->offset;
+		width += advance;
 	}
 
-	return (unsigned int)( s - str );
+	return layout->end;
 }
 
 /*
@@ -262,30 +595,12 @@ fdrawchar_t FTLIB_SetDrawIntercept( fdrawchar_t intercept )
 }
 
 /*
-* FTLIB_DrawRawChar
-* 
-* Draws one graphics character with 0 being transparent.
-* It can be clipped to the top of the screen to allow the console to be
-* smoothly scrolled off.
+* FTLIB_DrawRawGlyph
 */
-void FTLIB_DrawRawChar( int x, int y, wchar_t num, qfontface_t *font, vec4_t color )
+static void FTLIB_DrawRawGlyph( int x, int y, qglyph_t *glyph, qfontface_t *font, vec4_t color )
 {
-	qglyph_t *glyph;
 	fdrawchar_t draw = trap_R_DrawStretchPic;
 
-	if( ( num <= ' ' ) || !font || ( y <= -font->height ) )
-		return;
-
-	glyph = FTLIB_GetGlyph( font, num );
-	if( !glyph )
-	{
-		num = FTLIB_REPLACEMENT_GLYPH;
-		glyph = FTLIB_GetGlyph( font, num );
-	}
-
-	if( !glyph->shader )
-		font->f->renderString( font, Q_WCharToUtf8Char( num ) );
-
 	if( !glyph->width || !glyph->height )
 		return;
 
@@ -299,20 +614,17 @@ void FTLIB_DrawRawChar( int x, int y, wchar_t num, qfontface_t *font, vec4_t col
 }
 
 /*
-* FTLIB_DrawClampChar
+* FTLIB_DrawRawChar
 * 
 * Draws one graphics character with 0 being transparent.
-* Clipped to [xmin, ymin; xmax, ymax].
+* It can be clipped to the top of the screen to allow the console to be
+* smoothly scrolled off.
 */
-void FTLIB_DrawClampChar( int x, int y, wchar_t num, int xmin, int ymin, int xmax, int ymax, qfontface_t *font, vec4_t color )
+void FTLIB_DrawRawChar( int x, int y, wchar_t num, qfontface_t *font, vec4_t color )
 {
 	qglyph_t *glyph;
-	int x2, y2;
-	float s1 = 0.0f, t1 = 0.0f, s2 = 1.0f, t2 = 1.0f;
-	float tw, th;
-	fdrawchar_t draw = trap_R_DrawStretchPic;
 
-	if( ( num <= ' ' ) || !font || ( xmax <= xmin ) || ( ymax <= ymin ) )
+	if( ( num <= ' ' ) || !font || ( y <= -font->height ) )
 		return;
 
 	glyph = FTLIB_GetGlyph( font, num );
@@ -325,6 +637,19 @@ void FTLIB_DrawClampChar( int x, int y, wchar_t num, int xmin, int ymin, int xma
 	if( !glyph->shader )
 		font->f->renderString( font, Q_WCharToUtf8Char( num ) );
 
+	FTLIB_DrawRawGlyph( x, y, glyph, font, color );
+}
+
+/*
+* FTLIB_DrawClampGlyph
+*/
+static void FTLIB_DrawClampGlyph( int x, int y, qglyph_t *glyph, int xmin, int ymin, int xmax, int ymax, qfontface_t *font, vec4_t color )
+{
+	int x2, y2;
+	float s1 = 0.0f, t1 = 0.0f, s2 = 1.0f, t2 = 1.0f;
+	float tw, th;
+	fdrawchar_t draw = trap_R_DrawStretchPic;
+
 	if( !glyph->width || !glyph->height )
 		return;
 
@@ -371,21 +696,42 @@ void FTLIB_DrawClampChar( int x, int y, wchar_t num, int xmin, int ymin, int xma
 		color, glyph->shader );
 }
 
+/*
+* FTLIB_DrawClampChar
+* 
+* Draws one graphics character with 0 being transparent.
+* Clipped to [xmin, ymin; xmax, ymax].
+*/
+void FTLIB_DrawClampChar( int x, int y, wchar_t num, int xmin, int ymin, int xmax, int ymax, qfontface_t *font, vec4_t color )
+{
+	qglyph_t *glyph;
+
+	if( ( num <= ' ' ) || !font || ( xmax <= xmin ) || ( ymax <= ymin ) )
+		return;
+
+	glyph = FTLIB_GetGlyph( font, num );
+	if( !glyph )
+	{
+		num = FTLIB_REPLACEMENT_GLYPH;
+		glyph = FTLIB_GetGlyph( font, num );
+	}
+
+	if( !glyph->shader )
+		font->f->renderString( font, Q_WCharToUtf8Char( num ) );
+
+	FTLIB_DrawClampGlyph( x, y, glyph, xmin, ymin, xmax, ymax, font, color );
+}
+
 /*
 * FTLIB_DrawClampString
 */
 void FTLIB_DrawClampString( int x, int y, const char *str, int xmin, int ymin, int xmax, int ymax, qfontface_t *font, vec4_t color, int flags )
 {
+	int i;
 	int xoffset = 0;
 	vec4_t scolor;
-	int colorindex;
-	wchar_t num, prev_num = 0;
-	const char *s = str, *olds;
-	int gc;
-	qglyph_t *glyph, *prev_glyph = NULL;
-	renderString_f renderString;
-	getKerning_f getKerning;
-	bool hasKerning;
+	const ftlib_layout_t *layout;
+	const ftlib_runglyph_t *rg, *prev_rg = NULL;
 
 	if( !str || !font )
 		return;
@@ -394,56 +740,23 @@ void FTLIB_DrawClampString( int x, int y, const char *str, int xmin, int ymin, i
 
 	Vector4Copy( color, scolor );
 
-	renderString = font->f->renderString;
-	getKerning = font->f->getKerning;
-	hasKerning = ( flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
+	layout = FTLIB_GetLayout( str, font, flags, 0 );
 
-	while( 1 )
+	for( i = 0, rg = layout->glyphs; i < layout->numGlyphs; i++, rg++ )
 	{
-		olds = s;
-		gc = FTLIB_GrabChar( &s, &num, &colorindex, flags );
-		if( gc == GRABCHAR_CHAR )
-		{
-			if( num == '\n' )
-				break;
-
-			if( num < ' ' )
-				continue;
-
-			glyph = FTLIB_GetGlyph( font, num );
-			if( !glyph )
-			{
-				num = FTLIB_REPLACEMENT_GLYPH;
-				glyph = FTLIB_GetGlyph( font, num );
-			}
+		if( rg->colorindex >= 0 )
+			VectorCopy( color_table[rg->colorindex], scolor );
 
-			if( !glyph->shader )
-				renderString( font, olds );
+		if( prev_rg )
+			xoffset += prev_rg->glyph->x_advance + rg->kerning;
 
-			if( prev_num )
-			{
-				xoffset += prev_glyph->x_advance;
-				if( hasKerning )
-					xoffset += getKerning( font, prev_glyph, glyph );
-			}
-
-			if( x + xoffset > xmax )
-				break;
+		if( x + xoffset > xmax )
+			break;
 
-			FTLIB_DrawClampChar( x + xoffset, y, num, xmin, ymin, xmax, ymax, font, scolor );
+		if( rg->num > ' ' )
+			FTLIB_DrawClampGlyph( x + xoffset, y, rg->glyph, xmin, ymin, xmax, ymax, font, scolor );
 
-			prev_num = num;
-			prev_glyph = glyph;
-		}
-		else if( gc == GRABCHAR_COLOR )
-		{
-			assert( ( unsigned )colorindex < MAX_S_COLORS );
-			VectorCopy( color_table[colorindex], scolor );
-		}
-		else if( gc == GRABCHAR_END )
-			break;
-		else
-			assert( 0 );
+		prev_rg = rg;
 	}
 }
 
@@ -453,79 +766,47 @@ void FTLIB_DrawClampString( int x, int y, const char *str, int xmin, int ymin, i
 */
 size_t FTLIB_DrawRawString( int x, int y, const char *str, size_t maxwidth, int *width, qfontface_t *font, vec4_t color, int flags )
 {
+	int i;
 	unsigned int xoffset = 0;
 	vec4_t scolor;
-	const char *s, *olds;
-	int gc, colorindex;
-	wchar_t num, prev_num = 0;
-	qglyph_t *glyph, *prev_glyph = NULL;
-	renderString_f renderString;
-	getKerning_f getKerning;
-	bool hasKerning;
+	size_t len;
+	bool visible;
+	const ftlib_layout_t *layout;
+	const ftlib_runglyph_t *rg;
 
 	if( !str || !font )
 		return 0;
 
 	Vector4Copy( color, scolor );
 
-	renderString = font->f->renderString;
-	getKerning = font->f->getKerning;
-	hasKerning = ( flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
+	layout = FTLIB_GetLayout( str, font, flags, 0 );
+	len = layout->end;
+	visible = ( y > -font->height );
 
-	for( s = str; s; )
+	for( i = 0, rg = layout->glyphs; i < layout->numGlyphs; i++, rg++ )
 	{
-		olds = s;
-		gc = FTLIB_GrabChar( &s, &num, &colorindex, flags );
-		if( gc == GRABCHAR_CHAR )
-		{
-			if( num == '\n' )
-				break;
+		if( rg->colorindex >= 0 )
+			VectorCopy( color_table[rg->colorindex], scolor );
 
-			if( num < ' ' )
-				continue;
-
-			glyph = FTLIB_GetGlyph( font, num );
-			if( !glyph )
-			{
-				num = FTLIB_REPLACEMENT_GLYPH;
-				glyph = FTLIB_GetGlyph( font, num );
-			}
-
-			if( !glyph->shader )
-				renderString( font, olds );
-
-			// ignore kerning at this point so the full width of the previous character will always be returned
-			if( maxwidth && ( ( xoffset + glyph->x_advance ) > maxwidth ) )
-			{
-				s = olds;
-				break;
-			}
-
-			if( hasKerning && prev_num )
-				xoffset += getKerning( font, prev_glyph, glyph );
+		// ignore kerning at this point so the full width of the previous character will always be returned
+		if( maxwidth && ( ( xoffset + rg->glyph->x_advance ) > maxwidth ) )
+		{
+			len = rg->offset;
+			break;
+		}
 
-			FTLIB_DrawRawChar( x + xoffset, y, num, font, scolor );
+		xoffset += rg->kerning;
 
-			xoffset += glyph->x_advance;
+		if( visible && ( rg->num > ' ' ) )
+			FTLIB_DrawRawGlyph( x + xoffset, y, rg->glyph, font, scolor );
 
-			prev_num = num;
-			prev_glyph = glyph;
-		}
-		else if( gc == GRABCHAR_COLOR )
-		{
-			assert( ( unsigned )colorindex < MAX_S_COLORS );
-			VectorCopy( color_table[colorindex], scolor );
-		}
-		else if( gc == GRABCHAR_END )
-			break;
-		else
-			assert( 0 );
+		xoffset += rg->glyph->x_advance;
 	}
 
 	if( width )
 		*width = xoffset;
 
-	return ( s - str );
+	return len;
 }
 
 /* FTLIB_DrawMultilineString
@@ -534,222 +815,61 @@ size_t FTLIB_DrawRawString( int x, int y, const char *str, size_t maxwidth, int
  */
 int FTLIB_DrawMultilineString( int x, int y, const char *str, int halign, int maxwidth, int maxlines, qfontface_t *font, vec4_t color, int flags )
 {
-	bool ended = false; // whether to stop drawing lines
-
-	// characters and glyphs
-	const char *oldstr;
-	int gc, colorindex;
-	wchar_t num, prev_num;
-	qglyph_t *glyph, *prev_glyph;
-	int glyph_width;
-	renderString_f renderString;
-	getKerning_f getKerning;
-	bool hasKerning;
-
-	// words
-	const char *word = NULL; // beginning of the current word
-	int word_chars, space_chars; // length of the current word and number of spaces before it
-	int word_width, space_width; // width of the current word and the spaces before it
-	vec4_t word_color; // starting color of the current word
-	bool in_space; // whether currently in a sequence of spaces
-
-	// line drawing
-	const char *line = NULL; // beginning of the line
-	int line_chars; // number of characters to draw in this line
-	int line_width; // width of the current line
+	int i, j;
 	int line_x; // x position of the current character in line
-	vec4_t line_color, line_next_color; // first color in the line
+	int line_chars; // number of characters left to draw in this line
+	vec4_t line_color;
 	int line_height; // height of a single line
 	int lines = 0; // number of lines drawn - the return value
+	bool prev;
+	const ftlib_layout_t *layout;
+	const ftlib_runline_t *rl;
+	const ftlib_runglyph_t *rg;
 
 	if( !str || !font || ( maxwidth <= 0 ) )
 		return 0;
 
 	halign = halign % 3; // ignore vertical alignment
 
-	renderString = font->f->renderString;
-	getKerning = font->f->getKerning;
-	hasKerning = ( flags & TEXTDRAWFLAG_KERNING ) && font->hasKerning;
-
-	Vector4Copy( color, line_next_color );
 	line_height = FTLIB_FontHeight( font );
 
-	Vector4Copy( color, word_color );
+	layout = FTLIB_GetLayout( str, font, flags, maxwidth );
 
-	do
+	for( i = 0, rl = layout->lines; i < layout->numLines; i++, rl++ )
 	{
-		// reset
-		word_chars = space_chars = 0;
-		word_width = space_width = 0;
-		in_space = true; // assume starting from a whitespace so preceding whitespaces can be skipped
-		line_chars = 0;
-		line_width = 0;
-		Vector4Copy( line_next_color, line_color );
-
-		// find where to wrap
-		prev_num = 0;
-		prev_glyph = NULL;
-		while( str )
-		{
-			oldstr = str;
-			gc = FTLIB_GrabChar( &str, &num, &colorindex, flags );
-			if( gc == GRABCHAR_CHAR )
-			{
-				if( num == '\n' )
-				{
-					if( !word_chars )
-						space_chars = space_width = 0;
-					Vector4Copy( color, line_next_color );
-					break;
-				}
-
-				if( num < ' ' )
-					continue;
-
-				glyph = FTLIB_GetGlyph( font, num );
-				if( !glyph )
-				{
-					num = FTLIB_REPLACEMENT_GLYPH;
-					glyph = FTLIB_GetGlyph( font, num );
-				}
-
-				if( !glyph->shader )
-					renderString( font, oldstr );
-
-				if( Q_IsBreakingSpaceChar( num ) )
-				{
-					if( in_space )
-					{
-						if( !line_chars )
-							continue; // skip preceding whitespaces in a line
-					}
-					else
-					{
-						in_space = true;
-
-						// reached the space without wrapping - send the current word to the line
-						line_chars += space_chars + word_chars;
-						word_chars = space_chars = 0;
-						line_width += space_width + word_width;
-						word_width = space_width = 0;
-					}
-					space_chars++;
-					if( hasKerning && prev_num )
-						space_width += getKerning( font, prev_glyph, glyph );
-					space_width += glyph->x_advance;
-				}
-				else
-				{
-					in_space = false;
-
-					glyph_width = glyph->x_advance;
-					if( hasKerning && prev_num )
-						glyph_width += getKerning( font, prev_glyph, glyph );
-
-					if( !word_chars )
-					{
-						word = oldstr;
-						Vector4Copy( line_next_color, word_color );
-					}
-
-					if( line_chars )
-					{
-						// wrap after the previous word, ignoring spaces between the words
-						if( ( line_width + space_width + word_width + glyph_width ) > maxwidth )
-						{
-							str = word;
-							Vector4Copy( word_color, line_next_color );
-							word_chars = space_chars = 0;
-							word_width = space_width = 0;
-							break;
-						}
-					}
-					else
-					{
-						line = word;
-						if( word_chars ) // always draw at least 1 character in a line
-						{
-							if( ( word_width + glyph_width ) > maxwidth )
-							{
-								str = oldstr;
-								break;
-							}
-						}
-					}
-
-					word_chars++;
-					word_width += glyph_width;
-				}
-
-				prev_num = num;
-				prev_glyph = glyph;
-			}
-			else if( gc == GRABCHAR_COLOR )
-			{
-				assert( ( unsigned )colorindex < MAX_S_COLORS );
-				VectorCopy( color_table[colorindex], line_next_color );
-				if( !line_chars && !word_chars )
-					Vector4Copy( line_next_color, line_color );
-			}
-			else if( gc == GRABCHAR_END )
-			{
-				ended = true;
-				break;
-			}
-			else
-				assert( 0 );
-		}
-		// add the remaining part of the word
-		line_chars += space_chars + word_chars;
-		line_width += space_width + word_width;
-
 		// draw the line
-		if( line_chars > 0 )
+		if( rl->numChars > 0 )
 		{
 			line_x = x;
 			if( halign == ALIGN_CENTER_TOP )
-				line_x -= line_width >> 1;
+				line_x -= rl->width >> 1;
 			else if( halign == ALIGN_RIGHT_TOP )
-				line_x -= line_width;
+				line_x -= rl->width;
 
-			prev_num = 0;
-			prev_glyph = NULL;
-			while( ( line_chars > 0 ) && line )
-			{
-				gc = FTLIB_GrabChar( &line, &num, &colorindex, flags );
-				if( gc == GRABCHAR_CHAR )
-				{
-					if( num < ' ' )
-						continue;
+			Vector4Copy( color, line_color );
+			if( rl->colorindex >= 0 )
+				VectorCopy( color_table[rl->colorindex], line_color );
 
-					line_chars--;
+			prev = false;
+			line_chars = rl->numChars;
+			for( j = rl->first, rg = layout->glyphs + j; ( line_chars > 0 ) && ( j < layout->numGlyphs ); j++, rg++ )
+			{
+				if( rg->colorindex >= 0 )
+					VectorCopy( color_table[rg->colorindex], line_color );
 
-					glyph = FTLIB_GetGlyph( font, num );
-					if( !glyph )
-					{
-						num = FTLIB_REPLACEMENT_GLYPH;
-						glyph = FTLIB_GetGlyph( font, num );
-					}
+				if( !rg->glyph )
+					continue;
 
-					if( hasKerning && prev_num )
-						line_x += getKerning( font, prev_glyph, glyph );
+				line_chars--;
 
-					FTLIB_DrawRawChar( line_x, y, num, font, line_color );
+				if( prev )
+					line_x += rg->kerning;
 
-					line_x += glyph->x_advance;
+				if( ( rg->num > ' ' ) && ( y > -font->height ) )
+					FTLIB_DrawRawGlyph( line_x, y, rg->glyph, font, line_color );
 
-					prev_num = num;
-					prev_glyph = glyph;
-				}
-				else if( gc == GRABCHAR_COLOR )
-				{
-					assert( ( unsigned )colorindex < MAX_S_COLORS );
-					VectorCopy( color_table[colorindex], line_color );
-				}
-				else if( gc == GRABCHAR_END )
-					break;
-				else
-					assert( 0 );
+				line_x += rg->glyph->x_advance;
+				prev = true;
 			}
 		}
 
@@ -757,8 +877,7 @@ int FTLIB_DrawMultilineString( int x, int y, const char *str, int halign, int ma
 		if( ( maxlines > 0 ) && ( lines >= maxlines ) )
 			break;
 		y += line_height;
-
-	} while( !ended );
+	}
 
 	return lines;
 }
@@ -170,6 +170,7 @@ qglyph_t *FTLIB_GetGlyph( qfontface_t *font, wchar_t num );
 const char *FTLIB_FontShaderName( qfontface_t *qfont, unsigned int shaderNum );
 
 // ftlib_draw.c
+void FTLIB_FreeLayoutCache( void );
 size_t FTLIB_FontSize( qfontface_t *font );
 size_t FTLIB_FontHeight( qfontface_t *font );
 size_t FTLIB_strWidth( const char *str, qfontface_t *font, size_t maxlen, int flags );
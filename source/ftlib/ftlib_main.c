@@ -49,6 +49,8 @@ bool FTLIB_Init( bool verbose )
 */
 void FTLIB_Shutdown( bool verbose )
 {
+	FTLIB_FreeLayoutCache();
+
 	FTLIB_ShutdownSubsystems( verbose );
 
 	FTLIB_FreePool( &ftlibPool );
@@ -3,6 +3,8 @@
 #include "ai_manager.h"
 #include "ai_objective_based_team_brain.h"
 #include "ai_tactical_spots_detector.h"
+#include "ai_frame_trace_cache.h"
+#include "ai_think_scheduler.h"
 
 ai_weapon_aim_type BuiltinWeaponAimType(int builtinWeapon)
 {
@@ -145,6 +147,98 @@ void AI_UnloadLevel()
     AiAasWorld::Shutdown();
 }
 
+void AI_GenerateVisTable_f()
+{
+    AiAasWorld *aasWorld = AiAasWorld::Instance();
+    if (!aasWorld || !aasWorld->IsLoaded())
+    {
+        G_Printf("AAS world is not loaded\n");
+        return;
+    }
+
+    aasWorld->GenerateVisTable(level.mapname);
+}
+
+void AI_TacticalSpotsBenchmark_f()
+{
+    AiAasWorld *aasWorld = AiAasWorld::Instance();
+    if (!aasWorld || !aasWorld->IsLoaded())
+    {
+        G_Printf("AAS world is not loaded\n");
+        return;
+    }
+
+    int numSearches = trap_Cmd_Argc() > 1 ? atoi(trap_Cmd_Argv(1)) : 200;
+    clamp(numSearches, 1, 100000);
+    float searchRadius = trap_Cmd_Argc() > 2 ? atof(trap_Cmd_Argv(2)) : 768.0f;
+
+    StaticVector<int, 1024> testedAreas;
+    for (int i = 1; i < aasWorld->NumAreas() && testedAreas.size() < testedAreas.capacity(); ++i)
+    {
+        const auto &areaSettings = aasWorld->AreaSettings()[i];
+        if (!(areaSettings.areaflags & AREA_GROUNDED) || (areaSettings.areaflags & (AREA_DISABLED|AREA_JUNK)))
+            continue;
+        if (!areaSettings.numreachableareas)
+            continue;
+        testedAreas.push_back(i);
+    }
+    if (testedAreas.size() < 2)
+    {
+        G_Printf("Not enough areas to test\n");
+        return;
+    }
+
+    TacticalSpotsDetector detector;
+    detector.SetMinHeightAdvantage(-64.0f);
+    detector.SetSpotProximityThreshold(128.0f);
+
+    // Run the same searches with the area vis table and PVS, with PVS only and with neither of them
+    static const char *passNames[] = { "vis table + pvs", "pvs only       ", "traces only    " };
+    const bool hadVisTable = aasWorld->HasVisTable();
+    for (int pass = hadVisTable ? 0 : 1; pass < 3; ++pass)
+    {
+        aasWorld->SetUseVisTable(pass == 0);
+        detector.SetUsePvsPrefilter(pass < 2);
+
+        unsigned seed = 0x2F6E2B1;
+        int numSpots = 0;
+        unsigned startTime = trap_Milliseconds();
+        for (int i = 0; i < numSearches; ++i)
+        {
+            vec3_t origin, enemyOrigin, spots[8];
+            seed = seed * 1664525 + 1013904223;
+            aasWorld->GetAreaViewPoint(testedAreas[(seed >> 8) % testedAreas.size()], origin);
+            seed = seed * 1664525 + 1013904223;
+            aasWorld->GetAreaViewPoint(testedAreas[(seed >> 8) % testedAreas.size()], enemyOrigin);
+
+            TacticalSpotsDetector::OriginParams originParams(origin, searchRadius, AiAasRouteCache::Shared());
+            TacticalSpotsDetector::AdvantageProblemParams advantageParams(enemyOrigin);
+            TacticalSpotsDetector::CoverProblemParams coverParams(enemyOrigin, 16.0f);
+            numSpots += detector.FindPositionalAdvantageSpots(originParams, advantageParams, spots, 8);
+            numSpots += detector.FindCoverSpots(originParams, coverParams, spots, 8);
+        }
+        unsigned elapsed = std::max(1u, trap_Milliseconds() - startTime);
+
+        G_Printf("%s: %d searches in %u ms, %.1f searches/s, %d spots found\n",
+                 passNames[pass], 2 * numSearches, elapsed,
+                 2000.0f * numSearches / elapsed, numSpots);
+    }
+
+    aasWorld->SetUseVisTable(hadVisTable);
+    if (!hadVisTable)
+        G_Printf("There is no vis table for this map, use ai_genvistable to build it\n");
+}
+
+void AI_TraceStats_f()
+{
+    AiFrameTraceCache::Instance()->PrintStats();
+}
+
+void AI_ThinkSchedulerStats_f()
+{
+    AiThinkScheduler::Instance()->PrintStats();
+}
+
 void AI_GametypeChanged(const char *gametype)
 {
     AiManager::OnGametypeChanged(gametype);
@@ -155,13 +249,31 @@ void AI_JoinedTeam(edict_t *ent, int team)
     AiManager::Instance()->OnBotJoinedTeam(ent, team);
 }
 
+// Exported to the server for benchmarking
+static uint64_t aiMicroseconds = 0;
+
+uint64_t AI_Microseconds()
+{
+    return aiMicroseconds;
+}
+
 void AI_CommonFrame()
 {
+    uint64_t startTime = trap_Microseconds();
+    trap_Prof_Begin("ai_frame");
+
     AiAasWorld::Instance()->Frame();
 
+    AiFrameTraceCache::Instance()->Frame();
+
+    AiThinkScheduler::Instance()->Frame();
+
     NavEntitiesRegistry::Instance()->Update();
 
     AiManager::Instance()->Update();
+
+    trap_Prof_End();
+    aiMicroseconds += trap_Microseconds() - startTime;
 }
 
 static void FindHubAreas()
@@ -444,7 +556,11 @@ void AI_Think(edict_t *self)
     if( !self->ai || self->ai->type == AI_INACTIVE )
         return;
 
+    uint64_t startTime = trap_Microseconds();
+    trap_Prof_Begin("ai_think");
     self->ai->aiRef->Update();
+    trap_Prof_End();
+    aiMicroseconds += trap_Microseconds() - startTime;
 }
 
 void AI_SpawnBot( const char *team )
@@ -82,8 +82,17 @@ void AI_Shutdown( void );
 void AI_UnloadLevel();
 // Should be called when current gametype has been changed on has been set up first time
 void AI_GametypeChanged( const char *gametype );
+// Console commands: build the AAS area visibility table for the current map and benchmark tactical spot searches
+void AI_GenerateVisTable_f( void );
+void AI_TacticalSpotsBenchmark_f( void );
+// Console command: print counters of visibility tests and traces shared between bots within a frame
+void AI_TraceStats_f( void );
+// Console command: print the AI frame time budget, deferred tasks and over budget frames counters
+void AI_ThinkSchedulerStats_f( void );
 // Should be called before all entities (including AI's and clients) think
 void AI_CommonFrame( void );
+// Returns time spent in AI frames and thinks since the game module has been loaded
+uint64_t AI_Microseconds( void );
 // Should be called when an AI joins a team
 void AI_JoinedTeam( edict_t *ent, int team );
 
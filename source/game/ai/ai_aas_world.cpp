@@ -1,6 +1,6 @@
 #include "ai_aas_world.h"
 #include "static_vector.h"
-#include "../g_local.h"
+#include "ai_local.h"
 #undef min
 #undef max
 #include <memory>
@@ -30,6 +30,7 @@ bool AiAasWorld::Init(const char *mapname)
         return false;
     }
     instance->PostLoad();
+    instance->LoadVisTable(mapname);
     return true;
 }
 
@@ -790,6 +791,7 @@ AiAasWorld::~AiAasWorld()
 
     FreeLinkedEntities();
     FreeLinkHeap();
+    FreeVisTable();
 
     // These items may be absent for some stripped AAS files, so check each one.
     if (bboxes) G_LevelFree(bboxes);
@@ -928,4 +930,277 @@ void AiAasWorld::SwapData()
         clusters[i].numportals = LittleLong(clusters[i].numportals);
         clusters[i].firstportal = LittleLong(clusters[i].firstportal);
     }
-}
\ No newline at end of file
+}
+
+void AiAasWorld::GetAreaViewPoint(int areaNum, vec3_t point) const
+{
+    const aas_area_t &area = areas[areaNum];
+    VectorCopy(area.center, point);
+    point[2] = area.mins[2] - playerbox_stand_mins[2] + playerbox_stand_viewheight;
+}
+
+#define AASVISID					(('V'<<24)+('S'<<16)+('A'<<8)+'A')
+#define AASVISVERSION				2
+
+//aas visibility table file header, followed by visibility area numbers and zero-run compressed rows
+typedef struct aas_visheader_s
+{
+    int ident;
+    int version;
+    int numareas;
+    int numvisareas;
+    unsigned checksum;
+} aas_visheader_t;
+
+bool AiAasWorld::IsVisTableArea(const aas_areasettings_t &areaSettings)
+{
+    // Same kind of areas TacticalSpotsDetector may select, the table would be too large otherwise
+    if (!(areaSettings.areaflags & AREA_GROUNDED))
+        return false;
+    if (areaSettings.areaflags & (AREA_DISABLED|AREA_JUNK))
+        return false;
+    return areaSettings.numreachableareas > 0;
+}
+
+unsigned AiAasWorld::VisTableChecksum() const
+{
+    // FNV-1a of area bounds, rounded to integers to be independent of byte order
+    unsigned hash = 2166136261u;
+    for (int i = 0; i < numareas; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            hash = (hash ^ (unsigned)(int)areas[i].mins[j]) * 16777619u;
+            hash = (hash ^ (unsigned)(int)areas[i].maxs[j]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+// Only world geometry is tested: trap_inPVS() also applies the current areaportal state,
+// so doors that happen to be closed while the table is built would hide pairs for good
+static bool WorldPointsVisible(vec3_t p1, vec3_t p2)
+{
+    trace_t trace;
+    vec3_t zero = { 0, 0, 0 };
+    trap_CM_TransformedBoxTrace(&trace, p1, p2, zero, zero, nullptr, MASK_AISOLID, nullptr, nullptr);
+    if (trace.fraction == 1.0f)
+        return true;
+
+    // Traces are not guaranteed to be symmetric, and the table must never reject a visible pair
+    trap_CM_TransformedBoxTrace(&trace, p2, p1, zero, zero, nullptr, MASK_AISOLID, nullptr, nullptr);
+    return trace.fraction == 1.0f;
+}
+
+bool AiAasWorld::GenerateVisTable(const char *mapname)
+{
+    if (!loaded)
+        return false;
+
+    FreeVisTable();
+
+    areaVisIndex = (int *)G_LevelMalloc(sizeof(int) * numareas);
+    int *visAreaNums = (int *)G_LevelMalloc(sizeof(int) * numareas);
+    areaVisIndex[0] = -1;
+    for (int i = 1; i < numareas; ++i)
+    {
+        areaVisIndex[i] = -1;
+        if (IsVisTableArea(areasettings[i]))
+        {
+            areaVisIndex[i] = numVisAreas;
+            visAreaNums[numVisAreas++] = i;
+        }
+    }
+
+    areaVisRowSize = (numVisAreas + 7) >> 3;
+    areaVisRows = (uint8_t *)G_LevelMalloc(areaVisRowSize * numVisAreas + 1);
+    memset(areaVisRows, 0, areaVisRowSize * numVisAreas);
+
+    vec3_t *points = (vec3_t *)G_LevelMalloc(sizeof(vec3_t) * (numVisAreas + 1));
+    for (int i = 0; i < numVisAreas; ++i)
+        GetAreaViewPoint(visAreaNums[i], points[i]);
+
+    unsigned startTime = trap_Milliseconds();
+    int numVisiblePairs = 0;
+    for (int i = 0; i < numVisAreas; ++i)
+    {
+        areaVisRows[i * areaVisRowSize + (i >> 3)] |= 1 << (i & 7);
+        for (int j = i + 1; j < numVisAreas; ++j)
+        {
+            if (!WorldPointsVisible(points[i], points[j]))
+                continue;
+            areaVisRows[i * areaVisRowSize + (j >> 3)] |= 1 << (j & 7);
+            areaVisRows[j * areaVisRowSize + (i >> 3)] |= 1 << (i & 7);
+            numVisiblePairs++;
+        }
+    }
+
+    G_Printf("AAS visibility table: %d areas, %d of %d pairs visible, built in %u ms\n", numVisAreas,
+             numVisiblePairs, numVisAreas * (numVisAreas - 1) / 2, trap_Milliseconds() - startTime);
+
+    bool result = WriteVisTable(mapname, visAreaNums);
+    G_LevelFree(points);
+    G_LevelFree(visAreaNums);
+    useVisTable = true;
+    return result;
+}
+
+bool AiAasWorld::WriteVisTable(const char *mapname, const int *visAreaNums) const
+{
+    char filename[MAX_QPATH];
+    Q_snprintfz(filename, MAX_QPATH, "maps/%s.aasvis", mapname);
+
+    int fp;
+    if (trap_FS_FOpenFile(filename, &fp, FS_WRITE) == -1)
+    {
+        G_Printf(S_COLOR_RED "can't write %s\n", filename);
+        return false;
+    }
+
+    aas_visheader_t header;
+    header.ident = LittleLong(AASVISID);
+    header.version = LittleLong(AASVISVERSION);
+    header.numareas = LittleLong(numareas);
+    header.numvisareas = LittleLong(numVisAreas);
+    header.checksum = LittleLong(VisTableChecksum());
+    trap_FS_Write(&header, sizeof(header), fp);
+
+    for (int i = 0; i < numVisAreas; ++i)
+    {
+        int areaNum = LittleLong(visAreaNums[i]);
+        trap_FS_Write(&areaNum, sizeof(int), fp);
+    }
+
+    // Rows are mostly zeros, store zero bytes as a zero followed by a run length
+    uint8_t *compressed = (uint8_t *)G_LevelMalloc(areaVisRowSize * 2 + 1);
+    size_t totalSize = sizeof(header) + sizeof(int) * numVisAreas;
+    for (int i = 0; i < numVisAreas; ++i)
+    {
+        const uint8_t *row = areaVisRows + i * areaVisRowSize;
+        uint8_t *out = compressed;
+        for (int j = 0; j < areaVisRowSize; ++j)
+        {
+            if (row[j])
+            {
+                *out++ = row[j];
+                continue;
+            }
+            int run = 1;
+            while (j + run < areaVisRowSize && !row[j + run] && run < 255)
+                run++;
+            *out++ = 0;
+            *out++ = (uint8_t)run;
+            j += run - 1;
+        }
+        trap_FS_Write(compressed, out - compressed, fp);
+        totalSize += out - compressed;
+    }
+    G_LevelFree(compressed);
+
+    trap_FS_FCloseFile(fp);
+
+    G_Printf("Wrote %s (%d bytes, %d uncompressed)\n", filename, (int)totalSize, areaVisRowSize * numVisAreas);
+    return true;
+}
+
+bool AiAasWorld::LoadVisTable(const char *mapname)
+{
+    char filename[MAX_QPATH];
+    Q_snprintfz(filename, MAX_QPATH, "maps/%s.aasvis", mapname);
+
+    int fp;
+    int length = trap_FS_FOpenFile(filename, &fp, FS_READ);
+    if (length <= 0 || !fp)
+    {
+        G_Printf("No AAS visibility table %s found, use ai_genvistable to build it\n", filename);
+        return false;
+    }
+
+    uint8_t *data = (uint8_t *)G_LevelMalloc(length + 1);
+    trap_FS_Read(data, length, fp);
+    trap_FS_FCloseFile(fp);
+
+    aas_visheader_t header;
+    memcpy(&header, data, std::min(length, (int)sizeof(header)));
+
+    bool valid = (size_t)length >= sizeof(header);
+    valid = valid && LittleLong(header.ident) == AASVISID && LittleLong(header.version) == AASVISVERSION;
+    valid = valid && LittleLong(header.numareas) == numareas && (unsigned)LittleLong(header.checksum) == VisTableChecksum();
+    int numFileVisAreas = valid ? LittleLong(header.numvisareas) : 0;
+    valid = valid && numFileVisAreas > 0 && numFileVisAreas < numareas;
+    valid = valid && (size_t)length >= sizeof(header) + sizeof(int) * numFileVisAreas;
+    if (!valid)
+    {
+        G_Printf(S_COLOR_YELLOW "%s is invalid or outdated, use ai_genvistable to rebuild it\n", filename);
+        G_LevelFree(data);
+        return false;
+    }
+
+    numVisAreas = numFileVisAreas;
+    areaVisRowSize = (numVisAreas + 7) >> 3;
+    areaVisIndex = (int *)G_LevelMalloc(sizeof(int) * numareas);
+    for (int i = 0; i < numareas; ++i)
+        areaVisIndex[i] = -1;
+
+    const uint8_t *in = data + sizeof(header);
+    for (int i = 0; i < numVisAreas; ++i, in += sizeof(int))
+    {
+        int areaNum;
+        memcpy(&areaNum, in, sizeof(int));
+        areaNum = LittleLong(areaNum);
+        if (areaNum <= 0 || areaNum >= numareas)
+            valid = false;
+        else
+            areaVisIndex[areaNum] = i;
+    }
+
+    areaVisRows = (uint8_t *)G_LevelMalloc(areaVisRowSize * numVisAreas + 1);
+    const uint8_t *end = data + length;
+    uint8_t *out = areaVisRows, *outEnd = areaVisRows + areaVisRowSize * numVisAreas;
+    while (valid && out < outEnd)
+    {
+        if (in >= end)
+        {
+            valid = false;
+            break;
+        }
+        if (*in)
+        {
+            *out++ = *in++;
+            continue;
+        }
+        if (in + 1 >= end || !in[1] || in[1] > outEnd - out)
+        {
+            valid = false;
+            break;
+        }
+        memset(out, 0, in[1]);
+        out += in[1];
+        in += 2;
+    }
+
+    G_LevelFree(data);
+
+    if (!valid)
+    {
+        G_Printf(S_COLOR_YELLOW "%s is corrupt, use ai_genvistable to rebuild it\n", filename);
+        FreeVisTable();
+        return false;
+    }
+
+    useVisTable = true;
+    return true;
+}
+
+void AiAasWorld::FreeVisTable()
+{
+    if (areaVisIndex)
+        G_LevelFree(areaVisIndex);
+    if (areaVisRows)
+        G_LevelFree(areaVisRows);
+    areaVisIndex = nullptr;
+    areaVisRows = nullptr;
+    numVisAreas = 0;
+    areaVisRowSize = 0;
+    useVisTable = false;
+}
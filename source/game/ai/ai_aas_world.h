@@ -251,6 +251,14 @@ class AiAasWorld
     aas_link_t **arealinkedentities;			//entities linked into areas
     int numaaslinks;
 
+    // Precomputed visibility between view points of areas that may be tactical spots.
+    // Stored as full bit rows, areaVisIndex maps an area number to a row (or -1).
+    int numVisAreas;
+    int areaVisRowSize;
+    int *areaVisIndex;
+    uint8_t *areaVisRows;
+    bool useVisTable;
+
     static AiAasWorld *instance;
 
     AiAasWorld()
@@ -280,6 +288,12 @@ class AiAasWorld
     void FreeLinkHeap();
     void FreeLinkedEntities();
 
+    static bool IsVisTableArea(const aas_areasettings_t &areaSettings);
+    unsigned VisTableChecksum() const;
+    bool LoadVisTable(const char *mapname);
+    bool WriteVisTable(const char *mapname, const int *visAreaNums) const;
+    void FreeVisTable();
+
     aas_link_t *LinkEntity(const vec3_t absmins, const vec3_t absmaxs, int entnum);
     void UnlinkFromAreas(aas_link_t *linkedAreas);
     aas_link_t *AllocLink();
@@ -329,6 +343,28 @@ public:
     //returns the area the point is in
     int PointAreaNum(const vec3_t point) const;
 
+    // A point at the player view height above the area floor, used for area-to-area visibility tests
+    void GetAreaViewPoint(int areaNum, vec3_t point) const;
+
+    // Builds the visibility table from static world geometry and writes it next to the .aas file
+    bool GenerateVisTable(const char *mapname);
+
+    inline bool HasVisTable() const { return areaVisRows != nullptr; }
+    inline void SetUseVisTable(bool use) { useVisTable = use; }
+
+    // A conservative test: returns false only if view points of the areas can't see each other
+    // through static world geometry. Areas that are not in the table are considered visible.
+    inline bool AreasMayBeVisible(int areaNum1, int areaNum2) const
+    {
+        if (!useVisTable || !areaVisRows)
+            return true;
+        int row = areaVisIndex[areaNum1];
+        int column = areaVisIndex[areaNum2];
+        if (row < 0 || column < 0)
+            return true;
+        return (areaVisRows[row * areaVisRowSize + (column >> 3)] & (1 << (column & 7))) != 0;
+    }
+
     // If an area is not found, tries to adjust the origin a bit
     inline int FindAreaNum(const Vec3 &origin) const
     {
@@ -443,17 +443,12 @@ protected:
         if (!funcPtr || !angelExport)
             return nullptr;
 
-        asIScriptContext *ctx = angelExport->asAcquireContext(GAME_AS_ENGINE());
-        int error = ctx->Prepare(funcPtr);
-        if (error < 0)
-            return nullptr;
-
-        return ctx;
+        return G_asPrepareContext(funcPtr);
     }
 
     inline asIScriptContext *CallForContext(asIScriptContext *preparedContext)
     {
-        int error = preparedContext->Execute();
+        int error = G_asExecuteCall(preparedContext);
         // Put likely case first
         if (!G_ExecutionErrorReport(error))
             return preparedContext;
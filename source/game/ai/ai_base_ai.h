@@ -113,6 +113,8 @@ public:
     void CategorizePosition();
 
     virtual void OnBlockedTimeout() {};
+    // True if the AI has not made progress for a while (but has not reached the blocked timeout yet)
+    inline bool IsBlocked() const { return blockedTimeout - level.time <= BLOCKED_TIMEOUT - 500; }
 
     static constexpr unsigned BLOCKED_TIMEOUT = 15000;
 protected:
@@ -3,6 +3,7 @@
 #include "ai_base_team_brain.h"
 #include "ai_base_ai.h"
 #include "ai_ground_trace_cache.h"
+#include "ai_think_scheduler.h"
 #include "ai_aas_world.h"
 #include "static_vector.h"
 #include "../../gameshared/q_collision.h"
@@ -137,9 +138,16 @@ void AiBaseBrain::Think()
 
     // Always update weights before goal picking, except we have updated it in this frame
     bool weightsUpdated = false;
+    // A goal search is urgent if there is no goal to move to or the AI is stuck.
+    // Otherwise the search may be deferred if there is no time left in this frame.
+    bool isBlocked = self->ai->aiRef->IsBlocked();
 
     if (longTermGoalSearchTimeout <= level.time || longTermGoalReevaluationTimeout <= level.time)
     {
+        // Timeouts stay expired, so a deferred search is retried on next think frame
+        AiScheduledTask task(AiThinkScheduler::GOAL_SEARCH, self, !longTermGoal || isBlocked);
+        if (!task.IsAllowed())
+            return;
         if (!weightsUpdated)
         {
             UpdateInternalWeights();
@@ -150,6 +158,9 @@ void AiBaseBrain::Think()
 
     if (shortTermGoalSearchTimeout <= level.time || shortTermGoalReevaluationTimeout <= level.time)
     {
+        AiScheduledTask task(AiThinkScheduler::GOAL_SEARCH, self, !shortTermGoal || isBlocked);
+        if (!task.IsAllowed())
+            return;
         if (!weightsUpdated)
         {
             UpdateInternalWeights();
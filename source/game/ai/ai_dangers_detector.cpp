@@ -1,6 +1,7 @@
 #include "ai_shutdown_hooks_holder.h"
 #include "ai_caching_game_allocator.h"
 #include "ai_dangers_detector.h"
+#include "ai_frame_trace_cache.h"
 #include <algorithm>
 
 static inline trace_t Trace(const Vec3 &start, const Vec3 &mins, const Vec3 &maxs, const Vec3 &end, const edict_t *passedict, int contentmask = MASK_SOLID)
@@ -530,12 +531,13 @@ bool DangersDetector::FindPlasmaDangers(StaticVector<Danger, N> &dangers, Static
 template <unsigned N, unsigned M>
 bool DangersDetector::FindLaserDangers(StaticVector<Danger, N> &dangers, StaticVector<const edict_t*, M> &lasers)
 {
-    trace_t trace;
+    AiFrameTraceCache *traceCache = AiFrameTraceCache::Instance();
 
     for (unsigned i = 0; i < lasers.size(); ++i)
     {
         edict_t *beam = const_cast<edict_t *>(lasers[i]);
-        G_Trace(&trace, beam->s.origin, vec3_origin, vec3_origin, beam->s.origin2, beam, MASK_AISOLID);
+        // Every bot traces the same beams, share the result
+        const trace_t &trace = traceCache->LaserBeamTrace(beam);
         if (trace.fraction < 1.0f)
         {
             if (self != game.edicts + trace.ent)
@@ -584,17 +586,17 @@ bool DangersDetector::FindLaserDangers(StaticVector<Danger, N> &dangers, StaticV
 template <unsigned N, unsigned M>
 bool DangersDetector::FindProjectileDangers(StaticVector<Danger, N> &dangers, StaticVector<const edict_t*, M> &entities, float dangerRadius)
 {
-    trace_t trace;
     float minPrjTime = 1.0f;
     float minDamageLike = 0.0f;
 
     Vec3 botOrigin(self->s.origin);
+    AiFrameTraceCache *traceCache = AiFrameTraceCache::Instance();
 
     for (unsigned i = 0; i < entities.size(); ++i)
     {
         edict_t *target = const_cast<edict_t *>(entities[i]);
-        Vec3 end = Vec3(target->s.origin) + 2.0f * Vec3(target->velocity);
-        G_Trace(&trace, target->s.origin, target->r.mins, target->r.maxs, end.Data(), target, MASK_AISOLID);
+        // Every bot traces the same projectiles, share the result
+        const trace_t &trace = traceCache->ProjectilePathTrace(target);
         if (trace.fraction < minPrjTime)
         {
             minPrjTime = trace.fraction;
@@ -0,0 +1,196 @@
+#include "ai_shutdown_hooks_holder.h"
+#include "ai_frame_trace_cache.h"
+#include "static_vector.h"
+#include "ai_local.h"
+
+// Player pair flags
+enum : uint8_t
+{
+    PVS_TESTED = 1,
+    IN_PVS = 2,
+    VIS_TESTED = 4,
+    VISIBLE = 8
+};
+
+struct CachedEntityTrace
+{
+    unsigned framenum;
+    vec3_t start, end;
+    trace_t trace;
+};
+
+AiFrameTraceCache::AiFrameTraceCache()
+{
+    playerPairs = (uint8_t *)G_Malloc(MAX_CLIENTS * MAX_CLIENTS);
+    memset(playerPairs, 0, MAX_CLIENTS * MAX_CLIENTS);
+    entityTraces = G_Malloc(MAX_EDICTS * sizeof(CachedEntityTrace));
+    memset(entityTraces, 0, MAX_EDICTS * sizeof(CachedEntityTrace));
+    hasCachedPairs = false;
+    memset(&frameStats, 0, sizeof(frameStats));
+    memset(&lastFrameStats, 0, sizeof(lastFrameStats));
+    memset(&totalStats, 0, sizeof(totalStats));
+    numFrames = 0;
+}
+
+AiFrameTraceCache::AiFrameTraceCache(AiFrameTraceCache &&that)
+{
+    memcpy(this, &that, sizeof(AiFrameTraceCache));
+    that.playerPairs = nullptr;
+    that.entityTraces = nullptr;
+}
+
+AiFrameTraceCache::~AiFrameTraceCache()
+{
+    if (playerPairs)
+        G_Free(playerPairs);
+    if (entityTraces)
+        G_Free(entityTraces);
+}
+
+static StaticVector<AiFrameTraceCache, 1> instanceHolder;
+
+AiFrameTraceCache *AiFrameTraceCache::Instance()
+{
+    if (instanceHolder.empty())
+    {
+        instanceHolder.emplace_back(AiFrameTraceCache());
+        AiShutdownHooksHolder::Instance()->RegisterHook([&]{ instanceHolder.clear(); });
+    }
+    return &instanceHolder.front();
+}
+
+void AiFrameTraceCache::Frame()
+{
+    // Player pairs are not checked for staleness, so they must be reset each frame.
+    // Entity traces are tagged by a frame number and are checked lazily.
+    if (hasCachedPairs)
+    {
+        memset(playerPairs, 0, MAX_CLIENTS * gs.maxclients);
+        hasCachedPairs = false;
+    }
+
+    lastFrameStats = frameStats;
+    totalStats.pvsQueries += frameStats.pvsQueries;
+    totalStats.pvsTests += frameStats.pvsTests;
+    totalStats.visQueries += frameStats.visQueries;
+    totalStats.visTests += frameStats.visTests;
+    totalStats.traceQueries += frameStats.traceQueries;
+    totalStats.traces += frameStats.traces;
+    totalStats.traceMicros += frameStats.traceMicros;
+    memset(&frameStats, 0, sizeof(frameStats));
+    numFrames++;
+}
+
+static inline bool IsCachedPlayer(const edict_t *ent)
+{
+    int entNum = ENTNUM(const_cast<edict_t *>(ent));
+    return entNum >= 1 && entNum <= gs.maxclients;
+}
+
+bool AiFrameTraceCache::InPVS(const edict_t *ent1, const edict_t *ent2)
+{
+    frameStats.pvsQueries++;
+
+    uint8_t *pair = nullptr;
+    if (IsCachedPlayer(ent1) && IsCachedPlayer(ent2))
+    {
+        int num1 = PLAYERNUM(const_cast<edict_t *>(ent1)), num2 = PLAYERNUM(const_cast<edict_t *>(ent2));
+        pair = &playerPairs[std::min(num1, num2) * MAX_CLIENTS + std::max(num1, num2)];
+        if (*pair & PVS_TESTED)
+            return (*pair & IN_PVS) != 0;
+    }
+
+    frameStats.pvsTests++;
+    uint64_t startTime = trap_Microseconds();
+    bool result = trap_inPVS(ent1->s.origin, ent2->s.origin);
+    frameStats.traceMicros += trap_Microseconds() - startTime;
+
+    if (pair)
+    {
+        *pair |= PVS_TESTED | (result ? IN_PVS : 0);
+        hasCachedPairs = true;
+    }
+    return result;
+}
+
+bool AiFrameTraceCache::Visible(const edict_t *ent1, const edict_t *ent2)
+{
+    frameStats.visQueries++;
+
+    uint8_t *pair = nullptr;
+    if (IsCachedPlayer(ent1) && IsCachedPlayer(ent2))
+    {
+        int num1 = PLAYERNUM(const_cast<edict_t *>(ent1)), num2 = PLAYERNUM(const_cast<edict_t *>(ent2));
+        pair = &playerPairs[std::min(num1, num2) * MAX_CLIENTS + std::max(num1, num2)];
+        if (*pair & VIS_TESTED)
+            return (*pair & VISIBLE) != 0;
+        // Not in PVS means not visible, do not trace
+        if ((*pair & (PVS_TESTED|IN_PVS)) == PVS_TESTED)
+            return false;
+    }
+
+    frameStats.visTests++;
+    uint64_t startTime = trap_Microseconds();
+    bool result = G_Visible(const_cast<edict_t *>(ent1), const_cast<edict_t *>(ent2));
+    frameStats.traceMicros += trap_Microseconds() - startTime;
+
+    if (pair)
+    {
+        *pair |= VIS_TESTED | (result ? VISIBLE : 0);
+        hasCachedPairs = true;
+    }
+    return result;
+}
+
+const trace_t &AiFrameTraceCache::EntityTrace(const edict_t *ent, const vec3_t mins, const vec3_t maxs,
+                                               const vec3_t end)
+{
+    frameStats.traceQueries++;
+
+    CachedEntityTrace *cached = (CachedEntityTrace *)entityTraces + ENTNUM(const_cast<edict_t *>(ent));
+    // An entity may move between thinks of different bots, so check the trace points too
+    if (cached->framenum == level.framenum && VectorCompare(cached->start, ent->s.origin) &&
+        VectorCompare(cached->end, end))
+        return cached->trace;
+
+    frameStats.traces++;
+    cached->framenum = level.framenum;
+    VectorCopy(ent->s.origin, cached->start);
+    VectorCopy(end, cached->end);
+
+    uint64_t startTime = trap_Microseconds();
+    G_Trace(&cached->trace, cached->start, const_cast<float *>(mins), const_cast<float *>(maxs), cached->end,
+            const_cast<edict_t *>(ent), MASK_AISOLID);
+    frameStats.traceMicros += trap_Microseconds() - startTime;
+
+    return cached->trace;
+}
+
+const trace_t &AiFrameTraceCache::LaserBeamTrace(const edict_t *beam)
+{
+    return EntityTrace(beam, vec3_origin, vec3_origin, beam->s.origin2);
+}
+
+const trace_t &AiFrameTraceCache::ProjectilePathTrace(const edict_t *projectile)
+{
+    vec3_t end;
+    VectorMA(projectile->s.origin, 2.0f, projectile->velocity, end);
+    return EntityTrace(projectile, projectile->r.mins, projectile->r.maxs, end);
+}
+
+void AiFrameTraceCache::PrintStats() const
+{
+    const Stats &last = lastFrameStats;
+    G_Printf("Last frame: %u PVS tests of %u queries, %u visibility traces of %u queries, %u traces of %u queries\n",
+             last.pvsTests, last.pvsQueries, last.visTests, last.visQueries, last.traces, last.traceQueries);
+    G_Printf("Last frame: %u tests saved, %u us spent in tests\n", last.Saved(), (unsigned)last.traceMicros);
+
+    if (!numFrames)
+        return;
+
+    const Stats &total = totalStats;
+    G_Printf("Average over %u frames: %.1f tests saved, %.1f tests done, %.1f us spent in tests\n", numFrames,
+             total.Saved() / (float)numFrames,
+             (total.pvsTests + total.visTests + total.traces) / (float)numFrames,
+             total.traceMicros / (float)numFrames);
+}
@@ -0,0 +1,61 @@
+#ifndef QFUSION_AI_FRAME_TRACE_CACHE_H
+#define QFUSION_AI_FRAME_TRACE_CACHE_H
+
+#include <stdint.h>
+#include "../../gameshared/q_collision.h"
+
+// Visibility tests and traces that give the same result for every AI within a game frame.
+// With many bots the same player pairs (and the same projectiles) are tested over and over,
+// so results are computed lazily on a first request and shared until the next frame.
+class AiFrameTraceCache
+{
+    // In order to prevent inclusion of g_local.h declare untyped pointers
+    // A symmetric matrix of PVS/visibility test results over player edicts
+    uint8_t *playerPairs;
+    // Traces of projectiles and laser beams paths
+    void *entityTraces;
+    bool hasCachedPairs;
+
+    struct Stats
+    {
+        unsigned pvsQueries, pvsTests;
+        unsigned visQueries, visTests;
+        unsigned traceQueries, traces;
+        uint64_t traceMicros;
+
+        inline unsigned Saved() const
+        {
+            return (pvsQueries - pvsTests) + (visQueries - visTests) + (traceQueries - traces);
+        }
+    };
+
+    Stats frameStats, lastFrameStats, totalStats;
+    unsigned numFrames;
+
+    AiFrameTraceCache();
+    AiFrameTraceCache(const AiFrameTraceCache &that) = delete;
+    AiFrameTraceCache &operator=(const AiFrameTraceCache &that) = delete;
+
+    const trace_t &EntityTrace(const struct edict_s *ent, const vec3_t mins, const vec3_t maxs, const vec3_t end);
+public:
+    AiFrameTraceCache(AiFrameTraceCache &&that);
+    ~AiFrameTraceCache();
+    static AiFrameTraceCache *Instance();
+
+    // Should be called at the start of each game frame
+    void Frame();
+
+    // Same as trap_inPVS() for entities origins
+    bool InPVS(const struct edict_s *ent1, const struct edict_s *ent2);
+    // Same as G_Visible(). Considered to be symmetric for players.
+    bool Visible(const struct edict_s *ent1, const struct edict_s *ent2);
+
+    // A trace along a laser beam that ignores the beam itself
+    const trace_t &LaserBeamTrace(const struct edict_s *beam);
+    // A trace along a projectile path for the next 2 seconds that ignores the projectile itself
+    const trace_t &ProjectilePathTrace(const struct edict_s *projectile);
+
+    void PrintStats() const;
+};
+
+#endif
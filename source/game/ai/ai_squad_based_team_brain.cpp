@@ -1,6 +1,7 @@
 #include "ai_squad_based_team_brain.h"
 #include "ai_objective_based_team_brain.h"
 #include "ai_ground_trace_cache.h"
+#include "ai_frame_trace_cache.h"
 #include "bot.h"
 #include <algorithm>
 #include <limits>
@@ -341,16 +342,14 @@ bool AiSquad::CheckCanMoveTogether() const
 
 bool AiSquad::CheckCanFightTogether() const
 {
-    // Just check that each bot is visible for each other one
-    trace_t trace;
+    // Just check that each bot is visible for each other one.
+    // Bots are likely to have tested these pairs already while looking for enemies this frame.
+    AiFrameTraceCache *traceCache = AiFrameTraceCache::Instance();
     for (unsigned i = 0; i < bots.size(); ++i)
     {
         for (unsigned j = i + 1; j < bots.size(); ++j)
         {
-            edict_t *firstEnt = const_cast<edict_t*>(bots[i]->Self());
-            edict_t *secondEnt = const_cast<edict_t*>(bots[j]->Self());
-            G_Trace(&trace, firstEnt->s.origin, nullptr, nullptr, secondEnt->s.origin, firstEnt, MASK_AISOLID);
-            if (trace.fraction != 1.0f && trace.ent != ENTNUM(secondEnt))
+            if (!traceCache->Visible(bots[i]->Self(), bots[j]->Self()))
                 return false;
         }
     }
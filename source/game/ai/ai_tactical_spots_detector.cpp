@@ -243,6 +243,10 @@ void TacticalSpotsDetector::CheckAreasVisibleOriginTrace(const AdvantageProblemP
         Vec3 areaPoint(testedArea.center);
         areaPoint.Z() = testedArea.mins[2] + PLAYER_VIEW_GROUND_OFFSET;
 
+        // The origin is not an area view point so the area vis table can't be used, but PVS is conservative too
+        if (usePvsPrefilter && !trap_inPVS(areaPoint.Data(), origin))
+            continue;
+
         G_Trace(&trace, areaPoint.Data(), nullptr, nullptr, origin, passent, MASK_AISOLID);
         if (trace.fraction == 1.0f)
             result.push_back(candidateAreas[i]);
@@ -251,8 +255,9 @@ void TacticalSpotsDetector::CheckAreasVisibleOriginTrace(const AdvantageProblemP
 
 void TacticalSpotsDetector::SortByVisAndOtherFactors(const OriginParams &params, TraceCheckedAreas &areas)
 {
-    const aas_area_t *worldAreas = AiAasWorld::Instance()->Areas();
-    const aas_areasettings_t *worldAreaSettings = AiAasWorld::Instance()->AreaSettings();
+    const AiAasWorld *aasWorld = AiAasWorld::Instance();
+    const aas_area_t *worldAreas = aasWorld->Areas();
+    const aas_areasettings_t *worldAreaSettings = aasWorld->AreaSettings();
 
     const float originZ = params.origin[2];
     const float searchRadius = params.searchRadius;
@@ -265,13 +270,10 @@ void TacticalSpotsDetector::SortByVisAndOtherFactors(const OriginParams &params,
     std::fill(traceResultCache, traceResultCache + areas.capacity() * areas.capacity(), -1);
 
     // Compute area points to avoid doing it in the trace loop.
+    // These must be the same points the area vis table has been built for.
     vec3_t areaPoints[areas.capacity()];
     for (unsigned i = 0; i < areas.size(); ++i)
-    {
-        const aas_area_t &area = worldAreas[areas[i].areaNum];
-        VectorCopy(area.center, areaPoints[i]);
-        areaPoints[i][2] = area.mins[2] + PLAYER_VIEW_GROUND_OFFSET;
-    }
+        aasWorld->GetAreaViewPoint(areas[i].areaNum, areaPoints[i]);
 
     trace_t trace;
     for (unsigned i = 0; i < areas.size(); ++i)
@@ -286,9 +288,14 @@ void TacticalSpotsDetector::SortByVisAndOtherFactors(const OriginParams &params,
                 numVisAreas += cachedTraceResult;
                 continue;
             }
-            G_Trace(&trace, areaPoints[i], nullptr, nullptr, areaPoints[j], nullptr, MASK_AISOLID);
-            // Omit fractional part by intention
-            signed char visibility = (signed char)trace.fraction;
+            signed char visibility = 0;
+            // Skip pairs that are blocked by the world geometry according to the precomputed table
+            if (aasWorld->AreasMayBeVisible(areas[i].areaNum, areas[j].areaNum))
+            {
+                G_Trace(&trace, areaPoints[i], nullptr, nullptr, areaPoints[j], nullptr, MASK_AISOLID);
+                // Omit fractional part by intention
+                visibility = (signed char)trace.fraction;
+            }
             traceResultCache[areas.capacity() * i + j] = visibility;
             traceResultCache[areas.capacity() * j + i] = visibility;
             numVisAreas += visibility;
@@ -304,9 +311,14 @@ void TacticalSpotsDetector::SortByVisAndOtherFactors(const OriginParams &params,
                 numVisAreas += cachedTraceResult;
                 continue;
             }
-            G_Trace(&trace, areaPoints[i], nullptr, nullptr, areaPoints[j], nullptr, MASK_AISOLID);
-            // Omit fractional part by intention
-            signed char visibility = (signed char)trace.fraction;
+            signed char visibility = 0;
+            // Skip pairs that are blocked by the world geometry according to the precomputed table
+            if (aasWorld->AreasMayBeVisible(areas[i].areaNum, areas[j].areaNum))
+            {
+                G_Trace(&trace, areaPoints[i], nullptr, nullptr, areaPoints[j], nullptr, MASK_AISOLID);
+                // Omit fractional part by intention
+                visibility = (signed char)trace.fraction;
+            }
             traceResultCache[areas.capacity() * i + j] = visibility;
             traceResultCache[areas.capacity() * j + i] = visibility;
             numVisAreas += visibility;
@@ -382,9 +394,13 @@ bool TacticalSpotsDetector::LooksLikeACoverArea(const aas_area_t &area, const Or
     const edict_t *doNotHitEntity = originParams.originEntity;
 
     trace_t trace;
-    G_Trace(&trace, attackerOrigin, nullptr, nullptr, areaCenter, passent, MASK_AISOLID);
-    if (trace.fraction == 1.0f)
-        return false;
+    // If the area center is out of the attacker PVS, the trace is known to be blocked
+    if (!usePvsPrefilter || trap_inPVS(attackerOrigin, areaCenter))
+    {
+        G_Trace(&trace, attackerOrigin, nullptr, nullptr, areaCenter, passent, MASK_AISOLID);
+        if (trace.fraction == 1.0f)
+            return false;
+    }
 
     float harmfulRayThickness = problemParams.harmfulRayThickness;
 
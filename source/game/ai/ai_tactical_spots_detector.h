@@ -97,6 +97,7 @@ private:
     float wallPenalty;
     float spotProximityThreshold;
     bool checkToAndBackReachability;
+    bool usePvsPrefilter;
 
     struct AreaAndScore
     {
@@ -175,6 +176,7 @@ public:
         wallPenalty = 0.33f;
         spotProximityThreshold = 64.0f;
         checkToAndBackReachability = false;
+        usePvsPrefilter = true;
     }
 
     inline void SetCheckToAndBackReachability(bool checkToAndBack)
@@ -209,6 +211,9 @@ public:
 
     inline void SetSpotProximityThreshold(float radius) { spotProximityThreshold = std::max(0.0f, radius); }
 
+    // Rejecting traces by PVS first is always on in the game, it can be turned off to measure it
+    inline void SetUsePvsPrefilter(bool use) { usePvsPrefilter = use; }
+
     int FindPositionalAdvantageSpots(const OriginParams &originParams, const AdvantageProblemParams &problemParams,
                                      vec3_t *spots, int maxSpots);
 
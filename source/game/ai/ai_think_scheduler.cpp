@@ -0,0 +1,139 @@
+#include "ai_shutdown_hooks_holder.h"
+#include "ai_think_scheduler.h"
+#include "static_vector.h"
+#include "ai_local.h"
+
+static const char *taskNames[AiThinkScheduler::NUM_TASK_TYPES] =
+{
+    "goal search", "tactical spots", "rocket jump"
+};
+
+AiThinkScheduler::AiThinkScheduler()
+{
+    budgetVar = trap_Cvar_Get("ai_thinkBudget", "2000", CVAR_ARCHIVE);
+    // Start from a rough guess, first runs of tasks correct it quickly
+    for (float &cost: averageCost)
+        cost = 100.0f;
+    memset(deferrals, 0, sizeof(deferrals));
+    memset(&frameStats, 0, sizeof(frameStats));
+    memset(&lastFrameStats, 0, sizeof(lastFrameStats));
+    memset(&totalStats, 0, sizeof(totalStats));
+    numFrames = 0;
+    numOverBudgetFrames = 0;
+    maxFrameMicros = 0;
+}
+
+static StaticVector<AiThinkScheduler, 1> instanceHolder;
+
+AiThinkScheduler *AiThinkScheduler::Instance()
+{
+    if (instanceHolder.empty())
+    {
+        instanceHolder.emplace_back(AiThinkScheduler());
+        AiShutdownHooksHolder::Instance()->RegisterHook([&]{ instanceHolder.clear(); });
+    }
+    return &instanceHolder.front();
+}
+
+void AiThinkScheduler::Frame()
+{
+    int budget = budgetVar->integer;
+    if (budget > 0 && frameStats.micros > (unsigned)budget)
+        numOverBudgetFrames++;
+    if (frameStats.micros > maxFrameMicros)
+        maxFrameMicros = frameStats.micros;
+
+    lastFrameStats = frameStats;
+    totalStats.tasks += frameStats.tasks;
+    totalStats.deferred += frameStats.deferred;
+    totalStats.forced += frameStats.forced;
+    totalStats.micros += frameStats.micros;
+    memset(&frameStats, 0, sizeof(frameStats));
+    numFrames++;
+}
+
+bool AiThinkScheduler::TryBeginTask(TaskType type, const edict_t *ent, bool urgent)
+{
+    uint8_t *entDeferrals = &deferrals[ENTNUM(const_cast<edict_t *>(ent))][type];
+
+    // A zero budget disables scheduling. Also always let a first task in a frame run.
+    int budget = budgetVar->integer;
+    if (budget <= 0 || !frameStats.tasks)
+    {
+        *entDeferrals = 0;
+        return true;
+    }
+
+    float allowedMicros = budget * (urgent ? 1.0f : NON_URGENT_BUDGET_FRACTION);
+    if (frameStats.micros + averageCost[type] <= allowedMicros)
+    {
+        *entDeferrals = 0;
+        return true;
+    }
+
+    // Do not starve an AI, it will run the task on its next think frame
+    if (*entDeferrals >= MAX_DEFERRALS)
+    {
+        *entDeferrals = 0;
+        frameStats.forced++;
+        return true;
+    }
+
+    (*entDeferrals)++;
+    frameStats.deferred++;
+    return false;
+}
+
+void AiThinkScheduler::EndTask(TaskType type, uint64_t micros)
+{
+    averageCost[type] = 0.9f * averageCost[type] + 0.1f * micros;
+    frameStats.tasks++;
+    frameStats.micros += micros;
+}
+
+void AiThinkScheduler::PrintStats() const
+{
+    int budget = budgetVar->integer;
+    if (budget > 0)
+        G_Printf("Budget: %d us per frame\n", budget);
+    else
+        G_Printf("Budget: unlimited (ai_thinkBudget is 0)\n");
+
+    const Stats &last = lastFrameStats;
+    G_Printf("Last frame: %u tasks run in %u us, %u deferred, %u forced\n",
+             last.tasks, (unsigned)last.micros, last.deferred, last.forced);
+
+    for (int i = 0; i < NUM_TASK_TYPES; ++i)
+        G_Printf("Average cost of %s: %.1f us\n", taskNames[i], averageCost[i]);
+
+    if (!numFrames)
+        return;
+
+    const Stats &total = totalStats;
+    G_Printf("Average over %u frames: %.1f tasks run in %.1f us, %.1f deferred, %.1f forced\n", numFrames,
+             total.tasks / (float)numFrames, total.micros / (float)numFrames,
+             total.deferred / (float)numFrames, total.forced / (float)numFrames);
+    G_Printf("Over budget frames: %u (%.1f%%), max %u us spent in a frame\n", numOverBudgetFrames,
+             100.0f * numOverBudgetFrames / numFrames, (unsigned)maxFrameMicros);
+}
+
+AiScheduledTask::AiScheduledTask(AiThinkScheduler::TaskType type_, const edict_t *ent, bool urgent)
+    : type(type_)
+{
+    allowed = AiThinkScheduler::Instance()->TryBeginTask(type, ent, urgent);
+    startTime = 0;
+    if (allowed)
+    {
+        trap_Prof_Begin(taskNames[type]);
+        startTime = trap_Microseconds();
+    }
+}
+
+AiScheduledTask::~AiScheduledTask()
+{
+    if (allowed)
+    {
+        AiThinkScheduler::Instance()->EndTask(type, trap_Microseconds() - startTime);
+        trap_Prof_End();
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef QFUSION_AI_THINK_SCHEDULER_H
+#define QFUSION_AI_THINK_SCHEDULER_H
+
+#include <stdint.h>
+#include "../../gameshared/q_shared.h"
+
+// Spreads expensive AI queries over game frames so that a frame does not spend more than a given time in them.
+// Each query kind has a cost measured at runtime. A query that does not fit the rest of a frame budget is deferred
+// to a next think frame of the AI, unless the AI is in urgent need of it or the query has been deferred too often.
+class AiThinkScheduler
+{
+public:
+    enum TaskType
+    {
+        GOAL_SEARCH,
+        TACTICAL_SPOTS,
+        ROCKET_JUMP,
+
+        NUM_TASK_TYPES
+    };
+private:
+    // Non-urgent tasks may take only this part of a frame budget, the rest is kept for urgent ones
+    static constexpr float NON_URGENT_BUDGET_FRACTION = 0.6f;
+    // A task deferred this many times in a row is run regardless of the budget
+    static constexpr unsigned MAX_DEFERRALS = 2;
+
+    // In order to prevent inclusion of g_local.h declare untyped pointers
+    struct cvar_s *budgetVar;
+
+    // Exponential moving average of a task cost in microseconds
+    float averageCost[NUM_TASK_TYPES];
+    uint8_t deferrals[MAX_EDICTS][NUM_TASK_TYPES];
+
+    struct Stats
+    {
+        unsigned tasks, deferred, forced;
+        uint64_t micros;
+    };
+
+    Stats frameStats, lastFrameStats, totalStats;
+    unsigned numFrames, numOverBudgetFrames;
+    uint64_t maxFrameMicros;
+
+    AiThinkScheduler();
+    AiThinkScheduler(const AiThinkScheduler &that) = delete;
+    AiThinkScheduler &operator=(const AiThinkScheduler &that) = delete;
+public:
+    AiThinkScheduler(AiThinkScheduler &&that) = default;
+    static AiThinkScheduler *Instance();
+
+    // Should be called at the start of each game frame
+    void Frame();
+
+    // Returns true if the entity may run the task now. If true is returned, EndTask() must be called.
+    bool TryBeginTask(TaskType type, const struct edict_s *ent, bool urgent);
+    void EndTask(TaskType type, uint64_t micros);
+
+    void PrintStats() const;
+};
+
+// A helper that asks the scheduler for a task run and reports the run cost on scope exit
+class AiScheduledTask
+{
+    AiThinkScheduler::TaskType type;
+    bool allowed;
+    uint64_t startTime;
+public:
+    AiScheduledTask(AiThinkScheduler::TaskType type_, const struct edict_s *ent, bool urgent);
+    ~AiScheduledTask();
+
+    inline bool IsAllowed() const { return allowed; }
+};
+
+#endif
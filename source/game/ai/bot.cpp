@@ -1,5 +1,6 @@
 #include "bot.h"
 #include "ai_aas_world.h"
+#include "ai_frame_trace_cache.h"
 #include <algorithm>
 
 Bot::Bot(edict_t *self_, float skillLevel_)
@@ -179,15 +180,17 @@ void Bot::RegisterVisibleEnemies()
 
     static_assert(AiBaseEnemyPool::MAX_TRACKED_ENEMIES <= MAX_CLIENTS, "targetsInPVS capacity may be exceeded");
 
+    // PVS and visibility tests results are shared with other bots that test the same pairs this frame
+    AiFrameTraceCache *traceCache = AiFrameTraceCache::Instance();
     for (int i = 0, end = std::min(candidateTargets.size(), botBrain.MaxTrackedEnemies()); i < end; ++i)
     {
         edict_t *ent = game.edicts + candidateTargets[i].entNum;
-        if (trap_inPVS(self->s.origin, ent->s.origin))
+        if (traceCache->InPVS(self, ent))
             targetsInPVS.push_back(ent);
     }
 
     for (auto ent: targetsInPVS)
-        if (G_Visible(self, ent))
+        if (traceCache->Visible(self, ent))
             visibleTargets.push_back(ent);
 
     // Call bot brain callbacks on visible targets
@@ -3,6 +3,7 @@
 #include "ai_squad_based_team_brain.h"
 #include "bot_brain.h"
 #include "ai_tactical_spots_detector.h"
+#include "ai_think_scheduler.h"
 #include <algorithm>
 #include <limits>
 #include <stdarg.h>
@@ -518,6 +519,11 @@ void BotBrain::CheckTacticalPosition()
     if (combatTask.advance)
         return;
 
+    // Looking for a cover is urgent, a better position may be found a bit later
+    AiScheduledTask task(AiThinkScheduler::TACTICAL_SPOTS, self, combatTask.retreat);
+    if (!task.IsAllowed())
+        return;
+
     vec3_t newTacticalSpot;
     bool hasFoundNewSpot = false;
     unsigned spotTimeout = 300;
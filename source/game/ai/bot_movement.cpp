@@ -1,6 +1,7 @@
 #include "bot.h"
 #include "ai_aas_world.h"
 #include "ai_ground_trace_cache.h"
+#include "ai_think_scheduler.h"
 
 void Bot::MoveFrame(usercmd_t *ucmd, bool inhibitCombat, bool beSilent)
 {
@@ -901,9 +902,14 @@ void Bot::MoveGenericRunning(Vec3 *intendedLookVec, usercmd_t *ucmd, bool beSile
         return;
     }
 
-    // TryRocketJumpShortcut() is expensive, call it only in Think() frames
-    if (!beSilent && !ShouldSkipThinkFrame() && TryRocketJumpShortcut(ucmd))
-        return;
+    // TryRocketJumpShortcut() is expensive, call it only in Think() frames (and if the frame budget allows it).
+    // A rocket jump is urgent for a blocked bot since it might be the only way out.
+    if (!beSilent && !ShouldSkipThinkFrame())
+    {
+        AiScheduledTask task(AiThinkScheduler::ROCKET_JUMP, self, IsBlocked());
+        if (task.IsAllowed() && TryRocketJumpShortcut(ucmd))
+            return;
+    }
 
     Vec3 velocityVec(self->velocity);
     float speed = velocityVec.SquaredLength() > 0.01f ? velocityVec.LengthFast() : 0;
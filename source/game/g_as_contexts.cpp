@@ -0,0 +1,538 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "g_local.h"
+#include "g_as_local.h"
+
+/*
+============================================================================
+
+CONTEXT POOL
+
+Gametype callbacks are called several times per frame. Each of the hot entry
+points gets a private context which stays prepared for the same function, so
+that preparing it again for the next call is cheap.
+
+============================================================================
+*/
+
+#define G_AS_MAX_POOLED_CONTEXTS	32
+
+typedef struct
+{
+	asIScriptFunction *func;
+	asIScriptContext *ctx;
+} g_aspooledcontext_t;
+
+static g_aspooledcontext_t asContextPool[G_AS_MAX_POOLED_CONTEXTS];
+
+static inline bool G_asContextIsBusy( asIScriptContext *ctx )
+{
+	asEContextState state = ctx->GetState();
+	return state == asEXECUTION_ACTIVE || state == asEXECUTION_SUSPENDED;
+}
+
+/*
+* G_asPrepareContext
+*
+* Returns a context prepared for the function or NULL on error. Nested calls
+* to a function which is already executing fall back to a shared context.
+*/
+asIScriptContext *G_asPrepareContext( asIScriptFunction *func )
+{
+	int i;
+	asIScriptContext *ctx;
+	g_aspooledcontext_t *pooled, *freeSlot;
+
+	if( !func || !angelExport ) {
+		return NULL;
+	}
+
+	ctx = NULL;
+	freeSlot = NULL;
+	for( i = 0, pooled = asContextPool; i < G_AS_MAX_POOLED_CONTEXTS; i++, pooled++ ) {
+		if( pooled->func == func ) {
+			if( !G_asContextIsBusy( pooled->ctx ) ) {
+				ctx = pooled->ctx;
+			}
+			break;
+		}
+		if( !pooled->func && !freeSlot ) {
+			freeSlot = pooled;
+		}
+	}
+
+	if( !ctx && i == G_AS_MAX_POOLED_CONTEXTS && freeSlot ) {
+		if( !freeSlot->ctx ) {
+			freeSlot->ctx = angelExport->asCreateContext( GAME_AS_ENGINE() );
+		}
+		if( freeSlot->ctx && !G_asContextIsBusy( freeSlot->ctx ) ) {
+			freeSlot->func = func;
+			ctx = freeSlot->ctx;
+		}
+	}
+
+	if( !ctx ) {
+		ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
+		if( !ctx ) {
+			return NULL;
+		}
+	}
+
+	if( ctx->Prepare( func ) < 0 ) {
+		return NULL;
+	}
+
+	return ctx;
+}
+
+/*
+* G_asResetContextPool
+*
+* Drops the references pooled contexts hold to script functions, must be called
+* before the module the functions belong to is discarded.
+*/
+void G_asResetContextPool( void )
+{
+	int i;
+	g_aspooledcontext_t *pooled;
+
+	for( i = 0, pooled = asContextPool; i < G_AS_MAX_POOLED_CONTEXTS; i++, pooled++ ) {
+		if( pooled->ctx && !G_asContextIsBusy( pooled->ctx ) ) {
+			pooled->ctx->Unprepare();
+		}
+		pooled->func = NULL;
+	}
+}
+
+/*
+* G_asReleaseContextPool
+*/
+void G_asReleaseContextPool( void )
+{
+	int i;
+	g_aspooledcontext_t *pooled;
+
+	for( i = 0, pooled = asContextPool; i < G_AS_MAX_POOLED_CONTEXTS; i++, pooled++ ) {
+		if( pooled->ctx && angelExport ) {
+			angelExport->asReleaseContext( pooled->ctx );
+		}
+	}
+
+	memset( asContextPool, 0, sizeof( asContextPool ) );
+}
+
+/*
+============================================================================
+
+PROFILER
+
+While enabled, the line callback is set on every context executed through
+G_asExecuteCall. The time and the number of allocations between two
+statements are charged to the range of lines the first one belongs to.
+
+============================================================================
+*/
+
+#define G_ASPROF_MAX_ENTRIES		2048
+#define G_ASPROF_HASH_SIZE			1024
+
+#define G_ASPROF_DEFAULT_LINES		1
+#define G_ASPROF_DEFAULT_DUMP		20
+
+typedef struct g_asprofentry_s
+{
+	const asIScriptFunction *func;	// NULL once the module has been discarded
+	int firstLine;
+	char name[96];
+	char section[64];
+
+	unsigned int hits;
+	unsigned int allocs;
+	uint64_t usec;
+
+	struct g_asprofentry_s *hashNext;
+} g_asprofentry_t;
+
+typedef struct
+{
+	bool active;
+	int numLines;
+
+	g_asprofentry_t *entries;
+	int numEntries;
+	unsigned int numDropped;
+	g_asprofentry_t *hash[G_ASPROF_HASH_SIZE];
+
+	uint64_t startTime;
+	uint64_t totalTime;
+
+	// the range of lines being executed and when it has been entered
+	g_asprofentry_t *current;
+	uint64_t time;
+	unsigned int allocs;
+} g_asprofile_t;
+
+static g_asprofile_t asprof;
+
+/*
+* G_asProfileFindEntry
+*/
+static g_asprofentry_t *G_asProfileFindEntry( const asIScriptFunction *func, int line, const char *section )
+{
+	unsigned int hashKey;
+	int firstLine;
+	g_asprofentry_t *entry;
+
+	firstLine = line - ( line - 1 ) % asprof.numLines;
+
+	hashKey = ( unsigned int )( ( uintptr_t )func >> 4 ) * 31 + ( unsigned int )firstLine;
+	hashKey &= G_ASPROF_HASH_SIZE - 1;
+
+	for( entry = asprof.hash[hashKey]; entry; entry = entry->hashNext ) {
+		if( entry->func == func && entry->firstLine == firstLine ) {
+			return entry;
+		}
+	}
+
+	if( asprof.numEntries == G_ASPROF_MAX_ENTRIES ) {
+		asprof.numDropped++;
+		return NULL;
+	}
+
+	entry = &asprof.entries[asprof.numEntries++];
+	memset( entry, 0, sizeof( *entry ) );
+	entry->func = func;
+	entry->firstLine = firstLine;
+	Q_strncpyz( entry->name, func->GetDeclaration( true, true, false ), sizeof( entry->name ) );
+	Q_strncpyz( entry->section, section ? section : "", sizeof( entry->section ) );
+
+	entry->hashNext = asprof.hash[hashKey];
+	asprof.hash[hashKey] = entry;
+	return entry;
+}
+
+/*
+* G_asProfileCharge
+*
+* Charges the time and allocations since the last call to the current range of lines.
+*/
+static void G_asProfileCharge( void )
+{
+	uint64_t time = trap_Microseconds();
+	unsigned int allocs = angelExport->asGetAllocationCount();
+
+	if( asprof.current ) {
+		asprof.current->usec += time - asprof.time;
+		asprof.current->allocs += allocs - asprof.allocs;
+	}
+
+	asprof.time = time;
+	asprof.allocs = allocs;
+}
+
+/*
+* G_asProfileLineCallback
+*/
+static void G_asProfileLineCallback( asIScriptContext *ctx, void *param )
+{
+	int line;
+	const char *section;
+	asIScriptFunction *func;
+
+	G_asProfileCharge();
+
+	asprof.current = NULL;
+
+	func = ctx->GetFunction( 0 );
+	if( !func ) {
+		return;
+	}
+
+	section = NULL;
+	line = ctx->GetLineNumber( 0, NULL, &section );
+
+	asprof.current = G_asProfileFindEntry( func, line, section );
+	if( asprof.current ) {
+		asprof.current->hits++;
+	}
+
+	// don't charge the time spent here to the script
+	asprof.time = trap_Microseconds();
+}
+
+/*
+* G_asExecuteCall
+*
+* Executes the prepared context, charging the execution to the profile if it's enabled.
+*/
+int G_asExecuteCall( asIScriptContext *ctx )
+{
+	int error;
+	g_asprofentry_t *caller;
+
+	if( !asprof.active ) {
+		return ctx->Execute();
+	}
+
+	// we may be called from a script, which resumes after this call returns
+	G_asProfileCharge();
+	caller = asprof.current;
+	asprof.current = NULL;
+
+	ctx->SetLineCallback( asFUNCTION( G_asProfileLineCallback ), NULL, asCALL_CDECL );
+
+	error = ctx->Execute();
+
+	ctx->ClearLineCallback();
+
+	G_asProfileCharge();
+	asprof.current = caller;
+
+	return error;
+}
+
+/*
+* G_asProfileDetachModule
+*
+* Script functions of a discarded module may be reused at the same addresses, keep
+* what has been collected for them under their names only.
+*/
+void G_asProfileDetachModule( void )
+{
+	int i;
+
+	if( !asprof.entries ) {
+		return;
+	}
+
+	for( i = 0; i < asprof.numEntries; i++ ) {
+		asprof.entries[i].func = NULL;
+	}
+	memset( asprof.hash, 0, sizeof( asprof.hash ) );
+}
+
+/*
+* G_asProfileReset
+*/
+static void G_asProfileReset( void )
+{
+	asprof.numEntries = 0;
+	asprof.numDropped = 0;
+	asprof.totalTime = 0;
+	asprof.startTime = trap_Microseconds();
+	asprof.current = NULL;
+	memset( asprof.hash, 0, sizeof( asprof.hash ) );
+}
+
+/*
+* G_asShutdownProfiler
+*/
+void G_asShutdownProfiler( void )
+{
+	if( asprof.entries ) {
+		G_Free( asprof.entries );
+	}
+	memset( &asprof, 0, sizeof( asprof ) );
+}
+
+static int G_asProfileCmpByName( const void *p1, const void *p2 )
+{
+	const g_asprofentry_t *e1 = ( const g_asprofentry_t * )p1, *e2 = ( const g_asprofentry_t * )p2;
+	int cmp;
+
+	cmp = strcmp( e1->section, e2->section );
+	if( cmp ) {
+		return cmp;
+	}
+	cmp = strcmp( e1->name, e2->name );
+	if( cmp ) {
+		return cmp;
+	}
+	return e1->firstLine - e2->firstLine;
+}
+
+static int G_asProfileCmpByTime( const void *p1, const void *p2 )
+{
+	const g_asprofentry_t *e1 = ( const g_asprofentry_t * )p1, *e2 = ( const g_asprofentry_t * )p2;
+
+	if( e1->usec == e2->usec ) {
+		return 0;
+	}
+	return e1->usec > e2->usec ? -1 : 1;
+}
+
+/*
+* G_asProfileMerge
+*
+* Merges entries sharing the same function and line range, or the same function if
+* byFunction is true. Returns the new number of entries.
+*/
+static int G_asProfileMerge( g_asprofentry_t *entries, int numEntries, bool byFunction )
+{
+	int i, j;
+
+	if( byFunction ) {
+		for( i = 0; i < numEntries; i++ ) {
+			entries[i].firstLine = 0;
+		}
+	}
+
+	qsort( entries, numEntries, sizeof( *entries ), G_asProfileCmpByName );
+
+	for( i = 0, j = -1; i < numEntries; i++ ) {
+		if( j >= 0 && !G_asProfileCmpByName( &entries[j], &entries[i] ) ) {
+			entries[j].hits += entries[i].hits;
+			entries[j].allocs += entries[i].allocs;
+			entries[j].usec += entries[i].usec;
+			continue;
+		}
+		entries[++j] = entries[i];
+	}
+
+	qsort( entries, j + 1, sizeof( *entries ), G_asProfileCmpByTime );
+	return j + 1;
+}
+
+/*
+* G_asProfileDump
+*/
+static void G_asProfileDump( int maxEntries )
+{
+	int i, numEntries;
+	uint64_t totalTime, scriptTime;
+	g_asprofentry_t *entries, *entry;
+
+	if( !asprof.numEntries ) {
+		G_Printf( "No script profile has been collected\n" );
+		return;
+	}
+
+	totalTime = asprof.totalTime;
+	if( asprof.active ) {
+		totalTime += trap_Microseconds() - asprof.startTime;
+	}
+
+	scriptTime = 0;
+	for( i = 0; i < asprof.numEntries; i++ ) {
+		scriptTime += asprof.entries[i].usec;
+	}
+
+	G_Printf( "Script time: %.3f ms of %.3f ms profiled (%.2f%%)\n", scriptTime / 1000.0, totalTime / 1000.0,
+		totalTime ? 100.0 * scriptTime / totalTime : 0.0 );
+	if( asprof.numDropped ) {
+		G_Printf( S_COLOR_YELLOW "%u statements were not profiled, the profile is full\n", asprof.numDropped );
+	}
+
+	entries = ( g_asprofentry_t * )G_Malloc( asprof.numEntries * sizeof( *entries ) );
+
+	// by line ranges
+	memcpy( entries, asprof.entries, asprof.numEntries * sizeof( *entries ) );
+	numEntries = G_asProfileMerge( entries, asprof.numEntries, false );
+
+	G_Printf( "\n%10s %6s %9s %8s  %s\n", "usec", "%", "hits", "allocs", "lines" );
+	for( i = 0, entry = entries; i < numEntries && i < maxEntries; i++, entry++ ) {
+		char lines[32];
+
+		if( asprof.numLines > 1 ) {
+			Q_snprintfz( lines, sizeof( lines ), "%i-%i", entry->firstLine, entry->firstLine + asprof.numLines - 1 );
+		} else {
+			Q_snprintfz( lines, sizeof( lines ), "%i", entry->firstLine );
+		}
+
+		G_Printf( "%10llu %6.2f %9u %8u  %s:%s %s\n", (unsigned long long)entry->usec, scriptTime ? 100.0 * entry->usec / scriptTime : 0.0,
+			entry->hits, entry->allocs, entry->section, lines, entry->name );
+	}
+
+	// by functions
+	memcpy( entries, asprof.entries, asprof.numEntries * sizeof( *entries ) );
+	numEntries = G_asProfileMerge( entries, asprof.numEntries, true );
+
+	G_Printf( "\n%10s %6s %9s %8s  %s\n", "usec", "%", "hits", "allocs", "function" );
+	for( i = 0, entry = entries; i < numEntries && i < maxEntries; i++, entry++ ) {
+		G_Printf( "%10llu %6.2f %9u %8u  %s %s\n", (unsigned long long)entry->usec, scriptTime ? 100.0 * entry->usec / scriptTime : 0.0,
+			entry->hits, entry->allocs, entry->section, entry->name );
+	}
+
+	G_Free( entries );
+}
+
+/*
+* G_asProfile_f
+*/
+void G_asProfile_f( void )
+{
+	const char *cmd;
+
+	if( trap_Cmd_Argc() < 2 ) {
+		G_Printf( "Usage: asprofile <start [lines per range]|stop|reset|dump [count]>\n" );
+		return;
+	}
+
+	if( !angelExport || !angelExport->asGetAllocationCount ) {
+		G_Printf( "Angelscript is not initialized\n" );
+		return;
+	}
+
+	cmd = trap_Cmd_Argv( 1 );
+	if( !Q_stricmp( cmd, "start" ) ) {
+		int numLines = trap_Cmd_Argc() > 2 ? atoi( trap_Cmd_Argv( 2 ) ) : G_ASPROF_DEFAULT_LINES;
+
+		if( asprof.active ) {
+			G_Printf( "Script profiling is already enabled\n" );
+			return;
+		}
+
+		if( !asprof.entries ) {
+			asprof.entries = ( g_asprofentry_t * )G_Malloc( G_ASPROF_MAX_ENTRIES * sizeof( *asprof.entries ) );
+		}
+
+		// line ranges of different sizes can't be mixed
+		numLines = max( numLines, 1 );
+		if( numLines != asprof.numLines ) {
+			asprof.numLines = numLines;
+			G_asProfileReset();
+		}
+
+		asprof.active = true;
+		asprof.startTime = trap_Microseconds();
+		G_Printf( "Script profiling enabled\n" );
+	}
+	else if( !Q_stricmp( cmd, "stop" ) ) {
+		if( !asprof.active ) {
+			return;
+		}
+
+		asprof.active = false;
+		asprof.totalTime += trap_Microseconds() - asprof.startTime;
+		G_Printf( "Script profiling disabled\n" );
+	}
+	else if( !Q_stricmp( cmd, "reset" ) ) {
+		if( asprof.entries ) {
+			G_asProfileReset();
+		}
+	}
+	else if( !Q_stricmp( cmd, "dump" ) ) {
+		G_asProfileDump( trap_Cmd_Argc() > 2 ? atoi( trap_Cmd_Argv( 2 ) ) : G_ASPROF_DEFAULT_DUMP );
+	}
+	else {
+		G_Printf( "Unknown asprofile option: %s\n", cmd );
+	}
+}
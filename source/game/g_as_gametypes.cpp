@@ -60,6 +60,9 @@ void GT_asShutdownScript( void )
 
 	GT_ResetScriptData();
 
+	G_asResetContextPool();
+	G_asProfileDetachModule();
+
 	GAME_AS_ENGINE()->DiscardModule( GAMETYPE_SCRIPTS_MODULE_NAME );
 }
 
@@ -72,13 +75,11 @@ void GT_asCallSpawn( void )
 	if( !level.gametype.spawnFunc )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.spawnFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.spawnFunc) );
+	if( !ctx )
 		return;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -92,13 +93,11 @@ void GT_asCallMatchStateStarted( void )
 	if( !level.gametype.matchStateStartedFunc )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.matchStateStartedFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.matchStateStartedFunc) );
+	if( !ctx )
 		return;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -113,16 +112,14 @@ bool GT_asCallMatchStateFinished( int incomingMatchState )
 	if( !level.gametype.matchStateFinishedFunc )
 		return true;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.matchStateFinishedFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.matchStateFinishedFunc) );
+	if( !ctx )
 		return true;
 
 	// Now we need to pass the parameters to the script function.
 	ctx->SetArgDWord( 0, incomingMatchState );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -141,13 +138,11 @@ void GT_asCallThinkRules( void )
 	if( !level.gametype.thinkRulesFunc )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.thinkRulesFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.thinkRulesFunc) );
+	if( !ctx )
 		return;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -161,10 +156,8 @@ void GT_asCallPlayerRespawn( edict_t *ent, int old_team, int new_team )
 	if( !level.gametype.playerRespawnFunc )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.playerRespawnFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.playerRespawnFunc) );
+	if( !ctx )
 		return;
 
 	// Now we need to pass the parameters to the script function.
@@ -172,7 +165,7 @@ void GT_asCallPlayerRespawn( edict_t *ent, int old_team, int new_team )
 	ctx->SetArgDWord( 1, old_team );
 	ctx->SetArgDWord( 2, new_team );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -193,10 +186,8 @@ void GT_asCallScoreEvent( gclient_t *client, const char *score_event, const char
 	if( !args )
 		args = "";
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.scoreEventFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.scoreEventFunc) );
+	if( !ctx )
 		return;
 
 	// Now we need to pass the parameters to the script function.
@@ -207,7 +198,7 @@ void GT_asCallScoreEvent( gclient_t *client, const char *score_event, const char
 	ctx->SetArgObject( 1, s1 );
 	ctx->SetArgObject( 2, s2 );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -228,16 +219,14 @@ void GT_asCallScoreboardMessage( unsigned int maxlen )
 	if( !level.gametype.scoreboardMessageFunc )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.scoreboardMessageFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.scoreboardMessageFunc) );
+	if( !ctx )
 		return;
 
 	// Now we need to pass the parameters to the script function.
 	ctx->SetArgDWord( 0, maxlen );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -258,16 +247,14 @@ edict_t *GT_asCallSelectSpawnPoint( edict_t *ent )
 	if( !level.gametype.selectSpawnPointFunc )
 		return SelectDeathmatchSpawnPoint( ent ); // should have a hardcoded backup
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.selectSpawnPointFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.selectSpawnPointFunc) );
+	if( !ctx )
 		return SelectDeathmatchSpawnPoint( ent );
 
 	// Now we need to pass the parameters to the script function.
 	ctx->SetArgObject( 0, ent );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -292,10 +279,8 @@ bool GT_asCallGameCommand( gclient_t *client, const char *cmd, const char *args,
 	if( !cmd || !cmd[0] )
 		return false;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.clientCommandFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.clientCommandFunc) );
+	if( !ctx )
 		return false;
 
 	// Now we need to pass the parameters to the script function.
@@ -307,7 +292,7 @@ bool GT_asCallGameCommand( gclient_t *client, const char *cmd, const char *args,
 	ctx->SetArgObject( 2, s2 );
 	ctx->SetArgDWord( 3, argc );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -327,13 +312,11 @@ void GT_asCallShutdown( void )
 	if( !level.gametype.shutdownFunc || !angelExport )
 		return;
 
-	ctx = angelExport->asAcquireContext( GAME_AS_ENGINE() );
-
-	error = ctx->Prepare( static_cast<asIScriptFunction *>(level.gametype.shutdownFunc) );
-	if( error < 0 ) 
+	ctx = G_asPrepareContext( static_cast<asIScriptFunction *>(level.gametype.shutdownFunc) );
+	if( !ctx )
 		return;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -473,7 +456,7 @@ static bool G_asInitializeGametypeScript( asIScriptModule *asModule )
 	if( error < 0 ) 
 		return false;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		return false;
 
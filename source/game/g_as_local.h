@@ -42,6 +42,13 @@ extern angelwrap_api_t *angelExport;
 asIScriptModule *G_LoadGameScript( const char *moduleName, const char *dir, const char *filename, const char *ext );
 bool G_ExecutionErrorReport( int error );
 
+asIScriptContext *G_asPrepareContext( asIScriptFunction *func );
+int G_asExecuteCall( asIScriptContext *ctx );
+void G_asResetContextPool( void );
+void G_asReleaseContextPool( void );
+void G_asProfileDetachModule( void );
+void G_asShutdownProfiler( void );
+
 typedef struct asEnumVal_s
 {
     const char * name;
@@ -96,7 +96,7 @@ static void G_asCallMapFunction( void *func )
 	if( error < 0 ) 
 		return;
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		G_asShutdownMapScript();
 }
@@ -157,7 +157,7 @@ const char *G_asCallMapGametype( void )
 
 	ctx->SetArgObject( 0, s );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 
@@ -220,5 +220,7 @@ void G_asShutdownMapScript( void )
 
 	G_ResetMapScriptData();
 
+	G_asProfileDetachModule();
+
 	GAME_AS_ENGINE()->DiscardModule( MAP_SCRIPTS_MODULE_NAME );
 }
@@ -3390,7 +3390,7 @@ bool G_asCallMapEntitySpawnScript( const char *classname, edict_t *ent )
 	// Now we need to pass the parameters to the script function.
 	asContext->SetArgObject( 0, ent );
 
-	error = asContext->Execute();
+	error = G_asExecuteCall( asContext );
 	if( G_ExecutionErrorReport( error ) )
 	{
 		GT_asShutdownScript();
@@ -3480,7 +3480,7 @@ void G_asCallMapEntityThink( edict_t *ent )
 	// Now we need to pass the parameters to the script function.
 	ctx->SetArgObject( 0, ent );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3516,7 +3516,7 @@ void G_asCallMapEntityTouch( edict_t *ent, edict_t *other, cplane_t *plane, int
 	ctx->SetArgObject( 2, &normal );
 	ctx->SetArgDWord( 3, surfFlags );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3541,7 +3541,7 @@ void G_asCallMapEntityUse( edict_t *ent, edict_t *other, edict_t *activator )
 	ctx->SetArgObject( 1, other );
 	ctx->SetArgObject( 2, activator );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3567,7 +3567,7 @@ void G_asCallMapEntityPain( edict_t *ent, edict_t *other, float kick, float dama
 	ctx->SetArgFloat( 2, kick );
 	ctx->SetArgFloat( 3, damage );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3592,7 +3592,7 @@ void G_asCallMapEntityDie( edict_t *ent, edict_t *inflicter, edict_t *attacker,
 	ctx->SetArgObject( 1, inflicter );
 	ctx->SetArgObject( 2, attacker );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3615,7 +3615,7 @@ void G_asCallMapEntityStop( edict_t *ent )
 	// Now we need to pass the parameters to the script function.
 	ctx->SetArgObject( 0, ent );
 
-	error = ctx->Execute();
+	error = G_asExecuteCall( ctx );
 	if( G_ExecutionErrorReport( error ) )
 		GT_asShutdownScript();
 }
@@ -3676,12 +3676,20 @@ static char *G_LoadScriptSection( const char *dir, const char *script, int secti
 
 /*
 * G_BuildGameScript
+*
+* Compiled scripts are cached by angelwrap, keyed by the sources of all sections
+* and the script API, so unchanged scripts are loaded without being compiled.
 */
 static asIScriptModule *G_BuildGameScript( const char *moduleName, const char *dir, const char *scriptName, const char *script )
 {
 	int error;
-	int numSections, sectionNum;
+	int numSections, numLoaded, sectionNum;
 	char *section;
+	char **sectionNames, **sections;
+	char cacheName[MAX_QPATH];
+	uint64_t cacheKey;
+	unsigned int loadTime;
+	bool cached;
 	asIScriptModule *asModule;
 	asIScriptEngine *asEngine;
 	
@@ -3693,6 +3701,8 @@ static asIScriptModule *G_BuildGameScript( const char *moduleName, const char *d
 
 	G_Printf( "* Initializing script '%s'\n", scriptName );
 
+	loadTime = trap_Milliseconds();
+
 	// count referenced script sections
 	for( numSections = 0; ( section = G_ListNameForPosition( script, numSections, SECTIONS_SEPARATOR ) ) != NULL; numSections++ );
 
@@ -3709,31 +3719,58 @@ static asIScriptModule *G_BuildGameScript( const char *moduleName, const char *d
 		return NULL;
 	}
 
-	for( sectionNum = 0; ( section = G_LoadScriptSection( dir, script, sectionNum ) ) != NULL; sectionNum++ ) {
-		const char *sectionName = G_ListNameForPosition( script, sectionNum, SECTIONS_SEPARATOR );
-		error = asModule->AddScriptSection( sectionName, section, strlen( section ) );
+	sectionNames = ( char ** )G_Malloc( numSections * sizeof( char * ) );
+	sections = ( char ** )G_Malloc( numSections * sizeof( char * ) );
+
+	for( numLoaded = 0; numLoaded < numSections; numLoaded++ ) {
+		sections[numLoaded] = G_LoadScriptSection( dir, script, numLoaded );
+		if( !sections[numLoaded] )
+			break;
+		sectionNames[numLoaded] = G_CopyString( G_ListNameForPosition( script, numLoaded, SECTIONS_SEPARATOR ) );
+	}
+
+	if( numLoaded != numSections ) {
+		G_Printf( S_COLOR_RED "* Error: couldn't load all script sections.\n" );
+		asModule = NULL;
+		goto done;
+	}
 
-		G_Free( section );
+	Q_snprintfz( cacheName, sizeof( cacheName ), "cache/%s.asb", scriptName );
+	cacheKey = angelExport->asByteCodeKey( asEngine, numSections, ( const char ** )sectionNames, ( const char ** )sections );
+
+	cached = angelExport->asLoadByteCode( asModule, cacheName, cacheKey );
+	if( !cached ) {
+		for( sectionNum = 0; sectionNum < numSections; sectionNum++ ) {
+			error = asModule->AddScriptSection( sectionNames[sectionNum], sections[sectionNum], strlen( sections[sectionNum] ) );
+			if( error ) {
+				G_Printf( S_COLOR_RED "* Failed to add the script section %s with error %i\n", sectionNames[sectionNum], error );
+				asModule = NULL;
+				goto done;
+			}
+		}
 
+		error = asModule->Build();
 		if( error ) {
-			G_Printf( S_COLOR_RED "* Failed to add the script section %s with error %i\n", sectionName, error );
-			asEngine->DiscardModule( moduleName );
-			return NULL;
+			G_Printf( S_COLOR_RED "* Failed to build the script '%s'\n", scriptName );
+			asModule = NULL;
+			goto done;
 		}
+
+		angelExport->asSaveByteCode( asModule, cacheName, cacheKey );
 	}
 
-	if( sectionNum != numSections ) {
-		G_Printf( S_COLOR_RED "* Error: couldn't load all script sections.\n" );
-		asEngine->DiscardModule( moduleName );
-		return NULL;
+	G_Printf( "* %s script '%s' in %u ms\n", cached ? "Loaded cached" : "Compiled", scriptName, trap_Milliseconds() - loadTime );
+
+done:
+	for( sectionNum = 0; sectionNum < numLoaded; sectionNum++ ) {
+		G_Free( sections[sectionNum] );
+		G_Free( sectionNames[sectionNum] );
 	}
+	G_Free( sections );
+	G_Free( sectionNames );
 
-	error = asModule->Build();
-	if( error ) {
-		G_Printf( S_COLOR_RED "* Failed to build the script '%s'\n", scriptName );
+	if( !asModule )
 		asEngine->DiscardModule( moduleName );
-		return NULL;
-	}
 
 	return asModule;
 }
@@ -3872,6 +3909,9 @@ void G_asInitGameModuleEngine( void )
 void G_asShutdownGameModuleEngine( void )
 {
 	if( game.asEngine != NULL ) {
+		G_asReleaseContextPool();
+		G_asShutdownProfiler();
+
 		if( angelExport )
 			angelExport->asReleaseEngine( static_cast<asIScriptEngine *>(game.asEngine) );
 		G_ResetGameModuleScriptData();
@@ -41,25 +41,49 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define	AREA_TRIGGERS	2
 
 
-#define AREA_GRID		128
-#define AREA_GRIDNODES	(AREA_GRID * AREA_GRID)
-#define AREA_GRIDMINSIZE 64.0f	// minimum areagrid cell size, smaller values 
+// The areagrid is a stack of 2D loose grids over the world. Cells of each level
+// are twice as large as the cells of the level below, down to a single cell
+// covering the whole grid. Every entity is linked into exactly one cell: the one
+// containing the center of its box, at the lowest level where the box is not
+// larger than a cell. Its box can then only reach into half of a cell around the
+// cell it is linked into, so queries pad their box by that much at each level.
+#define AREA_GRID_LEVELS	8
+#define AREA_GRID			( 1 << ( AREA_GRID_LEVELS - 1 ) )		// cells along each axis at the lowest level
+#define AREA_GRIDNODES		( ( AREA_GRID * AREA_GRID * 4 - 1 ) / 3 )	// cells of all levels
+#define AREA_GRIDMINSIZE	64.0f	// minimum areagrid cell size, smaller values 
 								// work better for lots of small objects, higher
 								// values for large objects
+#define AREA_OUTSIDE		AREA_GRIDNODES		// entities outside the grid or larger than it
 
 typedef struct
 {
-	link_t grid[AREA_GRIDNODES];
-	link_t outside;
+	int cells;			// along each axis
+	int firstnode;
+	float cellsize;
+	float scale;		// cells per unit
+	int numlinked;		// empty levels are skipped by queries
+} areagrid_level_t;
+
+// kept apart from edicts so that walking the lists and rejecting
+// by bounds doesn't touch the much larger edict structures
+typedef struct
+{
+	int node;			// -1 if not linked
+	int level;			// -1 if linked outside the grid
+	int prev, next;		// entity numbers in the list of the node, 0 ends the list
+	vec3_t absmin, absmax;
+} areagrid_ent_t;
+
+typedef struct
+{
+	int numlevels;
+	areagrid_level_t levels[AREA_GRID_LEVELS];
+	int nodes[AREA_GRIDNODES + 1];	// first entity number in the list of each node
+	areagrid_ent_t ents[MAX_EDICTS];
 	vec3_t bias;
-	vec3_t scale;
 	vec3_t mins;
 	vec3_t maxs;
-	vec3_t size;
-	int marknumber;
-	// since the areagrid can have multiple references to one entity,
-	// we should avoid extensive checking on entities already encountered
-	int entmarknumber[MAX_EDICTS];
+	float size;
 } areagrid_t;
 
 static areagrid_t g_areagrid;
@@ -245,91 +269,80 @@ static c4clipedict_t *GClip_GetClipEdictForDeltaTime( int entNum, int deltaTime
 	return clipent;
 }
 
-// ClearLink is used for new headnodes
-static void GClip_ClearLink( link_t *l )
-{
-	l->prev = l->next = l;
-	l->entNum = 0;
-}
-
-static void GClip_RemoveLink( link_t *l )
-{
-	l->next->prev = l->prev;
-	l->prev->next = l->next;
-	l->entNum = 0;
-}
-
-static void GClip_InsertLinkBefore( link_t *l, link_t *before, int entNum )
-{
-	l->next = before;
-	l->prev = before->prev;
-	l->prev->next = l;
-	l->next->prev = l;
-	l->entNum = entNum;
-}
-
 /*
 * GClip_Init_AreaGrid
 */
 static void GClip_Init_AreaGrid( areagrid_t *areagrid, const vec3_t world_mins, const vec3_t world_maxs )
 {
-	int i;
-
-	// the areagrid_marknumber is not allowed to be 0
-	if( areagrid->marknumber < 1 ) {
-		areagrid->marknumber = 1;
-	}
+	int i, cells, firstnode;
+	areagrid_level_t *level;
 
 	// choose either the world box size, or a larger box to ensure the grid isn't too fine
-	areagrid->size[0] = max( world_maxs[0] - world_mins[0], AREA_GRID * AREA_GRIDMINSIZE );
-	areagrid->size[1] = max( world_maxs[1] - world_mins[1], AREA_GRID * AREA_GRIDMINSIZE );
-	areagrid->size[2] = max( world_maxs[2] - world_mins[2], AREA_GRID * AREA_GRIDMINSIZE );
+	areagrid->size = max( world_maxs[0] - world_mins[0], world_maxs[1] - world_mins[1] );
+	areagrid->size = max( areagrid->size, AREA_GRIDMINSIZE );
 
 	// figure out the corners of such a box, centered at the center of the world box
-	areagrid->mins[0] = ( world_mins[0] + world_maxs[0] - areagrid->size[0] ) * 0.5f;
-	areagrid->mins[1] = ( world_mins[1] + world_maxs[1] - areagrid->size[1] ) * 0.5f;
-	areagrid->mins[2] = ( world_mins[2] + world_maxs[2] - areagrid->size[2] ) * 0.5f;
-	areagrid->maxs[0] = ( world_mins[0] + world_maxs[0] + areagrid->size[0] ) * 0.5f;
-	areagrid->maxs[1] = ( world_mins[1] + world_maxs[1] + areagrid->size[1] ) * 0.5f;
-	areagrid->maxs[2] = ( world_mins[2] + world_maxs[2] + areagrid->size[2] ) * 0.5f;
-
-	// now calculate the actual useful info from that
+	for( i = 0; i < 3; i++ ) {
+		areagrid->mins[i] = ( world_mins[i] + world_maxs[i] - areagrid->size ) * 0.5f;
+		areagrid->maxs[i] = ( world_mins[i] + world_maxs[i] + areagrid->size ) * 0.5f;
+	}
 	VectorNegate( areagrid->mins, areagrid->bias );
-	areagrid->scale[0] = AREA_GRID / areagrid->size[0];
-	areagrid->scale[1] = AREA_GRID / areagrid->size[1];
-	areagrid->scale[2] = AREA_GRID / areagrid->size[2];
 
-	GClip_ClearLink( &areagrid->outside );
-	for( i = 0; i < AREA_GRIDNODES; i++ ) {
-		GClip_ClearLink( &areagrid->grid[i] );
+	// small maps get fewer levels instead of cells smaller than the minimum size
+	for( cells = AREA_GRID; cells > 1 && areagrid->size / cells < AREA_GRIDMINSIZE; cells >>= 1 );
+
+	areagrid->numlevels = 0;
+	for( firstnode = 0; cells > 0; cells >>= 1 ) {
+		level = &areagrid->levels[areagrid->numlevels++];
+		level->cells = cells;
+		level->firstnode = firstnode;
+		level->cellsize = areagrid->size / cells;
+		level->scale = cells / areagrid->size;
+		level->numlinked = 0;
+		firstnode += cells * cells;
 	}
 
-	memset( areagrid->entmarknumber, 0, sizeof( areagrid->entmarknumber ) );
+	memset( areagrid->nodes, 0, sizeof( areagrid->nodes ) );
+	memset( areagrid->ents, 0, sizeof( areagrid->ents ) );
+	for( i = 0; i < MAX_EDICTS; i++ ) {
+		areagrid->ents[i].node = -1;
+	}
 
 	if( developer->integer ) {
-		Com_Printf( "areagrid settings: divisions %ix%ix1 : box %f %f %f "
-			": %f %f %f size %f %f %f grid %f %f %f (mingrid %f)\n", 
-			AREA_GRID, AREA_GRID, 
+		Com_Printf( "areagrid settings: %i levels, divisions %ix%i : box %f %f %f "
+			": %f %f %f size %f grid %f (mingrid %f)\n", 
+			areagrid->numlevels, areagrid->levels[0].cells, areagrid->levels[0].cells, 
 			areagrid->mins[0], areagrid->mins[1], areagrid->mins[2],
 			areagrid->maxs[0], areagrid->maxs[1], areagrid->maxs[2], 
-			areagrid->size[0], areagrid->size[1], areagrid->size[2], 
-			1.0f / areagrid->scale[0], 1.0f / areagrid->scale[1], 1.0f / areagrid->scale[2], 
-			AREA_GRIDMINSIZE );
+			areagrid->size, areagrid->levels[0].cellsize, AREA_GRIDMINSIZE );
 	}
 }
 
 /*
 * GClip_UnlinkEntity_AreaGrid
 */
-static void GClip_UnlinkEntity_AreaGrid( edict_t *ent )
+static void GClip_UnlinkEntity_AreaGrid( areagrid_t *areagrid, edict_t *ent )
 {
-	for( int i = 0; i < MAX_ENT_AREAS; i++ ) {
-		if( !ent->areagrid[i].prev ) {
-			break;
-		}
-		GClip_RemoveLink( &ent->areagrid[i] );
-		ent->areagrid[i].prev = ent->areagrid[i].next = NULL;
+	areagrid_ent_t *gent = &areagrid->ents[NUM_FOR_EDICT( ent )];
+
+	if( gent->node < 0 ) {
+		return;
+	}
+
+	if( gent->prev ) {
+		areagrid->ents[gent->prev].next = gent->next;
+	} else {
+		areagrid->nodes[gent->node] = gent->next;
+	}
+	if( gent->next ) {
+		areagrid->ents[gent->next].prev = gent->prev;
 	}
+	if( gent->level >= 0 ) {
+		areagrid->levels[gent->level].numlinked--;
+	}
+
+	gent->node = -1;
+	gent->prev = gent->next = 0;
 }
 
 /*
@@ -337,8 +350,10 @@ static void GClip_UnlinkEntity_AreaGrid( edict_t *ent )
 */
 static void GClip_LinkEntity_AreaGrid( areagrid_t *areagrid, edict_t *ent )
 {
-	link_t *grid;
-	int igrid[3], igridmins[3], igridmaxs[3], gridnum, entitynumber;
+	int i, entitynumber, node, cell[2];
+	float extent;
+	areagrid_ent_t *gent;
+	areagrid_level_t *level;
 	
 	entitynumber = NUM_FOR_EDICT( ent );
 	if( entitynumber <= 0 || entitynumber >= game.maxentities || EDICT_NUM( entitynumber ) != ent )
@@ -349,138 +364,130 @@ static void GClip_LinkEntity_AreaGrid( areagrid_t *areagrid, edict_t *ent )
 		return;
 	}
 
-	igridmins[0] = (int) floor( (ent->r.absmin[0] + areagrid->bias[0]) * areagrid->scale[0] );
-	igridmins[1] = (int) floor( (ent->r.absmin[1] + areagrid->bias[1]) * areagrid->scale[1] );
-	//igridmins[2] = (int) floor( (ent->r.absmin[2] + areagrid->bias[2]) * areagrid->scale[2] );
-	igridmaxs[0] = (int) floor( (ent->r.absmax[0] + areagrid->bias[0]) * areagrid->scale[0] ) + 1;
-	igridmaxs[1] = (int) floor( (ent->r.absmax[1] + areagrid->bias[1]) * areagrid->scale[1] ) + 1;
-	//igridmaxs[2] = (int) floor( (ent->r.absmax[2] + areagrid->bias[2]) * areagrid->scale[2] ) + 1;
-	if( igridmins[0] < 0 || igridmaxs[0] > AREA_GRID 
-		|| igridmins[1] < 0 || igridmaxs[1] > AREA_GRID 
-		|| ((igridmaxs[0] - igridmins[0]) * (igridmaxs[1] - igridmins[1])) > MAX_ENT_AREAS )
-	{
-		// wow, something outside the grid, store it as such
-		GClip_InsertLinkBefore( &ent->areagrid[0], &areagrid->outside, entitynumber );
-		return;
+	gent = &areagrid->ents[entitynumber];
+	VectorCopy( ent->r.absmin, gent->absmin );
+	VectorCopy( ent->r.absmax, gent->absmax );
+
+	// find the lowest level with cells at least as large as the entity
+	extent = max( ent->r.absmax[0] - ent->r.absmin[0], ent->r.absmax[1] - ent->r.absmin[1] );
+	for( i = 0; i < areagrid->numlevels; i++ ) {
+		if( extent <= areagrid->levels[i].cellsize ) {
+			break;
+		}
+	}
+
+	// wow, something outside the grid or too big for it, store it as such
+	node = AREA_OUTSIDE;
+	gent->level = -1;
+	if( i < areagrid->numlevels ) {
+		level = &areagrid->levels[i];
+		cell[0] = (int) floor( ( ( ent->r.absmin[0] + ent->r.absmax[0] ) * 0.5f + areagrid->bias[0] ) * level->scale );
+		cell[1] = (int) floor( ( ( ent->r.absmin[1] + ent->r.absmax[1] ) * 0.5f + areagrid->bias[1] ) * level->scale );
+		if( cell[0] >= 0 && cell[0] < level->cells && cell[1] >= 0 && cell[1] < level->cells ) {
+			node = level->firstnode + cell[1] * level->cells + cell[0];
+			gent->level = i;
+			level->numlinked++;
+		}
 	}
 
-	gridnum = 0;
-	for( igrid[1] = igridmins[1]; igrid[1] < igridmaxs[1]; igrid[1]++ ) {
-		grid = areagrid->grid + igrid[1] * AREA_GRID + igridmins[0];
-		for( igrid[0] = igridmins[0]; igrid[0] < igridmaxs[0]; igrid[0]++, grid++, gridnum++ )
-			GClip_InsertLinkBefore( &ent->areagrid[gridnum], grid, entitynumber );
+	gent->node = node;
+	gent->prev = 0;
+	gent->next = areagrid->nodes[node];
+	if( gent->next ) {
+		areagrid->ents[gent->next].prev = entitynumber;
 	}
+	areagrid->nodes[node] = entitynumber;
 }
 
 /*
-* GClip_EntitiesInBox_AreaGrid
+* GClip_EntitiesInNode_AreaGrid
 */
-static int GClip_EntitiesInBox_AreaGrid( areagrid_t *areagrid, const vec3_t mins, const vec3_t maxs, 
-	int *list, int maxcount, int areatype, int timeDelta )
+static int GClip_EntitiesInNode_AreaGrid( areagrid_t *areagrid, int node, const vec3_t mins, const vec3_t maxs, 
+	int *list, int maxcount, int numlist, int areatype, int timeDelta )
 {
-	int numlist;
-	link_t *grid;
-	link_t *l;
-	c4clipedict_t *clipEnt;
-	vec3_t paddedmins, paddedmaxs;
-	int igrid[3], igridmins[3], igridmaxs[3];
-
-	// LordHavoc: discovered this actually causes its own bugs (dm6 teleporters 
-	// being too close to info_teleport_destination)
-	//VectorSet( paddedmins, mins[0] - 1.0f, mins[1] - 1.0f, mins[2] - 1.0f );
-	//VectorSet( paddedmaxs, maxs[0] + 1.0f, maxs[1] + 1.0f, maxs[2] + 1.0f );
-	VectorCopy( mins, paddedmins );
-	VectorCopy( maxs, paddedmaxs );
-
-	// FIXME: if areagrid_marknumber wraps, all entities need their
-	// ent->priv.server->areagridmarknumber reset
-	areagrid->marknumber++;
-
-	igridmins[0] = (int) floor( (paddedmins[0] + areagrid->bias[0]) * areagrid->scale[0] );
-	igridmins[1] = (int) floor( (paddedmins[1] + areagrid->bias[1]) * areagrid->scale[1] );
-	//igridmins[2] = (int) ( (paddedmins[2] + areagrid->bias[2]) * areagrid->scale[2] );
-	igridmaxs[0] = (int) floor( (paddedmaxs[0] + areagrid->bias[0]) * areagrid->scale[0] ) + 1;
-	igridmaxs[1] = (int) floor( (paddedmaxs[1] + areagrid->bias[1]) * areagrid->scale[1] ) + 1;
-	//igridmaxs[2] = (int) ( (paddedmaxs[2] + areagrid->bias[2]) * areagrid->scale[2] ) + 1;
-	igridmins[0] = max( 0, igridmins[0] );
-	igridmins[1] = max( 0, igridmins[1] );
-	//igridmins[2] = max( 0, igridmins[2] );
-	igridmaxs[0] = min( AREA_GRID, igridmaxs[0] );
-	igridmaxs[1] = min( AREA_GRID, igridmaxs[1] );
-	//igridmaxs[2] = min( AREA_GRID, igridmaxs[2] );
-
-	// paranoid debugging
-	//VectorSet( igridmins, 0, 0, 0 );VectorSet( igridmaxs, AREA_GRID, AREA_GRID, AREA_GRID );
-
-	numlist = 0;
-
-	// add entities not linked into areagrid because they are too big or
-	// outside the grid bounds
-	if( areagrid->outside.next )
-	{
-		grid = &areagrid->outside;
-		for( l = grid->next; l != grid; l = l->next ) {
-			clipEnt = GClip_GetClipEdictForDeltaTime( l->entNum, timeDelta );
-
-			if( areagrid->entmarknumber[l->entNum] == areagrid->marknumber ) {
+	int entNum;
+	const areagrid_ent_t *gent;
+	const entity_shared_t *r;
+	bool current = timeDelta >= 0 || !g_antilag->integer;
+
+	for( entNum = areagrid->nodes[node]; entNum; entNum = gent->next ) {
+		gent = &areagrid->ents[entNum];
+
+		if( current ) {
+			// the copied bounds are the same as the edict ones, absmin 
+			// and absmax are only ever set before linking
+			if( !BoundsIntersect( mins, maxs, gent->absmin, gent->absmax ) ) {
 				continue;
 			}
-			areagrid->entmarknumber[l->entNum] = areagrid->marknumber;
+			r = &game.edicts[entNum].r;
+		} else {
+			r = &GClip_GetClipEdictForDeltaTime( entNum, timeDelta )->r;
+		}
 
-			if( !clipEnt->r.inuse ) {
-				continue; // deactivated
-			}
-			if( areatype == AREA_TRIGGERS && clipEnt->r.solid != SOLID_TRIGGER ) {
-				continue;
-			}
-			if( areatype == AREA_SOLID && 
-				( clipEnt->r.solid == SOLID_TRIGGER || clipEnt->r.solid == SOLID_NOT ) ) {
-				continue;
-			}
+		if( !r->inuse ) {
+			continue; // deactivated
+		}
+		if( areatype == AREA_TRIGGERS && r->solid != SOLID_TRIGGER ) {
+			continue;
+		}
+		if( areatype == AREA_SOLID && 
+			( r->solid == SOLID_TRIGGER || r->solid == SOLID_NOT ) ) {
+			continue;
+		}
 
-			if( BoundsIntersect( paddedmins, paddedmaxs, clipEnt->r.absmin, clipEnt->r.absmax )) {
-				if( numlist < maxcount ) {
-					list[numlist] = l->entNum;
-				}
-				numlist++;
+		if( current || BoundsIntersect( mins, maxs, r->absmin, r->absmax ) ) {
+			if( numlist < maxcount ) {
+				list[numlist] = entNum;
 			}
+			numlist++;
 		}
 	}
 
-	// add grid linked entities
-	for( igrid[1] = igridmins[1]; igrid[1] < igridmaxs[1]; igrid[1]++ ) {
-		grid = areagrid->grid + igrid[1] * AREA_GRID + igridmins[0];
+	return numlist;
+}
 
-		for( igrid[0] = igridmins[0]; igrid[0] < igridmaxs[0]; igrid[0]++, grid++ ) {
-			if( !grid->next ) {
-				continue;
-			}
+/*
+* GClip_EntitiesInBox_AreaGrid
+*/
+static int GClip_EntitiesInBox_AreaGrid( areagrid_t *areagrid, const vec3_t mins, const vec3_t maxs, 
+	int *list, int maxcount, int areatype, int timeDelta )
+{
+	int i, numlist, node;
+	float pad;
+	const areagrid_level_t *level;
+	int igrid[2], igridmins[2], igridmaxs[2];
 
-			for( l = grid->next; l != grid; l = l->next ) {
-				clipEnt = GClip_GetClipEdictForDeltaTime( l->entNum, timeDelta );
+	// add entities not linked into areagrid because they are too big or
+	// outside the grid bounds
+	numlist = GClip_EntitiesInNode_AreaGrid( areagrid, AREA_OUTSIDE, mins, maxs, 
+		list, maxcount, 0, areatype, timeDelta );
 
-				if( areagrid->entmarknumber[l->entNum] == areagrid->marknumber ) {
-					continue;
-				}
-				areagrid->entmarknumber[l->entNum] = areagrid->marknumber;
+	// add grid linked entities
+	for( i = 0, level = areagrid->levels; i < areagrid->numlevels; i++, level++ ) {
+		if( !level->numlinked ) {
+			continue;
+		}
 
-				if( !clipEnt->r.inuse ) {
-					continue; // deactivated
-				}
-				if( areatype == AREA_TRIGGERS && clipEnt->r.solid != SOLID_TRIGGER ) {
+		// boxes of linked entities reach up to half of a cell out of their cell,
+		// and a unit more is added for rounding errors
+		pad = level->cellsize * 0.5f + 1.0f;
+		igridmins[0] = (int) floor( ( mins[0] - pad + areagrid->bias[0] ) * level->scale );
+		igridmins[1] = (int) floor( ( mins[1] - pad + areagrid->bias[1] ) * level->scale );
+		igridmaxs[0] = (int) floor( ( maxs[0] + pad + areagrid->bias[0] ) * level->scale ) + 1;
+		igridmaxs[1] = (int) floor( ( maxs[1] + pad + areagrid->bias[1] ) * level->scale ) + 1;
+		igridmins[0] = max( 0, igridmins[0] );
+		igridmins[1] = max( 0, igridmins[1] );
+		igridmaxs[0] = min( level->cells, igridmaxs[0] );
+		igridmaxs[1] = min( level->cells, igridmaxs[1] );
+
+		for( igrid[1] = igridmins[1]; igrid[1] < igridmaxs[1]; igrid[1]++ ) {
+			node = level->firstnode + igrid[1] * level->cells + igridmins[0];
+			for( igrid[0] = igridmins[0]; igrid[0] < igridmaxs[0]; igrid[0]++, node++ ) {
+				if( !areagrid->nodes[node] ) {
 					continue;
 				}
-				if( areatype == AREA_SOLID && 
-					( clipEnt->r.solid == SOLID_TRIGGER || clipEnt->r.solid == SOLID_NOT ) ) {
-					continue;
-				}
-
-				if( BoundsIntersect( paddedmins, paddedmaxs, clipEnt->r.absmin, clipEnt->r.absmax )) {
-					if( numlist < maxcount ) {
-						list[numlist] = l->entNum;
-					}
-					numlist++;
-				}
+				numlist = GClip_EntitiesInNode_AreaGrid( areagrid, node, mins, maxs, 
+					list, maxcount, numlist, areatype, timeDelta );
 			}
 		}
 	}
@@ -513,7 +520,7 @@ void GClip_UnlinkEntity( edict_t *ent )
 {
 	if( !ent->linked )
 		return; // not linked in anywhere
-	GClip_UnlinkEntity_AreaGrid( ent );
+	GClip_UnlinkEntity_AreaGrid( &g_areagrid, ent );
 	ent->linked = false;
 }
 
@@ -1236,3 +1243,210 @@ entity_state_t *G_GetEntityStateForDeltaTime( int entNum, int deltaTime )
 	return &clipEnt->s;
 }
 
+
+//===============================================================================
+//
+//AREAGRID BENCHMARK
+//
+//===============================================================================
+
+#define AREAGRIDBENCH_WORKLOADS	3
+
+static const char *areagridbench_names[AREAGRIDBENCH_WORKLOADS] =
+{
+	"projectile", "splash", "triggers"
+};
+
+/*
+* GClip_AreaGridBench_Rand
+*/
+static float GClip_AreaGridBench_Rand( unsigned *seed, float min, float max )
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return min + ( max - min ) * ( ( *seed >> 8 ) / (float)( 1 << 24 ) );
+}
+
+/*
+* GClip_AreaGridBench_Query
+*
+* Builds the box of a query of the given workload at a random point
+*/
+static int GClip_AreaGridBench_Query( int workload, unsigned *seed, vec3_t mins, vec3_t maxs )
+{
+	int i;
+	vec3_t org, move;
+	float rad;
+
+	for( i = 0; i < 3; i++ )
+		org[i] = GClip_AreaGridBench_Rand( seed, g_areagrid.mins[i], g_areagrid.maxs[i] );
+
+	switch( workload )
+	{
+	case 0:
+		// a rocket's move in one frame, the bounds GClip_Trace looks up
+		for( i = 0; i < 3; i++ )
+			move[i] = GClip_AreaGridBench_Rand( seed, -20.0f, 20.0f );
+		for( i = 0; i < 3; i++ )
+		{
+			mins[i] = min( org[i], org[i] + move[i] ) - 1;
+			maxs[i] = max( org[i], org[i] + move[i] ) + 1;
+		}
+		return AREA_SOLID;
+	case 1:
+		// the box GClip_FindInRadius looks up for a rocket splash
+		rad = GClip_AreaGridBench_Rand( seed, 100.0f, 250.0f ) * 1.42f + 1;
+		VectorSet( mins, org[0] - rad, org[1] - rad, org[2] - rad );
+		VectorSet( maxs, org[0] + rad, org[1] + rad, org[2] + rad );
+		return AREA_ALL;
+	default:
+		// a player touching triggers
+		VectorSet( mins, org[0] - 17, org[1] - 17, org[2] - 25 );
+		VectorSet( maxs, org[0] + 17, org[1] + 17, org[2] + 41 );
+		return AREA_TRIGGERS;
+	}
+}
+
+/*
+* GClip_AreaGridBench_Linear
+*
+* The same as GClip_AreaEdicts for the current time, checking every entity
+*/
+static int GClip_AreaGridBench_Linear( const vec3_t mins, const vec3_t maxs, int *list, int maxcount, int areatype )
+{
+	int i, num;
+	const edict_t *ent;
+
+	for( i = 1, num = 0; i < game.numentities; i++ )
+	{
+		ent = game.edicts + i;
+		if( !ent->r.inuse || !ent->linked )
+			continue;
+		if( areatype == AREA_TRIGGERS && ent->r.solid != SOLID_TRIGGER )
+			continue;
+		if( areatype == AREA_SOLID && ( ent->r.solid == SOLID_TRIGGER || ent->r.solid == SOLID_NOT ) )
+			continue;
+		if( !BoundsIntersect( mins, maxs, ent->r.absmin, ent->r.absmax ) )
+			continue;
+		if( num < maxcount )
+			list[num] = i;
+		num++;
+	}
+
+	return min( num, maxcount );
+}
+
+/*
+* GClip_AreaGridBench_SortCmp
+*/
+static int GClip_AreaGridBench_SortCmp( const void *a, const void *b )
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*
+* GClip_AreaGridBenchmark_f
+*
+* Times entity lookups of projectile moves, splash damage and trigger touches
+* against the areagrid and against checking every entity, with extra entities
+* of player, projectile, item and mover sizes spread over the current map
+*/
+void GClip_AreaGridBenchmark_f( void )
+{
+	int i, j, pass, workload, areatype, numqueries, numents, num, found, mismatches;
+	unsigned seed;
+	uint64_t time;
+	vec3_t mins, maxs;
+	edict_t *ent, **ents;
+	int list[MAX_EDICTS], check[MAX_EDICTS];
+
+	numqueries = trap_Cmd_Argc() > 1 ? atoi( trap_Cmd_Argv( 1 ) ) : 100000;
+	numents = trap_Cmd_Argc() > 2 ? atoi( trap_Cmd_Argv( 2 ) ) : 512;
+	clamp( numqueries, 1, 10000000 );
+	clamp( numents, 0, game.maxentities - game.numentities - 64 );
+
+	ents = (edict_t **)G_Malloc( max( numents, 1 ) * sizeof( *ents ) );
+
+	seed = 0x2F6E2B1;
+	for( i = 0; i < numents; i++ )
+	{
+		ent = ents[i] = G_Spawn();
+		ent->classname = "areagridbench";
+		for( j = 0; j < 3; j++ )
+			ent->s.origin[j] = GClip_AreaGridBench_Rand( &seed, g_areagrid.mins[j], g_areagrid.maxs[j] );
+
+		switch( i & 7 )
+		{
+		case 0: case 1: case 2:
+			ent->r.solid = SOLID_YES;
+			VectorSet( ent->r.mins, -16, -16, -24 );
+			VectorSet( ent->r.maxs, 16, 16, 40 );
+			break;
+		case 3: case 4:
+			ent->r.solid = SOLID_YES;
+			VectorSet( ent->r.mins, -2, -2, -2 );
+			VectorSet( ent->r.maxs, 2, 2, 2 );
+			break;
+		case 5: case 6:
+			ent->r.solid = SOLID_TRIGGER;
+			VectorSet( ent->r.mins, -16, -16, -16 );
+			VectorSet( ent->r.maxs, 16, 16, 40 );
+			break;
+		default:
+			ent->r.solid = SOLID_YES;
+			VectorSet( ent->r.mins, -256, -256, -16 );
+			VectorSet( ent->r.maxs, 256, 256, 16 );
+			break;
+		}
+		GClip_LinkEntity( ent );
+	}
+
+	G_Printf( "%i queries, %i entities of which %i added, %i levels of %.0f units and up\n",
+		numqueries, game.numentities, numents, g_areagrid.numlevels, g_areagrid.levels[0].cellsize );
+
+	for( workload = 0; workload < AREAGRIDBENCH_WORKLOADS; workload++ )
+	{
+		uint64_t times[2];
+
+		// the same queries against the grid and against every entity
+		for( pass = 0; pass < 2; pass++ )
+		{
+			seed = 0x1B873593 + workload;
+			found = 0;
+			time = trap_Microseconds();
+			for( i = 0; i < numqueries; i++ )
+			{
+				areatype = GClip_AreaGridBench_Query( workload, &seed, mins, maxs );
+				if( pass )
+					found += GClip_AreaGridBench_Linear( mins, maxs, list, MAX_EDICTS, areatype );
+				else
+					found += GClip_AreaEdicts( mins, maxs, list, MAX_EDICTS, areatype, 0 );
+			}
+			times[pass] = trap_Microseconds() - time;
+		}
+
+		// and check that both find the same entities
+		seed = 0x1B873593 + workload;
+		mismatches = 0;
+		for( i = 0; i < min( numqueries, 10000 ); i++ )
+		{
+			areatype = GClip_AreaGridBench_Query( workload, &seed, mins, maxs );
+			num = GClip_AreaEdicts( mins, maxs, list, MAX_EDICTS, areatype, 0 );
+			if( GClip_AreaGridBench_Linear( mins, maxs, check, MAX_EDICTS, areatype ) != num )
+			{
+				mismatches++;
+				continue;
+			}
+			qsort( list, num, sizeof( int ), GClip_AreaGridBench_SortCmp );
+			if( memcmp( list, check, num * sizeof( int ) ) )
+				mismatches++;
+		}
+
+		G_Printf( "%-10s: areagrid %7.1f ns, all entities %7.1f ns per query, %.1f found, %i mismatches\n",
+			areagridbench_names[workload], times[0] * 1000.0 / numqueries, times[1] * 1000.0 / numqueries,
+			(double)found / numqueries, mismatches );
+	}
+
+	for( i = 0; i < numents; i++ )
+		G_FreeEdict( ents[i] );
+	G_Free( ents );
+}
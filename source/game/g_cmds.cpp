@@ -359,6 +359,17 @@ static void Cmd_Score_f( edict_t *ent )
 	ent->r.client->level.showscores = newvalue;
 }
 
+/*
+* Cmd_ScoreboardRequest_f
+*
+* The client couldn't apply a scoreboard delta, send it a full one next time.
+*/
+static void Cmd_ScoreboardRequest_f( edict_t *ent )
+{
+	ent->r.client->level.scoreboard_seq = 0;
+	ent->r.client->level.scoreboard_time = 0;
+}
+
 /*
 * Cmd_CvarInfo_f - Contains a cvar name and string provided by the client
 */
@@ -1344,6 +1355,7 @@ void G_InitGameCommands( void )
 	G_AddCommand( "say", Cmd_SayCmd_f );
 	G_AddCommand( "say_team", Cmd_SayTeam_f );
 	G_AddCommand( "svscore", Cmd_Score_f );
+	G_AddCommand( "scbreq", Cmd_ScoreboardRequest_f );
 	G_AddCommand( "god", Cmd_God_f );
 	G_AddCommand( "noclip", Cmd_Noclip_f );
 	G_AddCommand( "use", Cmd_Use_f );
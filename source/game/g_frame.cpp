@@ -809,12 +809,20 @@ void G_RunFrame( unsigned int msec, unsigned int serverTime )
 	G_SpawnQueue_Think();
 
 	// run the world
+	trap_Prof_Begin( "g_mapscript" );
 	G_asCallMapPreThink();
+	trap_Prof_End();
 	AI_CommonFrame();
+	trap_Prof_Begin( "g_clients" );
 	G_RunClients();
+	trap_Prof_End();
+	trap_Prof_Begin( "g_entities" );
 	G_RunEntities();
+	trap_Prof_End();
 	G_RunGametype();
+	trap_Prof_Begin( "g_mapscript" );
 	G_asCallMapPostThink();
+	trap_Prof_End();
 	GClip_BackUpCollisionFrame();
 
 	G_LevelGarbageCollect();
@@ -1800,10 +1800,12 @@ void G_RunGametype( void )
 	G_UpdateScoreBoardMessages();
 
 	//check gametype specific rules
+	trap_Prof_Begin( "gt_thinkrules" );
 	if( game.asEngine != NULL )
 		GT_asCallThinkRules();
 	else
 		G_Gametype_GENERIC_ThinkRules();
+	trap_Prof_End();
 
 	if( G_EachNewSecond() )
 	{
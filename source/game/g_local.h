@@ -245,6 +245,8 @@ typedef struct
 	float gravity;
 
 	int colorCorrection;
+
+	unsigned int scoreboard_seq;	// last scoreboard sequence number given out to any client
 } level_locals_t;
 
 
@@ -516,6 +518,7 @@ void G_asInitGameModuleEngine( void );
 void G_asShutdownGameModuleEngine( void );
 void G_asGarbageCollect( bool force );
 void G_asDumpAPI_f( void );
+void G_asProfile_f( void );
 
 #define world	( (edict_t *)game.edicts )
 
@@ -730,14 +733,6 @@ void SP_trigger_gravity( edict_t *ent );
 //
 // g_clip.c
 //
-#define MAX_ENT_AREAS 16
-
-typedef struct link_s
-{
-	struct link_s *prev, *next;
-	int entNum;
-} link_t;
-
 int	G_PointContents( vec3_t p );
 void G_Trace( trace_t *tr, vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, edict_t *passedict, int contentmask );
 int G_PointContents4D( vec3_t p, int timeDelta );
@@ -754,6 +749,7 @@ void GClip_TouchTriggers( edict_t *ent );
 void G_PMoveTouchTriggers( pmove_t *pm, vec3_t previous_origin );
 entity_state_t *G_GetEntityStateForDeltaTime( int entNum, int deltaTime );
 int GClip_FindInRadius( vec3_t org, float rad, int *list, int maxcount );
+void GClip_AreaGridBenchmark_f( void );
 
 //
 // g_combat.c
@@ -899,6 +895,11 @@ void G_RemoveCommands( void );
 void SV_ReadIPList( void );
 void SV_WriteIPList( void );
 
+//
+// g_pmovetest.c
+//
+void G_PmoveTest_f( void );
+
 //
 // p_view.c
 //
@@ -911,9 +912,8 @@ void G_ClientDamageFeedback( edict_t *ent );
 //
 
 //scoreboards string
-extern char scoreboardString[MAX_STRING_CHARS];
+extern char scoreboardString[SCOREBOARD_MSG_MAXSIZE];
 extern const unsigned int scoreboardInterval;
-#define SCOREBOARD_MSG_MAXSIZE ( MAX_STRING_CHARS-8 ) //I know, I know, doesn't make sense having a bigger string than the maxsize value
 
 void MoveClientToIntermission( edict_t *client );
 void G_SetClientStats( edict_t *ent );
@@ -1135,6 +1135,8 @@ typedef struct
 	score_stats_t stats;
 	bool showscores;
 	unsigned int scoreboard_time;	// when scoreboard was last sent
+	unsigned int scoreboard_seq;	// sequence number of the last scoreboard sent, 0 if there's none
+	char scoreboard_baseline[SCOREBOARD_MSG_MAXSIZE];	// the last scoreboard sent, deltas are built from it
 	bool showPLinks;			// bot debug
 
 	// flood protection
@@ -1297,9 +1299,6 @@ struct edict_s
 
 	int linkcount;
 
-	// physics grid areas this edict is linked into
-	link_t areagrid[MAX_ENT_AREAS];
-
 	entity_state_t olds; // state in the last sent frame snap
 
 	int movetype;
@@ -524,7 +524,7 @@ static bool SV_Push( edict_t *pusher, vec3_t move, vec3_t amove )
 			|| check->movetype == MOVETYPE_NOCLIP )
 			continue;
 
-		if( !check->areagrid[0].prev )
+		if( !check->linked )
 			continue; // not linked in anywhere
 
 		// if the entity is standing on the pusher, it will definitely be moved
@@ -0,0 +1,512 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "g_local.h"
+
+#ifndef PUBLIC_BUILD
+
+//==============================================================
+//
+//PMOVE REGRESSION TEST
+//
+//Replays fixed usercmd streams through Pmove_Ext in a small room made of axial
+//brushes, independent of the loaded map, and hashes the player state, the
+//pmove results and the predicted events of every frame. The expected hashes
+//were recorded with the player movement code as it was before Pmove_Ext, so
+//any change to the movement physics shows up as a mismatch.
+//
+//==============================================================
+
+#define PMOVETEST_RANDOM_FRAMES 1500
+#define PMOVETEST_CLIP_EPSILON	0.125f   // same as SURFACE_CLIP_EPSILON in the collision code
+
+typedef struct
+{
+	vec3_t mins, maxs;
+	int contents;
+	int surfFlags;
+} pmovetest_brush_t;
+
+typedef struct
+{
+	int frames;
+	int msec;
+	int buttons;
+	float pitch, yaw, yawspeed;   // degrees, yawspeed is added each frame
+	float forwardmove, sidemove, upmove;
+} pmovetest_segment_t;
+
+typedef struct
+{
+	const char *name;
+	int pm_type;
+	unsigned int seed;            // 0 for the recorded route, otherwise random commands
+	unsigned int hash;
+} pmovetest_stream_t;
+
+// a 800x800x300 room with a step, a block too high to step on, a ladder and a pool
+static const pmovetest_brush_t pmovetest_brushes[] =
+{
+	{ { -464, -464, -64 }, { 464, 464, 0 }, CONTENTS_SOLID, 0 },
+	{ { -464, -464, 300 }, { 464, 464, 364 }, CONTENTS_SOLID, 0 },
+	{ { -464, -464, 0 }, { -400, 464, 300 }, CONTENTS_SOLID, 0 },
+	{ { 400, -464, 0 }, { 464, 464, 300 }, CONTENTS_SOLID, 0 },
+	{ { -400, -464, 0 }, { 400, -400, 300 }, CONTENTS_SOLID, 0 },
+	{ { -400, 400, 0 }, { 400, 464, 300 }, CONTENTS_SOLID, 0 },
+	{ { -100, 100, 0 }, { 100, 200, 16 }, CONTENTS_SOLID, 0 },
+	{ { -300, -300, 0 }, { -200, -200, 40 }, CONTENTS_SOLID, 0 },
+	{ { -64, 392, 0 }, { 64, 400, 300 }, CONTENTS_SOLID, SURF_LADDER },
+	{ { 200, -400, 0 }, { 400, 400, 48 }, CONTENTS_WATER, 0 },
+};
+
+// a scripted route through the room: walk over the step, climb the ladder,
+// bunny hop into the pool and swim out, dash, walljump off the block, crouch slide
+// and strafe in circles, with a few odd frame times in between
+static const pmovetest_segment_t pmovetest_route[] =
+{
+	{ 40, 16, 0, 0, 90, 0, 0, 0, 0 },
+	{ 130, 16, 0, 0, 90, 0, 1, 0, 0 },
+	{ 70, 16, 0, -60, 90, 0, 1, 0, 0 },
+	{ 12, 16, 0, 0, 90, 0, -1, 0, 1 },
+	{ 30, 16, 0, 0, 90, 0, 0, 0, 0 },
+	{ 90, 8, 0, 0, -45, 0, 1, 0, 1 },
+	{ 120, 16, 0, 0, 0, 0, 1, 0.5f, 1 },
+	{ 40, 16, 0, 0, 0, 0, 0, 0, 1 },
+	{ 40, 16, 0, 50, 0, 0, 1, 0, 0 },
+	{ 50, 16, 0, -30, 180, 0, 1, 0, 1 },
+	{ 4, 16, BUTTON_SPECIAL, 0, 180, 0, 1, 0, 0 },
+	{ 30, 16, 0, 0, 180, 0, 1, 0, 0 },
+	{ 4, 16, BUTTON_SPECIAL, 0, 180, 0, 0, -1, 0 },
+	{ 60, 16, 0, 0, 225, 0, 1, 0, 0 },
+	{ 10, 16, 0, 0, 225, 0, 1, 0, 1 },
+	{ 8, 16, BUTTON_SPECIAL, 0, 225, 0, 1, 0, 0 },
+	{ 40, 16, 0, 0, 45, 0, 1, 0, 0 },
+	{ 6, 16, 0, 0, 45, 0, 1, 0, 1 },
+	{ 50, 16, 0, 0, 45, 0, 1, 0, -1 },
+	{ 25, 16, 0, 0, 45, 0, 0, 0, -1 },
+	{ 120, 16, 0, 0, 0, 3, 1, 1, 0 },
+	{ 120, 11, 0, 0, 0, -4, 0.5f, -1, 1 },
+	{ 30, 33, 0, 0, 300, 0, 1, 0, 0 },
+	{ 60, 1, 0, 0, 300, 0, 1, 0, 1 },
+	{ 30, 7, BUTTON_SPECIAL, 10, 135, 1, -1, 1, 0 },
+	{ 60, 16, 0, 0, 135, 0, 0, 0, 0 },
+};
+
+// The hashes cover the raw bits of every float in the player state, so they depend on
+// the floating point code generation. They were recorded with SSE math (x86_64, or x86
+// built with -mfpmath=sse). x87 builds keep intermediates in extended precision and
+// will not match.
+static const pmovetest_stream_t pmovetest_streams[] =
+{
+	{ "route", PM_NORMAL, 0, 0xdaf6a2c1 },
+	{ "random1", PM_NORMAL, 1, 0x29bdaabd },
+	{ "random2", PM_NORMAL, 2, 0xafbad6bf },
+	{ "random3", PM_NORMAL, 3, 0x6645c637 },
+	{ "random4", PM_NORMAL, 4, 0xd1902f3d },
+	{ "random5", PM_NORMAL, 5, 0xf61e2329 },
+	{ "spectator", PM_SPECTATOR, 6, 0x9ff9d5bb },
+};
+
+static unsigned int pmovetest_eventhash;
+static entity_state_t pmovetest_worldstate;
+
+/*
+* G_PmoveTest_Hash
+*
+* FNV-1a over the bytes of the value, lowest first so the result doesn't depend on endianness
+*/
+static unsigned int G_PmoveTest_Hash( unsigned int hash, unsigned int value )
+{
+	int i;
+
+	for( i = 0; i < 4; i++, value >>= 8 )
+		hash = ( hash ^ ( value & 0xFF ) ) * 16777619u;
+	return hash;
+}
+
+/*
+* G_PmoveTest_HashFloats
+*/
+static unsigned int G_PmoveTest_HashFloats( unsigned int hash, const float *v, int count )
+{
+	int i;
+	unsigned int bits;
+
+	for( i = 0; i < count; i++ )
+	{
+		memcpy( &bits, &v[i], sizeof( bits ) );
+		hash = G_PmoveTest_Hash( hash, bits );
+	}
+	return hash;
+}
+
+/*
+* G_PmoveTest_Trace
+*
+* Sweeps the box against every brush, clipping short of the hit plane like the collision code does
+*/
+static void G_PmoveTest_Trace( trace_t *tr, vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int ignore, int contentmask, int timeDelta )
+{
+	int i, j, side, hitaxis, hitside;
+	float d1, d2, f, enterfrac, leavefrac;
+	bool startout, getout;
+	vec3_t lo, hi;
+	const pmovetest_brush_t *brush;
+
+	memset( tr, 0, sizeof( *tr ) );
+	tr->fraction = 1;
+
+	for( i = 0; i < (int)( sizeof( pmovetest_brushes ) / sizeof( pmovetest_brushes[0] ) ); i++ )
+	{
+		brush = &pmovetest_brushes[i];
+		if( !( brush->contents & contentmask ) )
+			continue;
+
+		for( j = 0; j < 3; j++ )
+		{
+			lo[j] = brush->mins[j] - ( maxs ? maxs[j] : 0 );
+			hi[j] = brush->maxs[j] - ( mins ? mins[j] : 0 );
+		}
+
+		enterfrac = -1;
+		leavefrac = 1;
+		startout = getout = false;
+		hitaxis = hitside = 0;
+
+		for( j = 0; j < 6; j++ )
+		{
+			side = j & 1;
+			if( side )
+			{
+				d1 = start[j>>1] - hi[j>>1];
+				d2 = end[j>>1] - hi[j>>1];
+			}
+			else
+			{
+				d1 = lo[j>>1] - start[j>>1];
+				d2 = lo[j>>1] - end[j>>1];
+			}
+
+			if( d2 > 0 )
+				getout = true;
+			if( d1 > 0 )
+				startout = true;
+
+			// completely in front of the face, no intersection
+			if( d1 > 0 && ( d2 >= PMOVETEST_CLIP_EPSILON || d2 >= d1 ) )
+				break;
+			if( d1 <= 0 && d2 <= 0 )
+				continue;
+
+			if( d1 > d2 )
+			{
+				f = ( d1 - PMOVETEST_CLIP_EPSILON ) / ( d1 - d2 );
+				if( f < 0 )
+					f = 0;
+				if( f > enterfrac )
+				{
+					enterfrac = f;
+					hitaxis = j >> 1;
+					hitside = side;
+				}
+			}
+			else
+			{
+				f = ( d1 + PMOVETEST_CLIP_EPSILON ) / ( d1 - d2 );
+				if( f > 1 )
+					f = 1;
+				if( f < leavefrac )
+					leavefrac = f;
+			}
+		}
+		if( j < 6 )
+			continue;
+
+		if( !startout )
+		{
+			tr->startsolid = true;
+			if( !getout )
+			{
+				tr->allsolid = true;
+				tr->fraction = 0;
+			}
+			tr->contents = brush->contents;
+			continue;
+		}
+
+		if( enterfrac < leavefrac && enterfrac > -1 && enterfrac < tr->fraction )
+		{
+			tr->fraction = enterfrac;
+			VectorClear( tr->plane.normal );
+			tr->plane.normal[hitaxis] = hitside ? 1 : -1;
+			tr->plane.dist = hitside ? brush->maxs[hitaxis] : -brush->mins[hitaxis];
+			CategorizePlane( &tr->plane );
+			tr->surfFlags = brush->surfFlags;
+			tr->contents = brush->contents;
+		}
+	}
+
+	if( tr->allsolid )
+		VectorCopy( start, tr->endpos );
+	else
+		for( j = 0; j < 3; j++ )
+			tr->endpos[j] = start[j] + tr->fraction * ( end[j] - start[j] );
+
+	// everything belongs to the world entity
+	tr->ent = ( tr->fraction < 1.0f || tr->startsolid ) ? 0 : -1;
+}
+
+/*
+* G_PmoveTest_PointContents
+*/
+static int G_PmoveTest_PointContents( vec3_t point, int timeDelta )
+{
+	int i, contents = 0;
+	const pmovetest_brush_t *brush;
+
+	for( i = 0; i < (int)( sizeof( pmovetest_brushes ) / sizeof( pmovetest_brushes[0] ) ); i++ )
+	{
+		brush = &pmovetest_brushes[i];
+		if( point[0] >= brush->mins[0] && point[0] <= brush->maxs[0]
+			&& point[1] >= brush->mins[1] && point[1] <= brush->maxs[1]
+			&& point[2] >= brush->mins[2] && point[2] <= brush->maxs[2] )
+			contents |= brush->contents;
+	}
+	return contents;
+}
+
+/*
+* G_PmoveTest_GetEntityState
+*/
+static entity_state_t *G_PmoveTest_GetEntityState( int entNum, int deltaTime )
+{
+	return &pmovetest_worldstate;
+}
+
+/*
+* G_PmoveTest_PredictedEvent
+*/
+static void G_PmoveTest_PredictedEvent( int entNum, int ev, int parm )
+{
+	pmovetest_eventhash = G_PmoveTest_Hash( pmovetest_eventhash, ev );
+	pmovetest_eventhash = G_PmoveTest_Hash( pmovetest_eventhash, parm );
+}
+
+/*
+* G_PmoveTest_TouchTriggers
+*/
+static void G_PmoveTest_TouchTriggers( pmove_t *pm, vec3_t previous_origin )
+{
+	pmovetest_eventhash = G_PmoveTest_HashFloats( pmovetest_eventhash, previous_origin, 3 );
+}
+
+/*
+* G_PmoveTest_RoundUpToHullSize
+*/
+static void G_PmoveTest_RoundUpToHullSize( vec3_t mins, vec3_t maxs )
+{
+}
+
+/*
+* G_PmoveTest_Random
+*/
+static int G_PmoveTest_Random( unsigned int *seed, int range )
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return (int)( ( *seed >> 8 ) % range );
+}
+
+/*
+* G_PmoveTest_Command
+*
+* Fills the usercmd of the given frame, returns false once the stream is over
+*/
+static bool G_PmoveTest_Command( const pmovetest_stream_t *stream, unsigned int *seed, int frame, usercmd_t *cmd )
+{
+	int i;
+	const pmovetest_segment_t *seg;
+
+	memset( cmd, 0, sizeof( *cmd ) );
+
+	if( stream->seed )
+	{
+		if( frame >= PMOVETEST_RANDOM_FRAMES )
+			return false;
+
+		cmd->msec = 8 + G_PmoveTest_Random( seed, 16 );
+		cmd->forwardmove = G_PmoveTest_Random( seed, 3 ) - 1;
+		cmd->sidemove = G_PmoveTest_Random( seed, 3 ) - 1;
+		i = G_PmoveTest_Random( seed, 10 );
+		cmd->upmove = i < 2 ? 1 : ( i == 2 ? -1 : 0 );
+		cmd->buttons = G_PmoveTest_Random( seed, 7 ) ? 0 : BUTTON_SPECIAL;
+		cmd->angles[YAW] = G_PmoveTest_Random( seed, 65536 );
+		cmd->angles[PITCH] = G_PmoveTest_Random( seed, 8000 ) - 4000;
+	}
+	else
+	{
+		for( i = 0; i < (int)( sizeof( pmovetest_route ) / sizeof( pmovetest_route[0] ) ); i++ )
+		{
+			if( frame < pmovetest_route[i].frames )
+				break;
+			frame -= pmovetest_route[i].frames;
+		}
+		if( i == (int)( sizeof( pmovetest_route ) / sizeof( pmovetest_route[0] ) ) )
+			return false;
+
+		seg = &pmovetest_route[i];
+		cmd->msec = seg->msec;
+		cmd->buttons = seg->buttons;
+		cmd->angles[PITCH] = ANGLE2SHORT( seg->pitch );
+		cmd->angles[YAW] = ANGLE2SHORT( seg->yaw + seg->yawspeed * frame );
+		cmd->forwardmove = seg->forwardmove;
+		cmd->sidemove = seg->sidemove;
+		cmd->upmove = seg->upmove;
+	}
+
+	return true;
+}
+
+/*
+* G_PmoveTest_RunStream
+*/
+static unsigned int G_PmoveTest_RunStream( const pmovetest_stream_t *stream, const pmove_callbacks_t *callbacks, int *numframes )
+{
+	int frame;
+	unsigned int seed, hash;
+	unsigned int serverTime;
+	player_state_t ps;
+	pmove_t pm;
+	usercmd_t cmd;
+
+	memset( &ps, 0, sizeof( ps ) );
+	ps.POVnum = 1;
+	ps.pmove.pm_type = stream->pm_type;
+	ps.pmove.gravity = 850;
+	ps.pmove.stats[PM_STAT_FEATURES] = PMFEAT_DEFAULT;
+	ps.pmove.stats[PM_STAT_MAXSPEED] = (short)DEFAULT_PLAYERSPEED_STANDARD;
+	ps.pmove.stats[PM_STAT_JUMPSPEED] = (short)DEFAULT_JUMPSPEED;
+	ps.pmove.stats[PM_STAT_DASHSPEED] = (short)DEFAULT_DASHSPEED;
+	VectorSet( ps.pmove.origin, 0, -200, 64 );
+
+	seed = stream->seed;
+	hash = 2166136261u;
+	pmovetest_eventhash = 2166136261u;
+	serverTime = 0;
+
+	for( frame = 0; G_PmoveTest_Command( stream, &seed, frame, &cmd ); frame++ )
+	{
+		serverTime += cmd.msec;
+		cmd.serverTimeStamp = serverTime;
+
+		memset( &pm, 0, sizeof( pm ) );
+		pm.playerState = &ps;
+		pm.cmd = cmd;
+		pm.snapinitial = frame == 0;
+
+		Pmove_Ext( &pm, callbacks );
+
+		hash = G_PmoveTest_Hash( hash, ps.pmove.pm_type );
+		hash = G_PmoveTest_HashFloats( hash, ps.pmove.origin, 3 );
+		hash = G_PmoveTest_HashFloats( hash, ps.pmove.velocity, 3 );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.pm_flags );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.pm_time );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.skim_time );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_DASHTIME] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_WJTIME] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_CROUCHTIME] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_CROUCHSLIDETIME] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_FWDTIME] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_KNOCKBACK] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.stats[PM_STAT_STUN] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.delta_angles[PITCH] );
+		hash = G_PmoveTest_Hash( hash, ps.pmove.delta_angles[YAW] );
+		hash = G_PmoveTest_HashFloats( hash, ps.viewangles, 3 );
+		hash = G_PmoveTest_HashFloats( hash, &ps.viewheight, 1 );
+		hash = G_PmoveTest_HashFloats( hash, pm.mins, 3 );
+		hash = G_PmoveTest_HashFloats( hash, pm.maxs, 3 );
+		hash = G_PmoveTest_Hash( hash, pm.groundentity );
+		hash = G_PmoveTest_Hash( hash, pm.watertype );
+		hash = G_PmoveTest_Hash( hash, pm.waterlevel );
+		hash = G_PmoveTest_Hash( hash, pm.numtouch );
+		hash = G_PmoveTest_HashFloats( hash, &pm.step, 1 );
+		hash = G_PmoveTest_Hash( hash, pmovetest_eventhash );
+	}
+
+	*numframes = frame;
+	return hash;
+}
+
+/*
+* G_PmoveTest_f
+*
+* pmovetest
+* Replays every stream and compares its hash with the recorded one. After an intended
+* change to the movement, copy the printed hashes into pmovetest_streams.
+*/
+void G_PmoveTest_f( void )
+{
+	int i, numframes, totalframes, passed;
+	int oldflags;
+	unsigned int hash;
+	uint64_t time;
+	pmove_callbacks_t callbacks;
+	const pmovetest_stream_t *stream;
+
+	callbacks.Trace = G_PmoveTest_Trace;
+	callbacks.GetEntityState = G_PmoveTest_GetEntityState;
+	callbacks.PointContents = G_PmoveTest_PointContents;
+	callbacks.PredictedEvent = G_PmoveTest_PredictedEvent;
+	callbacks.PMoveTouchTriggers = G_PmoveTest_TouchTriggers;
+	callbacks.RoundUpToHullSize = G_PmoveTest_RoundUpToHullSize;
+
+	// the streams were recorded with fall damage on and the match running
+	oldflags = gs.gameState.stats[GAMESTAT_FLAGS];
+	gs.gameState.stats[GAMESTAT_FLAGS] = GAMESTAT_FLAG_FALLDAMAGE;
+
+	memset( &pmovetest_worldstate, 0, sizeof( pmovetest_worldstate ) );
+	pmovetest_worldstate.type = ET_GENERIC;
+
+	passed = totalframes = 0;
+	time = trap_Microseconds();
+	for( i = 0; i < (int)( sizeof( pmovetest_streams ) / sizeof( pmovetest_streams[0] ) ); i++ )
+	{
+		stream = &pmovetest_streams[i];
+		hash = G_PmoveTest_RunStream( stream, &callbacks, &numframes );
+		totalframes += numframes;
+
+		if( hash == stream->hash )
+		{
+			G_Printf( "%-10s %5i frames  %08x  ok\n", stream->name, numframes, hash );
+			passed++;
+		}
+		else
+		{
+			G_Printf( "%-10s %5i frames  %08x  " S_COLOR_RED "MISMATCH" S_COLOR_WHITE ", expected %08x\n",
+				stream->name, numframes, hash, stream->hash );
+		}
+	}
+	time = trap_Microseconds() - time;
+
+	gs.gameState.stats[GAMESTAT_FLAGS] = oldflags;
+
+	G_Printf( "%i of %i streams match, %.2f usec per move\n", passed, i, totalframes ? (double)time / totalframes : 0.0 );
+}
+
+#endif // PUBLIC_BUILD
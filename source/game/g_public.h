@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 // g_public.h -- game dll information visible to server
 
-#define	GAME_API_VERSION    50
+#define	GAME_API_VERSION    53
 
 //===============================================================
 
@@ -96,6 +96,11 @@ typedef struct
 	int ( *SkinIndex )( const char *name );
 
 	unsigned int ( *Milliseconds )( void );
+	uint64_t ( *Microseconds )( void );
+
+	// profiler zones
+	void ( *Prof_Begin )( const char *name );
+	void ( *Prof_End )( void );
 
 	bool ( *inPVS )( const vec3_t p1, const vec3_t p2 );
 
@@ -227,6 +232,9 @@ typedef struct
 
 	game_state_t *( *GetGameState )( void );
 
+	// time spent in AI since the game module has been loaded, in microseconds
+	uint64_t ( *AIMicroseconds )( void );
+
 	bool ( *AllowDownload )( edict_t *ent, const char *requestname, const char *uploadname );
 
 	// Web requests to local HTTP server
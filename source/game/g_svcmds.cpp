@@ -396,11 +396,22 @@ void G_AddServerCommands( void )
 	trap_Cmd_AddCommand( "writeip", Cmd_WriteIP_f );
 
 	trap_Cmd_AddCommand( "dumpASapi", G_asDumpAPI_f );
+	trap_Cmd_AddCommand( "asprofile", G_asProfile_f );
 
 	trap_Cmd_AddCommand( "listratings", G_ListRatings_f );
 	trap_Cmd_AddCommand( "listraces", G_ListRaces_f );
 
 	trap_Cmd_AddCommand( "listlocations", Cmd_ListLocations_f );
+
+	trap_Cmd_AddCommand( "areagridbench", GClip_AreaGridBenchmark_f );
+#ifndef PUBLIC_BUILD
+	trap_Cmd_AddCommand( "pmovetest", G_PmoveTest_f );
+#endif
+
+	trap_Cmd_AddCommand( "ai_genvistable", AI_GenerateVisTable_f );
+	trap_Cmd_AddCommand( "ai_spotsbench", AI_TacticalSpotsBenchmark_f );
+	trap_Cmd_AddCommand( "ai_tracestats", AI_TraceStats_f );
+	trap_Cmd_AddCommand( "ai_schedstats", AI_ThinkSchedulerStats_f );
 }
 
 /*
@@ -422,9 +433,20 @@ void G_RemoveCommands( void )
 	trap_Cmd_RemoveCommand( "writeip" );
 
 	trap_Cmd_RemoveCommand( "dumpASapi" );
+	trap_Cmd_RemoveCommand( "asprofile" );
 
 	trap_Cmd_RemoveCommand( "listratings" );
 	trap_Cmd_RemoveCommand( "listraces" );
 
 	trap_Cmd_RemoveCommand( "listlocations" );
+
+	trap_Cmd_RemoveCommand( "areagridbench" );
+#ifndef PUBLIC_BUILD
+	trap_Cmd_RemoveCommand( "pmovetest" );
+#endif
+
+	trap_Cmd_RemoveCommand( "ai_genvistable" );
+	trap_Cmd_RemoveCommand( "ai_spotsbench" );
+	trap_Cmd_RemoveCommand( "ai_tracestats" );
+	trap_Cmd_RemoveCommand( "ai_schedstats" );
 }
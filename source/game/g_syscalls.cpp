@@ -53,6 +53,7 @@ extern "C" QF_DLL_EXPORT game_export_t *GetGameAPI( game_import_t *import )
 	globals.ClearSnap = G_ClearSnap;
 
 	globals.GetGameState = G_GetGameState;
+	globals.AIMicroseconds = AI_Microseconds;
 
 	globals.AllowDownload = G_AllowDownload;
 
@@ -84,6 +84,21 @@ static inline unsigned int trap_Milliseconds( void )
 	return GAME_IMPORT.Milliseconds();
 }
 
+static inline uint64_t trap_Microseconds( void )
+{
+	return GAME_IMPORT.Microseconds();
+}
+
+static inline void trap_Prof_Begin( const char *name )
+{
+	GAME_IMPORT.Prof_Begin( name );
+}
+
+static inline void trap_Prof_End( void )
+{
+	GAME_IMPORT.Prof_End();
+}
+
 static inline bool trap_inPVS( const vec3_t p1, const vec3_t p2 )
 {
 	return GAME_IMPORT.inPVS( p1, p2 ) == true;
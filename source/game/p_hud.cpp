@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "g_local.h"
 
-char scoreboardString[MAX_STRING_CHARS];
+char scoreboardString[SCOREBOARD_MSG_MAXSIZE];
 const unsigned int scoreboardInterval = 1000;
 static const char *G_PlayerStatsMessage( edict_t *ent );
 
@@ -30,6 +30,310 @@ static const char *G_PlayerStatsMessage( edict_t *ent );
 //
 //======================================================================
 
+// The scoreboard message is a list of rows, each one starting with a "&x" token.
+// Clients are sent the rows which changed since the last message they were sent:
+//   "&=K,N"          copy N rows starting at row K of the baseline
+//   "&~K i v ..."    copy row K of the baseline, replacing its i-th token with v
+//   "&x ..."         any other row is sent as is
+// in "scb <baseline> <sequence> <more> "rows"" commands. Commands are reliable, so the
+// last message sent becomes the baseline. A zero baseline means a full message, which
+// is sent periodically and when the client reports it has lost the baseline.
+
+#define SCOREBOARD_MAX_TOKENS	( SCOREBOARD_MSG_MAXSIZE / 2 )
+#define SCOREBOARD_CHUNK_SIZE	( MAX_STRING_CHARS - 48 )
+
+typedef struct
+{
+	char buffer[SCOREBOARD_MSG_MAXSIZE];
+	int numTokens;
+	const char *tokens[SCOREBOARD_MAX_TOKENS];
+	int numRows;
+	int rows[SCOREBOARD_MAX_TOKENS + 1];	// first token of each row, the last one ends the list
+} g_scoreboardtokens_t;
+
+static g_scoreboardtokens_t scbBaseline, scbCurrent;
+static char scbDelta[SCOREBOARD_MSG_MAXSIZE];
+
+/*
+* G_ScoreboardTokenize
+*/
+static void G_ScoreboardTokenize( g_scoreboardtokens_t *scb, const char *string )
+{
+	char *p;
+
+	Q_strncpyz( scb->buffer, string, sizeof( scb->buffer ) );
+	scb->numTokens = 0;
+	scb->numRows = 0;
+
+	p = scb->buffer;
+	while( scb->numTokens < SCOREBOARD_MAX_TOKENS )
+	{
+		while( *p && *p <= ' ' )
+			*p++ = '\0';
+		if( !*p )
+			break;
+
+		if( *p == '&' )
+			scb->rows[scb->numRows++] = scb->numTokens;
+
+		// anything before the first row is ignored by clients as well
+		if( scb->numRows )
+			scb->tokens[scb->numTokens++] = p;
+
+		while( *p > ' ' )
+			p++;
+	}
+
+	scb->rows[scb->numRows] = scb->numTokens;
+}
+
+/*
+* G_ScoreboardSameRow
+*
+* Rows are keyed by their type and first value, the player or team number.
+*/
+static bool G_ScoreboardSameRow( const g_scoreboardtokens_t *scb1, int row1, const g_scoreboardtokens_t *scb2, int row2 )
+{
+	int first1 = scb1->rows[row1], num1 = scb1->rows[row1+1] - first1;
+	int first2 = scb2->rows[row2], num2 = scb2->rows[row2+1] - first2;
+
+	if( strcmp( scb1->tokens[first1], scb2->tokens[first2] ) )
+		return false;
+	if( num1 < 2 || num2 < 2 )
+		return num1 == num2;
+	return !strcmp( scb1->tokens[first1+1], scb2->tokens[first2+1] );
+}
+
+/*
+* G_ScoreboardAppend
+*/
+static bool G_ScoreboardAppend( char *delta, size_t *len, const char *token )
+{
+	size_t tokenlen = strlen( token );
+
+	if( *len + tokenlen + 1 >= SCOREBOARD_MSG_MAXSIZE )
+		return false;
+
+	memcpy( delta + *len, token, tokenlen );
+	*len += tokenlen;
+	delta[( *len )++] = ' ';
+	delta[*len] = '\0';
+	return true;
+}
+
+/*
+* G_ScoreboardDelta
+*
+* Writes the changes between the two messages. Returns false if they don't fit,
+* or if nothing has changed, in which case unchanged is set.
+*/
+static bool G_ScoreboardDelta( const g_scoreboardtokens_t *base, const g_scoreboardtokens_t *cur, char *delta, size_t *len, bool *unchanged )
+{
+	int i, j, k, t;
+	int first, baseFirst, numTokens;
+	int copyStart, copyCount, lastMatch;
+	size_t rowLen, changesLen;
+	char op[32];
+
+	*len = 0;
+	baseFirst = 0;
+	delta[0] = '\0';
+	*unchanged = false;
+
+	copyStart = copyCount = 0;
+	lastMatch = -1;
+
+	for( j = 0; j < cur->numRows; j++ )
+	{
+		first = cur->rows[j];
+		numTokens = cur->rows[j+1] - first;
+
+		// rows mostly keep their order, so try the one after the last match first
+		k = -1;
+		if( lastMatch + 1 < base->numRows && G_ScoreboardSameRow( base, lastMatch + 1, cur, j ) )
+		{
+			k = lastMatch + 1;
+		}
+		else
+		{
+			for( i = 0; i < base->numRows; i++ )
+			{
+				if( G_ScoreboardSameRow( base, i, cur, j ) )
+				{
+					k = i;
+					break;
+				}
+			}
+		}
+
+		// compare the values of the matching row
+		rowLen = 0;
+		changesLen = 0;
+		if( k >= 0 )
+		{
+			baseFirst = base->rows[k];
+			if( base->rows[k+1] - baseFirst != numTokens )
+			{
+				k = -1;
+			}
+			else
+			{
+				for( t = 0; t < numTokens; t++ )
+				{
+					rowLen += strlen( cur->tokens[first+t] ) + 1;
+					if( strcmp( base->tokens[baseFirst+t], cur->tokens[first+t] ) )
+						changesLen += strlen( va( "%i", t ) ) + strlen( cur->tokens[first+t] ) + 2;
+				}
+			}
+		}
+
+		if( k >= 0 && !changesLen )
+		{
+			lastMatch = k;
+			if( copyCount && copyStart + copyCount == k )
+			{
+				copyCount++;
+				continue;
+			}
+
+			if( copyCount && !G_ScoreboardAppend( delta, len, va( "&=%i,%i", copyStart, copyCount ) ) )
+				return false;
+			copyStart = k;
+			copyCount = 1;
+			continue;
+		}
+
+		if( copyCount )
+		{
+			if( !G_ScoreboardAppend( delta, len, va( "&=%i,%i", copyStart, copyCount ) ) )
+				return false;
+			copyCount = 0;
+		}
+
+		if( k >= 0 )
+		{
+			lastMatch = k;
+			Q_snprintfz( op, sizeof( op ), "&~%i", k );
+
+			// send the changed values only if that's shorter than the whole row
+			if( strlen( op ) + 1 + changesLen < rowLen )
+			{
+				if( !G_ScoreboardAppend( delta, len, op ) )
+					return false;
+
+				for( t = 1; t < numTokens; t++ )
+				{
+					if( !strcmp( base->tokens[baseFirst+t], cur->tokens[first+t] ) )
+						continue;
+					if( !G_ScoreboardAppend( delta, len, va( "%i", t ) ) || !G_ScoreboardAppend( delta, len, cur->tokens[first+t] ) )
+						return false;
+				}
+				continue;
+			}
+		}
+
+		for( t = 0; t < numTokens; t++ )
+		{
+			if( !G_ScoreboardAppend( delta, len, cur->tokens[first+t] ) )
+				return false;
+		}
+	}
+
+	if( copyCount )
+	{
+		if( !copyStart && copyCount == base->numRows && copyCount == cur->numRows )
+		{
+			*unchanged = true;
+			return false;
+		}
+
+		if( !G_ScoreboardAppend( delta, len, va( "&=%i,%i", copyStart, copyCount ) ) )
+			return false;
+	}
+	else if( !cur->numRows && !base->numRows )
+	{
+		*unchanged = true;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* G_SendScoreboardCommands
+*
+* Splits the message into commands which fit MAX_STRING_CHARS.
+*/
+static void G_SendScoreboardCommands( edict_t *ent, unsigned int baseline, unsigned int sequence, const char *rows )
+{
+	char command[MAX_STRING_CHARS];
+	size_t len, chunk;
+
+	len = strlen( rows );
+	do
+	{
+		chunk = len;
+		if( chunk > SCOREBOARD_CHUNK_SIZE )
+		{
+			// split at a token boundary, clients join the chunks back as they are
+			chunk = SCOREBOARD_CHUNK_SIZE;
+			while( chunk > 0 && rows[chunk-1] != ' ' )
+				chunk--;
+			if( !chunk )
+				chunk = SCOREBOARD_CHUNK_SIZE;
+		}
+
+		Q_snprintfz( command, sizeof( command ), "scb %u %u %i \"%.*s\"", baseline, sequence, chunk < len ? 1 : 0, (int)chunk, rows );
+		trap_GameCmd( ent, command );
+
+		rows += chunk;
+		len -= chunk;
+	} while( len );
+}
+
+/*
+* G_SendScoreboardMessage
+*
+* Sends scoreboardString to the client, as a delta from the last one it has been sent if possible.
+*/
+static void G_SendScoreboardMessage( edict_t *ent, bool full )
+{
+	gclient_t *client = ent->r.client;
+	unsigned int baseline, sequence;
+	size_t len;
+	bool unchanged;
+
+	G_ScoreboardTokenize( &scbCurrent, scoreboardString );
+
+	// sequence numbers are unique across all clients, so a viewer switching between
+	// their commands (demos, multiview, chasecam POV changes) can't mistake one
+	// client's delta for another one's
+	baseline = client->level.scoreboard_seq;
+	sequence = ++level.scoreboard_seq;
+	if( !sequence )
+		sequence = ++level.scoreboard_seq;
+
+	if( baseline && !full )
+	{
+		G_ScoreboardTokenize( &scbBaseline, client->level.scoreboard_baseline );
+
+		if( G_ScoreboardDelta( &scbBaseline, &scbCurrent, scbDelta, &len, &unchanged ) && len < strlen( scoreboardString ) )
+		{
+			G_SendScoreboardCommands( ent, baseline, sequence, scbDelta );
+			goto sent;
+		}
+
+		if( unchanged )
+			return;
+	}
+
+	G_SendScoreboardCommands( ent, 0, sequence, scoreboardString );
+
+sent:
+	client->level.scoreboard_seq = sequence;
+	Q_strncpyz( client->level.scoreboard_baseline, scoreboardString, sizeof( client->level.scoreboard_baseline ) );
+}
+
 /*
 * G_ClientUpdateScoreBoardMessage
 * 
@@ -42,11 +346,9 @@ void G_UpdateScoreBoardMessages( void )
 	edict_t	*ent;
 	gclient_t *client;
 	bool forcedUpdate = false;
-	char command[MAX_STRING_CHARS];
 	size_t maxlen, staticlen;
 
-	// fixme : mess of copying
-	maxlen = MAX_STRING_CHARS - ( strlen( "scb \"\"" + 4 ) );
+	maxlen = SCOREBOARD_MSG_MAXSIZE - 1;
 
 	if( game.asEngine != NULL )
 		GT_asCallScoreboardMessage( maxlen );
@@ -57,49 +359,47 @@ void G_UpdateScoreBoardMessages( void )
 
 	staticlen = strlen( scoreboardString );
 
-update:
+	// every 10 seconds, send everyone a full scoreboard regardless of their last update,
+	// demos, multiview and TV clients never ask for one when they miss a baseline
+	nexttime -= game.snapFrameTime;
+	if( nexttime <= 0 )
+	{
+		do
+		{
+			nexttime += 10000;
+		}
+		while( nexttime <= 0 );
+
+		forcedUpdate = true;
+	}
+
 	// send to players who have scoreboard visible
 	for( i = 0; i < gs.maxclients; i++ )
 	{
 		ent = game.edicts + 1 + i;
-		if( !ent->r.inuse || !ent->r.client )
+		if( !ent->r.inuse || !ent->r.client || ( ent->r.svflags & SVF_FAKECLIENT ) )
 			continue;
 
 		client = ent->r.client;
 
-		if( game.realtime <= client->level.scoreboard_time + scoreboardInterval )
-			continue;
-
-		if( forcedUpdate || ( client->ps.stats[STAT_LAYOUTS] & STAT_LAYOUT_SCOREBOARD ) )
+		if( !forcedUpdate )
 		{
-			scoreboardString[staticlen] = '\0';
-			if( client->resp.chase.active )
-				G_ScoreboardMessage_AddChasers( client->resp.chase.target, ENTNUM( ent ) );
-			else
-				G_ScoreboardMessage_AddChasers( ENTNUM( ent ), ENTNUM( ent ) );
-			Q_snprintfz( command, sizeof( command ), "scb \"%s\"", scoreboardString );
-
-			client->level.scoreboard_time = game.realtime + scoreboardInterval - ( game.realtime%scoreboardInterval );
-			trap_GameCmd( ent, command );
-			trap_GameCmd( ent, G_PlayerStatsMessage( ent ) );
+			if( game.realtime <= client->level.scoreboard_time + scoreboardInterval )
+				continue;
+			if( !( client->ps.stats[STAT_LAYOUTS] & STAT_LAYOUT_SCOREBOARD ) )
+				continue;
 		}
-	}
 
-	if( !forcedUpdate )
-	{
-		// every 10 seconds, send everyone the scoreboard
-		nexttime -= game.snapFrameTime;
-		if( nexttime > 0 )
-			return;
+		scoreboardString[staticlen] = '\0';
+		if( client->resp.chase.active )
+			G_ScoreboardMessage_AddChasers( client->resp.chase.target, ENTNUM( ent ) );
+		else
+			G_ScoreboardMessage_AddChasers( ENTNUM( ent ), ENTNUM( ent ) );
 
-		do
-		{
-			nexttime += 10000;
-		}
-		while( nexttime <= 0 );
+		client->level.scoreboard_time = game.realtime + scoreboardInterval - ( game.realtime%scoreboardInterval );
 
-		forcedUpdate = true;
-		goto update;
+		G_SendScoreboardMessage( ent, forcedUpdate );
+		trap_GameCmd( ent, G_PlayerStatsMessage( ent ) );
 	}
 }
 
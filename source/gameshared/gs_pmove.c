@@ -88,8 +88,12 @@ typedef struct
 	float dashPlayerSpeed;
 } pml_t;
 
-pmove_t	*pm;
-pml_t pml;
+typedef struct
+{
+	pmove_t *pm;
+	pml_t pml;
+	const pmove_callbacks_t *callbacks;
+} pmove_context_t;
 
 // movement parameters
 
@@ -124,7 +128,7 @@ const float pm_wjupspeed = ( 330.0f * GRAVITY_COMPENSATE );
 const float pm_failedwjupspeed = ( 50.0f * GRAVITY_COMPENSATE );
 const float pm_wjbouncefactor = 0.3f;
 const float pm_failedwjbouncefactor = 0.1f;
-#define pm_wjminspeed ( ( pml.maxWalkSpeed + pml.maxPlayerSpeed ) * 0.5f )
+#define pm_wjminspeed ( ( ctx->pml.maxWalkSpeed + ctx->pml.maxPlayerSpeed ) * 0.5f )
 #endif
 
 //
@@ -147,11 +151,20 @@ static vec_t VectorNormalize2D( vec3_t v ) // ByMiK : normalize horizontally (do
 	return length;
 }
 
+// horizontal speed, without tv() which isn't safe to call from several threads
+static vec_t VectorLength2DFast( const vec3_t v )
+{
+	vec3_t hv;
+
+	VectorSet( hv, v[0], v[1], 0 );
+	return VectorLengthFast( hv );
+}
+
 // Walljump wall availability check
 // nbTestDir is the number of directions to test around the player
 // maxZnormal is the max Z value of the normal of a poly to consider it a wall
 // normal becomes a pointer to the normal of the most appropriate wall
-static void PlayerTouchWall( int nbTestDir, float maxZnormal, vec3_t *normal )
+static void PlayerTouchWall( pmove_context_t *ctx, int nbTestDir, float maxZnormal, vec3_t *normal )
 {
 	vec3_t zero, dir, mins, maxs;
 	trace_t trace;
@@ -163,33 +176,33 @@ static void PlayerTouchWall( int nbTestDir, float maxZnormal, vec3_t *normal )
 
 	// if there is nothing at all within the checked area, we can skip the individual checks
 	// this optimization must always overapproximate the combination of those checks
-	mins[0] = pm->mins[0] - pm->maxs[0];
-	mins[1] = pm->mins[1] - pm->maxs[0];
-	maxs[0] = pm->maxs[0] + pm->maxs[0];
-	maxs[1] = pm->maxs[1] + pm->maxs[0];
-	if( pml.velocity[0] > 0 )
-		maxs[0] += pml.velocity[0] * 0.015f;
+	mins[0] = ctx->pm->mins[0] - ctx->pm->maxs[0];
+	mins[1] = ctx->pm->mins[1] - ctx->pm->maxs[0];
+	maxs[0] = ctx->pm->maxs[0] + ctx->pm->maxs[0];
+	maxs[1] = ctx->pm->maxs[1] + ctx->pm->maxs[0];
+	if( ctx->pml.velocity[0] > 0 )
+		maxs[0] += ctx->pml.velocity[0] * 0.015f;
 	else
-		mins[0] += pml.velocity[0] * 0.015f;
-	if( pml.velocity[1] > 0 )
-		maxs[1] += pml.velocity[1] * 0.015f;
+		mins[0] += ctx->pml.velocity[0] * 0.015f;
+	if( ctx->pml.velocity[1] > 0 )
+		maxs[1] += ctx->pml.velocity[1] * 0.015f;
 	else
-		mins[1] += pml.velocity[1] * 0.015f;
+		mins[1] += ctx->pml.velocity[1] * 0.015f;
 	mins[2] = maxs[2] = 0;
-	module_Trace( &trace, pml.origin, mins, maxs, pml.origin, pm->playerState->POVnum, pm->contentmask, 0 );
+	ctx->callbacks->Trace( &trace, ctx->pml.origin, mins, maxs, ctx->pml.origin, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 	if( !trace.allsolid && trace.fraction == 1 )
 		return;
 
 	// determine the primary direction
-	if( pml.sidePush > 0 )
+	if( ctx->pml.sidePush > 0 )
 		r = -M_PI / 2.0f;
-	else if( pml.sidePush < 0 )
+	else if( ctx->pml.sidePush < 0 )
 		r = M_PI / 2.0f;
-	else if( pml.forwardPush > 0 )
+	else if( ctx->pml.forwardPush > 0 )
 		r = 0.0f;
 	else
 		r = M_PI;
-	alternate = pml.sidePush == 0 || pml.forwardPush == 0;
+	alternate = ctx->pml.sidePush == 0 || ctx->pml.forwardPush == 0;
 
 	d = 0.0f; // current distance from the primary direction
 
@@ -212,27 +225,27 @@ static void PlayerTouchWall( int nbTestDir, float maxZnormal, vec3_t *normal )
 		}
 
 		// determine the relative offsets from the origin
-		dx = cos( DEG2RAD( pm->playerState->viewangles[YAW] ) + r );
-		dy = sin( DEG2RAD( pm->playerState->viewangles[YAW] ) + r );
+		dx = cos( DEG2RAD( ctx->pm->playerState->viewangles[YAW] ) + r );
+		dy = sin( DEG2RAD( ctx->pm->playerState->viewangles[YAW] ) + r );
 
 		// project onto the player box
 		if( dx == 0 )
-			m = pm->maxs[1];
+			m = ctx->pm->maxs[1];
 		else if( dy == 0 )
-			m = pm->maxs[0];
-		else if( fabs( dx / pm->maxs[0] ) > fabs( dy / pm->maxs[1] ) )
-			m = fabs( pm->maxs[0] / dx );
+			m = ctx->pm->maxs[0];
+		else if( fabs( dx / ctx->pm->maxs[0] ) > fabs( dy / ctx->pm->maxs[1] ) )
+			m = fabs( ctx->pm->maxs[0] / dx );
 		else
-			m = fabs( pm->maxs[1] / dy );
+			m = fabs( ctx->pm->maxs[1] / dy );
 
 		// allow a gap between the player and the wall
-		m += pm->maxs[0];
+		m += ctx->pm->maxs[0];
 
-		dir[0] = pml.origin[0] + dx * m + pml.velocity[0] * 0.015f;
-		dir[1] = pml.origin[1] + dy * m + pml.velocity[1] * 0.015f;
-		dir[2] = pml.origin[2];
+		dir[0] = ctx->pml.origin[0] + dx * m + ctx->pml.velocity[0] * 0.015f;
+		dir[1] = ctx->pml.origin[1] + dy * m + ctx->pml.velocity[1] * 0.015f;
+		dir[2] = ctx->pml.origin[2];
 
-		module_Trace( &trace, pml.origin, zero, zero, dir, pm->playerState->POVnum, pm->contentmask, 0 );
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, zero, zero, dir, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 
 		if( trace.allsolid )
 			return;
@@ -243,7 +256,7 @@ static void PlayerTouchWall( int nbTestDir, float maxZnormal, vec3_t *normal )
 		if( trace.surfFlags & ( SURF_SKY|SURF_NOWALLJUMP ) )
 			continue;
 
-		if( trace.ent > 0 && module_GetEntityState( trace.ent, 0 )->type == ET_PLAYER )
+		if( trace.ent > 0 && ctx->callbacks->GetEntityState( trace.ent, 0 )->type == ET_PLAYER )
 			continue;
 
 		if( trace.fraction > 0 && fabs( trace.plane.normal[2] ) < maxZnormal )
@@ -267,27 +280,27 @@ static void PlayerTouchWall( int nbTestDir, float maxZnormal, vec3_t *normal )
 
 #define	MAX_CLIP_PLANES	5
 
-static void PM_AddTouchEnt( int entNum )
+static void PM_AddTouchEnt( pmove_context_t *ctx, int entNum )
 {
 	int i;
 
-	if( pm->numtouch >= MAXTOUCH || entNum < 0 )
+	if( ctx->pm->numtouch >= MAXTOUCH || entNum < 0 )
 		return;
 
 	// see if it is already added
-	for( i = 0; i < pm->numtouch; i++ )
+	for( i = 0; i < ctx->pm->numtouch; i++ )
 	{
-		if( pm->touchents[i] == entNum )
+		if( ctx->pm->touchents[i] == entNum )
 			return;
 	}
 
 	// add it
-	pm->touchents[pm->numtouch] = entNum;
-	pm->numtouch++;
+	ctx->pm->touchents[ctx->pm->numtouch] = entNum;
+	ctx->pm->numtouch++;
 }
 
 
-static int PM_SlideMove( void )
+static int PM_SlideMove( pmove_context_t *ctx )
 {
 	vec3_t end, dir;
 	vec3_t old_velocity, last_valid_origin;
@@ -297,34 +310,34 @@ static int PM_SlideMove( void )
 	trace_t	trace;
 	int moves, i, j, k;
 	int maxmoves = 4;
-	float remainingTime = pml.frametime;
+	float remainingTime = ctx->pml.frametime;
 	int blockedmask = 0;
 
-	if( pm->groundentity != -1 )
+	if( ctx->pm->groundentity != -1 )
 	{                          // clip velocity to ground, no need to wait
 		// if the ground is not horizontal (a ramp) clipping will slow the player down
-		if( pml.groundplane.normal[2] == 1.0f && pml.velocity[2] < 0.0f )
-			pml.velocity[2] = 0.0f;
+		if( ctx->pml.groundplane.normal[2] == 1.0f && ctx->pml.velocity[2] < 0.0f )
+			ctx->pml.velocity[2] = 0.0f;
 	}
 
-	VectorCopy( pml.velocity, old_velocity );
-	VectorCopy( pml.origin, last_valid_origin );
+	VectorCopy( ctx->pml.velocity, old_velocity );
+	VectorCopy( ctx->pml.origin, last_valid_origin );
 
 	numplanes = 0; // clean up planes count for checking
 
 	for( moves = 0; moves < maxmoves; moves++ )
 	{
-		VectorMA( pml.origin, remainingTime, pml.velocity, end );
-		module_Trace( &trace, pml.origin, pm->mins, pm->maxs, end, pm->playerState->POVnum, pm->contentmask, 0 );
+		VectorMA( ctx->pml.origin, remainingTime, ctx->pml.velocity, end );
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, end, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 		if( trace.allsolid )
 		{               // trapped into a solid
-			VectorCopy( last_valid_origin, pml.origin );
+			VectorCopy( last_valid_origin, ctx->pml.origin );
 			return SLIDEMOVEFLAG_TRAPPED;
 		}
 
 		if( trace.fraction > 0 )
 		{                   // actually covered some distance
-			VectorCopy( trace.endpos, pml.origin );
+			VectorCopy( trace.endpos, ctx->pml.origin );
 			VectorCopy( trace.endpos, last_valid_origin );
 		}
 
@@ -332,7 +345,7 @@ static int PM_SlideMove( void )
 			break; // move done
 
 		// save touched entity for return output
-		PM_AddTouchEnt( trace.ent );
+		PM_AddTouchEnt( ctx, trace.ent );
 
 		// at this point we are blocked but not trapped.
 
@@ -352,7 +365,7 @@ static int PM_SlideMove( void )
 		{
 			if( DotProduct( trace.plane.normal, planes[i] ) > ( 1.0f - SLIDEMOVE_PLANEINTERACT_EPSILON ) )
 			{
-				VectorAdd( trace.plane.normal, pml.velocity, pml.velocity );
+				VectorAdd( trace.plane.normal, ctx->pml.velocity, ctx->pml.velocity );
 				break;
 			}
 		}
@@ -362,7 +375,7 @@ static int PM_SlideMove( void )
 		// security check: we can't store more planes
 		if( numplanes >= MAX_CLIP_PLANES )
 		{
-			VectorClear( pml.velocity );
+			VectorClear( ctx->pml.velocity );
 			return SLIDEMOVEFLAG_TRAPPED;
 		}
 
@@ -376,53 +389,53 @@ static int PM_SlideMove( void )
 
 		for( i = 0; i < numplanes; i++ )
 		{
-			if( DotProduct( pml.velocity, planes[i] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )  // would not touch it
+			if( DotProduct( ctx->pml.velocity, planes[i] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )  // would not touch it
 				continue;
 
-			GS_ClipVelocity( pml.velocity, planes[i], pml.velocity, PM_OVERBOUNCE );
+			GS_ClipVelocity( ctx->pml.velocity, planes[i], ctx->pml.velocity, PM_OVERBOUNCE );
 			// see if we enter a second plane
 			for( j = 0; j < numplanes; j++ )
 			{
 				if( j == i )  // it's the same plane
 					continue;
-				if( DotProduct( pml.velocity, planes[j] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
+				if( DotProduct( ctx->pml.velocity, planes[j] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
 					continue; // not with this one
 
 				//there was a second one. Try to slide along it too
-				GS_ClipVelocity( pml.velocity, planes[j], pml.velocity, PM_OVERBOUNCE );
+				GS_ClipVelocity( ctx->pml.velocity, planes[j], ctx->pml.velocity, PM_OVERBOUNCE );
 
 				// check if the slide sent it back to the first plane
-				if( DotProduct( pml.velocity, planes[i] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
+				if( DotProduct( ctx->pml.velocity, planes[i] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
 					continue;
 
 				// bad luck: slide the original velocity along the crease
 				CrossProduct( planes[i], planes[j], dir );
 				VectorNormalize( dir );
-				value = DotProduct( dir, pml.velocity );
-				VectorScale( dir, value, pml.velocity );
+				value = DotProduct( dir, ctx->pml.velocity );
+				VectorScale( dir, value, ctx->pml.velocity );
 
 				// check if there is a third plane, in that case we're trapped
 				for( k = 0; k < numplanes; k++ )
 				{
 					if( j == k || i == k )  // it's the same plane
 						continue;
-					if( DotProduct( pml.velocity, planes[k] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
+					if( DotProduct( ctx->pml.velocity, planes[k] ) >= SLIDEMOVE_PLANEINTERACT_EPSILON )
 						continue; // not with this one
-					VectorClear( pml.velocity );
+					VectorClear( ctx->pml.velocity );
 					break;
 				}
 			}
 		}
 	}
 
-	if( pm->numtouch )
+	if( ctx->pm->numtouch )
 	{
-		if( pm->playerState->pmove.pm_time || ( pm->groundentity == -1 && pm->waterlevel < 2
-					&& pm->playerState->pmove.skim_time > 0 && old_velocity[2] >= pml.velocity[2] ) )
-			VectorCopy( old_velocity, pml.velocity );
-		pm->playerState->pmove.skim_time -= pm->cmd.msec;
-		if( pm->playerState->pmove.skim_time < 0 )
-			pm->playerState->pmove.skim_time = 0;
+		if( ctx->pm->playerState->pmove.pm_time || ( ctx->pm->groundentity == -1 && ctx->pm->waterlevel < 2
+					&& ctx->pm->playerState->pmove.skim_time > 0 && old_velocity[2] >= ctx->pml.velocity[2] ) )
+			VectorCopy( old_velocity, ctx->pml.velocity );
+		ctx->pm->playerState->pmove.skim_time -= ctx->pm->cmd.msec;
+		if( ctx->pm->playerState->pmove.skim_time < 0 )
+			ctx->pm->playerState->pmove.skim_time = 0;
 	}
 
 	return blockedmask;
@@ -434,7 +447,7 @@ static int PM_SlideMove( void )
 * Each intersection will try to step over the obstruction instead of
 * sliding along it.
 */
-static void PM_StepSlideMove( void )
+static void PM_StepSlideMove( pmove_context_t *ctx )
 {
 	vec3_t start_o, start_v;
 	vec3_t down_o, down_v;
@@ -444,37 +457,37 @@ static void PM_StepSlideMove( void )
 	vec3_t up, down;
 	int blocked;
 
-	VectorCopy( pml.origin, start_o );
-	VectorCopy( pml.velocity, start_v );
+	VectorCopy( ctx->pml.origin, start_o );
+	VectorCopy( ctx->pml.velocity, start_v );
 
-	blocked = PM_SlideMove();
+	blocked = PM_SlideMove( ctx );
 
-	VectorCopy( pml.origin, down_o );
-	VectorCopy( pml.velocity, down_v );
+	VectorCopy( ctx->pml.origin, down_o );
+	VectorCopy( ctx->pml.velocity, down_v );
 
 	VectorCopy( start_o, up );
 	up[2] += STEPSIZE;
 
-	module_Trace( &trace, up, pm->mins, pm->maxs, up, pm->playerState->POVnum, pm->contentmask, 0 );
+	ctx->callbacks->Trace( &trace, up, ctx->pm->mins, ctx->pm->maxs, up, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 	if( trace.allsolid )
 		return; // can't step up
 
 	// try sliding above
-	VectorCopy( up, pml.origin );
-	VectorCopy( start_v, pml.velocity );
+	VectorCopy( up, ctx->pml.origin );
+	VectorCopy( start_v, ctx->pml.velocity );
 
-	PM_SlideMove();
+	PM_SlideMove( ctx );
 
 	// push down the final amount
-	VectorCopy( pml.origin, down );
+	VectorCopy( ctx->pml.origin, down );
 	down[2] -= STEPSIZE;
-	module_Trace( &trace, pml.origin, pm->mins, pm->maxs, down, pm->playerState->POVnum, pm->contentmask, 0 );
+	ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, down, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 	if( !trace.allsolid )
 	{
-		VectorCopy( trace.endpos, pml.origin );
+		VectorCopy( trace.endpos, ctx->pml.origin );
 	}
 
-	VectorCopy( pml.origin, up );
+	VectorCopy( ctx->pml.origin, up );
 
 	// decide which one went farther
 	down_dist = ( down_o[0] - start_o[0] )*( down_o[0] - start_o[0] )
@@ -484,15 +497,15 @@ static void PM_StepSlideMove( void )
 
 	if( down_dist >= up_dist || trace.allsolid || ( trace.fraction != 1.0 && !ISWALKABLEPLANE( &trace.plane ) ) )
 	{
-		VectorCopy( down_o, pml.origin );
-		VectorCopy( down_v, pml.velocity );
+		VectorCopy( down_o, ctx->pml.origin );
+		VectorCopy( down_v, ctx->pml.velocity );
 		return;
 	}
 
 	// only add the stepping output when it was a vertical step (second case is at the exit of a ramp)
 	if( ( blocked & SLIDEMOVEFLAG_WALL_BLOCKED ) || trace.plane.normal[2] == 1.0f - SLIDEMOVE_PLANEINTERACT_EPSILON )
 	{
-		pm->step = ( pml.origin[2] - pml.previous_origin[2] );
+		ctx->pm->step = ( ctx->pml.origin[2] - ctx->pml.previous_origin[2] );
 	}
 
 	// Preserve speed when sliding up ramps
@@ -501,12 +514,12 @@ static void PM_StepSlideMove( void )
 	{
 		if( trace.plane.normal[2] >= 1.0f - SLIDEMOVE_PLANEINTERACT_EPSILON )
 		{
-			VectorCopy( start_v, pml.velocity );
+			VectorCopy( start_v, ctx->pml.velocity );
 		}
 		else
 		{
-			VectorNormalize2D( pml.velocity );
-			VectorScale2D( pml.velocity, hspeed, pml.velocity );
+			VectorNormalize2D( ctx->pml.velocity );
+			VectorScale2D( ctx->pml.velocity, hspeed, ctx->pml.velocity );
 		}
 	}
 
@@ -514,7 +527,7 @@ static void PM_StepSlideMove( void )
 
 	//!! Special case
 	// if we were walking along a plane, then we need to copy the Z over
-	pml.velocity[2] = down_v[2];
+	ctx->pml.velocity[2] = down_v[2];
 }
 
 /*
@@ -522,14 +535,14 @@ static void PM_StepSlideMove( void )
 * 
 * Handles both ground friction and water friction
 */
-static void PM_Friction( void )
+static void PM_Friction( pmove_context_t *ctx )
 {
 	float *vel;
 	float speed, newspeed, control;
 	float friction;
 	float drop;
 
-	vel = pml.velocity;
+	vel = ctx->pml.velocity;
 
 	speed = vel[0]*vel[0] +vel[1]*vel[1] + vel[2]*vel[2];
 	if( speed < 1 )
@@ -543,27 +556,27 @@ static void PM_Friction( void )
 	drop = 0;
 
 	// apply ground friction
-	if( ( ( ( ( pm->groundentity != -1 ) && !( pml.groundsurfFlags & SURF_SLICK ) ) )
-				&& ( pm->waterlevel < 2 ) ) || pml.ladder )
+	if( ( ( ( ( ctx->pm->groundentity != -1 ) && !( ctx->pml.groundsurfFlags & SURF_SLICK ) ) )
+				&& ( ctx->pm->waterlevel < 2 ) ) || ctx->pml.ladder )
 	{
-		if( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 )
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 )
 		{
 			friction = pm_friction;
 			control = speed < pm_decelerate ? pm_decelerate : speed;
-			if( pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
+			if( ctx->pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
 			{
-				if( pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] < PM_CROUCHSLIDE_FADE )
-					friction *= 1 - sqrt( (float)pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] / PM_CROUCHSLIDE_FADE );
+				if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] < PM_CROUCHSLIDE_FADE )
+					friction *= 1 - sqrt( (float)ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] / PM_CROUCHSLIDE_FADE );
 				else
 					friction = 0;
 			}
-			drop += control * friction * pml.frametime;
+			drop += control * friction * ctx->pml.frametime;
 		}
 	}
 
 	// apply water friction
-	if( ( pm->waterlevel >= 2 ) && !pml.ladder )
-		drop += speed * pm_waterfriction * pm->waterlevel * pml.frametime;
+	if( ( ctx->pm->waterlevel >= 2 ) && !ctx->pml.ladder )
+		drop += speed * pm_waterfriction * ctx->pm->waterlevel * ctx->pml.frametime;
 
 	// scale the velocity
 	newspeed = speed - drop;
@@ -584,38 +597,38 @@ static void PM_Friction( void )
 * 
 * Handles user intended acceleration
 */
-static void PM_Accelerate( vec3_t wishdir, float wishspeed, float accel )
+static void PM_Accelerate( pmove_context_t *ctx, vec3_t wishdir, float wishspeed, float accel )
 {
 	float addspeed, accelspeed, currentspeed, realspeed, newspeed;
 	bool crouchslide;
 
-	realspeed = VectorLengthFast( pml.velocity );
+	realspeed = VectorLengthFast( ctx->pml.velocity );
 
-	currentspeed = DotProduct( pml.velocity, wishdir );
+	currentspeed = DotProduct( ctx->pml.velocity, wishdir );
 	addspeed = wishspeed - currentspeed;
 	if( addspeed <= 0 )
 		return;
 
-	accelspeed = accel*pml.frametime*wishspeed;
+	accelspeed = accel*ctx->pml.frametime*wishspeed;
 	if( accelspeed > addspeed )
 		accelspeed = addspeed;
 
-	crouchslide = pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING && pm->groundentity != -1 && !( pml.groundsurfFlags & SURF_SLICK );
+	crouchslide = ctx->pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING && ctx->pm->groundentity != -1 && !( ctx->pml.groundsurfFlags & SURF_SLICK );
 
 	if( crouchslide )
 		accelspeed *= PM_CROUCHSLIDE_CONTROL;
 
-	VectorMA( pml.velocity, accelspeed, wishdir, pml.velocity );
+	VectorMA( ctx->pml.velocity, accelspeed, wishdir, ctx->pml.velocity );
 
 	if( crouchslide )
 	{ // disable overacceleration while crouch sliding
-		newspeed = VectorLengthFast( pml.velocity );
+		newspeed = VectorLengthFast( ctx->pml.velocity );
 		if( newspeed > wishspeed && newspeed != 0 )
-			VectorScale( pml.velocity, fmax( wishspeed, realspeed ) / newspeed, pml.velocity );
+			VectorScale( ctx->pml.velocity, fmax( wishspeed, realspeed ) / newspeed, ctx->pml.velocity );
 	}
 }
 
-static void PM_AirAccelerate( vec3_t wishdir, float wishspeed )
+static void PM_AirAccelerate( pmove_context_t *ctx, vec3_t wishdir, float wishspeed )
 {
 	vec3_t curvel, wishvel, acceldir, curdir;
 	float addspeed, accelspeed, curspeed;
@@ -632,28 +645,28 @@ static void PM_AirAccelerate( vec3_t wishdir, float wishspeed )
 	if( !wishspeed )
 		return;
 
-	VectorCopy( pml.velocity, curvel );
+	VectorCopy( ctx->pml.velocity, curvel );
 	curvel[2] = 0;
 	curspeed = VectorLength( curvel );
 
 	if( wishspeed > curspeed * 1.01f ) // moving below pm_maxspeed
 	{
-		accelspeed = curspeed + airforwardaccel * pml.maxPlayerSpeed * pml.frametime;
+		accelspeed = curspeed + airforwardaccel * ctx->pml.maxPlayerSpeed * ctx->pml.frametime;
 		if( accelspeed < wishspeed )
 			wishspeed = accelspeed;
 	}
 	else
 	{
-		float f = ( bunnytopspeed - curspeed ) / ( bunnytopspeed - pml.maxPlayerSpeed );
+		float f = ( bunnytopspeed - curspeed ) / ( bunnytopspeed - ctx->pml.maxPlayerSpeed );
 		if( f < 0 )
 			f = 0;
-		wishspeed = max( curspeed, pml.maxPlayerSpeed ) + bunnyaccel * f * pml.maxPlayerSpeed * pml.frametime;
+		wishspeed = max( curspeed, ctx->pml.maxPlayerSpeed ) + bunnyaccel * f * ctx->pml.maxPlayerSpeed * ctx->pml.frametime;
 	}
 	VectorScale( wishdir, wishspeed, wishvel );
 	VectorSubtract( wishvel, curvel, acceldir );
 	addspeed = VectorNormalize( acceldir );
 
-	accelspeed = turnaccel * pml.maxPlayerSpeed * pml.frametime;
+	accelspeed = turnaccel * ctx->pml.maxPlayerSpeed * ctx->pml.frametime;
 	if( accelspeed > addspeed )
 		accelspeed = addspeed;
 
@@ -665,11 +678,11 @@ static void PM_AirAccelerate( vec3_t wishdir, float wishspeed )
 			VectorMA( acceldir, -( 1.0f - backtosideratio ) * dot, curdir, acceldir );
 	}
 
-	VectorMA( pml.velocity, accelspeed, acceldir, pml.velocity );
+	VectorMA( ctx->pml.velocity, accelspeed, acceldir, ctx->pml.velocity );
 }
 
 // when using +strafe convert the inertia to forward speed.
-static void PM_Aircontrol( vec3_t wishdir, float wishspeed )
+static void PM_Aircontrol( pmove_context_t *ctx, vec3_t wishdir, float wishspeed )
 {
 	int i;
 	float zspeed, speed, dot, k;
@@ -679,52 +692,52 @@ static void PM_Aircontrol( vec3_t wishdir, float wishspeed )
 		return;
 
 	// accelerate
-	smove = pml.sidePush;
+	smove = ctx->pml.sidePush;
 
 	if( ( smove > 0 || smove < 0 ) || ( wishspeed == 0.0 ) )
 		return; // can't control movement if not moving forward or backward
 
-	zspeed = pml.velocity[2];
-	pml.velocity[2] = 0;
-	speed = VectorNormalize( pml.velocity );
+	zspeed = ctx->pml.velocity[2];
+	ctx->pml.velocity[2] = 0;
+	speed = VectorNormalize( ctx->pml.velocity );
 
 
-	dot = DotProduct( pml.velocity, wishdir );
-	k = 32.0f * pm_aircontrol * dot * dot * pml.frametime;
+	dot = DotProduct( ctx->pml.velocity, wishdir );
+	k = 32.0f * pm_aircontrol * dot * dot * ctx->pml.frametime;
 
 	if( dot > 0 )
 	{
 		// we can't change direction while slowing down
 		for( i = 0; i < 2; i++ )
-			pml.velocity[i] = pml.velocity[i] * speed + wishdir[i] * k;
+			ctx->pml.velocity[i] = ctx->pml.velocity[i] * speed + wishdir[i] * k;
 
-		VectorNormalize( pml.velocity );
+		VectorNormalize( ctx->pml.velocity );
 	}
 
 	for( i = 0; i < 2; i++ )
-		pml.velocity[i] *= speed;
+		ctx->pml.velocity[i] *= speed;
 
-	pml.velocity[2] = zspeed;
+	ctx->pml.velocity[2] = zspeed;
 }
 
 #if 0 // never used
-static void PM_AirAccelerate( vec3_t wishdir, float wishspeed, float accel )
+static void PM_AirAccelerate( pmove_context_t *ctx, vec3_t wishdir, float wishspeed, float accel )
 {
 	int i;
 	float addspeed, accelspeed, currentspeed, wishspd = wishspeed;
 
 	if( wishspd > 30 )
 		wishspd = 30;
-	currentspeed = DotProduct( pml.velocity, wishdir );
+	currentspeed = DotProduct( ctx->pml.velocity, wishdir );
 	addspeed = wishspd - currentspeed;
 	if( addspeed <= 0 )
 		return;
-	accelspeed = accel * wishspeed * pml.frametime;
+	accelspeed = accel * wishspeed * ctx->pml.frametime;
 	if( accelspeed > addspeed )
 		accelspeed = addspeed;
 
 	for( i = 0; i < 3; i++ )
-		pml.velocity[i] += accelspeed*wishdir[i];
+		ctx->pml.velocity[i] += accelspeed*wishdir[i];
 }
 #endif
 
@@ -732,21 +745,21 @@ static void PM_AirAccelerate( vec3_t wishdir, float wishspeed, float accel )
 /*
 * PM_AddCurrents
 */
-static void PM_AddCurrents( vec3_t wishvel )
+static void PM_AddCurrents( pmove_context_t *ctx, vec3_t wishvel )
 {
 	//
 	// account for ladders
 	//
 
-	if( pml.ladder && fabs( pml.velocity[2] ) <= DEFAULT_LADDERSPEED )
+	if( ctx->pml.ladder && fabs( ctx->pml.velocity[2] ) <= DEFAULT_LADDERSPEED )
 	{
-		if( ( pm->playerState->viewangles[PITCH] <= -15 ) && ( pml.forwardPush > 0 ) )
+		if( ( ctx->pm->playerState->viewangles[PITCH] <= -15 ) && ( ctx->pml.forwardPush > 0 ) )
 			wishvel[2] = DEFAULT_LADDERSPEED;
-		else if( ( pm->playerState->viewangles[PITCH] >= 15 ) && ( pml.forwardPush > 0 ) )
+		else if( ( ctx->pm->playerState->viewangles[PITCH] >= 15 ) && ( ctx->pml.forwardPush > 0 ) )
 			wishvel[2] = -DEFAULT_LADDERSPEED;
-		else if( pml.upPush > 0 )
+		else if( ctx->pml.upPush > 0 )
 			wishvel[2] = DEFAULT_LADDERSPEED;
-		else if( pml.upPush < 0 )
+		else if( ctx->pml.upPush < 0 )
 			wishvel[2] = -DEFAULT_LADDERSPEED;
 		else
 			wishvel[2] = 0;
@@ -761,7 +774,7 @@ static void PM_AddCurrents( vec3_t wishvel )
 * PM_WaterMove
 * 
 */
-static void PM_WaterMove( void )
+static void PM_WaterMove( pmove_context_t *ctx )
 {
 	int i;
 	vec3_t wishvel;
@@ -770,35 +783,35 @@ static void PM_WaterMove( void )
 
 	// user intentions
 	for( i = 0; i < 3; i++ )
-		wishvel[i] = pml.forward[i]*pml.forwardPush + pml.right[i]*pml.sidePush;
+		wishvel[i] = ctx->pml.forward[i]*ctx->pml.forwardPush + ctx->pml.right[i]*ctx->pml.sidePush;
 
-	if( !pml.forwardPush && !pml.sidePush && !pml.upPush )
+	if( !ctx->pml.forwardPush && !ctx->pml.sidePush && !ctx->pml.upPush )
 		wishvel[2] -= 60; // drift towards bottom
 	else
-		wishvel[2] += pml.upPush;
+		wishvel[2] += ctx->pml.upPush;
 
-	PM_AddCurrents( wishvel );
+	PM_AddCurrents( ctx, wishvel );
 
 	VectorCopy( wishvel, wishdir );
 	wishspeed = VectorNormalize( wishdir );
 
-	if( wishspeed > pml.maxPlayerSpeed )
+	if( wishspeed > ctx->pml.maxPlayerSpeed )
 	{
-		wishspeed = pml.maxPlayerSpeed / wishspeed;
+		wishspeed = ctx->pml.maxPlayerSpeed / wishspeed;
 		VectorScale( wishvel, wishspeed, wishvel );
-		wishspeed = pml.maxPlayerSpeed;
+		wishspeed = ctx->pml.maxPlayerSpeed;
 	}
 	wishspeed *= 0.5;
 
-	PM_Accelerate( wishdir, wishspeed, pm_wateraccelerate );
-	PM_StepSlideMove();
+	PM_Accelerate( ctx, wishdir, wishspeed, pm_wateraccelerate );
+	PM_StepSlideMove( ctx );
 }
 
 /*
 * PM_Move -- Kurim
 * 
 */
-static void PM_Move( void )
+static void PM_Move( pmove_context_t *ctx )
 {
 	int i;
 	vec3_t wishvel;
@@ -809,30 +822,30 @@ static void PM_Move( void )
 	float accel;
 	float wishspeed2;
 
-	fmove = pml.forwardPush;
-	smove = pml.sidePush;
+	fmove = ctx->pml.forwardPush;
+	smove = ctx->pml.sidePush;
 
 	for( i = 0; i < 2; i++ )
-		wishvel[i] = pml.forward[i]*fmove + pml.right[i]*smove;
+		wishvel[i] = ctx->pml.forward[i]*fmove + ctx->pml.right[i]*smove;
 	wishvel[2] = 0;
 
-	PM_AddCurrents( wishvel );
+	PM_AddCurrents( ctx, wishvel );
 
 	VectorCopy( wishvel, wishdir );
 	wishspeed = VectorNormalize( wishdir );
 
 	// clamp to server defined max speed
 
-	if( pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] )
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] )
 	{
-		maxspeed = pml.maxCrouchedSpeed;
+		maxspeed = ctx->pml.maxCrouchedSpeed;
 	}
-	else if( ( pm->cmd.buttons & BUTTON_WALK ) && ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_WALK ) )
+	else if( ( ctx->pm->cmd.buttons & BUTTON_WALK ) && ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_WALK ) )
 	{
-		maxspeed = pml.maxWalkSpeed;
+		maxspeed = ctx->pml.maxWalkSpeed;
 	}
 	else
-		maxspeed = pml.maxPlayerSpeed;
+		maxspeed = ctx->pml.maxPlayerSpeed;
 
 	if( wishspeed > maxspeed )
 	{
@@ -841,68 +854,68 @@ static void PM_Move( void )
 		wishspeed = maxspeed;
 	}
 
-	if( pml.ladder )
+	if( ctx->pml.ladder )
 	{
-		PM_Accelerate( wishdir, wishspeed, pm_accelerate );
+		PM_Accelerate( ctx, wishdir, wishspeed, pm_accelerate );
 
 		if( !wishvel[2] )
 		{
-			if( pml.velocity[2] > 0 )
+			if( ctx->pml.velocity[2] > 0 )
 			{
-				pml.velocity[2] -= pm->playerState->pmove.gravity * pml.frametime;
-				if( pml.velocity[2] < 0 )
-					pml.velocity[2]  = 0;
+				ctx->pml.velocity[2] -= ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
+				if( ctx->pml.velocity[2] < 0 )
+					ctx->pml.velocity[2]  = 0;
 			}
 			else
 			{
-				pml.velocity[2] += pm->playerState->pmove.gravity * pml.frametime;
-				if( pml.velocity[2] > 0 )
-					pml.velocity[2]  = 0;
+				ctx->pml.velocity[2] += ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
+				if( ctx->pml.velocity[2] > 0 )
+					ctx->pml.velocity[2]  = 0;
 			}
 		}
 
-		PM_StepSlideMove();
+		PM_StepSlideMove( ctx );
 	}
-	else if( pm->groundentity != -1 )
+	else if( ctx->pm->groundentity != -1 )
 	{ 
 		// walking on ground
-		if( pml.velocity[2] > 0 )
-			pml.velocity[2] = 0; //!!! this is before the accel
+		if( ctx->pml.velocity[2] > 0 )
+			ctx->pml.velocity[2] = 0; //!!! this is before the accel
 
-		PM_Accelerate( wishdir, wishspeed, pm_accelerate );
+		PM_Accelerate( ctx, wishdir, wishspeed, pm_accelerate );
 
 		// fix for negative trigger_gravity fields
-		if( pm->playerState->pmove.gravity > 0 )
+		if( ctx->pm->playerState->pmove.gravity > 0 )
 		{
-			if( pml.velocity[2] > 0 )
-				pml.velocity[2] = 0;
+			if( ctx->pml.velocity[2] > 0 )
+				ctx->pml.velocity[2] = 0;
 		}
 		else
-			pml.velocity[2] -= pm->playerState->pmove.gravity * pml.frametime;
+			ctx->pml.velocity[2] -= ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
 
-		if( !pml.velocity[0] && !pml.velocity[1] )
+		if( !ctx->pml.velocity[0] && !ctx->pml.velocity[1] )
 			return;
 
-		PM_StepSlideMove();
+		PM_StepSlideMove( ctx );
 	}
-	else if( ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_AIRCONTROL ) 
-		&& !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_FWDBUNNY ) )
+	else if( ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_AIRCONTROL ) 
+		&& !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_FWDBUNNY ) )
 	{
 		// Air Control
 		wishspeed2 = wishspeed;
-		if( DotProduct( pml.velocity, wishdir ) < 0 
-			&& !( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) 
-			&& ( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )
+		if( DotProduct( ctx->pml.velocity, wishdir ) < 0 
+			&& !( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) 
+			&& ( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )
 			accel = pm_airdecelerate;
 		else
 			accel = pm_airaccelerate;
 
 		// ch : remove knockback test here
-		if( ( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING )
-			/* || ( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) */ )
+		if( ( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING )
+			/* || ( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) */ )
 			accel = 0; // no stopmove while walljumping
 
-		if( ( smove > 0 || smove < 0 ) && !fmove && ( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )
+		if( ( smove > 0 || smove < 0 ) && !fmove && ( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )
 		{
 			if( wishspeed > pm_wishspeed )
 				wishspeed = pm_wishspeed;
@@ -910,44 +923,44 @@ static void PM_Move( void )
 		}
 
 		// Air control
-		PM_Accelerate( wishdir, wishspeed, accel );
-		if( pm_aircontrol && !( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) && ( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )  // no air ctrl while wjing
-			PM_Aircontrol( wishdir, wishspeed2 );
+		PM_Accelerate( ctx, wishdir, wishspeed, accel );
+		if( pm_aircontrol && !( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) && ( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] <= 0 ) )  // no air ctrl while wjing
+			PM_Aircontrol( ctx, wishdir, wishspeed2 );
 
 		// add gravity
-		pml.velocity[2] -= pm->playerState->pmove.gravity * pml.frametime;
-		PM_StepSlideMove();
+		ctx->pml.velocity[2] -= ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
+		PM_StepSlideMove( ctx );
 	}
 	else // air movement (old school)
 	{
 		bool inhibit = false;
 		bool accelerating, decelerating;
 
-		accelerating = ( DotProduct( pml.velocity, wishdir ) > 0.0f ) ? true : false;
-		decelerating = ( DotProduct( pml.velocity, wishdir ) < -0.0f ) ? true : false;
+		accelerating = ( DotProduct( ctx->pml.velocity, wishdir ) > 0.0f ) ? true : false;
+		decelerating = ( DotProduct( ctx->pml.velocity, wishdir ) < -0.0f ) ? true : false;
 		
-		if( ( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) &&
-			( pm->playerState->pmove.stats[PM_STAT_WJTIME] >= ( PM_WALLJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
+		if( ( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) &&
+			( ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] >= ( PM_WALLJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
 			inhibit = true;
 
-		if( ( pm->playerState->pmove.pm_flags & PMF_DASHING ) &&
-			( pm->playerState->pmove.stats[PM_STAT_DASHTIME] >= ( PM_DASHJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
+		if( ( ctx->pm->playerState->pmove.pm_flags & PMF_DASHING ) &&
+			( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] >= ( PM_DASHJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
 			inhibit = true;
 
-		if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_FWDBUNNY ) ||
-			pm->playerState->pmove.stats[PM_STAT_FWDTIME] > 0 )
+		if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_FWDBUNNY ) ||
+			ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] > 0 )
 			inhibit = true;
 
 		// ch : remove this because of the knockback 'bug'?
 		/*
-		if( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 )
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 )
 			inhibit = true;
 		*/
 
 		// (aka +fwdbunny) pressing forward or backward but not pressing strafe and not dashing
 		if( accelerating && !inhibit && !smove && fmove )
 		{
-			PM_AirAccelerate( wishdir, wishspeed );
+			PM_AirAccelerate( ctx, wishdir, wishspeed );
 		}
 		else // strafe running
 		{
@@ -955,24 +968,24 @@ static void PM_Move( void )
 
 			wishspeed2 = wishspeed;
 			if( decelerating && 
-				!( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) )
+				!( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) )
 				accel = pm_airdecelerate;
 			else
 				accel = pm_airaccelerate;
 
 			// ch : knockback out
-			if( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING 
-			/*	|| ( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) */ )
+			if( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING 
+			/*	|| ( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) */ )
 			{
 				accel = 0; // no stop-move while wall-jumping
 				aircontrol = false;
 			}
 
-			if( ( pm->playerState->pmove.pm_flags & PMF_DASHING ) &&
-				( pm->playerState->pmove.stats[PM_STAT_DASHTIME] >= ( PM_DASHJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
+			if( ( ctx->pm->playerState->pmove.pm_flags & PMF_DASHING ) &&
+				( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] >= ( PM_DASHJUMP_TIMEDELAY - PM_AIRCONTROL_BOUNCE_DELAY ) ) )
 				aircontrol = false;
 
-			if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_AIRCONTROL ) )
+			if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_AIRCONTROL ) )
 				aircontrol = false;
 
 			// +strafe bunnyhopping
@@ -981,18 +994,18 @@ static void PM_Move( void )
 				if( wishspeed > pm_wishspeed )
 					wishspeed = pm_wishspeed;
 
-				PM_Accelerate( wishdir, wishspeed, pm_strafebunnyaccel );
-				PM_Aircontrol( wishdir, wishspeed2 );
+				PM_Accelerate( ctx, wishdir, wishspeed, pm_strafebunnyaccel );
+				PM_Aircontrol( ctx, wishdir, wishspeed2 );
 			}
 			else // standard movement (includes strafejumping)
 			{
-				PM_Accelerate( wishdir, wishspeed, accel );
+				PM_Accelerate( ctx, wishdir, wishspeed, accel );
 			}
 		}
 
 		// add gravity
-		pml.velocity[2] -= pm->playerState->pmove.gravity * pml.frametime;
-		PM_StepSlideMove();
+		ctx->pml.velocity[2] -= ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
+		PM_StepSlideMove( ctx );
 	}
 }
 
@@ -1000,7 +1013,7 @@ static void PM_Move( void )
 /*
 * PM_CategorizePosition
 */
-static void PM_CategorizePosition( void )
+static void PM_CategorizePosition( pmove_context_t *ctx )
 {
 	vec3_t point;
 	int cont;
@@ -1011,453 +1024,453 @@ static void PM_CategorizePosition( void )
 	// if the player hull point one-quarter unit down is solid, the player is on ground
 
 	// see if standing on something solid
-	point[0] = pml.origin[0];
-	point[1] = pml.origin[1];
-	point[2] = pml.origin[2] - 0.25;
+	point[0] = ctx->pml.origin[0];
+	point[1] = ctx->pml.origin[1];
+	point[2] = ctx->pml.origin[2] - 0.25;
 
-	if( pml.velocity[2] > 180 ) // !!ZOID changed from 100 to 180 (ramp accel)
+	if( ctx->pml.velocity[2] > 180 ) // !!ZOID changed from 100 to 180 (ramp accel)
 	{
-		pm->playerState->pmove.pm_flags &= ~PMF_ON_GROUND;
-		pm->groundentity = -1;
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_ON_GROUND;
+		ctx->pm->groundentity = -1;
 	}
 	else
 	{
-		module_Trace( &trace, pml.origin, pm->mins, pm->maxs, point, pm->playerState->POVnum, pm->contentmask, 0 );
-		pml.groundplane = trace.plane;
-		pml.groundsurfFlags = trace.surfFlags;
-		pml.groundcontents = trace.contents;
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, point, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
+		ctx->pml.groundplane = trace.plane;
+		ctx->pml.groundsurfFlags = trace.surfFlags;
+		ctx->pml.groundcontents = trace.contents;
 
 		if( ( trace.fraction == 1 ) || ( !ISWALKABLEPLANE( &trace.plane ) && !trace.startsolid ) )
 		{
-			pm->groundentity = -1;
-			pm->playerState->pmove.pm_flags &= ~PMF_ON_GROUND;
+			ctx->pm->groundentity = -1;
+			ctx->pm->playerState->pmove.pm_flags &= ~PMF_ON_GROUND;
 		}
 		else
 		{
-			pm->groundentity = trace.ent;
+			ctx->pm->groundentity = trace.ent;
 
 			// hitting solid ground will end a waterjump
-			if( pm->playerState->pmove.pm_flags & PMF_TIME_WATERJUMP )
+			if( ctx->pm->playerState->pmove.pm_flags & PMF_TIME_WATERJUMP )
 			{
-				pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
-				pm->playerState->pmove.pm_time = 0;
+				ctx->pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
+				ctx->pm->playerState->pmove.pm_time = 0;
 			}
 
-			if( !( pm->playerState->pmove.pm_flags & PMF_ON_GROUND ) )
+			if( !( ctx->pm->playerState->pmove.pm_flags & PMF_ON_GROUND ) )
 			{ // just hit the ground
-				pm->playerState->pmove.pm_flags |= PMF_ON_GROUND;
+				ctx->pm->playerState->pmove.pm_flags |= PMF_ON_GROUND;
 			}
 		}
 
-		if( ( pm->numtouch < MAXTOUCH ) && ( trace.fraction < 1.0 ) )
+		if( ( ctx->pm->numtouch < MAXTOUCH ) && ( trace.fraction < 1.0 ) )
 		{
-			pm->touchents[pm->numtouch] = trace.ent;
-			pm->numtouch++;
+			ctx->pm->touchents[ctx->pm->numtouch] = trace.ent;
+			ctx->pm->numtouch++;
 		}
 	}
 
 	//
 	// get waterlevel, accounting for ducking
 	//
-	pm->waterlevel = 0;
-	pm->watertype = 0;
+	ctx->pm->waterlevel = 0;
+	ctx->pm->watertype = 0;
 
-	sample2 = pm->playerState->viewheight - pm->mins[2];
+	sample2 = ctx->pm->playerState->viewheight - ctx->pm->mins[2];
 	sample1 = sample2 / 2;
 
-	point[2] = pml.origin[2] + pm->mins[2] + 1;
-	cont = module_PointContents( point, 0 );
+	point[2] = ctx->pml.origin[2] + ctx->pm->mins[2] + 1;
+	cont = ctx->callbacks->PointContents( point, 0 );
 
 	if( cont & MASK_WATER )
 	{
-		pm->watertype = cont;
-		pm->waterlevel = 1;
-		point[2] = pml.origin[2] + pm->mins[2] + sample1;
-		cont = module_PointContents( point, 0 );
+		ctx->pm->watertype = cont;
+		ctx->pm->waterlevel = 1;
+		point[2] = ctx->pml.origin[2] + ctx->pm->mins[2] + sample1;
+		cont = ctx->callbacks->PointContents( point, 0 );
 		if( cont & MASK_WATER )
 		{
-			pm->waterlevel = 2;
-			point[2] = pml.origin[2] + pm->mins[2] + sample2;
-			cont = module_PointContents( point, 0 );
+			ctx->pm->waterlevel = 2;
+			point[2] = ctx->pml.origin[2] + ctx->pm->mins[2] + sample2;
+			cont = ctx->callbacks->PointContents( point, 0 );
 			if( cont & MASK_WATER )
-				pm->waterlevel = 3;
+				ctx->pm->waterlevel = 3;
 		}
 	}
 }
 
-static void PM_ClearDash( void )
+static void PM_ClearDash( pmove_context_t *ctx )
 {
-	pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
-	pm->playerState->pmove.stats[PM_STAT_DASHTIME] = 0;
+	ctx->pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
+	ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] = 0;
 }
 
-static void PM_ClearWallJump( void )
+static void PM_ClearWallJump( pmove_context_t *ctx )
 {
-	pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
-	pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
-	pm->playerState->pmove.stats[PM_STAT_WJTIME] = 0;
+	ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
+	ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
+	ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] = 0;
 }
 
-static void PM_ClearStun( void )
+static void PM_ClearStun( pmove_context_t *ctx )
 {
-	pm->playerState->pmove.stats[PM_STAT_STUN] = 0;
+	ctx->pm->playerState->pmove.stats[PM_STAT_STUN] = 0;
 }
 
 /*
 * PM_CheckJump
 */
-static void PM_CheckJump( void )
+static void PM_CheckJump( pmove_context_t *ctx )
 {
-	if( pml.upPush < 10 )
+	if( ctx->pml.upPush < 10 )
 	{ 
 		// not holding jump
-		if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
-			pm->playerState->pmove.pm_flags &= ~PMF_JUMP_HELD;
+		if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
+			ctx->pm->playerState->pmove.pm_flags &= ~PMF_JUMP_HELD;
 
 		return;
 	}
 
-	if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
+	if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
 	{
 		// must wait for jump to be released
-		if( pm->playerState->pmove.pm_flags & PMF_JUMP_HELD )
+		if( ctx->pm->playerState->pmove.pm_flags & PMF_JUMP_HELD )
 			return;
 	}
 
-	if( pm->playerState->pmove.pm_type != PM_NORMAL )
+	if( ctx->pm->playerState->pmove.pm_type != PM_NORMAL )
 		return;
 
-	if( pm->waterlevel >= 2 )
+	if( ctx->pm->waterlevel >= 2 )
 	{ // swimming, not jumping
-		pm->groundentity = -1;
+		ctx->pm->groundentity = -1;
 		return;
 	}
 
-	if( pm->groundentity == -1 )
+	if( ctx->pm->groundentity == -1 )
 		return;
 
-	if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_JUMP ) )
+	if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_JUMP ) )
 		return;
 
-	if( !( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
-		pm->playerState->pmove.pm_flags |= PMF_JUMP_HELD;
+	if( !( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CONTINOUSJUMP ) )
+		ctx->pm->playerState->pmove.pm_flags |= PMF_JUMP_HELD;
 
-	pm->groundentity = -1;
+	ctx->pm->groundentity = -1;
 
 	// clip against the ground when jumping if moving that direction
-	if( pml.groundplane.normal[2] > 0 && pml.velocity[2] < 0 && DotProduct2D( pml.groundplane.normal, pml.velocity ) > 0 )
-		GS_ClipVelocity( pml.velocity, pml.groundplane.normal, pml.velocity, PM_OVERBOUNCE );
+	if( ctx->pml.groundplane.normal[2] > 0 && ctx->pml.velocity[2] < 0 && DotProduct2D( ctx->pml.groundplane.normal, ctx->pml.velocity ) > 0 )
+		GS_ClipVelocity( ctx->pml.velocity, ctx->pml.groundplane.normal, ctx->pml.velocity, PM_OVERBOUNCE );
 
-	pm->playerState->pmove.skim_time = PM_SKIM_TIME;
+	ctx->pm->playerState->pmove.skim_time = PM_SKIM_TIME;
 
-	//if( gs.module == GS_MODULE_GAME ) GS_Printf( "upvel %f\n", pml.velocity[2] );
-	if( pml.velocity[2] > 100 )
+	//if( gs.module == GS_MODULE_GAME ) GS_Printf( "upvel %f\n", ctx->pml.velocity[2] );
+	if( ctx->pml.velocity[2] > 100 )
 	{
-		module_PredictedEvent( pm->playerState->POVnum, EV_DOUBLEJUMP, 0 );
-		pml.velocity[2] += pml.jumpPlayerSpeed;
+		ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_DOUBLEJUMP, 0 );
+		ctx->pml.velocity[2] += ctx->pml.jumpPlayerSpeed;
 	}
-	else if( pml.velocity[2] > 0 )
+	else if( ctx->pml.velocity[2] > 0 )
 	{
-		module_PredictedEvent( pm->playerState->POVnum, EV_JUMP, 0 );
-		pml.velocity[2] += pml.jumpPlayerSpeed;
+		ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_JUMP, 0 );
+		ctx->pml.velocity[2] += ctx->pml.jumpPlayerSpeed;
 	}
 	else
 	{
-		module_PredictedEvent( pm->playerState->POVnum, EV_JUMP, 0 );
-		pml.velocity[2] = pml.jumpPlayerSpeed;
+		ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_JUMP, 0 );
+		ctx->pml.velocity[2] = ctx->pml.jumpPlayerSpeed;
 	}
 
 	// remove wj count
-	pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
-	PM_ClearDash();
-	PM_ClearWallJump();
+	ctx->pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
+	PM_ClearDash( ctx );
+	PM_ClearWallJump( ctx );
 }
 
 /*
 * PM_CheckDash -- by Kurim
 */
-static void PM_CheckDash( void )
+static void PM_CheckDash( pmove_context_t *ctx )
 {
 	float actual_velocity;
 	float upspeed;
 	vec3_t dashdir;
 
-	if( !( pm->cmd.buttons & BUTTON_SPECIAL ) )
-		pm->playerState->pmove.pm_flags &= ~PMF_SPECIAL_HELD;
+	if( !( ctx->pm->cmd.buttons & BUTTON_SPECIAL ) )
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_SPECIAL_HELD;
 
-	if( pm->playerState->pmove.pm_type != PM_NORMAL )
+	if( ctx->pm->playerState->pmove.pm_type != PM_NORMAL )
 		return;
 
-	if( pm->playerState->pmove.stats[PM_STAT_DASHTIME] > 0 )
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] > 0 )
 		return;
 
-	if( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) // can not start a new dash during knockback time
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 ) // can not start a new dash during knockback time
 		return;
 
-	if( ( pm->cmd.buttons & BUTTON_SPECIAL ) && pm->groundentity != -1 
-		&& ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_DASH ) )
+	if( ( ctx->pm->cmd.buttons & BUTTON_SPECIAL ) && ctx->pm->groundentity != -1 
+		&& ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_DASH ) )
 	{
-		if( pm->playerState->pmove.pm_flags & PMF_SPECIAL_HELD )
+		if( ctx->pm->playerState->pmove.pm_flags & PMF_SPECIAL_HELD )
 			return;
 
-		pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
-		PM_ClearWallJump();
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
+		PM_ClearWallJump( ctx );
 
-		pm->playerState->pmove.pm_flags |= PMF_DASHING;
-		pm->playerState->pmove.pm_flags |= PMF_SPECIAL_HELD;
-		pm->groundentity = -1;
+		ctx->pm->playerState->pmove.pm_flags |= PMF_DASHING;
+		ctx->pm->playerState->pmove.pm_flags |= PMF_SPECIAL_HELD;
+		ctx->pm->groundentity = -1;
 
 		// clip against the ground when jumping if moving that direction
-		if( pml.groundplane.normal[2] > 0 && pml.velocity[2] < 0 && DotProduct2D( pml.groundplane.normal, pml.velocity ) > 0 )
-			GS_ClipVelocity( pml.velocity, pml.groundplane.normal, pml.velocity, PM_OVERBOUNCE );
+		if( ctx->pml.groundplane.normal[2] > 0 && ctx->pml.velocity[2] < 0 && DotProduct2D( ctx->pml.groundplane.normal, ctx->pml.velocity ) > 0 )
+			GS_ClipVelocity( ctx->pml.velocity, ctx->pml.groundplane.normal, ctx->pml.velocity, PM_OVERBOUNCE );
 
-		if( pml.velocity[2] <= 0.0f )
+		if( ctx->pml.velocity[2] <= 0.0f )
 			upspeed = pm_dashupspeed;
 		else
-			upspeed = pm_dashupspeed + pml.velocity[2];
+			upspeed = pm_dashupspeed + ctx->pml.velocity[2];
 
 		// ch : we should do explicit forwardPush here, and ignore sidePush ?
-		VectorMA( vec3_origin, pml.forwardPush, pml.flatforward, dashdir );
-		VectorMA( dashdir, pml.sidePush, pml.right, dashdir );
+		VectorMA( vec3_origin, ctx->pml.forwardPush, ctx->pml.flatforward, dashdir );
+		VectorMA( dashdir, ctx->pml.sidePush, ctx->pml.right, dashdir );
 		dashdir[2] = 0.0;
 
 		if( VectorLength( dashdir ) < 0.01f )  // if not moving, dash like a "forward dash"
-			VectorCopy( pml.flatforward, dashdir );
+			VectorCopy( ctx->pml.flatforward, dashdir );
 
 		VectorNormalizeFast( dashdir );
 
-		actual_velocity = VectorNormalize2D( pml.velocity );
-		if( actual_velocity <= pml.dashPlayerSpeed )
-			VectorScale( dashdir, pml.dashPlayerSpeed, dashdir );
+		actual_velocity = VectorNormalize2D( ctx->pml.velocity );
+		if( actual_velocity <= ctx->pml.dashPlayerSpeed )
+			VectorScale( dashdir, ctx->pml.dashPlayerSpeed, dashdir );
 		else
 			VectorScale( dashdir, actual_velocity, dashdir );
 
-		VectorCopy( dashdir, pml.velocity );
-		pml.velocity[2] = upspeed;
+		VectorCopy( dashdir, ctx->pml.velocity );
+		ctx->pml.velocity[2] = upspeed;
 
-		pm->playerState->pmove.stats[PM_STAT_DASHTIME] = PM_DASHJUMP_TIMEDELAY;
+		ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] = PM_DASHJUMP_TIMEDELAY;
 
-		pm->playerState->pmove.skim_time = PM_SKIM_TIME;
+		ctx->pm->playerState->pmove.skim_time = PM_SKIM_TIME;
 
 		// return sound events
-		if( fabs( pml.sidePush ) > 10 && fabs( pml.sidePush ) >= fabs( pml.forwardPush ) )
+		if( fabs( ctx->pml.sidePush ) > 10 && fabs( ctx->pml.sidePush ) >= fabs( ctx->pml.forwardPush ) )
 		{
-			if( pml.sidePush > 0 )
+			if( ctx->pml.sidePush > 0 )
 			{
-				module_PredictedEvent( pm->playerState->POVnum, EV_DASH, 2 );
+				ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_DASH, 2 );
 			}
 			else
 			{
-				module_PredictedEvent( pm->playerState->POVnum, EV_DASH, 1 );
+				ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_DASH, 1 );
 			}
 		}
-		else if( pml.forwardPush < -10 )
+		else if( ctx->pml.forwardPush < -10 )
 		{
-			module_PredictedEvent( pm->playerState->POVnum, EV_DASH, 3 );
+			ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_DASH, 3 );
 		}
 		else
 		{
-			module_PredictedEvent( pm->playerState->POVnum, EV_DASH, 0 );
+			ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_DASH, 0 );
 		}
 	}
-	else if( pm->groundentity == -1 )
-		pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
+	else if( ctx->pm->groundentity == -1 )
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
 }
 
 /*
 * PM_CheckWallJump -- By Kurim
 */
-static void PM_CheckWallJump( void )
+static void PM_CheckWallJump( pmove_context_t *ctx )
 {
 	vec3_t normal;
 	float hspeed;
 
-	if( !( pm->cmd.buttons & BUTTON_SPECIAL ) )
-		pm->playerState->pmove.pm_flags &= ~PMF_SPECIAL_HELD;
+	if( !( ctx->pm->cmd.buttons & BUTTON_SPECIAL ) )
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_SPECIAL_HELD;
 
-	if( pm->groundentity != -1 )
+	if( ctx->pm->groundentity != -1 )
 	{
-		pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
-		pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
 	}
 
-	if( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING && pml.velocity[2] < 0.0 )
-		pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
+	if( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING && ctx->pml.velocity[2] < 0.0 )
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
 
-	if( pm->playerState->pmove.stats[PM_STAT_WJTIME] <= 0 )  // reset the wj count after wj delay
-		pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] <= 0 )  // reset the wj count after wj delay
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPCOUNT;
 
-	if( pm->playerState->pmove.pm_type != PM_NORMAL )
+	if( ctx->pm->playerState->pmove.pm_type != PM_NORMAL )
 		return;
 
 	// don't walljump in the first 100 milliseconds of a dash jump
-	if( pm->playerState->pmove.pm_flags & PMF_DASHING 
-		&& ( pm->playerState->pmove.stats[PM_STAT_DASHTIME] > ( PM_DASHJUMP_TIMEDELAY - 100 ) ) )
+	if( ctx->pm->playerState->pmove.pm_flags & PMF_DASHING 
+		&& ( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] > ( PM_DASHJUMP_TIMEDELAY - 100 ) ) )
 		return;
 
 	
 	// markthis
 
-	if( pm->groundentity == -1 && ( pm->cmd.buttons & BUTTON_SPECIAL ) 
-		&& ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_WALLJUMP ) &&
-		( !( pm->playerState->pmove.pm_flags & PMF_WALLJUMPCOUNT ) )
-		&& pm->playerState->pmove.stats[PM_STAT_WJTIME] <= 0
+	if( ctx->pm->groundentity == -1 && ( ctx->pm->cmd.buttons & BUTTON_SPECIAL ) 
+		&& ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_WALLJUMP ) &&
+		( !( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPCOUNT ) )
+		&& ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] <= 0
 		)
 	{
 		trace_t trace;
 		vec3_t point;
 
-		point[0] = pml.origin[0];
-		point[1] = pml.origin[1];
-		point[2] = pml.origin[2] - STEPSIZE;
+		point[0] = ctx->pml.origin[0];
+		point[1] = ctx->pml.origin[1];
+		point[2] = ctx->pml.origin[2] - STEPSIZE;
 
 		// don't walljump if our height is smaller than a step 
 		// unless jump is pressed or the player is moving faster than dash speed and upwards
-		hspeed = VectorLengthFast( tv( pml.velocity[0], pml.velocity[1], 0 ) );
-		module_Trace( &trace, pml.origin, pm->mins, pm->maxs, point, pm->playerState->POVnum, pm->contentmask, 0 );
+		hspeed = VectorLength2DFast( ctx->pml.velocity );
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, point, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 		
-		if( pml.upPush >= 10
-			|| ( hspeed > pm->playerState->pmove.stats[PM_STAT_DASHSPEED] && pml.velocity[2] > 8 )
+		if( ctx->pml.upPush >= 10
+			|| ( hspeed > ctx->pm->playerState->pmove.stats[PM_STAT_DASHSPEED] && ctx->pml.velocity[2] > 8 )
 			|| ( trace.fraction == 1 ) || ( !ISWALKABLEPLANE( &trace.plane ) && !trace.startsolid ) )
 		{
 			VectorClear( normal );
-			PlayerTouchWall( 20, 0.3f, &normal );
+			PlayerTouchWall( ctx, 20, 0.3f, &normal );
 			if( !VectorLength( normal ) )
 				return;
 
-			if( !( pm->playerState->pmove.pm_flags & PMF_SPECIAL_HELD ) 
-				&& !( pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) )
+			if( !( ctx->pm->playerState->pmove.pm_flags & PMF_SPECIAL_HELD ) 
+				&& !( ctx->pm->playerState->pmove.pm_flags & PMF_WALLJUMPING ) )
 			{
-				float oldupvelocity = pml.velocity[2];
-				pml.velocity[2] = 0.0;
+				float oldupvelocity = ctx->pml.velocity[2];
+				ctx->pml.velocity[2] = 0.0;
 
-				hspeed = VectorNormalize2D( pml.velocity );
+				hspeed = VectorNormalize2D( ctx->pml.velocity );
 
 				// if stunned almost do nothing
-				if( pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
+				if( ctx->pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
 				{
-					GS_ClipVelocity( pml.velocity, normal, pml.velocity, 1.0f );
-					VectorMA( pml.velocity, pm_failedwjbouncefactor, normal, pml.velocity );
+					GS_ClipVelocity( ctx->pml.velocity, normal, ctx->pml.velocity, 1.0f );
+					VectorMA( ctx->pml.velocity, pm_failedwjbouncefactor, normal, ctx->pml.velocity );
 
-					VectorNormalize( pml.velocity );
+					VectorNormalize( ctx->pml.velocity );
 
-					VectorScale( pml.velocity, hspeed, pml.velocity );
-					pml.velocity[2] = ( oldupvelocity + pm_failedwjupspeed > pm_failedwjupspeed ) ? oldupvelocity : oldupvelocity + pm_failedwjupspeed;
+					VectorScale( ctx->pml.velocity, hspeed, ctx->pml.velocity );
+					ctx->pml.velocity[2] = ( oldupvelocity + pm_failedwjupspeed > pm_failedwjupspeed ) ? oldupvelocity : oldupvelocity + pm_failedwjupspeed;
 				}
 				else
 				{
-					GS_ClipVelocity( pml.velocity, normal, pml.velocity, 1.0005f );
-					VectorMA( pml.velocity, pm_wjbouncefactor, normal, pml.velocity );
+					GS_ClipVelocity( ctx->pml.velocity, normal, ctx->pml.velocity, 1.0005f );
+					VectorMA( ctx->pml.velocity, pm_wjbouncefactor, normal, ctx->pml.velocity );
 
 					if( hspeed < pm_wjminspeed )
 						hspeed = pm_wjminspeed;
 
-					VectorNormalize( pml.velocity );
+					VectorNormalize( ctx->pml.velocity );
 
-					VectorScale( pml.velocity, hspeed, pml.velocity );
-					pml.velocity[2] = ( oldupvelocity > pm_wjupspeed ) ? oldupvelocity : pm_wjupspeed; // jal: if we had a faster upwards speed, keep it
+					VectorScale( ctx->pml.velocity, hspeed, ctx->pml.velocity );
+					ctx->pml.velocity[2] = ( oldupvelocity > pm_wjupspeed ) ? oldupvelocity : pm_wjupspeed; // jal: if we had a faster upwards speed, keep it
 				}
 
 				// set the walljumping state
-				PM_ClearDash();
-				pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
+				PM_ClearDash( ctx );
+				ctx->pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
 
-				pm->playerState->pmove.pm_flags |= PMF_WALLJUMPING;
-				pm->playerState->pmove.pm_flags |= PMF_SPECIAL_HELD;
+				ctx->pm->playerState->pmove.pm_flags |= PMF_WALLJUMPING;
+				ctx->pm->playerState->pmove.pm_flags |= PMF_SPECIAL_HELD;
 
-				pm->playerState->pmove.pm_flags |= PMF_WALLJUMPCOUNT;
+				ctx->pm->playerState->pmove.pm_flags |= PMF_WALLJUMPCOUNT;
 
-				if( pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
+				if( ctx->pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
 				{
-					pm->playerState->pmove.stats[PM_STAT_WJTIME] = PM_WALLJUMP_FAILED_TIMEDELAY;
+					ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] = PM_WALLJUMP_FAILED_TIMEDELAY;
 
 					// Create the event
-					module_PredictedEvent( pm->playerState->POVnum, EV_WALLJUMP_FAILED, DirToByte( normal ) );
+					ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_WALLJUMP_FAILED, DirToByte( normal ) );
 				}
 				else
 				{
-					pm->playerState->pmove.stats[PM_STAT_WJTIME] = PM_WALLJUMP_TIMEDELAY;
-					pm->playerState->pmove.skim_time = PM_SKIM_TIME;
+					ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] = PM_WALLJUMP_TIMEDELAY;
+					ctx->pm->playerState->pmove.skim_time = PM_SKIM_TIME;
 
 					// Create the event
-					module_PredictedEvent( pm->playerState->POVnum, EV_WALLJUMP, DirToByte( normal ) );
+					ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_WALLJUMP, DirToByte( normal ) );
 				}
 			}
 		}
 	}
 	else
-		pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_WALLJUMPING;
 }
 
 /*
 * PM_CheckCrouchSlide
 */
-static void PM_CheckCrouchSlide( void )
+static void PM_CheckCrouchSlide( pmove_context_t *ctx )
 {
-	if( pml.upPush < 0 && VectorLengthFast( tv( pml.velocity[0], pml.velocity[1], 0 ) ) > pml.maxWalkSpeed )
+	if( ctx->pml.upPush < 0 && VectorLength2DFast( ctx->pml.velocity ) > ctx->pml.maxWalkSpeed )
 	{
-		if( pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] > 0 )
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] > 0 )
 			return; // cooldown or already sliding
 
-		if( pm->groundentity != -1 )
+		if( ctx->pm->groundentity != -1 )
 			return; // already on the ground
 
 		// start sliding when we land
-		pm->playerState->pmove.pm_flags |= PMF_CROUCH_SLIDING;
-		pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = PM_CROUCHSLIDE + PM_CROUCHSLIDE_FADE;
+		ctx->pm->playerState->pmove.pm_flags |= PMF_CROUCH_SLIDING;
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = PM_CROUCHSLIDE + PM_CROUCHSLIDE_FADE;
 	}
-	else if( pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
+	else if( ctx->pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
 	{
-		pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = min( pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME], PM_CROUCHSLIDE_FADE );
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = min( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME], PM_CROUCHSLIDE_FADE );
 	}
 }
 
 /*
 * PM_CheckSpecialMovement
 */
-static void PM_CheckSpecialMovement( void )
+static void PM_CheckSpecialMovement( pmove_context_t *ctx )
 {
 	vec3_t spot;
 	int cont;
 	trace_t	trace;
 
-	if( pm->playerState->pmove.pm_time )
+	if( ctx->pm->playerState->pmove.pm_time )
 		return;
 
-	pml.ladder = false;
+	ctx->pml.ladder = false;
 
 	// check for ladder
-	VectorMA( pml.origin, 1, pml.flatforward, spot );
-	module_Trace( &trace, pml.origin, pm->mins, pm->maxs, spot, pm->playerState->POVnum, pm->contentmask, 0 );
+	VectorMA( ctx->pml.origin, 1, ctx->pml.flatforward, spot );
+	ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, spot, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 	if( ( trace.fraction < 1 ) && ( trace.surfFlags & SURF_LADDER ) )
-		pml.ladder = true;
+		ctx->pml.ladder = true;
 
 	// check for water jump
-	if( pm->waterlevel != 2 )
+	if( ctx->pm->waterlevel != 2 )
 		return;
 
-	VectorMA( pml.origin, 30, pml.flatforward, spot );
+	VectorMA( ctx->pml.origin, 30, ctx->pml.flatforward, spot );
 	spot[2] += 4;
-	cont = module_PointContents( spot, 0 );
+	cont = ctx->callbacks->PointContents( spot, 0 );
 	if( !( cont & CONTENTS_SOLID ) )
 		return;
 
 	spot[2] += 16;
-	cont = module_PointContents( spot, 0 );
+	cont = ctx->callbacks->PointContents( spot, 0 );
 	if( cont )
 		return;
 	// jump out of water
-	VectorScale( pml.flatforward, 50, pml.velocity );
-	pml.velocity[2] = 350;
+	VectorScale( ctx->pml.flatforward, 50, ctx->pml.velocity );
+	ctx->pml.velocity[2] = 350;
 
-	pm->playerState->pmove.pm_flags |= PMF_TIME_WATERJUMP;
-	pm->playerState->pmove.pm_time = 255;
+	ctx->pm->playerState->pmove.pm_flags |= PMF_TIME_WATERJUMP;
+	ctx->pm->playerState->pmove.pm_time = 255;
 }
 
 /*
 * PM_FlyMove
 */
-static void PM_FlyMove( bool doclip )
+static void PM_FlyMove( pmove_context_t *ctx, bool doclip )
 {
 	float speed, drop, friction, control, newspeed;
 	float currentspeed, addspeed, accelspeed, maxspeed;
@@ -1470,9 +1483,9 @@ static void PM_FlyMove( bool doclip )
 	trace_t	trace;
 
 	// Qrace - Increase maxspeed for accelerating
-	speed = VectorLength(pml.velocity);
-	if (speed < pml.maxPlayerSpeed)
-		maxspeed = pml.maxPlayerSpeed * 1.5f;
+	speed = VectorLength(ctx->pml.velocity);
+	if (speed < ctx->pml.maxPlayerSpeed)
+		maxspeed = ctx->pml.maxPlayerSpeed * 1.5f;
 	else
 		maxspeed = speed + 50.0f;
 	if (maxspeed > PM_FLYMOVE_SPEED)
@@ -1480,10 +1493,10 @@ static void PM_FlyMove( bool doclip )
 	// !Qrace
 
 	// friction
-	speed = VectorLength( pml.velocity );
+	speed = VectorLength( ctx->pml.velocity );
 	if( speed < 1 )
 	{
-		VectorClear( pml.velocity );
+		VectorClear( ctx->pml.velocity );
 	}
 	else
 	{
@@ -1491,7 +1504,7 @@ static void PM_FlyMove( bool doclip )
 
 		friction = pm_friction * 0.1f; // Qrace - old friction 1.5
 		control = speed < pm_decelerate ? pm_decelerate : speed;
-		drop += control * friction * pml.frametime;
+		drop += control * friction * ctx->pml.frametime;
 
 		// scale the velocity
 		newspeed = speed - drop;
@@ -1500,171 +1513,171 @@ static void PM_FlyMove( bool doclip )
 		newspeed /= speed;
 
 		// Qrace - only apply friction if special held without a movement key
-		if (pml.forwardPush == 0 && pml.sidePush == 0 && pm->cmd.buttons & BUTTON_SPECIAL)
-			VectorScale(pml.velocity, newspeed, pml.velocity);
+		if (ctx->pml.forwardPush == 0 && ctx->pml.sidePush == 0 && ctx->pm->cmd.buttons & BUTTON_SPECIAL)
+			VectorScale(ctx->pml.velocity, newspeed, ctx->pml.velocity);
 		// !Qrace
 	}
 
 	// accelerate
-	fmove = pml.forwardPush;
-	smove = pml.sidePush;
+	fmove = ctx->pml.forwardPush;
+	smove = ctx->pml.sidePush;
 
-	if( pm->cmd.buttons & BUTTON_SPECIAL )
+	if( ctx->pm->cmd.buttons & BUTTON_SPECIAL )
 	{
 		// Qrace - constantly accelerate w/ +special
 		float fdot, sdot;
 
-		fdot = DotProduct(pml.forward, pml.velocity);
+		fdot = DotProduct(ctx->pml.forward, ctx->pml.velocity);
 		if (fmove * fdot > 0)
-			fmove = 2 * (pml.forwardPush + fdot);
+			fmove = 2 * (ctx->pml.forwardPush + fdot);
 		else
-			fmove = fdot > (pml.forwardPush * 2) ? fdot : pml.forwardPush * 2;
+			fmove = fdot > (ctx->pml.forwardPush * 2) ? fdot : ctx->pml.forwardPush * 2;
 
-		sdot = DotProduct(pml.right, pml.velocity);
+		sdot = DotProduct(ctx->pml.right, ctx->pml.velocity);
 		if (smove * sdot > 0)
-			smove = 2 * (pml.sidePush + sdot);
+			smove = 2 * (ctx->pml.sidePush + sdot);
 		else
-			smove = sdot > (pml.sidePush * 2) ? sdot : pml.sidePush * 2;
+			smove = sdot > (ctx->pml.sidePush * 2) ? sdot : ctx->pml.sidePush * 2;
 		// !Qrace
 	}
 
-	VectorNormalize( pml.forward );
-	VectorNormalize( pml.right );
+	VectorNormalize( ctx->pml.forward );
+	VectorNormalize( ctx->pml.right );
 
 	for( i = 0; i < 3; i++ )
-		wishvel[i] = pml.forward[i]*fmove + pml.right[i]*smove;
-	wishvel[2] += pml.upPush;
+		wishvel[i] = ctx->pml.forward[i]*fmove + ctx->pml.right[i]*smove;
+	wishvel[2] += ctx->pml.upPush;
 
 	VectorCopy( wishvel, wishdir );
 	wishspeed = VectorNormalize( wishdir );
 
 
 
-	currentspeed = DotProduct( pml.velocity, wishdir );
+	currentspeed = DotProduct( ctx->pml.velocity, wishdir );
 	addspeed = wishspeed - currentspeed;
 	if( addspeed > 0 )
 	{
-		accelspeed = pm_accelerate * pml.frametime * wishspeed;
+		accelspeed = pm_accelerate * ctx->pml.frametime * wishspeed;
 		if( accelspeed > addspeed )
 			accelspeed = addspeed;
 
 		for( i = 0; i < 3; i++ )
-			pml.velocity[i] += accelspeed*wishdir[i];
+			ctx->pml.velocity[i] += accelspeed*wishdir[i];
 	}
 
 	// Qrace - clamp after acceleration
-	speed = VectorNormalize(pml.velocity);
+	speed = VectorNormalize(ctx->pml.velocity);
 	speed = speed > maxspeed ? maxspeed : speed;
-	VectorScale(wishdir, speed, pml.velocity);
+	VectorScale(wishdir, speed, ctx->pml.velocity);
 	// !Qrace
 
 	if( doclip )
 	{
 		for( i = 0; i < 3; i++ )
-			end[i] = pml.origin[i] + pml.frametime * pml.velocity[i];
+			end[i] = ctx->pml.origin[i] + ctx->pml.frametime * ctx->pml.velocity[i];
 
-		module_Trace( &trace, pml.origin, pm->mins, pm->maxs, end, pm->playerState->POVnum, pm->contentmask, 0 );
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, ctx->pm->mins, ctx->pm->maxs, end, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 
-		VectorCopy( trace.endpos, pml.origin );
+		VectorCopy( trace.endpos, ctx->pml.origin );
 	}
 	else
 	{
 		// move
-		VectorMA( pml.origin, pml.frametime, pml.velocity, pml.origin );
+		VectorMA( ctx->pml.origin, ctx->pml.frametime, ctx->pml.velocity, ctx->pml.origin );
 	}
 }
 
-static void PM_CheckZoom( void )
+static void PM_CheckZoom( pmove_context_t *ctx )
 {
-	if( pm->playerState->pmove.pm_type != PM_NORMAL )
+	if( ctx->pm->playerState->pmove.pm_type != PM_NORMAL )
 	{
-		pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] = 0;
+		ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] = 0;
 		return;
 	}
 
-	if( ( pm->cmd.buttons & BUTTON_ZOOM ) && ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_ZOOM ) )
+	if( ( ctx->pm->cmd.buttons & BUTTON_ZOOM ) && ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_ZOOM ) )
 	{
-		pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] += pm->cmd.msec;
-		clamp( pm->playerState->pmove.stats[PM_STAT_ZOOMTIME], 0, ZOOMTIME );
+		ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] += ctx->pm->cmd.msec;
+		clamp( ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME], 0, ZOOMTIME );
 	}
-	else if( pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] > 0 )
+	else if( ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] > 0 )
 	{
-		pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] -= pm->cmd.msec;
-		clamp( pm->playerState->pmove.stats[PM_STAT_ZOOMTIME], 0, ZOOMTIME );
+		ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] -= ctx->pm->cmd.msec;
+		clamp( ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME], 0, ZOOMTIME );
 	}
 }
 
 /*
 * PM_AdjustBBox
 * 
-* Sets mins, maxs, and pm->viewheight
+* Sets mins, maxs, and ctx->pm->viewheight
 */
-static void PM_AdjustBBox( void )
+static void PM_AdjustBBox( pmove_context_t *ctx )
 {
 	float crouchFrac;
 	trace_t	trace;
 
-	if( pm->playerState->pmove.pm_type == PM_GIB )
+	if( ctx->pm->playerState->pmove.pm_type == PM_GIB )
 	{
-		pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
-		VectorCopy( playerbox_gib_maxs, pm->maxs );
-		VectorCopy( playerbox_gib_mins, pm->mins );
-		pm->playerState->viewheight = playerbox_gib_viewheight;
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
+		VectorCopy( playerbox_gib_maxs, ctx->pm->maxs );
+		VectorCopy( playerbox_gib_mins, ctx->pm->mins );
+		ctx->pm->playerState->viewheight = playerbox_gib_viewheight;
 		return;
 	}
 
-	if( pm->playerState->pmove.pm_type >= PM_FREEZE )
+	if( ctx->pm->playerState->pmove.pm_type >= PM_FREEZE )
 	{
-		pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
-		pm->playerState->viewheight = 0;
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
+		ctx->pm->playerState->viewheight = 0;
 		return;
 	}
 
-	if( pm->playerState->pmove.pm_type == PM_SPECTATOR )
+	if( ctx->pm->playerState->pmove.pm_type == PM_SPECTATOR )
 	{
-		pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
-		pm->playerState->viewheight = playerbox_stand_viewheight;
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
+		ctx->pm->playerState->viewheight = playerbox_stand_viewheight;
 	}
 
-	if( pml.upPush < 0 && ( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CROUCH ) && 
-		pm->playerState->pmove.stats[PM_STAT_WJTIME] < ( PM_WALLJUMP_TIMEDELAY - PM_SPECIAL_CROUCH_INHIBIT ) &&
-		pm->playerState->pmove.stats[PM_STAT_DASHTIME] < ( PM_DASHJUMP_TIMEDELAY - PM_SPECIAL_CROUCH_INHIBIT ) )
+	if( ctx->pml.upPush < 0 && ( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_CROUCH ) && 
+		ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] < ( PM_WALLJUMP_TIMEDELAY - PM_SPECIAL_CROUCH_INHIBIT ) &&
+		ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] < ( PM_DASHJUMP_TIMEDELAY - PM_SPECIAL_CROUCH_INHIBIT ) )
 	{
-		pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] += pm->cmd.msec;
-		clamp( pm->playerState->pmove.stats[PM_STAT_CROUCHTIME], 0, CROUCHTIME );
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] += ctx->pm->cmd.msec;
+		clamp( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME], 0, CROUCHTIME );
 
-		crouchFrac = (float)pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] / (float)CROUCHTIME;
-		VectorLerp( playerbox_stand_mins, crouchFrac, playerbox_crouch_mins, pm->mins );
-		VectorLerp( playerbox_stand_maxs, crouchFrac, playerbox_crouch_maxs, pm->maxs );
-		pm->playerState->viewheight = playerbox_stand_viewheight - ( crouchFrac * ( playerbox_stand_viewheight - playerbox_crouch_viewheight ) );
+		crouchFrac = (float)ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] / (float)CROUCHTIME;
+		VectorLerp( playerbox_stand_mins, crouchFrac, playerbox_crouch_mins, ctx->pm->mins );
+		VectorLerp( playerbox_stand_maxs, crouchFrac, playerbox_crouch_maxs, ctx->pm->maxs );
+		ctx->pm->playerState->viewheight = playerbox_stand_viewheight - ( crouchFrac * ( playerbox_stand_viewheight - playerbox_crouch_viewheight ) );
 
 		// it's going down, so, no need of checking for head-chomping
 		return;
 	}
 
 	// it's crouched, but not pressing the crouch button anymore, try to stand up
-	if( pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] != 0 )
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] != 0 )
 	{
 		vec3_t curmins, curmaxs, wishmins, wishmaxs;
 		float curviewheight, wishviewheight;
 		int newcrouchtime;
 
 		// find the current size
-		crouchFrac = (float)pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] / (float)CROUCHTIME;
+		crouchFrac = (float)ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] / (float)CROUCHTIME;
 		VectorLerp( playerbox_stand_mins, crouchFrac, playerbox_crouch_mins, curmins );
 		VectorLerp( playerbox_stand_maxs, crouchFrac, playerbox_crouch_maxs, curmaxs );
 		curviewheight = playerbox_stand_viewheight - ( crouchFrac * ( playerbox_stand_viewheight - playerbox_crouch_viewheight ) );
 
-		if( !pm->cmd.msec ) // no need to continue
+		if( !ctx->pm->cmd.msec ) // no need to continue
 		{
-			VectorCopy( curmins, pm->mins );
-			VectorCopy( curmaxs, pm->maxs );
-			pm->playerState->viewheight = curviewheight;
+			VectorCopy( curmins, ctx->pm->mins );
+			VectorCopy( curmaxs, ctx->pm->maxs );
+			ctx->pm->playerState->viewheight = curviewheight;
 			return;
 		}
 
 		// find the desired size
-		newcrouchtime = pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] - pm->cmd.msec;
+		newcrouchtime = ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] - ctx->pm->cmd.msec;
 		clamp( newcrouchtime, 0, CROUCHTIME );
 		crouchFrac = (float)newcrouchtime / (float)CROUCHTIME;
 		VectorLerp( playerbox_stand_mins, crouchFrac, playerbox_crouch_mins, wishmins );
@@ -1672,69 +1685,69 @@ static void PM_AdjustBBox( void )
 		wishviewheight = playerbox_stand_viewheight - ( crouchFrac * ( playerbox_stand_viewheight - playerbox_crouch_viewheight ) );
 
 		// check that the head is not blocked
-		module_Trace( &trace, pml.origin, wishmins, wishmaxs, pml.origin, pm->playerState->POVnum, pm->contentmask, 0 );
+		ctx->callbacks->Trace( &trace, ctx->pml.origin, wishmins, wishmaxs, ctx->pml.origin, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 		if( trace.allsolid || trace.startsolid )
 		{
 			// can't do the uncrouching, let the time alone and use old position
-			VectorCopy( curmins, pm->mins );
-			VectorCopy( curmaxs, pm->maxs );
-			pm->playerState->viewheight = curviewheight;
+			VectorCopy( curmins, ctx->pm->mins );
+			VectorCopy( curmaxs, ctx->pm->maxs );
+			ctx->pm->playerState->viewheight = curviewheight;
 			return;
 		}
 
 		// can do the uncrouching, use new position and update the time
-		pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = newcrouchtime;
-		VectorCopy( wishmins, pm->mins );
-		VectorCopy( wishmaxs, pm->maxs );
-		pm->playerState->viewheight = wishviewheight;
+		ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = newcrouchtime;
+		VectorCopy( wishmins, ctx->pm->mins );
+		VectorCopy( wishmaxs, ctx->pm->maxs );
+		ctx->pm->playerState->viewheight = wishviewheight;
 		return;
 	}
 
 	// the player is not crouching at all
-	VectorCopy( playerbox_stand_mins, pm->mins );
-	VectorCopy( playerbox_stand_maxs, pm->maxs );
-	pm->playerState->viewheight = playerbox_stand_viewheight;
+	VectorCopy( playerbox_stand_mins, ctx->pm->mins );
+	VectorCopy( playerbox_stand_maxs, ctx->pm->maxs );
+	ctx->pm->playerState->viewheight = playerbox_stand_viewheight;
 }
 
 /*
 * PM_AdjustViewheight
 */
-void PM_AdjustViewheight( void )
+static void PM_AdjustViewheight( pmove_context_t *ctx )
 {
 	float height;
 	vec3_t pm_maxs, mins, maxs;
 
-	if( pm->playerState->pmove.pm_type == PM_SPECTATOR )
+	if( ctx->pm->playerState->pmove.pm_type == PM_SPECTATOR )
 	{
 		VectorCopy( playerbox_stand_mins, mins );
 		VectorCopy( playerbox_stand_maxs, maxs );
 	}
 	else
 	{
-		VectorCopy( pm->mins, mins );
-		VectorCopy( pm->maxs, maxs );
+		VectorCopy( ctx->pm->mins, mins );
+		VectorCopy( ctx->pm->maxs, maxs );
 	}
 
 	VectorCopy( maxs, pm_maxs );
-	module_RoundUpToHullSize( mins, maxs );
+	ctx->callbacks->RoundUpToHullSize( mins, maxs );
 
 	height = pm_maxs[2] - maxs[2];
 	if( height > 0 )
-		pm->playerState->viewheight -= height;
+		ctx->pm->playerState->viewheight -= height;
 }
 
-static bool PM_GoodPosition( int snaptorigin[3] )
+static bool PM_GoodPosition( pmove_context_t *ctx, int snaptorigin[3] )
 {
 	trace_t	trace;
 	vec3_t origin, end;
 	int i;
 
-	if( pm->playerState->pmove.pm_type == PM_SPECTATOR )
+	if( ctx->pm->playerState->pmove.pm_type == PM_SPECTATOR )
 		return true;
 
 	for( i = 0; i < 3; i++ )
 		origin[i] = end[i] = snaptorigin[i]*( 1.0/PM_VECTOR_SNAP );
-	module_Trace( &trace, origin, pm->mins, pm->maxs, end, pm->playerState->POVnum, pm->contentmask, 0 );
+	ctx->callbacks->Trace( &trace, origin, ctx->pm->mins, ctx->pm->maxs, end, ctx->pm->playerState->POVnum, ctx->pm->contentmask, 0 );
 
 	return !trace.allsolid ? true : false;
 }
@@ -1745,7 +1758,7 @@ static bool PM_GoodPosition( int snaptorigin[3] )
 * On exit, the origin will have a value that is pre-quantized to the (1.0/16.0)
 * precision of the network channel and in a valid position.
 */
-static void PM_SnapPosition( void )
+static void PM_SnapPosition( pmove_context_t *ctx )
 {
 	int sign[3];
 	int i, j, bits;
@@ -1757,18 +1770,18 @@ static void PM_SnapPosition( void )
 	// snap velocity to sixteenths
 	for( i = 0; i < 3; i++ )
 	{
-		velint[i] = (int)( pml.velocity[i]*PM_VECTOR_SNAP );
-		pm->playerState->pmove.velocity[i] = velint[i]*( 1.0/PM_VECTOR_SNAP );
+		velint[i] = (int)( ctx->pml.velocity[i]*PM_VECTOR_SNAP );
+		ctx->pm->playerState->pmove.velocity[i] = velint[i]*( 1.0/PM_VECTOR_SNAP );
 	}
 
 	for( i = 0; i < 3; i++ )
 	{
-		if( pml.origin[i] >= 0 )
+		if( ctx->pml.origin[i] >= 0 )
 			sign[i] = 1;
 		else
 			sign[i] = -1;
-		origint[i] = (int)( pml.origin[i]*PM_VECTOR_SNAP );
-		if( origint[i]*( 1.0/PM_VECTOR_SNAP ) == pml.origin[i] )
+		origint[i] = (int)( ctx->pml.origin[i]*PM_VECTOR_SNAP );
+		if( origint[i]*( 1.0/PM_VECTOR_SNAP ) == ctx->pml.origin[i] )
 			sign[i] = 0;
 	}
 	VectorCopy( origint, base );
@@ -1782,16 +1795,16 @@ static void PM_SnapPosition( void )
 			if( bits & ( 1<<i ) )
 				origint[i] += sign[i];
 
-		if( PM_GoodPosition( origint ) )
+		if( PM_GoodPosition( ctx, origint ) )
 		{
-			VectorScale( origint, ( 1.0/PM_VECTOR_SNAP ), pm->playerState->pmove.origin );
+			VectorScale( origint, ( 1.0/PM_VECTOR_SNAP ), ctx->pm->playerState->pmove.origin );
 			return;
 		}
 	}
 
 	// go back to the last position
-	VectorCopy( pml.previous_origin, pm->playerState->pmove.origin );
-	VectorClear( pm->playerState->pmove.velocity );
+	VectorCopy( ctx->pml.previous_origin, ctx->pm->playerState->pmove.origin );
+	VectorClear( ctx->pm->playerState->pmove.velocity );
 }
 
 
@@ -1799,14 +1812,14 @@ static void PM_SnapPosition( void )
 * PM_InitialSnapPosition
 * 
 */
-static void PM_InitialSnapPosition( void )
+static void PM_InitialSnapPosition( pmove_context_t *ctx )
 {
 	int x, y, z;
 	int base[3];
 	static const int offset[3] = { 0, -1, 1 };
 	int origint[3];
 
-	VectorScale( pm->playerState->pmove.origin, PM_VECTOR_SNAP, origint );
+	VectorScale( ctx->pm->playerState->pmove.origin, PM_VECTOR_SNAP, origint );
 	VectorCopy( origint, base );
 
 	for( z = 0; z < 3; z++ )
@@ -1818,12 +1831,12 @@ static void PM_InitialSnapPosition( void )
 			for( x = 0; x < 3; x++ )
 			{
 				origint[0] = base[0] + offset[x];
-				if( PM_GoodPosition( origint ) )
+				if( PM_GoodPosition( ctx, origint ) )
 				{
-					pml.origin[0] = pm->playerState->pmove.origin[0] = origint[0]*( 1.0/PM_VECTOR_SNAP );
-					pml.origin[1] = pm->playerState->pmove.origin[1] = origint[1]*( 1.0/PM_VECTOR_SNAP );
-					pml.origin[2] = pm->playerState->pmove.origin[2] = origint[2]*( 1.0/PM_VECTOR_SNAP );
-					VectorCopy( pm->playerState->pmove.origin, pml.previous_origin );
+					ctx->pml.origin[0] = ctx->pm->playerState->pmove.origin[0] = origint[0]*( 1.0/PM_VECTOR_SNAP );
+					ctx->pml.origin[1] = ctx->pm->playerState->pmove.origin[1] = origint[1]*( 1.0/PM_VECTOR_SNAP );
+					ctx->pml.origin[2] = ctx->pm->playerState->pmove.origin[2] = origint[2]*( 1.0/PM_VECTOR_SNAP );
+					VectorCopy( ctx->pm->playerState->pmove.origin, ctx->pml.previous_origin );
 					return;
 				}
 			}
@@ -1831,7 +1844,7 @@ static void PM_InitialSnapPosition( void )
 	}
 }
 
-static void PM_UpdateDeltaAngles( void )
+static void PM_UpdateDeltaAngles( pmove_context_t *ctx )
 {
 	int i;
 
@@ -1839,7 +1852,7 @@ static void PM_UpdateDeltaAngles( void )
 		return;
 
 	for( i = 0; i < 3; i++ )
-		pm->playerState->pmove.delta_angles[i] = ANGLE2SHORT( pm->playerState->viewangles[i] ) - pm->cmd.angles[i];
+		ctx->pm->playerState->pmove.delta_angles[i] = ANGLE2SHORT( ctx->pm->playerState->viewangles[i] ) - ctx->pm->cmd.angles[i];
 }
 
 /*
@@ -1850,338 +1863,341 @@ static void PM_UpdateDeltaAngles( void )
 #pragma warning( push )
 #pragma warning( disable : 4310 )   // cast truncates constant value
 #endif
-static void PM_ApplyMouseAnglesClamp( void )
+static void PM_ApplyMouseAnglesClamp( pmove_context_t *ctx )
 {
 	int i;
 	short temp;
 
 	for( i = 0; i < 3; i++ )
 	{
-		temp = pm->cmd.angles[i] + pm->playerState->pmove.delta_angles[i];
+		temp = ctx->pm->cmd.angles[i] + ctx->pm->playerState->pmove.delta_angles[i];
 		if( i == PITCH )
 		{
 			// don't let the player look up or down more than 90 degrees
 			if( temp > (short)ANGLE2SHORT( 90 ) - 1 )
 			{
-				pm->playerState->pmove.delta_angles[i] = ( ANGLE2SHORT( 90 ) - 1 ) - pm->cmd.angles[i];
+				ctx->pm->playerState->pmove.delta_angles[i] = ( ANGLE2SHORT( 90 ) - 1 ) - ctx->pm->cmd.angles[i];
 				temp = (short)ANGLE2SHORT( 90 ) - 1;
 			}
 			else if( temp < (short)ANGLE2SHORT( -90 ) + 1 )
 			{
-				pm->playerState->pmove.delta_angles[i] = ( ANGLE2SHORT( -90 ) + 1 ) - pm->cmd.angles[i];
+				ctx->pm->playerState->pmove.delta_angles[i] = ( ANGLE2SHORT( -90 ) + 1 ) - ctx->pm->cmd.angles[i];
 				temp = (short)ANGLE2SHORT( -90 ) + 1;
 			}
 		}
 
-		pm->playerState->viewangles[i] = SHORT2ANGLE( (short)temp );
+		ctx->pm->playerState->viewangles[i] = SHORT2ANGLE( (short)temp );
 	}
 
-	AngleVectors( pm->playerState->viewangles, pml.forward, pml.right, pml.up );
+	AngleVectors( ctx->pm->playerState->viewangles, ctx->pml.forward, ctx->pml.right, ctx->pml.up );
 
-	VectorCopy( pml.forward, pml.flatforward );
-	pml.flatforward[2] = 0.0f;
-	VectorNormalize( pml.flatforward );
+	VectorCopy( ctx->pml.forward, ctx->pml.flatforward );
+	ctx->pml.flatforward[2] = 0.0f;
+	VectorNormalize( ctx->pml.flatforward );
 }
 #if defined ( _WIN32 ) && ( _MSC_VER >= 1400 )
 #pragma warning( pop )
 #endif
 
 /*
-* Pmove
+* Pmove_Ext
 * 
-* Can be called by either the server or the client
+* Can be called by either the server or the client. All the state lives in the context
+* on the stack, so independent moves can run at the same time if the callbacks allow it.
 */
-void Pmove( pmove_t *pmove )
+void Pmove_Ext( pmove_t *pmove, const pmove_callbacks_t *callbacks )
 {
+	pmove_context_t context, *ctx = &context;
 	float fallvelocity, falldelta, damage;
 	int oldGroundEntity;
 
 	if( !pmove->playerState )
 		return;
 
-	pm = pmove;
+	ctx->pm = pmove;
+	ctx->callbacks = callbacks;
 
 	// clear results
-	pm->numtouch = 0;
-	pm->groundentity = -1;
-	pm->watertype = 0;
-	pm->waterlevel = 0;
-	pm->step = false;
+	ctx->pm->numtouch = 0;
+	ctx->pm->groundentity = -1;
+	ctx->pm->watertype = 0;
+	ctx->pm->waterlevel = 0;
+	ctx->pm->step = false;
 
 	// clear all pmove local vars
-	memset( &pml, 0, sizeof( pml ) );
+	memset( &ctx->pml, 0, sizeof( ctx->pml ) );
 
-	VectorCopy( pm->playerState->pmove.origin, pml.origin );
-	VectorCopy( pm->playerState->pmove.velocity, pml.velocity );
+	VectorCopy( ctx->pm->playerState->pmove.origin, ctx->pml.origin );
+	VectorCopy( ctx->pm->playerState->pmove.velocity, ctx->pml.velocity );
 
-	fallvelocity = ( ( pml.velocity[2] < 0.0f ) ? fabs( pml.velocity[2] ) : 0.0f );
+	fallvelocity = ( ( ctx->pml.velocity[2] < 0.0f ) ? fabs( ctx->pml.velocity[2] ) : 0.0f );
 
 	// save old org in case we get stuck
-	VectorCopy( pm->playerState->pmove.origin, pml.previous_origin );
+	VectorCopy( ctx->pm->playerState->pmove.origin, ctx->pml.previous_origin );
 
-	pml.frametime = pm->cmd.msec * 0.001;
+	ctx->pml.frametime = ctx->pm->cmd.msec * 0.001;
 
-	pml.maxPlayerSpeed = pm->playerState->pmove.stats[PM_STAT_MAXSPEED];
-	if( pml.maxPlayerSpeed < 0 )
-		pml.maxPlayerSpeed = DEFAULT_PLAYERSPEED;
+	ctx->pml.maxPlayerSpeed = ctx->pm->playerState->pmove.stats[PM_STAT_MAXSPEED];
+	if( ctx->pml.maxPlayerSpeed < 0 )
+		ctx->pml.maxPlayerSpeed = DEFAULT_PLAYERSPEED;
 
-	pml.jumpPlayerSpeed = (float)pm->playerState->pmove.stats[PM_STAT_JUMPSPEED] * GRAVITY_COMPENSATE;
-	if( pml.jumpPlayerSpeed < 0 )
-		pml.jumpPlayerSpeed = DEFAULT_JUMPSPEED * GRAVITY_COMPENSATE;
+	ctx->pml.jumpPlayerSpeed = (float)ctx->pm->playerState->pmove.stats[PM_STAT_JUMPSPEED] * GRAVITY_COMPENSATE;
+	if( ctx->pml.jumpPlayerSpeed < 0 )
+		ctx->pml.jumpPlayerSpeed = DEFAULT_JUMPSPEED * GRAVITY_COMPENSATE;
 
-	pml.dashPlayerSpeed = pm->playerState->pmove.stats[PM_STAT_DASHSPEED];
-	if( pml.dashPlayerSpeed < 0 )
-		pml.dashPlayerSpeed = DEFAULT_DASHSPEED;
+	ctx->pml.dashPlayerSpeed = ctx->pm->playerState->pmove.stats[PM_STAT_DASHSPEED];
+	if( ctx->pml.dashPlayerSpeed < 0 )
+		ctx->pml.dashPlayerSpeed = DEFAULT_DASHSPEED;
 
-	pml.maxWalkSpeed = DEFAULT_WALKSPEED;
-	if( pml.maxWalkSpeed > pml.maxPlayerSpeed * 0.66f )
-		pml.maxWalkSpeed = pml.maxPlayerSpeed * 0.66f;
+	ctx->pml.maxWalkSpeed = DEFAULT_WALKSPEED;
+	if( ctx->pml.maxWalkSpeed > ctx->pml.maxPlayerSpeed * 0.66f )
+		ctx->pml.maxWalkSpeed = ctx->pml.maxPlayerSpeed * 0.66f;
 
-	pml.maxCrouchedSpeed = DEFAULT_CROUCHEDSPEED;
-	if( pml.maxCrouchedSpeed > pml.maxPlayerSpeed * 0.5f )
-		pml.maxCrouchedSpeed = pml.maxPlayerSpeed * 0.5f;
+	ctx->pml.maxCrouchedSpeed = DEFAULT_CROUCHEDSPEED;
+	if( ctx->pml.maxCrouchedSpeed > ctx->pml.maxPlayerSpeed * 0.5f )
+		ctx->pml.maxCrouchedSpeed = ctx->pml.maxPlayerSpeed * 0.5f;
 
 	// assign a contentmask for the movement type
-	switch( pm->playerState->pmove.pm_type )
+	switch( ctx->pm->playerState->pmove.pm_type )
 	{
 	case PM_FREEZE:
 	case PM_CHASECAM:
 		if( gs.module == GS_MODULE_GAME )
-			pm->playerState->pmove.pm_flags |= PMF_NO_PREDICTION;
-		pm->contentmask = 0;
+			ctx->pm->playerState->pmove.pm_flags |= PMF_NO_PREDICTION;
+		ctx->pm->contentmask = 0;
 		break;
 
 	case PM_GIB:
 		if( gs.module == GS_MODULE_GAME )
-			pm->playerState->pmove.pm_flags |= PMF_NO_PREDICTION;
-		pm->contentmask = MASK_DEADSOLID;
+			ctx->pm->playerState->pmove.pm_flags |= PMF_NO_PREDICTION;
+		ctx->pm->contentmask = MASK_DEADSOLID;
 		break;
 
 	case PM_SPECTATOR:
 		if( gs.module == GS_MODULE_GAME )
-			pm->playerState->pmove.pm_flags &= ~PMF_NO_PREDICTION;
-		pm->contentmask = MASK_DEADSOLID;
+			ctx->pm->playerState->pmove.pm_flags &= ~PMF_NO_PREDICTION;
+		ctx->pm->contentmask = MASK_DEADSOLID;
 		break;
 
 	default:
 	case PM_NORMAL:
 		if( gs.module == GS_MODULE_GAME )
-			pm->playerState->pmove.pm_flags &= ~PMF_NO_PREDICTION;
-		if( pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_GHOSTMOVE )
-			pm->contentmask = MASK_DEADSOLID;
+			ctx->pm->playerState->pmove.pm_flags &= ~PMF_NO_PREDICTION;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_FEATURES] & PMFEAT_GHOSTMOVE )
+			ctx->pm->contentmask = MASK_DEADSOLID;
 		else
-			pm->contentmask = MASK_PLAYERSOLID;
+			ctx->pm->contentmask = MASK_PLAYERSOLID;
 		break;
 	}
 
 	if( ! GS_MatchPaused() )
 	{
 		// drop timing counters
-		if( pm->playerState->pmove.pm_time )
+		if( ctx->pm->playerState->pmove.pm_time )
 		{
 			int msec;
 
-			msec = pm->cmd.msec >> 3;
+			msec = ctx->pm->cmd.msec >> 3;
 			if( !msec )
 				msec = 1;
-			if( msec >= pm->playerState->pmove.pm_time )
+			if( msec >= ctx->pm->playerState->pmove.pm_time )
 			{
-				pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
-				pm->playerState->pmove.pm_time = 0;
+				ctx->pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
+				ctx->pm->playerState->pmove.pm_time = 0;
 			}
 			else
-				pm->playerState->pmove.pm_time -= msec;
+				ctx->pm->playerState->pmove.pm_time -= msec;
 		}
 
-		if( pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] = 0;
 
 		// PM_STAT_CROUCHTIME is handled at PM_AdjustBBox
 		// PM_STAT_ZOOMTIME is handled at PM_CheckZoom
 
-		if( pm->playerState->pmove.stats[PM_STAT_DASHTIME] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_DASHTIME] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_DASHTIME] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_DASHTIME] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_WJTIME] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_WJTIME] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_WJTIME] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_WJTIME] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_NOAUTOATTACK] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_STUN] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_STUN] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_STUN] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_STUN] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_STUN] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_STUN] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_STUN] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_FWDTIME] > 0 )
-			pm->playerState->pmove.stats[PM_STAT_FWDTIME] -= pm->cmd.msec;
-		else if( pm->playerState->pmove.stats[PM_STAT_FWDTIME] < 0 )
-			pm->playerState->pmove.stats[PM_STAT_FWDTIME] = 0;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] > 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] -= ctx->pm->cmd.msec;
+		else if( ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] < 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] = 0;
 
-		if( pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] > 0 )
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] > 0 )
 		{
-			pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] -= pm->cmd.msec;
-			if( pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] <= 0 )
+			ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] -= ctx->pm->cmd.msec;
+			if( ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] <= 0 )
 			{
-				if( pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
-					pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = PM_CROUCHSLIDE_TIMEDELAY;
+				if( ctx->pm->playerState->pmove.pm_flags & PMF_CROUCH_SLIDING )
+					ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = PM_CROUCHSLIDE_TIMEDELAY;
 				else
-					pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = 0;
-				pm->playerState->pmove.pm_flags &= ~PMF_CROUCH_SLIDING;
+					ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHSLIDETIME] = 0;
+				ctx->pm->playerState->pmove.pm_flags &= ~PMF_CROUCH_SLIDING;
 			}
 		}
 	}
 
-	pml.forwardPush = pm->cmd.forwardmove * SPEEDKEY;
-	pml.sidePush = pm->cmd.sidemove * SPEEDKEY;
-	pml.upPush = pm->cmd.upmove * SPEEDKEY;
+	ctx->pml.forwardPush = ctx->pm->cmd.forwardmove * SPEEDKEY;
+	ctx->pml.sidePush = ctx->pm->cmd.sidemove * SPEEDKEY;
+	ctx->pml.upPush = ctx->pm->cmd.upmove * SPEEDKEY;
 
-	if( pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] > 0 )
+	if( ctx->pm->playerState->pmove.stats[PM_STAT_NOUSERCONTROL] > 0 )
 	{
-		pml.forwardPush = 0;
-		pml.sidePush = 0;
-		pml.upPush = 0;
-		pm->cmd.buttons = 0;
+		ctx->pml.forwardPush = 0;
+		ctx->pml.sidePush = 0;
+		ctx->pml.upPush = 0;
+		ctx->pm->cmd.buttons = 0;
 	}
 
 	// in order the forward accelt to kick in, one has to keep +fwd pressed 
 	// for some time without strafing
-	if( pml.forwardPush <= 0 || pml.sidePush ) {
-		pm->playerState->pmove.stats[PM_STAT_FWDTIME] = PM_FORWARD_ACCEL_TIMEDELAY;
+	if( ctx->pml.forwardPush <= 0 || ctx->pml.sidePush ) {
+		ctx->pm->playerState->pmove.stats[PM_STAT_FWDTIME] = PM_FORWARD_ACCEL_TIMEDELAY;
 	}
 
-	if( pm->snapinitial )
-		PM_InitialSnapPosition();
+	if( ctx->pm->snapinitial )
+		PM_InitialSnapPosition( ctx );
 
-	if( pm->playerState->pmove.pm_type != PM_NORMAL ) // includes dead, freeze, chasecam...
+	if( ctx->pm->playerState->pmove.pm_type != PM_NORMAL ) // includes dead, freeze, chasecam...
 	{
 		if( !GS_MatchPaused() )
 		{
-			PM_ClearDash();
-			PM_ClearWallJump();
-			PM_ClearStun();
-			pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] = 0;
-			pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
-			pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] = 0;
-			pm->playerState->pmove.pm_flags &= ~(PMF_JUMPPAD_TIME|PMF_DOUBLEJUMPED|PMF_TIME_WATERJUMP|PMF_TIME_LAND|PMF_TIME_TELEPORT|PMF_SPECIAL_HELD);
-
-			PM_AdjustBBox();
+			PM_ClearDash( ctx );
+			PM_ClearWallJump( ctx );
+			PM_ClearStun( ctx );
+			ctx->pm->playerState->pmove.stats[PM_STAT_KNOCKBACK] = 0;
+			ctx->pm->playerState->pmove.stats[PM_STAT_CROUCHTIME] = 0;
+			ctx->pm->playerState->pmove.stats[PM_STAT_ZOOMTIME] = 0;
+			ctx->pm->playerState->pmove.pm_flags &= ~(PMF_JUMPPAD_TIME|PMF_DOUBLEJUMPED|PMF_TIME_WATERJUMP|PMF_TIME_LAND|PMF_TIME_TELEPORT|PMF_SPECIAL_HELD);
+
+			PM_AdjustBBox( ctx );
 		}
 
-		PM_AdjustViewheight();
+		PM_AdjustViewheight( ctx );
 
-		if( pm->playerState->pmove.pm_type == PM_SPECTATOR )
+		if( ctx->pm->playerState->pmove.pm_type == PM_SPECTATOR )
 		{
-			PM_ApplyMouseAnglesClamp();
-			PM_FlyMove( false );
+			PM_ApplyMouseAnglesClamp( ctx );
+			PM_FlyMove( ctx, false );
 		}
 		else
 		{
-			pml.forwardPush = 0;
-			pml.sidePush = 0;
-			pml.upPush = 0;
+			ctx->pml.forwardPush = 0;
+			ctx->pml.sidePush = 0;
+			ctx->pml.upPush = 0;
 		}
 		
-		PM_SnapPosition();
+		PM_SnapPosition( ctx );
 		return;
 	}
 
-	PM_ApplyMouseAnglesClamp();
+	PM_ApplyMouseAnglesClamp( ctx );
 
 	// set mins, maxs, viewheight amd fov
-	PM_AdjustBBox();
-	PM_CheckZoom();
+	PM_AdjustBBox( ctx );
+	PM_CheckZoom( ctx );
 
 	// round up mins/maxs to hull size and adjust the viewheight, if needed
-	PM_AdjustViewheight();
+	PM_AdjustViewheight( ctx );
 
 	// set groundentity, watertype, and waterlevel
-	PM_CategorizePosition();
-	oldGroundEntity = pm->groundentity;
+	PM_CategorizePosition( ctx );
+	oldGroundEntity = ctx->pm->groundentity;
 
-	PM_CheckSpecialMovement();
+	PM_CheckSpecialMovement( ctx );
 
-	if( pm->playerState->pmove.pm_flags & PMF_TIME_TELEPORT )
+	if( ctx->pm->playerState->pmove.pm_flags & PMF_TIME_TELEPORT )
 	{
 		// teleport pause stays exactly in place
 	}
-	else if( pm->playerState->pmove.pm_flags & PMF_TIME_WATERJUMP )
+	else if( ctx->pm->playerState->pmove.pm_flags & PMF_TIME_WATERJUMP )
 	{
 		// waterjump has no control, but falls
-		pml.velocity[2] -= pm->playerState->pmove.gravity * pml.frametime;
-		if( pml.velocity[2] < 0 )
+		ctx->pml.velocity[2] -= ctx->pm->playerState->pmove.gravity * ctx->pml.frametime;
+		if( ctx->pml.velocity[2] < 0 )
 		{
 			// cancel as soon as we are falling down again
-			pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
-			pm->playerState->pmove.pm_time = 0;
+			ctx->pm->playerState->pmove.pm_flags &= ~( PMF_TIME_WATERJUMP | PMF_TIME_LAND | PMF_TIME_TELEPORT );
+			ctx->pm->playerState->pmove.pm_time = 0;
 		}
 
-		PM_StepSlideMove();
+		PM_StepSlideMove( ctx );
 	}
 	else
 	{
 		// Kurim
 		// Keep this order !
-		PM_CheckJump();
-		PM_CheckDash();
-		PM_CheckWallJump();
+		PM_CheckJump( ctx );
+		PM_CheckDash( ctx );
+		PM_CheckWallJump( ctx );
 
-		PM_CheckCrouchSlide();
+		PM_CheckCrouchSlide( ctx );
 
-		PM_Friction();
+		PM_Friction( ctx );
 
-		if( pm->waterlevel >= 2 )
+		if( ctx->pm->waterlevel >= 2 )
 		{
-			PM_WaterMove();
+			PM_WaterMove( ctx );
 		}
 		else
 		{
 			vec3_t angles;
 
-			VectorCopy( pm->playerState->viewangles, angles );
+			VectorCopy( ctx->pm->playerState->viewangles, angles );
 			if( angles[PITCH] > 180 )
 				angles[PITCH] = angles[PITCH] - 360;
 			angles[PITCH] /= 3;
 
-			AngleVectors( angles, pml.forward, pml.right, pml.up );
+			AngleVectors( angles, ctx->pml.forward, ctx->pml.right, ctx->pml.up );
 
 			// hack to work when looking straight up and straight down
-			if( pml.forward[2] == -1.0f )
+			if( ctx->pml.forward[2] == -1.0f )
 			{
-				VectorCopy( pml.up, pml.flatforward );
+				VectorCopy( ctx->pml.up, ctx->pml.flatforward );
 			}
-			else if( pml.forward[2] == 1.0f )
+			else if( ctx->pml.forward[2] == 1.0f )
 			{
-				VectorCopy( pml.up, pml.flatforward );
-				VectorNegate( pml.flatforward, pml.flatforward );
+				VectorCopy( ctx->pml.up, ctx->pml.flatforward );
+				VectorNegate( ctx->pml.flatforward, ctx->pml.flatforward );
 			}
 			else
 			{
-				VectorCopy( pml.forward, pml.flatforward );
+				VectorCopy( ctx->pml.forward, ctx->pml.flatforward );
 			}
-			pml.flatforward[2] = 0.0f;
-			VectorNormalize( pml.flatforward );
+			ctx->pml.flatforward[2] = 0.0f;
+			VectorNormalize( ctx->pml.flatforward );
 
-			PM_Move();
+			PM_Move( ctx );
 		}
 	}
 
 	// set groundentity, watertype, and waterlevel for final spot
-	PM_CategorizePosition();
-	PM_SnapPosition();
+	PM_CategorizePosition( ctx );
+	PM_SnapPosition( ctx );
 
 	// falling event
 
@@ -2194,42 +2210,42 @@ void Pmove( pmove_t *pmove )
 	// We check the entire path between the origin before the pmove and the
 	// current origin to ensure no triggers are missed at high velocity.
 	// Note that this method assumes the movement has been linear.
-	module_PMoveTouchTriggers( pm, pml.previous_origin );
+	ctx->callbacks->PMoveTouchTriggers( ctx->pm, ctx->pml.previous_origin );
 
-	PM_UpdateDeltaAngles(); // in case some trigger action has moved the view angles (like teleported).
+	PM_UpdateDeltaAngles( ctx ); // in case some trigger action has moved the view angles (like teleported).
 
 	// touching triggers may force groundentity off
-	if( !( pm->playerState->pmove.pm_flags & PMF_ON_GROUND ) && pm->groundentity != -1 )
+	if( !( ctx->pm->playerState->pmove.pm_flags & PMF_ON_GROUND ) && ctx->pm->groundentity != -1 )
 	{
-		pm->groundentity = -1;
-		pml.velocity[2] = 0;
+		ctx->pm->groundentity = -1;
+		ctx->pml.velocity[2] = 0;
 	}
 
-	if( pm->groundentity != -1 ) // remove wall-jump and dash bits when touching ground
+	if( ctx->pm->groundentity != -1 ) // remove wall-jump and dash bits when touching ground
 	{
 		// always keep the dash flag 50 msecs at least (to prevent being removed at the start of the dash)
-		if( pm->playerState->pmove.stats[PM_STAT_DASHTIME] < ( PM_DASHJUMP_TIMEDELAY - 50 ) )
-			pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_DASHTIME] < ( PM_DASHJUMP_TIMEDELAY - 50 ) )
+			ctx->pm->playerState->pmove.pm_flags &= ~PMF_DASHING;
 
-		if( pm->playerState->pmove.stats[PM_STAT_WJTIME] < ( PM_WALLJUMP_TIMEDELAY - 50 ) )
-			PM_ClearWallJump();
+		if( ctx->pm->playerState->pmove.stats[PM_STAT_WJTIME] < ( PM_WALLJUMP_TIMEDELAY - 50 ) )
+			PM_ClearWallJump( ctx );
 	}
 
 	if( oldGroundEntity == -1 )
 	{
-		falldelta = fallvelocity - ( ( pml.velocity[2] < 0.0f ) ? fabs( pml.velocity[2] ) : 0.0f );
+		falldelta = fallvelocity - ( ( ctx->pml.velocity[2] < 0.0f ) ? fabs( ctx->pml.velocity[2] ) : 0.0f );
 
 		// scale delta if in water
-		if( pm->waterlevel == 3 )
+		if( ctx->pm->waterlevel == 3 )
 			falldelta = 0;
-		if( pm->waterlevel == 2 )
+		if( ctx->pm->waterlevel == 2 )
 			falldelta *= 0.25;
-		if( pm->waterlevel == 1 )
+		if( ctx->pm->waterlevel == 1 )
 			falldelta *= 0.5;
 
 		if( falldelta > FALL_STEP_MIN_DELTA )
 		{
-			if( !GS_FallDamage() || ( pml.groundsurfFlags & SURF_NODAMAGE ) || ( pm->playerState->pmove.pm_flags & PMF_JUMPPAD_TIME ) )
+			if( !GS_FallDamage() || ( ctx->pml.groundsurfFlags & SURF_NODAMAGE ) || ( ctx->pm->playerState->pmove.pm_flags & PMF_JUMPPAD_TIME ) )
 				damage = 0;
 			else
 			{
@@ -2237,9 +2253,28 @@ void Pmove( pmove_t *pmove )
 				clamp( damage, 0.0f, MAX_FALLING_DAMAGE );
 			}
 
-			module_PredictedEvent( pm->playerState->POVnum, EV_FALL, damage );
+			ctx->callbacks->PredictedEvent( ctx->pm->playerState->POVnum, EV_FALL, damage );
 		}
 
-		pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
+		ctx->pm->playerState->pmove.pm_flags &= ~PMF_JUMPPAD_TIME;
 	}
 }
+
+/*
+* Pmove
+* 
+* Moves the player using the callbacks of the module
+*/
+void Pmove( pmove_t *pmove )
+{
+	pmove_callbacks_t callbacks;
+
+	callbacks.Trace = module_Trace;
+	callbacks.GetEntityState = module_GetEntityState;
+	callbacks.PointContents = module_PointContents;
+	callbacks.PredictedEvent = module_PredictedEvent;
+	callbacks.PMoveTouchTriggers = module_PMoveTouchTriggers;
+	callbacks.RoundUpToHullSize = module_RoundUpToHullSize;
+
+	Pmove_Ext( pmove, &callbacks );
+}
@@ -276,7 +276,19 @@ enum {
 	GS_MAXBUNNIES
 };
 
+// the world a player moves in, as seen by Pmove_Ext
+typedef struct
+{
+	void ( *Trace )( trace_t *t, vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int ignore, int contentmask, int timeDelta );
+	entity_state_t *( *GetEntityState )( int entNum, int deltaTime );
+	int ( *PointContents )( vec3_t point, int timeDelta );
+	void ( *PredictedEvent )( int entNum, int ev, int parm );
+	void ( *PMoveTouchTriggers )( pmove_t *pm, vec3_t previous_origin );
+	void ( *RoundUpToHullSize )( vec3_t mins, vec3_t maxs );
+} pmove_callbacks_t;
+
 void Pmove( pmove_t *pmove );
+void Pmove_Ext( pmove_t *pmove, const pmove_callbacks_t *callbacks );
 
 //===============================================================
 
@@ -763,6 +775,9 @@ static const char *gs_keyicon_names[] = {
 
 #define STAT_NOTSET					-9999 // used for stats that don't have meaningful value atm.
 
+// scoreboard messages are sent as deltas split into several commands, so they may exceed MAX_STRING_CHARS
+#define SCOREBOARD_MSG_MAXSIZE		( MAX_STRING_CHARS * 8 )
+
 //===============================================================
 
 // means of death
@@ -126,9 +126,13 @@ typedef	struct angelwrap_api_s
 
 	// context
 	asIScriptContext *( *asAcquireContext )( asIScriptEngine *engine );
+	asIScriptContext *( *asCreateContext )( asIScriptEngine *engine ); // not shared with asAcquireContext
 	void ( *asReleaseContext )( asIScriptContext *context );
 	asIScriptContext *( *asGetActiveContext )( void );
 
+	// total number of allocations made by script engines
+	unsigned int ( *asGetAllocationCount )( void );
+
 	// strings
 	asstring_t *( *asStringFactoryBuffer )( const char *buffer, unsigned int length );
 	void( *asStringRelease )( asstring_t *str );
@@ -145,6 +149,11 @@ typedef	struct angelwrap_api_s
 	// any
 	CScriptAnyInterface *( *asCreateAnyCpp )( asIScriptEngine *engine );
 	void ( *asReleaseAnyCpp )( CScriptAnyInterface *any );
+
+	// bytecode cache, a key identifies the script sources and the interface registered with the engine
+	uint64_t ( *asByteCodeKey )( asIScriptEngine *engine, unsigned int numSections, const char **names, const char **sections );
+	bool ( *asLoadByteCode )( asIScriptModule *module, const char *filename, uint64_t key );
+	bool ( *asSaveByteCode )( asIScriptModule *module, const char *filename, uint64_t key );
 } angelwrap_api_t;
 
 #endif
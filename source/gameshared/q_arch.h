@@ -355,6 +355,12 @@ typedef int socket_handle_t;
 #define HAVE__INTERLOCKED_API
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || ( defined _M_IX86_FP && _M_IX86_FP >= 2 )
+#define HAVE_SSE2
+#elif defined __ARM_NEON__ || defined __ARM_NEON
+#define HAVE_NEON
+#endif
+
 //==============================================
 
 #if !defined(__cplusplus)
@@ -443,14 +449,17 @@ typedef int socket_handle_t;
 #define ATTRIBUTE_ALIGNED( x ) __attribute__( ( aligned( x ) ) )
 #define ATTRIBUTE_NOINLINE     __attribute__((noinline))
 #define ATTRIBUTE_NAKED
+#define ATTRIBUTE_TLS          __thread
 #elif defined ( _MSC_VER )
 #define ATTRIBUTE_ALIGNED( x ) __declspec( align( x ) )
 #define ATTRIBUTE_NOINLINE
 #define ATTRIBUTE_NAKED        __declspec( naked )
+#define ATTRIBUTE_TLS          __declspec( thread )
 #else
 #define ATTRIBUTE_ALIGNED( x )
 #define ATTRIBUTE_NOINLINE
 #define ATTRIBUTE_NAKED
+#define ATTRIBUTE_TLS
 #endif
 
 #ifdef HAVE___STRTOI64
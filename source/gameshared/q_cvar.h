@@ -59,6 +59,7 @@ typedef struct cvar_s
 	bool modified;          // set each time the cvar is changed
 	float value;
 	int integer;
+	volatile int generation;	// incremented each time the value changes
 } cvar_t;
 
 #ifdef __cplusplus
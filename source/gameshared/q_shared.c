@@ -390,8 +390,8 @@ char *va_r( char *dest, size_t size, const char *format, ... )
 char *va( const char *format, ... )
 {
 	va_list	argptr;
-	static int str_index;
-	static char string[8][2048];
+	static ATTRIBUTE_TLS int str_index;
+	static ATTRIBUTE_TLS char string[8][2048];
 
 	str_index = ( str_index+1 ) & 7;
 	va_start( argptr, format );
@@ -187,6 +187,12 @@ void Com_ScriptModule_Init( void )
 	import.Cmd_RemoveCommand = Cmd_RemoveCommand;
 	import.Cmd_ExecuteText = Cbuf_ExecuteText;
 
+	import.FS_FOpenFile = FS_FOpenFile;
+	import.FS_Read = FS_Read;
+	import.FS_Write = FS_Write;
+	import.FS_Seek = FS_Seek;
+	import.FS_FCloseFile = FS_FCloseFile;
+
 	import.Mem_Alloc = Com_ScriptModule_MemAlloc;
 	import.Mem_Free = Com_ScriptModule_MemFree;
 	import.Mem_AllocPool = Com_ScriptModule_MemAllocPool;
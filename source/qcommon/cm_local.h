@@ -170,6 +170,11 @@ struct cmodel_state_s
 
 	dvis_t *map_pvs, *map_phs;
 	int map_visdatasize;
+	bool map_pvs_mapped;            // map_pvs points into map_filebuf
+
+	void *map_filebuf;              // BSP file buffer, kept while the map is loaded if memory mapped,
+	                                // or until CM_ReleaseMapFile if it's a heap copy
+	bool map_filebuf_mapped;
 
 	uint8_t nullrow[MAX_CM_LEAFS/8];
 
@@ -199,6 +204,20 @@ struct cmodel_state_s
 	float *leaf_mins, *leaf_maxs;
 	int leaf_topnode;
 
+	// trace scratch, kept per state so that different collision
+	// states can be traced from different threads
+	vec3_t trace_start, trace_end;
+	vec3_t trace_mins, trace_maxs;
+	vec3_t trace_startmins, trace_endmins;
+	vec3_t trace_startmaxs, trace_endmaxs;
+	vec3_t trace_absmins, trace_absmaxs;
+	vec3_t trace_extents;
+
+	trace_t	*trace_trace;
+	float trace_realfraction;
+	int trace_contents;
+	bool trace_ispoint;         // optimized case
+
 	// optional special handling of line tracing and point contents
 	void ( *CM_TransformedBoxTrace )( struct cmodel_state_s *cms, trace_t *tr, vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs, struct cmodel_s *cmodel, int brushmask, vec3_t origin, vec3_t angles );
 	int ( *CM_TransformedPointContents )( struct cmodel_state_s *cms, vec3_t p, struct cmodel_s *cmodel, vec3_t origin, vec3_t angles );
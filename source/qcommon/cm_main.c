@@ -157,8 +157,17 @@ static void CM_Clear( cmodel_state_t *cms )
 
 	if( cms->map_pvs )
 	{
-		Mem_Free( cms->map_pvs );
+		if( !cms->map_pvs_mapped )
+			Mem_Free( cms->map_pvs );
 		cms->map_pvs = NULL;
+		cms->map_pvs_mapped = false;
+	}
+
+	if( cms->map_filebuf )
+	{
+		FS_FreeMappedFile( cms->map_filebuf );
+		cms->map_filebuf = NULL;
+		cms->map_filebuf_mapped = false;
 	}
 
 	if( cms->map_entitystring != &cms->map_entitystring_empty )
@@ -184,6 +193,21 @@ MAP LOADING
 ===============================================================================
 */
 
+/*
+* CM_ReleaseMapFile
+*
+* Frees the heap copy of the BSP file once the renderer has loaded the world model.
+* Memory mapped files stay for as long as the map is loaded.
+*/
+void CM_ReleaseMapFile( cmodel_state_t *cms )
+{
+	if( !cms->map_filebuf || cms->map_filebuf_mapped )
+		return;
+
+	FS_FreeMappedFile( cms->map_filebuf );
+	cms->map_filebuf = NULL;
+}
+
 /*
 * CM_LoadMap
 * Loads in the map and all submodels
@@ -196,6 +220,8 @@ cmodel_t *CM_LoadMap( cmodel_state_t *cms, const char *name, bool clientload, un
 	int length;
 	unsigned *buf;
 	char *header;
+	bool mapped;
+	unsigned loadtime;
 	const modelFormatDescr_t *descr;
 	bspFormatDesc_t *bspFormat = NULL;
 
@@ -229,10 +255,17 @@ cmodel_t *CM_LoadMap( cmodel_state_t *cms, const char *name, bool clientload, un
 	//
 	// load the file
 	//
-	length = FS_LoadFile( name, ( void ** )&buf, NULL, 0 );
+	loadtime = Sys_Milliseconds();
+
+	// the file is shared with the renderer, which loads the same map right after
+	length = FS_LoadMappedFile( name, ( void ** )&buf, &mapped );
 	if( !buf )
 		Com_Error( ERR_DROP, "Couldn't load %s", name );
 
+	// also released by CM_Clear if loading fails
+	cms->map_filebuf = buf;
+	cms->map_filebuf_mapped = mapped;
+
 	cms->checksum = md5_digest32( ( const uint8_t * )buf, length );
 	*checksum = cms->checksum;
 
@@ -257,6 +290,15 @@ cmodel_t *CM_LoadMap( cmodel_state_t *cms, const char *name, bool clientload, un
 
 	descr->loader( cms, NULL, buf, bspFormat );
 
+	// keep the mapping for as long as the map is loaded so that lumps can be used in place.
+	// a heap copy, such as of a deflated pk3 entry, is kept until CM_ReleaseMapFile so that
+	// the renderer can load the world model from it, unless there's no renderer
+	if( !mapped && dedicated->integer )
+		CM_ReleaseMapFile( cms );
+
+	Com_DPrintf( "CM_LoadMap: loaded %s in %u msec, %s, %u KiB of collision data\n", name,
+		Sys_Milliseconds() - loadtime, mapped ? "mapped" : "not mapped", (unsigned)( Mem_PoolTotalSize( cms->mempool ) >> 10 ) );
+
 	CM_InitBoxHull( cms );
 	CM_InitOctagonHull( cms );
 
@@ -195,11 +195,6 @@ LINE TESTING IN HULLS
 #define HULLCHECKSTATE_SOLID 1
 #define HULLCHECKSTATE_DONE 2
 
-static trace_t *trace_trace;
-
-static vec3_t trace_start, trace_end;
-static int trace_contents;
-
 /*
 * CM_RecursiveHullCheck
 */
@@ -221,19 +216,19 @@ start:
 		int contents;
 
 		contents = CMod_SurfaceContents( nodenum );
-		if( trace_contents & contents )
+		if( cms->trace_contents & contents )
 		{
 			c_brush_traces++;
 
-			trace_trace->contents = contents;
-			trace_trace->surfFlags = CMod_SurfaceFlags( nodenum );
-			if( trace_trace->allsolid )
-				trace_trace->startsolid = true;
+			cms->trace_trace->contents = contents;
+			cms->trace_trace->surfFlags = CMod_SurfaceFlags( nodenum );
+			if( cms->trace_trace->allsolid )
+				cms->trace_trace->startsolid = true;
 			return HULLCHECKSTATE_SOLID;
 		}
 		else
 		{
-			trace_trace->allsolid = false;
+			cms->trace_trace->allsolid = false;
 			return HULLCHECKSTATE_EMPTY;
 		}
 	}
@@ -281,13 +276,13 @@ start:
 	// the other side of the node is solid, this is the impact point
 	if( !side )
 	{
-		trace_trace->plane = *plane;
+		cms->trace_trace->plane = *plane;
 	}
 	else
 	{
-		VectorNegate( plane->normal, trace_trace->plane.normal );
-		trace_trace->plane.dist = -plane->dist;
-		CategorizePlane( &trace_trace->plane );
+		VectorNegate( plane->normal, cms->trace_trace->plane.normal );
+		cms->trace_trace->plane.dist = -plane->dist;
+		CategorizePlane( &cms->trace_trace->plane );
 	}
 
 	// put the crosspoint DIST_EPSILON pixels on the near side
@@ -297,8 +292,8 @@ start:
 		frac = (t1 - DIST_EPSILON) / (t1 - t2);
 	midf = p1f + (p2f - p1f) * bound( 0, frac, 1 );
 
-	trace_trace->fraction = bound( 0, midf, 1 );
-	VectorLerp( p1, frac, p2, trace_trace->endpos );
+	cms->trace_trace->fraction = bound( 0, midf, 1 );
+	VectorLerp( p1, frac, p2, cms->trace_trace->endpos );
 
 	return HULLCHECKSTATE_DONE;
 }
@@ -340,10 +335,10 @@ static void CM_TransformedHullTrace( cmodel_state_t *cms, trace_t *tr, vec3_t st
 	VectorSubtract( end, offset, end_l );
 
 	tr->allsolid = true;
-	trace_trace = tr;
-	trace_contents = brushmask;
-	VectorCopy( start_l, trace_start );
-	VectorCopy( end_l, trace_end );
+	cms->trace_trace = tr;
+	cms->trace_contents = brushmask;
+	VectorCopy( start_l, cms->trace_start );
+	VectorCopy( end_l, cms->trace_end );
 
 	// rotate start and end into the models frame of reference
 	if( ( angles[0] || angles[1] || angles[2] ) 
@@ -372,7 +367,7 @@ static void CM_TransformedHullTrace( cmodel_state_t *cms, trace_t *tr, vec3_t st
 	// check for position test special case
 	if( VectorCompare( start, end ) )
 	{
-		VectorCopy( start, trace_trace->endpos );
+		VectorCopy( start, cms->trace_trace->endpos );
 		return;
 	}
 
@@ -806,6 +801,4 @@ void CM_LoadQ1BrushModel( cmodel_state_t *cms, void *parent, void *buf, bspForma
 	cms->CM_TransformedBoxTrace = CM_TransformedHullTrace;
 	cms->CM_TransformedPointContents = CM_TransformedHullContents;
 	cms->CM_RoundUpToHullSize = CM_HullSizeForBBox;
-
-	FS_FreeFile( buf );
 }
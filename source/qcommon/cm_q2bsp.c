@@ -497,6 +497,4 @@ void CM_LoadQ2BrushModel( cmodel_state_t *cms, void *parent, void *buf, bspForma
 	CMod_LoadSubmodels( cms, &header.lumps[Q2_LUMP_MODELS] );
 	CMod_LoadVisibility( cms, &header.lumps[Q2_LUMP_VISIBILITY] );
 	CMod_LoadEntityString( cms, &header.lumps[Q2_LUMP_ENTITIES] );
-
-	FS_FreeFile( buf );
 }
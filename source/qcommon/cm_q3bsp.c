@@ -22,9 +22,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "qcommon.h"
 #include "cm_local.h"
 #include "patch.h"
+#include "sys_threads.h"
 
 #define MAX_FACET_PLANES 32
 
+#define CM_PATCH_NUM_THREADS 4
+
+typedef struct
+{
+	cface_t *face;
+	cshaderref_t *shaderref;
+	vec3_t *verts;
+	int patch_cp[2];
+} cpatchjob_t;
+
 /*
 * CM_CreateFacetFromPoints
 */
@@ -422,29 +433,104 @@ static void CMod_LoadVertexes_RBSP( cmodel_state_t *cms, lump_t *l )
 
 /*
 * CMod_LoadFace
+*
+* Returns true if the face is a solid patch, the patch itself is created later by CMod_CreatePatches
 */
-static inline void CMod_LoadFace( cmodel_state_t *cms, cface_t *out, int shadernum, int firstvert, int numverts, int *patch_cp )
+static inline bool CMod_LoadFace( cmodel_state_t *cms, cpatchjob_t *job, cface_t *out, int shadernum, int firstvert, int numverts, const int *patch_cp )
 {
 	cshaderref_t *shaderref;
 
+	// the map buffer may be shared with the renderer, so never swap it in place
 	shadernum = LittleLong( shadernum );
 	if( shadernum < 0 || shadernum >= cms->numshaderrefs )
-		return;
+		return false;
 
 	shaderref = &cms->map_shaderrefs[shadernum];
 	if( !shaderref->contents || ( shaderref->flags & SURF_NONSOLID ) )
-		return;
+		return false;
 
-	patch_cp[0] = LittleLong( patch_cp[0] );
-	patch_cp[1] = LittleLong( patch_cp[1] );
-	if( patch_cp[0] <= 0 || patch_cp[1] <= 0 )
-		return;
+	job->patch_cp[0] = LittleLong( patch_cp[0] );
+	job->patch_cp[1] = LittleLong( patch_cp[1] );
+	if( job->patch_cp[0] <= 0 || job->patch_cp[1] <= 0 )
+		return false;
 
 	firstvert = LittleLong( firstvert );
+	numverts = LittleLong( numverts );
 	if( numverts <= 0 || firstvert < 0 || firstvert >= cms->numvertexes )
+		return false;
+
+	job->face = out;
+	job->shaderref = shaderref;
+	job->verts = cms->map_verts + firstvert;
+	return true;
+}
+
+/*
+* CMod_CreatePatches_Job
+*/
+typedef struct
+{
+	cmodel_state_t *cms;
+	volatile int *cnt;
+	int maxcnt;
+	cpatchjob_t *jobs;
+	qmutex_t *mutex;
+} cpatcharg_t;
+
+static void *CMod_CreatePatches_Job( void *parg )
+{
+	int i;
+	cpatchjob_t *job;
+	cpatcharg_t *arg = parg;
+
+	while( true ) {
+		i = Sys_Atomic_Add( arg->cnt, 1, arg->mutex );
+		if( i >= arg->maxcnt )
+			break;
+
+		job = &arg->jobs[i];
+		CM_CreatePatch( arg->cms, job->face, job->shaderref, job->verts, job->patch_cp );
+	}
+
+	return NULL;
+}
+
+/*
+* CMod_CreatePatches
+*
+* Patch facets creation is the most expensive part of the collision map loading
+* and patches are independent of each other, so spread them over a few threads
+*/
+static void CMod_CreatePatches( cmodel_state_t *cms, cpatchjob_t *jobs, int numjobs )
+{
+	int i;
+	volatile int cnt;
+	qthread_t *threads[CM_PATCH_NUM_THREADS - 1] = { NULL };
+	const int num_threads = min( numjobs, CM_PATCH_NUM_THREADS ) - 1;
+	cpatcharg_t arg;
+
+	if( !numjobs )
 		return;
 
-	CM_CreatePatch( cms, out, shaderref, cms->map_verts + firstvert, patch_cp );
+	cnt = 0;
+	arg.cms = cms;
+	arg.cnt = &cnt;
+	arg.maxcnt = numjobs;
+	arg.jobs = jobs;
+	arg.mutex = QMutex_Create();
+
+	for( i = 0; i < num_threads; i++ )
+		threads[i] = QThread_Create( CMod_CreatePatches_Job, &arg );
+
+	CMod_CreatePatches_Job( &arg );
+
+	for( i = 0; i < num_threads; i++ )
+	{
+		if( threads[i] )
+			QThread_Join( threads[i] );
+	}
+
+	QMutex_Destroy( &arg.mutex );
 }
 
 /*
@@ -452,9 +538,10 @@ static inline void CMod_LoadFace( cmodel_state_t *cms, cface_t *out, int shadern
 */
 static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l )
 {
-	int i, count;
+	int i, count, numjobs;
 	dface_t	*in;
 	cface_t	*out;
+	cpatchjob_t *jobs;
 
 	in = ( void * )( cms->cmod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) )
@@ -466,6 +553,9 @@ static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l )
 	out = cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *out ) );
 	cms->numfaces = count;
 
+	jobs = Mem_TempMalloc( count * sizeof( *jobs ) );
+	numjobs = 0;
+
 	for( i = 0; i < count; i++, in++, out++ )
 	{
 		out->contents = 0;
@@ -473,8 +563,13 @@ static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l )
 		out->facets = NULL;
 		if( LittleLong( in->facetype ) != FACETYPE_PATCH )
 			continue;
-		CMod_LoadFace( cms, out, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
+		if( CMod_LoadFace( cms, &jobs[numjobs], out, in->shadernum, in->firstvert, in->numverts, in->patch_cp ) )
+			numjobs++;
 	}
+
+	CMod_CreatePatches( cms, jobs, numjobs );
+
+	Mem_TempFree( jobs );
 }
 
 /*
@@ -482,9 +577,10 @@ static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l )
 */
 static void CMod_LoadFaces_RBSP( cmodel_state_t *cms, lump_t *l )
 {
-	int i, count;
+	int i, count, numjobs;
 	rdface_t *in;
 	cface_t	*out;
+	cpatchjob_t *jobs;
 
 	in = ( void * )( cms->cmod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) )
@@ -496,6 +592,9 @@ static void CMod_LoadFaces_RBSP( cmodel_state_t *cms, lump_t *l )
 	out = cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *out ) );
 	cms->numfaces = count;
 
+	jobs = Mem_TempMalloc( count * sizeof( *jobs ) );
+	numjobs = 0;
+
 	for( i = 0; i < count; i++, in++, out++ )
 	{
 		out->contents = 0;
@@ -503,8 +602,13 @@ static void CMod_LoadFaces_RBSP( cmodel_state_t *cms, lump_t *l )
 		out->facets = NULL;
 		if( LittleLong( in->facetype ) != FACETYPE_PATCH )
 			continue;
-		CMod_LoadFace( cms, out, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
+		if( CMod_LoadFace( cms, &jobs[numjobs], out, in->shadernum, in->firstvert, in->numverts, in->patch_cp ) )
+			numjobs++;
 	}
+
+	CMod_CreatePatches( cms, jobs, numjobs );
+
+	Mem_TempFree( jobs );
 }
 
 /*
@@ -834,6 +938,16 @@ static void CMod_LoadVisibility( cmodel_state_t *cms, lump_t *l )
 		return;
 	}
 
+#ifdef ENDIAN_LITTLE
+	// the PVS is used as is, so point to the memory mapped file instead of copying it
+	if( cms->map_filebuf_mapped && !( l->fileofs & 3 ) )
+	{
+		cms->map_pvs = ( dvis_t * )( cms->cmod_base + l->fileofs );
+		cms->map_pvs_mapped = true;
+		return;
+	}
+#endif
+
 	cms->map_pvs = Mem_Alloc( cms->mempool, cms->map_visdatasize );
 	memcpy( cms->map_pvs, cms->cmod_base + l->fileofs, cms->map_visdatasize );
 
@@ -895,8 +1009,6 @@ void CM_LoadQ3BrushModel( cmodel_state_t *cms, void *parent, void *buf, bspForma
 	CMod_LoadVisibility( cms, &header.lumps[LUMP_VISIBILITY] );
 	CMod_LoadEntityString( cms, &header.lumps[LUMP_ENTITIES] );
 
-	FS_FreeFile( buf );
-
 	if( cms->numvertexes )
 		Mem_Free( cms->map_verts );
 }
@@ -488,20 +488,6 @@ BOX TRACING
 #endif
 #define RADIUS_EPSILON		1.0f
 
-static vec3_t trace_start, trace_end;
-static vec3_t trace_mins, trace_maxs;
-static vec3_t trace_startmins, trace_endmins;
-static vec3_t trace_startmaxs, trace_endmaxs;
-static vec3_t trace_absmins, trace_absmaxs;
-static vec3_t trace_extents;
-
-static trace_t	*trace_trace;
-#ifdef TRACEVICFIX
-static float trace_realfraction;
-#endif
-static int trace_contents;
-static bool trace_ispoint;      // optimized case
-
 /*
 * CM_ClipBoxToBrush
 */
@@ -538,44 +524,44 @@ static void CM_ClipBoxToBrush( cmodel_state_t *cms, cbrush_t *brush )
 		// push the plane out apropriately for mins/maxs
 		if( p->type < 3 )
 		{
-			d1 = trace_startmins[p->type] - p->dist;
-			d2 = trace_endmins[p->type] - p->dist;
+			d1 = cms->trace_startmins[p->type] - p->dist;
+			d2 = cms->trace_endmins[p->type] - p->dist;
 		}
 		else
 		{
 			switch( p->signbits )
 			{
 			case 0:
-				d1 = p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmins[2] - p->dist;
-				d2 = p->normal[0]*trace_endmins[0] + p->normal[1]*trace_endmins[1] + p->normal[2]*trace_endmins[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmins[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmins[0] + p->normal[1]*cms->trace_endmins[1] + p->normal[2]*cms->trace_endmins[2] - p->dist;
 				break;
 			case 1:
-				d1 = p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmins[2] - p->dist;
-				d2 = p->normal[0]*trace_endmaxs[0] + p->normal[1]*trace_endmins[1] + p->normal[2]*trace_endmins[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmins[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmaxs[0] + p->normal[1]*cms->trace_endmins[1] + p->normal[2]*cms->trace_endmins[2] - p->dist;
 				break;
 			case 2:
-				d1 = p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmins[2] - p->dist;
-				d2 = p->normal[0]*trace_endmins[0] + p->normal[1]*trace_endmaxs[1] + p->normal[2]*trace_endmins[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmins[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmins[0] + p->normal[1]*cms->trace_endmaxs[1] + p->normal[2]*cms->trace_endmins[2] - p->dist;
 				break;
 			case 3:
-				d1 = p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmins[2] - p->dist;
-				d2 = p->normal[0]*trace_endmaxs[0] + p->normal[1]*trace_endmaxs[1] + p->normal[2]*trace_endmins[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmins[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmaxs[0] + p->normal[1]*cms->trace_endmaxs[1] + p->normal[2]*cms->trace_endmins[2] - p->dist;
 				break;
 			case 4:
-				d1 = p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmaxs[2] - p->dist;
-				d2 = p->normal[0]*trace_endmins[0] + p->normal[1]*trace_endmins[1] + p->normal[2]*trace_endmaxs[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmaxs[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmins[0] + p->normal[1]*cms->trace_endmins[1] + p->normal[2]*cms->trace_endmaxs[2] - p->dist;
 				break;
 			case 5:
-				d1 = p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmaxs[2] - p->dist;
-				d2 = p->normal[0]*trace_endmaxs[0] + p->normal[1]*trace_endmins[1] + p->normal[2]*trace_endmaxs[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmaxs[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmaxs[0] + p->normal[1]*cms->trace_endmins[1] + p->normal[2]*cms->trace_endmaxs[2] - p->dist;
 				break;
 			case 6:
-				d1 = p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmaxs[2] - p->dist;
-				d2 = p->normal[0]*trace_endmins[0] + p->normal[1]*trace_endmaxs[1] + p->normal[2]*trace_endmaxs[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmaxs[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmins[0] + p->normal[1]*cms->trace_endmaxs[1] + p->normal[2]*cms->trace_endmaxs[2] - p->dist;
 				break;
 			case 7:
-				d1 = p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmaxs[2] - p->dist;
-				d2 = p->normal[0]*trace_endmaxs[0] + p->normal[1]*trace_endmaxs[1] + p->normal[2]*trace_endmaxs[2] - p->dist;
+				d1 = p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmaxs[2] - p->dist;
+				d2 = p->normal[0]*cms->trace_endmaxs[0] + p->normal[1]*cms->trace_endmaxs[1] + p->normal[2]*cms->trace_endmaxs[2] - p->dist;
 				break;
 			default:
 				d1 = d2 = 0; // shut up compiler
@@ -640,42 +626,42 @@ static void CM_ClipBoxToBrush( cmodel_state_t *cms, cbrush_t *brush )
 	if( !startout )
 	{
 		// original point was inside brush
-		trace_trace->startsolid = true;
-		trace_trace->contents = brush->contents;
+		cms->trace_trace->startsolid = true;
+		cms->trace_trace->contents = brush->contents;
 		if( !getout )
 		{
-			trace_trace->allsolid = true;
-			trace_trace->fraction = 0;
+			cms->trace_trace->allsolid = true;
+			cms->trace_trace->fraction = 0;
 		}
 		return;
 	}
 #ifdef TRACEVICFIX
 	if( enterfrac - FRAC_EPSILON <= leavefrac )
 	{
-		if( enterfrac > -1 && enterfrac < trace_realfraction )
+		if( enterfrac > -1 && enterfrac < cms->trace_realfraction )
 		{
 			if( enterfrac < 0 )
 				enterfrac = 0;
-			trace_realfraction = enterfrac;
-			trace_trace->plane = *clipplane;
-			trace_trace->surfFlags = leadside->surfFlags;
-			trace_trace->contents = brush->contents;
-			trace_trace->fraction = ( enterdist - DIST_EPSILON ) / move;
-			if( trace_trace->fraction < 0 )
-				trace_trace->fraction = 0;
+			cms->trace_realfraction = enterfrac;
+			cms->trace_trace->plane = *clipplane;
+			cms->trace_trace->surfFlags = leadside->surfFlags;
+			cms->trace_trace->contents = brush->contents;
+			cms->trace_trace->fraction = ( enterdist - DIST_EPSILON ) / move;
+			if( cms->trace_trace->fraction < 0 )
+				cms->trace_trace->fraction = 0;
 		}
 	}
 #else
 	if( enterfrac - ( 1.0f / 1024.0f ) <= leavefrac )
 	{
-		if( enterfrac > -1 && enterfrac < trace_trace->fraction )
+		if( enterfrac > -1 && enterfrac < cms->trace_trace->fraction )
 		{
 			if( enterfrac < 0 )
 				enterfrac = 0;
-			trace_trace->fraction = enterfrac;
-			trace_trace->plane = *clipplane;
-			trace_trace->surfFlags = leadside->surfFlags;
-			trace_trace->contents = brush->contents;
+			cms->trace_trace->fraction = enterfrac;
+			cms->trace_trace->plane = *clipplane;
+			cms->trace_trace->surfFlags = leadside->surfFlags;
+			cms->trace_trace->contents = brush->contents;
 		}
 	}
 #endif
@@ -702,7 +688,7 @@ static void CM_TestBoxInBrush( cmodel_state_t *cms, cbrush_t *brush )
 		// if completely in front of face, no intersection
 		if( p->type < 3 )
 		{
-			if( trace_startmins[p->type] > p->dist )
+			if( cms->trace_startmins[p->type] > p->dist )
 				return;
 		}
 		else
@@ -710,35 +696,35 @@ static void CM_TestBoxInBrush( cmodel_state_t *cms, cbrush_t *brush )
 			switch( p->signbits )
 			{
 			case 0:
-				if( p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmins[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmins[2] > p->dist )
 					return;
 				break;
 			case 1:
-				if( p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmins[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmins[2] > p->dist )
 					return;
 				break;
 			case 2:
-				if( p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmins[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmins[2] > p->dist )
 					return;
 				break;
 			case 3:
-				if( p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmins[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmins[2] > p->dist )
 					return;
 				break;
 			case 4:
-				if( p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmaxs[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmaxs[2] > p->dist )
 					return;
 				break;
 			case 5:
-				if( p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmins[1] + p->normal[2]*trace_startmaxs[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmins[1] + p->normal[2]*cms->trace_startmaxs[2] > p->dist )
 					return;
 				break;
 			case 6:
-				if( p->normal[0]*trace_startmins[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmaxs[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmins[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmaxs[2] > p->dist )
 					return;
 				break;
 			case 7:
-				if( p->normal[0]*trace_startmaxs[0] + p->normal[1]*trace_startmaxs[1] + p->normal[2]*trace_startmaxs[2] > p->dist )
+				if( p->normal[0]*cms->trace_startmaxs[0] + p->normal[1]*cms->trace_startmaxs[1] + p->normal[2]*cms->trace_startmaxs[2] > p->dist )
 					return;
 				break;
 			default:
@@ -749,9 +735,9 @@ static void CM_TestBoxInBrush( cmodel_state_t *cms, cbrush_t *brush )
 	}
 
 	// inside this brush
-	trace_trace->startsolid = trace_trace->allsolid = true;
-	trace_trace->fraction = 0;
-	trace_trace->contents = brush->contents;
+	cms->trace_trace->startsolid = cms->trace_trace->allsolid = true;
+	cms->trace_trace->fraction = 0;
+	cms->trace_trace->contents = brush->contents;
 }
 
 /*
@@ -772,10 +758,10 @@ static void CM_CollideBox( cmodel_state_t *cms, cbrush_t **markbrushes, int numm
 		if( b->checkcount == cms->checkcount )
 			continue; // already checked this brush
 		b->checkcount = cms->checkcount;
-		if( !( b->contents & trace_contents ) )
+		if( !( b->contents & cms->trace_contents ) )
 			continue;
 		func( cms, b );
-		if( !trace_trace->fraction )
+		if( !cms->trace_trace->fraction )
 			return;
 	}
 
@@ -789,15 +775,15 @@ static void CM_CollideBox( cmodel_state_t *cms, cbrush_t **markbrushes, int numm
 		if( patch->checkcount == cms->checkcount )
 			continue; // already checked this patch
 		patch->checkcount = cms->checkcount;
-		if( !( patch->contents & trace_contents ) )
+		if( !( patch->contents & cms->trace_contents ) )
 			continue;
-		if( !BoundsIntersect( patch->mins, patch->maxs, trace_absmins, trace_absmaxs ) )
+		if( !BoundsIntersect( patch->mins, patch->maxs, cms->trace_absmins, cms->trace_absmaxs ) )
 			continue;
 		facet = patch->facets;
 		for( j = 0; j < patch->numfacets; j++, facet++ )
 		{
 			func( cms, facet );
-			if( !trace_trace->fraction )
+			if( !cms->trace_trace->fraction )
 				return;
 		}
 	}
@@ -836,10 +822,10 @@ static void CM_RecursiveHullCheck( cmodel_state_t *cms, int num, float p1f, floa
 
 loc0:
 #ifdef TRACEVICFIX
-	if( trace_realfraction <= p1f )
+	if( cms->trace_realfraction <= p1f )
 		return; // already hit something nearer
 #else
-	if( trace_trace->fraction <= p1f )
+	if( cms->trace_trace->fraction <= p1f )
 		return; // already hit something nearer
 #endif
 	// if < 0, we are in a leaf node
@@ -848,7 +834,7 @@ loc0:
 		cleaf_t	*leaf;
 
 		leaf = &cms->map_leafs[-1 - num];
-		if( leaf->contents & trace_contents )
+		if( leaf->contents & cms->trace_contents )
 			CM_ClipBox( cms, leaf->markbrushes, leaf->nummarkbrushes, leaf->markfaces, leaf->nummarkfaces );
 		return;
 	}
@@ -864,18 +850,18 @@ loc0:
 	{
 		t1 = p1[plane->type] - plane->dist;
 		t2 = p2[plane->type] - plane->dist;
-		offset = trace_extents[plane->type];
+		offset = cms->trace_extents[plane->type];
 	}
 	else
 	{
 		t1 = DotProduct( plane->normal, p1 ) - plane->dist;
 		t2 = DotProduct( plane->normal, p2 ) - plane->dist;
-		if( trace_ispoint )
+		if( cms->trace_ispoint )
 			offset = 0;
 		else
-			offset = fabs( trace_extents[0] * plane->normal[0] ) +
-			fabs( trace_extents[1] * plane->normal[1] ) +
-			fabs( trace_extents[2] * plane->normal[2] );
+			offset = fabs( cms->trace_extents[0] * plane->normal[0] ) +
+			fabs( cms->trace_extents[1] * plane->normal[1] ) +
+			fabs( cms->trace_extents[2] * plane->normal[2] );
 	}
 
 	// see which sides we need to consider
@@ -955,34 +941,34 @@ static void CM_BoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t
 	// fill in a default trace
 	memset( tr, 0, sizeof( *tr ) );
 #ifdef TRACEVICFIX
-	tr->fraction = trace_realfraction = 1;
+	tr->fraction = cms->trace_realfraction = 1;
 #else
 	tr->fraction = 1;
 #endif
 	if( !cms->numnodes )  // map not loaded
 		return;
 
-	trace_trace = tr;
-	trace_contents = brushmask;
-	VectorCopy( start, trace_start );
-	VectorCopy( end, trace_end );
-	VectorCopy( mins, trace_mins );
-	VectorCopy( maxs, trace_maxs );
+	cms->trace_trace = tr;
+	cms->trace_contents = brushmask;
+	VectorCopy( start, cms->trace_start );
+	VectorCopy( end, cms->trace_end );
+	VectorCopy( mins, cms->trace_mins );
+	VectorCopy( maxs, cms->trace_maxs );
 
 	// build a bounding box of the entire move
-	ClearBounds( trace_absmins, trace_absmaxs );
+	ClearBounds( cms->trace_absmins, cms->trace_absmaxs );
 
-	VectorAdd( start, trace_mins, trace_startmins );
-	AddPointToBounds( trace_startmins, trace_absmins, trace_absmaxs );
+	VectorAdd( start, cms->trace_mins, cms->trace_startmins );
+	AddPointToBounds( cms->trace_startmins, cms->trace_absmins, cms->trace_absmaxs );
 
-	VectorAdd( start, trace_maxs, trace_startmaxs );
-	AddPointToBounds( trace_startmaxs, trace_absmins, trace_absmaxs );
+	VectorAdd( start, cms->trace_maxs, cms->trace_startmaxs );
+	AddPointToBounds( cms->trace_startmaxs, cms->trace_absmins, cms->trace_absmaxs );
 
-	VectorAdd( end, trace_mins, trace_endmins );
-	AddPointToBounds( trace_endmins, trace_absmins, trace_absmaxs );
+	VectorAdd( end, cms->trace_mins, cms->trace_endmins );
+	AddPointToBounds( cms->trace_endmins, cms->trace_absmins, cms->trace_absmaxs );
 
-	VectorAdd( end, trace_maxs, trace_endmaxs );
-	AddPointToBounds( trace_endmaxs, trace_absmins, trace_absmaxs );
+	VectorAdd( end, cms->trace_maxs, cms->trace_endmaxs );
+	AddPointToBounds( cms->trace_endmaxs, cms->trace_absmins, cms->trace_absmaxs );
 
 	//
 	// check for position test special case
@@ -997,7 +983,7 @@ static void CM_BoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t
 
 		if( notworld )
 		{
-			if( BoundsIntersect( cmodel->mins, cmodel->maxs, trace_absmins, trace_absmaxs ) )
+			if( BoundsIntersect( cmodel->mins, cmodel->maxs, cms->trace_absmins, cms->trace_absmaxs ) )
 			{
 				CM_TestBox( cms, cmodel->markbrushes, cmodel->nummarkbrushes, cmodel->markfaces, cmodel->nummarkfaces );
 			}
@@ -1015,7 +1001,7 @@ static void CM_BoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t
 			{
 				leaf = &cms->map_leafs[leafs[i]];
 
-				if( leaf->contents & trace_contents )
+				if( leaf->contents & cms->trace_contents )
 				{
 					CM_TestBox( cms, leaf->markbrushes, leaf->nummarkbrushes, leaf->markfaces, leaf->nummarkfaces );
 					if( tr->allsolid )
@@ -1033,13 +1019,13 @@ static void CM_BoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t
 	//
 	if( VectorCompare( mins, vec3_origin ) && VectorCompare( maxs, vec3_origin ) )
 	{
-		trace_ispoint = true;
-		VectorClear( trace_extents );
+		cms->trace_ispoint = true;
+		VectorClear( cms->trace_extents );
 	}
 	else
 	{
-		trace_ispoint = false;
-		VectorSet( trace_extents,
+		cms->trace_ispoint = false;
+		VectorSet( cms->trace_extents,
 			-mins[0] > maxs[0] ? -mins[0] : maxs[0],
 			-mins[1] > maxs[1] ? -mins[1] : maxs[1],
 			-mins[2] > maxs[2] ? -mins[2] : maxs[2] );
@@ -1050,7 +1036,7 @@ static void CM_BoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t
 	//
 	if( !notworld )
 		CM_RecursiveHullCheck( cms, 0, 0, 1, start, end );
-	else if( BoundsIntersect( cmodel->mins, cmodel->maxs, trace_absmins, trace_absmaxs ) )
+	else if( BoundsIntersect( cmodel->mins, cmodel->maxs, cms->trace_absmins, cms->trace_absmaxs ) )
 		CM_ClipBox( cms, cmodel->markbrushes, cmodel->nummarkbrushes, cmodel->markfaces, cmodel->nummarkfaces );
 
 #ifdef TRACEVICFIX
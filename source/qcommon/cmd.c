@@ -31,6 +31,14 @@ typedef struct cmdalias_s
 	char *name;
 	char *value;
 	bool archive;
+
+	// aliases of a single command are tokenized once and then executed directly
+	// instead of going through the command buffer, see Cmd_CompileAlias
+	int compiled;			// 0 - not yet, 1 - single command, -1 - has to be buffered
+	int argc;
+	char *tokens;			// argv strings, one after another
+	size_t tokens_size;
+	char *args;
 } cmd_alias_t;
 
 static bool	cmd_preinitialized = false;
@@ -41,6 +49,10 @@ static const trie_casing_t CMD_ALIAS_TRIE_CASING = CON_CASE_SENSITIVE ? TRIE_CAS
 
 static bool	cmd_wait;
 static int alias_count;    // for detecting runaway loops
+static bool	cmd_from_cbuf;  // the next Cmd_ExecuteString is called by Cbuf_Execute
+
+static void Cmd_InvalidateLookups( void );
+static void Cmd_FreeAliasTokens( cmd_alias_t *a );
 
 static int Cmd_Archive( void *alias, void *ignored )
 {
@@ -328,6 +340,7 @@ void Cbuf_Execute( void )
 		line[i] = 0;
 
 		// execute the command line
+		cmd_from_cbuf = true;
 		Cmd_ExecuteString( line );
 
 		if( cmd_wait )
@@ -608,6 +621,7 @@ static void Cmd_Alias_f_( bool archive )
 			return;
 		}
 		Mem_ZoneFree( a->value );
+		Cmd_FreeAliasTokens( a );
 	}
 	else
 	{
@@ -615,6 +629,7 @@ static void Cmd_Alias_f_( bool archive )
 		a->name = (char *) ( (uint8_t *)a + sizeof( cmd_alias_t ) );
 		strcpy( a->name, s );
 		Trie_Insert( cmd_alias_trie, s, a );
+		Cmd_InvalidateLookups();
 	}
 
 	if( archive )
@@ -675,6 +690,8 @@ static void Cmd_Unalias_f( void )
 	assert( cmd_alias_trie );
 	if( Trie_Remove( cmd_alias_trie, s, (void **)&a ) == TRIE_OK )
 	{
+		Cmd_InvalidateLookups();
+		Cmd_FreeAliasTokens( a );
 		Mem_ZoneFree( a->value );
 		Mem_ZoneFree( a );
 	}
@@ -699,11 +716,13 @@ static void Cmd_UnaliasAll_f( void )
 	for( i = 0; i < dump->size; ++i )
 	{
 		cmd_alias_t *const a = (cmd_alias_t *) dump->key_value_vector[i].value;
+		Cmd_FreeAliasTokens( a );
 		Mem_ZoneFree( a->value );
 		Mem_ZoneFree( a );
 	}
 	Trie_FreeDump( dump );
 	Trie_Clear( cmd_alias_trie );
+	Cmd_InvalidateLookups();
 }
 
 /*
@@ -747,11 +766,28 @@ typedef struct cmd_function_s
 } cmd_function_t;
 
 
-static int cmd_argc;
-static char *cmd_argv[MAX_STRING_TOKENS];
-static size_t cmd_argv_sizes[MAX_STRING_TOKENS];
+// the tokenized command is per thread, TV relays parse server commands on worker threads
+static ATTRIBUTE_TLS int cmd_argc;
+static ATTRIBUTE_TLS char *cmd_argv[MAX_STRING_TOKENS];
 static char *cmd_null_string = "";
-static char cmd_args[MAX_STRING_CHARS];
+static ATTRIBUTE_TLS char cmd_args[MAX_STRING_CHARS];
+
+// argv strings are parsed one after another into a single buffer, which is only
+// reallocated when a longer command line comes in
+static ATTRIBUTE_TLS char *cmd_tokens;
+static ATTRIBUTE_TLS size_t cmd_tokens_size, cmd_tokens_used;
+
+// direct-mapped cache of command and alias names, in front of the tries
+#define CMD_LOOKUP_CACHE_SIZE	256
+
+typedef struct
+{
+	const char *name;
+	cmd_function_t *cmd;
+	cmd_alias_t *alias;
+} cmd_lookup_t;
+
+static cmd_lookup_t cmd_lookup_cache[CMD_LOOKUP_CACHE_SIZE];
 
 static trie_t *cmd_function_trie = NULL;
 static const trie_casing_t CMD_FUNCTION_TRIE_CASING = CON_CASE_SENSITIVE ? TRIE_CASE_SENSITIVE : TRIE_CASE_INSENSITIVE;
@@ -803,14 +839,30 @@ char *Cmd_Args( void )
 */
 void Cmd_TokenizeString( const char *text )
 {
-	char *com_token;
+	char *token;
+	size_t size;
 
 	cmd_argc = 0;
 	cmd_args[0] = 0;
+	cmd_tokens_used = 0;
 
 	if( !text )
 		return;
 
+	// the text must not come from the tokens of the previous command
+	assert( !cmd_tokens || text < cmd_tokens || text >= cmd_tokens + cmd_tokens_size );
+
+	// tokens can't be longer than the text plus terminating zeros, but the parser
+	// may use up to MAX_TOKEN_CHARS for the last one
+	size = strlen( text ) + MAX_STRING_TOKENS + MAX_TOKEN_CHARS;
+	if( cmd_tokens_size < size )
+	{
+		if( cmd_tokens )
+			Mem_ZoneFree( cmd_tokens );
+		cmd_tokens_size = size + MAX_STRING_CHARS;
+		cmd_tokens = Mem_ZoneMalloc( cmd_tokens_size );
+	}
+
 	for(;; )
 	{
 		// skip whitespace up to a /n
@@ -832,8 +884,7 @@ void Cmd_TokenizeString( const char *text )
 		{
 			size_t l;
 
-			strncpy( cmd_args, text, sizeof( cmd_args )-1 );
-			cmd_args[sizeof( cmd_args )-1] = 0;
+			Q_strncpyz( cmd_args, text, sizeof( cmd_args ) );
 
 			// strip off any trailing whitespace
 			// use > 0 and -1 instead of >= 0 since size_t can be unsigned
@@ -845,22 +896,15 @@ void Cmd_TokenizeString( const char *text )
 					break;
 		}
 
-		com_token = COM_Parse( &text );
+		token = cmd_tokens + cmd_tokens_used;
+		COM_ParseExt2_r( token, MAX_TOKEN_CHARS, &text, true, true );
 		if( !text )
 			return;
 
 		if( cmd_argc < MAX_STRING_TOKENS )
 		{
-			size_t size = strlen( com_token ) + 1;
-			if( cmd_argv_sizes[cmd_argc] < size )
-			{
-				cmd_argv_sizes[cmd_argc] = min( size + 64, MAX_TOKEN_CHARS );
-				if( cmd_argv[cmd_argc] )
-					Mem_ZoneFree( cmd_argv[cmd_argc] );
-				cmd_argv[cmd_argc] = Mem_ZoneMalloc( cmd_argv_sizes[cmd_argc] );
-			}
-			strcpy( cmd_argv[cmd_argc], com_token );
-			cmd_argc++;
+			cmd_argv[cmd_argc++] = token;
+			cmd_tokens_used += strlen( token ) + 1;
 		}
 	}
 }
@@ -908,6 +952,7 @@ void Cmd_AddCommand( const char *cmd_name, xcommand_t function )
 	cmd->function = function;
 	cmd->completion_func = NULL;
 	Trie_Insert( cmd_function_trie, cmd_name, cmd );
+	Cmd_InvalidateLookups();
 }
 
 /*
@@ -923,7 +968,10 @@ void Cmd_RemoveCommand( const char *cmd_name )
 	assert( cmd_function_trie );
 	assert( cmd_name );
 	if( Trie_Remove( cmd_function_trie, cmd_name, (void **)&cmd ) == TRIE_OK )
+	{
+		Cmd_InvalidateLookups();
 		Mem_ZoneFree( cmd );
+	}
 	else
 		Com_Printf( "Cmd_RemoveCommand: %s not added\n", cmd_name );
 }
@@ -1296,19 +1344,156 @@ bool Cmd_CheckForCommand( char *text )
 }
 
 /*
-* Cmd_ExecuteString
-* // Parses a single line of text into arguments and tries to execute it
-* // as if it was typed at the console
-* FIXME: lookupnoadd the token to speed search?
+* Cmd_InvalidateLookups
 */
-void Cmd_ExecuteString( const char *text )
+static void Cmd_InvalidateLookups( void )
+{
+	memset( cmd_lookup_cache, 0, sizeof( cmd_lookup_cache ) );
+}
+
+/*
+* Cmd_LookupHash
+*/
+static unsigned int Cmd_LookupHash( const char *name )
+{
+	unsigned int hash = 2166136261u;
+
+	for( ; *name; name++ )
+	{
+		hash ^= CON_CASE_SENSITIVE ? (unsigned char)*name : (unsigned char)tolower( *name );
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+* Cmd_Lookup
+*
+* Finds the command function or the alias with given name
+*/
+static void Cmd_Lookup( const char *name, cmd_function_t **cmd, cmd_alias_t **alias )
+{
+	cmd_lookup_t *lookup = &cmd_lookup_cache[Cmd_LookupHash( name ) & ( CMD_LOOKUP_CACHE_SIZE - 1 )];
+
+	if( lookup->name && !( CON_CASE_SENSITIVE ? strcmp( lookup->name, name ) : Q_stricmp( lookup->name, name ) ) )
+	{
+		*cmd = lookup->cmd;
+		*alias = lookup->alias;
+		return;
+	}
+
+	assert( cmd_function_trie );
+	assert( cmd_alias_trie );
+
+	*alias = NULL;
+	if( Trie_Find( cmd_function_trie, name, TRIE_EXACT_MATCH, (void **)cmd ) != TRIE_OK )
+	{
+		*cmd = NULL;
+		if( Trie_Find( cmd_alias_trie, name, TRIE_EXACT_MATCH, (void **)alias ) != TRIE_OK )
+		{
+			// cvars and dynvars are looked up on their own
+			*alias = NULL;
+			return;
+		}
+	}
+
+	lookup->name = *cmd ? ( *cmd )->name : ( *alias )->name;
+	lookup->cmd = *cmd;
+	lookup->alias = *alias;
+}
+
+/*
+* Cmd_FreeAliasTokens
+*/
+static void Cmd_FreeAliasTokens( cmd_alias_t *a )
+{
+	if( a->tokens )
+		Mem_ZoneFree( a->tokens );
+	a->compiled = 0;
+	a->argc = 0;
+	a->tokens = NULL;
+	a->tokens_size = 0;
+	a->args = NULL;
+}
+
+/*
+* Cmd_CompileAlias
+*
+* Tokenizes the alias if it consists of a single command. Aliases of multiple
+* commands have to go through the command buffer because of "wait".
+* Returns true if the alias has been compiled.
+*/
+static bool Cmd_CompileAlias( cmd_alias_t *a )
+{
+	const char *p;
+	bool quotes, quoteskip;
+	size_t args_size;
+
+	if( a->compiled )
+		return a->compiled > 0;
+
+	// same line breaking rules as in Cbuf_Execute
+	quotes = quoteskip = false;
+	for( p = a->value; *p; p++ )
+	{
+		if( !quoteskip && *p == '"' )
+			quotes = !quotes;
+		quoteskip = !quoteskip && *p == '\\';
+
+		if( *p == '\n' || ( !quotes && *p == ';' ) )
+			break;
+	}
+	if( *p || p - a->value >= MAX_STRING_CHARS - 1 )
+	{
+		a->compiled = -1;
+		return false;
+	}
+
+	Cmd_TokenizeString( a->value );
+
+	args_size = strlen( cmd_args ) + 1;
+	a->tokens_size = cmd_tokens_used;
+	a->tokens = Mem_ZoneMalloc( a->tokens_size + args_size );
+	memcpy( a->tokens, cmd_tokens, a->tokens_size );
+	a->args = a->tokens + a->tokens_size;
+	memcpy( a->args, cmd_args, args_size );
+	a->argc = cmd_argc;
+	a->compiled = 1;
+	return true;
+}
+
+/*
+* Cmd_SetAliasTokens
+*/
+static void Cmd_SetAliasTokens( const cmd_alias_t *a )
+{
+	int i;
+	char *token;
+
+	assert( a->compiled > 0 );
+	assert( cmd_tokens_size >= a->tokens_size );
+
+	memcpy( cmd_tokens, a->tokens, a->tokens_size );
+	cmd_tokens_used = a->tokens_size;
+	Q_strncpyz( cmd_args, a->args, sizeof( cmd_args ) );
+
+	for( i = 0, token = cmd_tokens; i < a->argc; i++ )
+	{
+		cmd_argv[i] = token;
+		token += strlen( token ) + 1;
+	}
+	cmd_argc = a->argc;
+}
+
+/*
+* Cmd_ExecuteTokenized
+*/
+static void Cmd_ExecuteTokenized( const char *text, bool from_cbuf )
 {
 	char *str;
 	cmd_function_t *cmd;
 	cmd_alias_t *a;
 
-	Cmd_TokenizeString( text );
-
 	// execute the command line
 	if( !Cmd_Argc() )
 		return; // no tokens
@@ -1322,9 +1507,8 @@ void Cmd_ExecuteString( const char *text )
 	// that does not break seperation of concerns.
 	// Aiwa, 07-14-2006
 
-	assert( cmd_function_trie );
-	assert( cmd_alias_trie );
-	if( Trie_Find( cmd_function_trie, str, TRIE_EXACT_MATCH, (void **)&cmd ) == TRIE_OK )
+	Cmd_Lookup( str, &cmd, &a );
+	if( cmd )
 	{
 		// check functions
 		if( !cmd->function )
@@ -1333,7 +1517,7 @@ void Cmd_ExecuteString( const char *text )
 		else
 			cmd->function();
 	}
-	else if( Trie_Find( cmd_alias_trie, str, TRIE_EXACT_MATCH, (void **)&a ) == TRIE_OK )
+	else if( a )
 	{
 		// check alias
 		if( ++alias_count == ALIAS_LOOP_COUNT )
@@ -1342,6 +1526,16 @@ void Cmd_ExecuteString( const char *text )
 			alias_count = 0;
 			return;
 		}
+
+		// when executed from the buffer, the alias would be the next command
+		// to run anyway, so don't bother reinserting and reparsing its text
+		if( from_cbuf && Cmd_CompileAlias( a ) )
+		{
+			Cmd_SetAliasTokens( a );
+			Cmd_ExecuteTokenized( a->value, true );
+			return;
+		}
+
 		Cbuf_InsertText( "\n" );
 		Cbuf_InsertText( a->value );
 	}
@@ -1361,6 +1555,74 @@ void Cmd_ExecuteString( const char *text )
 	}
 }
 
+/*
+* Cmd_ExecuteString
+* // Parses a single line of text into arguments and tries to execute it
+* // as if it was typed at the console
+*/
+void Cmd_ExecuteString( const char *text )
+{
+	bool from_cbuf = cmd_from_cbuf;
+
+	cmd_from_cbuf = false;
+
+	Cmd_TokenizeString( text );
+
+	Cmd_ExecuteTokenized( text, from_cbuf );
+}
+
+/*
+* Cmd_Nop_f
+*/
+static void Cmd_Nop_f( void )
+{
+}
+
+/*
+* Cmd_Bench_f
+*
+* Measures how many commands per second go through tokenizing and dispatching
+*/
+static void Cmd_Bench_f( void )
+{
+	static const char *lines[] =
+	{
+		"cmdbench_nop",
+		"cmdbench_nop \"some quoted argument\" 1 2 3 4 5 6 7 8",
+		"cmdbench_alias",
+	};
+	int i, j, count;
+	uint64_t start, usec;
+
+	count = Cmd_Argc() > 1 ? atoi( Cmd_Argv( 1 ) ) : 100000;
+	if( count <= 0 )
+	{
+		Com_Printf( "Usage: %s [count]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	Cmd_AddCommand( "cmdbench_nop", Cmd_Nop_f );
+	Cbuf_ExecuteText( EXEC_NOW, "alias cmdbench_alias \"cmdbench_nop 1 2 3\"" );
+
+	for( i = 0; i < (int)( sizeof( lines ) / sizeof( lines[0] ) ); i++ )
+	{
+		start = Sys_Microseconds();
+		for( j = 0; j < count; j++ )
+		{
+			// pretend the commands come from the buffer, for aliases to be expanded
+			cmd_from_cbuf = true;
+			Cmd_ExecuteString( lines[i] );
+			alias_count = 0;
+		}
+		usec = max( Sys_Microseconds() - start, 1 );
+
+		Com_Printf( "%-56s %10.0f commands per second\n", lines[i], count * 1000000.0 / usec );
+	}
+
+	Cbuf_ExecuteText( EXEC_NOW, "unalias cmdbench_alias" );
+	Cmd_RemoveCommand( "cmdbench_nop" );
+}
+
 /*
 * Cmd_List_f
 */
@@ -1428,6 +1690,7 @@ void Cmd_Init( void )
 	Cmd_AddCommand( "alias", Cmd_Alias_f );
 	Cmd_AddCommand( "wait", Cmd_Wait_f );
 	Cmd_AddCommand( "vstr", Cmd_VStr_f );
+	Cmd_AddCommand( "cmdbench", Cmd_Bench_f );
 
 	Cmd_SetCompletionFunc( "alias", Cmd_CompleteAliasBuildList );
 	Cmd_SetCompletionFunc( "aliasa", Cmd_CompleteAliasBuildList );
@@ -1437,6 +1700,23 @@ void Cmd_Init( void )
 	cmd_initialized = true;
 }
 
+/*
+* Cmd_ThreadShutdown
+* 
+* Frees the tokenized command of the calling thread. Threads that tokenize
+* commands must call this before they exit.
+*/
+void Cmd_ThreadShutdown( void )
+{
+	cmd_argc = 0;
+	if( cmd_tokens )
+	{
+		Mem_ZoneFree( cmd_tokens );
+		cmd_tokens = NULL;
+		cmd_tokens_size = cmd_tokens_used = 0;
+	}
+}
+
 void Cmd_Shutdown( void )
 {
 	if( cmd_initialized )
@@ -1457,13 +1737,9 @@ void Cmd_Shutdown( void )
 		Cmd_RemoveCommand( "alias" );
 		Cmd_RemoveCommand( "wait" );
 		Cmd_RemoveCommand( "vstr" );
+		Cmd_RemoveCommand( "cmdbench" );
 
-		// this is somewhat ugly IMO
-		for( i = 0; i < MAX_STRING_TOKENS && cmd_argv_sizes[i]; i++ )
-		{
-			Mem_ZoneFree( cmd_argv[i] );
-			cmd_argv_sizes[i] = 0;
-		}
+		Cmd_ThreadShutdown();
 
 		Trie_Dump( cmd_function_trie, "", TRIE_DUMP_VALUES, &dump );
 		for( i = 0; i < dump->size; ++i )
@@ -1488,6 +1764,7 @@ void Cmd_Shutdown( void )
 		cmd_alias_trie = NULL;
 		Trie_Destroy( cmd_function_trie );
 		cmd_function_trie = NULL;
+		Cmd_InvalidateLookups();
 
 		cmd_preinitialized = false;
 	}
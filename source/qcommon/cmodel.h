@@ -28,6 +28,7 @@ int c_pointcontents, c_traces, c_brush_traces;
 struct cmodel_s *CM_LoadMap( cmodel_state_t *cms, const char *name, bool clientload, unsigned *checksum );
 struct cmodel_s *CM_InlineModel( cmodel_state_t *cms, int num ); // 1, 2, etc
 char *CM_LoadMapMessage( char *name, char *message, int size );
+void CM_ReleaseMapFile( cmodel_state_t *cms );
 
 dvis_t *CM_PVSData( cmodel_state_t *cms );
 dvis_t *CM_PHSData( cmodel_state_t *cms );
@@ -833,6 +833,8 @@ void Qcommon_InitCommands( void )
 	Cmd_AddCommand( "irc_connect", Irc_Connect_f );
 	Cmd_AddCommand( "irc_disconnect", Irc_Disconnect_f );
 
+	Cmd_AddCommand( "dlbenchmark", DLWindow_Benchmark_f );
+
 	if( dedicated->integer )
 		Cmd_AddCommand( "quit", Com_Quit );
 
@@ -855,6 +857,8 @@ void Qcommon_ShutdownCommands( void )
 	Cmd_RemoveCommand( "irc_connect" );
 	Cmd_RemoveCommand( "irc_disconnect" );
 
+	Cmd_RemoveCommand( "dlbenchmark" );
+
 	if( dedicated->integer )
 		Cmd_RemoveCommand( "quit" );
 
@@ -956,6 +960,8 @@ void Qcommon_Init( int argc, char **argv )
 
 	Qcommon_InitCommands();
 
+	Prof_Init();
+
 	host_speeds =	    Cvar_Get( "host_speeds", "0", 0 );
 	developer =	    Cvar_Get( "developer", "0", 0 );
 	timescale =	    Cvar_Get( "timescale", "1.0", CVAR_CHEAT );
@@ -1058,6 +1064,10 @@ void Qcommon_Frame( unsigned int realmsec )
 	if( setjmp( abortframe ) )
 		return; // an ERR_DROP was thrown
 
+	Prof_Frame();
+	Cvar_Frame();
+	Prof_Begin( "frame" );
+
 	if( logconsole && logconsole->modified )
 	{
 		logconsole->modified = false;
@@ -1113,12 +1123,16 @@ void Qcommon_Frame( unsigned int realmsec )
 	if( host_speeds->integer )
 		time_before = Sys_Milliseconds();
 
+	Prof_Begin( "server" );
 	SV_Frame( realmsec, gamemsec );
+	Prof_End();
 
 	if( host_speeds->integer )
 		time_between = Sys_Milliseconds();
 
+	Prof_Begin( "client" );
 	CL_Frame( realmsec, gamemsec );
+	Prof_End();
 
 	if( host_speeds->integer )
 		time_after = Sys_Milliseconds();
@@ -1145,6 +1159,8 @@ void Qcommon_Frame( unsigned int realmsec )
 		frametick = Dynvar_Lookup( "frametick" );
 	Dynvar_CallListeners( frametick, &fc );
 	++fc;
+
+	Prof_End();
 }
 
 /*
@@ -1161,6 +1177,8 @@ void Qcommon_Shutdown( void )
 	}
 	isdown = true;
 
+	Prof_Shutdown();
+
 	Com_ScriptModule_Shutdown();
 	CM_Shutdown();
 	Netchan_Shutdown();
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "qcommon.h"
 #include "../qalgo/q_trie.h"
 #include "../client/console.h"
+#include "sys_threads.h"
 
 static bool	cvar_initialized = false;
 static bool	cvar_preinitialized = false;
@@ -66,6 +67,151 @@ static bool Cvar_InfoValidate( const char *s, bool name )
 		( name && strchr( s, Q_COLOR_ESCAPE ) ) );
 }
 
+/*
+* by-name lookup tracing
+*
+* Cvar_Find and friends walk the trie under a mutex, which is fine for one-off
+* lookups but adds up when done every frame. The tracer counts lookups per cvar
+* so that such callers can be found and switched to cvar_t pointers or handles.
+*/
+#define CVAR_LOOKUPS_HASH_SIZE	2048
+
+typedef struct
+{
+	const cvar_t *var;
+	unsigned int count;
+	unsigned int frames;
+	unsigned int lastFrame;
+} cvar_lookup_t;
+
+static bool cvar_lookups_active = false;
+static unsigned int cvar_lookups_frame;
+static unsigned int cvar_lookups_startFrame;
+static unsigned int cvar_lookups_misses;
+static cvar_lookup_t cvar_lookups[CVAR_LOOKUPS_HASH_SIZE];
+
+/*
+* Cvar_TraceLookup
+*
+* Must be called with cvar_mutex locked.
+*/
+static void Cvar_TraceLookup( const cvar_t *var )
+{
+	unsigned int i, hash;
+	cvar_lookup_t *lookup;
+
+	if( !var )
+	{
+		cvar_lookups_misses++;
+		return;
+	}
+
+	hash = (unsigned int)( ( (uintptr_t)var >> 4 ) * 2654435761u );
+	for( i = 0; i < CVAR_LOOKUPS_HASH_SIZE; i++ )
+	{
+		lookup = &cvar_lookups[( hash + i ) & ( CVAR_LOOKUPS_HASH_SIZE - 1 )];
+		if( !lookup->var )
+			lookup->var = var;
+		else if( lookup->var != var )
+			continue;
+
+		lookup->count++;
+		if( !lookup->frames || lookup->lastFrame != cvar_lookups_frame )
+		{
+			lookup->frames++;
+			lookup->lastFrame = cvar_lookups_frame;
+		}
+		return;
+	}
+}
+
+/*
+* Cvar_FindInTrie
+*/
+static cvar_t *Cvar_FindInTrie( const char *var_name )
+{
+	cvar_t *var;
+
+	assert( cvar_trie );
+	QMutex_Lock( cvar_mutex );
+	if( Trie_Find( cvar_trie, var_name, TRIE_EXACT_MATCH, (void **)&var ) != TRIE_OK )
+		var = NULL;
+	if( cvar_lookups_active )
+		Cvar_TraceLookup( var );
+	QMutex_Unlock( cvar_mutex );
+	return var;
+}
+
+/*
+* info strings
+*
+* Userinfo and serverinfo strings are kept around and updated in place when a
+* flagged cvar changes its value, so that requesting them doesn't have to go
+* through the whole trie. Flag changes are rare and just invalidate the string.
+*/
+#define CVAR_INFO_FLAGS ( CVAR_USERINFO|CVAR_SERVERINFO )
+
+typedef struct
+{
+	cvar_flag_t flag;
+	bool valid;
+	char string[MAX_INFO_STRING];
+} cvar_info_t;
+
+static cvar_info_t cvar_infos[] =
+{
+	{ CVAR_USERINFO, false, "" },
+	{ CVAR_SERVERINFO, false, "" },
+};
+
+/*
+* Cvar_InvalidateInfo
+*/
+static void Cvar_InvalidateInfo( cvar_flag_t flags )
+{
+	unsigned int i;
+
+	for( i = 0; i < sizeof( cvar_infos ) / sizeof( cvar_infos[0] ); i++ )
+	{
+		if( Cvar_FlagIsSet( flags, cvar_infos[i].flag ) )
+			cvar_infos[i].valid = false;
+	}
+}
+
+/*
+* Cvar_UpdateInfo
+*/
+static void Cvar_UpdateInfo( const cvar_t *var )
+{
+	unsigned int i;
+
+	for( i = 0; i < sizeof( cvar_infos ) / sizeof( cvar_infos[0] ); i++ )
+	{
+		cvar_info_t *info = &cvar_infos[i];
+
+		if( !info->valid || !Cvar_FlagIsSet( var->flags, info->flag ) )
+			continue;
+
+		// replacing a key moves it to the end, while versioncvar has to stay first
+		if( var == versioncvar || !Info_SetValueForKey( info->string, var->name, var->string ) )
+			info->valid = false;
+	}
+}
+
+/*
+* Cvar_UpdateValues
+*
+* Parses numeric values of the cvar after its string has been changed and bumps
+* the generation so that handles know their cached values are out of date.
+*/
+static void Cvar_UpdateValues( cvar_t *var )
+{
+	var->value = atof( var->string );
+	var->integer = Q_rint( var->value );
+	Sys_Atomic_Add( &var->generation, 1, cvar_mutex );
+	Cvar_UpdateInfo( var );
+}
+
 /*
 * Cvar_Initialized
 */
@@ -79,12 +225,23 @@ bool Cvar_Initialized( void )
 */
 cvar_t *Cvar_Find( const char *var_name )
 {
-	cvar_t *cvar;
-	assert( cvar_trie );
-	QMutex_Lock( cvar_mutex );
-	Trie_Find( cvar_trie, var_name, TRIE_EXACT_MATCH, (void **)&cvar );
-	QMutex_Unlock( cvar_mutex );
-	return cvar;
+	return Cvar_FindInTrie( var_name );
+}
+
+/*
+* Cvar_HandleVar
+*/
+cvar_t *Cvar_HandleVar( cvar_handle_t *handle )
+{
+	if( !handle->var )
+	{
+		// cvars are never freed before shutdown, so the pointer stays valid
+		handle->var = Cvar_FindInTrie( handle->name );
+		if( !handle->var )
+			return NULL;
+		handle->generation = handle->var->generation - 1;
+	}
+	return handle->var;
 }
 
 /*
@@ -95,7 +252,7 @@ float Cvar_Value( const char *var_name )
 {
 	const cvar_t *const var = Cvar_Find( var_name );
 	return var
-		? atof( var->string )
+		? var->value
 		: 0;
 }
 
@@ -129,6 +286,7 @@ int Cvar_Integer( const char *var_name )
 * Creates the variable if it doesn't exist.
 * If the variable already exists, the value will not be set
 * The flags will be or'ed and default value overwritten in if the variable exists.
+* If value is NULL, the existing variable is returned untouched, or NULL if there's none.
 */
 cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags )
 {
@@ -146,17 +304,15 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags
 		}
 	}
 
-	assert( cvar_trie );
-	QMutex_Lock( cvar_mutex );
-	Trie_Find( cvar_trie, var_name, TRIE_EXACT_MATCH, (void **)&var );
-	QMutex_Unlock( cvar_mutex );
+	var = Cvar_FindInTrie( var_name );
 
 	if( !var_value )
-		return NULL;
+		return var;
 
 	if( var )
 	{
 		bool reset = false;
+		cvar_flag_t oldFlags = var->flags;
 
 		if( !var->dvalue || strcmp( var->dvalue, var_value ) )
 		{
@@ -185,8 +341,7 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags
 				if( var->string )
 					Mem_ZoneFree( var->string );
 				var->string = ZoneCopyString( (char *) var_value );
-				var->value = atof( var->string );
-				var->integer = Q_rint( var->value );
+				Cvar_UpdateValues( var );
 			}
 			var->flags = flags;
 		}
@@ -195,6 +350,7 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags
 			userinfo_modified = true; // transmit at next oportunity
 
 		Cvar_FlagSet( &var->flags, flags );
+		Cvar_InvalidateInfo( oldFlags ^ var->flags );
 		return var;
 	}
 
@@ -212,8 +368,7 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags
 	strcpy( var->name, var_name );
 	var->dvalue = ZoneCopyString( (char *) var_value );
 	var->string = ZoneCopyString( (char *) var_value );
-	var->value = atof( var->string );
-	var->integer = Q_rint( var->value );
+	Cvar_UpdateValues( var );
 	var->flags = flags;
 	Cvar_SetModified( var );
 
@@ -221,6 +376,8 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, cvar_flag_t flags
 	Trie_Insert( cvar_trie, var_name, var );
 	QMutex_Unlock( cvar_mutex );
 
+	Cvar_InvalidateInfo( var->flags );
+
 	return var;
 }
 
@@ -311,8 +468,7 @@ static cvar_t *Cvar_Set2( const char *var_name, const char *value, bool force )
 					}
 					Mem_ZoneFree( var->string ); // free the old value string
 					var->string = ZoneCopyString( value );
-					var->value = atof( var->string );
-					var->integer = Q_rint( var->value );
+					Cvar_UpdateValues( var );
 					Cvar_SetModified( var );
 				}
 			}
@@ -337,8 +493,7 @@ static cvar_t *Cvar_Set2( const char *var_name, const char *value, bool force )
 	Mem_ZoneFree( var->string ); // free the old value string
 
 	var->string = ZoneCopyString( (char *) value );
-	var->value = atof( var->string );
-	var->integer = Q_rint( var->value );
+	Cvar_UpdateValues( var );
 	Cvar_SetModified( var );
 
 	return var;
@@ -368,11 +523,13 @@ cvar_t *Cvar_Set( const char *var_name, const char *value )
 cvar_t *Cvar_FullSet( const char *var_name, const char *value, cvar_flag_t flags, bool overwrite_flags )
 {
 	cvar_t *var;
+	cvar_flag_t oldFlags;
 
 	var = Cvar_Find( var_name );
 	if( !var )
 		return Cvar_Get( var_name, value, flags );
 
+	oldFlags = var->flags;
 	if( overwrite_flags )
 	{
 		var->flags = flags;
@@ -381,6 +538,7 @@ cvar_t *Cvar_FullSet( const char *var_name, const char *value, cvar_flag_t flags
 	{
 		Cvar_FlagSet( &var->flags, flags );
 	}
+	Cvar_InvalidateInfo( oldFlags ^ var->flags );
 
 	// if we overwrite the flags, we will also force the value
 	return Cvar_Set2( var_name, value, overwrite_flags );
@@ -434,8 +592,7 @@ void Cvar_GetLatchedVars( cvar_flag_t flags )
 		Mem_ZoneFree( var->string );
 		var->string = var->latched_string;
 		var->latched_string = NULL;
-		var->value = atof( var->string );
-		var->integer = Q_rint( var->value );
+		Cvar_UpdateValues( var );
 	}
 	Trie_FreeDump( dump );
 }
@@ -463,8 +620,7 @@ void Cvar_FixCheatVars( void )
 		cvar_t *const var = (cvar_t *) dump->key_value_vector[i].value;
 		Mem_ZoneFree( var->string );
 		var->string = ZoneCopyString( var->dvalue );
-		var->value = atof( var->string );
-		var->integer = Q_rint( var->value );
+		Cvar_UpdateValues( var );
 	}
 	Trie_FreeDump( dump );
 }
@@ -642,6 +798,73 @@ void Cvar_WriteVariables( int file )
 	Trie_FreeDump( dump );
 }
 
+/*
+* Cvar_LookupsCmp
+*/
+static int Cvar_LookupsCmp( const cvar_lookup_t *l1, const cvar_lookup_t *l2 )
+{
+	if( l1->count != l2->count )
+		return l1->count > l2->count ? -1 : 1;
+	return Q_stricmp( l1->var->name, l2->var->name );
+}
+
+/*
+* Cvar_Lookups_f
+*/
+static void Cvar_Lookups_f( void )
+{
+	unsigned int i, numLookups, numFrames;
+	cvar_lookup_t *lookups;
+	const char *cmd = Cmd_Argv( 1 );
+
+	if( !Q_stricmp( cmd, "start" ) || !Q_stricmp( cmd, "reset" ) )
+	{
+		QMutex_Lock( cvar_mutex );
+		memset( cvar_lookups, 0, sizeof( cvar_lookups ) );
+		cvar_lookups_misses = 0;
+		cvar_lookups_startFrame = cvar_lookups_frame;
+		if( !Q_stricmp( cmd, "start" ) )
+			cvar_lookups_active = true;
+		QMutex_Unlock( cvar_mutex );
+		return;
+	}
+	if( !Q_stricmp( cmd, "stop" ) )
+	{
+		cvar_lookups_active = false;
+		return;
+	}
+	if( *cmd )
+	{
+		Com_Printf( "Usage: %s [start|stop|reset]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	lookups = Mem_TempMalloc( sizeof( cvar_lookups ) );
+
+	QMutex_Lock( cvar_mutex );
+	for( i = 0, numLookups = 0; i < CVAR_LOOKUPS_HASH_SIZE; i++ )
+	{
+		if( cvar_lookups[i].var )
+			lookups[numLookups++] = cvar_lookups[i];
+	}
+	QMutex_Unlock( cvar_mutex );
+
+	qsort( lookups, numLookups, sizeof( *lookups ), ( int ( * )( const void *, const void * ) )Cvar_LookupsCmp );
+
+	numFrames = max( cvar_lookups_frame - cvar_lookups_startFrame, 1 );
+
+	Com_Printf( "Cvar lookups by name over %u frames%s:\n", numFrames, cvar_lookups_active ? "" : " (not tracing)" );
+	Com_Printf( "   count frames per frame name\n" );
+	for( i = 0; i < numLookups; i++ )
+	{
+		Com_Printf( "%8u %6u %9.2f %s\n", lookups[i].count, lookups[i].frames,
+			(float)lookups[i].count / numFrames, lookups[i].var->name );
+	}
+	Com_Printf( "%u lookups of undefined cvars\n", cvar_lookups_misses );
+
+	Mem_TempFree( lookups );
+}
+
 /*
 * Cvar_List_f
 */
@@ -733,11 +956,22 @@ bool userinfo_modified;
 
 static char *Cvar_BitInfo( int bit )
 {
-	static char info[MAX_INFO_STRING];
+	cvar_info_t *info = NULL;
 	struct trie_dump_s *dump = NULL;
 	unsigned int i;
+	size_t len, pairlen;
 
-	info[0] = 0;
+	for( i = 0; i < sizeof( cvar_infos ) / sizeof( cvar_infos[0] ); i++ )
+	{
+		if( cvar_infos[i].flag == bit )
+			info = &cvar_infos[i];
+	}
+	assert( info );
+
+	if( info->valid )
+		return info->string;
+
+	info->string[0] = 0;
 
 	assert( cvar_trie );
 	QMutex_Lock( cvar_mutex );
@@ -745,27 +979,32 @@ static char *Cvar_BitInfo( int bit )
 	QMutex_Unlock( cvar_mutex );
 
 	// make sure versioncvar comes first
-	for( i = dump->size; i > 0; --i )
-	{
-		cvar_t *const var = dump->key_value_vector[i-1].value;
-		if( var == versioncvar )
-		{
-			Info_SetValueForKey( info, var->name, var->string );
-			break;
-		}
-	}
+	if( versioncvar && Cvar_FlagIsSet( versioncvar->flags, bit ) )
+		Info_SetValueForKey( info->string, versioncvar->name, versioncvar->string );
+	len = strlen( info->string );
 
-	// dump other cvars
+	// dump other cvars, names are unique so the pairs can just be appended
 	for( i = 0; i < dump->size; ++i )
 	{
 		cvar_t *const var = dump->key_value_vector[i].value;
-		if( var != versioncvar )
-			Info_SetValueForKey( info, var->name, var->string );
+
+		if( var == versioncvar )
+			continue;
+		if( !Cvar_InfoValidate( var->name, true ) || !Cvar_InfoValidate( var->string, false ) )
+			continue;
+
+		pairlen = strlen( var->name ) + strlen( var->string ) + 2;
+		if( len + pairlen >= MAX_INFO_STRING )
+			continue;
+
+		Q_snprintfz( info->string + len, MAX_INFO_STRING - len, "\\%s\\%s", var->name, var->string );
+		len += pairlen;
 	}
 
 	Trie_FreeDump( dump );
 
-	return info;
+	info->valid = true;
+	return info->string;
 }
 
 /*
@@ -876,6 +1115,14 @@ char **Cvar_CompleteBuildListServer( const char *partial )
 	return Cvar_CompleteBuildListWithFlag( partial, CVAR_SERVERINFO );
 }
 
+/*
+* Cvar_Frame
+*/
+void Cvar_Frame( void )
+{
+	cvar_lookups_frame++;
+}
+
 /*
 * Cvar_PreInit
 */
@@ -914,6 +1161,7 @@ void Cvar_Init( void )
 	Cmd_AddCommand( "reset", Cvar_Reset_f );
 	Cmd_AddCommand( "toggle", Cvar_Toggle_f );
 	Cmd_AddCommand( "cvarlist", Cvar_List_f );
+	Cmd_AddCommand( "cvarlookups", Cvar_Lookups_f );
 
 	Cmd_SetCompletionFunc( "set", Cvar_CompleteBuildList );
 	Cmd_SetCompletionFunc( "seta", Cvar_CompleteBuildList );
@@ -968,6 +1216,7 @@ void Cvar_Shutdown( void )
 		Cmd_RemoveCommand( "reset" );
 		Cmd_RemoveCommand( "toggle" );
 		Cmd_RemoveCommand( "cvarlist" );
+		Cmd_RemoveCommand( "cvarlookups" );
 #ifndef PUBLIC_BUILD
 		Cmd_RemoveCommand( "cvararchivelist" );
 #endif
@@ -987,6 +1236,11 @@ void Cvar_Shutdown( void )
 		}
 		Trie_FreeDump( dump );
 
+		cvar_lookups_active = false;
+		memset( cvar_lookups, 0, sizeof( cvar_lookups ) );
+
+		Cvar_InvalidateInfo( CVAR_INFO_FLAGS );
+
 		cvar_initialized = false;
 	}
 
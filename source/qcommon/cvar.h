@@ -40,6 +40,22 @@ static inline void	    Cvar_UnsetModified( cvar_t *var );
 // Medar: undefined untill used, so gcc doesn't whine
 //static inline cvar_type_t	Cvar_GetType(const cvar_t *var);
 
+// handles cache the by-name lookup of a cvar for code that can't keep a cvar_t
+// pointer around, e.g. because the cvar is registered by some other module
+typedef struct
+{
+	const char *name;
+	cvar_t *var;
+	int generation;
+} cvar_handle_t;
+
+#define CVAR_HANDLE( name ) { name, NULL, 0 }
+
+static inline float	    Cvar_HandleValue( cvar_handle_t *handle );
+static inline int	    Cvar_HandleInteger( cvar_handle_t *handle );
+static inline const char *Cvar_HandleString( cvar_handle_t *handle );
+static inline bool	    Cvar_HandleModified( cvar_handle_t *handle );
+
 // this is set each time a CVAR_USERINFO variable is changed so
 // that the client knows to send it to the server
 extern bool	userinfo_modified;
@@ -67,6 +83,7 @@ const char *Cvar_String( const char *var_name );
 int	    Cvar_Integer( const char *var_name );
 void	    Cmd_WriteAliases( int file );
 cvar_t      *Cvar_Find ( const char *var_name );
+cvar_t      *Cvar_HandleVar( cvar_handle_t *handle );
 int	    Cvar_CompleteCountPossible( const char *partial );
 char **Cvar_CompleteBuildList( const char *partial );
 char *Cvar_TabComplete( const char *partial );
@@ -77,6 +94,7 @@ void	    Cvar_WriteVariables( int file );
 void	    Cvar_PreInit( void );
 void	    Cvar_Init( void );
 void	    Cvar_Shutdown( void );
+void	    Cvar_Frame( void );
 char *Cvar_Userinfo( void );
 char *Cvar_Serverinfo( void );
 
@@ -124,6 +142,31 @@ static inline void Cvar_UnsetModified( cvar_t *var )
 	var->modified = ( bool )0;
 }
 
+static inline float Cvar_HandleValue( cvar_handle_t *handle )
+{
+	const cvar_t *var = handle->var ? handle->var : Cvar_HandleVar( handle );
+	return var ? var->value : 0;
+}
+static inline int Cvar_HandleInteger( cvar_handle_t *handle )
+{
+	const cvar_t *var = handle->var ? handle->var : Cvar_HandleVar( handle );
+	return var ? var->integer : 0;
+}
+static inline const char *Cvar_HandleString( cvar_handle_t *handle )
+{
+	const cvar_t *var = handle->var ? handle->var : Cvar_HandleVar( handle );
+	return var ? var->string : "";
+}
+// returns true once after each change of the value, unlike var->modified this is per handle
+static inline bool Cvar_HandleModified( cvar_handle_t *handle )
+{
+	const cvar_t *var = handle->var ? handle->var : Cvar_HandleVar( handle );
+	if( !var || handle->generation == var->generation )
+		return false;
+	handle->generation = var->generation;
+	return true;
+}
+
 static inline cvar_flag_t Cvar_FlagSet( cvar_flag_t *flags, cvar_flag_t flag )
 {
 	return *flags |= flag;
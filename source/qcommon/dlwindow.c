@@ -0,0 +1,409 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// dlwindow.c -- sliding window for server to client file transfers
+
+#include "qcommon.h"
+
+/*
+
+The file is split into DLWINDOW_BLOCKSIZE blocks, the sender keeps up to
+DLWINDOW_MAXBLOCKS of them in flight. The receiver acknowledges with the
+first block it is missing and a bitmask of the blocks it already has
+after that one, so a lost block only costs a retransmit of that block.
+
+Sending is paced by a token bucket. The rate starts low, doubles every
+round trip until the first loss and is then adjusted additive increase,
+multiplicative decrease, never exceeding the rate allowed by the caller.
+
+*/
+
+#define DLWINDOW_MINRTO			100
+#define DLWINDOW_MAXRTO			3000
+
+/*
+* DLWindow_BlockLength
+*/
+int DLWindow_BlockLength( int size, int block )
+{
+	int length = size - block * DLWINDOW_BLOCKSIZE;
+
+	return bound( 0, length, DLWINDOW_BLOCKSIZE );
+}
+
+/*
+* DLWindow_ClampRate
+*/
+static void DLWindow_ClampRate( dlwindow_sender_t *s, int maxrate )
+{
+	if( s->rate > maxrate )
+		s->rate = maxrate;
+	if( s->rate < min( DLWINDOW_MINRATE, maxrate ) )
+		s->rate = min( DLWINDOW_MINRATE, maxrate );
+}
+
+/*
+* DLWindow_InitSender
+*/
+void DLWindow_InitSender( dlwindow_sender_t *s, int size, int maxrate, unsigned int time )
+{
+	memset( s, 0, sizeof( *s ) );
+
+	s->size = size;
+	s->numblocks = ( size + DLWINDOW_BLOCKSIZE - 1 ) / DLWINDOW_BLOCKSIZE;
+	s->rate = maxrate / 4;
+	DLWindow_ClampRate( s, maxrate );
+	s->credit = DLWINDOW_BLOCKSIZE;
+	s->slowstart = true;
+	s->lasttime = s->lastloss = time;
+	s->rto = 1000;
+}
+
+/*
+* DLWindow_NextBlock
+*
+* Returns the block to be sent now, or -1 if the rate or window doesn't allow it.
+* Blocks which haven't been acknowledged in time are resent first.
+*/
+int DLWindow_NextBlock( dlwindow_sender_t *s, int maxrate, unsigned int time )
+{
+	int block, slot, length;
+
+	DLWindow_ClampRate( s, maxrate );
+
+	if( time > s->lasttime )
+	{
+		s->credit += (int)( (int64_t)s->rate * ( time - s->lasttime ) / 1000 );
+		s->credit = min( s->credit, max( s->rate / 10, DLWINDOW_BLOCKSIZE * 2 ) );
+		s->lasttime = time;
+	}
+
+	if( s->credit <= 0 )
+		return -1;
+
+	for( block = s->base; block < s->next; block++ )
+	{
+		if( s->acked & ( 1u << ( block - s->base ) ) )
+			continue;
+
+		slot = block % DLWINDOW_MAXBLOCKS;
+		if( time - s->senttime[slot] < (unsigned)s->rto )
+			continue;
+
+		// lost, back off once per round trip
+		if( time - s->lastloss >= (unsigned)( s->srtt ? s->srtt : s->rto ) )
+		{
+			s->rate -= s->rate / 4;
+			DLWindow_ClampRate( s, maxrate );
+			s->slowstart = false;
+			s->lastloss = time;
+			s->rto = min( s->rto * 2, DLWINDOW_MAXRTO );
+		}
+
+		if( s->sendcount[slot] < 255 )
+			s->sendcount[slot]++;
+		s->resent++;
+		goto send;
+	}
+
+	if( s->next >= s->numblocks || s->next >= s->base + DLWINDOW_MAXBLOCKS )
+		return -1;
+
+	block = s->next++;
+	slot = block % DLWINDOW_MAXBLOCKS;
+	s->sendcount[slot] = 1;
+
+send:
+	length = DLWindow_BlockLength( s->size, block );
+	s->senttime[slot] = time;
+	s->credit -= length;
+	s->sentbytes += length;
+	return block;
+}
+
+/*
+* DLWindow_SampleRTT
+*/
+static int DLWindow_SampleRTT( dlwindow_sender_t *s, int block, unsigned int time )
+{
+	int slot = block % DLWINDOW_MAXBLOCKS;
+	int sample;
+
+	// Karn's rule, resent blocks give ambiguous samples
+	if( s->sendcount[slot] == 1 )
+	{
+		sample = (int)( time - s->senttime[slot] );
+		s->srtt = s->srtt ? ( s->srtt * 7 + sample ) / 8 : sample;
+		s->rto = bound( DLWINDOW_MINRTO, s->srtt * 2 + 50, DLWINDOW_MAXRTO );
+	}
+
+	return DLWindow_BlockLength( s->size, block );
+}
+
+/*
+* DLWindow_Ack
+*
+* base is the first block the receiver is missing, bit n of mask is set
+* when it has block base+1+n. Acks may arrive late, so base can go back.
+*/
+void DLWindow_Ack( dlwindow_sender_t *s, int base, unsigned int mask, int maxrate, unsigned int time )
+{
+	int n, block, bytes = 0;
+
+	base = bound( 0, base, s->numblocks );
+
+	if( base > s->base )
+	{
+		for( block = s->base; block < base && block < s->next; block++ )
+		{
+			if( !( s->acked & ( 1u << ( block - s->base ) ) ) )
+				bytes += DLWindow_SampleRTT( s, block, time );
+		}
+
+		s->acked = base - s->base < DLWINDOW_MAXBLOCKS ? s->acked >> ( base - s->base ) : 0;
+		s->base = base;
+
+		// the receiver may already have a part of the file from an earlier attempt
+		if( s->next < s->base )
+			s->next = s->base;
+	}
+
+	for( n = 0; n < DLWINDOW_MAXBLOCKS && base + 1 + n < s->next; n++ )
+	{
+		block = base + 1 + n;
+		if( !( mask & ( 1u << n ) ) || block < s->base || block >= s->base + DLWINDOW_MAXBLOCKS )
+			continue;
+		if( s->acked & ( 1u << ( block - s->base ) ) )
+			continue;
+
+		s->acked |= 1u << ( block - s->base );
+		bytes += DLWindow_SampleRTT( s, block, time );
+	}
+
+	if( !bytes )
+		return;
+
+	if( s->slowstart )
+		s->rate += bytes;
+	else if( s->srtt )
+		s->rate += (int)( (int64_t)bytes * DLWINDOW_BLOCKSIZE * 1000 / ( (int64_t)s->rate * s->srtt ) );
+	else
+		s->rate += (int)( (int64_t)bytes * DLWINDOW_BLOCKSIZE / s->rate );
+
+	DLWindow_ClampRate( s, maxrate );
+}
+
+/*
+* DLWindow_SenderDone
+*/
+bool DLWindow_SenderDone( const dlwindow_sender_t *s )
+{
+	return s->base >= s->numblocks;
+}
+
+/*
+* DLWindow_InitReceiver
+*
+* offset is the amount of data already present at the start of the file
+*/
+void DLWindow_InitReceiver( dlwindow_receiver_t *r, int size, int offset )
+{
+	memset( r, 0, sizeof( *r ) );
+
+	r->size = size;
+	r->numblocks = ( size + DLWINDOW_BLOCKSIZE - 1 ) / DLWINDOW_BLOCKSIZE;
+	r->base = bound( 0, offset / DLWINDOW_BLOCKSIZE, r->numblocks );
+	r->bytes = min( r->base * DLWINDOW_BLOCKSIZE, size );
+}
+
+/*
+* DLWindow_ReceiveBlock
+*
+* Returns false for invalid or duplicate blocks, which should not be written
+*/
+bool DLWindow_ReceiveBlock( dlwindow_receiver_t *r, int offset, int length )
+{
+	int block, n;
+
+	if( offset < 0 || offset % DLWINDOW_BLOCKSIZE )
+		return false;
+
+	block = offset / DLWINDOW_BLOCKSIZE;
+	if( block < r->base || block >= r->numblocks )
+		return false;
+	if( length != DLWindow_BlockLength( r->size, block ) )
+		return false;
+
+	if( block == r->base )
+	{
+		// slide past all the blocks we already have
+		r->base++;
+		while( r->mask & 1 )
+		{
+			r->mask >>= 1;
+			r->base++;
+		}
+		r->mask >>= 1;
+	}
+	else
+	{
+		n = block - r->base - 1;
+		if( n >= DLWINDOW_MAXBLOCKS || ( r->mask & ( 1u << n ) ) )
+			return false;
+		r->mask |= 1u << n;
+	}
+
+	r->bytes += length;
+	return true;
+}
+
+/*
+* DLWindow_ReceiverDone
+*/
+bool DLWindow_ReceiverDone( const dlwindow_receiver_t *r )
+{
+	return r->base >= r->numblocks;
+}
+
+//============================================================================
+
+#define DLBENCH_QUEUE_SIZE		256
+#define DLBENCH_SERVER_FRAME	16
+#define DLBENCH_CLIENT_FRAME	8
+#define DLBENCH_MAX_TIME		( 30 * 60 * 1000 )
+
+typedef struct
+{
+	unsigned int time;
+	int a, b;
+} dlbench_packet_t;
+
+typedef struct
+{
+	int count;
+	dlbench_packet_t packets[DLBENCH_QUEUE_SIZE];
+} dlbench_queue_t;
+
+/*
+* DLWindow_BenchQueue
+*/
+static void DLWindow_BenchQueue( dlbench_queue_t *q, unsigned int time, int a, int b )
+{
+	if( q->count == DLBENCH_QUEUE_SIZE )
+		return; // overflow, counts as lost
+
+	q->packets[q->count].time = time;
+	q->packets[q->count].a = a;
+	q->packets[q->count].b = b;
+	q->count++;
+}
+
+/*
+* DLWindow_BenchDequeue
+*/
+static bool DLWindow_BenchDequeue( dlbench_queue_t *q, unsigned int time, dlbench_packet_t *p )
+{
+	int i;
+
+	for( i = 0; i < q->count; i++ )
+	{
+		if( q->packets[i].time <= time )
+		{
+			*p = q->packets[i];
+			q->packets[i] = q->packets[--q->count];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+* DLWindow_Benchmark_f
+*
+* Simulates a transfer over a link with the given latency and packet loss
+* and compares it with the nextdl block per round trip protocol.
+*/
+void DLWindow_Benchmark_f( void )
+{
+	int size, rtt, rate, block, numblocks;
+	float loss;
+	unsigned int time, swtime;
+	bool ackpending = false;
+	dlwindow_sender_t s;
+	dlwindow_receiver_t r;
+	dlbench_packet_t p;
+	static dlbench_queue_t data, acks;
+
+	if( Cmd_Argc() > 5 || ( Cmd_Argc() > 1 && !Q_stricmp( Cmd_Argv( 1 ), "help" ) ) )
+	{
+		Com_Printf( "Usage: %s [kbytes] [rtt msec] [loss percent] [rate]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	size = ( Cmd_Argc() > 1 ? max( atoi( Cmd_Argv( 1 ) ), 1 ) : 2048 ) * 1024;
+	rtt = Cmd_Argc() > 2 ? max( atoi( Cmd_Argv( 2 ) ), 0 ) : 100;
+	loss = Cmd_Argc() > 3 ? bound( 0, atof( Cmd_Argv( 3 ) ), 90 ) * 0.01f : 0.02f;
+	rate = Cmd_Argc() > 4 ? max( atoi( Cmd_Argv( 4 ) ), 1000 ) : 60000;
+
+	data.count = acks.count = 0;
+	DLWindow_InitSender( &s, size, rate, 0 );
+	DLWindow_InitReceiver( &r, size, 0 );
+
+	for( time = 0; !DLWindow_ReceiverDone( &r ) && time < DLBENCH_MAX_TIME; time++ )
+	{
+		while( DLWindow_BenchDequeue( &data, time, &p ) )
+			ackpending |= DLWindow_ReceiveBlock( &r, p.a * DLWINDOW_BLOCKSIZE, p.b );
+
+		while( DLWindow_BenchDequeue( &acks, time, &p ) )
+			DLWindow_Ack( &s, p.a, (unsigned)p.b, rate, time );
+
+		if( !( time % DLBENCH_SERVER_FRAME ) )
+		{
+			while( ( block = DLWindow_NextBlock( &s, rate, time ) ) >= 0 )
+			{
+				if( random() >= loss )
+					DLWindow_BenchQueue( &data, time + rtt / 2, block, DLWindow_BlockLength( size, block ) );
+			}
+		}
+
+		if( !( time % DLBENCH_CLIENT_FRAME ) && ackpending )
+		{
+			// acks are reliable commands, a lost one goes out again with the next packet
+			DLWindow_BenchQueue( &acks, time + rtt / 2 + ( random() < loss ? DLBENCH_CLIENT_FRAME : 0 ), r.base, (int)r.mask );
+			ackpending = false;
+		}
+	}
+
+	// nextdl: one FRAGMENT_SIZE*2 block per round trip, 3 seconds timeout on loss
+	numblocks = ( size + FRAGMENT_SIZE * 2 - 1 ) / ( FRAGMENT_SIZE * 2 );
+	for( swtime = 0, block = 0; block < numblocks && swtime < DLBENCH_MAX_TIME; block++ )
+	{
+		while( random() < loss && swtime < DLBENCH_MAX_TIME )
+			swtime += 3000;
+		swtime += rtt;
+	}
+
+	Com_Printf( "%i KB, %i msec rtt, %.1f%% loss, rate %i\n", size / 1024, rtt, loss * 100.0f, rate );
+	Com_Printf( "windowed: %.1f KB/s, %.2f sec, %i resent blocks\n",
+		(float)r.bytes / 1024.0f / ( max( time, 1 ) * 0.001f ), time * 0.001f, s.resent );
+	Com_Printf( "nextdl:   %.1f KB/s, %.2f sec\n",
+		(float)size / 1024.0f / ( max( swtime, 1 ) * 0.001f ), swtime * 0.001f );
+}
@@ -26,7 +26,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "compression.h"
 #include "wswcurl.h"
 #include "../qalgo/md5.h"
-#include "../qalgo/q_trie.h"
+#include "zipindex.h"
 
 /*
 =============================================================================
@@ -40,13 +40,8 @@ QUAKE FILESYSTEM
 
 #define FS_ZIP_BUFSIZE				0x00004000
 
-#define FS_ZIP_BUFREADCOMMENT	    0x00000400
 #define FS_ZIP_SIZELOCALHEADER	    0x0000001e
-#define FS_ZIP_SIZECENTRALDIRITEM   0x0000002e
-
 #define FS_ZIP_LOCALHEADERMAGIC	    0x04034b50
-#define FS_ZIP_CENTRALHEADERMAGIC   0x02014b50
-#define FS_ZIP_ENDHEADERMAGIC	    0x06054b50
 
 #define FS_PAK_MANIFEST_FILE		"manifest.txt"
 
@@ -118,9 +113,8 @@ typedef struct pack_s
 	void *sysHandle;
 	void *vfsHandle;
 	int numFiles;
-	packfile_t *files;
-	char *fileNames;
-	trie_t *trie;
+	packfile_t *files;			// in the order of the index entries
+	zipindex_t *index;
 } pack_t;
 
 typedef struct filehandle_s
@@ -194,6 +188,20 @@ static mempool_t *fs_mempool;
 
 static filehandle_t fs_filehandles[FS_MAX_HANDLES];
 static filehandle_t fs_filehandles_headnode, *fs_free_filehandles;
+
+// files shared through FS_LoadMappedFile, either mapped into memory or read into the heap
+typedef struct fs_mappedfile_s
+{
+	char *name;
+	int file;                       // kept open while the file is mapped, 0 for heap copies
+	void *data;
+	size_t size;
+	int refcount;
+	struct fs_mappedfile_s *next;
+} fs_mappedfile_t;
+
+static fs_mappedfile_t *fs_mappedfiles;
+static qmutex_t *fs_mappedfiles_mutex;
 static qmutex_t *fs_fh_mutex;
 
 static int fs_notifications = 0;
@@ -351,17 +359,16 @@ static bool FS_VFSPathForFileName( const searchpath_t *search, const char *fileN
 */
 static bool FS_SearchPakForFile( pack_t *pak, const char *filename, packfile_t **pout )
 {
-	packfile_t *pakFile = NULL;
-	trie_error_t trie_error;
+	int num;
 
 	assert( pak );
 	assert( filename );
 
-	trie_error = Trie_Find( pak->trie, filename, TRIE_EXACT_MATCH, ( void ** )&pakFile );
+	num = ZipIndex_Find( pak->index, filename );
 	if( pout ) {
-		*pout = pakFile;
+		*pout = num >= 0 ? &pak->files[num] : NULL;
 	}
-	return trie_error == TRIE_OK ? true : false;
+	return num >= 0;
 }
 
 /*
@@ -1959,6 +1966,136 @@ void FS_FreeFile( void *buffer )
 	Mem_TempFree( buffer );
 }
 
+/*
+* FS_LoadMappedFile
+*
+* Returns a read-only view of the file, shared by all callers that load the same
+* file until the last one releases it with FS_FreeMappedFile. Uncompressed files
+* are mapped into memory, others are read into the heap once. If mapped is not
+* NULL, it's set to true for memory mapped files.
+*/
+int FS_LoadMappedFile( const char *path, void **buffer, bool *mapped )
+{
+	int file, len;
+	void *data;
+	filehandle_t *fh;
+	fs_mappedfile_t *mf;
+
+	*buffer = NULL;
+	if( mapped )
+		*mapped = false;
+
+	QMutex_Lock( fs_mappedfiles_mutex );
+
+	for( mf = fs_mappedfiles; mf; mf = mf->next )
+	{
+		if( !Q_stricmp( mf->name, path ) )
+			break;
+	}
+
+	if( !mf )
+	{
+		len = FS_FOpenFile( path, &file, FS_READ );
+		if( !file )
+		{
+			QMutex_Unlock( fs_mappedfiles_mutex );
+			return -1;
+		}
+		if( len <= 0 )
+		{
+			FS_FCloseFile( file );
+			QMutex_Unlock( fs_mappedfiles_mutex );
+			return -1;
+		}
+
+		// lumps are read as integers, don't map files stored at unaligned offsets in packs
+		data = NULL;
+		fh = FS_FileHandleForNum( file );
+		if( !fh->zipEntry && !fh->gzstream && !( fh->pakOffset & 3 ) )
+			data = FS_MMapBaseFile( file, len, fh->pakOffset );
+
+		if( !data )
+		{
+			data = FS_Malloc( len + 1 );
+			if( FS_Read( data, len, file ) != len )
+			{
+				FS_Free( data );
+				FS_FCloseFile( file );
+				QMutex_Unlock( fs_mappedfiles_mutex );
+				return -1;
+			}
+			FS_FCloseFile( file );
+			file = 0;
+		}
+
+		mf = FS_Malloc( sizeof( *mf ) + strlen( path ) + 1 );
+		mf->name = ( char * )( mf + 1 );
+		strcpy( mf->name, path );
+		mf->file = file;
+		mf->data = data;
+		mf->size = len;
+		mf->next = fs_mappedfiles;
+		fs_mappedfiles = mf;
+	}
+
+	mf->refcount++;
+
+	*buffer = mf->data;
+	if( mapped )
+		*mapped = mf->file != 0;
+
+	QMutex_Unlock( fs_mappedfiles_mutex );
+
+	return mf->size;
+}
+
+/*
+* FS_FreeMappedFile
+*/
+void FS_FreeMappedFile( void *buffer )
+{
+	fs_mappedfile_t *mf, **prev;
+
+	if( !buffer )
+		return;
+
+	QMutex_Lock( fs_mappedfiles_mutex );
+
+	for( prev = &fs_mappedfiles, mf = fs_mappedfiles; mf; prev = &mf->next, mf = mf->next )
+	{
+		if( mf->data == buffer )
+			break;
+	}
+
+	if( !mf )
+	{
+		QMutex_Unlock( fs_mappedfiles_mutex );
+		Com_Printf( S_COLOR_YELLOW "FS_FreeMappedFile: unknown buffer\n" );
+		return;
+	}
+
+	if( --mf->refcount > 0 )
+	{
+		QMutex_Unlock( fs_mappedfiles_mutex );
+		return;
+	}
+
+	*prev = mf->next;
+
+	if( mf->file )
+	{
+		FS_UnMMapBaseFile( mf->file, mf->data );
+		FS_FCloseFile( mf->file );
+	}
+	else
+	{
+		FS_Free( mf->data );
+	}
+	FS_Free( mf );
+
+	QMutex_Unlock( fs_mappedfiles_mutex );
+}
+
 /*
 * FS_FreeBaseFile
 */
@@ -2427,65 +2564,6 @@ static void FS_ReadPackManifest( pack_t *pack )
 	}
 }
 
-/*
-* FS_PK3SearchCentralDir
-* 
-* Locate the central directory of a zipfile (at the end, just before the global comment)
-*/
-static unsigned FS_PK3SearchCentralDir( FILE *fin, void *vfsHandle )
-{
-	unsigned fileSize, backRead;
-	unsigned maxBack = 0xffff; // maximum size of global comment
-	unsigned char buf[FS_ZIP_BUFREADCOMMENT+4];
-	unsigned vfsOffset = 0;
-
-	if( vfsHandle )
-	{
-		vfsOffset = Sys_VFS_FileOffset( vfsHandle );
-		if( fseek( fin, vfsOffset + Sys_VFS_FileSize( vfsHandle ), SEEK_SET ) != 0 )
-			return 0;
-	}
-	else
-	{
-		if( fseek( fin, 0, SEEK_END ) != 0 )
-			return 0;
-	}
-
-	fileSize = ftell( fin ) - vfsOffset;
-	if( maxBack > fileSize )
-		maxBack = fileSize;
-
-	backRead = 4;
-	while( backRead < maxBack )
-	{
-		unsigned i, readSize, readPos;
-
-		if( backRead + FS_ZIP_BUFREADCOMMENT > maxBack )
-			backRead = maxBack;
-		else
-			backRead += FS_ZIP_BUFREADCOMMENT;
-
-		readPos = fileSize - backRead;
-		readSize = min( FS_ZIP_BUFREADCOMMENT + 4, backRead );
-		if( readSize < 4 )
-			continue;
-
-		if( fseek( fin, vfsOffset + readPos, SEEK_SET ) != 0 )
-			break;
-		if( fread( buf, 1, readSize, fin ) != readSize )
-			break;
-
-		for( i = readSize - 3; i--; )
-		{
-			// check the magic
-			if( LittleLongRaw( buf + i ) == FS_ZIP_ENDHEADERMAGIC )
-				return readPos + i;
-		}
-	}
-
-	return 0;
-}
-
 /*
 * FS_DosTimeToUnixtime
 * 
@@ -2511,67 +2589,6 @@ static time_t FS_DosTimeToUnixtime( unsigned dosDateTime )
 	return time;
 }
 
-/*
-* FS_PK3GetFileInfo
-* 
-* Get Info about the current file in the zipfile, with internal only info
-*/
-static unsigned FS_PK3GetFileInfo( FILE *f, void *vfsHandle, unsigned pos, unsigned byteBeforeTheZipFile, 
-	packfile_t *file, size_t *fileNameLen, int *crc )
-{
-	size_t sizeRead;
-	unsigned dosDateTime;
-	unsigned compressed;
-	unsigned char infoHeader[46]; // we can't use a struct here because of packing
-
-	if( fseek( f, Sys_VFS_FileOffset( vfsHandle ) + pos, SEEK_SET ) != 0 )
-		return 0;
-	if( fread( infoHeader, 1, sizeof( infoHeader ), f ) != sizeof( infoHeader ) )
-		return 0;
-
-	// check the magic
-	if( LittleLongRaw( &infoHeader[0] ) != FS_ZIP_CENTRALHEADERMAGIC )
-		return 0;
-
-	compressed = LittleShortRaw( &infoHeader[10] );
-	if( compressed && ( compressed != Z_DEFLATED ) )
-		return 0;
-
-	dosDateTime = LittleLongRaw( &infoHeader[12] );
-
-	if( crc )
-		*crc = LittleLongRaw( &infoHeader[16] );
-	if( file )
-	{
-		if( compressed == Z_DEFLATED )
-			file->flags |= FS_PACKFILE_DEFLATED;
-		file->compressedSize = LittleLongRaw( &infoHeader[20] );
-		file->uncompressedSize = LittleLongRaw( &infoHeader[24] );
-		file->offset = LittleLongRaw( &infoHeader[42] ) + byteBeforeTheZipFile;
-		file->mtime = FS_DosTimeToUnixtime( dosDateTime );
-	}
-
-	sizeRead = ( size_t )LittleShortRaw( &infoHeader[28] );
-	if( !sizeRead )
-		return 0;
-
-	if( fileNameLen )
-		*fileNameLen = sizeRead;
-
-	if( file )
-	{
-		if( fread( file->name, 1, sizeRead, f ) != sizeRead )
-			return 0;
-
-		*( file->name + sizeRead ) = 0;
-		if( *( file->name + sizeRead - 1 ) == '/' )
-			file->flags |= FS_PACKFILE_DIRECTORY;
-	}
-
-	return FS_ZIP_SIZECENTRALDIRITEM + ( unsigned )LittleShortRaw( &infoHeader[28] ) +
-		( unsigned )LittleShortRaw( &infoHeader[30] ) + ( unsigned )LittleShortRaw( &infoHeader[32] );
-}
-
 /*
 * FS_LoadPK3File
 * 
@@ -2584,14 +2601,12 @@ static pack_t *FS_LoadPK3File( const char *packfilename, bool silent )
 {
 	int i;
 	int *checksums = NULL;
-	int numFiles;
-	size_t namesLen, len;
 	pack_t *pack = NULL;
 	packfile_t *file;
-	FILE *fin = NULL;
-	char *names;
-	unsigned char zipHeader[20]; // we can't use a struct here because of packing
-	unsigned offset, centralPos, sizeCentralDir, offsetCentralDir, byteBeforeTheZipFile;
+	zipindex_t *index = NULL;
+	const zipentry_t *entry;
+	const char *error = NULL;
+	const char *ext;
 	bool modulepack;
 	int manifestFilesize;
 	void *handle = NULL;
@@ -2611,82 +2626,28 @@ static pack_t *FS_LoadPK3File( const char *packfilename, bool silent )
 		}
 	}
 
-	fin = fopen( vfsHandle ? Sys_VFS_VFSName( vfsHandle ) : packfilename, "rb" );
-	if( fin == NULL )
-	{
-		if( !silent ) Com_Printf( "Error opening PK3 file: %s\n", packfilename );
-		goto error;
-	}
-	centralPos = FS_PK3SearchCentralDir( fin, vfsHandle );
-	if( centralPos == 0 )
-	{
-		if( !silent ) Com_Printf( "No central directory found for PK3 file: %s\n", packfilename );
-		goto error;
-	}
-	if( fseek( fin, Sys_VFS_FileOffset( vfsHandle ) + centralPos, SEEK_SET ) != 0 )
-	{
-		if( !silent ) Com_Printf( "Error seeking PK3 file: %s\n", packfilename );
-		goto error;
-	}
-	if( fread( zipHeader, 1, sizeof( zipHeader ), fin ) != sizeof( zipHeader ) )
-	{
-		if( !silent ) Com_Printf( "Error reading PK3 file: %s\n", packfilename );
-		goto error;
-	}
-
-	// total number of entries in the central dir on this disk
-	numFiles = LittleShortRaw( &zipHeader[8] );
-	if( !numFiles )
-	{
-		if( !silent ) Com_Printf( "%s is not a valid pk3 file\n", packfilename );
-		goto error;
-	}
-	if( LittleShortRaw( &zipHeader[10] ) != numFiles || LittleShortRaw( &zipHeader[6] ) != 0
-		|| LittleShortRaw( &zipHeader[4] ) != 0 )
-	{
-		if( !silent ) Com_Printf( "%s is not a valid pk3 file\n", packfilename );
-		goto error;
-	}
-
-	// size of the central directory
-	sizeCentralDir = LittleLongRaw( &zipHeader[12] );
-
-	// offset of start of central directory with respect to the starting disk number
-	offsetCentralDir = LittleLongRaw( &zipHeader[16] );
-	if( centralPos < offsetCentralDir + sizeCentralDir )
+	// partially downloaded files are checked once and then renamed
+	ext = COM_FileExtension( packfilename );
+	index = ZipIndex_Load( fs_mempool, vfsHandle ? Sys_VFS_VFSName( vfsHandle ) : packfilename,
+		Sys_VFS_FileOffset( vfsHandle ), Sys_VFS_FileSize( vfsHandle ),
+		( ext && !Q_stricmp( ext, ".tmp" ) ) ? ZIPINDEX_NOCACHE : 0, &error );
+	if( !index )
 	{
-		if( !silent ) Com_Printf( "%s is not a valid pk3 file\n", packfilename );
+		if( !silent ) Com_Printf( "%s: PK3 file %s\n", error, packfilename );
 		goto error;
 	}
-	byteBeforeTheZipFile = centralPos - offsetCentralDir - sizeCentralDir;
-
-	for( i = 0, namesLen = 0, centralPos = offsetCentralDir + byteBeforeTheZipFile; i < numFiles; i++, centralPos += offset )
-	{
-		offset = FS_PK3GetFileInfo( fin, vfsHandle, centralPos, byteBeforeTheZipFile, NULL, &len, NULL );
-		if( !offset )
-		{
-			if( !silent ) Com_Printf( "%s is not a valid pk3 file\n", packfilename );
-			goto error; // something wrong occured
-		}
-		namesLen += len + 1;
-	}
 
-	namesLen += 1; // add space for a guard
-
-	pack = ( pack_t* )FS_Malloc( (int)( sizeof( pack_t ) + numFiles * sizeof( packfile_t ) + namesLen) );
+	pack = ( pack_t* )FS_Malloc( (int)( sizeof( pack_t ) + index->numEntries * sizeof( packfile_t ) ) );
 	pack->filename = FS_CopyString( packfilename );
 	pack->files = ( packfile_t * )( ( uint8_t * )pack + sizeof( pack_t ) );
-	pack->fileNames = names = ( char * )( ( uint8_t * )pack->files + numFiles * sizeof( packfile_t ) );
-	pack->numFiles = numFiles;
+	pack->numFiles = index->numEntries;
 	pack->sysHandle = handle;
 	pack->vfsHandle = vfsHandle;
-	pack->trie = NULL;
+	pack->index = index;
 	pack->pure = FS_IsExplicitPurePak( packfilename, NULL ) ? FS_PURE_EXPLICIT : FS_PURE_NONE;
 
-	Trie_Create( TRIE_CASE_INSENSITIVE, &pack->trie );
-
 	// allocate temp memory for files' checksums
-	checksums = ( int* )Mem_TempMallocExt( ( numFiles + 1 ) * sizeof( *checksums ), 0 );
+	checksums = ( int* )Mem_TempMallocExt( ( index->numEntries + 1 ) * sizeof( *checksums ), 0 );
 
 	if( !Q_strnicmp( COM_FileBase( packfilename ), "modules", strlen( "modules" ) ) )
 		modulepack = true;
@@ -2695,18 +2656,23 @@ static pack_t *FS_LoadPK3File( const char *packfilename, bool silent )
 
 	manifestFilesize = -1;
 
-	// add all files to the trie
-	for( i = 0, file = pack->files, centralPos = offsetCentralDir + byteBeforeTheZipFile; i < numFiles; i++, file++, centralPos += offset, names += len + 1 )
+	for( i = 0, file = pack->files, entry = index->entries; i < index->numEntries; i++, file++, entry++ )
 	{
-		const char *ext;
-		trie_error_t trie_err;
-		packfile_t *trie_file;
-
-		file->name = names;
+		file->name = index->names + entry->name;
 		file->pakname = pack->filename;
 		file->vfsHandle = vfsHandle;
+		file->flags = 0;
+		if( entry->flags & ZIPENTRY_DEFLATED )
+			file->flags |= FS_PACKFILE_DEFLATED;
+		if( entry->flags & ZIPENTRY_DIRECTORY )
+			file->flags |= FS_PACKFILE_DIRECTORY;
+		file->compressedSize = entry->compressedSize;
+		file->uncompressedSize = entry->uncompressedSize;
+		file->offset = entry->offset;
+		file->mtime = FS_DosTimeToUnixtime( entry->dosDateTime );
 
-		offset = FS_PK3GetFileInfo( fin, vfsHandle, centralPos, byteBeforeTheZipFile, file, &len, &checksums[i] );
+		// the checksum depends on the order of files in the archive
+		checksums[entry->order] = entry->crc;
 
 		if( !COM_ValidateRelativeFilename( file->name ) )
 		{
@@ -2727,21 +2693,14 @@ static pack_t *FS_LoadPK3File( const char *packfilename, bool silent )
 		}
 		else
 		{
-			if( !Q_stricmp( file->name, FS_PAK_MANIFEST_FILE ) && !(file->flags & FS_PACKFILE_DIRECTORY) )
+			if( !Q_stricmp( file->name, FS_PAK_MANIFEST_FILE ) && !(file->flags & FS_PACKFILE_DIRECTORY)
+				&& !( entry->flags & ZIPENTRY_SHADOWED ) )
 				manifestFilesize = file->uncompressedSize;
 		}
-
-		trie_err = Trie_Replace( pack->trie, file->name, file, (void **)&trie_file );
-		if( trie_err == TRIE_KEY_NOT_FOUND ) {
-			Trie_Insert( pack->trie, file->name, file );
-		}
 	}
 
-	fclose( fin );
-	fin = NULL;
-
-	checksums[numFiles] = 0x1234567; // add some pseudo-random stuff
-	pack->checksum = FS_ChecksumPK3File( pack->filename, numFiles + 1, checksums );
+	checksums[index->numEntries] = 0x1234567; // add some pseudo-random stuff
+	pack->checksum = FS_ChecksumPK3File( pack->filename, index->numEntries + 1, checksums );
 
 	if( !pack->checksum )
 	{
@@ -2760,16 +2719,14 @@ static pack_t *FS_LoadPK3File( const char *packfilename, bool silent )
 	return pack;
 
 error:
-	if( fin )
-		fclose( fin );
 	if( pack )
 	{
-		if( pack->trie )
-			Trie_Destroy( pack->trie );
 		if( pack->filename )
 			FS_Free( pack->filename );
 		FS_Free( pack );
 	}
+	if( index )
+		ZipIndex_Free( index );
 	if( checksums )
 		Mem_TempFree( checksums );
 	if( handle != NULL )
@@ -2790,10 +2747,12 @@ static pack_t *FS_LoadPakFile( const char *packfilename, bool silent )
 	unsigned int	i, j;
 	FILE			*fin = NULL;
 	int				*checksums = NULL;
-	char			*p, *names, dirName[56];
+	char			*p, *names = NULL, dirName[56];
 	const char		*ext;
 	packfile_t		*file;
 	pack_t			*pack = NULL;
+	zipindex_t		*index = NULL;
+	zipentry_t		*entries = NULL, *entry;
 	// c++
 	typedef struct { int ident; int	dirofs; int dirlen; } fs_header_t;
 	typedef struct { char name[56]; int filepos, filelen; } fs_info_t;
@@ -2900,18 +2859,48 @@ static pack_t *FS_LoadPakFile( const char *packfilename, bool silent )
 
 	namesLen += 1; // add space for a guard
 
-	pack = ( pack_t* )Mem_Alloc( fs_mempool, ( sizeof( pack_t ) + (numFiles + numDirs) * sizeof( packfile_t ) + namesLen ) );
+	// index all files and dirs
+	entries = ( zipentry_t * )Mem_TempMalloc( (numFiles + numDirs) * sizeof( *entries ) );
+	names = ( char * )Mem_TempMalloc( namesLen );
+
+	for( i = 0, len = 0, entry = entries; i < numFiles + numDirs; i++, entry++ )
+	{
+		const char *name = i < numFiles ? info[i].name : dirs[i - numFiles].name;
+
+		entry->name = len;
+		entry->order = i;
+		strcpy( names + len, name );
+		len += strlen( name ) + 1;
+
+		if( i < numFiles )
+		{
+			if( !COM_FileExtension( name ) && name[strlen( name ) - 1] == '/' )
+				entry->flags = ZIPENTRY_DIRECTORY;
+			entry->offset = entry->dataOffset = LittleLong( info[i].filepos );
+			entry->compressedSize = entry->uncompressedSize = LittleLong( info[i].filelen );
+		}
+		else
+		{
+			entry->flags = ZIPENTRY_DIRECTORY;
+		}
+	}
+
+	index = ZipIndex_Build( fs_mempool, entries, numFiles + numDirs, names, namesLen );
+
+	Mem_TempFree( entries );
+	entries = NULL;
+	Mem_TempFree( names );
+	names = NULL;
+
+	pack = ( pack_t* )Mem_Alloc( fs_mempool, ( sizeof( pack_t ) + (numFiles + numDirs) * sizeof( packfile_t ) ) );
 	pack->filename = FS_CopyString( packfilename );
 	pack->files = ( packfile_t * )( ( uint8_t * )pack + sizeof( pack_t ) );
-	pack->fileNames = names = ( char * )( ( uint8_t * )pack->files + (numFiles + numDirs) * sizeof( packfile_t ) );
 	pack->numFiles = numFiles + numDirs;
 	pack->sysHandle = handle;
 	pack->vfsHandle = vfsHandle;
-	pack->trie = NULL;
+	pack->index = index;
 	pack->pure = FS_IsExplicitPurePak( packfilename, NULL ) ? FS_PURE_EXPLICIT : FS_PURE_NONE;
 
-	Trie_Create( TRIE_CASE_INSENSITIVE, &pack->trie );
-
 	// allocate temp memory for files' checksums
 	checksums = ( int* )Mem_TempMallocExt( ( numFiles + 1 ) * sizeof( *checksums ), 0 );
 
@@ -2922,63 +2911,43 @@ static pack_t *FS_LoadPakFile( const char *packfilename, bool silent )
 
 	manifestFilesize = -1;
 
-	// add all files and dirs
-	for( i = 0, file = pack->files; i < numFiles + numDirs; i++, file++ )
+	for( i = 0, file = pack->files, entry = index->entries; i < numFiles + numDirs; i++, file++, entry++ )
 	{
-		trie_error_t trie_err;
-		packfile_t *trie_file;
-
-		file->name = names;
+		file->name = index->names + entry->name;
 		file->pakname = pack->filename;
 		file->vfsHandle = vfsHandle;
 
 		file->flags = FS_PACKFILE_COHERENT;
-		if( i < numFiles )
-		{
-			strcpy( file->name, info[i].name );
-			names += strlen( file->name ) + 1;
-
-			ext = COM_FileExtension( file->name );
+		if( entry->flags & ZIPENTRY_DIRECTORY )
+			file->flags |= FS_PACKFILE_DIRECTORY;
+		file->offset = entry->offset;
+		file->compressedSize = entry->compressedSize;
+		file->uncompressedSize = entry->uncompressedSize;
+		file->mtime = 0;
 
-			if( !ext )
-			{
-				if( file->name[strlen( file->name ) - 1] == '/' )
-					file->flags |= FS_PACKFILE_DIRECTORY;
-			}
+		if( entry->order >= numFiles )
+			continue;
 
-			file->offset = LittleLong( info[i].filepos );
-			file->compressedSize = file->uncompressedSize = LittleLong( info[i].filelen );
-			file->mtime = 0;
+		ext = COM_FileExtension( file->name );
 
-			// only module packs can include libraries
-			if( !modulepack )
-			{
-				if( ext && (!Q_stricmp( ext, ".so" ) || !Q_stricmp( ext, ".dll" ) || !Q_stricmp( ext, ".dylib" )) )
-				{
-					if( !silent )
-						Com_Printf( "%s is not module pack, but includes module file: %s\n", packfilename, file->name );
-					goto error;
-				}
-			}
-			else
+		// only module packs can include libraries
+		if( !modulepack )
+		{
+			if( ext && (!Q_stricmp( ext, ".so" ) || !Q_stricmp( ext, ".dll" ) || !Q_stricmp( ext, ".dylib" )) )
 			{
-				if( !Q_stricmp( file->name, FS_PAK_MANIFEST_FILE ) && !(file->flags & FS_PACKFILE_DIRECTORY) )
-					manifestFilesize = file->uncompressedSize;
+				if( !silent )
+					Com_Printf( "%s is not module pack, but includes module file: %s\n", packfilename, file->name );
+				goto error;
 			}
-
-			checksums[i] = file->offset + file->compressedSize; // FIXME
 		}
 		else
 		{
-			file->flags |= FS_PACKFILE_DIRECTORY;
-			strcpy( file->name, dirs[i - numFiles].name );
-			ext = NULL;
+			if( !Q_stricmp( file->name, FS_PAK_MANIFEST_FILE ) && !(file->flags & FS_PACKFILE_DIRECTORY)
+				&& !( entry->flags & ZIPENTRY_SHADOWED ) )
+				manifestFilesize = file->uncompressedSize;
 		}
 
-		trie_err = Trie_Replace( pack->trie, file->name, file, (void **)&trie_file );
-		if( trie_err == TRIE_KEY_NOT_FOUND ) {
-			Trie_Insert( pack->trie, file->name, file );
-		}
+		checksums[entry->order] = file->offset + file->compressedSize; // FIXME
 	}
 
 	fclose( fin );
@@ -3016,6 +2985,12 @@ error:
 			FS_Free( pack->filename );
 		FS_Free( pack );
 	}
+	if( index )
+		ZipIndex_Free( index );
+	if( entries )
+		Mem_TempFree( entries );
+	if( names )
+		Mem_TempFree( names );
 	if( checksums )
 		Mem_TempFree( checksums );
 	if( info )
@@ -3146,7 +3121,7 @@ static void FS_FreePakFile( pack_t *pack )
 {
 	if( pack->sysHandle )
 		Sys_FS_UnlockFile( pack->sysHandle );
-	Trie_Destroy( pack->trie );
+	ZipIndex_Free( pack->index );
 	FS_Free( pack->filename );
 	FS_Free( pack );
 }
@@ -3196,20 +3171,6 @@ bool FS_CheckPakExtension( const char *filename )
 	return false;
 }
 
-/*
-* FS_PatternMatchesPackfile
-*/
-static int FS_PatternMatchesPackfile( void *file, void *pattern )
-{
-	const char *cpattern = ( const char * )pattern;
-	packfile_t *packfile = ( packfile_t * )file;
-
-	assert( cpattern != NULL );
-	assert( packfile != NULL );
-
-	return Com_GlobMatch( cpattern, packfile->name, false );
-}
-
 /*
 * FS_PathGetFileListExt
 */
@@ -3344,48 +3305,46 @@ static int FS_PathGetFileListExt( searchpath_t *search, const char *dir, const c
 	}
 	else
 	{
-		unsigned int t;
-		struct trie_dump_s *trie_dump = NULL;
-		trie_error_t trie_err;
-		char *pattern;
+		int t, first, num;
+		char *name;
+		const char *p;
+		packfile_t *pakfile;
+		const zipindex_t *index = search->pack->index;
 
 		Q_snprintfz( tempname, sizeof( tempname ), "%s%s*%s", 
 			dirlen ? dir : "", 
 			dirlen ? "/" : "",
 			extension ? extension : "" );
 
-		pattern = tempname;
-		trie_err = Trie_DumpIf( search->pack->trie, dirlen ? dir : "", TRIE_DUMP_VALUES, 
-			FS_PatternMatchesPackfile, pattern, &trie_dump );
+		// names sharing the directory prefix are contiguous in the sorted index
+		first = ZipIndex_FindPrefix( index, dirlen ? dir : "", &num );
 
-		if( trie_err == TRIE_OK ) {
-			char *name;
-			const char *p;
-			packfile_t *pakfile;
+		for( t = first; t < first + num; t++ ) {
+			if( index->entries[t].flags & ZIPENTRY_SHADOWED )
+				continue;
 
-			for( t = 0; t < trie_dump->size; t++ ) {
-				pakfile = ( (packfile_t *) ( trie_dump->key_value_vector[t].value ) );
-				name = dirlen ? pakfile->name + dirlen + 1 : pakfile->name;
+			pakfile = &search->pack->files[t];
+			if( !Com_GlobMatch( tempname, pakfile->name, false ) )
+				continue;
 
-				if( !name[0] )
-					continue;
+			name = dirlen ? pakfile->name + dirlen + 1 : pakfile->name;
 
-				// ignore subdirectories
-				p = strchr( name, '/' );
-				if( p )
-				{
-					if( *( p + 1 ) )
-						continue;
-				}
+			if( !name[0] )
+				continue;
 
-				files[found].name = name;
-				files[found].searchPath = search;
-				if( ++found == size )
-					break;
+			// ignore subdirectories
+			p = strchr( name, '/' );
+			if( p )
+			{
+				if( *( p + 1 ) )
+					continue;
 			}
-		}
 
-		Trie_FreeDump( trie_dump );
+			files[found].name = name;
+			files[found].searchPath = search;
+			if( ++found == size )
+				break;
+		}
 	}
 
 	return found;
@@ -4433,43 +4392,42 @@ static void Cmd_FS_SearchExt_f( int cantHaveFlags, int mustHaveFlags )
 
 	for( search = fs_searchpaths; search; search = search->next )
 	{
-		unsigned int i;
+		int i;
 		pack_t *pack;
 		packfile_t *pakfile;
 		bool first;
-		struct trie_dump_s *trie_dump = NULL;
-		trie_error_t trie_err;
 
 		pack = search->pack;
 		if( !pack )
 			continue;
 
-		trie_err = Trie_DumpIf( pack->trie, "", TRIE_DUMP_VALUES, 
-			FS_PatternMatchesPackfile, pattern, &trie_dump );
+		first = true;
 
-		if( trie_err == TRIE_OK ) {
-			first = true;
+		for( i = 0; i < pack->numFiles; i++ ) {
+			if( pack->index->entries[i].flags & ZIPENTRY_SHADOWED ) {
+				continue;
+			}
 
-			for( i = 0; i < trie_dump->size; i++ ) {
-				pakfile = ( (packfile_t *) ( trie_dump->key_value_vector[i].value ) );
+			pakfile = &pack->files[i];
 
-				if( mustHaveFlags && !(pakfile->flags & mustHaveFlags) ) {
-					continue;
-				}
-				if( cantHaveFlags && (pakfile->flags & cantHaveFlags) ) {
-					continue;
-				}
+			if( mustHaveFlags && !(pakfile->flags & mustHaveFlags) ) {
+				continue;
+			}
+			if( cantHaveFlags && (pakfile->flags & cantHaveFlags) ) {
+				continue;
+			}
+			if( !Com_GlobMatch( pattern, pakfile->name, false ) ) {
+				continue;
+			}
 
-				if( first )
-				{
-					Com_Printf( "\n" S_COLOR_YELLOW "%s%s\n", pack->filename, pack->pure ? " (P)" : "" );
-					first = false;
-				}
-				Com_Printf( "   %s\n", pakfile->name );
-				total++;
+			if( first )
+			{
+				Com_Printf( "\n" S_COLOR_YELLOW "%s%s\n", pack->filename, pack->pure ? " (P)" : "" );
+				first = false;
 			}
+			Com_Printf( "   %s\n", pakfile->name );
+			total++;
 		}
-		Trie_FreeDump( trie_dump );
 	}
 
 	QMutex_Unlock( fs_searchpaths_mutex );
@@ -4587,6 +4545,7 @@ void FS_Init( void )
 
 	fs_fh_mutex = QMutex_Create();
 	fs_searchpaths_mutex = QMutex_Create();
+	fs_mappedfiles_mutex = QMutex_Create();
 
 	fs_mempool = Mem_AllocPool( NULL, "Filesystem" );
 	
@@ -4759,6 +4718,7 @@ void FS_Shutdown( void )
 
 	QMutex_Destroy( &fs_fh_mutex );
 	QMutex_Destroy( &fs_searchpaths_mutex );
+	QMutex_Destroy( &fs_mappedfiles_mutex );
 
 	fs_initialized = false;
 }
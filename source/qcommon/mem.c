@@ -113,6 +113,9 @@ mempool_t *zoneMemPool;
 
 static qmutex_t *memMutex;
 
+// sum of the sizes of all allocations, and its high-water mark since Mem_ResetPeakSize
+static size_t mem_totalsize, mem_peaksize;
+
 static bool memory_initialized = false;
 static bool commands_initialized = false;
 
@@ -158,6 +161,10 @@ void *_Mem_AllocExt( mempool_t *pool, size_t size, size_t alignment, int z, int
 	pool->totalsize += size;
 	realsize = sizeof( memheader_t ) + size + alignment + sizeof( int );
 
+	mem_totalsize += size;
+	if( mem_totalsize > mem_peaksize )
+		mem_peaksize = mem_totalsize;
+
 	pool->realsize += realsize;
 
 	base = malloc( realsize );
@@ -279,6 +286,7 @@ void _Mem_Free( void *data, int musthave, int canthave, const char *filename, in
 
 	// memheader has been unlinked, do the actual free now
 	pool->totalsize -= mem->size;
+	mem_totalsize -= mem->size;
 
 	base = mem->baseaddress;
 	pool->realsize -= mem->realsize;
@@ -447,6 +455,34 @@ void _Mem_EmptyPool( mempool_t *pool, int musthave, int canthave, const char *fi
 		Mem_Free( (void *)( (uint8_t *) pool->chain + sizeof( memheader_t ) ) );
 }
 
+/*
+* Mem_TotalSize
+*/
+size_t Mem_TotalSize( void )
+{
+	return mem_totalsize;
+}
+
+/*
+* Mem_PeakSize
+*
+* The most memory that has been allocated at once since the last Mem_ResetPeakSize
+*/
+size_t Mem_PeakSize( void )
+{
+	return mem_peaksize;
+}
+
+/*
+* Mem_ResetPeakSize
+*/
+void Mem_ResetPeakSize( void )
+{
+	QMutex_Lock( memMutex );
+	mem_peaksize = mem_totalsize;
+	QMutex_Unlock( memMutex );
+}
+
 size_t Mem_PoolTotalSize( mempool_t *pool )
 {
 	assert( pool != NULL );
@@ -541,6 +577,7 @@ static void Mem_PrintStats( void )
 
 	Com_Printf( "%i memory pools, totalling %i bytes (%.3fMB), %i bytes (%.3fMB) actual\n", total, totalsize, totalsize / 1048576.0,
 		realsize, realsize / 1048576.0 );
+	Com_Printf( "peak allocated: %.3fMB\n", mem_peaksize / 1048576.0 );
 
 	// temporary pools are not nested
 	for( pool = poolChain; pool; pool = pool->next )
@@ -252,7 +252,7 @@ int MSG_SkipData( msg_t *msg, size_t length )
 static char *MSG_ReadString2( msg_t *msg, bool linebreak )
 {
 	int l, c;
-	static char string[MAX_MSG_STRING_CHARS];
+	static ATTRIBUTE_TLS char string[MAX_MSG_STRING_CHARS];
 
 	l = 0;
 	do
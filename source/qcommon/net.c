@@ -33,6 +33,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#define NET_POLL_EPOLL
+#else
+#include <poll.h>
+#define NET_POLL_POLL
+#endif
 #endif
 
 #define	MAX_LOOPBACK	4
@@ -1919,6 +1927,363 @@ int NET_Monitor( int msec, socket_t *sockets[], void (*read_cb)(socket_t *, void
 	return ret;
 }
 
+/*
+=============================================================================
+POLL SETS
+
+A set of sockets which is kept between waits, with per-socket events of interest.
+Uses epoll on Linux, poll() on other unixes and select() on Windows.
+=============================================================================
+*/
+
+typedef struct
+{
+	socket_t *socket;			// NULL for free slots
+	int events;
+	void *privatep;
+	int nextfree;
+} netpollentry_t;
+
+struct netpoll_s
+{
+	netpollentry_t *entries;
+	int numentries, maxentries;
+	int firstfree;
+#if defined( NET_POLL_EPOLL )
+	int epfd;
+	struct epoll_event *events;
+	int maxevents;
+#elif defined( NET_POLL_POLL )
+	struct pollfd *fds;
+	int *fdids;
+	int maxfds;
+#endif
+};
+
+/*
+* NET_Poll_Create
+*/
+netpoll_t *NET_Poll_Create( void )
+{
+	netpoll_t *np;
+
+	np = Mem_ZoneMalloc( sizeof( *np ) );
+	np->firstfree = -1;
+
+#ifdef NET_POLL_EPOLL
+	np->epfd = epoll_create( 64 );
+	if( np->epfd < 0 )
+	{
+		NET_SetErrorStringFromLastError( "epoll_create" );
+		Mem_ZoneFree( np );
+		return NULL;
+	}
+#endif
+
+	return np;
+}
+
+/*
+* NET_Poll_Destroy
+*/
+void NET_Poll_Destroy( netpoll_t **pnp )
+{
+	netpoll_t *np = *pnp;
+
+	if( !np )
+		return;
+
+#if defined( NET_POLL_EPOLL )
+	close( np->epfd );
+	if( np->events )
+		Mem_ZoneFree( np->events );
+#elif defined( NET_POLL_POLL )
+	if( np->fds )
+	{
+		Mem_ZoneFree( np->fds );
+		Mem_ZoneFree( np->fdids );
+	}
+#endif
+
+	if( np->entries )
+		Mem_ZoneFree( np->entries );
+	Mem_ZoneFree( np );
+	*pnp = NULL;
+}
+
+#ifdef NET_POLL_EPOLL
+/*
+* NET_Poll_EpollControl
+*
+* Sockets without events of interest are kept out of the epoll set,
+* as hang-ups would be reported for them anyway
+*/
+static bool NET_Poll_EpollControl( netpoll_t *np, int id, int oldevents, int newevents )
+{
+	int op;
+	struct epoll_event ev;
+
+	if( !oldevents && !newevents )
+		return true;
+
+	if( !oldevents )
+		op = EPOLL_CTL_ADD;
+	else if( !newevents )
+		op = EPOLL_CTL_DEL;
+	else
+		op = EPOLL_CTL_MOD;
+
+	memset( &ev, 0, sizeof( ev ) );
+	ev.events = ( ( newevents & NET_POLL_READ ) ? EPOLLIN : 0 ) | ( ( newevents & NET_POLL_WRITE ) ? EPOLLOUT : 0 );
+	ev.data.u32 = id;
+
+	if( epoll_ctl( np->epfd, op, np->entries[id].socket->handle, &ev ) < 0 )
+	{
+		NET_SetErrorStringFromLastError( "epoll_ctl" );
+		return false;
+	}
+	return true;
+}
+#endif
+
+/*
+* NET_Poll_Add
+*
+* Returns an id which stays valid until the socket is removed, or -1 on error
+*/
+int NET_Poll_Add( netpoll_t *np, socket_t *socket, int events, void *privatep )
+{
+	int id;
+	netpollentry_t *entry;
+
+	assert( socket->open );
+
+	if( np->firstfree >= 0 )
+	{
+		id = np->firstfree;
+		np->firstfree = np->entries[id].nextfree;
+	}
+	else
+	{
+		if( np->numentries == np->maxentries )
+		{
+			np->maxentries = max( np->maxentries * 2, 16 );
+			if( np->entries )
+				np->entries = Mem_Realloc( np->entries, np->maxentries * sizeof( *np->entries ) );
+			else
+				np->entries = Mem_ZoneMalloc( np->maxentries * sizeof( *np->entries ) );
+		}
+		id = np->numentries++;
+	}
+
+	entry = &np->entries[id];
+	entry->socket = socket;
+	entry->events = 0;
+	entry->privatep = privatep;
+	entry->nextfree = -1;
+
+	if( !NET_Poll_Modify( np, id, events ) )
+	{
+		NET_Poll_Remove( np, id );
+		return -1;
+	}
+	return id;
+}
+
+/*
+* NET_Poll_Modify
+*/
+bool NET_Poll_Modify( netpoll_t *np, int id, int events )
+{
+	netpollentry_t *entry;
+
+	if( id < 0 || id >= np->numentries || !np->entries[id].socket )
+		return false;
+
+	entry = &np->entries[id];
+	if( entry->events == events )
+		return true;
+
+#ifdef NET_POLL_EPOLL
+	if( !NET_Poll_EpollControl( np, id, entry->events, events ) )
+		return false;
+#endif
+
+	entry->events = events;
+	return true;
+}
+
+/*
+* NET_Poll_Remove
+*
+* Must be called before the socket is closed
+*/
+void NET_Poll_Remove( netpoll_t *np, int id )
+{
+	netpollentry_t *entry;
+
+	if( id < 0 || id >= np->numentries || !np->entries[id].socket )
+		return;
+
+	entry = &np->entries[id];
+#ifdef NET_POLL_EPOLL
+	NET_Poll_EpollControl( np, id, entry->events, 0 );
+#endif
+
+	entry->socket = NULL;
+	entry->events = 0;
+	entry->privatep = NULL;
+	entry->nextfree = np->firstfree;
+	np->firstfree = id;
+}
+
+/*
+* NET_Poll_Dispatch
+*
+* Callbacks may add and remove sockets, so the entry is looked up again between them
+*/
+static void NET_Poll_Dispatch( netpoll_t *np, int id, bool readable, bool writable,
+	void (*read_cb)(socket_t *, void*), void (*write_cb)(socket_t *, void*) )
+{
+	if( readable && read_cb && np->entries[id].socket && ( np->entries[id].events & NET_POLL_READ ) )
+		read_cb( np->entries[id].socket, np->entries[id].privatep );
+	if( writable && write_cb && np->entries[id].socket && ( np->entries[id].events & NET_POLL_WRITE ) )
+		write_cb( np->entries[id].socket, np->entries[id].privatep );
+}
+
+/*
+* NET_Poll_Wait
+*
+* Waits for events for up to msec milliseconds and calls the callbacks for the ready sockets.
+* Errors and hang-ups are reported as both events so that the owner notices them on the next read or write.
+* Returns the number of ready sockets or -1 on error.
+*/
+int NET_Poll_Wait( netpoll_t *np, int msec, void (*read_cb)(socket_t *, void*), void (*write_cb)(socket_t *, void*) )
+{
+	int i, ret;
+#if defined( NET_POLL_EPOLL )
+	int id;
+	unsigned int ev;
+
+	if( !np->maxevents || np->maxevents < np->numentries )
+	{
+		np->maxevents = max( np->maxentries, 16 );
+		if( np->events )
+			Mem_ZoneFree( np->events );
+		np->events = Mem_ZoneMalloc( np->maxevents * sizeof( *np->events ) );
+	}
+
+	ret = epoll_wait( np->epfd, np->events, np->maxevents, msec );
+	if( ret < 0 )
+	{
+		if( errno == EINTR )
+			return 0;
+		NET_SetErrorStringFromLastError( "epoll_wait" );
+		return -1;
+	}
+
+	for( i = 0; i < ret; i++ )
+	{
+		id = np->events[i].data.u32;
+		ev = np->events[i].events;
+		if( id >= np->numentries )
+			continue;
+		NET_Poll_Dispatch( np, id, ( ev & ( EPOLLIN|EPOLLERR|EPOLLHUP ) ) != 0,
+			( ev & ( EPOLLOUT|EPOLLERR|EPOLLHUP ) ) != 0, read_cb, write_cb );
+	}
+#elif defined( NET_POLL_POLL )
+	int numfds, numentries;
+	short rev;
+
+	if( np->maxfds < np->numentries )
+	{
+		np->maxfds = np->maxentries;
+		if( np->fds )
+		{
+			Mem_ZoneFree( np->fds );
+			Mem_ZoneFree( np->fdids );
+		}
+		np->fds = Mem_ZoneMalloc( np->maxfds * sizeof( *np->fds ) );
+		np->fdids = Mem_ZoneMalloc( np->maxfds * sizeof( *np->fdids ) );
+	}
+
+	numfds = 0;
+	for( i = 0; i < np->numentries; i++ )
+	{
+		if( !np->entries[i].socket || !np->entries[i].events )
+			continue;
+		np->fds[numfds].fd = np->entries[i].socket->handle;
+		np->fds[numfds].events = ( ( np->entries[i].events & NET_POLL_READ ) ? POLLIN : 0 ) |
+			( ( np->entries[i].events & NET_POLL_WRITE ) ? POLLOUT : 0 );
+		np->fds[numfds].revents = 0;
+		np->fdids[numfds] = i;
+		numfds++;
+	}
+
+	ret = poll( np->fds, numfds, msec );
+	if( ret < 0 )
+	{
+		if( errno == EINTR )
+			return 0;
+		NET_SetErrorStringFromLastError( "poll" );
+		return -1;
+	}
+
+	// callbacks may add sockets and reallocate fds, but only those present at the time of the call are checked
+	numentries = numfds;
+	for( i = 0; i < numentries && ret > 0; i++ )
+	{
+		rev = np->fds[i].revents;
+		if( !rev )
+			continue;
+		NET_Poll_Dispatch( np, np->fdids[i], ( rev & ( POLLIN|POLLERR|POLLHUP ) ) != 0,
+			( rev & ( POLLOUT|POLLERR|POLLHUP ) ) != 0, read_cb, write_cb );
+	}
+#else
+	struct timeval timeout;
+	fd_set fdsetr, fdsetw, fdsete;
+	int numentries;
+	socket_handle_t handle;
+
+	FD_ZERO( &fdsetr );
+	FD_ZERO( &fdsetw );
+	FD_ZERO( &fdsete );
+
+	for( i = 0; i < np->numentries; i++ )
+	{
+		if( !np->entries[i].socket || !np->entries[i].events )
+			continue;
+		handle = np->entries[i].socket->handle;
+		if( np->entries[i].events & NET_POLL_READ )
+			FD_SET( handle, &fdsetr );
+		if( np->entries[i].events & NET_POLL_WRITE )
+			FD_SET( handle, &fdsetw );
+		FD_SET( handle, &fdsete );
+	}
+
+	timeout.tv_sec = msec / 1000;
+	timeout.tv_usec = ( msec % 1000 ) * 1000;
+	ret = select( FD_SETSIZE, &fdsetr, &fdsetw, &fdsete, &timeout );
+	if( ret < 0 )
+	{
+		NET_SetErrorStringFromLastError( "select" );
+		return -1;
+	}
+
+	numentries = np->numentries;
+	for( i = 0; i < numentries && ret > 0; i++ )
+	{
+		if( !np->entries[i].socket || !np->entries[i].events )
+			continue;
+		handle = np->entries[i].socket->handle;
+		NET_Poll_Dispatch( np, i, FD_ISSET( handle, &fdsetr ) || FD_ISSET( handle, &fdsete ),
+			FD_ISSET( handle, &fdsetw ) || FD_ISSET( handle, &fdsete ), read_cb, write_cb );
+	}
+#endif
+
+	return ret;
+}
+
 /*
 * NET_SendFile
 */
@@ -115,7 +115,7 @@ void Netchan_OutOfBand( const socket_t *socket, const netadr_t *address, size_t
 void Netchan_OutOfBandPrint( const socket_t *socket, const netadr_t *address, const char *format, ... )
 {
 	va_list	argptr;
-	static char string[MAX_PACKETLEN - 4];
+	char string[MAX_PACKETLEN - 4];
 
 	va_start( argptr, format );
 	Q_vsnprintfz( string, sizeof( string ), format, argptr );
@@ -140,9 +140,6 @@ void Netchan_Setup( netchan_t *chan, const socket_t *socket, const netadr_t *add
 	chan->outgoingSequence = 1;
 }
 
-
-static uint8_t msg_process_data[MAX_MSGLEN];
-
 //=============================================================
 // Zlib compression
 //=============================================================
@@ -219,6 +216,7 @@ static int Netchan_ZLibDecompressChunk( const uint8_t *source, unsigned long sou
 int Netchan_CompressMessage( msg_t *msg )
 {
 	int length;
+	uint8_t msg_process_data[MAX_MSGLEN];
 
 	if( msg == NULL || !msg->data )
 		return 0;
@@ -252,6 +250,7 @@ int Netchan_CompressMessage( msg_t *msg )
 int Netchan_DecompressMessage( msg_t *msg )
 {
 	int length;
+	uint8_t msg_process_data[MAX_MSGLEN];
 
 	if( msg == NULL || !msg->data )
 		return 0;
@@ -0,0 +1,663 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// profile.c -- hierarchical frame profiler
+
+#include "qcommon.h"
+#include "sys_threads.h"
+
+#ifdef _WIN32
+#include "../win32/winquake.h"
+#else
+#include <time.h>
+#endif
+
+/*
+
+Zones are opened with Prof_Begin and closed with Prof_End, nesting freely. Each thread writes
+its zone events to a ring buffer of its own, so recording needs no locks. The buffers are drained
+by the main thread once a frame, building a tree of zones per thread with stats over a window of
+the last frames, and optionally writing the events to a Chrome trace file (chrome://tracing).
+
+While com_profile is 0 and no trace is being written, opening a zone only bumps a thread-local
+nesting counter.
+
+*/
+
+#define PROF_MAX_THREADS	32
+#define PROF_MAX_DEPTH		64			// zones nested deeper are not recorded
+#define PROF_RING_SIZE		( 1<<15 )	// events per thread, must be a power of two
+#define PROF_MAX_NODES		1024
+#define PROF_NAME_LEN		24
+#define PROF_WINDOW			64			// frames the stats are averaged over
+
+typedef struct
+{
+	uint64_t time;
+	char name[PROF_NAME_LEN];		// empty for the end of the innermost zone
+} prof_event_t;
+
+typedef struct
+{
+	int node;
+	uint64_t begin;
+	bool traced;
+} prof_stackentry_t;
+
+typedef struct
+{
+	bool used;
+	volatile bool exiting;
+	char name[32];
+
+	// written by the owner thread
+	prof_event_t *events;
+	volatile int write;
+	volatile int read;
+	int open;						// recorded zones which are not closed yet
+	unsigned dropped;
+
+	// read by the main thread
+	int root;						// first top level node
+	prof_stackentry_t stack[PROF_MAX_DEPTH];
+	int depth;
+} prof_thread_t;
+
+typedef struct
+{
+	char name[PROF_NAME_LEN];
+	int thread;
+	int parent, child, sibling;
+	unsigned calls[PROF_WINDOW];
+	uint64_t time[PROF_WINDOW];
+	uint64_t maxtime;
+} prof_node_t;
+
+static cvar_t *com_profile;
+
+static volatile bool prof_active;
+static bool prof_initialized;
+static qmutex_t *prof_mutex;
+
+static prof_thread_t prof_threads[PROF_MAX_THREADS];
+static prof_node_t *prof_nodes;
+static int prof_numnodes;
+static unsigned prof_frame, prof_numframes;
+static uint64_t prof_basetime;
+
+static int prof_tracefile;
+static int prof_traceframes;
+static bool prof_tracefirst;
+
+static ATTRIBUTE_TLS prof_thread_t *prof_thread;
+static ATTRIBUTE_TLS int prof_depth;
+static ATTRIBUTE_TLS uint64_t prof_recorded;	// a bit per nesting level, set for recorded zones
+
+/*
+* Prof_Nanoseconds
+*/
+static uint64_t Prof_Nanoseconds( void )
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+
+	if( !freq.QuadPart )
+		QueryPerformanceFrequency( &freq );
+	QueryPerformanceCounter( &now );
+	return (uint64_t)( now.QuadPart / freq.QuadPart ) * 1000000000ULL
+		+ (uint64_t)( now.QuadPart % freq.QuadPart ) * 1000000000ULL / freq.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/*
+* Prof_RegisterThread
+*/
+static prof_thread_t *Prof_RegisterThread( void )
+{
+	int i;
+	prof_thread_t *t = NULL;
+
+	if( !prof_initialized )
+		return NULL;
+
+	QMutex_Lock( prof_mutex );
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		if( !prof_threads[i].used && !prof_threads[i].exiting )
+		{
+			t = &prof_threads[i];
+			break;
+		}
+	}
+
+	if( t )
+	{
+		if( !t->events )
+			t->events = Mem_ZoneMallocExt( PROF_RING_SIZE * sizeof( *t->events ), 0 );
+		t->write = t->read = 0;
+		t->open = 0;
+		t->depth = 0;
+		if( !t->name[0] )
+			Q_snprintfz( t->name, sizeof( t->name ), "thread %i", i );
+		t->used = true;
+	}
+	QMutex_Unlock( prof_mutex );
+
+	return t;
+}
+
+/*
+* Prof_Record
+*/
+static bool Prof_Record( const char *name )
+{
+	prof_thread_t *t = prof_thread;
+	prof_event_t *ev;
+	unsigned used;
+
+	if( !t )
+	{
+		t = prof_thread = Prof_RegisterThread();
+		if( !t )
+			return false;
+	}
+
+	if( name )
+	{
+		// always keep room for the ends of the open zones
+		used = (unsigned)( t->write - t->read );
+		if( used + t->open + 2 > PROF_RING_SIZE )
+		{
+			t->dropped++;
+			return false;
+		}
+		t->open++;
+	}
+	else
+	{
+		t->open--;
+	}
+
+	ev = &t->events[t->write & ( PROF_RING_SIZE - 1 )];
+	ev->time = Prof_Nanoseconds();
+	if( name )
+		Q_strncpyz( ev->name, name, sizeof( ev->name ) );
+	else
+		ev->name[0] = '\0';
+
+	// publish the event to the main thread
+	Sys_Atomic_Add( &t->write, 1, NULL );
+	return true;
+}
+
+/*
+* Prof_Begin
+*/
+void Prof_Begin( const char *name )
+{
+	int depth = prof_depth++;
+	uint64_t bit;
+
+	if( depth >= PROF_MAX_DEPTH )
+		return;
+
+	bit = (uint64_t)1 << depth;
+	if( prof_active && Prof_Record( name ) )
+		prof_recorded |= bit;
+	else
+		prof_recorded &= ~bit;
+}
+
+/*
+* Prof_End
+*/
+void Prof_End( void )
+{
+	int depth;
+	uint64_t bit;
+
+	if( !prof_depth )
+		return;
+
+	depth = --prof_depth;
+	if( depth >= PROF_MAX_DEPTH )
+		return;
+
+	bit = (uint64_t)1 << depth;
+	if( prof_recorded & bit )
+	{
+		prof_recorded &= ~bit;
+		Prof_Record( NULL );
+	}
+}
+
+/*
+* Prof_SetThreadName
+*/
+void Prof_SetThreadName( const char *name )
+{
+	if( !prof_thread )
+		prof_thread = Prof_RegisterThread();
+	if( prof_thread )
+		Q_strncpyz( prof_thread->name, name, sizeof( prof_thread->name ) );
+}
+
+/*
+* Prof_ThreadExit
+*
+* Hands the thread buffer back, it gets reused once the main thread has drained it
+*/
+void Prof_ThreadExit( void )
+{
+	while( prof_depth )
+		Prof_End();
+
+	if( prof_thread )
+	{
+		prof_thread->exiting = true;
+		prof_thread = NULL;
+	}
+	prof_recorded = 0;
+}
+
+/*
+* Prof_FindNode
+*/
+static int Prof_FindNode( int thread, int parent, const char *name )
+{
+	int *link, i;
+	prof_node_t *node;
+
+	link = parent < 0 ? &prof_threads[thread].root : &prof_nodes[parent].child;
+	for( i = *link; i >= 0; i = prof_nodes[i].sibling )
+	{
+		if( !strcmp( prof_nodes[i].name, name ) )
+			return i;
+	}
+
+	if( prof_numnodes == PROF_MAX_NODES )
+		return -1;
+
+	i = prof_numnodes++;
+	node = &prof_nodes[i];
+	memset( node, 0, sizeof( *node ) );
+	Q_strncpyz( node->name, name, sizeof( node->name ) );
+	node->thread = thread;
+	node->parent = parent;
+	node->child = -1;
+	node->sibling = *link;
+	*link = i;
+	return i;
+}
+
+/*
+* Prof_TraceEvent
+*/
+static void Prof_TraceEvent( int thread, const char *name, uint64_t time )
+{
+	char escaped[PROF_NAME_LEN];
+	int i;
+
+	if( name )
+	{
+		for( i = 0; name[i] && i < PROF_NAME_LEN - 1; i++ )
+			escaped[i] = ( name[i] == '"' || name[i] == '\\' || name[i] < ' ' ) ? '_' : name[i];
+		escaped[i] = '\0';
+	}
+
+	FS_Printf( prof_tracefile, "%s{\"ph\":\"%s\",\"pid\":1,\"tid\":%i,\"ts\":%.3f%s%s%s}",
+		prof_tracefirst ? "\n" : ",\n", name ? "B" : "E", thread, ( time - prof_basetime ) * 0.001,
+		name ? ",\"name\":\"" : "", name ? escaped : "", name ? "\"" : "" );
+	prof_tracefirst = false;
+}
+
+/*
+* Prof_DrainThread
+*/
+static void Prof_DrainThread( int thread )
+{
+	prof_thread_t *t = &prof_threads[thread];
+	prof_stackentry_t *entry;
+	prof_event_t *ev;
+	prof_node_t *node;
+	unsigned slot = prof_frame % PROF_WINDOW;
+	int read, write;
+
+	write = Sys_Atomic_Add( &t->write, 0, NULL );
+	for( read = t->read; read != write; read++ )
+	{
+		ev = &t->events[read & ( PROF_RING_SIZE - 1 )];
+
+		if( ev->name[0] )
+		{
+			if( t->depth == PROF_MAX_DEPTH )
+				continue;
+			entry = &t->stack[t->depth++];
+			entry->node = Prof_FindNode( thread, t->depth > 1 ? entry[-1].node : -1, ev->name );
+			entry->begin = ev->time;
+			entry->traced = prof_tracefile != 0;
+			if( entry->traced )
+				Prof_TraceEvent( thread, ev->name, ev->time );
+			continue;
+		}
+
+		if( !t->depth )
+			continue;
+		entry = &t->stack[--t->depth];
+		if( entry->traced && prof_tracefile )
+			Prof_TraceEvent( thread, NULL, ev->time );
+		if( entry->node < 0 )
+			continue;
+
+		node = &prof_nodes[entry->node];
+		node->calls[slot]++;
+		node->time[slot] += ev->time - entry->begin;
+	}
+
+	Sys_Atomic_Add( &t->read, write - t->read, NULL );
+}
+
+/*
+* Prof_StopTrace
+*/
+static void Prof_StopTrace( void )
+{
+	int i;
+
+	if( !prof_tracefile )
+		return;
+
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		if( !prof_threads[i].used )
+			continue;
+		FS_Printf( prof_tracefile, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+			prof_tracefirst ? "\n" : ",\n", i, prof_threads[i].name );
+		prof_tracefirst = false;
+	}
+	FS_Printf( prof_tracefile, "\n]}\n" );
+	FS_FCloseFile( prof_tracefile );
+	prof_tracefile = 0;
+	prof_traceframes = 0;
+
+	Com_Printf( "Profiler trace written\n" );
+}
+
+/*
+* Prof_Frame
+*
+* Called by the main thread between frames
+*/
+void Prof_Frame( void )
+{
+	int i;
+	unsigned slot;
+	uint64_t frametime;
+	prof_node_t *node;
+
+	if( !prof_initialized )
+		return;
+
+	// zones left open by an aborted frame
+	while( prof_depth )
+		Prof_End();
+
+	// drain even when disabled so that buffers of exited threads are released
+	QMutex_Lock( prof_mutex );
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		prof_thread_t *t = &prof_threads[i];
+
+		if( !t->used )
+			continue;
+
+		Prof_DrainThread( i );
+
+		if( t->exiting )
+		{
+			t->depth = 0;
+			t->used = false;
+			t->exiting = false;
+		}
+	}
+	QMutex_Unlock( prof_mutex );
+
+	if( prof_active )
+	{
+		// track the worst frame of each zone
+		slot = prof_frame % PROF_WINDOW;
+		for( i = 0, node = prof_nodes; i < prof_numnodes; i++, node++ )
+		{
+			frametime = node->time[slot];
+			if( frametime > node->maxtime )
+				node->maxtime = frametime;
+		}
+
+		prof_frame++;
+		if( prof_numframes < PROF_WINDOW )
+			prof_numframes++;
+
+		// clear the next frame slot
+		slot = prof_frame % PROF_WINDOW;
+		for( i = 0, node = prof_nodes; i < prof_numnodes; i++, node++ )
+		{
+			node->calls[slot] = 0;
+			node->time[slot] = 0;
+		}
+	}
+
+	if( prof_tracefile && --prof_traceframes <= 0 )
+		Prof_StopTrace();
+
+	prof_active = com_profile->integer || prof_tracefile;
+}
+
+/*
+* Prof_PrintNode
+*/
+static void Prof_PrintNode( int index, int level, uint64_t parenttime )
+{
+	int i, child;
+	unsigned calls = 0;
+	uint64_t time = 0, childtime = 0;
+	prof_node_t *node = &prof_nodes[index];
+	char name[PROF_NAME_LEN + 2*PROF_MAX_DEPTH];
+
+	for( i = 0; i < PROF_WINDOW; i++ )
+	{
+		calls += node->calls[i];
+		time += node->time[i];
+	}
+	for( child = node->child; child >= 0; child = prof_nodes[child].sibling )
+	{
+		for( i = 0; i < PROF_WINDOW; i++ )
+			childtime += prof_nodes[child].time[i];
+	}
+
+	for( i = 0; i < level * 2 && i < (int)sizeof( name ) - 1; i++ )
+		name[i] = ' ';
+	Q_strncpyz( name + i, node->name, sizeof( name ) - i );
+
+	Com_Printf( "%-32s %8.1f %9.3f %9.3f %9.3f %6.1f%%\n", name, (float)calls / prof_numframes,
+		time * 1e-6 / prof_numframes, ( time - min( childtime, time ) ) * 1e-6 / prof_numframes,
+		node->maxtime * 1e-6, parenttime ? time * 100.0 / parenttime : 100.0 );
+
+	for( child = node->child; child >= 0; child = prof_nodes[child].sibling )
+		Prof_PrintNode( child, level + 1, time );
+}
+
+/*
+* Prof_Stats_f
+*/
+static void Prof_Stats_f( void )
+{
+	int i, root;
+
+	if( !prof_numframes )
+	{
+		Com_Printf( "No profiling data, set com_profile to 1 to collect it\n" );
+		return;
+	}
+
+	Com_Printf( "Averaged over the last %u frames, times in milliseconds per frame\n", prof_numframes );
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		prof_thread_t *t = &prof_threads[i];
+
+		if( t->root < 0 )
+			continue;
+
+		Com_Printf( "\n%s%s:\n", t->name, t->used ? "" : " (exited)" );
+		if( t->dropped )
+			Com_Printf( "%u zones dropped because of a full buffer\n", t->dropped );
+		Com_Printf( "%-32s %8s %9s %9s %9s %7s\n", "zone", "calls", "total", "self", "max", "parent" );
+		for( root = t->root; root >= 0; root = prof_nodes[root].sibling )
+			Prof_PrintNode( root, 0, 0 );
+	}
+}
+
+/*
+* Prof_Reset_f
+*/
+static void Prof_Reset_f( void )
+{
+	int i;
+
+	QMutex_Lock( prof_mutex );
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		// drained zones that are still open refer to the nodes
+		prof_threads[i].root = -1;
+		prof_threads[i].dropped = 0;
+		while( prof_threads[i].depth )
+			prof_threads[i].stack[--prof_threads[i].depth].node = -1;
+		prof_threads[i].depth = 0;
+	}
+	prof_numnodes = 0;
+	prof_frame = prof_numframes = 0;
+	QMutex_Unlock( prof_mutex );
+}
+
+/*
+* Prof_Trace_f
+*/
+static void Prof_Trace_f( void )
+{
+	char filename[MAX_QPATH];
+	int frames;
+
+	if( Cmd_Argc() < 2 )
+	{
+		Com_Printf( "Usage: %s <frames> [filename]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+	if( prof_tracefile )
+	{
+		Com_Printf( "A trace is already being written\n" );
+		return;
+	}
+
+	frames = atoi( Cmd_Argv( 1 ) );
+	if( frames <= 0 )
+	{
+		Com_Printf( "Bad frames count\n" );
+		return;
+	}
+
+	Q_strncpyz( filename, Cmd_Argc() > 2 ? Cmd_Argv( 2 ) : "profiles/trace", sizeof( filename ) );
+	COM_DefaultExtension( filename, ".json", sizeof( filename ) );
+
+	if( FS_FOpenFile( filename, &prof_tracefile, FS_WRITE ) == -1 )
+	{
+		Com_Printf( "Couldn't open %s for writing\n", filename );
+		prof_tracefile = 0;
+		return;
+	}
+
+	FS_Printf( prof_tracefile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+	prof_tracefirst = true;
+	prof_traceframes = frames;
+	prof_active = true;
+
+	Com_Printf( "Writing a trace of %i frames to %s\n", frames, filename );
+}
+
+/*
+* Prof_Init
+*/
+void Prof_Init( void )
+{
+	int i;
+
+	com_profile = Cvar_Get( "com_profile", "0", 0 );
+
+	prof_mutex = QMutex_Create();
+	prof_nodes = Mem_ZoneMallocExt( PROF_MAX_NODES * sizeof( *prof_nodes ), 0 );
+	prof_numnodes = 0;
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+		prof_threads[i].root = -1;
+	prof_basetime = Prof_Nanoseconds();
+	prof_initialized = true;
+
+	Prof_SetThreadName( "main" );
+
+	Cmd_AddCommand( "profile", Prof_Stats_f );
+	Cmd_AddCommand( "profile_reset", Prof_Reset_f );
+	Cmd_AddCommand( "profile_trace", Prof_Trace_f );
+}
+
+/*
+* Prof_Shutdown
+*/
+void Prof_Shutdown( void )
+{
+	int i;
+
+	if( !prof_initialized )
+		return;
+
+	Cmd_RemoveCommand( "profile" );
+	Cmd_RemoveCommand( "profile_reset" );
+	Cmd_RemoveCommand( "profile_trace" );
+
+	Prof_StopTrace();
+
+	prof_active = false;
+	prof_initialized = false;
+	prof_thread = NULL;
+
+	for( i = 0; i < PROF_MAX_THREADS; i++ )
+	{
+		if( prof_threads[i].events )
+			Mem_ZoneFree( prof_threads[i].events );
+	}
+	memset( prof_threads, 0, sizeof( prof_threads ) );
+
+	Mem_ZoneFree( prof_nodes );
+	prof_nodes = NULL;
+
+	QMutex_Destroy( &prof_mutex );
+}
@@ -152,7 +152,12 @@ void SNAP_BuildClientFrameSnap( struct cmodel_state_s *cms, struct ginfo_s *gi,
 
 void SNAP_FreeClientFrames( struct client_s *client );
 
+typedef struct snap_demowriter_s snap_demowriter_t;
+
 void SNAP_RecordDemoMessage( int demofile, msg_t *msg, int offset );
+snap_demowriter_t *SNAP_CreateDemoWriter( int demofile );
+bool SNAP_WriteDemoMessage( snap_demowriter_t *writer, msg_t *msg, int offset );
+bool SNAP_DestroyDemoWriter( snap_demowriter_t **pwriter );
 int SNAP_ReadDemoMessage( int demofile, msg_t *msg );
 void SNAP_BeginDemoRecording( int demofile, unsigned int spawncount, unsigned int snapFrameTime, 
 								const char *sv_name, unsigned int sv_bitflags, purelist_t *purelist, 
@@ -252,6 +257,13 @@ enum svc_ops_e
 	svc_extension			// for future expansion
 };
 
+// svc_extension ids
+#define SVC_EXT_GAMESTATE		1		// [long] spawncount [long] id [long] size [long] uncompressed size [long] offset [data]
+
+#define GAMESTATE_CHUNK_SIZE	( FRAGMENT_SIZE - 64 )	// so that every chunk fits into a single packet
+#define GAMESTATE_MAX_SIZE		( MAX_CONFIGSTRINGS * ( 2 + MAX_CONFIGSTRING_CHARS ) + MAX_EDICTS * ( sizeof( entity_state_t ) + 32 ) + 16 )
+#define GAMESTATE_MAX_CHUNKS	( ( GAMESTATE_MAX_SIZE + GAMESTATE_MAX_SIZE / 100 + 64 ) / GAMESTATE_CHUNK_SIZE + 1 )
+
 //==============================================
 
 //
@@ -275,6 +287,7 @@ enum clc_ops_e
 #define SV_BITFLAGS_TVSERVER		( 1<<2 )
 #define SV_BITFLAGS_HTTP			( 1<<3 )
 #define SV_BITFLAGS_HTTP_BASEURL	( 1<<4 )
+#define SV_BITFLAGS_GAMESTATE		( 1<<5 )	// configstrings and baselines can be requested in bulk
 
 // framesnap flags
 #define FRAMESNAP_FLAG_DELTA		( 1<<0 )
@@ -449,6 +462,7 @@ typedef char ** ( *xcompletionf_t )( const char *partial );
 void	    Cmd_PreInit( void );
 void	    Cmd_Init( void );
 void	    Cmd_Shutdown( void );
+void	    Cmd_ThreadShutdown( void );
 void	    Cmd_AddCommand( const char *cmd_name, xcommand_t function );
 void	    Cmd_RemoveCommand( const char *cmd_name );
 bool    Cmd_Exists( const char *cmd_name );
@@ -640,6 +654,21 @@ int         NET_Monitor( int msec, socket_t *sockets[],
 				void (*read_cb)(socket_t *socket, void*), 
 				void (*write_cb)(socket_t *socket, void*), 
 				void (*exception_cb)(socket_t *socket, void*), void *privatep[] );
+
+#define NET_POLL_READ	1
+#define NET_POLL_WRITE	2
+
+typedef struct netpoll_s netpoll_t;
+
+netpoll_t  *NET_Poll_Create( void );
+void		NET_Poll_Destroy( netpoll_t **np );
+int			NET_Poll_Add( netpoll_t *np, socket_t *socket, int events, void *privatep );
+bool		NET_Poll_Modify( netpoll_t *np, int id, int events );
+void		NET_Poll_Remove( netpoll_t *np, int id );
+int			NET_Poll_Wait( netpoll_t *np, int msec,
+				void (*read_cb)(socket_t *socket, void*),
+				void (*write_cb)(socket_t *socket, void*) );
+
 const char *NET_ErrorString( void );
 void	    NET_SetErrorString( const char *format, ... );
 void		NET_SetErrorStringFromLastError( const char *function );
@@ -710,6 +739,56 @@ void Netchan_OutOfBand( const socket_t *socket, const netadr_t *address, size_t
 void Netchan_OutOfBandPrint( const socket_t *socket, const netadr_t *address, const char *format, ... );
 int Netchan_GamePort( void );
 
+//============================================================================
+
+// windowed file transfer with selective acknowledgement, see dlwindow.c
+#define DLWINDOW_BLOCKSIZE		1024		// fits into a single unfragmented packet
+#define DLWINDOW_MAXBLOCKS		32			// blocks in flight, also the width of the ack mask
+#define DLWINDOW_MINRATE		( DLWINDOW_BLOCKSIZE * 4 )
+
+typedef struct
+{
+	int size;
+	int numblocks;
+	int base;                   // first block not acknowledged
+	int next;                   // first block never sent
+	unsigned int acked;         // bit n is set when block base+n is acknowledged
+	unsigned int senttime[DLWINDOW_MAXBLOCKS];
+	uint8_t sendcount[DLWINDOW_MAXBLOCKS];
+
+	int rate;                   // current send rate in bytes per second
+	int credit;                 // bytes we are allowed to send right now
+	bool slowstart;
+	unsigned int lasttime;
+	unsigned int lastloss;
+	int srtt;                   // smoothed round trip time in milliseconds
+	int rto;                    // retransmission timeout in milliseconds
+
+	int sentbytes;
+	int resent;
+} dlwindow_sender_t;
+
+typedef struct
+{
+	int size;
+	int numblocks;
+	int base;                   // first block not received
+	unsigned int mask;          // bit n is set when block base+1+n is received
+	int bytes;                  // received so far, including the resumed part
+} dlwindow_receiver_t;
+
+void DLWindow_InitSender( dlwindow_sender_t *s, int size, int maxrate, unsigned int time );
+int DLWindow_NextBlock( dlwindow_sender_t *s, int maxrate, unsigned int time );
+void DLWindow_Ack( dlwindow_sender_t *s, int base, unsigned int mask, int maxrate, unsigned int time );
+bool DLWindow_SenderDone( const dlwindow_sender_t *s );
+int DLWindow_BlockLength( int size, int block );
+
+void DLWindow_InitReceiver( dlwindow_receiver_t *r, int size, int offset );
+bool DLWindow_ReceiveBlock( dlwindow_receiver_t *r, int offset, int length );
+bool DLWindow_ReceiverDone( const dlwindow_receiver_t *r );
+
+void DLWindow_Benchmark_f( void );
+
 /*
 ==============================================================
 
@@ -772,6 +851,8 @@ int		FS_GetCompressionLevel( int file );
 int	    FS_LoadFileExt( const char *path, int flags, void **buffer, void *stack, size_t stackSize, const char *filename, int fileline );
 int	    FS_LoadBaseFileExt( const char *path, int flags, void **buffer, void *stack, size_t stackSize, const char *filename, int fileline );
 void	FS_FreeFile( void *buffer );
+int	    FS_LoadMappedFile( const char *path, void **buffer, bool *mapped );
+void	FS_FreeMappedFile( void *buffer );
 void	FS_FreeBaseFile( void *buffer );
 #define FS_LoadFile(path,buffer,stack,stacksize) FS_LoadFileExt(path,0,buffer,stack,stacksize,__FILE__,__LINE__)
 #define FS_LoadBaseFile(path,buffer,stack,stacksize) FS_LoadBaseFileExt(path,0,buffer,stack,stacksize,__FILE__,__LINE__)
@@ -875,6 +956,22 @@ extern unsigned int time_after_ref;
 /*
 ==============================================================
 
+PROFILER
+
+==============================================================
+*/
+
+void Prof_Init( void );
+void Prof_Shutdown( void );
+void Prof_Frame( void );
+void Prof_Begin( const char *name );
+void Prof_End( void );
+void Prof_SetThreadName( const char *name );
+void Prof_ThreadExit( void );
+
+/*
+==============================================================
+
 MEMORY MANAGEMENT
 
 ==============================================================
@@ -912,6 +1009,9 @@ void _Mem_CheckSentinels( void *data, const char *filename, int fileline );
 void _Mem_CheckSentinelsGlobal( const char *filename, int fileline );
 
 size_t Mem_PoolTotalSize( mempool_t *pool );
+size_t Mem_TotalSize( void );
+size_t Mem_PeakSize( void );
+void Mem_ResetPeakSize( void );
 
 #define Mem_AllocExt( pool, size, z ) _Mem_AllocExt( pool, size, 0, z, 0, 0, __FILE__, __LINE__ )
 #define Mem_Alloc( pool, size ) _Mem_Alloc( pool, size, 0, 0, __FILE__, __LINE__ )
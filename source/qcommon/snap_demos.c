@@ -50,6 +50,213 @@ void SNAP_RecordDemoMessage( int demofile, msg_t *msg, int offset )
 	FS_Write( msg->data + offset, len, demofile );
 }
 
+/*
+* Demo writer
+*
+* Messages of a demo being recorded are copied into a ring buffer and written
+* (and compressed if the file is a gzip stream) by a separate thread, so that
+* disk stalls do not hold the frame. Each demo file gets its own writer, a
+* writer is only fed by a single thread. If the ring buffer fills up or a write
+* fails, the writer is marked as failed and the recording should be stopped
+* and the file discarded.
+*/
+
+#define SNAP_DEMOWRITER_BUFSIZE		0x200000
+#define SNAP_DEMOWRITER_WAIT_MSEC	1000
+
+enum
+{
+	SNAP_DEMOWRITER_CMD_WRITE,
+	SNAP_DEMOWRITER_CMD_SHUTDOWN,
+
+	SNAP_DEMOWRITER_CMD_NUM_CMDS
+};
+
+struct snap_demowriter_s
+{
+	int demofile;
+	qbufPipe_t *pipe;
+	qthread_t *thread;
+	volatile int failed;
+	uint8_t *cmdbuf;            // the command is assembled here before being copied into the ring
+};
+
+typedef struct
+{
+	int id;
+	int len;                    // length of the data following the command
+	snap_demowriter_t *writer;
+} demoWriterCmdWrite_t;
+
+typedef struct
+{
+	int id;
+} demoWriterCmdShutdown_t;
+
+typedef unsigned (*demoWriterCmdHandler_t)( const void * );
+
+/*
+* SNAP_DemoWriter_CmdSize
+*
+* Keeps commands in the ring aligned for the next one
+*/
+static unsigned SNAP_DemoWriter_CmdSize( int len )
+{
+	return ( sizeof( demoWriterCmdWrite_t ) + len + sizeof( void * ) - 1 ) & ~( sizeof( void * ) - 1 );
+}
+
+/*
+* SNAP_DemoWriter_HandleWriteCmd
+*/
+static unsigned SNAP_DemoWriter_HandleWriteCmd( const demoWriterCmdWrite_t *cmd )
+{
+	snap_demowriter_t *writer = cmd->writer;
+	int len;
+
+	// keep draining the queue after an error so the producer never blocks on it
+	if( writer->failed )
+		return SNAP_DemoWriter_CmdSize( cmd->len );
+
+	len = LittleLong( cmd->len );
+	if( FS_Write( &len, 4, writer->demofile ) != 4
+		|| FS_Write( cmd + 1, cmd->len, writer->demofile ) != cmd->len )
+		writer->failed = 1;
+
+	return SNAP_DemoWriter_CmdSize( cmd->len );
+}
+
+/*
+* SNAP_DemoWriter_HandleShutdownCmd
+*/
+static unsigned SNAP_DemoWriter_HandleShutdownCmd( const demoWriterCmdShutdown_t *cmd )
+{
+	return 0;
+}
+
+static demoWriterCmdHandler_t demoWriterCmdHandlers[SNAP_DEMOWRITER_CMD_NUM_CMDS] =
+{
+	/* SNAP_DEMOWRITER_CMD_WRITE */
+	(demoWriterCmdHandler_t)SNAP_DemoWriter_HandleWriteCmd,
+	/* SNAP_DEMOWRITER_CMD_SHUTDOWN */
+	(demoWriterCmdHandler_t)SNAP_DemoWriter_HandleShutdownCmd,
+};
+
+/*
+* SNAP_DemoWriter_CmdsWaiter
+*/
+static int SNAP_DemoWriter_CmdsWaiter( qbufPipe_t *queue, demoWriterCmdHandler_t *cmdHandlers, bool timeout )
+{
+	return QBufPipe_ReadCmds( queue, cmdHandlers );
+}
+
+/*
+* SNAP_DemoWriter_Proc
+*/
+static void *SNAP_DemoWriter_Proc( void *param )
+{
+	snap_demowriter_t *writer = param;
+
+	Prof_SetThreadName( "demowriter" );
+
+	QBufPipe_Wait( writer->pipe, SNAP_DemoWriter_CmdsWaiter, demoWriterCmdHandlers, SNAP_DEMOWRITER_WAIT_MSEC );
+
+	return NULL;
+}
+
+/*
+* SNAP_CreateDemoWriter
+*
+* Starts a writer thread for the opened demo file. SNAP_BeginDemoRecording
+* writes to the file directly, so it must be done before any message is queued.
+*/
+snap_demowriter_t *SNAP_CreateDemoWriter( int demofile )
+{
+	snap_demowriter_t *writer;
+
+	writer = Mem_ZoneMalloc( sizeof( *writer ) + SNAP_DemoWriter_CmdSize( MAX_MSGLEN ) );
+	writer->demofile = demofile;
+	writer->cmdbuf = ( uint8_t * )( writer + 1 );
+	writer->pipe = QBufPipe_Create( SNAP_DEMOWRITER_BUFSIZE, 0 );
+	writer->thread = QThread_Create( SNAP_DemoWriter_Proc, writer );
+
+	return writer;
+}
+
+/*
+* SNAP_WriteDemoMessage
+*
+* Queues given message to be written to the demo file. Never blocks, returns
+* false if the message could not be queued or an earlier write has failed.
+*/
+bool SNAP_WriteDemoMessage( snap_demowriter_t *writer, msg_t *msg, int offset )
+{
+	demoWriterCmdWrite_t *cmd;
+	int len;
+
+	if( !writer )
+		return false;
+	if( writer->failed )
+		return false;
+
+	len = (int)msg->cursize - offset;
+	if( len <= 0 )
+		return true;
+	if( len > MAX_MSGLEN )
+	{
+		writer->failed = 1;
+		return false;
+	}
+
+	cmd = ( demoWriterCmdWrite_t * )writer->cmdbuf;
+	cmd->id = SNAP_DEMOWRITER_CMD_WRITE;
+	cmd->len = len;
+	cmd->writer = writer;
+	memcpy( cmd + 1, msg->data + offset, len );
+
+	if( !QBufPipe_TryWriteCmd( writer->pipe, cmd, SNAP_DemoWriter_CmdSize( len ) ) )
+	{
+		writer->failed = 1;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* SNAP_DestroyDemoWriter
+*
+* Waits for all queued messages to be written and stops the writer thread.
+* Must be called before the demo file is finished or closed. Returns false
+* if any message was dropped or failed to be written, in which case the demo
+* file is incomplete and should be discarded.
+*/
+bool SNAP_DestroyDemoWriter( snap_demowriter_t **pwriter )
+{
+	snap_demowriter_t *writer;
+	demoWriterCmdShutdown_t cmd;
+	bool failed;
+
+	writer = *pwriter;
+	*pwriter = NULL;
+	if( !writer )
+		return true;
+
+	// the queue is never blocking, wait for room for the shutdown command
+	cmd.id = SNAP_DEMOWRITER_CMD_SHUTDOWN;
+	while( !QBufPipe_TryWriteCmd( writer->pipe, &cmd, sizeof( cmd ) ) )
+		QThread_Yield();
+
+	QBufPipe_Finish( writer->pipe );
+	QThread_Join( writer->thread );
+
+	failed = writer->failed != 0;
+
+	QBufPipe_Destroy( &writer->pipe );
+	Mem_ZoneFree( writer );
+
+	return !failed;
+}
+
 /*
 * SNAP_ReadDemoMessage
 */
@@ -109,6 +109,28 @@ void QCondVar_Wake( qcondvar_t *cond )
 	Sys_CondVar_Wake( cond );
 }
 
+typedef struct
+{
+	void *(*routine) (void*);
+	void *param;
+} qthread_start_t;
+
+/*
+* QThread_Start
+*/
+static void *QThread_Start( void *param )
+{
+	qthread_start_t start = *( qthread_start_t * )param;
+	void *ret;
+
+	free( param );
+
+	ret = start.routine( start.param );
+
+	Prof_ThreadExit();
+	return ret;
+}
+
 /*
 * QThread_Create
 */
@@ -116,8 +138,13 @@ qthread_t *QThread_Create( void *(*routine) (void*), void *param )
 {
 	int ret;
 	qthread_t *thread;
+	qthread_start_t *start;
+
+	start = malloc( sizeof( *start ) );
+	start->routine = routine;
+	start->param = param;
 
-	ret = Sys_Thread_Create( &thread, routine, param );
+	ret = Sys_Thread_Create( &thread, QThread_Start, start );
 	if( ret != 0 ) {
 		Sys_Error( "QThread_Create: failed with code %i", ret );
 	}
@@ -252,25 +279,27 @@ static void QBufPipe_BufLenAdd( qbufPipe_t *pipe, int val )
 }
 
 /*
-* QBufPipe_WriteCmd
+* QBufPipe_TryWriteCmd
 *
 * Add new command to buffer. Never allow the distance between the reader
 * and the writer to grow beyond the size of the buffer.
 *
 * Note that there are race conditions here but in the worst case we're going
 * to erroneously drop cmd's instead of stepping on the reader's toes.
+*
+* Returns false if the command has been dropped.
 */
-void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
+bool QBufPipe_TryWriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
 {
 	void *buf;
 	unsigned write_remains;
 	bool was_empty;
 	
 	if( !pipe ) {
-		return;
+		return false;
 	}
 	if( pipe->terminated ) {
-		return;
+		return false;
 	}
 
 	assert( pipe->bufSize >= pipe->write_pos );
@@ -287,7 +316,7 @@ void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
 				QThread_Yield();
 				continue;
 			}
-			return;
+			return false;
 		}
 
 		// not enough space to enpipe even the reset cmd, rewind
@@ -301,7 +330,7 @@ void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
 				QThread_Yield();
 				continue;
 			}
-			return;
+			return false;
 		}
 
 		// explicit pointer reset cmd
@@ -318,7 +347,7 @@ void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
 				QThread_Yield();
 				continue;
 			}
-			return;
+			return false;
 		}
 	}
 
@@ -332,6 +361,16 @@ void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
 		QBufPipe_Wake( pipe );
 		QMutex_Unlock( pipe->nonempty_mutex );
 	}
+
+	return true;
+}
+
+/*
+* QBufPipe_WriteCmd
+*/
+void QBufPipe_WriteCmd( qbufPipe_t *pipe, const void *pcmd, unsigned cmd_size )
+{
+	QBufPipe_TryWriteCmd( pipe, pcmd, cmd_size );
 }
 
 /*
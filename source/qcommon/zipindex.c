@@ -0,0 +1,686 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "qcommon.h"
+#include "sys_fs.h"
+#include "zipindex.h"
+
+// the central directory of every archive used to be parsed with a couple of seeks
+// and reads per entry on each startup, so the resulting tables are now built in a
+// single pass over the mapped central directory and saved in the cache directory,
+// to be reused for as long as the archive stays the same
+
+#define ZIP_SIZELOCALHEADER			0x0000001e
+#define ZIP_SIZECENTRALDIRITEM		0x0000002e
+#define ZIP_SIZEENDHEADER			0x00000016
+#define ZIP_MAXCOMMENT				0x0000ffff
+
+#define ZIP_LOCALHEADERMAGIC		0x04034b50
+#define ZIP_CENTRALHEADERMAGIC		0x02014b50
+#define ZIP_ENDHEADERMAGIC			0x06054b50
+
+#define ZIP_STORED					0
+#define ZIP_DEFLATED				8
+
+#define ZIPINDEX_CACHE_DIRECTORY	"zipindex"
+#define ZIPINDEX_CACHE_MAGIC		"QZIX"
+#define ZIPINDEX_CACHE_VERSION		1
+
+typedef struct
+{
+	char magic[4];
+	int version;
+	int flags;
+	unsigned archiveOffset, archiveSize;
+	unsigned fileSize;
+	int64_t fileMTime;
+	int numEntries;
+	int hashSize;
+	unsigned namesSize;
+	unsigned pathLength;
+} zipindex_cacheheader_t;
+
+typedef struct
+{
+	const char *name;
+	const zipentry_t *entry;
+} zipindex_sortentry_t;
+
+static inline unsigned int LittleLongRaw( const uint8_t *raw )
+{
+	return ( raw[3] << 24 ) | ( raw[2] << 16 ) | ( raw[1] << 8 ) | raw[0];
+}
+
+static inline unsigned short LittleShortRaw( const uint8_t *raw )
+{
+	return ( raw[1] << 8 ) | raw[0];
+}
+
+/*
+* ZipIndex_HashName
+*/
+static unsigned ZipIndex_HashName( const char *name )
+{
+	unsigned hash = 0x811c9dc5;
+
+	for( ; *name; name++ )
+		hash = ( hash ^ tolower( ( unsigned char )*name ) ) * 0x01000193;
+	return hash;
+}
+
+/*
+* ZipIndex_DataSize
+*/
+static size_t ZipIndex_DataSize( int numEntries, int hashSize, size_t namesSize )
+{
+	return numEntries * sizeof( zipentry_t ) + hashSize * sizeof( int ) + namesSize;
+}
+
+/*
+* ZipIndex_Alloc
+*
+* The index is a single block, so that everything but the header can be saved and loaded as is.
+*/
+static zipindex_t *ZipIndex_Alloc( mempool_t *pool, int numEntries, int hashSize, size_t namesSize )
+{
+	zipindex_t *index;
+
+	index = Mem_Alloc( pool, sizeof( *index ) + ZipIndex_DataSize( numEntries, hashSize, namesSize ) );
+	index->numEntries = numEntries;
+	index->entries = ( zipentry_t * )( ( uint8_t * )index + sizeof( *index ) );
+	index->hashSize = hashSize;
+	index->hashTable = ( int * )( index->entries + numEntries );
+	index->namesSize = namesSize;
+	index->names = ( char * )( index->hashTable + hashSize );
+	return index;
+}
+
+/*
+* ZipIndex_SortCmp
+*/
+static int ZipIndex_SortCmp( const zipindex_sortentry_t *e1, const zipindex_sortentry_t *e2 )
+{
+	int cmp = Q_stricmp( e1->name, e2->name );
+	if( cmp )
+		return cmp;
+	return ( int )e1->entry->order - ( int )e2->entry->order;
+}
+
+/*
+* ZipIndex_Build
+*
+* Makes an index of entries with names at the given offsets. Entries with the same name
+* are all kept, but only the one coming last in the archive can be found.
+*/
+zipindex_t *ZipIndex_Build( mempool_t *pool, zipentry_t *entries, int numEntries, const char *names, size_t namesSize )
+{
+	int i;
+	int hashSize;
+	zipindex_t *index;
+	zipentry_t *entry;
+	zipindex_sortentry_t *sorted;
+
+	for( hashSize = 1; hashSize < numEntries; hashSize <<= 1 );
+
+	index = ZipIndex_Alloc( pool, numEntries, hashSize, namesSize );
+	memcpy( index->names, names, namesSize );
+
+	sorted = Mem_TempMalloc( max( numEntries, 1 ) * sizeof( *sorted ) );
+	for( i = 0; i < numEntries; i++ )
+	{
+		sorted[i].name = names + entries[i].name;
+		sorted[i].entry = &entries[i];
+	}
+	qsort( sorted, numEntries, sizeof( *sorted ), ( int ( * )( const void *, const void * ) )ZipIndex_SortCmp );
+
+	for( i = 0; i < hashSize; i++ )
+		index->hashTable[i] = -1;
+
+	for( i = 0, entry = index->entries; i < numEntries; i++, entry++ )
+	{
+		*entry = *sorted[i].entry;
+		entry->hash = ZipIndex_HashName( sorted[i].name );
+		entry->flags &= ~ZIPENTRY_SHADOWED;
+		entry->hashNext = -1;
+
+		if( i + 1 < numEntries && !Q_stricmp( sorted[i].name, sorted[i+1].name ) )
+		{
+			entry->flags |= ZIPENTRY_SHADOWED;
+			continue;
+		}
+
+		entry->hashNext = index->hashTable[entry->hash & ( hashSize - 1 )];
+		index->hashTable[entry->hash & ( hashSize - 1 )] = i;
+	}
+
+	Mem_TempFree( sorted );
+
+	return index;
+}
+
+/*
+* ZipIndex_Parse
+*/
+static zipindex_t *ZipIndex_Parse( mempool_t *pool, FILE *fin, unsigned archiveOffset, unsigned archiveSize, int flags, const char **error )
+{
+	int i, numFiles;
+	unsigned tailSize, centralPos, sizeCentralDir, offsetCentralDir, byteBeforeTheZipFile;
+	unsigned pos, nameLen, method;
+	size_t namesLen;
+	uint8_t *tail = NULL, *dir = NULL, *item;
+	void *mapping = NULL;
+	size_t mapping_offset = 0;
+	bool mapped = false;
+	char *names = NULL;
+	zipentry_t *entries = NULL, *entry;
+	zipindex_t *index = NULL;
+
+	// locate the central directory, reading the maximum possible size of the global comment at once
+	tailSize = min( archiveSize, ZIP_MAXCOMMENT + ZIP_SIZEENDHEADER );
+	if( tailSize < ZIP_SIZEENDHEADER )
+	{
+		*error = "No central directory found";
+		goto done;
+	}
+
+	tail = Mem_TempMalloc( tailSize );
+	if( fseek( fin, archiveOffset + archiveSize - tailSize, SEEK_SET ) != 0 || fread( tail, 1, tailSize, fin ) != tailSize )
+	{
+		*error = "Error reading";
+		goto done;
+	}
+
+	for( pos = tailSize - ZIP_SIZEENDHEADER + 1; pos--; )
+	{
+		if( LittleLongRaw( tail + pos ) == ZIP_ENDHEADERMAGIC )
+			break;
+	}
+	if( pos == ( unsigned )-1 )
+	{
+		*error = "No central directory found";
+		goto done;
+	}
+	item = tail + pos;
+	centralPos = archiveSize - tailSize + pos;
+
+	// total number of entries in the central dir on this disk
+	numFiles = LittleShortRaw( item + 8 );
+	if( !numFiles || LittleShortRaw( item + 10 ) != numFiles || LittleShortRaw( item + 6 ) != 0
+		|| LittleShortRaw( item + 4 ) != 0 )
+	{
+		*error = "Not a valid zip file";
+		goto done;
+	}
+
+	sizeCentralDir = LittleLongRaw( item + 12 );
+	offsetCentralDir = LittleLongRaw( item + 16 );
+	if( centralPos < offsetCentralDir + sizeCentralDir || sizeCentralDir < ZIP_SIZECENTRALDIRITEM )
+	{
+		*error = "Not a valid zip file";
+		goto done;
+	}
+	byteBeforeTheZipFile = centralPos - offsetCentralDir - sizeCentralDir;
+
+	Mem_TempFree( tail );
+	tail = NULL;
+
+	// map the central directory, falling back to reading it if that fails
+	dir = Sys_FS_MMapFile( Sys_FS_FileNo( fin ), sizeCentralDir, archiveOffset + offsetCentralDir + byteBeforeTheZipFile,
+		&mapping, &mapping_offset );
+	if( dir )
+	{
+		mapped = true;
+	}
+	else
+	{
+		dir = Mem_TempMalloc( sizeCentralDir );
+		if( fseek( fin, archiveOffset + offsetCentralDir + byteBeforeTheZipFile, SEEK_SET ) != 0
+			|| fread( dir, 1, sizeCentralDir, fin ) != sizeCentralDir )
+		{
+			*error = "Error reading";
+			goto done;
+		}
+	}
+
+	// every name takes less space in the directory than 1 byte per item header
+	entries = Mem_TempMalloc( numFiles * sizeof( *entries ) );
+	names = Mem_TempMalloc( sizeCentralDir );
+	namesLen = 0;
+
+	for( i = 0, pos = 0, entry = entries; i < numFiles; i++, entry++ )
+	{
+		if( pos + ZIP_SIZECENTRALDIRITEM > sizeCentralDir )
+		{
+			*error = "Not a valid zip file";
+			goto done;
+		}
+
+		item = dir + pos;
+
+		// check the magic
+		if( LittleLongRaw( item ) != ZIP_CENTRALHEADERMAGIC )
+		{
+			*error = "Not a valid zip file";
+			goto done;
+		}
+
+		method = LittleShortRaw( item + 10 );
+		if( method != ZIP_STORED && method != ZIP_DEFLATED )
+		{
+			*error = "Unsupported compression method";
+			goto done;
+		}
+
+		nameLen = LittleShortRaw( item + 28 );
+		if( !nameLen || pos + ZIP_SIZECENTRALDIRITEM + nameLen > sizeCentralDir )
+		{
+			*error = "Not a valid zip file";
+			goto done;
+		}
+
+		memset( entry, 0, sizeof( *entry ) );
+		entry->name = namesLen;
+		entry->order = i;
+		entry->dosDateTime = LittleLongRaw( item + 12 );
+		entry->crc = LittleLongRaw( item + 16 );
+		entry->compressedSize = LittleLongRaw( item + 20 );
+		entry->uncompressedSize = LittleLongRaw( item + 24 );
+		entry->offset = LittleLongRaw( item + 42 ) + byteBeforeTheZipFile;
+		if( method == ZIP_DEFLATED )
+			entry->flags |= ZIPENTRY_DEFLATED;
+		if( item[ZIP_SIZECENTRALDIRITEM + nameLen - 1] == '/' )
+			entry->flags |= ZIPENTRY_DIRECTORY;
+
+		memcpy( names + namesLen, item + ZIP_SIZECENTRALDIRITEM, nameLen );
+		names[namesLen + nameLen] = 0;
+		namesLen += nameLen + 1;
+
+		pos += ZIP_SIZECENTRALDIRITEM + nameLen + LittleShortRaw( item + 30 ) + LittleShortRaw( item + 32 );
+	}
+
+	if( flags & ZIPINDEX_LOCALHEADERS )
+	{
+		uint8_t localHeader[ZIP_SIZELOCALHEADER];
+
+		for( i = 0, entry = entries; i < numFiles; i++, entry++ )
+		{
+			if( fseek( fin, archiveOffset + entry->offset, SEEK_SET ) != 0
+				|| fread( localHeader, 1, sizeof( localHeader ), fin ) != sizeof( localHeader ) )
+			{
+				*error = "Error reading";
+				goto done;
+			}
+
+			// check the magic and that the local header agrees with the central directory
+			method = LittleShortRaw( &localHeader[8] );
+			if( LittleLongRaw( &localHeader[0] ) != ZIP_LOCALHEADERMAGIC
+				|| ( method == ZIP_DEFLATED ) != ( ( entry->flags & ZIPENTRY_DEFLATED ) != 0 )
+				|| ( !( LittleShortRaw( &localHeader[6] ) & 8 ) && LittleLongRaw( &localHeader[22] ) != entry->uncompressedSize ) )
+			{
+				*error = "Not a valid zip file";
+				goto done;
+			}
+
+			entry->dataOffset = entry->offset + ZIP_SIZELOCALHEADER + LittleShortRaw( &localHeader[26] ) +
+				( unsigned )LittleShortRaw( &localHeader[28] );
+		}
+	}
+
+	index = ZipIndex_Build( pool, entries, numFiles, names, namesLen );
+
+done:
+	if( tail )
+		Mem_TempFree( tail );
+	if( mapped )
+		Sys_FS_UnMMapFile( mapping, dir, sizeCentralDir, mapping_offset );
+	else if( dir )
+		Mem_TempFree( dir );
+	if( entries )
+		Mem_TempFree( entries );
+	if( names )
+		Mem_TempFree( names );
+
+	return index;
+}
+
+/*
+* ZipIndex_CacheName
+*/
+static void ZipIndex_CacheName( const char *filename, unsigned archiveOffset, char *cacheName, size_t cacheNameSize )
+{
+	char base[MAX_QPATH];
+
+	Q_strncpyz( base, COM_FileBase( filename ), sizeof( base ) );
+	COM_StripExtension( base );
+
+	Q_snprintfz( cacheName, cacheNameSize, "%s/%s/%s.%08x%08x.idx", FS_CacheDirectory(), ZIPINDEX_CACHE_DIRECTORY,
+		base, ZipIndex_HashName( filename ), archiveOffset );
+}
+
+/*
+* ZipIndex_ValidateCache
+*
+* Checks everything in a cached index that is used to index memory or the archive,
+* so that a corrupt or tampered cache is rebuilt instead of trusted.
+*/
+static bool ZipIndex_ValidateCache( const zipindex_t *index, unsigned archiveSize, int flags )
+{
+	int i, next;
+	unsigned mask = index->hashSize - 1;
+	const zipentry_t *entry;
+	uint8_t *orders;
+	bool valid;
+
+	for( i = 0; i < index->hashSize; i++ )
+	{
+		next = index->hashTable[i];
+		if( next < -1 || next >= index->numEntries )
+			return false;
+		if( next >= 0 && ( index->entries[next].hash & mask ) != ( unsigned )i )
+			return false;
+	}
+
+	for( i = 0, entry = index->entries; i < index->numEntries; i++, entry++ )
+	{
+		if( entry->name >= index->namesSize )
+			return false;
+		if( entry->hash != ZipIndex_HashName( index->names + entry->name ) )
+			return false;
+
+		// chains are linked from later entries to earlier ones, which also rules out loops
+		if( entry->hashNext < -1 || entry->hashNext >= i )
+			return false;
+		if( entry->hashNext >= 0 && ( index->entries[entry->hashNext].hash & mask ) != ( entry->hash & mask ) )
+			return false;
+
+		// lookups by prefix need the entries sorted
+		if( i && Q_stricmp( index->names + entry[-1].name, index->names + entry->name ) > 0 )
+			return false;
+
+		if( ( uint64_t )entry->offset + entry->compressedSize > archiveSize )
+			return false;
+		if( ( flags & ZIPINDEX_LOCALHEADERS ) && ( entry->dataOffset < entry->offset + ZIP_SIZELOCALHEADER
+			|| ( uint64_t )entry->dataOffset + entry->compressedSize > archiveSize ) )
+			return false;
+	}
+
+	// the orders index tables of all entries, so every position must be used exactly once
+	orders = Mem_TempMalloc( ( index->numEntries + 7 ) / 8 );
+	valid = true;
+	for( i = 0, entry = index->entries; i < index->numEntries; i++, entry++ )
+	{
+		if( entry->order >= ( unsigned )index->numEntries || ( orders[entry->order >> 3] & ( 1 << ( entry->order & 7 ) ) ) )
+		{
+			valid = false;
+			break;
+		}
+		orders[entry->order >> 3] |= 1 << ( entry->order & 7 );
+	}
+	Mem_TempFree( orders );
+
+	return valid;
+}
+
+/*
+* ZipIndex_LoadCache
+*/
+static zipindex_t *ZipIndex_LoadCache( mempool_t *pool, const char *cacheName, const zipindex_cacheheader_t *key, const char *filename )
+{
+	FILE *f;
+	long fileLength;
+	int hashSize;
+	size_t dataSize;
+	zipindex_cacheheader_t header;
+	char path[1024];
+	zipindex_t *index = NULL;
+
+	f = fopen( cacheName, "rb" );
+	if( !f )
+		return NULL;
+
+	if( fseek( f, 0, SEEK_END ) != 0 || ( fileLength = ftell( f ) ) < 0 || fseek( f, 0, SEEK_SET ) != 0 )
+		goto done;
+
+	if( fread( &header, 1, sizeof( header ), f ) != sizeof( header )
+		|| memcmp( header.magic, key->magic, sizeof( header.magic ) )
+		|| header.version != key->version
+		|| header.flags != key->flags
+		|| header.archiveOffset != key->archiveOffset
+		|| header.archiveSize != key->archiveSize
+		|| header.fileSize != key->fileSize
+		|| header.fileMTime != key->fileMTime
+		|| header.pathLength != key->pathLength
+		|| header.pathLength >= sizeof( path )
+		|| header.numEntries <= 0
+		|| ( uint64_t )header.numEntries * ZIP_SIZECENTRALDIRITEM > header.archiveSize
+		|| !header.namesSize || header.namesSize > header.archiveSize )
+		goto done;
+
+	// the hash table is sized the same way ZipIndex_Build does it
+	for( hashSize = 1; hashSize < header.numEntries; hashSize <<= 1 );
+	if( header.hashSize != hashSize )
+		goto done;
+
+	// check the size before allocating anything, so that a bogus header can't make us allocate a lot
+	if( ( uint64_t )fileLength != sizeof( header ) + header.pathLength + ( uint64_t )header.numEntries * sizeof( zipentry_t )
+		+ ( uint64_t )header.hashSize * sizeof( int ) + header.namesSize )
+		goto done;
+	dataSize = ZipIndex_DataSize( header.numEntries, header.hashSize, header.namesSize );
+
+	// the name is hashed in the cache file name, make sure it's the same archive
+	if( fread( path, 1, header.pathLength, f ) != header.pathLength || memcmp( path, filename, header.pathLength ) )
+		goto done;
+
+	index = ZipIndex_Alloc( pool, header.numEntries, header.hashSize, header.namesSize );
+	if( fread( index->entries, 1, dataSize, f ) != dataSize || index->names[index->namesSize - 1]
+		|| !ZipIndex_ValidateCache( index, header.archiveSize, header.flags ) )
+	{
+		Com_DPrintf( "Invalid zip index cache %s, rebuilding\n", cacheName );
+		Mem_Free( index );
+		index = NULL;
+	}
+
+done:
+	fclose( f );
+	return index;
+}
+
+/*
+* ZipIndex_SaveCache
+*/
+static void ZipIndex_SaveCache( const zipindex_t *index, const char *cacheName, zipindex_cacheheader_t *header, const char *filename )
+{
+	FILE *f;
+	size_t dataSize;
+	char tempName[1024];
+	bool ok;
+
+	header->numEntries = index->numEntries;
+	header->hashSize = index->hashSize;
+	header->namesSize = index->namesSize;
+
+	// write to a temporary file first, so that an incomplete index is never loaded
+	Q_snprintfz( tempName, sizeof( tempName ), "%s.tmp", cacheName );
+	FS_CreateAbsolutePath( tempName );
+
+	f = fopen( tempName, "wb" );
+	if( !f )
+		return;
+
+	dataSize = ZipIndex_DataSize( index->numEntries, index->hashSize, index->namesSize );
+	ok = fwrite( header, 1, sizeof( *header ), f ) == sizeof( *header )
+		&& fwrite( filename, 1, header->pathLength, f ) == header->pathLength
+		&& fwrite( index->entries, 1, dataSize, f ) == dataSize;
+	ok = ( fclose( f ) == 0 ) && ok;
+
+	if( ok )
+	{
+		remove( cacheName );
+		ok = ( rename( tempName, cacheName ) == 0 );
+	}
+	if( !ok )
+		remove( tempName );
+}
+
+/*
+* ZipIndex_Load
+*
+* Indexes the zip archive in the file, or the part of it starting at archiveOffset if archiveSize
+* is not 0. Returns NULL and sets the error if the archive can't be indexed.
+*/
+zipindex_t *ZipIndex_Load( mempool_t *pool, const char *filename, unsigned archiveOffset, unsigned archiveSize, int flags, const char **error )
+{
+	FILE *fin;
+	long fileSize;
+	char cacheName[1024];
+	zipindex_cacheheader_t header;
+	zipindex_t *index;
+	const char *dummy;
+
+	if( !error )
+		error = &dummy;
+	*error = NULL;
+
+	fin = fopen( filename, "rb" );
+	if( !fin )
+	{
+		*error = "Error opening";
+		return NULL;
+	}
+
+	if( fseek( fin, 0, SEEK_END ) != 0 || ( fileSize = ftell( fin ) ) < 0 )
+	{
+		*error = "Error seeking";
+		fclose( fin );
+		return NULL;
+	}
+	if( !archiveSize )
+		archiveSize = fileSize - archiveOffset;
+	if( ( size_t )archiveOffset + archiveSize > ( size_t )fileSize )
+	{
+		*error = "Error seeking";
+		fclose( fin );
+		return NULL;
+	}
+
+	// the index is valid for as long as the archive file isn't changed
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, ZIPINDEX_CACHE_MAGIC, sizeof( header.magic ) );
+	header.version = ZIPINDEX_CACHE_VERSION;
+	header.flags = flags & ~ZIPINDEX_NOCACHE;
+	header.archiveOffset = archiveOffset;
+	header.archiveSize = archiveSize;
+	header.fileSize = fileSize;
+	header.fileMTime = Sys_FS_FileMTime( filename );
+	header.pathLength = strlen( filename );
+
+	ZipIndex_CacheName( filename, archiveOffset, cacheName, sizeof( cacheName ) );
+
+	index = NULL;
+	if( !( flags & ZIPINDEX_NOCACHE ) )
+		index = ZipIndex_LoadCache( pool, cacheName, &header, filename );
+
+	if( !index )
+	{
+		index = ZipIndex_Parse( pool, fin, archiveOffset, archiveSize, flags, error );
+		if( index && !( flags & ZIPINDEX_NOCACHE ) && header.fileMTime > 0 )
+			ZipIndex_SaveCache( index, cacheName, &header, filename );
+	}
+
+	fclose( fin );
+	return index;
+}
+
+/*
+* ZipIndex_Free
+*/
+void ZipIndex_Free( zipindex_t *index )
+{
+	if( index )
+		Mem_Free( index );
+}
+
+/*
+* ZipIndex_Find
+*
+* Returns the number of the entry with the name, or -1 if it's not found.
+*/
+int ZipIndex_Find( const zipindex_t *index, const char *name )
+{
+	int i;
+	unsigned hash;
+	const zipentry_t *entry;
+
+	if( !index || !index->numEntries )
+		return -1;
+
+	hash = ZipIndex_HashName( name );
+	for( i = index->hashTable[hash & ( index->hashSize - 1 )]; i >= 0; i = entry->hashNext )
+	{
+		entry = &index->entries[i];
+		if( entry->hash == hash && !Q_stricmp( index->names + entry->name, name ) )
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+* ZipIndex_FindPrefix
+*
+* Returns the number of the first entry with names starting with the prefix, such as the contents
+* of a directory and its subdirectories, which are all next to each other in the sorted index.
+*/
+int ZipIndex_FindPrefix( const zipindex_t *index, const char *prefix, int *numEntries )
+{
+	int lo, hi, mid, first;
+	size_t len = strlen( prefix );
+
+	*numEntries = 0;
+	if( !index )
+		return 0;
+
+	// the first entry that isn't before the prefix
+	lo = 0;
+	hi = index->numEntries;
+	while( lo < hi )
+	{
+		mid = ( lo + hi ) >> 1;
+		if( Q_strnicmp( index->names + index->entries[mid].name, prefix, len ) < 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	first = lo;
+
+	// the first entry after the prefix
+	hi = index->numEntries;
+	while( lo < hi )
+	{
+		mid = ( lo + hi ) >> 1;
+		if( Q_strnicmp( index->names + index->entries[mid].name, prefix, len ) <= 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*numEntries = lo - first;
+	return first;
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// zipindex.h - sorted and hashed tables of archive entries, cached on disk for zip files
+
+#ifndef __ZIPINDEX_H
+#define __ZIPINDEX_H
+
+#define ZIPENTRY_DEFLATED		1
+#define ZIPENTRY_DIRECTORY		2
+#define ZIPENTRY_SHADOWED		4			// overridden by a later entry with the same name
+
+#define ZIPINDEX_LOCALHEADERS	1			// read local headers to find where the data of entries starts
+#define ZIPINDEX_NOCACHE		2			// don't save the index, such as for partially downloaded files
+
+typedef struct
+{
+	unsigned name;							// offset in the names
+	unsigned hash;
+	unsigned flags;
+	unsigned order;							// position in the archive directory
+	unsigned compressedSize, uncompressedSize;
+	unsigned offset;						// of the local header
+	unsigned dataOffset;					// of the data, only with ZIPINDEX_LOCALHEADERS
+	unsigned dosDateTime;
+	int crc;
+	int hashNext;
+} zipentry_t;
+
+typedef struct
+{
+	int numEntries;
+	zipentry_t *entries;					// sorted by name, case-insensitively
+	int hashSize;
+	int *hashTable;
+	size_t namesSize;
+	char *names;
+} zipindex_t;
+
+zipindex_t	*ZipIndex_Load( mempool_t *pool, const char *filename, unsigned archiveOffset, unsigned archiveSize, int flags, const char **error );
+zipindex_t	*ZipIndex_Build( mempool_t *pool, zipentry_t *entries, int numEntries, const char *names, size_t namesSize );
+void		ZipIndex_Free( zipindex_t *index );
+int			ZipIndex_Find( const zipindex_t *index, const char *name );
+int			ZipIndex_FindPrefix( const zipindex_t *index, const char *prefix, int *numEntries );
+
+static inline const char *ZipIndex_EntryName( const zipindex_t *index, const zipentry_t *entry )
+{
+	return index->names + entry->name;
+}
+
+#endif // __ZIPINDEX_H
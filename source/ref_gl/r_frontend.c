@@ -73,7 +73,9 @@ static void RF_AdapterFrame( ref_frontendAdapter_t *adapter )
 
 	frame = RF_GetNextAdapterFrame( adapter );
 	if( frame ) {
+		ri.Prof_Begin( "r_backend_frame" );
 		frame->RunCmds( frame );
+		ri.Prof_End();
 		adapter->lastForceVsync = frame->GetForceVsync( frame );
 		adapter->readFrameId = frame->GetFrameId( frame );
 	}
@@ -362,6 +364,8 @@ void RF_BeginFrame( float cameraSeparation, bool forceClear, bool forceVsync, bo
 {
 	int swapInterval;
 
+	ri.Prof_Begin( "r_beginframe" );
+
 	RF_CheckCvars();
 
 	// run cinematic passes on shaders
@@ -397,10 +401,14 @@ void RF_BeginFrame( float cameraSeparation, bool forceClear, bool forceVsync, bo
 	clamp_low( swapInterval, r_swapinterval_min->integer );
 
 	rrf.frame->BeginFrame( rrf.frame, cameraSeparation, forceClear, swapInterval );
+
+	ri.Prof_End();
 }
 
 void RF_EndFrame( void )
 {
+	ri.Prof_Begin( "r_endframe" );
+
 	R_DataSync();
 
 	rrf.frame->EndFrame( rrf.frame );
@@ -411,6 +419,8 @@ void RF_EndFrame( void )
 		rrf.frameId++;
 		ri.Mutex_Unlock( rrf.adapter.frameLock );
 	}
+
+	ri.Prof_End();
 }
 
 void RF_BeginRegistration( void )
@@ -469,7 +479,9 @@ void RF_AddLightStyleToScene( int style, float r, float g, float b )
 
 void RF_RenderScene( const refdef_t *fd )
 {
+	ri.Prof_Begin( "r_scene" );
 	rrf.frame->RenderScene( rrf.frame, fd );
+	ri.Prof_End();
 }
 
 void RF_DrawStretchPic( int x, int y, int w, int h, float s1, float t1, float s2, float t2, 
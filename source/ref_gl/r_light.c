@@ -393,6 +393,11 @@ static image_t *r_lightmapTextures[MAX_LIGHTMAP_IMAGES];
 static int r_numUploadedLightmaps;
 static int r_maxLightmapBlockSize;
 
+// the atlas being filled by R_PackLightmapsJob
+static const uint8_t *r_packLightmapData;
+static int r_packLightmapW, r_packLightmapH, r_packLightmapSamples;
+static int r_packLightmapDataStep, r_packLightmapRectX;
+
 /*
 * R_BuildLightmap
 */
@@ -465,6 +470,28 @@ static int R_UploadLightmap( const char *name, uint8_t *data, int w, int h, int
 	return r_numUploadedLightmaps++;
 }
 
+/*
+* R_PackLightmapsJob
+*
+* Each block of the atlas is copied into its own region of the buffer
+*/
+static void R_PackLightmapsJob( unsigned first, unsigned items, jobarg_t *j )
+{
+	unsigned i;
+	int x, y;
+	int xStride = r_packLightmapW * r_packLightmapSamples;
+	int blockWidth = r_packLightmapRectX * xStride;
+
+	for( i = first; i < first + items; i++ ) {
+		x = i % r_packLightmapRectX;
+		y = i / r_packLightmapRectX;
+		R_BuildLightmap( r_packLightmapW, r_packLightmapH,
+			mapConfig.deluxeMappingEnabled && ( i & 1 ) ? true : false,
+			r_packLightmapData ? r_packLightmapData + i * r_packLightmapDataStep : NULL,
+			r_lightmapBuffer + y * blockWidth * r_packLightmapH + x * xStride, blockWidth, r_packLightmapSamples );
+	}
+}
+
 /*
 * R_PackLightmaps
 */
@@ -472,12 +499,12 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 	const char *name, const uint8_t *data, mlightmapRect_t *rects )
 {
 	int i, x, y, root;
-	uint8_t *block;
 	int lightmapNum;
 	int rectX, rectY, rectW, rectH, rectSize;
-	int maxX, maxY, max, xStride;
+	int maxX, maxY, max;
 	double tw, th, tx, ty;
 	mlightmapRect_t *rect;
+	jobarg_t ja = { 0 };
 
 	maxX = r_maxLightmapBlockSize / w;
 	maxY = r_maxLightmapBlockSize / h;
@@ -550,7 +577,6 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 	tw = 1.0 / (double)rectX;
 	th = 1.0 / (double)rectY;
 
-	xStride = w * samples;
 	rectW = rectX * w;
 	rectH = rectY * h;
 	rectSize = rectW * rectH * samples * sizeof( *r_lightmapBuffer );
@@ -565,15 +591,19 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 
 	ri.Com_DPrintf( "%ix%i : %ix%i\n", rectX, rectY, rectW, rectH );
 
-	block = r_lightmapBuffer;
-	for( y = 0, ty = 0.0, num = 0, rect = rects; y < rectY; y++, ty += th, block += rectX * xStride * h )
+	// blocks don't overlap in the atlas, so fill it on the job threads
+	r_packLightmapData = data;
+	r_packLightmapW = w;
+	r_packLightmapH = h;
+	r_packLightmapSamples = samples;
+	r_packLightmapDataStep = dataSize * stride;
+	r_packLightmapRectX = rectX;
+	RJ_ScheduleJob( &R_PackLightmapsJob, &ja, rectX * rectY );
+
+	for( y = 0, ty = 0.0, num = 0, rect = rects; y < rectY; y++, ty += th )
 	{
-		for( x = 0, tx = 0.0; x < rectX; x++, tx += tw, num++, data += dataSize * stride )
+		for( x = 0, tx = 0.0; x < rectX; x++, tx += tw, num++ )
 		{
-			R_BuildLightmap( w, h, 
-				mapConfig.deluxeMappingEnabled && ( num & 1 ) ? true : false, 
-				data, block + x * xStride, rectX * xStride, samples );
-
 			// this is not a real texture matrix, but who cares?
 			if( rects )
 			{
@@ -584,6 +614,8 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 		}
 	}
 
+	RJ_CompleteJobs();
+
 	lightmapNum = R_UploadLightmap( name, r_lightmapBuffer, rectW, rectH, samples, deluxe );
 	if( rects )
 	{
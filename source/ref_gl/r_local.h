@@ -690,6 +690,8 @@ vboSlice_t *R_GetVBOSlice( unsigned int index );
 void R_InitDrawLists( void );
 
 void R_SortDrawList( drawList_t *list );
+void R_StopDrawListCapture( void );
+void R_DrawSortBenchmark_f( void );
 void R_DrawSurfaces( drawList_t *list );
 void R_DrawOutlinedSurfaces( drawList_t *list );
 
@@ -773,6 +775,7 @@ shader_t	*R_FindShaderForSkinFile( const struct skinfile_s *skinfile, const char
 //
 bool	R_AddSkeletalModelToDrawList( const entity_t *e );
 void	R_DrawSkeletalSurf( const entity_t *e, const shader_t *shader, const mfog_t *fog, const portalSurface_t *portalSurface, unsigned int shadowBits, drawSurfaceSkeletal_t *drawSurf );
+void		R_SkeletalCompleteTransforms( void );
 float		R_SkeletalModelBBox( const entity_t *e, vec3_t mins, vec3_t maxs );
 void		R_SkeletalModelFrameBounds( const model_t *mod, int frame, vec3_t mins, vec3_t maxs );
 int			R_SkeletalGetBoneInfo( const model_t *mod, int bonenum, char *name, size_t name_size, int *flags );
@@ -784,6 +787,8 @@ void		R_InitSkeletalCache( void );
 void		R_ClearSkeletalCache( void );
 void		R_ShutdownSkeletalCache( void );
 
+void		R_SkeletalBenchmark_f( void );
+
 //
 // r_vbo.c
 //
@@ -1258,7 +1258,9 @@ void R_RenderView( const refdef_t *fd )
 
 	if( !shadowMap ) {
 		if( ! ( rn.refdef.rdflags & RDF_NOWORLDMODEL ) ) {
+			ri.Prof_Begin( "r_world" );
 			R_DrawWorld();
+			ri.Prof_End();
 
 			if( !rn.numVisSurfaces ) {
 				// no world surfaces visible
@@ -1280,7 +1282,9 @@ void R_RenderView( const refdef_t *fd )
 
 	if( r_speeds->integer )
 		msec = ri.Sys_Milliseconds();
+	ri.Prof_Begin( "r_entities" );
 	R_DrawEntities();
+	ri.Prof_End();
 	if( r_speeds->integer )
 		rf.stats.t_add_entities += ( ri.Sys_Milliseconds() - msec );
 
@@ -1291,16 +1295,22 @@ void R_RenderView( const refdef_t *fd )
 		R_SetupViewMatrices();
 
 		// render to depth textures, mark shadowed entities and surfaces
+		ri.Prof_Begin( "r_shadowmaps" );
 		R_DrawShadowmaps();
+		ri.Prof_End();
 	}
 
+	ri.Prof_Begin( "r_sort" );
 	R_SortDrawList( rn.meshlist );
+	ri.Prof_End();
 
 	R_BindRefInstFBO();
 
 	R_SetupGL();
 
+	ri.Prof_Begin( "r_portals" );
 	R_DrawPortals();
+	ri.Prof_End();
 
 	if( r_portalonly->integer && !( rn.renderFlags & ( RF_MIRRORVIEW|RF_PORTALVIEW ) ) )
 		return;
@@ -1309,7 +1319,9 @@ void R_RenderView( const refdef_t *fd )
 
 	if( r_speeds->integer )
 		msec = ri.Sys_Milliseconds();
+	ri.Prof_Begin( "r_drawsurfs" );
 	R_DrawSurfaces( rn.meshlist );
+	ri.Prof_End();
 	if( r_speeds->integer )
 		rf.stats.t_draw_meshes += ( ri.Sys_Milliseconds() - msec );
 
@@ -239,7 +239,7 @@ void R_UpdateDrawListSurf( void *psds, unsigned order )
 /*
 * R_DrawSurfCompare
 *
-* Comparison callback function for R_SortDrawList
+* Comparison callback, the reference ordering for R_SortDrawSurfs
 */
 static int R_DrawSurfCompare( const sortedDrawSurf_t *sbs1, const sortedDrawSurf_t *sbs2 )
 {
@@ -256,20 +256,273 @@ static int R_DrawSurfCompare( const sortedDrawSurf_t *sbs1, const sortedDrawSurf
 	return 0;
 }
 
+static struct
+{
+	int file;
+	volatile int numFrames;
+} r_drawsort_capture;
+
 /*
-* R_SortDrawList
+* R_CaptureDrawList
 *
-* Regular quicksort. Note that for all kinds of transparent meshes
-* you probably want to set distance or draw order to prevent flickering
-* due to quicksort's unstable nature.
+* Appends unsorted keys of the list to the capture file.
+*/
+static void R_CaptureDrawList( const drawList_t *list )
+{
+	unsigned int i;
+	int buf[2];
+
+	buf[0] = LittleLong( list->numDrawSurfs );
+	ri.FS_Write( buf, sizeof( int ), r_drawsort_capture.file );
+
+	for( i = 0; i < list->numDrawSurfs; i++ ) {
+		buf[0] = LittleLong( list->drawSurfs[i].distKey );
+		buf[1] = LittleLong( list->drawSurfs[i].sortKey );
+		ri.FS_Write( buf, sizeof( buf ), r_drawsort_capture.file );
+	}
+
+	if( --r_drawsort_capture.numFrames == 0 ) {
+		R_StopDrawListCapture();
+	}
+}
+
+#define DRAWSORT_MAX_RUNS	16		// fall back to radix sort if there are more sorted runs than this
+
+/*
+* R_DrawSurfSortKey
+*/
+static inline uint64_t R_DrawSurfSortKey( const sortedDrawSurf_t *sds )
+{
+	return ( (uint64_t)sds->distKey << 32 ) | sds->sortKey;
+}
+
+/*
+* R_ReserveSortItems
+*/
+static void R_ReserveSortItems( drawList_t *list, unsigned int minItems )
+{
+	unsigned int newSize;
+	uint8_t *buf;
+
+	if( minItems <= list->maxSortItems ) {
+		return;
+	}
+
+	newSize = max( minItems, list->maxSortItems * 2 );
+
+	if( list->sortItems ) {
+		R_Free( list->sortItems );
+	}
+
+	// a single block for everything
+	buf = R_Malloc( newSize * ( sizeof( drawSortItem_t ) * 2 + sizeof( sortedDrawSurf_t ) + sizeof( unsigned int ) ) );
+	list->sortItems = ( drawSortItem_t * )buf; buf += newSize * sizeof( drawSortItem_t );
+	list->sortItemsTemp = ( drawSortItem_t * )buf; buf += newSize * sizeof( drawSortItem_t );
+	list->sortDrawSurfsTemp = ( sortedDrawSurf_t * )buf; buf += newSize * sizeof( sortedDrawSurf_t );
+	list->sortPerm = ( unsigned int * )buf;
+	list->numSortPerm = 0;
+	list->maxSortItems = newSize;
+}
+
+/*
+* R_FindSortedRuns
+*
+* Splits items into ascending runs. Returns 0 if there are more than maxRuns of them.
+*/
+static unsigned int R_FindSortedRuns( const drawSortItem_t *items, unsigned int numItems, unsigned int *runs, unsigned int maxRuns )
+{
+	unsigned int i, numRuns;
+
+	numRuns = 0;
+	runs[numRuns++] = 0;
+
+	for( i = 1; i < numItems; i++ ) {
+		if( items[i-1].key <= items[i].key ) {
+			continue;
+		}
+		if( numRuns == maxRuns ) {
+			return 0;
+		}
+		runs[numRuns++] = i;
+	}
+
+	runs[numRuns] = numItems;
+	return numRuns;
+}
+
+/*
+* R_MergeSortedRuns
+*
+* Stable bottom-up merge of adjacent ascending runs. Returns the buffer holding the result.
+*/
+static drawSortItem_t *R_MergeSortedRuns( drawSortItem_t *items, drawSortItem_t *temp, unsigned int *runs, unsigned int numRuns )
+{
+	unsigned int r, n, a, m, b;
+	drawSortItem_t *src = items, *dst = temp, *t;
+
+	while( numRuns > 1 ) {
+		for( r = 0, n = 0; r < numRuns; r += 2, n++ ) {
+			a = runs[r];
+			if( r + 1 == numRuns ) {
+				// odd run out
+				memcpy( dst + a, src + a, ( runs[r+1] - a ) * sizeof( *src ) );
+			}
+			else {
+				drawSortItem_t *out = dst + a;
+
+				m = runs[r+1];
+				b = runs[r+2];
+				while( a < runs[r+1] && m < b ) {
+					if( src[m].key < src[a].key ) {
+						*out++ = src[m++];
+					}
+					else {
+						*out++ = src[a++];
+					}
+				}
+				while( a < runs[r+1] ) {
+					*out++ = src[a++];
+				}
+				while( m < b ) {
+					*out++ = src[m++];
+				}
+			}
+			runs[n] = runs[r];
+		}
+
+		runs[n] = runs[numRuns];
+		numRuns = n;
+
+		t = src; src = dst; dst = t;
+	}
+
+	return src;
+}
+
+/*
+* R_RadixSortItems
+*
+* LSD radix sort of 64-bit keys, 8 bits at a time. Passes where all keys share
+* the same digit are skipped, which is the case for most of the distKey bits.
+* Returns the buffer holding the result.
+*/
+static drawSortItem_t *R_RadixSortItems( drawSortItem_t *items, drawSortItem_t *temp, unsigned int numItems )
+{
+	unsigned int i, pass, sum, c;
+	unsigned int counts[8][256];
+	drawSortItem_t *src = items, *dst = temp, *t;
+
+	memset( counts, 0, sizeof( counts ) );
+
+	for( i = 0; i < numItems; i++ ) {
+		uint64_t key = items[i].key;
+		for( pass = 0; pass < 8; pass++, key >>= 8 ) {
+			counts[pass][key & 255]++;
+		}
+	}
+
+	for( pass = 0; pass < 8; pass++ ) {
+		unsigned int *count = counts[pass];
+		const unsigned int shift = pass * 8;
+
+		if( count[( src[0].key >> shift ) & 255] == numItems ) {
+			continue;
+		}
+
+		for( i = 0, sum = 0; i < 256; i++ ) {
+			c = count[i];
+			count[i] = sum;
+			sum += c;
+		}
+
+		for( i = 0; i < numItems; i++ ) {
+			dst[count[( src[i].key >> shift ) & 255]++] = src[i];
+		}
+
+		t = src; src = dst; dst = t;
+	}
+
+	return src;
+}
+
+/*
+* R_SortDrawSurfs
+*
+* Sorts the list by distKey and sortKey. If the number of surfaces hasn't changed
+* since the last sort, the previous ordering is applied first and the result is
+* fixed up by merging its sorted runs. The same is tried on the list as it is, so
+* presorted lists and concatenations of presorted sublists are merged as well.
+* Everything else is radix sorted. All paths are stable.
+*/
+static void R_SortDrawSurfs( drawList_t *list )
+{
+	unsigned int i, numRuns;
+	unsigned int runs[DRAWSORT_MAX_RUNS+1];
+	unsigned int numDrawSurfs = list->numDrawSurfs;
+	sortedDrawSurf_t *drawSurfs = list->drawSurfs;
+	drawSortItem_t *items, *sorted;
+
+	if( numDrawSurfs < 2 ) {
+		list->numSortPerm = 0;
+		return;
+	}
+
+	R_ReserveSortItems( list, numDrawSurfs );
+
+	items = list->sortItems;
+	numRuns = 0;
+
+	// try last frame's ordering
+	if( list->numSortPerm == numDrawSurfs ) {
+		const unsigned int *perm = list->sortPerm;
+
+		for( i = 0; i < numDrawSurfs; i++ ) {
+			items[i].index = perm[i];
+			items[i].key = R_DrawSurfSortKey( &drawSurfs[perm[i]] );
+		}
+
+		numRuns = R_FindSortedRuns( items, numDrawSurfs, runs, DRAWSORT_MAX_RUNS );
+	}
+
+	if( !numRuns ) {
+		for( i = 0; i < numDrawSurfs; i++ ) {
+			items[i].index = i;
+			items[i].key = R_DrawSurfSortKey( &drawSurfs[i] );
+		}
+
+		numRuns = R_FindSortedRuns( items, numDrawSurfs, runs, DRAWSORT_MAX_RUNS );
+	}
+
+	if( numRuns ) {
+		sorted = R_MergeSortedRuns( items, list->sortItemsTemp, runs, numRuns );
+	}
+	else {
+		sorted = R_RadixSortItems( items, list->sortItemsTemp, numDrawSurfs );
+	}
+
+	for( i = 0; i < numDrawSurfs; i++ ) {
+		list->sortDrawSurfsTemp[i] = drawSurfs[sorted[i].index];
+		list->sortPerm[i] = sorted[i].index;
+	}
+	memcpy( drawSurfs, list->sortDrawSurfsTemp, numDrawSurfs * sizeof( sortedDrawSurf_t ) );
+
+	list->numSortPerm = numDrawSurfs;
+}
+
+/*
+* R_SortDrawList
 */
 void R_SortDrawList( drawList_t *list )
 {
 	if( r_draworder->integer ) {
 		return;
 	}
-	qsort( list->drawSurfs, list->numDrawSurfs, sizeof( sortedDrawSurf_t ), 
-		(int (*)(const void *, const void *))R_DrawSurfCompare );
+
+	if( list == &r_worldlist && r_drawsort_capture.numFrames ) {
+		R_CaptureDrawList( list );
+	}
+
+	R_SortDrawSurfs( list );
 }
 
 /*
@@ -436,6 +689,9 @@ static void _R_DrawSurfaces( drawList_t *list )
 		return;
 	}
 
+	// skeletal meshes queued for CPU skinning when the entities were added
+	R_SkeletalCompleteTransforms();
+
 	riFBO = RB_BoundFrameBufferObject();
 
 	RB_SetScreenImageSet( rn.st );
@@ -752,3 +1008,177 @@ void R_BuildTangentVectors( int numVertexes, vec4_t *xyzArray, vec4_t *normalsAr
 	if( tVectorsArray != stackTVectorsArray )
 		R_Free( tVectorsArray );
 }
+
+/*
+* R_StopDrawListCapture
+*/
+void R_StopDrawListCapture( void )
+{
+	r_drawsort_capture.numFrames = 0;
+
+	if( r_drawsort_capture.file ) {
+		ri.FS_FCloseFile( r_drawsort_capture.file );
+		r_drawsort_capture.file = 0;
+		Com_Printf( "Draw list capture finished\n" );
+	}
+}
+
+/*
+* R_DrawSortBenchmark_f
+*
+* drawsortbenchmark capture <name> [frames]
+* drawsortbenchmark <name> [runs]
+*
+* The first form records unsorted keys of the main view draw lists for the
+* following frames into drawlists/<name>.drawlist. The second one replays
+* a recording through qsort and R_SortDrawSurfs, both with and without the
+* ordering from the previous frame, checking that all of them agree.
+*/
+void R_DrawSortBenchmark_f( void )
+{
+	int i, run, numRuns, frame, numFrames, length, file;
+	unsigned int j, numKeys, maxKeys, totalKeys;
+	char filename[MAX_QPATH];
+	const char *name;
+	int *data, *keys;
+	drawList_t cold, warm;
+	sortedDrawSurf_t *reference;
+	uint64_t t, qsorttime, radixtime, coherenttime;
+	bool mismatch;
+
+	if( ri.Cmd_Argc() < 2 || ( !Q_stricmp( ri.Cmd_Argv( 1 ), "capture" ) && ri.Cmd_Argc() < 3 ) ) {
+		Com_Printf( "Usage: %s [capture] <name> [frames|runs]\n", ri.Cmd_Argv( 0 ) );
+		return;
+	}
+
+	if( !Q_stricmp( ri.Cmd_Argv( 1 ), "capture" ) ) {
+		name = ri.Cmd_Argv( 2 );
+		numFrames = ri.Cmd_Argc() > 3 ? max( atoi( ri.Cmd_Argv( 3 ) ), 1 ) : 100;
+	}
+	else {
+		name = ri.Cmd_Argv( 1 );
+		numFrames = 0;
+	}
+
+	Q_snprintfz( filename, sizeof( filename ), "drawlists/%s", name );
+	COM_SanitizeFilePath( filename );
+	COM_DefaultExtension( filename, ".drawlist", sizeof( filename ) );
+	if( !COM_ValidateRelativeFilename( filename ) ) {
+		Com_Printf( "Invalid filename\n" );
+		return;
+	}
+
+	if( numFrames ) {
+		R_StopDrawListCapture();
+
+		if( ri.FS_FOpenFile( filename, &file, FS_WRITE ) == -1 ) {
+			Com_Printf( "Couldn't open %s for writing\n", filename );
+			return;
+		}
+
+		Com_Printf( "Capturing %i frames to %s\n", numFrames, filename );
+		r_drawsort_capture.file = file;
+		r_drawsort_capture.numFrames = numFrames;
+		return;
+	}
+
+	length = ri.FS_FOpenFile( filename, &file, FS_READ );
+	if( length <= 0 ) {
+		if( length == 0 ) {
+			ri.FS_FCloseFile( file );
+		}
+		Com_Printf( "Couldn't open %s\n", filename );
+		return;
+	}
+
+	data = R_Malloc( length );
+	ri.FS_Read( data, length, file );
+	ri.FS_FCloseFile( file );
+
+	// validate and find the largest frame
+	numFrames = 0;
+	maxKeys = totalKeys = 0;
+	for( i = 0; i < length / (int)sizeof( int ); ) {
+		numKeys = LittleLong( data[i] );
+		if( numKeys > (unsigned)( length / sizeof( int ) - i - 1 ) / 2 ) {
+			break;
+		}
+		maxKeys = max( maxKeys, numKeys );
+		totalKeys += numKeys;
+		i += 1 + numKeys * 2;
+		numFrames++;
+	}
+
+	if( !numFrames || !maxKeys ) {
+		Com_Printf( "%s is empty or truncated\n", filename );
+		R_Free( data );
+		return;
+	}
+
+	numRuns = ri.Cmd_Argc() > 2 ? max( atoi( ri.Cmd_Argv( 2 ) ), 1 ) : 10;
+
+	R_InitDrawList( &cold );
+	R_ReserveDrawSurfaces( &cold, maxKeys );
+	R_InitDrawList( &warm );
+	R_ReserveDrawSurfaces( &warm, maxKeys );
+	reference = R_Malloc( maxKeys * sizeof( *reference ) );
+
+	qsorttime = radixtime = coherenttime = 0;
+	mismatch = false;
+
+	for( run = 0; run < numRuns; run++ ) {
+		for( frame = 0, keys = data; frame < numFrames; frame++, keys += 1 + numKeys * 2 ) {
+			numKeys = LittleLong( keys[0] );
+
+			for( j = 0; j < numKeys; j++ ) {
+				reference[j].distKey = LittleLong( keys[1 + j * 2] );
+				reference[j].sortKey = LittleLong( keys[1 + j * 2 + 1] );
+				reference[j].drawSurf = NULL;
+			}
+
+			// no ordering from the previous frame
+			memcpy( cold.drawSurfs, reference, numKeys * sizeof( *reference ) );
+			cold.numDrawSurfs = numKeys;
+			cold.numSortPerm = 0;
+			t = ri.Sys_Microseconds();
+			R_SortDrawSurfs( &cold );
+			radixtime += ri.Sys_Microseconds() - t;
+
+			// sort as in the game, reusing the previous frame's ordering
+			memcpy( warm.drawSurfs, reference, numKeys * sizeof( *reference ) );
+			warm.numDrawSurfs = numKeys;
+			t = ri.Sys_Microseconds();
+			R_SortDrawSurfs( &warm );
+			coherenttime += ri.Sys_Microseconds() - t;
+
+			t = ri.Sys_Microseconds();
+			qsort( reference, numKeys, sizeof( *reference ), 
+				(int (*)(const void *, const void *))R_DrawSurfCompare );
+			qsorttime += ri.Sys_Microseconds() - t;
+
+			for( j = 0; j < numKeys; j++ ) {
+				if( cold.drawSurfs[j].distKey != reference[j].distKey || cold.drawSurfs[j].sortKey != reference[j].sortKey ||
+					warm.drawSurfs[j].distKey != reference[j].distKey || warm.drawSurfs[j].sortKey != reference[j].sortKey ) {
+					mismatch = true;
+					break;
+				}
+			}
+		}
+	}
+
+	Com_Printf( "%s: %i frames, %i surfaces per frame on average, %i runs\n", filename, 
+		numFrames, totalKeys / numFrames, numRuns );
+	Com_Printf( "qsort:     %8.3f ms/frame\n", qsorttime / 1000.0 / ( numFrames * numRuns ) );
+	Com_Printf( "cold:      %8.3f ms/frame\n", radixtime / 1000.0 / ( numFrames * numRuns ) );
+	Com_Printf( "coherent:  %8.3f ms/frame\n", coherenttime / 1000.0 / ( numFrames * numRuns ) );
+	if( mismatch ) {
+		Com_Printf( S_COLOR_RED "Sort results differ from qsort!\n" );
+	}
+
+	R_Free( reference );
+	R_Free( warm.sortItems );
+	R_Free( warm.drawSurfs );
+	R_Free( cold.sortItems );
+	R_Free( cold.drawSurfs );
+	R_Free( data );
+}
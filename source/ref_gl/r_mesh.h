@@ -57,11 +57,25 @@ typedef struct
 	drawSurfaceType_t	*drawSurf;
 } sortedDrawSurf_t;
 
+typedef struct
+{
+	uint64_t			key;
+	unsigned int		index;
+} drawSortItem_t;
+
 typedef struct
 {
 	unsigned int		numDrawSurfs, maxDrawSurfs;
 	sortedDrawSurf_t	*drawSurfs;
 
+	// sort scratch space and the ordering produced by the last sort,
+	// which is tried first in case the list hasn't changed much
+	unsigned int		maxSortItems;
+	drawSortItem_t		*sortItems, *sortItemsTemp;
+	sortedDrawSurf_t	*sortDrawSurfsTemp;
+	unsigned int		numSortPerm;
+	unsigned int		*sortPerm;
+
 	unsigned int		maxVboSlices;
 	vboSlice_t			*vboSlices;
 
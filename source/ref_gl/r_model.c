@@ -1019,6 +1019,8 @@ model_t *Mod_ForName( const char *name, bool crash )
 	int i;
 	model_t	*mod, *lod;
 	unsigned *buf;
+	bool mapped = false;
+	unsigned loadtime;
 	char shortname[MAX_QPATH], lodname[MAX_QPATH];
 	const char *extension;
 	const modelFormatDescr_t *descr;
@@ -1053,7 +1055,13 @@ model_t *Mod_ForName( const char *name, bool crash )
 	//
 	// load the file
 	//
-	modfilelen = R_LoadFile( name, (void **)&buf );
+	loadtime = ri.Sys_Milliseconds();
+
+	// the world model shares the file with the collision map, which usually has it mapped already
+	if( mod_isworldmodel )
+		modfilelen = ri.FS_LoadMappedFile( name, (void **)&buf, &mapped );
+	else
+		modfilelen = R_LoadFile( name, (void **)&buf );
 	if( !buf && crash )
 		ri.Com_Error( ERR_DROP, "Mod_NumForName: %s not found", name );
 
@@ -1076,6 +1084,10 @@ model_t *Mod_ForName( const char *name, bool crash )
 	if( !descr )
 	{
 		ri.Com_DPrintf( S_COLOR_YELLOW "Mod_NumForName: unknown fileid for %s", mod->name );
+		if( mod_isworldmodel )
+			ri.FS_FreeMappedFile( buf );
+		else
+			R_FreeFile( buf );
 		return NULL;
 	}
 
@@ -1085,7 +1097,15 @@ model_t *Mod_ForName( const char *name, bool crash )
 	}
 
 	descr->loader( mod, NULL, buf, bspFormat );
-	R_FreeFile( buf );
+
+	if( mod_isworldmodel ) {
+		ri.FS_FreeMappedFile( buf );
+		ri.Com_DPrintf( "Mod_ForName: loaded %s in %u msec, %s, %u KiB of model data\n", name,
+			ri.Sys_Milliseconds() - loadtime, mapped ? "mapped" : "not mapped", (unsigned)( ri.Mem_PoolTotalSize( mod->mempool ) >> 10 ) );
+	}
+	else {
+		R_FreeFile( buf );
+	}
 
 	if( mod->type == mod_bad ) {
 		return NULL;
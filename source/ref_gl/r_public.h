@@ -22,7 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../cgame/ref.h"
 
-#define REF_API_VERSION 23
+#define REF_API_VERSION 25
 
 struct mempool_s;
 struct cinematics_s;
@@ -64,6 +64,9 @@ typedef struct
 	uint64_t ( *Sys_Microseconds )( void );
 	void ( *Sys_Sleep )( unsigned int milliseconds );
 
+	void ( *Prof_Begin )( const char *name );
+	void ( *Prof_End )( void );
+
 	void *( *Com_LoadSysLibrary )( const char *name, dllfunc_t *funcs );
 	void ( *Com_UnloadLibrary )( void **lib );
 	void *( *Com_LibraryProcAddress )( void *lib, const char *name );
@@ -90,6 +93,8 @@ typedef struct
 	const char * ( *FS_WriteDirectory )( void );
 	const char * ( *FS_MediaDirectory )( fs_mediatype_t type );
 	void ( *FS_AddFileToMedia )( const char *filename );
+	int ( *FS_LoadMappedFile )( const char *path, void **buffer, bool *mapped );
+	void ( *FS_FreeMappedFile )( void *buffer );
 
 	struct cinematics_s *( *CIN_Open )( const char *name, unsigned int start_time, bool *yuv, float *framerate );
 	bool ( *CIN_NeedNextFrame )( struct cinematics_s *cin, unsigned int curtime );
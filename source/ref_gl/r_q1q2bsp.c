@@ -1928,7 +1928,7 @@ static void Mod_Q2LoadEntities( const lump_t *l )
 void Mod_LoadQ2BrushModel( model_t *mod, model_t *parent, void *buffer, bspFormatDesc_t *format )
 {
 	int i;
-	q2dheader_t *header;
+	q2dheader_t header;
 
 	mod->type = mod_brush;
 	mod->registrationSequence = rsh.registrationSequence;
@@ -1940,25 +1940,26 @@ void Mod_LoadQ2BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 
 	mod_bspFormat = format;
 
-	header = ( q2dheader_t * )buffer;
-	mod_base = ( uint8_t * )header;
+	// the buffer may be a read-only file mapping, so swap a copy of the header
+	header = *( q2dheader_t * )buffer;
+	mod_base = ( uint8_t * )buffer;
 
 	// swap all the lumps
-	for( i = 0; i < sizeof( *header )/4; i++ )
-		( (int *)header )[i] = LittleLong( ( (int *)header )[i] );
+	for( i = 0; i < sizeof( header )/4; i++ )
+		( (int *)&header )[i] = LittleLong( ( (int *)&header )[i] );
 
 	// load into heap
-	Mod_Q2LoadEntities( &header->lumps[Q2_LUMP_ENTITIES] );
-	Mod_Q2LoadSubmodels( &header->lumps[Q2_LUMP_MODELS] );
-	Mod_Q2LoadVertexes( &header->lumps[Q2_LUMP_VERTEXES] );
-	Mod_Q2LoadEdges( &header->lumps[Q2_LUMP_EDGES] );
-	Mod_Q2LoadSurfedges( &header->lumps[Q2_LUMP_SURFEDGES] );
-	Mod_Q2LoadLighting( &header->lumps[Q2_LUMP_LIGHTING] );
-	Mod_Q2LoadPlanes( &header->lumps[Q2_LUMP_PLANES] );
-	Mod_Q2LoadTexinfo( &header->lumps[Q2_LUMP_TEXINFO] );
-	Mod_Q2LoadFaces( &header->lumps[Q2_LUMP_FACES] );
-	Mod_Q2LoadLeafs( &header->lumps[Q2_LUMP_LEAFS], &header->lumps[Q2_LUMP_LEAFFACES] );
-	Mod_Q2LoadNodes( &header->lumps[Q2_LUMP_NODES] );
+	Mod_Q2LoadEntities( &header.lumps[Q2_LUMP_ENTITIES] );
+	Mod_Q2LoadSubmodels( &header.lumps[Q2_LUMP_MODELS] );
+	Mod_Q2LoadVertexes( &header.lumps[Q2_LUMP_VERTEXES] );
+	Mod_Q2LoadEdges( &header.lumps[Q2_LUMP_EDGES] );
+	Mod_Q2LoadSurfedges( &header.lumps[Q2_LUMP_SURFEDGES] );
+	Mod_Q2LoadLighting( &header.lumps[Q2_LUMP_LIGHTING] );
+	Mod_Q2LoadPlanes( &header.lumps[Q2_LUMP_PLANES] );
+	Mod_Q2LoadTexinfo( &header.lumps[Q2_LUMP_TEXINFO] );
+	Mod_Q2LoadFaces( &header.lumps[Q2_LUMP_FACES] );
+	Mod_Q2LoadLeafs( &header.lumps[Q2_LUMP_LEAFS], &header.lumps[Q2_LUMP_LEAFFACES] );
+	Mod_Q2LoadNodes( &header.lumps[Q2_LUMP_NODES] );
 
 	Mod_Finish();
 }
@@ -2785,7 +2786,7 @@ void Mod_LoadQ1BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 {
 	int i;
 	int numvisleafs;
-	q1dheader_t *header;
+	q1dheader_t header;
 
 	mod->type = mod_brush;
 	mod->registrationSequence = rsh.registrationSequence;
@@ -2796,25 +2797,26 @@ void Mod_LoadQ1BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 
 	mod_bspFormat = format;
 
-	header = ( q1dheader_t * )buffer;
-	mod_base = ( uint8_t * )header;
+	// the buffer may be a read-only file mapping, so swap a copy of the header
+	header = *( q1dheader_t * )buffer;
+	mod_base = ( uint8_t * )buffer;
 
 	// swap all the lumps
 	for( i = 0; i < sizeof( header )/4; i++ )
-		( (int *)header )[i] = LittleLong( ( (int *)header )[i] );
+		( (int *)&header )[i] = LittleLong( ( (int *)&header )[i] );
 
 	// load into heap
-	numvisleafs = Mod_Q1LoadSubmodels( &header->lumps[Q1_LUMP_MODELS] );
-	Mod_Q1LoadVertexes( &header->lumps[Q1_LUMP_VERTEXES] );
-	Mod_Q1LoadEdges( &header->lumps[Q1_LUMP_EDGES] );
-	Mod_Q1LoadSurfedges( &header->lumps[Q1_LUMP_SURFEDGES] );
-	Mod_Q1LoadLighting( &header->lumps[Q1_LUMP_LIGHTING] );
-	Mod_Q1LoadPlanes( &header->lumps[Q1_LUMP_PLANES] );
-	Mod_Q1LoadMiptex( &header->lumps[Q1_LUMP_TEXTURES] );
-	Mod_Q1LoadTexinfo( &header->lumps[Q1_LUMP_TEXINFO] );
-	Mod_Q1LoadFaces( &header->lumps[Q1_LUMP_FACES] );
-	Mod_Q1LoadLeafs( &header->lumps[Q1_LUMP_LEAFS], &header->lumps[Q1_LUMP_MARKSURFACES], numvisleafs );
-	Mod_Q1LoadNodes( &header->lumps[Q1_LUMP_NODES] );
+	numvisleafs = Mod_Q1LoadSubmodels( &header.lumps[Q1_LUMP_MODELS] );
+	Mod_Q1LoadVertexes( &header.lumps[Q1_LUMP_VERTEXES] );
+	Mod_Q1LoadEdges( &header.lumps[Q1_LUMP_EDGES] );
+	Mod_Q1LoadSurfedges( &header.lumps[Q1_LUMP_SURFEDGES] );
+	Mod_Q1LoadLighting( &header.lumps[Q1_LUMP_LIGHTING] );
+	Mod_Q1LoadPlanes( &header.lumps[Q1_LUMP_PLANES] );
+	Mod_Q1LoadMiptex( &header.lumps[Q1_LUMP_TEXTURES] );
+	Mod_Q1LoadTexinfo( &header.lumps[Q1_LUMP_TEXINFO] );
+	Mod_Q1LoadFaces( &header.lumps[Q1_LUMP_FACES] );
+	Mod_Q1LoadLeafs( &header.lumps[Q1_LUMP_LEAFS], &header.lumps[Q1_LUMP_MARKSURFACES], numvisleafs );
+	Mod_Q1LoadNodes( &header.lumps[Q1_LUMP_NODES] );
 
 	Mod_Finish();
 }
@@ -224,8 +224,11 @@ static void Mod_PreloadFaces( const lump_t *l )
 		if( l->filelen % sizeof( *in ) )
 			ri.Com_Error( ERR_DROP, "Mod_LoadFaces: funny lump size in %s", loadmodel->name );
 
+		// lighting data is adjusted below and the buffer may be a read-only file mapping
 		loadmodel_numsurfaces = l->filelen / sizeof( *in );
-		loadmodel_dsurfaces = in;
+		loadmodel_dsurfaces = Mod_Malloc( loadmodel, loadmodel_numsurfaces*sizeof( *in ) );
+		memcpy( loadmodel_dsurfaces, in, loadmodel_numsurfaces*sizeof( *in ) );
+		in = loadmodel_dsurfaces;
 
 		// verify lighting data
 		for( i = 0; i < loadmodel_numsurfaces; i++, in++ ) {
@@ -1640,6 +1643,20 @@ static void Mod_ApplySuperStylesToFace( const rdface_t *in, msurface_t *out )
 	out->superLightStyle = R_AddSuperLightStyle( loadmodel, lightmaps, lightmapStyles, vertexStyles, lmRects );
 }
 
+/*
+* Mod_CreateMeshesJob
+*/
+static void Mod_CreateMeshesJob( unsigned first, unsigned items, jobarg_t *j )
+{
+	unsigned i;
+	msurface_t *surf;
+
+	for( i = first; i < first + items; i++ ) {
+		surf = loadbmodel->surfaces + i;
+		surf->mesh = Mod_CreateMeshForSurface( loadmodel_dsurfaces + i, surf, loadmodel_patchgrouprefs[i] );
+	}
+}
+
 /*
 * Mod_Finish
 */
@@ -1650,6 +1667,7 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 	mfog_t *testFog;
 	bool globalFog;
 	rdface_t *in;
+	jobarg_t ja = { 0 };
 
 	// remembe the BSP format just in case
 	loadbmodel->format = mod_bspFormat;
@@ -1718,10 +1736,13 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 
 	R_SortSuperLightStyles( loadmodel );
 
+	// surfaces are independent of each other, so tessellate them on the job threads
+	RJ_ScheduleJob( &Mod_CreateMeshesJob, &ja, loadbmodel->numsurfaces );
+	RJ_CompleteJobs();
+
 	in = loadmodel_dsurfaces;
 	surf = loadbmodel->surfaces;
 	for( i = 0; i < loadbmodel->numsurfaces; i++, in++, surf++ ) {
-		surf->mesh = Mod_CreateMeshForSurface( in, surf, loadmodel_patchgrouprefs[i] );
 		if( surf->mesh ) {
 			surf->numVerts = surf->mesh->numVerts;
 			surf->numElems = surf->mesh->numElems;
@@ -1746,9 +1767,7 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 		ri.Com_DPrintf( "Global fog detected: %s\n", testFog->shader->name );
 	}
 
-	if( !( mod_bspFormat->flags & BSP_RAVEN ) ) {
-		Mod_MemFree( loadmodel_dsurfaces );
-	}
+	Mod_MemFree( loadmodel_dsurfaces );
 	loadmodel_dsurfaces = NULL;
 	loadmodel_numsurfaces = 0;
 
@@ -1782,7 +1801,7 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 void Mod_LoadQ3BrushModel( model_t *mod, model_t *parent, void *buffer, bspFormatDesc_t *format )
 {
 	int i;
-	dheader_t *header;
+	dheader_t header;
 	vec3_t gridSize, ambient, outline;
 
 	mod->type = mod_brush;
@@ -1794,38 +1813,39 @@ void Mod_LoadQ3BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 
 	mod_bspFormat = format;
 
-	header = (dheader_t *)buffer;
-	mod_base = (uint8_t *)header;
+	// the buffer may be a read-only file mapping, so swap a copy of the header
+	header = *(dheader_t *)buffer;
+	mod_base = (uint8_t *)buffer;
 
 	// swap all the lumps
 	for( i = 0; i < sizeof( dheader_t )/4; i++ )
-		( (int *)header )[i] = LittleLong( ( (int *)header )[i] );
+		( (int *)&header )[i] = LittleLong( ( (int *)&header )[i] );
 
 	// load into heap
-	Mod_LoadSubmodels( &header->lumps[LUMP_MODELS] );
-	Mod_LoadEntities( &header->lumps[LUMP_ENTITIES], gridSize, ambient, outline );
-	Mod_LoadLighting( &header->lumps[LUMP_LIGHTING], &header->lumps[LUMP_FACES] );
-	Mod_LoadShaderrefs( &header->lumps[LUMP_SHADERREFS] );
-	Mod_PreloadFaces( &header->lumps[LUMP_FACES] );
-	Mod_LoadPlanes( &header->lumps[LUMP_PLANES] );
-	Mod_LoadFogs( &header->lumps[LUMP_FOGS], &header->lumps[LUMP_BRUSHES], &header->lumps[LUMP_BRUSHSIDES] );
-	Mod_LoadFaces( &header->lumps[LUMP_FACES] );
+	Mod_LoadSubmodels( &header.lumps[LUMP_MODELS] );
+	Mod_LoadEntities( &header.lumps[LUMP_ENTITIES], gridSize, ambient, outline );
+	Mod_LoadLighting( &header.lumps[LUMP_LIGHTING], &header.lumps[LUMP_FACES] );
+	Mod_LoadShaderrefs( &header.lumps[LUMP_SHADERREFS] );
+	Mod_PreloadFaces( &header.lumps[LUMP_FACES] );
+	Mod_LoadPlanes( &header.lumps[LUMP_PLANES] );
+	Mod_LoadFogs( &header.lumps[LUMP_FOGS], &header.lumps[LUMP_BRUSHES], &header.lumps[LUMP_BRUSHSIDES] );
+	Mod_LoadFaces( &header.lumps[LUMP_FACES] );
 	if( mod_bspFormat->flags & BSP_RAVEN )
-		Mod_LoadVertexes_RBSP( &header->lumps[LUMP_VERTEXES] );
+		Mod_LoadVertexes_RBSP( &header.lumps[LUMP_VERTEXES] );
 	else
-		Mod_LoadVertexes( &header->lumps[LUMP_VERTEXES] );
-	Mod_LoadElems( &header->lumps[LUMP_ELEMENTS] );
+		Mod_LoadVertexes( &header.lumps[LUMP_VERTEXES] );
+	Mod_LoadElems( &header.lumps[LUMP_ELEMENTS] );
 	if( mod_bspFormat->flags & BSP_RAVEN )
-		Mod_LoadLightgrid_RBSP( &header->lumps[LUMP_LIGHTGRID] );
+		Mod_LoadLightgrid_RBSP( &header.lumps[LUMP_LIGHTGRID] );
 	else
-		Mod_LoadLightgrid( &header->lumps[LUMP_LIGHTGRID] );
-	Mod_LoadPatchGroups( &header->lumps[LUMP_FACES] );
-	Mod_LoadLeafs( &header->lumps[LUMP_LEAFS], &header->lumps[LUMP_LEAFFACES] );
-	Mod_LoadNodes( &header->lumps[LUMP_NODES] );
+		Mod_LoadLightgrid( &header.lumps[LUMP_LIGHTGRID] );
+	Mod_LoadPatchGroups( &header.lumps[LUMP_FACES] );
+	Mod_LoadLeafs( &header.lumps[LUMP_LEAFS], &header.lumps[LUMP_LEAFFACES] );
+	Mod_LoadNodes( &header.lumps[LUMP_NODES] );
 	if( mod_bspFormat->flags & BSP_RAVEN )
-		Mod_LoadLightArray_RBSP( &header->lumps[LUMP_LIGHTARRAY] );
+		Mod_LoadLightArray_RBSP( &header.lumps[LUMP_LIGHTARRAY] );
 	else
 		Mod_LoadLightArray();
 
-	Mod_Finish( &header->lumps[LUMP_FACES], &header->lumps[LUMP_LIGHTING], gridSize, ambient, outline );
+	Mod_Finish( &header.lumps[LUMP_FACES], &header.lumps[LUMP_LIGHTING], gridSize, ambient, outline );
 }
@@ -1208,6 +1208,8 @@ static void R_Register( const char *screenshotsPrefix )
 	ri.Cmd_AddCommand( "gfxinfo", R_GfxInfo_f );
 	ri.Cmd_AddCommand( "glslprogramlist", RP_ProgramList_f );
 	ri.Cmd_AddCommand( "cinlist", R_CinList_f );
+	ri.Cmd_AddCommand( "skmbenchmark", R_SkeletalBenchmark_f );
+	ri.Cmd_AddCommand( "drawsortbenchmark", R_DrawSortBenchmark_f );
 }
 
 /*
@@ -1579,6 +1581,10 @@ void R_Shutdown( bool verbose )
 	ri.Cmd_RemoveCommand( "shaderlist" );
 	ri.Cmd_RemoveCommand( "glslprogramlist" );
 	ri.Cmd_RemoveCommand( "cinlist" );
+	ri.Cmd_RemoveCommand( "skmbenchmark" );
+	ri.Cmd_RemoveCommand( "drawsortbenchmark" );
+
+	R_StopDrawListCapture();
 
 	// free shaders, models, etc.
 
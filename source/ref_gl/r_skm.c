@@ -21,8 +21,15 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // r_skm.c: skeletal animation model format
 
 #include "r_local.h"
+#include "r_frontend.h"
 #include "iqm.h"
 
+#if defined( HAVE_SSE2 )
+#include <emmintrin.h>
+#elif defined( HAVE_NEON )
+#include <arm_neon.h>
+#endif
+
 // typedefs
 typedef struct iqmheader iqmheader_t;
 typedef struct iqmvertexarray iqmvertexarray_t;
@@ -915,6 +922,36 @@ static skmcacheentry_t *r_skmcachekeys[MAX_REF_ENTITIES*(MOD_MAX_LODS+1)];		// e
 
 #define R_SKMCacheAlloc(size) R_MallocExt(r_skmcachepool, (size), 16, 1)
 
+#define SKM_MAX_TRANSFORMS		2048
+#define SKM_TRANSFORM_VERTS		2048	// meshes are split into ranges of at most this many vertices
+
+// CPU skinned vertices of a mesh for this frame
+typedef struct
+{
+	vattribmask_t vattribs;         // transformed attributes, 0 if the mesh hasn't been queued
+	vec4_t *xyzArray, *normalsArray, *sVectorsArray;
+} skmskinnedmesh_t;
+
+// bone transforms and skinned meshes of an entity for this frame, lives in the skeletal cache
+typedef struct
+{
+	dualquat_t *bonePoseRelativeDQ;
+	mat4_t *bonePoseRelativeMat;    // NULL if every mesh is skinned on the GPU
+	skmskinnedmesh_t *meshes;
+} skmentitycache_t;
+
+// a range of vertices to transform, every job works on its own ranges
+typedef struct
+{
+	const mskmesh_t *mesh;
+	unsigned int first, numverts;
+	mat4_t *relbonepose;
+	vec4_t *xyzArray, *normalsArray, *sVectorsArray;
+} skmtransform_t;
+
+static skmtransform_t r_skmtransforms[SKM_MAX_TRANSFORMS];
+static unsigned int r_numskmtransforms;
+
 /*
 * R_InitSkeletalCache
 */
@@ -1030,6 +1067,9 @@ void R_ClearSkeletalCache( void )
 	r_skmcache_head = NULL;
 
 	memset( r_skmcachekeys, 0, sizeof( r_skmcachekeys ) );
+
+	// transforms that were never completed point into the cache
+	r_numskmtransforms = 0;
 }
 
 /*
@@ -1055,6 +1095,236 @@ void R_ShutdownSkeletalCache( void )
 # pragma fp_contract(on)		// this line is needed on Itanium processors
 #endif
 
+#if defined( HAVE_SSE2 )
+
+/*
+* R_SkeletalBlendPoses
+*
+* SSE2 version: blends full matrix columns, the 4th row comes out as
+* the weighted sum of the source rows, which the transforms ignore.
+*/
+static void R_SkeletalBlendPoses( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose )
+{
+	unsigned int i, j, k;
+	float *pose;
+	const float *b;
+	mskblend_t *blend;
+	__m128 f, c0, c1, c2, c3;
+
+	for( i = 0, j = numbones, blend = blends; i < numblends; i++, j++, blend++ ) {
+		pose = relbonepose[j];
+
+		b = relbonepose[blend->indices[0]];
+		f = _mm_set1_ps( blend->weights[0] * (1.0 / 255.0) );
+
+		c0 = _mm_mul_ps( f, _mm_loadu_ps( b +  0 ) );
+		c1 = _mm_mul_ps( f, _mm_loadu_ps( b +  4 ) );
+		c2 = _mm_mul_ps( f, _mm_loadu_ps( b +  8 ) );
+		c3 = _mm_mul_ps( f, _mm_loadu_ps( b + 12 ) );
+
+		for( k = 1; k < SKM_MAX_WEIGHTS && blend->weights[k]; k++ ) {
+			b = relbonepose[blend->indices[k]];
+			f = _mm_set1_ps( blend->weights[k] * (1.0 / 255.0) );
+
+			c0 = _mm_add_ps( c0, _mm_mul_ps( f, _mm_loadu_ps( b +  0 ) ) );
+			c1 = _mm_add_ps( c1, _mm_mul_ps( f, _mm_loadu_ps( b +  4 ) ) );
+			c2 = _mm_add_ps( c2, _mm_mul_ps( f, _mm_loadu_ps( b +  8 ) ) );
+			c3 = _mm_add_ps( c3, _mm_mul_ps( f, _mm_loadu_ps( b + 12 ) ) );
+		}
+
+		_mm_storeu_ps( pose +  0, c0 );
+		_mm_storeu_ps( pose +  4, c1 );
+		_mm_storeu_ps( pose +  8, c2 );
+		_mm_storeu_ps( pose + 12, c3 );
+	}
+}
+
+#define R_SKM_XYZ_MASK	_mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) )
+
+/*
+* R_SkeletalTransformVerts
+*/
+static void R_SkeletalTransformVerts( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov )
+{
+	const float *pose;
+	const __m128 mask = R_SKM_XYZ_MASK;
+	const __m128 w = _mm_set_ps( 1, 0, 0, 0 );
+	__m128 r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		r = _mm_mul_ps( _mm_set1_ps( v[0] ), _mm_loadu_ps( pose + 0 ) );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[1] ), _mm_loadu_ps( pose + 4 ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[2] ), _mm_loadu_ps( pose + 8 ) ) );
+		r = _mm_add_ps( r, _mm_loadu_ps( pose + 12 ) );
+
+		_mm_storeu_ps( ov, _mm_or_ps( _mm_and_ps( r, mask ), w ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormals
+*/
+static void R_SkeletalTransformNormals( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov )
+{
+	const float *pose;
+	const __m128 mask = R_SKM_XYZ_MASK;
+	__m128 r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		r = _mm_mul_ps( _mm_set1_ps( v[0] ), _mm_loadu_ps( pose + 0 ) );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[1] ), _mm_loadu_ps( pose + 4 ) ) );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[2] ), _mm_loadu_ps( pose + 8 ) ) );
+
+		_mm_storeu_ps( ov, _mm_and_ps( r, mask ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormalsAndSVecs
+*/
+static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv )
+{
+	const float *pose;
+	const __m128 mask = R_SKM_XYZ_MASK;
+	__m128 c0, c1, c2, r, s, in;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, sv += 4, osv += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		c0 = _mm_loadu_ps( pose + 0 );
+		c1 = _mm_loadu_ps( pose + 4 );
+		c2 = _mm_loadu_ps( pose + 8 );
+
+		r = _mm_mul_ps( _mm_set1_ps( v[0] ), c0 );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[1] ), c1 ) );
+		r = _mm_add_ps( r, _mm_mul_ps( _mm_set1_ps( v[2] ), c2 ) );
+		_mm_storeu_ps( ov, _mm_and_ps( r, mask ) );
+
+		in = _mm_loadu_ps( sv );
+		s = _mm_mul_ps( _mm_set1_ps( sv[0] ), c0 );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_set1_ps( sv[1] ), c1 ) );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_set1_ps( sv[2] ), c2 ) );
+		_mm_storeu_ps( osv, _mm_or_ps( _mm_and_ps( s, mask ), _mm_andnot_ps( mask, in ) ) );
+	}
+}
+
+#undef R_SKM_XYZ_MASK
+
+#elif defined( HAVE_NEON )
+
+/*
+* R_SkeletalBlendPoses
+*
+* NEON version, see the SSE2 one above.
+*/
+static void R_SkeletalBlendPoses( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose )
+{
+	unsigned int i, j, k;
+	float *pose;
+	const float *b;
+	mskblend_t *blend;
+	float f;
+	float32x4_t c0, c1, c2, c3;
+
+	for( i = 0, j = numbones, blend = blends; i < numblends; i++, j++, blend++ ) {
+		pose = relbonepose[j];
+
+		b = relbonepose[blend->indices[0]];
+		f = blend->weights[0] * (1.0 / 255.0);
+
+		c0 = vmulq_n_f32( vld1q_f32( b +  0 ), f );
+		c1 = vmulq_n_f32( vld1q_f32( b +  4 ), f );
+		c2 = vmulq_n_f32( vld1q_f32( b +  8 ), f );
+		c3 = vmulq_n_f32( vld1q_f32( b + 12 ), f );
+
+		for( k = 1; k < SKM_MAX_WEIGHTS && blend->weights[k]; k++ ) {
+			b = relbonepose[blend->indices[k]];
+			f = blend->weights[k] * (1.0 / 255.0);
+
+			c0 = vmlaq_n_f32( c0, vld1q_f32( b +  0 ), f );
+			c1 = vmlaq_n_f32( c1, vld1q_f32( b +  4 ), f );
+			c2 = vmlaq_n_f32( c2, vld1q_f32( b +  8 ), f );
+			c3 = vmlaq_n_f32( c3, vld1q_f32( b + 12 ), f );
+		}
+
+		vst1q_f32( pose +  0, c0 );
+		vst1q_f32( pose +  4, c1 );
+		vst1q_f32( pose +  8, c2 );
+		vst1q_f32( pose + 12, c3 );
+	}
+}
+
+/*
+* R_SkeletalTransformVerts
+*/
+static void R_SkeletalTransformVerts( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov )
+{
+	const float *pose;
+	float32x4_t r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		r = vmlaq_n_f32( vld1q_f32( pose + 12 ), vld1q_f32( pose + 0 ), v[0] );
+		r = vmlaq_n_f32( r, vld1q_f32( pose + 4 ), v[1] );
+		r = vmlaq_n_f32( r, vld1q_f32( pose + 8 ), v[2] );
+
+		vst1q_f32( ov, vsetq_lane_f32( 1.0f, r, 3 ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormals
+*/
+static void R_SkeletalTransformNormals( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov )
+{
+	const float *pose;
+	float32x4_t r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		r = vmulq_n_f32( vld1q_f32( pose + 0 ), v[0] );
+		r = vmlaq_n_f32( r, vld1q_f32( pose + 4 ), v[1] );
+		r = vmlaq_n_f32( r, vld1q_f32( pose + 8 ), v[2] );
+
+		vst1q_f32( ov, vsetq_lane_f32( 0.0f, r, 3 ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormalsAndSVecs
+*/
+static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv )
+{
+	const float *pose;
+	float32x4_t c0, c1, c2, r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, sv += 4, osv += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		c0 = vld1q_f32( pose + 0 );
+		c1 = vld1q_f32( pose + 4 );
+		c2 = vld1q_f32( pose + 8 );
+
+		r = vmulq_n_f32( c0, v[0] );
+		r = vmlaq_n_f32( r, c1, v[1] );
+		r = vmlaq_n_f32( r, c2, v[2] );
+		vst1q_f32( ov, vsetq_lane_f32( 0.0f, r, 3 ) );
+
+		r = vmulq_n_f32( c0, sv[0] );
+		r = vmlaq_n_f32( r, c1, sv[1] );
+		r = vmlaq_n_f32( r, c2, sv[2] );
+		vst1q_f32( osv, vsetq_lane_f32( sv[3], r, 3 ) );
+	}
+}
+
+#else
+
 /*
 * R_SkeletalBlendPoses
 */
@@ -1145,6 +1415,8 @@ static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int
 	}
 }
 
+#endif
+
 // set the FP precision back to whatever value it was
 #if defined ( _WIN32 ) && ( _MSC_VER >= 1400 ) && defined( NDEBUG )
 # pragma float_control(pop)
@@ -1155,30 +1427,121 @@ static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int
 //=======================================================================
 
 /*
-* R_DrawSkeletalSurf
+* R_SkeletalLerpBonePoses
+*
+* Interpolates between two sets of boneposes. If applyParents is true, the boneposes
+* are relative to their parents and get concatenated into model space as well.
 */
-void R_DrawSkeletalSurf( const entity_t *e, const shader_t *shader, const mfog_t *fog, const portalSurface_t *portalSurface, unsigned int shadowBits, drawSurfaceSkeletal_t *drawSurf )
+static const bonepose_t *R_SkeletalLerpBonePoses( const mskmodel_t *skmodel, const bonepose_t *bp, const bonepose_t *oldbp, 
+	float frontlerp, bool applyParents, bonepose_t *tempbonepose )
+{
+	unsigned int i;
+	const bonepose_t *bonepose, *oldbonepose;
+	const mskbone_t *bone;
+	bonepose_t *out, tp;
+
+	if( bp == oldbp || frontlerp == 1 )
+	{
+		if( !applyParents )
+		{
+			// assume that parent transforms have already been applied
+			return bp;
+		}
+
+		for( i = 0; i < skmodel->numbones; i++ )
+		{
+			out = tempbonepose + i;
+			bonepose = bp + i;
+			bone = skmodel->bones + i;
+
+			if( bone->parent >= 0 ) {
+				DualQuat_Multiply( tempbonepose[bone->parent].dualquat, bonepose->dualquat, out->dualquat );
+			}
+			else {
+				DualQuat_Copy( bonepose->dualquat, out->dualquat );
+			}
+		}
+		return tempbonepose;
+	}
+
+	if( !applyParents )
+	{
+		// lerp, assume that parent transforms have already been applied
+		for( i = 0, out = tempbonepose, bonepose = bp, oldbonepose = oldbp; i < skmodel->numbones; i++, out++, bonepose++, oldbonepose++ )
+		{
+			DualQuat_Lerp( oldbonepose->dualquat, bonepose->dualquat, frontlerp, out->dualquat );
+		}
+		return tempbonepose;
+	}
+
+	// lerp and transform
+	for( i = 0; i < skmodel->numbones; i++ )
+	{
+		out = tempbonepose + i;
+		bonepose = bp + i;
+		oldbonepose = oldbp + i;
+		bone = skmodel->bones + i;
+
+		DualQuat_Lerp( oldbonepose->dualquat, bonepose->dualquat, frontlerp, out->dualquat );
+
+		if( bone->parent >= 0 ) {
+			DualQuat_Copy( out->dualquat, tp.dualquat );
+			DualQuat_Multiply( tempbonepose[bone->parent].dualquat, tp.dualquat, out->dualquat );
+		}
+	}
+	return tempbonepose;
+}
+
+/*
+* R_SkeletalComputeBoneTransforms
+*
+* Generates bind-pose relative dual quaternions for all bones and, if bonePoseRelativeMat
+* is not NULL, matrices for all bones and blend combinations for CPU skinning.
+*/
+static void R_SkeletalComputeBoneTransforms( const mskmodel_t *skmodel, const bonepose_t *lerpedbonepose, 
+	dualquat_t *bonePoseRelativeDQ, mat4_t *bonePoseRelativeMat )
+{
+	unsigned int i;
+
+	// generate dual quaternions for all bones
+	for( i = 0; i < skmodel->numbones; i++ ) {
+		DualQuat_Multiply( lerpedbonepose[i].dualquat, skmodel->invbaseposes[i].dualquat, bonePoseRelativeDQ[i] );
+		DualQuat_Normalize( bonePoseRelativeDQ[i] );
+	}
+
+	// CPU transforms
+	if( !bonePoseRelativeMat ) {
+		return;
+	}
+
+	// generate matrices for all bones
+	for( i = 0; i < skmodel->numbones; i++ ) {
+		Matrix4_FromDualQuaternion( bonePoseRelativeDQ[i], bonePoseRelativeMat[i] );
+	}
+
+	// generate matrices for all blend combinations
+	R_SkeletalBlendPoses( skmodel->numblends, skmodel->blends, skmodel->numbones, bonePoseRelativeMat );
+}
+
+/*
+* R_SkeletalHardwareTransform
+*/
+static bool R_SkeletalHardwareTransform( const mskmesh_t *skmesh )
+{
+	return skmesh->vbo != NULL && glConfig.maxGLSLBones > 0 ? true : false;
+}
+
+/*
+* R_SkeletalChooseBonePoses
+*
+* Picks the boneposes to lerp between, returns false for the static frame 0 of the model
+*/
+static bool R_SkeletalChooseBonePoses( const entity_t *e, const model_t *mod, const bonepose_t **pbp, const bonepose_t **poldbp )
 {
-	unsigned int i, j;
 	int framenum = e->frame;
 	int oldframenum = e->oldframe;
-	float backlerp = e->backlerp;
-	float frontlerp = 1.0 - backlerp;
-	bonepose_t tempbonepose[256];
-	const bonepose_t *bp, *oldbp, *bonepose, *oldbonepose, *lerpedbonepose;
-	bonepose_t *out, tp;
-	mskbone_t *bone;
-	mat4_t *bonePoseRelativeMat;
-	dualquat_t *bonePoseRelativeDQ;
-	size_t bonePoseRelativeMatSize, bonePoseRelativeDQSize;
-	const model_t *mod = drawSurf->model;
 	const mskmodel_t *skmodel = ( const mskmodel_t * )mod->extradata;
-	const mskmesh_t *skmesh = drawSurf->mesh;
-	bool hardwareTransform = skmesh->vbo != NULL && glConfig.maxGLSLBones > 0 ? true : false;
-	vattribmask_t vattribs;
-
-	bonePoseRelativeMat = NULL;
-	bonePoseRelativeDQ = NULL;
+	const bonepose_t *bp, *oldbp;
 
 	bp = e->boneposes;
 	oldbp = e->oldboneposes;
@@ -1217,115 +1580,205 @@ void R_DrawSkeletalSurf( const entity_t *e, const shader_t *shader, const mfog_t
 		oldbp = skmodel->frames[oldframenum].boneposes;
 	}
 
-	if( bp == oldbp && !framenum && skmesh->vbo != NULL ) {
-		// fastpath: render static frame 0 as is
-		RB_BindVBO( skmesh->vbo->index, GL_TRIANGLES );
+	*pbp = bp;
+	*poldbp = oldbp;
+	return !( bp == oldbp && !framenum );
+}
 
-		RB_DrawElements( 0, skmesh->numverts, 0, skmesh->numtris * 3, 
-			0, skmesh->numverts, 0, skmesh->numtris * 3 );
+/*
+* R_SkeletalEntityCache
+*
+* Returns the bone transforms of the entity for this frame, lerping the boneposes
+* on first use. Room for the vertices of the meshes skinned on the CPU is
+* reserved along with them.
+*/
+static skmentitycache_t *R_SkeletalEntityCache( const entity_t *e, const model_t *mod, const bonepose_t *bp, const bonepose_t *oldbp )
+{
+	unsigned int i;
+	size_t cacheSize, dqSize, matSize, meshesSize, numverts;
+	bonepose_t tempbonepose[256];
+	const bonepose_t *lerpedbonepose;
+	const mskmodel_t *skmodel = ( const mskmodel_t * )mod->extradata;
+	const mskmesh_t *skmesh;
+	skmentitycache_t *cache;
+	uint8_t *data;
 
-		return;
+	cache = ( skmentitycache_t * )R_GetSkeletalCache( R_ENT2NUM( e ), mod->lodnum );
+	if( cache ) {
+		return cache;
 	}
 
-	// see what vertex attribs backend needs
-	vattribs = RB_GetVertexAttribs();
+	numverts = 0;
+	for( i = 0, skmesh = skmodel->meshes; i < skmodel->nummeshes; i++, skmesh++ ) {
+		if( !R_SkeletalHardwareTransform( skmesh ) ) {
+			numverts += skmesh->numverts;
+		}
+	}
 
-	// cache size
-	bonePoseRelativeMatSize = sizeof( mat4_t ) * (skmodel->numbones + skmodel->numblends);
-	bonePoseRelativeDQSize = sizeof( dualquat_t ) * skmodel->numbones;
+	cacheSize = ALIGN( sizeof( skmentitycache_t ), 16 );
+	dqSize = sizeof( dualquat_t ) * skmodel->numbones;
+	matSize = numverts ? sizeof( mat4_t ) * ( skmodel->numbones + skmodel->numblends ) : 0;
+	meshesSize = ALIGN( sizeof( skmskinnedmesh_t ) * skmodel->nummeshes, 16 );
 
-	// fetch bones tranforms from cache (both matrices and dual quaternions)
-	bonePoseRelativeDQ = ( dualquat_t * )R_GetSkeletalCache( R_ENT2NUM( e ), mod->lodnum );
-	if( bonePoseRelativeDQ ) {
-		bonePoseRelativeMat = ( mat4_t * )(( uint8_t * )bonePoseRelativeDQ + bonePoseRelativeDQSize);
-	}
-	else {
-		// lerp boneposes and store results in cache
+	data = R_AllocSkeletalDataCache( R_ENT2NUM( e ), mod->lodnum, 
+		cacheSize + dqSize + matSize + meshesSize + sizeof( vec4_t ) * 3 * numverts );
 
-		lerpedbonepose = tempbonepose;
-		if( bp == oldbp || frontlerp == 1 )
-		{
-			if( e->boneposes )
-			{
-				// assume that parent transforms have already been applied
-				lerpedbonepose = bp;
-			}
-			else
-			{
-				for( i = 0; i < skmodel->numbones; i++ )
-				{
-					j = i;
-					out = tempbonepose + j;
-					bonepose = bp + j;
-					bone = skmodel->bones + j;
-
-					if( bone->parent >= 0 ) {
-						DualQuat_Multiply( tempbonepose[bone->parent].dualquat, bonepose->dualquat, out->dualquat );
-					}
-					else {
-						DualQuat_Copy( bonepose->dualquat, out->dualquat );
-					}
-				}
-			}
-		}
-		else
-		{
-			if( e->boneposes )
-			{
-				// lerp, assume that parent transforms have already been applied
-				for( i = 0, out = tempbonepose, bonepose = bp, oldbonepose = oldbp, bone = skmodel->bones; i < skmodel->numbones; i++, out++, bonepose++, oldbonepose++, bone++ )
-				{
-					DualQuat_Lerp( oldbonepose->dualquat, bonepose->dualquat, frontlerp, out->dualquat );
-				}
-			}
-			else
-			{
-				// lerp and transform
-				for( i = 0; i < skmodel->numbones; i++ )
-				{
-					j = i;
-					out = tempbonepose + j;
-					bonepose = bp + j;
-					oldbonepose = oldbp + j;
-					bone = skmodel->bones + j;
-
-					DualQuat_Lerp( oldbonepose->dualquat, bonepose->dualquat, frontlerp, out->dualquat );
-
-					if( bone->parent >= 0 ) {
-						DualQuat_Copy( out->dualquat, tp.dualquat );
-						DualQuat_Multiply( tempbonepose[bone->parent].dualquat, tp.dualquat, out->dualquat );
-					}
-				}
-			}
-		}
+	cache = ( skmentitycache_t * )data;
+	data += cacheSize;
+	cache->bonePoseRelativeDQ = ( dualquat_t * )data;
+	data += dqSize;
+	cache->bonePoseRelativeMat = matSize ? ( mat4_t * )data : NULL;
+	data += matSize;
+	cache->meshes = ( skmskinnedmesh_t * )data;
+	data += meshesSize;
 
-		bonePoseRelativeDQ = ( dualquat_t * )R_AllocSkeletalDataCache( R_ENT2NUM( e ), mod->lodnum, 
-			bonePoseRelativeDQSize + bonePoseRelativeMatSize );
+	for( i = 0, skmesh = skmodel->meshes; i < skmodel->nummeshes; i++, skmesh++ ) {
+		skmskinnedmesh_t *skinned = &cache->meshes[i];
 
-		// generate dual quaternions for all bones
-		for( i = 0; i < skmodel->numbones; i++ ) {
-			DualQuat_Multiply( lerpedbonepose[i].dualquat, skmodel->invbaseposes[i].dualquat, bonePoseRelativeDQ[i] );
-			DualQuat_Normalize( bonePoseRelativeDQ[i] );
+		skinned->vattribs = 0;
+		if( R_SkeletalHardwareTransform( skmesh ) ) {
+			skinned->xyzArray = skinned->normalsArray = skinned->sVectorsArray = NULL;
+			continue;
 		}
 
-		// CPU transforms
-		if( !hardwareTransform ) {
-			bonePoseRelativeMat = ( mat4_t * )(( uint8_t * )bonePoseRelativeDQ + bonePoseRelativeDQSize);
+		skinned->xyzArray = ( vec4_t * )data;
+		skinned->normalsArray = skinned->xyzArray + skmesh->numverts;
+		skinned->sVectorsArray = skinned->normalsArray + skmesh->numverts;
+		data += sizeof( vec4_t ) * 3 * skmesh->numverts;
+	}
 
-			// generate matrices for all bones
-			for( i = 0; i < skmodel->numbones; i++ ) {
-				Matrix4_FromDualQuaternion( bonePoseRelativeDQ[i], bonePoseRelativeMat[i] );
-			}
+	// lerp boneposes and store results in cache
+	lerpedbonepose = R_SkeletalLerpBonePoses( skmodel, bp, oldbp, 1.0 - e->backlerp, e->boneposes != NULL, tempbonepose );
+
+	R_SkeletalComputeBoneTransforms( skmodel, lerpedbonepose, cache->bonePoseRelativeDQ, cache->bonePoseRelativeMat );
+
+	return cache;
+}
+
+/*
+* R_SkeletalTransformRange
+*/
+static void R_SkeletalTransformRange( const skmtransform_t *t )
+{
+	const mskmesh_t *skmesh = t->mesh;
+	const unsigned int *blends = skmesh->vertexBlends + t->first;
+
+	R_SkeletalTransformVerts( t->numverts, blends, t->relbonepose,
+		( vec_t * )skmesh->xyzArray[t->first], ( vec_t * )t->xyzArray[t->first] );
+
+	if( t->sVectorsArray ) {
+		R_SkeletalTransformNormalsAndSVecs( t->numverts, blends, t->relbonepose,
+			( vec_t * )skmesh->normalsArray[t->first], ( vec_t * )t->normalsArray[t->first],
+			( vec_t * )skmesh->sVectorsArray[t->first], ( vec_t * )t->sVectorsArray[t->first] );
+	} else if( t->normalsArray ) {
+		R_SkeletalTransformNormals( t->numverts, blends, t->relbonepose,
+			( vec_t * )skmesh->normalsArray[t->first], ( vec_t * )t->normalsArray[t->first] );
+	}
+}
+
+/*
+* R_SkeletalTransformJob
+*/
+static void R_SkeletalTransformJob( unsigned first, unsigned items, jobarg_t *j )
+{
+	unsigned i;
 
-			// generate matrices for all blend combinations
-			R_SkeletalBlendPoses( skmodel->numblends, skmodel->blends, skmodel->numbones, bonePoseRelativeMat );
+	for( i = first; i < first + items; i++ ) {
+		R_SkeletalTransformRange( &r_skmtransforms[i] );
+	}
+}
+
+/*
+* R_SkeletalQueueMeshTransform
+*
+* Queues CPU skinning of the mesh for the job threads, the vertices are ready once
+* R_SkeletalCompleteTransforms has been called. Meshes are queued once per frame,
+* other views of the frame reuse the vertices.
+*/
+static void R_SkeletalQueueMeshTransform( skmentitycache_t *cache, const mskmesh_t *skmesh, 
+	skmskinnedmesh_t *skinned, vattribmask_t vattribs )
+{
+	unsigned int first, numverts;
+	skmtransform_t *t, local;
+
+	skinned->vattribs = VATTRIB_POSITION_BIT;
+	if( vattribs & ( VATTRIB_NORMAL_BIT|VATTRIB_SVECTOR_BIT ) ) {
+		skinned->vattribs |= VATTRIB_NORMAL_BIT;
+	}
+	if( vattribs & VATTRIB_SVECTOR_BIT ) {
+		skinned->vattribs |= VATTRIB_SVECTOR_BIT;
+	}
+
+	for( first = 0; first < skmesh->numverts; first += numverts ) {
+		numverts = min( skmesh->numverts - first, SKM_TRANSFORM_VERTS );
+
+		// out of slots, transform right away
+		t = r_numskmtransforms < SKM_MAX_TRANSFORMS ? &r_skmtransforms[r_numskmtransforms++] : &local;
+
+		t->mesh = skmesh;
+		t->first = first;
+		t->numverts = numverts;
+		t->relbonepose = cache->bonePoseRelativeMat;
+		t->xyzArray = skinned->xyzArray;
+		t->normalsArray = ( skinned->vattribs & VATTRIB_NORMAL_BIT ) ? skinned->normalsArray : NULL;
+		t->sVectorsArray = ( skinned->vattribs & VATTRIB_SVECTOR_BIT ) ? skinned->sVectorsArray : NULL;
+
+		if( t == &local ) {
+			R_SkeletalTransformRange( t );
 		}
 	}
+}
 
-	if( hardwareTransform )
+/*
+* R_SkeletalCompleteTransforms
+*
+* Skins all meshes queued so far on the job threads and waits for them. Called
+* before the draw surfaces of a view are submitted.
+*/
+void R_SkeletalCompleteTransforms( void )
+{
+	jobarg_t ja = { 0 };
+
+	if( !r_numskmtransforms ) {
+		return;
+	}
+
+	RJ_ScheduleJob( &R_SkeletalTransformJob, &ja, r_numskmtransforms );
+	RJ_CompleteJobs();
+
+	r_numskmtransforms = 0;
+}
+
+/*
+* R_DrawSkeletalSurf
+*/
+void R_DrawSkeletalSurf( const entity_t *e, const shader_t *shader, const mfog_t *fog, const portalSurface_t *portalSurface, unsigned int shadowBits, drawSurfaceSkeletal_t *drawSurf )
+{
+	const bonepose_t *bp, *oldbp;
+	const model_t *mod = drawSurf->model;
+	const mskmodel_t *skmodel = ( const mskmodel_t * )mod->extradata;
+	const mskmesh_t *skmesh = drawSurf->mesh;
+	skmentitycache_t *cache;
+	skmskinnedmesh_t *skinned;
+	vattribmask_t vattribs;
+
+	if( !R_SkeletalChooseBonePoses( e, mod, &bp, &oldbp ) && skmesh->vbo != NULL ) {
+		// fastpath: render static frame 0 as is
+		RB_BindVBO( skmesh->vbo->index, GL_TRIANGLES );
+
+		RB_DrawElements( 0, skmesh->numverts, 0, skmesh->numtris * 3, 
+			0, skmesh->numverts, 0, skmesh->numtris * 3 );
+
+		return;
+	}
+
+	// fetch bones tranforms from cache (both matrices and dual quaternions)
+	cache = R_SkeletalEntityCache( e, mod, bp, oldbp );
+
+	if( R_SkeletalHardwareTransform( skmesh ) )
 	{
 		RB_BindVBO( skmesh->vbo->index, GL_TRIANGLES );
-		RB_SetBonesData( skmodel->numbones, bonePoseRelativeDQ, skmesh->maxWeights );
+		RB_SetBonesData( skmodel->numbones, cache->bonePoseRelativeDQ, skmesh->maxWeights );
 		RB_DrawElements( 0, skmesh->numverts, 0, skmesh->numtris * 3, 
 			0, skmesh->numverts, 0, skmesh->numtris * 3 );
 	}
@@ -1333,28 +1786,28 @@ void R_DrawSkeletalSurf( const entity_t *e, const shader_t *shader, const mfog_t
 	{
 		mesh_t dynamicMesh;
 
+		// see what vertex attribs backend needs
+		vattribs = RB_GetVertexAttribs();
+		if( vattribs & VATTRIB_SVECTOR_BIT ) {
+			vattribs |= VATTRIB_NORMAL_BIT;
+		}
+		vattribs = ( vattribs & ( VATTRIB_NORMAL_BIT|VATTRIB_SVECTOR_BIT ) ) | VATTRIB_POSITION_BIT;
+
+		// skinned by the job threads unless the mesh wasn't queued with these attributes
+		skinned = &cache->meshes[skmesh - skmodel->meshes];
+		if( ( skinned->vattribs & vattribs ) != vattribs ) {
+			R_SkeletalQueueMeshTransform( cache, skmesh, skinned, vattribs );
+			R_SkeletalCompleteTransforms();
+		}
+
 		memset( &dynamicMesh, 0, sizeof( dynamicMesh ) );
 
 		dynamicMesh.elems = skmesh->elems;
 		dynamicMesh.numElems = skmesh->numtris * 3;
 		dynamicMesh.numVerts = skmesh->numverts;
-
-		R_GetTransformBufferForMesh( &dynamicMesh, true,
-			( vattribs & ( VATTRIB_NORMAL_BIT|VATTRIB_SVECTOR_BIT ) ) ? true : false,
-			( vattribs & VATTRIB_SVECTOR_BIT ) ? true : false );
-
-		R_SkeletalTransformVerts( skmesh->numverts, skmesh->vertexBlends, bonePoseRelativeMat,
-			( vec_t * )skmesh->xyzArray[0], ( vec_t * )( dynamicMesh.xyzArray ) );
-
-		if( vattribs & VATTRIB_SVECTOR_BIT ) {
-			R_SkeletalTransformNormalsAndSVecs( skmesh->numverts, skmesh->vertexBlends, bonePoseRelativeMat,
-				( vec_t * )skmesh->normalsArray[0], ( vec_t * )( dynamicMesh.normalsArray ),
-				( vec_t * )skmesh->sVectorsArray[0], ( vec_t * )( dynamicMesh.sVectorsArray ) );
-		} else if( vattribs & VATTRIB_NORMAL_BIT ) {
-			R_SkeletalTransformNormals( skmesh->numverts, skmesh->vertexBlends, bonePoseRelativeMat,
-				( vec_t * )skmesh->normalsArray[0], ( vec_t * )( dynamicMesh.normalsArray ) );
-		}
-
+		dynamicMesh.xyzArray = skinned->xyzArray;
+		dynamicMesh.normalsArray = ( vattribs & VATTRIB_NORMAL_BIT ) ? skinned->normalsArray : NULL;
+		dynamicMesh.sVectorsArray = ( vattribs & VATTRIB_SVECTOR_BIT ) ? skinned->sVectorsArray : NULL;
 		dynamicMesh.stArray = skmesh->stArray;
 
 		RB_AddDynamicMesh( e, shader, fog, portalSurface, shadowBits, &dynamicMesh, GL_TRIANGLES, 0.0f, 0.0f );
@@ -1468,6 +1921,9 @@ bool R_AddSkeletalModelToDrawList( const entity_t *e )
 	float radius;
 	float distance;
 	int clipped;
+	bool animated;
+	const bonepose_t *bp, *oldbp;
+	skmentitycache_t *cache;
 
 	mod = R_SkeletalModelLOD( e );
 	if( !( skmodel = ( ( mskmodel_t * )mod->extradata ) ) || !skmodel->nummeshes )
@@ -1506,6 +1962,9 @@ bool R_AddSkeletalModelToDrawList( const entity_t *e )
 	}
 #endif
 
+	animated = R_SkeletalChooseBonePoses( e, mod, &bp, &oldbp );
+	cache = NULL;
+
 	for( i = 0, mesh = skmodel->meshes; i < (int)skmodel->nummeshes; i++, mesh++ )
 	{
 		shader = NULL;
@@ -1517,10 +1976,151 @@ bool R_AddSkeletalModelToDrawList( const entity_t *e )
 			shader = mesh->skin.shader;
 		}
 
-		if( shader ) {
-			R_AddSurfToDrawList( rn.meshlist, e, fog, shader, distance, 0, NULL, skmodel->drawSurfs + i );
+		if( !shader ) {
+			continue;
+		}
+
+		// start CPU skinning on the job threads, it's done before the surfaces are drawn
+		if( ( animated || !mesh->vbo ) && !R_SkeletalHardwareTransform( mesh ) ) {
+			if( !cache ) {
+				cache = R_SkeletalEntityCache( e, mod, bp, oldbp );
+			}
+			if( !cache->meshes[i].vattribs ) {
+				R_SkeletalQueueMeshTransform( cache, mesh, &cache->meshes[i], 
+					shader->vattribs | ( e->outlineHeight ? VATTRIB_NORMAL_BIT : 0 ) );
+			}
 		}
+
+		R_AddSurfToDrawList( rn.meshlist, e, fog, shader, distance, 0, NULL, skmodel->drawSurfs + i );
 	}
 
 	return true;
 }
+
+/*
+* R_SkeletalBenchmark_f
+*
+* skmbenchmark <model> [numents] [frames]
+*
+* Runs the CPU skinning path of R_DrawSkeletalSurf for a number of fake
+* entities, bypassing the skeletal cache and the backend. Skinning is timed
+* both on the calling thread and the way it is done when drawing, with the
+* meshes of all entities queued and skinned by the job threads at once. The
+* model is registered through the renderer, so this needs a running GL context.
+*/
+void R_SkeletalBenchmark_f( void )
+{
+	int ent, numents, frame, numframes;
+	unsigned int i;
+	uint64_t numverts;
+	model_t *mod;
+	const mskmodel_t *skmodel;
+	const mskmesh_t *skmesh;
+	const bonepose_t *bp, *oldbp, *lerpedbonepose;
+	bonepose_t *tempbonepose;
+	dualquat_t *bonePoseRelativeDQ;
+	mat4_t *bonePoseRelativeMat;
+	vec4_t *verts;
+	skmentitycache_t *caches;
+	skmskinnedmesh_t *skinned;
+	uint64_t t, posetime, skintime, jobtime;
+
+	if( ri.Cmd_Argc() < 2 ) {
+		Com_Printf( "Usage: %s <model> [numents] [frames]\n", ri.Cmd_Argv( 0 ) );
+		return;
+	}
+
+	mod = R_RegisterModel( ri.Cmd_Argv( 1 ) );
+	if( !mod || mod->type != mod_skeletal ) {
+		Com_Printf( "%s is not a skeletal model\n", ri.Cmd_Argv( 1 ) );
+		return;
+	}
+
+	skmodel = ( const mskmodel_t * )mod->extradata;
+	numents = ri.Cmd_Argc() > 2 ? max( atoi( ri.Cmd_Argv( 2 ) ), 1 ) : 64;
+	numframes = ri.Cmd_Argc() > 3 ? max( atoi( ri.Cmd_Argv( 3 ) ), 1 ) : 100;
+
+	// every entity gets its own transforms and vertices, like in the skeletal cache
+	tempbonepose = R_Malloc( sizeof( bonepose_t ) * skmodel->numbones );
+	bonePoseRelativeDQ = R_Malloc( sizeof( dualquat_t ) * skmodel->numbones );
+	bonePoseRelativeMat = R_Malloc( sizeof( mat4_t ) * ( skmodel->numbones + skmodel->numblends ) * numents );
+	verts = R_Malloc( sizeof( vec4_t ) * 3 * skmodel->numverts * numents );
+	caches = R_Malloc( ( sizeof( skmentitycache_t ) + sizeof( skmskinnedmesh_t ) * skmodel->nummeshes ) * numents );
+
+	for( ent = 0; ent < numents; ent++ ) {
+		vec4_t *entverts = verts + 3 * skmodel->numverts * ent;
+
+		caches[ent].bonePoseRelativeDQ = bonePoseRelativeDQ;
+		caches[ent].bonePoseRelativeMat = bonePoseRelativeMat + ( skmodel->numbones + skmodel->numblends ) * ent;
+		caches[ent].meshes = ( skmskinnedmesh_t * )( caches + numents ) + skmodel->nummeshes * ent;
+
+		for( i = 0, skmesh = skmodel->meshes; i < skmodel->nummeshes; i++, skmesh++ ) {
+			skinned = &caches[ent].meshes[i];
+			skinned->xyzArray = entverts;
+			skinned->normalsArray = skinned->xyzArray + skmesh->numverts;
+			skinned->sVectorsArray = skinned->normalsArray + skmesh->numverts;
+			entverts += 3 * skmesh->numverts;
+		}
+	}
+
+	posetime = skintime = jobtime = 0;
+	numverts = 0;
+
+	// the job threads are shared with the frontend, make sure it's done with them
+	RF_Finish();
+
+	for( frame = 0; frame < numframes; frame++ ) {
+		for( ent = 0; ent < numents; ent++ ) {
+			// spread entities over the animation so they don't all hit the same frame
+			bp = skmodel->frames[(frame + ent + 1) % skmodel->numframes].boneposes;
+			oldbp = skmodel->frames[(frame + ent) % skmodel->numframes].boneposes;
+
+			t = ri.Sys_Microseconds();
+			lerpedbonepose = R_SkeletalLerpBonePoses( skmodel, bp, oldbp, 0.5f, true, tempbonepose );
+			R_SkeletalComputeBoneTransforms( skmodel, lerpedbonepose, bonePoseRelativeDQ, caches[ent].bonePoseRelativeMat );
+			posetime += ri.Sys_Microseconds() - t;
+
+			t = ri.Sys_Microseconds();
+			for( i = 0, skmesh = skmodel->meshes; i < skmodel->nummeshes; i++, skmesh++ ) {
+				skinned = &caches[ent].meshes[i];
+				R_SkeletalTransformVerts( skmesh->numverts, skmesh->vertexBlends, caches[ent].bonePoseRelativeMat,
+					( vec_t * )skmesh->xyzArray[0], ( vec_t * )skinned->xyzArray );
+				R_SkeletalTransformNormalsAndSVecs( skmesh->numverts, skmesh->vertexBlends, caches[ent].bonePoseRelativeMat,
+					( vec_t * )skmesh->normalsArray[0], ( vec_t * )skinned->normalsArray,
+					( vec_t * )skmesh->sVectorsArray[0], ( vec_t * )skinned->sVectorsArray );
+				numverts += skmesh->numverts;
+			}
+			skintime += ri.Sys_Microseconds() - t;
+		}
+
+		// the whole frame at once, the way the entities are drawn
+		t = ri.Sys_Microseconds();
+		for( ent = 0; ent < numents; ent++ ) {
+			for( i = 0, skmesh = skmodel->meshes; i < skmodel->nummeshes; i++, skmesh++ ) {
+				R_SkeletalQueueMeshTransform( &caches[ent], skmesh, &caches[ent].meshes[i], 
+					VATTRIB_NORMAL_BIT|VATTRIB_SVECTOR_BIT );
+			}
+		}
+		R_SkeletalCompleteTransforms();
+		jobtime += ri.Sys_Microseconds() - t;
+	}
+
+	R_Free( caches );
+	R_Free( verts );
+	R_Free( bonePoseRelativeMat );
+	R_Free( bonePoseRelativeDQ );
+	R_Free( tempbonepose );
+
+	Com_Printf( "%s: %i bones, %i blends, %i verts, %i entities x %i frames\n", mod->name,
+		skmodel->numbones, skmodel->numblends, skmodel->numverts, numents, numframes );
+	Com_Printf( "poses: %8.3f ms/frame\n", posetime / 1000.0 / numframes );
+	Com_Printf( "skinning: %8.3f ms/frame, %.1f Mverts/s\n", skintime / 1000.0 / numframes,
+		skintime ? (double)numverts / skintime : 0.0 );
+	Com_Printf( "skinning with jobs: %8.3f ms/frame, %.1f Mverts/s (%i threads)\n", 
+		jobtime / 1000.0 / numframes, jobtime ? (double)numverts / jobtime : 0.0, NUM_JOB_THREADS );
+#if defined( HAVE_SSE2 )
+	Com_Printf( "using SSE2 code path\n" );
+#elif defined( HAVE_NEON )
+	Com_Printf( "using NEON code path\n" );
+#endif
+}
@@ -6,6 +6,7 @@ cvar_t *in_grabinconsole;
 cvar_t *in_disablemacosxmouseaccel;
 cvar_t *in_mousehack;
 
+extern cvar_t *vid_fullscreen;
 extern cvar_t *vid_xpos;
 extern cvar_t *vid_ypos;
 
@@ -517,7 +518,7 @@ void IN_Frame()
 	if( !input_inited )
 		return;
 
-	if( !input_focus || ( !Cvar_Value( "vid_fullscreen" ) && cls.key_dest == key_console && !in_grabinconsole->integer ) ) {
+	if( !input_focus || ( !vid_fullscreen->integer && cls.key_dest == key_console && !in_grabinconsole->integer ) ) {
 		if( mouse_active ) {
 			if( mouse_relative ) {
 				mouse_relative = !(SDL_SetRelativeMouseMode( SDL_FALSE ) == 0);
@@ -30,6 +30,10 @@
 
 #define USERINFO_UPDATE_COOLDOWN_MSEC	2000
 
+//#define WORLDFRAMETIME 25 // 40fps
+//#define WORLDFRAMETIME 20 // 50fps
+#define WORLDFRAMETIME 16 // 62.5fps
+
 typedef enum
 {
 	ss_dead,        // no map loaded
@@ -112,8 +116,21 @@ typedef struct
 	int size;               // total bytes (can't use EOF because of paks)
 	unsigned int timeout;   // so we can free the file being downloaded
 	                        // if client omits sending success or failure message
+	bool windowed;          // client acknowledges blocks with dlack instead of requesting them
+	dlwindow_sender_t window;
 } client_download_t;
 
+typedef struct
+{
+	int id;                 // gamestate being sent, 0 if none
+	int numpending;
+	int nextchunk;          // lowest chunk that may be pending
+	int nextcs;             // next modified configstring to send
+	int credit;             // bytes we are allowed to send right now
+	unsigned int lasttime;
+	uint8_t pending[( GAMESTATE_MAX_CHUNKS + 7 ) / 8];
+} client_gamestate_t;
+
 typedef struct
 {
 	unsigned int framenum;
@@ -177,6 +194,7 @@ typedef struct client_s
 	client_snapshot_t snapShots[UPDATE_BACKUP]; // updates can be delta'd from here
 
 	client_download_t download;
+	client_gamestate_t gamestate;   // see sv_gamestate.c
 
 	int challenge;                  // challenge of this user, randomly generated
 
@@ -217,6 +235,7 @@ typedef struct
 typedef struct
 {
 	int file;
+	snap_demowriter_t *writer;      // writes the messages on a separate thread
 	char *filename;
 	char *tempname;
 	time_t localtime;
@@ -293,6 +312,17 @@ typedef struct
 	char *motd;
 
 	void *wakelock;
+
+	struct
+	{
+		int spawncount;
+		int id;
+		size_t size;                    // compressed
+		size_t rawsize;
+		uint8_t *data;
+		int nummodified;                // configstrings changed since it was built
+		uint8_t modified[MAX_CONFIGSTRINGS/8];
+	} gamestate;                        // see sv_gamestate.c
 } server_static_t;
 
 typedef struct
@@ -462,6 +492,7 @@ typedef struct
 
 void SV_FlushRedirect( int sv_redirected, const char *outputbuf, const void *extra );
 void SV_SendClientMessages( void );
+int SV_ClientDownloadRate( const client_t *client );
 
 void SV_Multicast( vec3_t origin, multicast_t to );
 void SV_BroadcastCommand( const char *format, ... );
@@ -478,6 +509,40 @@ void SV_ExecuteClientThinks( int clientNum );
 void SV_ClientResetCommandBuffers( client_t *client );
 void SV_ClientCloseDownload( client_t *client );
 
+//
+// sv_gamestate.c
+//
+void SV_FreeGamestate( void );
+void SV_GamestateConfigstringChanged( int index );
+void SV_StartGamestate( client_t *client );
+void SV_ResendGamestate( client_t *client, int offset, int id, const char *mask );
+void SV_SendClientGamestate( client_t *client );
+void SV_GamestateInfo_f( void );
+
+//
+// sv_bench.c
+//
+typedef enum
+{
+	SV_BENCH_USERCMDS,		// parsing of simulated client messages
+	SV_BENCH_GAME,			// ge->RunFrame, AI included
+	SV_BENCH_SNAPFRAME,		// ge->SnapFrame
+	SV_BENCH_SNAPBUILD,
+	SV_BENCH_SNAPENCODE,
+	SV_BENCH_NETCHAN,
+	SV_BENCH_DEMO,
+
+	SV_BENCH_NUM_TIMERS
+} sv_benchtimer_t;
+
+uint64_t SV_Bench_Time( void );
+uint64_t SV_Bench_Add( sv_benchtimer_t timer, uint64_t start );
+void SV_Bench_RecordUsercmd( client_t *client, const usercmd_t *ucmd );
+void SV_Bench_Shutdown( void );
+void SV_Benchmark_f( void );
+void SV_BenchRecord_f( void );
+void SV_BenchRecordStop_f( void );
+
 //
 // sv_mv.c
 //
@@ -565,3 +630,8 @@ const char *SV_Web_UpstreamBaseUrl( void );
 bool SV_Web_AddGameClient( const char *session, int clientNum, const netadr_t *netAdr );
 void SV_Web_RemoveGameClient( const char *session );
 void SV_Web_GameFrame( http_game_query_cb cb );
+
+//
+// sv_webload.c
+//
+void SV_WebLoad_f( void );
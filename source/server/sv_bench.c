@@ -0,0 +1,624 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// sv_bench.c -- headless server benchmark and usercmd recording
+
+#include "server.h"
+
+/*
+
+"benchmark <map> [frames] [bots] [clients] [seed] [json] [usercmds]" loads a map, adds bots
+through g_numbots and connects simulated clients. Simulated clients have no-transmit netchans,
+so snapshots are built, encoded and passed through the netchan just like for real clients.
+Every frame each of them hands a move message to SV_ParseClientMessage, acknowledging the last
+snapshot and all reliable commands. Moves are replayed from a file written by "benchrecord"
+or generated from the seed. Frames are run back to back with a fixed frame time, so results
+depend only on the map, the arguments and the binaries, which makes it usable in CI.
+
+*/
+
+#define BENCH_UCMDS_MAGIC		"WSWUCMD1"
+#define BENCH_UCMDS_MAGIC_LEN	8
+#define BENCH_WARMUP_FRAMES		50		// bots spawn and clients join in these, not measured
+#define BENCH_DEFAULT_FRAMES	1000
+
+typedef struct
+{
+	client_t *client;
+	unsigned int ucmdNum;
+	int ucmdIndex;				// into the recorded usercmds
+	int seed;					// for scripted usercmds
+	int nextChange;				// frame when a scripted client changes its direction
+	int yawSpeed;
+	usercmd_t cmd;
+} sv_benchclient_t;
+
+static struct
+{
+	bool running;
+	uint64_t times[SV_BENCH_NUM_TIMERS];
+
+	usercmd_t *ucmds;
+	int numUcmds;
+
+	int numClients;
+	sv_benchclient_t clients[MAX_CLIENTS];
+
+	int recordFile;
+	client_t *recordClient;
+	char recordSession[HTTP_CLIENT_SESSION_SIZE];
+	usercmd_t recordLast;
+} sv_bench;
+
+static const char *sv_benchtimer_names[SV_BENCH_NUM_TIMERS] =
+{
+	"usercmds", "game", "snapframe", "snapshot_build", "snapshot_encode", "netchan", "demo"
+};
+
+/*
+* SV_Bench_Time
+*/
+uint64_t SV_Bench_Time( void )
+{
+	return sv_bench.running ? Sys_Microseconds() : 0;
+}
+
+/*
+* SV_Bench_Add
+*
+* Adds the time passed since start to the timer and returns the current time
+*/
+uint64_t SV_Bench_Add( sv_benchtimer_t timer, uint64_t start )
+{
+	uint64_t now;
+
+	if( !sv_bench.running )
+		return 0;
+
+	now = Sys_Microseconds();
+	sv_bench.times[timer] += now - start;
+	return now;
+}
+
+/*
+* SV_Bench_StopRecording
+*/
+static void SV_Bench_StopRecording( void )
+{
+	if( !sv_bench.recordFile )
+		return;
+
+	FS_FCloseFile( sv_bench.recordFile );
+	sv_bench.recordFile = 0;
+	sv_bench.recordClient = NULL;
+	Com_Printf( "Stopped recording usercmds\n" );
+}
+
+/*
+* SV_BenchRecordStop_f
+*/
+void SV_BenchRecordStop_f( void )
+{
+	if( !sv_bench.recordFile )
+	{
+		Com_Printf( "Not recording usercmds\n" );
+		return;
+	}
+
+	SV_Bench_StopRecording();
+}
+
+/*
+* SV_BenchRecord_f
+*/
+void SV_BenchRecord_f( void )
+{
+	int playernum;
+	client_t *client;
+	char filename[MAX_QPATH];
+
+	if( Cmd_Argc() != 3 )
+	{
+		Com_Printf( "Usage: benchrecord <player number> <filename>\n" );
+		return;
+	}
+
+	if( sv.state != ss_game )
+	{
+		Com_Printf( "No map running\n" );
+		return;
+	}
+
+	if( sv_bench.recordFile )
+	{
+		Com_Printf( "Already recording usercmds\n" );
+		return;
+	}
+
+	playernum = atoi( Cmd_Argv( 1 ) );
+	if( playernum < 0 || playernum >= sv_maxclients->integer )
+	{
+		Com_Printf( "Bad player number\n" );
+		return;
+	}
+
+	client = svs.clients + playernum;
+	if( client->state < CS_SPAWNED || ( client->edict->r.svflags & SVF_FAKECLIENT ) )
+	{
+		Com_Printf( "Player %i is not an active client\n", playernum );
+		return;
+	}
+
+	Q_strncpyz( filename, Cmd_Argv( 2 ), sizeof( filename ) );
+	COM_SanitizeFilePath( filename );
+	if( !COM_ValidateRelativeFilename( filename ) )
+	{
+		Com_Printf( "Invalid filename\n" );
+		return;
+	}
+
+	if( FS_FOpenFile( filename, &sv_bench.recordFile, FS_WRITE ) == -1 )
+	{
+		Com_Printf( "Couldn't open %s for writing\n", filename );
+		sv_bench.recordFile = 0;
+		return;
+	}
+
+	FS_Write( BENCH_UCMDS_MAGIC, BENCH_UCMDS_MAGIC_LEN, sv_bench.recordFile );
+
+	sv_bench.recordClient = client;
+	Q_strncpyz( sv_bench.recordSession, client->session, sizeof( sv_bench.recordSession ) );
+	memset( &sv_bench.recordLast, 0, sizeof( sv_bench.recordLast ) );
+
+	Com_Printf( "Recording usercmds of %s to %s\n", client->name, filename );
+}
+
+/*
+* SV_Bench_RecordUsercmd
+*
+* Usercmds are stored delta compressed, in the same way as they are sent by clients
+*/
+void SV_Bench_RecordUsercmd( client_t *client, const usercmd_t *ucmd )
+{
+	msg_t msg;
+	uint8_t data[32];
+	usercmd_t cmd;
+
+	if( client != sv_bench.recordClient )
+		return;
+
+	// the slot has been taken by someone else
+	if( strcmp( client->session, sv_bench.recordSession ) )
+	{
+		SV_Bench_StopRecording();
+		return;
+	}
+
+	cmd = *ucmd;
+	MSG_Init( &msg, data, sizeof( data ) );
+	MSG_WriteDeltaUsercmd( &msg, &sv_bench.recordLast, &cmd );
+	FS_Write( msg.data, msg.cursize, sv_bench.recordFile );
+	sv_bench.recordLast = cmd;
+}
+
+/*
+* SV_Bench_LoadUsercmds
+*/
+static bool SV_Bench_LoadUsercmds( const char *filename )
+{
+	uint8_t *buffer;
+	int length, maxcmds;
+	msg_t msg;
+	usercmd_t last;
+
+	length = FS_LoadFile( filename, (void **)&buffer, NULL, 0 );
+	if( !buffer )
+	{
+		Com_Printf( "Couldn't load %s\n", filename );
+		return false;
+	}
+
+	if( length < BENCH_UCMDS_MAGIC_LEN || memcmp( buffer, BENCH_UCMDS_MAGIC, BENCH_UCMDS_MAGIC_LEN ) )
+	{
+		Com_Printf( "%s is not a usercmds recording\n", filename );
+		FS_FreeFile( buffer );
+		return false;
+	}
+
+	// the smallest delta is a byte of flags and a long of timestamp
+	maxcmds = ( length - BENCH_UCMDS_MAGIC_LEN ) / 5 + 1;
+	sv_bench.ucmds = Mem_Alloc( sv_mempool, maxcmds * sizeof( usercmd_t ) );
+	sv_bench.numUcmds = 0;
+
+	MSG_Init( &msg, buffer + BENCH_UCMDS_MAGIC_LEN, length - BENCH_UCMDS_MAGIC_LEN );
+	msg.cursize = length - BENCH_UCMDS_MAGIC_LEN;
+
+	memset( &last, 0, sizeof( last ) );
+	while( msg.readcount < msg.cursize && sv_bench.numUcmds < maxcmds )
+	{
+		MSG_ReadDeltaUsercmd( &msg, &last, &sv_bench.ucmds[sv_bench.numUcmds] );
+		if( msg.readcount > msg.cursize )
+			break;
+		last = sv_bench.ucmds[sv_bench.numUcmds++];
+	}
+
+	FS_FreeFile( buffer );
+
+	if( !sv_bench.numUcmds )
+	{
+		Com_Printf( "%s has no usercmds\n", filename );
+		Mem_Free( sv_bench.ucmds );
+		sv_bench.ucmds = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* SV_Bench_NextUsercmd
+*/
+static void SV_Bench_NextUsercmd( sv_benchclient_t *bc, int frame )
+{
+	if( sv_bench.numUcmds )
+	{
+		bc->cmd = sv_bench.ucmds[bc->ucmdIndex];
+		bc->ucmdIndex = ( bc->ucmdIndex + 1 ) % sv_bench.numUcmds;
+		return;
+	}
+
+	// a scripted client runs around in a random direction, turning, jumping and shooting
+	if( frame >= bc->nextChange )
+	{
+		bc->cmd.forwardmove = (float)( Q_rand( &bc->seed ) % 3 - 1 );
+		bc->cmd.sidemove = (float)( Q_rand( &bc->seed ) % 3 - 1 );
+		bc->yawSpeed = ( Q_rand( &bc->seed ) % 11 - 5 ) * 64;
+		bc->nextChange = frame + 15 + Q_rand( &bc->seed ) % 45;
+	}
+
+	bc->cmd.angles[YAW] = (short)( bc->cmd.angles[YAW] + bc->yawSpeed );
+	bc->cmd.upmove = ( Q_rand( &bc->seed ) % 40 ) ? 0 : 1;
+	bc->cmd.buttons = ( Q_rand( &bc->seed ) % 4 ) ? 0 : BUTTON_ATTACK;
+}
+
+/*
+* SV_Bench_SendMove
+*
+* Does what a client on a perfect connection would do each frame
+*/
+static void SV_Bench_SendMove( sv_benchclient_t *bc, int frame )
+{
+	client_t *client = bc->client;
+	usercmd_t nullcmd;
+	uint8_t data[64];
+	msg_t msg;
+
+	if( client->state != CS_SPAWNED )
+		return;
+
+	SV_Bench_NextUsercmd( bc, frame );
+	bc->cmd.serverTimeStamp = svs.gametime;
+
+	MSG_Init( &msg, data, sizeof( data ) );
+	MSG_WriteByte( &msg, clc_svcack );
+	MSG_WriteLong( &msg, client->reliableSent );
+	MSG_WriteByte( &msg, clc_move );
+	MSG_WriteLong( &msg, client->lastSentFrameNum );
+	MSG_WriteLong( &msg, ++bc->ucmdNum );
+	MSG_WriteByte( &msg, 1 );
+	memset( &nullcmd, 0, sizeof( nullcmd ) );
+	MSG_WriteDeltaUsercmd( &msg, &nullcmd, &bc->cmd );
+
+	client->lastPacketReceivedTime = svs.realtime;
+	SV_ParseClientMessage( client, &msg );
+}
+
+/*
+* SV_Bench_ConnectClient
+*/
+static client_t *SV_Bench_ConnectClient( int num )
+{
+	int i;
+	client_t *client;
+	const socket_t *socket;
+	netadr_t address;
+	char userinfo[MAX_INFO_STRING];
+
+	for( i = 0, client = svs.clients; i < sv_maxclients->integer; i++, client++ )
+	{
+		if( client->state == CS_FREE )
+			break;
+	}
+	if( i == sv_maxclients->integer )
+		return NULL;
+
+	// nothing is sent to a no-transmit address, but the netchan still wants an open socket
+	if( svs.socket_udp.open )
+		socket = &svs.socket_udp;
+	else if( svs.socket_udp6.open )
+		socket = &svs.socket_udp6;
+	else if( svs.socket_loopback.open )
+		socket = &svs.socket_loopback;
+	else
+		return NULL;
+
+	userinfo[0] = '\0';
+	Info_SetValueForKey( userinfo, "name", va( "bench%i", num ) );
+	Info_SetValueForKey( userinfo, "socket", NET_SocketTypeToString( socket->type ) );
+	Info_SetValueForKey( userinfo, "ip", "127.0.0.1" );
+
+	NET_InitAddress( &address, NA_NOTRANSMIT );
+	if( !SV_ClientConnect( socket, &address, client, userinfo, -1, 0, false, false, 0, 0 ) )
+		return NULL;
+
+	client->state = CS_SPAWNED;
+	ge->ClientBegin( client->edict );
+
+	// join the game like a player would
+	Cmd_TokenizeString( "join" );
+	ge->ClientCommand( client->edict );
+
+	return client;
+}
+
+/*
+* SV_Bench_Shutdown
+*/
+void SV_Bench_Shutdown( void )
+{
+	int i;
+
+	SV_Bench_StopRecording();
+
+	if( sv_bench.running )
+	{
+		for( i = 0; i < sv_bench.numClients; i++ )
+		{
+			if( sv_bench.clients[i].client->state > CS_ZOMBIE )
+				SV_DropClient( sv_bench.clients[i].client, DROP_TYPE_GENERAL, NULL );
+		}
+	}
+
+	if( sv_bench.ucmds )
+		Mem_Free( sv_bench.ucmds );
+	sv_bench.ucmds = NULL;
+	sv_bench.numUcmds = 0;
+	sv_bench.numClients = 0;
+	sv_bench.running = false;
+}
+
+/*
+* SV_Bench_WriteTimer
+*/
+static void SV_Bench_WriteTimer( int file, const char *name, uint64_t total, int frames, bool last )
+{
+	FS_Printf( file, "\t\t\"%s\": { \"total_us\": %llu, \"avg_us\": %.2f }%s\n",
+		name, (unsigned long long)total, (double)total / frames, last ? "" : "," );
+}
+
+/*
+* SV_Bench_RestoreCvars
+*/
+static void SV_Bench_RestoreCvars( const char *oldnumbots, const char *oldthinkbudget )
+{
+	Cvar_ForceSet( "g_numbots", oldnumbots );
+	Cvar_ForceSet( "ai_thinkBudget", oldthinkbudget );
+}
+
+/*
+* SV_Bench_JsonString
+*/
+static const char *SV_Bench_JsonString( const char *in, char *out, size_t size )
+{
+	size_t len = 0;
+
+	for( ; *in && len + 7 < size; in++ )
+	{
+		if( *in == '"' || *in == '\\' )
+		{
+			out[len++] = '\\';
+			out[len++] = *in;
+		}
+		else if( ( unsigned char )*in < ' ' )
+		{
+			Q_snprintfz( out + len, size - len, "\\u%04x", ( unsigned char )*in );
+			len += 6;
+		}
+		else
+		{
+			out[len++] = *in;
+		}
+	}
+	out[len] = '\0';
+	return out;
+}
+
+/*
+* SV_Benchmark_f
+*/
+void SV_Benchmark_f( void )
+{
+	int i, frame, frames, bots, clients, seed, file;
+	int snapshots;
+	uint64_t time, frameTime, maxFrameTime, wallTime, aiTime;
+	char map[MAX_QPATH], jsonname[MAX_QPATH], jsonmap[MAX_QPATH*6];
+	char oldnumbots[16], oldthinkbudget[16];
+	const char *ucmdsname;
+	cvar_t *g_numbots, *ai_thinkBudget;
+
+	if( Cmd_Argc() < 2 )
+	{
+		Com_Printf( "Usage: benchmark <map> [frames] [bots] [clients] [seed] [json file|-] [usercmds file]\n" );
+		return;
+	}
+
+	if( sv_bench.running )
+	{
+		Com_Printf( "Already running a benchmark\n" );
+		return;
+	}
+
+	Q_strncpyz( map, Cmd_Argv( 1 ), sizeof( map ) );
+	frames = Cmd_Argc() > 2 ? atoi( Cmd_Argv( 2 ) ) : BENCH_DEFAULT_FRAMES;
+	bots = Cmd_Argc() > 3 ? atoi( Cmd_Argv( 3 ) ) : 0;
+	clients = Cmd_Argc() > 4 ? atoi( Cmd_Argv( 4 ) ) : 0;
+	seed = Cmd_Argc() > 5 ? atoi( Cmd_Argv( 5 ) ) : 1;
+	Q_strncpyz( jsonname, Cmd_Argc() > 6 ? Cmd_Argv( 6 ) : "-", sizeof( jsonname ) );
+	ucmdsname = Cmd_Argc() > 7 ? Cmd_Argv( 7 ) : NULL;
+
+	if( frames < 1 || bots < 0 || clients < 0 || bots + clients > sv_maxclients->integer )
+	{
+		Com_Printf( "Bad arguments, bots and clients must fit in sv_maxclients (%i)\n", sv_maxclients->integer );
+		return;
+	}
+
+	if( ucmdsname && !SV_Bench_LoadUsercmds( ucmdsname ) )
+		return;
+
+	// bots are added by the game module itself
+	g_numbots = Cvar_Get( "g_numbots", "0", 0 );
+	Q_strncpyz( oldnumbots, g_numbots->string, sizeof( oldnumbots ) );
+	Cvar_ForceSet( "g_numbots", va( "%i", bots ) );
+
+	// bots must think every frame, or the AI time depends on how the think budget
+	// spreads them over frames rather than on how expensive they are
+	ai_thinkBudget = Cvar_Get( "ai_thinkBudget", "2000", CVAR_ARCHIVE );
+	Q_strncpyz( oldthinkbudget, ai_thinkBudget->string, sizeof( oldthinkbudget ) );
+	Cvar_ForceSet( "ai_thinkBudget", "0" );
+
+	Cbuf_ExecuteText( EXEC_NOW, va( "map \"%s\"\n", map ) );
+	if( sv.state != ss_game )
+	{
+		Com_Printf( "Couldn't start map %s\n", map );
+		SV_Bench_RestoreCvars( oldnumbots, oldthinkbudget );
+		SV_Bench_Shutdown();
+		return;
+	}
+
+	srand( seed );
+
+	memset( sv_bench.clients, 0, sizeof( sv_bench.clients ) );
+	for( i = 0; i < clients; i++ )
+	{
+		sv_benchclient_t *bc = &sv_bench.clients[sv_bench.numClients];
+
+		bc->client = SV_Bench_ConnectClient( i );
+		if( !bc->client )
+		{
+			Com_Printf( "Couldn't connect a simulated client\n" );
+			break;
+		}
+		bc->ucmdNum = 1;
+		bc->seed = seed + i;
+		bc->ucmdIndex = sv_bench.numUcmds ? ( i * sv_bench.numUcmds / clients ) : 0;
+		sv_bench.numClients++;
+	}
+
+	Com_Printf( "Benchmarking %s: %i frames, %i bots, %i clients, seed %i, %s usercmds\n",
+		sv.mapname, frames, bots, sv_bench.numClients, seed, sv_bench.numUcmds ? "recorded" : "scripted" );
+
+	sv_bench.running = true;
+	maxFrameTime = wallTime = aiTime = 0;
+	snapshots = 0;
+
+	for( frame = -BENCH_WARMUP_FRAMES; frame < frames && sv_bench.running; frame++ )
+	{
+		if( !frame )
+		{
+			memset( sv_bench.times, 0, sizeof( sv_bench.times ) );
+			snapshots = sv.framenum;
+			aiTime = ge->AIMicroseconds();
+			wallTime = Sys_Microseconds();
+
+			// measure demo writing too, once players are in
+			if( !svs.demo.file )
+				Cbuf_ExecuteText( EXEC_NOW, "serverrecord benchmark\n" );
+		}
+
+		time = Sys_Microseconds();
+		for( i = 0; i < sv_bench.numClients; i++ )
+			SV_Bench_SendMove( &sv_bench.clients[i], frame );
+		SV_Bench_Add( SV_BENCH_USERCMDS, time );
+
+		SV_Frame( WORLDFRAMETIME, WORLDFRAMETIME );
+
+		frameTime = Sys_Microseconds() - time;
+		if( frame >= 0 && frameTime > maxFrameTime )
+			maxFrameTime = frameTime;
+	}
+
+	if( !sv_bench.running || sv.state != ss_game )
+	{
+		Com_Printf( "The benchmark has been interrupted\n" );
+		SV_Bench_RestoreCvars( oldnumbots, oldthinkbudget );
+		SV_Bench_Shutdown();
+		return;
+	}
+
+	wallTime = Sys_Microseconds() - wallTime;
+	aiTime = ge->AIMicroseconds() - aiTime;
+	snapshots = sv.framenum - snapshots;
+
+	// don't keep the demo, it's only there to be timed
+	if( svs.demo.file )
+		Cbuf_ExecuteText( EXEC_NOW, "serverrecordcancel\n" );
+
+	Com_Printf( "%i frames, %i snapshots in %.3f sec, %.1f frames per second\n",
+		frames, snapshots, wallTime / 1000000.0, frames * 1000000.0 / max( wallTime, 1 ) );
+	Com_Printf( "frame:           %8.1f us average, %8u us max\n", (double)wallTime / frames, (unsigned)maxFrameTime );
+	Com_Printf( "ai:              %8.1f us average\n", (double)aiTime / frames );
+	for( i = 0; i < SV_BENCH_NUM_TIMERS; i++ )
+		Com_Printf( "%-16s %8.1f us average\n", va( "%s:", sv_benchtimer_names[i] ), (double)sv_bench.times[i] / frames );
+
+	if( strcmp( jsonname, "-" ) )
+	{
+		COM_DefaultExtension( jsonname, ".json", sizeof( jsonname ) );
+		if( FS_FOpenFile( jsonname, &file, FS_WRITE ) == -1 )
+		{
+			Com_Printf( "Couldn't open %s for writing\n", jsonname );
+		}
+		else
+		{
+			FS_Printf( file, "{\n" );
+			FS_Printf( file, "\t\"map\": \"%s\",\n", SV_Bench_JsonString( sv.mapname, jsonmap, sizeof( jsonmap ) ) );
+			FS_Printf( file, "\t\"frames\": %i,\n", frames );
+			FS_Printf( file, "\t\"frametime_ms\": %i,\n", WORLDFRAMETIME );
+			FS_Printf( file, "\t\"bots\": %i,\n", bots );
+			FS_Printf( file, "\t\"clients\": %i,\n", sv_bench.numClients );
+			FS_Printf( file, "\t\"seed\": %i,\n", seed );
+			FS_Printf( file, "\t\"usercmds\": \"%s\",\n", sv_bench.numUcmds ? "recorded" : "scripted" );
+			FS_Printf( file, "\t\"snapshots\": %i,\n", snapshots );
+			FS_Printf( file, "\t\"timings\": {\n" );
+			FS_Printf( file, "\t\t\"frame\": { \"total_us\": %llu, \"avg_us\": %.2f, \"max_us\": %u },\n",
+				(unsigned long long)wallTime, (double)wallTime / frames, (unsigned)maxFrameTime );
+			SV_Bench_WriteTimer( file, "ai", aiTime, frames, false );
+			for( i = 0; i < SV_BENCH_NUM_TIMERS; i++ )
+				SV_Bench_WriteTimer( file, sv_benchtimer_names[i], sv_bench.times[i], frames, i == SV_BENCH_NUM_TIMERS - 1 );
+			FS_Printf( file, "\t}\n" );
+			FS_Printf( file, "}\n" );
+			FS_FCloseFile( file );
+
+			Com_Printf( "Wrote %s\n", jsonname );
+		}
+	}
+
+	SV_Bench_RestoreCvars( oldnumbots, oldthinkbudget );
+	SV_Bench_Shutdown();
+}
@@ -435,6 +435,14 @@ void SV_InitOperatorCommands( void )
 
 	Cmd_AddCommand( "cvarcheck", SV_CvarCheck_f );
 
+	Cmd_AddCommand( "gamestateinfo", SV_GamestateInfo_f );
+
+	Cmd_AddCommand( "benchmark", SV_Benchmark_f );
+	Cmd_AddCommand( "benchrecord", SV_BenchRecord_f );
+	Cmd_AddCommand( "benchrecordstop", SV_BenchRecordStop_f );
+
+	Cmd_AddCommand( "webload", SV_WebLoad_f );
+
 	Cmd_SetCompletionFunc( "map", SV_MapComplete_f );
 	Cmd_SetCompletionFunc( "devmap", SV_MapComplete_f );
 	Cmd_SetCompletionFunc( "gamemap", SV_MapComplete_f );
@@ -469,4 +477,12 @@ void SV_ShutdownOperatorCommands( void )
 	}
 
 	Cmd_RemoveCommand( "cvarcheck" );
+
+	Cmd_RemoveCommand( "gamestateinfo" );
+
+	Cmd_RemoveCommand( "benchmark" );
+	Cmd_RemoveCommand( "benchrecord" );
+	Cmd_RemoveCommand( "benchrecordstop" );
+
+	Cmd_RemoveCommand( "webload" );
 }
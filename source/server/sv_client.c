@@ -327,6 +327,7 @@ static void SV_New_f( client_t *client )
 			sv_bitflags |= SV_BITFLAGS_PURE;
 		if( client->reliable )
 			sv_bitflags |= SV_BITFLAGS_RELIABLE;
+		sv_bitflags |= SV_BITFLAGS_GAMESTATE;
 		if( SV_Web_Running() )
 		{
 			const char *baseurl = SV_Web_UpstreamBaseUrl();
@@ -361,6 +362,7 @@ static void SV_New_f( client_t *client )
 	}
 
 	SV_ClientResetCommandBuffers( client );
+	memset( &client->gamestate, 0, sizeof( client->gamestate ) );
 
 	SV_SendMessageToClient( client, &tmpMessage );
 	Netchan_PushAllFragments( &client->netchan );
@@ -422,6 +424,42 @@ static void SV_Configstrings_f( client_t *client )
 		SV_SendServerCommand( client, "cmd configstrings %i %i", svs.spawncount, start );
 }
 
+/*
+* SV_Gamestate_f
+*
+* Sends configstrings and baselines in one go, see sv_gamestate.c
+*/
+static void SV_Gamestate_f( client_t *client )
+{
+	if( client->state == CS_CONNECTING )
+	{
+		Com_DPrintf( "Start Gamestate() from %s\n", client->name );
+		client->state = CS_CONNECTED;
+	}
+	else
+		Com_DPrintf( "Gamestate() from %s\n", client->name );
+
+	if( client->state != CS_CONNECTED )
+	{
+		Com_Printf( "gamestate not valid -- already spawned\n" );
+		return;
+	}
+
+	// handle the case of a level changing while a client was connecting
+	if( atoi( Cmd_Argv( 1 ) ) != svs.spawncount )
+	{
+		Com_Printf( "SV_Gamestate_f from different level\n" );
+		SV_SendServerCommand( client, "reconnect" );
+		return;
+	}
+
+	// a retry names the gamestate it's filling and the chunks it's missing
+	if( Cmd_Argc() > 4 )
+		SV_ResendGamestate( client, atoi( Cmd_Argv( 2 ) ), atoi( Cmd_Argv( 3 ) ), Cmd_Argv( 4 ) );
+	else
+		SV_StartGamestate( client );
+}
+
 /*
 * SV_Baselines_f
 */
@@ -512,6 +550,27 @@ static void SV_Begin_f( client_t *client )
 //=============================================================================
 
 
+/*
+* SV_OpenClientDownload
+*/
+static bool SV_OpenClientDownload( client_t *client )
+{
+	if( client->download.file )
+		return true;
+
+	Com_Printf( "Starting server upload of %s to %s\n", client->download.name, client->name );
+
+	client->download.size = FS_FOpenBaseFile( client->download.name, &client->download.file, FS_READ );
+	if( !client->download.file || client->download.size < 0 )
+	{
+		Com_Printf( "Error opening %s for uploading\n", client->download.name );
+		SV_ClientCloseDownload( client );
+		return false;
+	}
+
+	return true;
+}
+
 /*
 * SV_NextDownload_f
 * 
@@ -558,24 +617,13 @@ static void SV_NextDownload_f( client_t *client )
 		return;
 	}
 
-	if( !client->download.file )
-	{
-		Com_Printf( "Starting server upload of %s to %s\n", client->download.name, client->name );
-
-		client->download.size = FS_FOpenBaseFile( client->download.name, &client->download.file, FS_READ );
-		if( !client->download.file || client->download.size < 0 )
-		{
-			Com_Printf( "Error opening %s for uploading\n", client->download.name );
-			SV_ClientCloseDownload( client );
-			return;
-		}
-	}
+	if( !SV_OpenClientDownload( client ) )
+		return;
 
 	SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
 	SV_AddReliableCommandsToMessage( client, &tmpMessage );
 
 	blocksize = client->download.size - offset;
-	// jalfixme: adapt download to user rate setting and sv_maxrate setting.
 	if( blocksize > sizeof( data ) )
 		blocksize = sizeof( data );
 	if( offset + blocksize > client->download.size )
@@ -600,6 +648,41 @@ static void SV_NextDownload_f( client_t *client )
 	client->download.timeout = svs.realtime + 10000;
 }
 
+/*
+* SV_DownloadAck_f
+* 
+* Windowed downloads: the client acknowledges the blocks it has received,
+* the first one also tells us where to start. Blocks are then sent from
+* SV_SendClientDownload, paced to the client's rate.
+*/
+static void SV_DownloadAck_f( client_t *client )
+{
+	if( !client->download.name || !client->download.windowed )
+	{
+		Com_Printf( "dlack message for client with no windowed download active, from: %s\n", client->name );
+		return;
+	}
+
+	if( Q_stricmp( client->download.name, Cmd_Argv( 1 ) ) )
+	{
+		Com_Printf( "dlack message for wrong filename, from: %s\n", client->name );
+		return;
+	}
+
+	if( !client->download.file )
+	{
+		if( !SV_OpenClientDownload( client ) )
+			return;
+		DLWindow_InitSender( &client->download.window, client->download.size,
+			SV_ClientDownloadRate( client ), svs.realtime );
+	}
+
+	DLWindow_Ack( &client->download.window, atoi( Cmd_Argv( 2 ) ), strtoul( Cmd_Argv( 3 ), NULL, 10 ),
+		SV_ClientDownloadRate( client ), svs.realtime );
+
+	client->download.timeout = svs.realtime + 10000;
+}
+
 /*
 * SV_GameAllowDownload
 * Asks game function whether to allow downloading of a file
@@ -750,6 +833,9 @@ static void SV_BeginDownload_f( client_t *client )
 	if( client->download.name )
 		SV_ClientCloseDownload( client );
 
+	// newer clients ask for the windowed transfer
+	client->download.windowed = atoi( Cmd_Argv( 3 ) ) != 0;
+
 	client->download.size = FS_LoadBaseFile( uploadname, NULL, NULL, 0 );
 	if( client->download.size == -1 )
 	{
@@ -807,8 +893,8 @@ local_download:
 
 	// start the download
 	SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
-	SV_SendServerCommand( client, "initdownload \"%s\" %i %u %i \"%s\"", client->download.name,
-		client->download.size, checksum, local_http ? 1 : 0, ( url ? url : "" ) );
+	SV_SendServerCommand( client, "initdownload \"%s\" %i %u %i \"%s\" %i", client->download.name,
+		client->download.size, checksum, local_http ? 1 : 0, ( url ? url : "" ), client->download.windowed ? 1 : 0 );
 	SV_AddReliableCommandsToMessage( client, &tmpMessage );
 	SV_SendMessageToClient( client, &tmpMessage );
 
@@ -932,6 +1018,7 @@ ucmd_t ucmds[] =
 	{ "new", SV_New_f },
 	{ "configstrings", SV_Configstrings_f },
 	{ "baselines", SV_Baselines_f },
+	{ "gamestate", SV_Gamestate_f },
 	{ "begin", SV_Begin_f },
 	{ "disconnect", SV_Disconnect_f },
 	{ "usri", SV_UserinfoCommand_f },
@@ -945,6 +1032,7 @@ ucmd_t ucmds[] =
 
 	{ "download", SV_BeginDownload_f },
 	{ "nextdl", SV_NextDownload_f },
+	{ "dlack", SV_DownloadAck_f },
 
 	// server demo downloads
 	{ "demolist", SV_DemoList_f },
@@ -1051,6 +1139,8 @@ void SV_ExecuteClientThinks( int clientNum )
 		if( client->lastframe > 0 )
 			timeDelta = -(int)( svs.gametime - ucmd->serverTimeStamp );
 
+		SV_Bench_RecordUsercmd( client, ucmd );
+
 		ge->ClientThink( client->edict, ucmd, timeDelta );
 
 		client->UcmdTime = ucmd->serverTimeStamp;
@@ -25,15 +25,15 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 /*
 * SV_Demo_WriteMessage
 * 
-* Writes given message to the demofile
+* Queues given message to be written to the demofile
 */
-static void SV_Demo_WriteMessage( msg_t *msg )
+static bool SV_Demo_WriteMessage( msg_t *msg )
 {
 	assert( svs.demo.file );
 	if( !svs.demo.file )
-		return;
+		return false;
 
-	SNAP_RecordDemoMessage( svs.demo.file, msg, 0 );
+	return SNAP_WriteDemoMessage( svs.demo.writer, msg, 0 );
 }
 
 /*
@@ -81,7 +81,13 @@ void SV_Demo_WriteSnap( void )
 
 	SV_AddReliableCommandsToMessage( &svs.demo.client, &msg );
 
-	SV_Demo_WriteMessage( &msg );
+	if( !SV_Demo_WriteMessage( &msg ) )
+	{
+		// don't hold the server frame waiting for the disk
+		Com_Printf( "Error: Failed to write the server demo, stopping recording\n" );
+		SV_Demo_Stop_f();
+		return;
+	}
 
 	svs.demo.duration = svs.gametime - svs.demo.basetime;
 	svs.demo.client.lastframe = sv.framenum; // FIXME: is this needed?
@@ -194,6 +200,8 @@ void SV_Demo_Start_f( void )
 	svs.demo.localtime = time( NULL );
 	SV_Demo_WriteStartMessages();
 
+	svs.demo.writer = SNAP_CreateDemoWriter( svs.demo.file );
+
 	// write one nodelta frame
 	svs.demo.client.nodelta = true;
 	SV_Demo_WriteSnap();
@@ -213,6 +221,13 @@ static void SV_Demo_Stop( bool cancel, bool silent )
 		return;
 	}
 
+	// flush the queued messages, an incomplete demo is not worth keeping
+	if( !SNAP_DestroyDemoWriter( &svs.demo.writer ) && !cancel )
+	{
+		Com_Printf( "Error: Server demo recording is incomplete, discarding it\n" );
+		cancel = true;
+	}
+
 	if( cancel )
 	{
 		Com_Printf( "Canceled server demo recording: %s\n", svs.demo.filename );
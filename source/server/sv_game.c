@@ -259,6 +259,7 @@ static void PF_ConfigString( int index, const char *val )
 
 	// change the string in sv
 	Q_strncpyz( sv.configstrings[index], val, sizeof( sv.configstrings[index] ) );
+	SV_GamestateConfigstringChanged( index );
 
 	if( sv.state != ss_loading )
 		SV_SendServerCommand( NULL, "cs %i \"%s\"", index, val );
@@ -483,6 +484,10 @@ void SV_InitGameProgs( void )
 	import.CM_LeafArea = PF_CM_LeafArea;
 
 	import.Milliseconds = Sys_Milliseconds;
+	import.Microseconds = Sys_Microseconds;
+
+	import.Prof_Begin = Prof_Begin;
+	import.Prof_End = Prof_End;
 
 	import.ModelIndex = SV_ModelIndex;
 	import.SoundIndex = SV_SoundIndex;
@@ -0,0 +1,403 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// sv_gamestate.c -- configstrings and baselines sent to connecting clients in bulk
+
+#include "server.h"
+#include "../qcommon/compression.h"
+
+/*
+
+Clients which see SV_BITFLAGS_GAMESTATE in serverdata ask for "gamestate <spawncount> <offset>"
+instead of going through the configstrings/baselines round trips. The gamestate is
+a zlib compressed list of [short] index [string] configstring pairs terminated by -1,
+followed by svc_spawnbaseline entries terminated by svc_bad.
+
+It's built once per map and shared by all clients. Configstrings changed afterwards
+reach the clients which are already connecting as regular "cs" commands, and are
+sent the same way to the ones which start loading the gamestate later, so the blob
+and its id stay the same while anyone is downloading it. It's only rebuilt when
+nobody is.
+
+The gamestate goes in GAMESTATE_CHUNK_SIZE pieces, paced by the client's rate from
+SV_SendClientMessages. Clients ask for the chunks they are missing with
+"gamestate <spawncount> <offset> <id> <mask>", where bit n of the hex mask stands
+for the n-th chunk after offset, and only those are sent again.
+
+*/
+
+static int sv_gamestate_id;
+
+/*
+* SV_FreeGamestate
+*/
+void SV_FreeGamestate( void )
+{
+	if( svs.gamestate.data )
+		Mem_Free( svs.gamestate.data );
+	memset( &svs.gamestate, 0, sizeof( svs.gamestate ) );
+}
+
+/*
+* SV_GamestateConfigstringChanged
+*
+* Called when a configstring changes after the gamestate may have been built
+*/
+void SV_GamestateConfigstringChanged( int index )
+{
+	if( !svs.gamestate.data || index < 0 || index >= MAX_CONFIGSTRINGS )
+		return;
+	if( svs.gamestate.modified[index>>3] & ( 1<<( index&7 ) ) )
+		return;
+
+	svs.gamestate.modified[index>>3] |= 1<<( index&7 );
+	svs.gamestate.nummodified++;
+}
+
+/*
+* SV_GamestateInTransfer
+*/
+static bool SV_GamestateInTransfer( void )
+{
+	int i;
+	client_t *client;
+
+	for( i = 0, client = svs.clients; i < sv_maxclients->integer; i++, client++ )
+	{
+		if( client->state == CS_CONNECTED && client->gamestate.id && client->gamestate.id == svs.gamestate.id )
+			return true;
+	}
+	return false;
+}
+
+/*
+* SV_WriteGamestate
+*/
+static void SV_WriteGamestate( msg_t *msg )
+{
+	int i;
+	entity_state_t nullstate, *base;
+
+	for( i = 0; i < MAX_CONFIGSTRINGS; i++ )
+	{
+		if( !sv.configstrings[i][0] )
+			continue;
+		MSG_WriteShort( msg, i );
+		MSG_WriteString( msg, sv.configstrings[i] );
+	}
+	MSG_WriteShort( msg, -1 );
+
+	memset( &nullstate, 0, sizeof( nullstate ) );
+
+	for( i = 0; i < MAX_EDICTS; i++ )
+	{
+		base = &sv.baselines[i];
+		if( base->modelindex || base->sound || base->effects )
+		{
+			MSG_WriteByte( msg, svc_spawnbaseline );
+			MSG_WriteDeltaEntity( &nullstate, base, msg, true, true );
+		}
+	}
+	MSG_WriteByte( msg, svc_bad );
+}
+
+/*
+* SV_BuildGamestate
+*/
+static bool SV_BuildGamestate( void )
+{
+	msg_t msg;
+	uint8_t *raw;
+	size_t rawmax;
+	uLongf size;
+	int zerror;
+
+	if( svs.gamestate.data && svs.gamestate.spawncount == svs.spawncount )
+	{
+		// changed configstrings are cheaper to send as commands than restarting someone's download
+		if( !svs.gamestate.nummodified || SV_GamestateInTransfer() )
+			return true;
+	}
+
+	SV_FreeGamestate();
+
+	rawmax = GAMESTATE_MAX_SIZE;
+	raw = Mem_TempMalloc( rawmax );
+
+	MSG_Init( &msg, raw, rawmax );
+	SV_WriteGamestate( &msg );
+
+	size = msg.cursize + msg.cursize / 100 + 64;
+	svs.gamestate.data = Mem_Alloc( sv_mempool, size );
+
+	zerror = qzcompress2( svs.gamestate.data, &size, raw, msg.cursize, Z_BEST_COMPRESSION );
+	Mem_TempFree( raw );
+
+	if( zerror != Z_OK )
+	{
+		Com_Printf( "SV_BuildGamestate: compression error %i\n", zerror );
+		SV_FreeGamestate();
+		return false;
+	}
+
+	svs.gamestate.spawncount = svs.spawncount;
+	svs.gamestate.id = ++sv_gamestate_id;	// lets clients tell rebuilt gamestates apart
+	svs.gamestate.size = size;
+	svs.gamestate.rawsize = msg.cursize;
+	return true;
+}
+
+/*
+* SV_WriteGamestateChunk
+*/
+static void SV_WriteGamestateChunk( msg_t *msg, int offset, int length )
+{
+	MSG_WriteByte( msg, svc_extension );
+	MSG_WriteByte( msg, SVC_EXT_GAMESTATE );
+	MSG_WriteByte( msg, 1 );	// version
+	MSG_WriteShort( msg, 20 + length );
+	MSG_WriteLong( msg, svs.spawncount );
+	MSG_WriteLong( msg, svs.gamestate.id );
+	MSG_WriteLong( msg, (int)svs.gamestate.size );
+	MSG_WriteLong( msg, (int)svs.gamestate.rawsize );
+	MSG_WriteLong( msg, offset );
+	if( length )
+		MSG_CopyData( msg, svs.gamestate.data + offset, length );
+}
+
+/*
+* SV_MarkGamestateChunk
+*/
+static void SV_MarkGamestateChunk( client_gamestate_t *gs, int chunk )
+{
+	if( gs->pending[chunk>>3] & ( 1<<( chunk&7 ) ) )
+		return;
+
+	gs->pending[chunk>>3] |= 1<<( chunk&7 );
+	gs->numpending++;
+	if( chunk < gs->nextchunk )
+		gs->nextchunk = chunk;
+}
+
+/*
+* SV_StartGamestate
+*
+* Queues the whole gamestate and the configstrings which changed since it was built.
+* If the gamestate couldn't be built, an empty one tells the client to fall back
+* to configstrings and baselines.
+*/
+void SV_StartGamestate( client_t *client )
+{
+	int i, numchunks;
+	client_gamestate_t *gs = &client->gamestate;
+
+	memset( gs, 0, sizeof( *gs ) );
+
+	if( !SV_BuildGamestate() )
+	{
+		SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
+		SV_WriteGamestateChunk( &tmpMessage, 0, 0 );
+		SV_SendMessageToClient( client, &tmpMessage );
+		return;
+	}
+
+	numchunks = ( svs.gamestate.size + GAMESTATE_CHUNK_SIZE - 1 ) / GAMESTATE_CHUNK_SIZE;
+
+	gs->id = svs.gamestate.id;
+	gs->nextchunk = numchunks;
+	for( i = 0; i < numchunks; i++ )
+		SV_MarkGamestateChunk( gs, i );
+	gs->nextcs = svs.gamestate.nummodified ? 0 : MAX_CONFIGSTRINGS;
+	gs->credit = max( SV_ClientDownloadRate( client ) / 10, GAMESTATE_CHUNK_SIZE );
+	gs->lasttime = svs.realtime;
+}
+
+/*
+* SV_ResendGamestate
+*
+* Queues the chunks the client reported missing. Chunks past the end of the mask
+* are assumed missing as well.
+*/
+void SV_ResendGamestate( client_t *client, int offset, int id, const char *mask )
+{
+	int i, len, chunk, first, numchunks, bits;
+	client_gamestate_t *gs = &client->gamestate;
+
+	// the gamestate went away or got rebuilt under the client, start over
+	if( !svs.gamestate.data || !gs->id || gs->id != svs.gamestate.id || id != svs.gamestate.id )
+	{
+		SV_StartGamestate( client );
+		return;
+	}
+
+	numchunks = ( svs.gamestate.size + GAMESTATE_CHUNK_SIZE - 1 ) / GAMESTATE_CHUNK_SIZE;
+	first = max( offset, 0 ) / GAMESTATE_CHUNK_SIZE;
+
+	len = strlen( mask );
+
+	for( chunk = first; chunk < numchunks; chunk++ )
+	{
+		i = ( chunk - first ) >> 2;
+		if( i >= len )
+			bits = 15;
+		else if( mask[i] >= '0' && mask[i] <= '9' )
+			bits = mask[i] - '0';
+		else if( mask[i] >= 'a' && mask[i] <= 'f' )
+			bits = mask[i] - 'a' + 10;
+		else
+			bits = 15;
+
+		if( bits & ( 1<<( ( chunk - first ) & 3 ) ) )
+			SV_MarkGamestateChunk( gs, chunk );
+	}
+}
+
+/*
+* SV_SendClientGamestate
+*
+* Sends the configstrings changed since the gamestate was built as long as there's
+* room for reliable commands, then as many pending chunks as the client's rate allows,
+* one unfragmented packet per chunk
+*/
+void SV_SendClientGamestate( client_t *client )
+{
+	int length, offset, numchunks, maxcredit;
+	client_gamestate_t *gs = &client->gamestate;
+
+	if( !gs->id || client->state != CS_CONNECTED )
+		return;
+	if( gs->id != svs.gamestate.id || !svs.gamestate.data )
+	{
+		gs->id = 0;
+		return;
+	}
+
+	for( ; gs->nextcs < MAX_CONFIGSTRINGS; gs->nextcs++ )
+	{
+		if( !( svs.gamestate.modified[gs->nextcs>>3] & ( 1<<( gs->nextcs&7 ) ) ) )
+			continue;
+		if( client->reliableSequence - client->reliableAcknowledge >= MAX_RELIABLE_COMMANDS - 8 )
+			break;
+		SV_SendServerCommand( client, "cs %i \"%s\"", gs->nextcs, sv.configstrings[gs->nextcs] );
+	}
+
+	maxcredit = max( SV_ClientDownloadRate( client ) / 10, GAMESTATE_CHUNK_SIZE );
+	gs->credit += SV_ClientDownloadRate( client ) * (int)( svs.realtime - gs->lasttime ) / 1000;
+	if( gs->credit > maxcredit )
+		gs->credit = maxcredit;
+	gs->lasttime = svs.realtime;
+
+	numchunks = ( svs.gamestate.size + GAMESTATE_CHUNK_SIZE - 1 ) / GAMESTATE_CHUNK_SIZE;
+
+	while( gs->numpending && gs->credit > 0 && !client->netchan.unsentFragments )
+	{
+		while( gs->nextchunk < numchunks && !( gs->pending[gs->nextchunk>>3] & ( 1<<( gs->nextchunk&7 ) ) ) )
+			gs->nextchunk++;
+		if( gs->nextchunk >= numchunks )
+		{
+			gs->numpending = 0;
+			break;
+		}
+
+		offset = gs->nextchunk * GAMESTATE_CHUNK_SIZE;
+		length = min( (int)svs.gamestate.size - offset, GAMESTATE_CHUNK_SIZE );
+
+		SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
+		SV_WriteGamestateChunk( &tmpMessage, offset, length );
+		if( !SV_SendMessageToClient( client, &tmpMessage ) )
+			return;
+
+		gs->pending[gs->nextchunk>>3] &= ~( 1<<( gs->nextchunk&7 ) );
+		gs->numpending--;
+		gs->credit -= tmpMessage.cursize;
+	}
+}
+
+/*
+* SV_GamestateInfo_f
+*
+* Compares the connect time of the bulk gamestate with the legacy configstrings
+* and baselines round trips for the current map, given a round trip time
+*/
+void SV_GamestateInfo_f( void )
+{
+	int i, rtt, count, legacy, chunks;
+	unsigned int time;
+	entity_state_t nullstate, *base;
+	msg_t msg;
+	uint8_t *raw;
+	size_t rawmax, legacybytes;
+
+	if( sv.state != ss_game )
+	{
+		Com_Printf( "No map running\n" );
+		return;
+	}
+
+	rtt = Cmd_Argc() > 1 ? max( atoi( Cmd_Argv( 1 ) ), 0 ) : 100;
+
+	time = Sys_Milliseconds();
+	if( !SV_BuildGamestate() )
+		return;
+	time = Sys_Milliseconds() - time;
+
+	// configstrings go MAX_RELIABLE_COMMANDS - 9 per round trip, like SV_Configstrings_f
+	legacybytes = 0;
+	for( i = 0, count = 0; i < MAX_CONFIGSTRINGS; i++ )
+	{
+		if( !sv.configstrings[i][0] )
+			continue;
+		legacybytes += strlen( sv.configstrings[i] ) + 10;
+		count++;
+	}
+	legacy = max( ( count + MAX_RELIABLE_COMMANDS - 10 ) / ( MAX_RELIABLE_COMMANDS - 9 ), 1 );
+
+	// baselines go FRAGMENT_SIZE * 3 bytes per round trip, like SV_Baselines_f
+	rawmax = MAX_EDICTS * ( sizeof( entity_state_t ) + 32 );
+	raw = Mem_TempMalloc( rawmax );
+	MSG_Init( &msg, raw, rawmax );
+	memset( &nullstate, 0, sizeof( nullstate ) );
+
+	legacy++;
+	for( i = 0, count = 0; i < MAX_EDICTS; i++ )
+	{
+		base = &sv.baselines[i];
+		if( !( base->modelindex || base->sound || base->effects ) )
+			continue;
+
+		if( msg.cursize - count >= FRAGMENT_SIZE * 3 )
+		{
+			legacy++;
+			count = msg.cursize;
+		}
+		MSG_WriteByte( &msg, svc_spawnbaseline );
+		MSG_WriteDeltaEntity( &nullstate, base, &msg, true, true );
+	}
+	legacybytes += msg.cursize;
+	Mem_TempFree( raw );
+
+	chunks = ( svs.gamestate.size + GAMESTATE_CHUNK_SIZE - 1 ) / GAMESTATE_CHUNK_SIZE;
+
+	Com_Printf( "gamestate: %i bytes, %i compressed, %i chunks, built in %u msec\n",
+		(int)svs.gamestate.rawsize, (int)svs.gamestate.size, chunks, time );
+	Com_Printf( "legacy:    %i bytes in %i round trips, %i msec at %i msec rtt\n",
+		(int)legacybytes, legacy, legacy * rtt, rtt );
+	Com_Printf( "bulk:      1 round trip, %i msec at %i msec rtt\n", rtt, rtt );
+}
@@ -52,6 +52,7 @@ static int SV_FindIndex( const char *name, int start, int max, bool create )
 		Com_Error( ERR_DROP, "*Index: overflow" );
 
 	Q_strncpyz( sv.configstrings[start+i], name, sizeof( sv.configstrings[i] ) );
+	SV_GamestateConfigstringChanged( start+i );
 
 	// send the update to everyone
 	if( sv.state != ss_loading )
@@ -251,6 +252,7 @@ static void SV_SpawnServer( const char *server, bool devmap )
 	Com_Printf( "SpawnServer: %s\n", server );
 
 	svs.spawncount++;   // any partially connected client will be restarted
+	SV_FreeGamestate();
 
 	Com_SetServerState( ss_dead );
 
@@ -518,8 +520,12 @@ void SV_ShutdownGame( const char *finalmsg, bool reconnect )
 	if( svs.clients )
 		SV_FinalMessage( finalmsg, reconnect );
 
+	SV_Bench_Shutdown();
+
 	SV_ShutdownGameProgs();
 
+	SV_FreeGamestate();
+
 	// SV_MM_Shutdown();
 
 	SV_MasterSendQuit();
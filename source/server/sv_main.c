@@ -467,9 +467,6 @@ static void SV_CheckLatchedUserinfoChanges( void )
 	}
 }
 
-//#define WORLDFRAMETIME 25 // 40fps
-//#define WORLDFRAMETIME 20 // 50fps
-#define WORLDFRAMETIME 16 // 62.5fps
 /*
 * SV_RunGameFrame
 */
@@ -479,6 +476,7 @@ static bool SV_RunGameFrame( int msec )
 	bool refreshSnapshot;
 	bool refreshGameModule;
 	bool sentFragments;
+	uint64_t benchtime;
 
 	accTime += msec;
 
@@ -549,7 +547,11 @@ static bool SV_RunGameFrame( int msec )
 		if( host_speeds->integer )
 			time_before_game = Sys_Milliseconds();
 
+		benchtime = SV_Bench_Time();
+		Prof_Begin( "game" );
 		ge->RunFrame( moduleTime, svs.gametime );
+		Prof_End();
+		SV_Bench_Add( SV_BENCH_GAME, benchtime );
 
 		if( host_speeds->integer )
 			time_after_game = Sys_Milliseconds();
@@ -562,7 +564,11 @@ static bool SV_RunGameFrame( int msec )
 
 		// set up for sending a snapshot
 		sv.framenum++;
+		benchtime = SV_Bench_Time();
+		Prof_Begin( "game_snapframe" );
 		ge->SnapFrame();
+		Prof_End();
+		SV_Bench_Add( SV_BENCH_SNAPFRAME, benchtime );
 
 		// set time for next snapshot
 		extraSnapTime = (int)( svs.gametime - sv.nextSnapTime );
@@ -726,6 +732,7 @@ static void SV_CheckPostUpdateRestart( void )
 static void SV_CheckMatchUUID_Callback( const char *uuid )
 {
 	Q_strncpyz( sv.configstrings[CS_MATCHUUID], uuid, sizeof( sv.configstrings[0] ) );
+	SV_GamestateConfigstringChanged( CS_MATCHUUID );
 }
 
 /*
@@ -749,6 +756,7 @@ static void SV_CheckMatchUUID( void )
 void SV_Frame( int realmsec, int gamemsec )
 {
 	const unsigned int wrappingPoint = 0x70000000;
+	uint64_t benchtime;
 
 	time_before_game = time_after_game = 0;
 
@@ -774,7 +782,9 @@ void SV_Frame( int realmsec, int gamemsec )
 	SV_CheckTimeouts();
 
 	// get packets from clients
+	Prof_Begin( "sv_readpackets" );
 	SV_ReadPackets();
+	Prof_End();
 
 	// apply latched userinfo changes
 	SV_CheckLatchedUserinfoChanges();
@@ -783,10 +793,16 @@ void SV_Frame( int realmsec, int gamemsec )
 	if( SV_RunGameFrame( gamemsec ) )
 	{
 		// send messages back to the clients that had packets read this frame
+		Prof_Begin( "sv_sendmessages" );
 		SV_SendClientMessages();
+		Prof_End();
 
 		// write snap to server demo file
+		benchtime = SV_Bench_Time();
+		Prof_Begin( "sv_demo" );
 		SV_Demo_WriteSnap();
+		Prof_End();
+		SV_Bench_Add( SV_BENCH_DEMO, benchtime );
 
 		// run matchmaker stuff
 		SV_CheckMatchUUID();
@@ -801,7 +817,9 @@ void SV_Frame( int realmsec, int gamemsec )
 	}
 
 	// handle HTTP connections
+	Prof_Begin( "sv_webqueries" );
 	SV_Web_GameFrame( ge->WebRequest );
+	Prof_End();
 
 	SV_CheckAutoUpdate();
 
@@ -405,6 +405,9 @@ void SV_BuildClientFrameSnap( client_t *client )
 */
 static bool SV_SendClientDatagram( client_t *client )
 {
+	bool result;
+	uint64_t benchtime;
+
 	if( client->edict && ( client->edict->r.svflags & SVF_FAKECLIENT ) )
 		return true;
 
@@ -414,11 +417,72 @@ static bool SV_SendClientDatagram( client_t *client )
 
 	// send over all the relevant entity_state_t
 	// and the player_state_t
+	benchtime = SV_Bench_Time();
+	Prof_Begin( "snap_build" );
 	SV_BuildClientFrameSnap( client );
+	Prof_End();
+	benchtime = SV_Bench_Add( SV_BENCH_SNAPBUILD, benchtime );
 
+	Prof_Begin( "snap_encode" );
 	SV_WriteFrameSnapToClient( client, &tmpMessage );
+	Prof_End();
+	benchtime = SV_Bench_Add( SV_BENCH_SNAPENCODE, benchtime );
+
+	Prof_Begin( "netchan" );
+	result = SV_SendMessageToClient( client, &tmpMessage );
+	Prof_End();
+	SV_Bench_Add( SV_BENCH_NETCHAN, benchtime );
+	return result;
+}
+
+/*
+* SV_ClientDownloadRate
+*/
+int SV_ClientDownloadRate( const client_t *client )
+{
+	int rate = client->rate > 0 ? client->rate : 99999;
+
+	if( sv_maxrate->integer > 0 && rate > sv_maxrate->integer )
+		rate = sv_maxrate->integer;
+	return rate;
+}
+
+/*
+* SV_SendClientDownload
+* 
+* Sends as many blocks of a windowed download as the client's rate allows,
+* one unfragmented packet per block
+*/
+static void SV_SendClientDownload( client_t *client )
+{
+	int block, offset, length;
+	uint8_t data[DLWINDOW_BLOCKSIZE];
+
+	if( !client->download.windowed || !client->download.file )
+		return;
+
+	while( ( block = DLWindow_NextBlock( &client->download.window, SV_ClientDownloadRate( client ), svs.realtime ) ) >= 0 )
+	{
+		offset = block * DLWINDOW_BLOCKSIZE;
+		length = DLWindow_BlockLength( client->download.size, block );
+
+		FS_Seek( client->download.file, offset, FS_SEEK_SET );
+		if( FS_Read( data, length, client->download.file ) != length )
+		{
+			Com_Printf( "Error reading %s for uploading\n", client->download.name );
+			SV_ClientCloseDownload( client );
+			return;
+		}
 
-	return SV_SendMessageToClient( client, &tmpMessage );
+		SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
+		MSG_WriteByte( &tmpMessage, svc_download );
+		MSG_WriteString( &tmpMessage, client->download.name );
+		MSG_WriteLong( &tmpMessage, offset );
+		MSG_WriteLong( &tmpMessage, length );
+		MSG_CopyData( &tmpMessage, data, length );
+		if( !SV_SendMessageToClient( client, &tmpMessage ) )
+			return;
+	}
 }
 
 /*
@@ -474,5 +538,8 @@ void SV_SendClientMessages( void )
 				}
 			}
 		}
+
+		SV_SendClientGamestate( client );
+		SV_SendClientDownload( client );
 	}
 }
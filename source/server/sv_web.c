@@ -24,7 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #ifdef HTTP_SUPPORT
 
-#define MAX_INCOMING_HTTP_CONNECTIONS			48
+#define MAX_INCOMING_HTTP_CONNECTIONS			1024
 #define MAX_INCOMING_HTTP_CONNECTIONS_PER_ADDR	3
 
 #define MAX_INCOMING_CONTENT_LENGTH				0x2800
@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define INCOMING_HTTP_CONNECTION_SEND_TIMEOUT	15 // seconds
 
 #define HTTP_SERVER_SLEEP_TIME					50 // milliseconds
+#define HTTP_SERVER_AWAIT_SLEEP_TIME			5 // milliseconds, while waiting for the game module responses
 
 typedef enum
 {
@@ -49,6 +50,8 @@ typedef enum
 	CONTENT_STATE_RECEIVED = 2,
 } sv_http_content_state_t;
 
+// requested ranges are stored as is: a negative begin stands for a suffix
+// range ('bytes=-N', end is N), a negative end for an open range ('bytes=N-')
 typedef struct {
 	long begin;
 	long end;
@@ -86,6 +89,11 @@ typedef struct {
 
 	bool got_start_line;
 	bool close_after_resp;
+
+	// pipelined requests data that follows this request in the header buffer
+	size_t pipelined_offset;
+	size_t pipelined_length;
+	char pipelined_byte;		// the first byte gets overwritten by the content terminator
 } sv_http_request_t;
 
 typedef struct {
@@ -112,6 +120,8 @@ typedef struct sv_http_connection_s
 
 	socket_t socket;
 	netadr_t address;
+	int pollid;
+	int pollevents;
 
 	unsigned int last_active;
 
@@ -135,11 +145,12 @@ typedef unsigned (*queueCmdHandler_t)( const void * );
 static bool sv_http_initialized = false;
 static volatile bool sv_http_running = false;
 
-static sv_http_connection_t sv_http_connections[MAX_INCOMING_HTTP_CONNECTIONS];
 static sv_http_connection_t sv_http_connection_headnode, *sv_free_http_connections;
+static unsigned sv_http_num_connections;		// allocated ones, including free
 
 static socket_t sv_socket_http;
 static socket_t sv_socket_http6;
+static netpoll_t *sv_http_poll;
 
 static netadr_t sv_web_upstream_addr;
 
@@ -213,6 +224,9 @@ static void SV_Web_ResetRequest( sv_http_request_t *request )
 	request->got_start_line = false;
 	request->error = HTTP_RESP_NONE;
 	request->clientNum = -1;
+	request->pipelined_offset = 0;
+	request->pipelined_length = 0;
+	request->pipelined_byte = 0;
 }
 
 /*
@@ -265,6 +279,13 @@ static sv_http_connection_t *SV_Web_AllocConnection( void )
 		con = sv_free_http_connections;
 		sv_free_http_connections = con->next;
 	}
+	else if( sv_http_num_connections < MAX_INCOMING_HTTP_CONNECTIONS )
+	{
+		// connections are never released back to the heap until shutdown as
+		// pending game module responses may still point to them
+		con = Mem_ZoneMalloc( sizeof( *con ) );
+		sv_http_num_connections++;
+	}
 	else
 	{
 		return NULL;
@@ -278,6 +299,8 @@ static sv_http_connection_t *SV_Web_AllocConnection( void )
 	con->state = HTTP_CONN_STATE_NONE;
 	con->close_after_resp = false;
 	con->is_upstream = false;
+	con->pollid = -1;
+	con->pollevents = 0;
 	return con;
 }
 
@@ -301,21 +324,27 @@ static void SV_Web_FreeConnection( sv_http_connection_t *con )
 }
 
 /*
-* SV_Web_InitConnections
+* SV_Web_CloseConnection
 */
-static void SV_Web_InitConnections( void )
+static void SV_Web_CloseConnection( sv_http_connection_t *con )
 {
-	unsigned int i;
+	NET_Poll_Remove( sv_http_poll, con->pollid );
+	con->pollid = -1;
+	con->pollevents = 0;
 
-	memset( sv_http_connections, 0, sizeof( sv_http_connections ) );
+	NET_CloseSocket( &con->socket );
+	SV_Web_FreeConnection( con );
+}
 
-	// link decals
-	sv_free_http_connections = sv_http_connections;
+/*
+* SV_Web_InitConnections
+*/
+static void SV_Web_InitConnections( void )
+{
+	sv_free_http_connections = NULL;
+	sv_http_num_connections = 0;
 	sv_http_connection_headnode.prev = &sv_http_connection_headnode;
 	sv_http_connection_headnode.next = &sv_http_connection_headnode;
-	for( i = 0; i < MAX_INCOMING_HTTP_CONNECTIONS - 2; i++ ) {
-		sv_http_connections[i].next = &sv_http_connections[i+1];
-	}
 }
 
 /*
@@ -325,16 +354,22 @@ static void SV_Web_ShutdownConnections( void )
 {
 	sv_http_connection_t *con, *next, *hnode;
 
-	// close dead connections
+	// close all connections
 	hnode = &sv_http_connection_headnode;
 	for( con = hnode->prev; con != hnode; con = next )
 	{
 		next = con->prev;
-		if( con->open ) {
-			NET_CloseSocket( &con->socket );
-			SV_Web_FreeConnection( con );
-		}
+		SV_Web_CloseConnection( con );
+	}
+
+	// release memory
+	for( con = sv_free_http_connections; con; con = next )
+	{
+		next = con->next;
+		Mem_ZoneFree( con );
 	}
+	sv_free_http_connections = NULL;
+	sv_http_num_connections = 0;
 }
 
 /*
@@ -468,12 +503,11 @@ static unsigned SV_Web_ConnectionLimitReached( const netadr_t *addr )
 	for( con = hnode->prev; con != hnode; con = next )
 	{
 		next = con->prev;
-		if( NET_CompareAddress( addr, &con->address ) ) {
-			if( cnt >= MAX_INCOMING_HTTP_CONNECTIONS_PER_ADDR ) {
+		if( NET_CompareBaseAddress( addr, &con->address ) ) {
+			if( ++cnt >= MAX_INCOMING_HTTP_CONNECTIONS_PER_ADDR ) {
 				return true;
 			}
 		}
-		cnt++;
 	}
 	return false;
 }
@@ -792,54 +826,50 @@ static void SV_Web_AnalyzeHeader( sv_http_request_t *request, const char *key, c
 	}
 	else if( !Q_stricmp( key, "Range" ) 
 		&& ( request->method == HTTP_METHOD_GET || request->method == HTTP_METHOD_HEAD ) ) {
-		const char *delim = strchr( value, '-' );
+		const char *p = value + 6;
+		char *end;
+		long begin, last;
 
-		if( Q_strnicmp( value, "bytes=", 6 ) || !delim ) {
-			request->error = HTTP_RESP_BAD_REQUEST;
+		// only single byte ranges are supported, ignore anything else and serve the whole resource
+		if( Q_strnicmp( value, "bytes=", 6 ) || strchr( p, ',' ) ) {
+			return;
 		}
-		else {
-			bool neg_end = false;
-			const char *p = value;
-
-			// first byte pos
-			while( *p && p < delim ) {
-				if( *p >= '0' && *p <= '9' )
-					stream->content_range.begin = stream->content_range.begin*10 + *p - '0';
-				p++;
-			}
+
+		while( *p == ' ' ) {
 			p++;
+		}
 
-			// last byte pos
-			if( *p == '-' ) {
-				if( value != delim ) {
-					request->error = HTTP_RESP_REQUESTED_RANGE_NOT_SATISFIABLE;
-					return;
-				}
-				neg_end = true;
-				p++;
+		if( *p == '-' ) {
+			// bytes=-100, the last 100 bytes
+			last = strtol( p + 1, &end, 10 );
+			if( end == p + 1 || last < 0 ) {
+				return;
 			}
-			while( *p ) {
-				if( *p >= '0' && *p <= '9' )
-				stream->content_range.end = stream->content_range.end*10 + *p++ - '0';
+			begin = -1;
+		}
+		else {
+			begin = strtol( p, &end, 10 );
+			if( end == p || *end != '-' || begin < 0 ) {
+				return;
 			}
 
-			// partial content request
-			if( neg_end && stream->content_range.end ) {
-				// bytes=-100
-				request->partial = true;
-				stream->content_range.end = -stream->content_range.end;
-			} else if( stream->content_range.end >= stream->content_range.begin ) {
-				// bytes=200-300
-				request->partial = true;
-			} else if( stream->content_range.begin >= 0 && *(delim+1) == '\0' ) {
+			p = end + 1;
+			if( *p == '\0' ) {
 				// bytes=200-
-				request->partial = true;
+				last = -1;
 			}
-
-			if( request->partial ) {
-				request->partial_content_range = stream->content_range;
+			else {
+				// bytes=200-300, the last byte position is inclusive
+				last = strtol( p, &end, 10 );
+				if( end == p || last < begin ) {
+					return;
+				}
 			}
 		}
+
+		request->partial = true;
+		request->partial_content_range.begin = begin;
+		request->partial_content_range.end = last;
 	} else if( !Q_stricmp( key, "X-Client" ) ) {
 		request->clientNum = atoi( value );
 	} else if( !Q_stricmp( key, "X-Session" ) ) {
@@ -913,64 +943,78 @@ static size_t SV_Web_ParseHeaders( sv_http_request_t *request, char *data )
 }
 
 /*
-* SV_Web_ReceiveRequest
+* SV_Web_ParseRequest
+*
+* Reads and parses the request from the socket. Pipelined requests data that
+* has already been read into the header buffer is parsed first.
 */
-static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
+static void SV_Web_ParseRequest( sv_http_connection_t *con, bool pipelined )
 {
 	int ret = 0;
 	char *recvbuf;
 	size_t recvbuf_size;
 	sv_http_request_t *request = &con->request;
+	sv_http_stream_t *stream = &request->stream;
 	size_t total_received = 0;
+	bool had_pipelined = pipelined;
 
 	if( con->state != HTTP_CONN_STATE_RECV ) {
 		return;
 	}
 
-	while( !request->stream.header_done && sv_http_running ) {
+	while( !stream->header_done && sv_http_running ) {
 		char *end;
 		size_t rem;
 		size_t advance;
+		size_t buf_length;
 
-		recvbuf = request->stream.header_buf + request->stream.header_buf_p;
-		recvbuf_size = sizeof( request->stream.header_buf ) - request->stream.header_buf_p;
-		if( recvbuf_size <= 1 ) {
-			request->error = HTTP_RESP_BAD_REQUEST;
-			break;
+		if( pipelined ) {
+			// parse what's already in the buffer
+			pipelined = false;
+			ret = 0;
 		}
+		else {
+			recvbuf = stream->header_buf + stream->header_buf_p;
+			recvbuf_size = sizeof( stream->header_buf ) - stream->header_buf_p;
+			if( recvbuf_size <= 1 ) {
+				request->error = HTTP_RESP_BAD_REQUEST;
+				break;
+			}
 
-		ret = SV_Web_Get( con, recvbuf, recvbuf_size - 1 );
-		if( ret <= 0 ) {
-			if( total_received == 0 ) {
-				// no data on the socket after select() call, 
-				// the connection has probably been closed on the other end
-				con->open = false;
-				return;
+			ret = SV_Web_Get( con, recvbuf, recvbuf_size - 1 );
+			if( ret <= 0 ) {
+				if( total_received == 0 && !had_pipelined ) {
+					// no data on the socket after poll() call, 
+					// the connection has probably been closed on the other end
+					con->open = false;
+					return;
+				}
+				break;
 			}
-			break;
-		}
 
-		total_received += ret;
+			total_received += ret;
+		}
 
-		recvbuf[ret] = '\0';
-		advance = SV_Web_ParseHeaders( request, request->stream.header_buf );
+		buf_length = stream->header_buf_p + ret;
+		stream->header_buf[buf_length] = '\0';
+		advance = SV_Web_ParseHeaders( request, stream->header_buf );
 		if( !advance ) {
-			request->stream.header_buf_p += ret;
+			stream->header_buf_p = buf_length;
 			continue;
 		}
 
-		end = request->stream.header_buf + advance;
-		rem = (request->stream.header_buf_p + ret) - advance;
-		memmove( request->stream.header_buf, end, rem );
-		request->stream.header_buf_p = rem;
-		request->stream.header_length += advance;
+		end = stream->header_buf + advance;
+		rem = buf_length - advance;
+		memmove( stream->header_buf, end, rem );
+		stream->header_buf_p = rem;
+		stream->header_length += advance;
 
-		if( request->stream.header_length > MAX_INCOMING_CONTENT_LENGTH ) {
+		if( stream->header_length > MAX_INCOMING_CONTENT_LENGTH ) {
 			request->error = HTTP_RESP_REQUEST_TOO_LARGE;
 		}
 
 		// request must come from a connected client with a valid session id
-		if( !request->error && request->stream.header_done ) {
+		if( !request->error && stream->header_done ) {
 			// check real IP header value for upstream HTTP connections
 			if( con->is_upstream && 
 				(request->realAddr.type == NA_NOTRANSMIT || SV_Web_ConnectionLimitReached( &request->realAddr )) ) {
@@ -985,28 +1029,28 @@ static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
 			break;
 		}
 
-		if( request->stream.header_done ) {
+		if( stream->header_done ) {
 			con->close_after_resp = request->close_after_resp;
 
-			if( request->stream.content_length ) {
-				if( request->stream.content_length < sizeof( request->stream.header_buf ) ) {
-					request->stream.content = request->stream.header_buf;
-					request->stream.content_p = request->stream.header_buf_p;
+			if( stream->content_length ) {
+				if( stream->content_length < sizeof( stream->header_buf ) ) {
+					stream->content = stream->header_buf;
+					stream->content_p = stream->header_buf_p;
 				}
 				else {
-					request->stream.content = Mem_ZoneMallocExt( request->stream.content_length + 1, 0 );
-					request->stream.content[request->stream.content_length] = 0;
-					memcpy( request->stream.content, request->stream.header_buf, request->stream.header_buf_p );
-					request->stream.content_p = request->stream.header_buf_p;
+					stream->content = Mem_ZoneMallocExt( stream->content_length + 1, 0 );
+					stream->content[stream->content_length] = 0;
+					memcpy( stream->content, stream->header_buf, stream->header_buf_p );
+					stream->content_p = stream->header_buf_p;
 				}
 			}
 		}
 	}
 
-	if( request->stream.header_done && !request->error && request->stream.content_length ) {
-		while( request->stream.content_length > request->stream.content_p && sv_http_running ) {
-			recvbuf = request->stream.content + request->stream.content_p;
-			recvbuf_size = request->stream.content_length - request->stream.content_p;
+	if( stream->header_done && !request->error ) {
+		while( stream->content_length > stream->content_p && sv_http_running ) {
+			recvbuf = stream->content + stream->content_p;
+			recvbuf_size = stream->content_length - stream->content_p;
 
 			ret = SV_Web_Get( con, recvbuf, recvbuf_size );
 			if( ret <= 0 ) {
@@ -1014,11 +1058,27 @@ static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
 			}
 
 			total_received += ret;
-			request->stream.content_p += ret;
+			stream->content_p += ret;
 		}
-		if( request->stream.content_p >= request->stream.content_length ) {
-			request->stream.content_p = request->stream.content_length;
-			request->stream.content[request->stream.content_p] = '\0';
+
+		if( stream->content_p >= stream->content_length ) {
+			// keep whatever follows the request for the next one
+			if( !stream->content ) {
+				request->pipelined_offset = 0;
+				request->pipelined_length = stream->header_buf_p;
+			}
+			else if( stream->content == stream->header_buf ) {
+				request->pipelined_offset = stream->content_length;
+				request->pipelined_length = stream->content_p - stream->content_length;
+			}
+			if( request->pipelined_length ) {
+				request->pipelined_byte = stream->header_buf[request->pipelined_offset];
+			}
+
+			if( stream->content ) {
+				stream->content_p = stream->content_length;
+				stream->content[stream->content_p] = '\0';
+			}
 		}
 	}
 
@@ -1036,7 +1096,7 @@ static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
 		con->close_after_resp = true;
 		con->state = HTTP_CONN_STATE_RESP;
 	}
-	else if( request->stream.header_done && request->stream.content_p >= request->stream.content_length ) {
+	else if( stream->header_done && stream->content_p >= stream->content_length ) {
 		// yay, fully got the request
 		con->state = HTTP_CONN_STATE_RESP;
 	}
@@ -1047,6 +1107,42 @@ static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
 	}
 }
 
+/*
+* SV_Web_ReceiveRequest
+*/
+static void SV_Web_ReceiveRequest( socket_t *socket, sv_http_connection_t *con )
+{
+	SV_Web_ParseRequest( con, false );
+}
+
+/*
+* SV_Web_NextRequest
+*
+* Prepares the connection for the next request after the response has been sent,
+* picking up pipelined requests data if there's any.
+*/
+static void SV_Web_NextRequest( sv_http_connection_t *con )
+{
+	sv_http_request_t *request = &con->request;
+	sv_http_stream_t *stream = &request->stream;
+	size_t offset = request->pipelined_offset;
+	size_t length = request->pipelined_length;
+	char byte = request->pipelined_byte;
+
+	SV_Web_ResetResponse( &con->response );
+	SV_Web_ResetRequest( request );
+
+	if( !length ) {
+		return;
+	}
+
+	memmove( stream->header_buf, stream->header_buf + offset, length );
+	stream->header_buf[0] = byte;
+	stream->header_buf_p = length;
+
+	SV_Web_ParseRequest( con, true );
+}
+
 // ============================================================================
 
 /*
@@ -1169,24 +1265,32 @@ static void SV_Web_RespondToQuery( sv_http_connection_t *con )
 
 		// serve range requests
 		if( request->partial && response->file ) {
-			// seek to first byte pos and clamp the last byte pos to content length
-			if( request->partial_content_range.begin > 0 ) { 
-				FS_Seek( response->file, request->partial_content_range.begin, FS_SEEK_SET );
-				// range.end may be set to 0 for 'bytes=100-' style requests
-				response->stream.content_range.end = request->partial_content_range.end 
-					? request->partial_content_range.end : content_length;
-
-			} else if( request->partial_content_range.end < 0 ) {
-				// seek to N last bytes in the file
-				FS_Seek( response->file, request->partial_content_range.end, FS_SEEK_END );
-				response->stream.content_range.end = -request->partial_content_range.end;
+			long file_length = (long)content_length;
+			long begin = request->partial_content_range.begin;
+			long end = request->partial_content_range.end;
+
+			if( begin < 0 ) {
+				// the last N bytes of the file
+				begin = max( file_length - end, 0 );
+				end = file_length - 1;
+			}
+			else if( end < 0 || end >= file_length ) {
+				// clamp the last byte pos to content length
+				end = file_length - 1;
 			}
 
-			// Content-Range header values
-			response->file_send_pos = FS_Tell( response->file );
-			response->stream.content_range.begin = response->file_send_pos;
-			response->stream.content_range.end = min( (int)content_length, response->stream.content_range.end );
-			response->code = HTTP_RESP_PARTIAL_CONTENT;
+			if( begin >= file_length || end < begin ) {
+				FS_FCloseFile( response->file );
+				response->file = 0;
+				response->code = HTTP_RESP_REQUESTED_RANGE_NOT_SATISFIABLE;
+			}
+			else {
+				// Content-Range header values
+				response->file_send_pos = begin;
+				response->stream.content_range.begin = begin;
+				response->stream.content_range.end = end;
+				response->code = HTTP_RESP_PARTIAL_CONTENT;
+			}
 		}
 
 		if( request->method == HTTP_METHOD_HEAD && response->file ) {
@@ -1205,24 +1309,27 @@ static void SV_Web_RespondToQuery( sv_http_connection_t *con )
 			sizeof( resp_stream->header_buf ) );
 
 	if( response->code == HTTP_RESP_REQUESTED_RANGE_NOT_SATISFIABLE ) {
-		int file_length = FS_FOpenBaseFile( request->resource, NULL, FS_READ );
-
 		// in accordance with RFC 2616, send the Content-Range entity header,
 		// specifying the length of the resource
-		if( file_length < 0 ) {
+		if( !response->filename ) {
 			Q_strncatz( resp_stream->header_buf, "Content-Range: bytes */*\r\n",
 				sizeof( resp_stream->header_buf ) );
 		}
 		else {
-			Q_snprintfz( vastr, sizeof( vastr ), "Content-Range: bytes */%i\r\n", content_length );
+			Q_snprintfz( vastr, sizeof( vastr ), "Content-Range: bytes */%i\r\n", (int)content_length );
 			Q_strncatz( resp_stream->header_buf, vastr, sizeof( resp_stream->header_buf ) );
 		}
 	}
 	else if( response->code == HTTP_RESP_PARTIAL_CONTENT ) {
-		Q_snprintfz( vastr, sizeof( vastr ), "Content-Range: bytes %i-%i/%i\r\n", 
-			response->stream.content_range.begin, response->stream.content_range.end, content_length );
+		Q_snprintfz( vastr, sizeof( vastr ), "Content-Range: bytes %li-%li/%i\r\n", 
+			response->stream.content_range.begin, response->stream.content_range.end, (int)content_length );
 		Q_strncatz( resp_stream->header_buf, vastr, sizeof( resp_stream->header_buf ) );
-		content_length = response->stream.content_range.end - response->stream.content_range.begin;
+		content_length = response->stream.content_range.end - response->stream.content_range.begin + 1;
+	}
+
+	if( con->close_after_resp ) {
+		Q_strncatz( resp_stream->header_buf, "Connection: close\r\n", 
+			sizeof( resp_stream->header_buf ) );
 	}
 
 	if( response->code >= HTTP_RESP_BAD_REQUEST || !content_length ) {
@@ -1350,12 +1457,12 @@ static void SV_Web_WriteResponse( socket_t *socket, sv_http_connection_t *con )
 			SV_Web_SendResponse( con );
 
 			if( con->state == HTTP_CONN_STATE_RECV ) {
-				SV_Web_ResetResponse( &con->response );
 				if( con->close_after_resp ) {
+					SV_Web_ResetResponse( &con->response );
 					con->open = false;
 				}
 				else {
-					SV_Web_ResetRequest( &con->request );
+					SV_Web_NextRequest( con );
 				}
 			}
 			break;
@@ -1432,17 +1539,29 @@ static void SV_Web_Listen( socket_t *socket )
 		}
 		
 		if( !block ) {
-			Com_DPrintf( "HTTP connection accepted from %s\n", NET_AddressToString( &newaddress ) );
 			con = SV_Web_AllocConnection();
 			if( !con ) {
-				break;
+				Com_DPrintf( "HTTP connection limit reached, refusing %s\n", NET_AddressToString( &newaddress ) );
+				NET_CloseSocket( &newsocket );
+				continue;
 			}
+
 			con->socket = newsocket;
 			con->address = newaddress;
 			con->last_active = Sys_Milliseconds();
 			con->open = true;
 			con->state = HTTP_CONN_STATE_RECV;
 			con->is_upstream = is_upstream;
+
+			con->pollevents = NET_POLL_READ;
+			con->pollid = NET_Poll_Add( sv_http_poll, &con->socket, con->pollevents, con );
+			if( con->pollid < 0 ) {
+				Com_Printf( "HTTP connection error: %s\n", NET_ErrorString() );
+				SV_Web_CloseConnection( con );
+				continue;
+			}
+
+			Com_DPrintf( "HTTP connection accepted from %s\n", NET_AddressToString( &newaddress ) );
 			continue;
 		}
 
@@ -1475,6 +1594,23 @@ void SV_Web_Init( void )
 		return;
 	}
 
+	sv_http_poll = NET_Poll_Create();
+	if( !sv_http_poll ) {
+		Com_Printf( "Error: Couldn't create HTTP poll set: %s\n", NET_ErrorString() );
+		NET_CloseSocket( &sv_socket_http );
+		NET_CloseSocket( &sv_socket_http6 );
+		sv_http_initialized = false;
+		return;
+	}
+
+	// listening sockets are told apart from connections by the NULL private pointer
+	if( sv_socket_http.address.type == NA_IP ) {
+		NET_Poll_Add( sv_http_poll, &sv_socket_http, NET_POLL_READ, NULL );
+	}
+	if( sv_socket_http6.address.type == NA_IP6 ) {
+		NET_Poll_Add( sv_http_poll, &sv_socket_http6, NET_POLL_READ, NULL );
+	}
+
 	sv_http_running = true;
 
 	SV_Web_InitQueues();
@@ -1484,16 +1620,34 @@ void SV_Web_Init( void )
 	sv_http_thread = QThread_Create( SV_Web_ThreadProc, NULL );
 }
 
+/*
+* SV_Web_PollRead
+*/
+static void SV_Web_PollRead( socket_t *socket, void *privatep )
+{
+	if( !privatep ) {
+		SV_Web_Listen( socket );
+		return;
+	}
+	SV_Web_ReceiveRequest( socket, privatep );
+}
+
+/*
+* SV_Web_PollWrite
+*/
+static void SV_Web_PollWrite( socket_t *socket, void *privatep )
+{
+	SV_Web_WriteResponse( socket, privatep );
+}
+
 /*
 * SV_Web_Frame
 */
 static void SV_Web_Frame( void )
 {
 	sv_http_connection_t *con, *next, *hnode = &sv_http_connection_headnode;
-	socket_t *sockets[MAX_INCOMING_HTTP_CONNECTIONS+1];
-	void *connections[MAX_INCOMING_HTTP_CONNECTIONS];
-	int num_sockets = 0;
 	bool upstream_is_set;
+	bool awaiting = false;
 
 	if( !sv_http_initialized ) {
 		return;
@@ -1514,54 +1668,52 @@ static void SV_Web_Frame( void )
 			NET_InitAddress( &sv_web_upstream_addr, NA_NOTRANSMIT );
 	}
 
-	// accept new connections
-	if( sv_socket_http.address.type == NA_IP ) {
-		SV_Web_Listen( &sv_socket_http );
-	}
-	if( sv_socket_http6.address.type == NA_IP6 ) {
-		SV_Web_Listen( &sv_socket_http6 );
-	}
+	// read query results from the game module
+	SV_Web_ReadOutgoingQueueCmds();
 
-	// handle incoming data
-	num_sockets = 0;
+	// update events of interest: only wait for the socket to become writable
+	// when there's something to send, otherwise poll would never block
 	for( con = hnode->prev; con != hnode; con = next )
 	{
+		int events = 0;
+
 		next = con->prev;
 		switch( con->state ) {
 			case HTTP_CONN_STATE_RECV:
+				events = NET_POLL_READ;
+				break;
 			case HTTP_CONN_STATE_RESP:
+				if( con->response.content_state == CONTENT_STATE_AWAITING ) {
+					awaiting = true;
+				}
+				else {
+					events = NET_POLL_WRITE;
+				}
+				break;
 			case HTTP_CONN_STATE_SEND:
-				sockets[num_sockets] = &con->socket;
-				connections[num_sockets] = con;
-				num_sockets++;
+				events = NET_POLL_WRITE;
 				break;
 			default:
 				break;
 		}
-	}
-	sockets[num_sockets] = NULL;
-
-	// read query results from the game module
-	SV_Web_ReadOutgoingQueueCmds();
 
-	if( num_sockets != 0 ) {
-		NET_Monitor( HTTP_SERVER_SLEEP_TIME, sockets,
-			(void (*)(socket_t *, void*))SV_Web_ReceiveRequest,
-			(void (*)(socket_t *, void*))SV_Web_WriteResponse,
-			NULL, connections );
-	}
-	else {
-		// sleep on network sockets if got nothing else to do
-		if( sv_socket_http.address.type == NA_IP ) {
-			sockets[num_sockets++] = &sv_socket_http;
-		}
-		if( sv_socket_http6.address.type == NA_IP6 ) {
-			sockets[num_sockets++] = &sv_socket_http6;
+		if( events != con->pollevents ) {
+			if( !NET_Poll_Modify( sv_http_poll, con->pollid, events ) ) {
+				con->open = false;
+				continue;
+			}
+			con->pollevents = events;
 		}
-		sockets[num_sockets] = NULL;
-		NET_Sleep( HTTP_SERVER_SLEEP_TIME, sockets );
 	}
 
+	// accept new connections and handle incoming and outgoing data
+	Prof_Begin( "http_poll" );
+	if( NET_Poll_Wait( sv_http_poll, awaiting ? HTTP_SERVER_AWAIT_SLEEP_TIME : HTTP_SERVER_SLEEP_TIME,
+		SV_Web_PollRead, SV_Web_PollWrite ) < 0 ) {
+		Com_DPrintf( "HTTP poll error: %s\n", NET_ErrorString() );
+	}
+	Prof_End();
+
 	// close dead connections
 	for( con = hnode->prev; con != hnode; con = next )
 	{
@@ -1592,8 +1744,7 @@ static void SV_Web_Frame( void )
 		}
 
 		if( !con->open ) {
-			NET_CloseSocket( &con->socket );
-			SV_Web_FreeConnection( con );
+			SV_Web_CloseConnection( con );
 		}
 	}
 }
@@ -1619,6 +1770,8 @@ void SV_Web_GameFrame( http_game_query_cb cb )
 */
 static void *SV_Web_ThreadProc( void *param )
 {
+	Prof_SetThreadName( "http" );
+
 	while( sv_http_running ) {
 		SV_Web_Frame();
 	}
@@ -1641,6 +1794,8 @@ void SV_Web_Shutdown( void )
 
 	SV_Web_DestroyQueues();
 
+	NET_Poll_Destroy( &sv_http_poll );
+
 	NET_CloseSocket( &sv_socket_http );
 	NET_CloseSocket( &sv_socket_http6 );
 
@@ -0,0 +1,431 @@
+/*
+Copyright (C) 2016 Victor Luchits
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// sv_webload.c -- load generator for the builtin HTTP server
+
+#include "server.h"
+
+/*
+
+"webload [connections] [seconds] [resource]" opens the connections to the local web server
+and keeps each of them busy with keep-alive requests for the resource, reconnecting when the
+server closes a connection. Requests carry a temporary HTTP session registered for the first
+client slot, so they pass the same checks as requests of real clients. Game module resources
+are answered while the command runs as the main thread keeps passing queries to the game.
+Throughput and response latencies are printed at the end.
+
+*/
+
+#ifdef HTTP_SUPPORT
+
+#define WEBLOAD_MAX_CONNECTIONS			1000
+#define WEBLOAD_DEFAULT_CONNECTIONS		100
+#define WEBLOAD_DEFAULT_SECONDS			10
+#define WEBLOAD_DEFAULT_RESOURCE		"game/callvotes/map"
+#define WEBLOAD_SESSION					"webload"
+#define WEBLOAD_LATENCY_BUCKETS			1000	// one per millisecond, the last one takes everything above
+
+typedef struct
+{
+	socket_t socket;
+	int pollid;
+	bool connecting;
+
+	uint64_t request_time;
+	size_t request_sent;
+
+	char header[0x2000];
+	size_t header_p;
+	size_t header_length;		// zero until the whole header is received
+	size_t content_length;
+	size_t content_received;
+	int code;
+	bool close;
+} sv_webload_conn_t;
+
+static struct
+{
+	netpoll_t *poll;
+	netadr_t address;
+	sv_webload_conn_t *conns;
+	int numConns;
+
+	char request[1024];
+	size_t request_length;
+
+	unsigned responses, failed, errors, reconnects;
+	uint64_t bytes;
+	uint64_t latencyTotal, latencyMax;
+	unsigned latencies[WEBLOAD_LATENCY_BUCKETS];
+} sv_webload;
+
+/*
+* SV_WebLoad_ResetResponse
+*/
+static void SV_WebLoad_ResetResponse( sv_webload_conn_t *conn )
+{
+	conn->request_time = 0;
+	conn->request_sent = 0;
+	conn->header_p = 0;
+	conn->header_length = 0;
+	conn->content_length = 0;
+	conn->content_received = 0;
+	conn->code = 0;
+	conn->close = false;
+}
+
+/*
+* SV_WebLoad_Connect
+*/
+static bool SV_WebLoad_Connect( sv_webload_conn_t *conn )
+{
+	netadr_t address;
+	connection_status_t status;
+
+	SV_WebLoad_ResetResponse( conn );
+	conn->pollid = -1;
+
+	NET_InitAddress( &address, sv_webload.address.type );
+	if( !NET_OpenSocket( &conn->socket, SOCKET_TCP, &address, false ) )
+		return false;
+	NET_SetSocketNoDelay( &conn->socket, 1 );
+
+	status = NET_Connect( &conn->socket, &sv_webload.address );
+	if( status == CONNECTION_FAILED )
+	{
+		NET_CloseSocket( &conn->socket );
+		return false;
+	}
+	conn->connecting = status == CONNECTION_INPROGRESS;
+
+	// the socket becomes writable once connected
+	conn->pollid = NET_Poll_Add( sv_webload.poll, &conn->socket, NET_POLL_WRITE, conn );
+	if( conn->pollid < 0 )
+	{
+		NET_CloseSocket( &conn->socket );
+		return false;
+	}
+	return true;
+}
+
+/*
+* SV_WebLoad_Disconnect
+*/
+static void SV_WebLoad_Disconnect( sv_webload_conn_t *conn )
+{
+	if( !conn->socket.open )
+		return;
+
+	NET_Poll_Remove( sv_webload.poll, conn->pollid );
+	conn->pollid = -1;
+	NET_CloseSocket( &conn->socket );
+}
+
+/*
+* SV_WebLoad_Reconnect
+*/
+static void SV_WebLoad_Reconnect( sv_webload_conn_t *conn )
+{
+	SV_WebLoad_Disconnect( conn );
+	sv_webload.reconnects++;
+	if( !SV_WebLoad_Connect( conn ) )
+		sv_webload.errors++;
+}
+
+/*
+* SV_WebLoad_Error
+*/
+static void SV_WebLoad_Error( sv_webload_conn_t *conn )
+{
+	sv_webload.errors++;
+	SV_WebLoad_Reconnect( conn );
+}
+
+/*
+* SV_WebLoad_ParseHeader
+*/
+static void SV_WebLoad_ParseHeader( sv_webload_conn_t *conn )
+{
+	char *line, *p;
+
+	line = conn->header;
+	if( !strncmp( line, "HTTP/", 5 ) && ( p = strchr( line, ' ' ) ) != NULL )
+		conn->code = atoi( p + 1 );
+
+	while( ( p = strstr( line, "\r\n" ) ) != NULL && p != line )
+	{
+		*p = '\0';
+		if( !Q_strnicmp( line, "Content-Length:", 15 ) )
+			conn->content_length = strtoul( line + 15, NULL, 10 );
+		else if( !Q_strnicmp( line, "Connection:", 11 ) && strstr( line + 11, "close" ) )
+			conn->close = true;
+		line = p + 2;
+	}
+}
+
+/*
+* SV_WebLoad_FinishResponse
+*/
+static void SV_WebLoad_FinishResponse( sv_webload_conn_t *conn )
+{
+	uint64_t latency;
+
+	latency = Sys_Microseconds() - conn->request_time;
+	sv_webload.latencyTotal += latency;
+	if( latency > sv_webload.latencyMax )
+		sv_webload.latencyMax = latency;
+	sv_webload.latencies[min( latency / 1000, WEBLOAD_LATENCY_BUCKETS - 1 )]++;
+
+	sv_webload.responses++;
+	if( conn->code < 200 || conn->code >= 300 )
+		sv_webload.failed++;
+	sv_webload.bytes += conn->header_length + conn->content_length;
+
+	if( conn->close )
+	{
+		SV_WebLoad_Reconnect( conn );
+		return;
+	}
+
+	SV_WebLoad_ResetResponse( conn );
+	NET_Poll_Modify( sv_webload.poll, conn->pollid, NET_POLL_WRITE );
+}
+
+/*
+* SV_WebLoad_Write
+*/
+static void SV_WebLoad_Write( socket_t *socket, void *privatep )
+{
+	int sent;
+	sv_webload_conn_t *conn = privatep;
+
+	if( conn->connecting )
+	{
+		connection_status_t status = NET_CheckConnect( &conn->socket );
+		if( status == CONNECTION_INPROGRESS )
+			return;
+		if( status == CONNECTION_FAILED )
+		{
+			SV_WebLoad_Error( conn );
+			return;
+		}
+		conn->connecting = false;
+	}
+
+	if( !conn->request_sent )
+		conn->request_time = Sys_Microseconds();
+
+	sent = NET_Send( &conn->socket, sv_webload.request + conn->request_sent,
+		sv_webload.request_length - conn->request_sent, &sv_webload.address );
+	if( sent < 0 )
+	{
+		SV_WebLoad_Error( conn );
+		return;
+	}
+
+	conn->request_sent += sent;
+	if( conn->request_sent >= sv_webload.request_length )
+		NET_Poll_Modify( sv_webload.poll, conn->pollid, NET_POLL_READ );
+}
+
+/*
+* SV_WebLoad_Read
+*/
+static void SV_WebLoad_Read( socket_t *socket, void *privatep )
+{
+	int ret;
+	char *end;
+	char discard[0x4000];
+	sv_webload_conn_t *conn = privatep;
+
+	if( !conn->header_length )
+	{
+		if( conn->header_p >= sizeof( conn->header ) - 1 )
+		{
+			SV_WebLoad_Error( conn );
+			return;
+		}
+
+		ret = NET_Get( &conn->socket, NULL, conn->header + conn->header_p, sizeof( conn->header ) - 1 - conn->header_p );
+		if( ret <= 0 )
+		{
+			// readable but nothing to read means the server has closed the connection
+			SV_WebLoad_Error( conn );
+			return;
+		}
+
+		conn->header_p += ret;
+		conn->header[conn->header_p] = '\0';
+
+		end = strstr( conn->header, "\r\n\r\n" );
+		if( !end )
+			return;
+
+		conn->header_length = end + 4 - conn->header;
+		conn->content_received = conn->header_p - conn->header_length;
+		SV_WebLoad_ParseHeader( conn );
+	}
+	else
+	{
+		ret = NET_Get( &conn->socket, NULL, discard, sizeof( discard ) );
+		if( ret <= 0 )
+		{
+			SV_WebLoad_Error( conn );
+			return;
+		}
+		conn->content_received += ret;
+	}
+
+	if( conn->content_received >= conn->content_length )
+		SV_WebLoad_FinishResponse( conn );
+}
+
+/*
+* SV_WebLoad_Percentile
+*/
+static unsigned SV_WebLoad_Percentile( float fraction )
+{
+	unsigned i, count, target;
+
+	target = (unsigned)( sv_webload.responses * fraction );
+	for( i = 0, count = 0; i < WEBLOAD_LATENCY_BUCKETS; i++ )
+	{
+		count += sv_webload.latencies[i];
+		if( count > target )
+			break;
+	}
+	return i;
+}
+
+/*
+* SV_WebLoad_f
+*/
+void SV_WebLoad_f( void )
+{
+	int i, numConns, seconds;
+	const char *resource;
+	char session[HTTP_CLIENT_SESSION_SIZE];
+	unsigned start, elapsed;
+	float fsecs;
+
+	numConns = Cmd_Argc() > 1 ? atoi( Cmd_Argv( 1 ) ) : WEBLOAD_DEFAULT_CONNECTIONS;
+	seconds = Cmd_Argc() > 2 ? atoi( Cmd_Argv( 2 ) ) : WEBLOAD_DEFAULT_SECONDS;
+	resource = Cmd_Argc() > 3 ? Cmd_Argv( 3 ) : WEBLOAD_DEFAULT_RESOURCE;
+
+	if( numConns < 1 || numConns > WEBLOAD_MAX_CONNECTIONS || seconds < 1 )
+	{
+		Com_Printf( "Usage: %s [connections (1-%i)] [seconds] [resource]\n", Cmd_Argv( 0 ), WEBLOAD_MAX_CONNECTIONS );
+		return;
+	}
+	while( *resource == '/' )
+		resource++;
+
+	if( !SV_Web_Running() )
+	{
+		Com_Printf( "The web server is not running\n" );
+		return;
+	}
+	if( !Q_strnicmp( resource, "game/", 5 ) && ( !ge || sv.state != ss_game ) )
+	{
+		Com_Printf( "Game module resources require a running game\n" );
+		return;
+	}
+
+	memset( &sv_webload, 0, sizeof( sv_webload ) );
+
+	NET_StringToAddress( "127.0.0.1", &sv_webload.address );
+	NET_SetAddressPort( &sv_webload.address, sv_http_port->integer );
+
+	// requests must carry a session of a connected client
+	memset( session, 0, sizeof( session ) );
+	Q_strncpyz( session, WEBLOAD_SESSION, sizeof( session ) );
+	if( !SV_Web_AddGameClient( session, 0, &sv_webload.address ) )
+	{
+		Com_Printf( "Couldn't register the HTTP session\n" );
+		return;
+	}
+
+	Q_snprintfz( sv_webload.request, sizeof( sv_webload.request ),
+		"GET /%s HTTP/1.1\r\nHost: %s\r\nX-Client: 0\r\nX-Session: %s\r\n\r\n",
+		resource, NET_AddressToString( &sv_webload.address ), session );
+	sv_webload.request_length = strlen( sv_webload.request );
+
+	sv_webload.poll = NET_Poll_Create();
+	if( !sv_webload.poll )
+	{
+		Com_Printf( "Couldn't create the poll set: %s\n", NET_ErrorString() );
+		SV_Web_RemoveGameClient( session );
+		return;
+	}
+
+	sv_webload.conns = Mem_ZoneMalloc( numConns * sizeof( *sv_webload.conns ) );
+	sv_webload.numConns = numConns;
+	for( i = 0; i < numConns; i++ )
+	{
+		if( !SV_WebLoad_Connect( &sv_webload.conns[i] ) )
+			sv_webload.errors++;
+	}
+
+	Com_Printf( "Loading http://%s/%s with %i connections for %i seconds\n",
+		NET_AddressToString( &sv_webload.address ), resource, numConns, seconds );
+
+	start = Sys_Milliseconds();
+	do
+	{
+		NET_Poll_Wait( sv_webload.poll, 1, SV_WebLoad_Read, SV_WebLoad_Write );
+
+		// the web server thread waits for the game module to answer queries
+		if( ge )
+			SV_Web_GameFrame( ge->WebRequest );
+
+		elapsed = Sys_Milliseconds() - start;
+	} while( elapsed < (unsigned)seconds * 1000 );
+
+	for( i = 0; i < numConns; i++ )
+		SV_WebLoad_Disconnect( &sv_webload.conns[i] );
+	Mem_ZoneFree( sv_webload.conns );
+	sv_webload.conns = NULL;
+	NET_Poll_Destroy( &sv_webload.poll );
+	SV_Web_RemoveGameClient( session );
+
+	fsecs = elapsed * 0.001f;
+	Com_Printf( "%u responses in %.1f seconds: %.1f responses/s, %.1f KiB/s\n", sv_webload.responses, fsecs,
+		sv_webload.responses / fsecs, sv_webload.bytes / 1024.0f / fsecs );
+	Com_Printf( "%u non-2xx responses, %u connection errors, %u reconnects\n",
+		sv_webload.failed, sv_webload.errors, sv_webload.reconnects );
+	if( sv_webload.responses )
+	{
+		Com_Printf( "Latency: average %.2f ms, p50 %u ms, p99 %u ms, max %.2f ms\n",
+			sv_webload.latencyTotal * 0.001f / sv_webload.responses, SV_WebLoad_Percentile( 0.5f ),
+			SV_WebLoad_Percentile( 0.99f ), sv_webload.latencyMax * 0.001f );
+	}
+}
+
+#else
+
+/*
+* SV_WebLoad_f
+*/
+void SV_WebLoad_f( void )
+{
+	Com_Printf( "HTTP support is disabled\n" );
+}
+
+#endif // HTTP_SUPPORT
@@ -351,9 +351,11 @@ static void S_SetListener( const vec3_t origin, const vec3_t velocity, const mat
 */
 static void S_Update( void )
 {
+	trap_Prof_Begin( "s_update" );
 	S_UpdateMusic();
 	
 	S_UpdateStreams();
+	trap_Prof_End();
 	
 	s_volume->modified = false; // Checked by src and stream
 	s_musicvolume->modified = false; // Checked by stream and music
@@ -27,6 +27,14 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 sfx_t knownSfx[MAX_SFX];
 static bool buffers_inited = false;
 
+static struct
+{
+	size_t size;        // bytes uploaded to OpenAL
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int evictions;
+} buffers_stats;
+
 /*
 * Local helper functions
 */
@@ -118,12 +126,14 @@ bool S_UnloadBuffer( sfx_t *sfx )
 	}
 
 	sfx->inMemory = false;
+	buffers_stats.size -= sfx->size;
+	sfx->size = 0;
 
 	return true;
 }
 
 // Remove the least recently used sound effect from memory
-static bool buffer_evict()
+static bool buffer_evict( const sfx_t *keep, bool keepResident )
 {
 	int i;
 	int candinate = -1;
@@ -133,22 +143,41 @@ static bool buffer_evict()
 	{
 		if( knownSfx[i].filename[0] == '\0' || !knownSfx[i].inMemory || knownSfx[i].isLocked )
 			continue;
+		if( &knownSfx[i] == keep || ( keepResident && knownSfx[i].isResident ) )
+			continue;
 
-		if( knownSfx[i].used < candinate_value )
+		if( knownSfx[i].used < candinate_value && !S_IsBufferInUse( &knownSfx[i] ) )
 		{
 			candinate = i;
 			candinate_value = knownSfx[i].used;
 		}
 	}
 
-	if( candinate != -1 )
+	if( candinate != -1 && S_UnloadBuffer( &knownSfx[candinate] ) )
 	{
-		return S_UnloadBuffer( &knownSfx[candinate] );
+		buffers_stats.evictions++;
+		return true;
 	}
 
 	return false;
 }
 
+// Evict the least recently used sounds until the buffers fit into s_cachesize
+static void buffer_trim( const sfx_t *keep )
+{
+	size_t budget;
+
+	if( s_cachesize->value <= 0 )
+		return;
+
+	budget = (size_t)( s_cachesize->value * 1024 * 1024 );
+	while( buffers_stats.size > budget )
+	{
+		if( !buffer_evict( keep, true ) )
+			break;
+	}
+}
+
 bool S_LoadBuffer( sfx_t *sfx )
 {
 	ALenum error;
@@ -197,7 +226,7 @@ bool S_LoadBuffer( sfx_t *sfx )
 	// If we ran out of memory, start evicting the least recently used sounds
 	while( error == AL_OUT_OF_MEMORY )
 	{
-		if( !buffer_evict() )
+		if( !buffer_evict( sfx, false ) )
 		{
 			S_Free( data );
 			Com_Printf( "Out of memory loading %s\n", sfx->filename );
@@ -220,6 +249,11 @@ bool S_LoadBuffer( sfx_t *sfx )
 
 	S_Free( data );
 	sfx->inMemory = true;
+	sfx->isResident = info.samples < info.rate * S_RESIDENT_SECONDS;
+	sfx->size = info.size;
+	buffers_stats.size += info.size;
+
+	buffer_trim( sfx );
 
 	return true;
 }
@@ -274,6 +308,7 @@ void S_InitBuffers( void )
 		return;
 
 	memset( knownSfx, 0, sizeof( knownSfx ) );
+	memset( &buffers_stats, 0, sizeof( buffers_stats ) );
 
 	buffers_inited = true;
 }
@@ -313,6 +348,12 @@ void S_SoundList_f( void )
 			Com_Printf( " : %s\n", knownSfx[i].filename );
 		}
 	}
+
+	Com_Printf( "Sound cache: %.1f MB", buffers_stats.size / ( 1024.0 * 1024.0 ) );
+	if( s_cachesize->value > 0 )
+		Com_Printf( " of %.1f MB", s_cachesize->value );
+	Com_Printf( ", %u hits, %u misses, %u evictions\n", 
+		buffers_stats.hits, buffers_stats.misses, buffers_stats.evictions );
 }
 
 void S_UseBuffer( sfx_t *sfx )
@@ -320,8 +361,15 @@ void S_UseBuffer( sfx_t *sfx )
 	if( sfx->filename[0] == '\0' )
 		return;
 
-	if( !sfx->inMemory )
+	if( sfx->inMemory )
+	{
+		buffers_stats.hits++;
+	}
+	else
+	{
+		buffers_stats.misses++;
 		S_LoadBuffer( sfx );
+	}
 
 	sfx->used = trap_Milliseconds();
 }
@@ -65,9 +65,15 @@ typedef struct sfx_s
 	ALuint buffer;      // OpenAL buffer
 	bool inMemory;
 	bool isLocked;
+	bool isResident;    // short sounds are never evicted to fit s_cachesize
+	int size;           // Bytes uploaded to the buffer
 	int used;           // Time last used
 } sfx_t;
 
+// sounds are loaded on first use and evicted in LRU order once the
+// buffers outgrow s_cachesize, except for short ones which stay resident
+#define S_RESIDENT_SECONDS	2
+
 extern cvar_t *s_volume;
 extern cvar_t *s_musicvolume;
 extern cvar_t *s_sources;
@@ -77,6 +83,7 @@ extern cvar_t *s_doppler;
 extern cvar_t *s_sound_velocity;
 
 extern cvar_t *s_globalfocus;
+extern cvar_t *s_cachesize;
 
 extern int s_attenuation_model;
 extern float s_attenuation_maxdistance;
@@ -197,6 +204,7 @@ void S_StopAllSources( void );
 ALuint S_GetALSource( const src_t *src );
 src_t *S_AllocRawSource( int entNum, float fvol, float attenuation, cvar_t *volumeVar );
 void S_SetEntitySpatialization( int entnum, const vec3_t origin, const vec3_t velocity );
+bool S_IsBufferInUse( const sfx_t *sfx );
 
 /*
 * Music
@@ -35,6 +35,7 @@ cvar_t *s_doppler;
 cvar_t *s_sound_velocity;
 cvar_t *s_stereo2mono;
 cvar_t *s_globalfocus;
+cvar_t *s_cachesize;
 
 static int s_registration_sequence = 1;
 static bool s_registering;
@@ -132,6 +133,7 @@ bool SF_Init( void *hwnd, int maxEntities, bool verbose )
 	s_sound_velocity = trap_Cvar_Get( "s_sound_velocity", "10976", CVAR_DEVELOPER );
 	s_stereo2mono = trap_Cvar_Get ( "s_stereo2mono", "0", CVAR_ARCHIVE );
 	s_globalfocus = trap_Cvar_Get( "s_globalfocus", "0", CVAR_ARCHIVE );
+	s_cachesize = trap_Cvar_Get( "s_cachesize", "32", CVAR_ARCHIVE );
 
 #ifdef ENABLE_PLAY
 	trap_Cmd_AddCommand( "play", SF_Play_f );
@@ -248,8 +250,8 @@ sfx_t *SF_RegisterSound( const char *name )
 
 	assert( name );
 
+	// the buffer is filled by the background thread the first time it's played
 	sfx = S_FindBuffer( name );
-	S_IssueLoadSfxCmd( s_cmdPipe, sfx->id );
 	sfx->used = trap_Milliseconds();
 	sfx->registration_sequence = s_registration_sequence;
 	return sfx;
@@ -435,8 +435,6 @@ void S_StartLocalSound( sfx_t *sfx )
 	if( !src )
 		return;
 
-	S_UseBuffer( sfx );
-
 	source_setup( src, sfx, SRCPRI_LOCAL, -1, S_CHANNEL_AUTO, 1.0, ATTN_NONE );
 	qalSourcei( src->source, AL_SOURCE_RELATIVE, AL_TRUE );
 
@@ -540,3 +538,17 @@ void S_StopAllSources( void )
 	for( i = 0; i < src_count; i++ )
 		source_kill( &srclist[i] );
 }
+
+/*
+* S_IsBufferInUse
+*/
+bool S_IsBufferInUse( const sfx_t *sfx )
+{
+	int i;
+
+	for( i = 0; i < src_count; i++ ) {
+		if( srclist[i].sfx == sfx )
+			return true;
+	}
+	return false;
+}
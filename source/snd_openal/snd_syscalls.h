@@ -171,6 +171,16 @@ static inline void trap_Sleep( unsigned int milliseconds )
 	SOUND_IMPORT.Sys_Sleep( milliseconds );
 }
 
+static inline void trap_Prof_Begin( const char *name )
+{
+	SOUND_IMPORT.Prof_Begin( name );
+}
+
+static inline void trap_Prof_End( void )
+{
+	SOUND_IMPORT.Prof_End();
+}
+
 static inline struct mempool_s *trap_MemAllocPool( const char *name, const char *filename, int fileline )
 {
 	return SOUND_IMPORT.Mem_AllocPool( name, filename, fileline );
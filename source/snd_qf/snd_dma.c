@@ -111,6 +111,8 @@ static void S_SoundList_f( void )
 			total += size;
 			if( sc->loopstart < sc->length )
 				Com_Printf( "L" );
+			else if( sfx->stream )
+				Com_Printf( "S" );
 			else
 				Com_Printf( " " );
 			Com_Printf( "(%2db) %6i : %s\n", sc->width*8, size, sfx->name );
@@ -124,6 +126,8 @@ static void S_SoundList_f( void )
 		}
 	}
 	Com_Printf( "Total resident: %i\n", total );
+
+	S_PrintSoundCacheStats();
 }
 
 /*
@@ -523,7 +527,7 @@ void S_IssuePlaysound( playsound_t *ps )
 		S_FreePlaysound( ps );
 		return;
 	}
-	sc = S_LoadSound( ps->sfx );
+	sc = ps->sfx->cache;
 	if( !sc )
 	{
 		S_FreePlaysound( ps );
@@ -735,7 +739,7 @@ static void S_AddLoopSounds( void )
 			continue;
 
 		sfx = loop_sfx[i].sfx;
-		sc = sfx->cache;
+		sc = sfx->cache ? sfx->cache : S_LoadSound( sfx );
 		if( !sc )
 			continue;
 
@@ -1281,9 +1285,11 @@ static void S_Update( void )
 	}
 
 	// mix some sound
+	trap_Prof_Begin( "s_paint" );
 	S_UpdateBackgroundTrack();
 
 	S_Update_();
+	trap_Prof_End();
 }
 
 /*
@@ -1436,10 +1442,7 @@ static unsigned S_HandleFreeSfxCmd( const sndCmdFreeSfx_t *cmd )
 	sfx_t *sfx;
 	//Com_Printf("S_HandleFreeSfxCmd\n");
 	sfx = known_sfx + cmd->sfx;
-	if( sfx->cache ) {
-		S_Free( sfx->cache );
-		sfx->cache = NULL;
-	}
+	S_FreeSound( sfx );
 	return sizeof( *cmd );
 }
 
@@ -46,6 +46,7 @@ typedef struct
 	unsigned int speed;              // not needed, because converted on load?
 	unsigned short channels;
 	unsigned short width;
+	unsigned int decoded;            // samples available to the mixer, less than length while streaming
 	uint8_t data[1];          // variable sized
 } sfxcache_t;
 
@@ -55,6 +56,8 @@ typedef struct sfx_s
 	int registration_sequence;
 	bool isUrl;
 	sfxcache_t *cache;
+	unsigned int used;			// paintedtime of the last request, for LRU eviction
+	void *stream;				// decoder state while the cache is being filled
 } sfx_t;
 
 typedef struct
@@ -210,6 +213,8 @@ void	SNDOGG_Init( bool verbose );
 void	SNDOGG_Shutdown( bool verbose );
 bool SNDOGG_OpenTrack( bgTrack_t *track, bool *delay );
 sfxcache_t *SNDOGG_Load( sfx_t *s );
+void	SNDOGG_Stream( sfx_t *s, unsigned int samples );
+void	SNDOGG_CloseStream( sfx_t *s );
 
 //====================================================================
 
@@ -221,6 +226,13 @@ sfxcache_t *SNDOGG_Load( sfx_t *s );
 extern sfx_t known_sfx[MAX_SFX];
 extern int num_sfx;
 
+// sounds are decoded on first use and evicted in LRU order once the
+// cache outgrows s_cachesize, except for short ones which stay resident
+#define S_RESIDENT_SECONDS	2
+// longer .ogg sounds are decoded a second at a time as they play
+#define S_STREAM_SECONDS	8
+#define S_MAX_STREAMS		8
+
 #define	MAX_CHANNELS		128
 extern channel_t channels[MAX_CHANNELS];
 
@@ -248,6 +260,7 @@ extern cvar_t *s_swapstereo;
 extern cvar_t *s_pseudoAcoustics;
 extern cvar_t *s_separationDelay;
 extern cvar_t *s_globalfocus;
+extern cvar_t *s_cachesize;
 
 extern struct mempool_s *soundpool;
 
@@ -266,6 +279,9 @@ unsigned int ResampleSfx( unsigned int numsamples, unsigned int speed, unsigned
 void S_InitScaletable( void );
 
 sfxcache_t *S_LoadSound( sfx_t *s );
+void S_FreeSound( sfx_t *s );
+void S_StreamSound( sfx_t *s, unsigned int samples );
+void S_PrintSoundCacheStats( void );
 
 void S_IssuePlaysound( playsound_t *ps );
 
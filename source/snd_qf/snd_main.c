@@ -47,6 +47,7 @@ cvar_t *s_swapstereo;
 cvar_t *s_pseudoAcoustics;
 cvar_t *s_separationDelay;
 cvar_t *s_globalfocus;
+cvar_t *s_cachesize;
 
 sfx_t known_sfx[MAX_SFX];
 int num_sfx;
@@ -195,23 +196,12 @@ void SF_BeginRegistration( void )
 sfx_t *SF_RegisterSound( const char *name )
 {
 	sfx_t *sfx;
-	int sfxnum;
 
 	assert( name );
 
+	// the sound is decoded by the background thread the first time it's played
 	sfx = SF_FindName( name );
-	if( sfx->registration_sequence != s_registration_sequence ) {
-		sfx->registration_sequence = s_registration_sequence;
-
-		// evenly balance the load between two threads during registration
-		sfxnum = sfx - known_sfx;
-		if( !s_registering || sfxnum & 1 ) {
-			S_IssueLoadSfxCmd( s_cmdPipe, sfxnum );
-		}
-		else {
-			S_LoadSound( sfx );
-		}
-	}
+	sfx->registration_sequence = s_registration_sequence;
 	return sfx;
 }
 
@@ -223,6 +213,15 @@ void SF_FreeSounds( void )
 	int i;
 	sfx_t *sfx;
 
+	// the cache belongs to the background thread
+	for( i = 0, sfx = known_sfx; i < num_sfx; i++, sfx++ )
+	{
+		if( !sfx->name[0] ) {
+			continue;
+		}
+		S_IssueFreeSfxCmd( s_cmdPipe, i );
+	}
+
 	// wait for the queue to be processed
 	S_FinishSoundCmdPipe( s_cmdPipe );
 
@@ -232,7 +231,6 @@ void SF_FreeSounds( void )
 		if( !sfx->name[0] ) {
 			continue;
 		}
-		S_Free( sfx->cache );
 		memset( sfx, 0, sizeof( *sfx ) );
 	}
 }
@@ -245,19 +243,28 @@ void SF_EndRegistration( void )
 	int i;
 	sfx_t *sfx;
 
+	s_registering = false;
+
+	// free any sounds not from this registration sequence, the
+	// cache belongs to the background thread
+	for( i = 0, sfx = known_sfx; i < num_sfx; i++, sfx++ ) {
+		if( !sfx->name[0] ) {
+			continue;
+		}
+		if( sfx->registration_sequence != s_registration_sequence ) {
+			S_IssueFreeSfxCmd( s_cmdPipe, i );
+		}
+	}
+
 	// wait for the queue to be processed
 	S_FinishSoundCmdPipe( s_cmdPipe );
 
-	s_registering = false;
-
-	// free any sounds not from this registration sequence
 	for( i = 0, sfx = known_sfx; i < num_sfx; i++, sfx++ ) {
 		if( !sfx->name[0] ) {
 			continue;
 		}
 		if( sfx->registration_sequence != s_registration_sequence ) {
 			// we don't need this sound
-			S_Free( sfx->cache );
 			memset( sfx, 0, sizeof( *sfx ) );
 		}
 	}
@@ -282,6 +289,7 @@ bool SF_Init( void *hwnd, int maxEntities, bool verbose )
 	s_pseudoAcoustics = trap_Cvar_Get( "s_pseudoAcoustics", "0", CVAR_ARCHIVE );
 	s_separationDelay = trap_Cvar_Get( "s_separationDelay", "1.0", CVAR_ARCHIVE );
 	s_globalfocus = trap_Cvar_Get( "s_globalfocus", "0", CVAR_ARCHIVE );
+	s_cachesize = trap_Cvar_Get( "s_cachesize", "32", CVAR_ARCHIVE );
 
 #ifdef ENABLE_PLAY
 	trap_Cmd_AddCommand( "play", SF_Play_f );
@@ -241,14 +241,14 @@ sfxcache_t *S_LoadSound_Wav( sfx_t *s )
 		return NULL;
 	}
 
-	if( sc->width == 2 ) {
+	if( info.width == 2 ) {
 		int i;
 		short *wdata;
 
 		wdata = ( short * )(data + info.dataofs);
-		len = sc->length * sc->channels;
+		len = info.samples * info.channels;
 		for( i = 0; i < len; i++ ) {
-			wdata[i] = LittleLong( wdata[i] );
+			wdata[i] = LittleShort( wdata[i] );
 		}
 	}
 
@@ -257,6 +257,7 @@ sfxcache_t *S_LoadSound_Wav( sfx_t *s )
 	sc->width = info.width;
 	sc->speed = dma.speed;
 	sc->loopstart = info.loopstart < 0 ? sc->length : info.loopstart * ((double)sc->length / (double)info.samples);
+	sc->decoded = sc->length;
 	s->cache = sc;
 
 	S_Free( data );
@@ -264,36 +265,185 @@ sfxcache_t *S_LoadSound_Wav( sfx_t *s )
 	return sc;
 }
 
+//=============================================================================
+
+static struct
+{
+	size_t size;			// bytes of decoded samples in memory
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int evictions;
+} s_cache;
+
+/*
+* S_SoundCacheSize
+*/
+static size_t S_SoundCacheSize( const sfxcache_t *sc )
+{
+	return (size_t)sc->length * sc->width * sc->channels;
+}
+
+/*
+* S_SoundInUse
+*
+* Returns true if the sound is playing on a channel or waiting to be started.
+*/
+static bool S_SoundInUse( const sfx_t *s )
+{
+	int i;
+	const playsound_t *ps;
+
+	for( i = 0; i < MAX_CHANNELS; i++ ) {
+		if( channels[i].sfx == s ) {
+			return true;
+		}
+	}
+
+	for( ps = s_pendingplays.next; ps != &s_pendingplays; ps = ps->next ) {
+		if( ps->sfx == s ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+* S_EvictSounds
+*
+* Frees the least recently used sounds until the cache fits into s_cachesize.
+*/
+static void S_EvictSounds( const sfx_t *keep )
+{
+	int i;
+	sfx_t *sfx, *best;
+	size_t budget;
+	const unsigned int resident = dma.speed * S_RESIDENT_SECONDS;
+
+	if( s_cachesize->value <= 0 ) {
+		return;
+	}
+
+	budget = (size_t)( s_cachesize->value * 1024 * 1024 );
+	while( s_cache.size > budget ) {
+		best = NULL;
+		for( i = 0, sfx = known_sfx; i < num_sfx; i++, sfx++ ) {
+			if( !sfx->cache || sfx == keep || sfx->cache->length < resident ) {
+				continue;
+			}
+			if( best && (int)( sfx->used - best->used ) >= 0 ) {
+				continue;
+			}
+			if( S_SoundInUse( sfx ) ) {
+				continue;
+			}
+			best = sfx;
+		}
+
+		if( !best ) {
+			break;
+		}
+
+		S_FreeSound( best );
+		s_cache.evictions++;
+	}
+}
+
+/*
+* S_FreeSound
+*/
+void S_FreeSound( sfx_t *s )
+{
+	if( s->stream ) {
+		SNDOGG_CloseStream( s );
+	}
+	if( s->cache ) {
+		s_cache.size -= S_SoundCacheSize( s->cache );
+		S_Free( s->cache );
+		s->cache = NULL;
+	}
+}
+
+/*
+* S_StreamSound
+*
+* Makes sure that the first samples of a streamed sound are decoded.
+*/
+void S_StreamSound( sfx_t *s, unsigned int samples )
+{
+	if( s->stream && s->cache && s->cache->decoded < samples ) {
+		SNDOGG_Stream( s, samples );
+	}
+}
+
 /*
 * S_LoadSound
 */
 sfxcache_t *S_LoadSound( sfx_t *s )
 {
 	const char *extension;
+	sfxcache_t *sc = NULL;
 
 	if( !s->name[0] )
 		return NULL;
 	if( s->isUrl )
 		return NULL;
 
+	s->used = paintedtime;
+
 	// see if still in memory
-	if( s->cache )
+	if( s->cache ) {
+		s_cache.hits++;
 		return s->cache;
+	}
+
+	s_cache.misses++;
 
 	extension = COM_FileExtension( s->name );
 	if( extension )
 	{
 		if( !Q_stricmp( extension, ".wav" ) )
 		{
-			return S_LoadSound_Wav( s );
+			sc = S_LoadSound_Wav( s );
 		}
-		if( !Q_stricmp( extension, ".ogg" ) )
+		else if( !Q_stricmp( extension, ".ogg" ) )
 		{
-			return SNDOGG_Load( s );
+			sc = SNDOGG_Load( s );
 		}
 	}
 
-	return NULL;
+	if( sc ) {
+		s_cache.size += S_SoundCacheSize( sc );
+		S_EvictSounds( s );
+	}
+
+	return sc;
+}
+
+/*
+* S_PrintSoundCacheStats
+*/
+void S_PrintSoundCacheStats( void )
+{
+	int i, numLoaded = 0, numStreams = 0;
+	unsigned int total = s_cache.hits + s_cache.misses;
+
+	for( i = 0; i < num_sfx; i++ ) {
+		if( known_sfx[i].cache ) {
+			numLoaded++;
+		}
+		if( known_sfx[i].stream ) {
+			numStreams++;
+		}
+	}
+
+	Com_Printf( "Sound cache: %i of %i sounds loaded, %i streaming, %.1f MB", 
+		numLoaded, num_sfx, numStreams, s_cache.size / ( 1024.0 * 1024.0 ) );
+	if( s_cachesize->value > 0 ) {
+		Com_Printf( " of %.1f MB", s_cachesize->value );
+	}
+	Com_Printf( "\n%u hits, %u misses (%.1f%% hit rate), %u evictions\n", 
+		s_cache.hits, s_cache.misses, total ? 100.0 * s_cache.hits / total : 0.0, s_cache.evictions );
 }
 
 
@@ -456,10 +456,15 @@ int S_PaintChannels( unsigned int endtime, int dumpfile, float gain )
 				if( ch->end < end )
 					count = ch->end > ltime ? ch->end - ltime : 0;
 
-				sc = S_LoadSound( ch->sfx );
+				// playing sounds are never evicted from the cache
+				sc = ch->sfx->cache;
 				if( !sc )
 					break;
 
+				// long sounds are decoded as they play
+				if( ch->pos + count > sc->decoded )
+					S_StreamSound( ch->sfx, ch->pos + count );
+
 				if( count > 0 && ch->sfx )
 				{
 					if( s_pseudoAcoustics->value )
@@ -151,16 +151,138 @@ static int SNDOGG_FRead( bgTrack_t *track, void *ptr, size_t size );
 static int SNDOGG_FSeek( bgTrack_t *track, int pos );
 static void SNDOGG_FClose( bgTrack_t *track );
 
+#ifdef ENDIAN_BIG
+#define OGG_BIGENDIAN 1
+#elif defined (ENDIAN_LITTLE)
+#define OGG_BIGENDIAN 0
+#else
+#error "runtime endianess detection support missing"
+#endif
+
+typedef struct
+{
+	OggVorbis_File vorbisfile;
+	int rate;
+	int channels;
+	unsigned int samples;		// source samples decoded so far
+	unsigned int total;			// source samples in the file
+	unsigned int chunk;			// source samples decoded at once
+	char *buffer;
+} sndogg_stream_t;
+
+static int s_numOggStreams;
+
+/*
+* SNDOGG_FreeStream
+*/
+static void SNDOGG_FreeStream( sfx_t *s )
+{
+	sndogg_stream_t *stream = s->stream;
+
+	qov_clear( &stream->vorbisfile ); // Does FS_FCloseFile
+	S_Free( stream->buffer );
+	S_Free( stream );
+	s->stream = NULL;
+}
+
+/*
+* SNDOGG_ReadChunk
+*
+* Decodes the next chunk of source samples and resamples it into the cache.
+*/
+static bool SNDOGG_ReadChunk( sfx_t *s )
+{
+	sndogg_stream_t *stream = s->stream;
+	sfxcache_t *sc = s->cache;
+	unsigned int samples, out;
+	int bitstream, bytes_read, bytes_read_total, len;
+
+	samples = min( stream->chunk, stream->total - stream->samples );
+	if( !samples ) {
+		return false;
+	}
+
+	len = samples * 2 * stream->channels;
+	bytes_read_total = 0;
+	do
+	{
+		bytes_read = qov_read( &stream->vorbisfile, stream->buffer+bytes_read_total, len-bytes_read_total, OGG_BIGENDIAN, 2, 1, &bitstream );
+		if( bytes_read > 0 ) {
+			bytes_read_total += bytes_read;
+		}
+	} while( bytes_read > 0 && bytes_read_total < len );
+
+	if( bytes_read_total != len )
+	{
+		Com_Printf( "Error reading .ogg file: %s\n", s->name );
+		return false;
+	}
+
+	// the sum of all chunks never exceeds the length computed in SNDOGG_Load
+	out = ResampleSfx( samples, stream->rate, sc->channels, 2, (uint8_t *)stream->buffer, 
+		sc->data + sc->decoded * 2 * sc->channels, s->name );
+	if( !out ) {
+		return false;
+	}
+
+	sc->decoded += out;
+	stream->samples += samples;
+	return true;
+}
+
+/*
+* SNDOGG_Stream
+*
+* Decodes the sound up to the given number of samples. The stream
+* is closed once the whole file has been decoded or on error, in
+* which case the rest is filled with silence.
+*/
+void SNDOGG_Stream( sfx_t *s, unsigned int samples )
+{
+	sfxcache_t *sc = s->cache;
+	sndogg_stream_t *stream = s->stream;
+
+	if( !stream ) {
+		return;
+	}
+
+	while( sc->decoded < samples ) {
+		if( !SNDOGG_ReadChunk( s ) ) {
+			break;
+		}
+	}
+
+	if( sc->decoded < samples || stream->samples >= stream->total ) {
+		memset( sc->data + sc->decoded * 2 * sc->channels, 0, ( sc->length - sc->decoded ) * 2 * sc->channels );
+		sc->decoded = sc->length;
+		SNDOGG_CloseStream( s );
+	}
+}
+
+/*
+* SNDOGG_CloseStream
+*/
+void SNDOGG_CloseStream( sfx_t *s )
+{
+	if( s->stream ) {
+		SNDOGG_FreeStream( s );
+		s_numOggStreams--;
+	}
+}
+
 /*
 * SNDOGG_Load
+*
+* Short sounds are decoded at once, long ones are streamed into the
+* cache a second at a time by SNDOGG_Stream as they are being played.
 */
 sfxcache_t *SNDOGG_Load( sfx_t *s )
 {
-	OggVorbis_File vorbisfile;
+	sndogg_stream_t *stream;
 	vorbis_info *vi;
 	sfxcache_t *sc;
-	char *buffer;
-	int filenum, bitstream, bytes_read, bytes_read_total, len, samples;
+	int filenum, len, samples;
+	bool streaming;
 	ov_callbacks callbacks = { ovcb_read, ovcb_seek, ovcb_close, ovcb_tell };
 
 	assert( s && s->name[0] );
@@ -175,92 +297,77 @@ sfxcache_t *SNDOGG_Load( sfx_t *s )
 	if( !filenum )
 		return NULL;
 
-	if( qov_open_callbacks( (void *)(intptr_t)filenum, &vorbisfile, NULL, 0, callbacks ) < 0 )
+	// OggVorbis_File can't be moved once opened
+	stream = S_Malloc( sizeof( *stream ) );
+	s->stream = stream;
+
+	if( qov_open_callbacks( (void *)(intptr_t)filenum, &stream->vorbisfile, NULL, 0, callbacks ) < 0 )
 	{
-		Com_Printf( "Couldn't open %s for reading: %s\n", s->name );
+		Com_Printf( "Couldn't open %s for reading\n", s->name );
 		trap_FS_FCloseFile( filenum );
+		S_Free( stream );
+		s->stream = NULL;
 		return NULL;
 	}
 
-	if( callbacks.seek_func && !qov_seekable( &vorbisfile ) )
+	if( callbacks.seek_func && !qov_seekable( &stream->vorbisfile ) )
 	{
 		Com_Printf( "Error unsupported .ogg file (not seekable): %s\n", s->name );
-		qov_clear( &vorbisfile ); // Does FS_FCloseFile
+		SNDOGG_FreeStream( s );
 		return NULL;
 	}
 
-	if( qov_streams( &vorbisfile ) != 1 )
+	if( qov_streams( &stream->vorbisfile ) != 1 )
 	{
 		Com_Printf( "Error unsupported .ogg file (multiple logical bitstreams): %s\n", s->name );
-		qov_clear( &vorbisfile ); // Does FS_FCloseFile
+		SNDOGG_FreeStream( s );
 		return NULL;
 	}
 
-	vi = qov_info( &vorbisfile, -1 );
+	vi = qov_info( &stream->vorbisfile, -1 );
 	if( vi->channels != 1 && vi->channels != 2 )
 	{
 		Com_Printf( "Error unsupported .ogg file (unsupported number of channels: %i): %s\n", vi->channels, s->name );
-		qov_clear( &vorbisfile ); // Does FS_FCloseFile
+		SNDOGG_FreeStream( s );
 		return NULL;
 	}
 
-	samples = (int)qov_pcm_total( &vorbisfile, -1 );
+	samples = (int)qov_pcm_total( &stream->vorbisfile, -1 );
+	streaming = samples > vi->rate * S_STREAM_SECONDS && s_numOggStreams < S_MAX_STREAMS;
+
+	stream->rate = vi->rate;
+	stream->channels = vi->channels;
+	stream->total = samples;
+	stream->chunk = streaming ? vi->rate : samples;
+	stream->buffer = S_Malloc( stream->chunk * 2 * vi->channels );
+	s_numOggStreams++;
+
 	len = (int) ( (double) samples * (double) dma.speed / (double) vi->rate );
-	len = len * 2 * vi->channels;
 
-	sc = s->cache = S_Malloc( len + sizeof( sfxcache_t ) );
-	sc->length = samples;
+	sc = s->cache = S_Malloc( len * 2 * vi->channels + sizeof( sfxcache_t ) );
+	sc->length = len;
 	sc->loopstart = sc->length;
-	sc->speed = vi->rate;
+	sc->speed = dma.speed;
 	sc->channels = vi->channels;
 	sc->width = 2;
+	sc->decoded = 0;
+
+	if( !streaming ) {
+		if( !SNDOGG_ReadChunk( s ) ) {
+			SNDOGG_CloseStream( s );
+			S_Free( sc );
+			s->cache = NULL;
+			return NULL;
+		}
 
-	if( sc->speed != dma.speed )
-	{
-		len = samples * 2 * vi->channels;
-		buffer = S_Malloc( len );
-	}
-	else
-	{
-		buffer = (char *)sc->data;
-	}
-
-	bytes_read = bytes_read_total = 0;
-	do
-	{
-		bytes_read_total += bytes_read;
-
-#ifdef ENDIAN_BIG
-		bytes_read = qov_read( &vorbisfile, buffer+bytes_read_total, len-bytes_read_total, 1, 2, 1, &bitstream );
-#elif defined (ENDIAN_LITTLE)
-		bytes_read = qov_read( &vorbisfile, buffer+bytes_read_total, len-bytes_read_total, 0, 2, 1, &bitstream );
-#else
-#error "runtime endianess detection support missing"
-#endif
-	} while( bytes_read > 0 && bytes_read_total < len );
-
-	qov_clear( &vorbisfile ); // Does FS_FCloseFile and also kills vorbis_info vi*
-
-	if( bytes_read_total != len )
-	{
-		Com_Printf( "Error reading .ogg file: %s\n", s->name );
-		if( (void *)buffer != sc->data )
-			S_Free( buffer );
-		S_Free( sc );
-		s->cache = NULL;
-		return NULL;
-	}
-
-	if( sc->speed != dma.speed ) {
-		sc->length = ResampleSfx( samples, sc->speed, sc->channels, 2, (uint8_t *)buffer, sc->data, s->name );
-		sc->loopstart = sc->length;
-		sc->speed = dma.speed;
-	}
-
-	if( (void *)buffer != sc->data ) {
-		S_Free( buffer );
+		// the resampler may round the length down
+		sc->length = sc->loopstart = sc->decoded;
+		SNDOGG_CloseStream( s );
+		return sc;
 	}
 
+	// decode the first second so that the sound can start right away
+	SNDOGG_Stream( s, 1 );
 	return sc;
 }
 
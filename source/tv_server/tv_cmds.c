@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "tv_upstream.h"
 #include "tv_upstream_demos.h"
+#include "tv_relay_threads.h"
 
 static char *TV_ConnstateToString( connstate_t state )
 {
@@ -502,6 +503,8 @@ static cmd_function_t cmdlist[] =
 
 	{ "music", TV_Music_f },
 
+	{ "relaystats", TV_RelayThreads_Stats_f },
+
 	{ NULL, NULL }
 };
 
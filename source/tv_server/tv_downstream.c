@@ -87,6 +87,24 @@ void TV_Downstream_AddGameCommand( relay_t *relay, client_t *client, const char
 	}
 }
 
+/*
+* TV_Downstream_BroadcastGameCommand
+* 
+* Sends the game command to all spawned clients, no matter which relay they watch
+*/
+void TV_Downstream_BroadcastGameCommand( const char *cmd )
+{
+	int i;
+	client_t *client;
+
+	for( i = 0, client = tvs.clients; i < tv_maxclients->integer; i++, client++ )
+	{
+		if( client->state != CS_SPAWNED )
+			continue;
+		TV_Downstream_AddGameCommand( client->relay, client, cmd );
+	}
+}
+
 /*
 * TV_Downstream_Msg
 * 
@@ -31,6 +31,7 @@ void TV_Downstream_ClientResetCommandBuffers( client_t *client, bool resetReliab
 char *TV_Downstream_FixName( const char *orginal_name, client_t *client );
 bool TV_Downstream_ChangeStream( client_t *client, relay_t *relay );
 void TV_Downstream_AddGameCommand( relay_t *relay, client_t *client, const char *cmd );
+void TV_Downstream_BroadcastGameCommand( const char *cmd );
 void TV_Downstream_UserinfoChanged( client_t *cl );
 void TV_Downstream_AddServerCommand( client_t *client, const char *cmd );
 void TV_Downstream_SendServerCommand( client_t *cl, const char *format, ... );
@@ -254,6 +254,7 @@ extern cvar_t *tv_reconnectlimit;
 extern cvar_t *tv_public;
 extern cvar_t *tv_autorecord;
 extern cvar_t *tv_lobbymusic;
+extern cvar_t *tv_relaythreads;
 
 extern cvar_t *tv_masterservers;
 extern cvar_t *tv_masterservers_steam;
@@ -26,6 +26,7 @@
 #include "tv_cmds.h"
 #include "tv_downstream.h"
 #include "tv_lobby.h"
+#include "tv_relay_threads.h"
 
 tv_t tvs;
 
@@ -46,6 +47,7 @@ cvar_t *tv_tcp;
 cvar_t *tv_public;
 cvar_t *tv_autorecord;
 cvar_t *tv_lobbymusic;
+cvar_t *tv_relaythreads;
 
 cvar_t *tv_timeout;
 cvar_t *tv_zombietime;
@@ -107,6 +109,7 @@ void TV_Init( void )
 	tv_rcon_password = Cvar_Get( "tv_rcon_password", "", 0 );
 	tv_autorecord = Cvar_Get( "tv_autorecord", "", CVAR_ARCHIVE );
 	tv_lobbymusic = Cvar_Get( "tv_lobbymusic", "", CVAR_ARCHIVE );
+	tv_relaythreads = Cvar_Get( "tv_relaythreads", "0", CVAR_ARCHIVE | CVAR_NOSET );
 
 	tv_masterservers = Cvar_Get( "tv_masterservers", DEFAULT_MASTER_SERVERS_IPS, CVAR_LATCH );
 	tv_masterservers_steam = Cvar_Get( "tv_masterservers_steam", DEFAULT_MASTER_SERVERS_STEAM_IPS, CVAR_LATCH );
@@ -209,6 +212,8 @@ void TV_Init( void )
 #endif
 
 	TV_Downstream_InitMaster();
+
+	TV_RelayThreads_Init();
 }
 
 /*
@@ -216,23 +221,11 @@ void TV_Init( void )
 */
 void TV_Frame( int realmsec, int gamemsec )
 {
-	int i;
-
 	tvs.realtime += realmsec;
 
 	TV_Lobby_Run();
 
-	for( i = 0; i < tvs.numupstreams; i++ )
-	{
-		if( !tvs.upstreams[i] )
-			continue;
-
-		if( userinfo_modified )
-			tvs.upstreams[i]->userinfo_modified = true;
-
-		TV_Upstream_Run( tvs.upstreams[i], realmsec );
-	}
-	userinfo_modified = false;
+	TV_RelayThreads_Run( realmsec );
 
 	TV_Downstream_ReadPackets();
 	TV_Downstream_SendClientMessages();
@@ -255,6 +248,8 @@ void TV_Shutdown( const char *finalmsg )
 
 	TV_Downstream_MasterSendQuit();
 
+	TV_RelayThreads_Shutdown();
+
 	for( i = 0; i < tvs.numupstreams; i++ )
 	{
 		if( !tvs.upstreams[i] )
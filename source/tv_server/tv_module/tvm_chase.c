@@ -81,9 +81,9 @@ static int TVM_Chase_FindFollowPOV( edict_t *ent )
 	int newpov = -1;
 	tvm_relay_t *relay = ent->relay;
 	edict_t *target;
-	static int ctfpov = -1, poweruppov = -1;
-	static unsigned int flagswitchTime = 0;
-	static unsigned int pwupswitchTime = 0;
+	static ATTRIBUTE_TLS int ctfpov = -1, poweruppov = -1;
+	static ATTRIBUTE_TLS unsigned int flagswitchTime = 0;
+	static ATTRIBUTE_TLS unsigned int pwupswitchTime = 0;
 #define CARRIERSWITCHDELAY 8000
 
 	if( !ent->r.client || !ent->r.client->chase.active || !ent->r.client->chase.followmode )
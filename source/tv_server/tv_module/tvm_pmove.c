@@ -35,8 +35,9 @@ typedef struct
 	float forwardPush, sidePush, upPush;
 } pml_t;
 
-pmove_t	*pm;
-pml_t pml;
+// relays may run on several threads at once
+static ATTRIBUTE_TLS pmove_t *pm;
+static ATTRIBUTE_TLS pml_t pml;
 
 vec3_t playerbox_stand_mins = { -16, -16, -24 };
 vec3_t playerbox_stand_maxs = { 16, 16, 40 };
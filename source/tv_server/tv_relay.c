@@ -27,11 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "tv_relay_module.h"
 #include "tv_relay_client.h"
 #include "tv_downstream.h"
-
-#include <setjmp.h>
-
-// for jumping over relay handling when it's disconnected
-jmp_buf relay_abortframe;
+#include "tv_relay_threads.h"
 
 /*
 * TV_Relay_RunSnap
@@ -172,7 +168,7 @@ void TV_Relay_Error( relay_t *relay, const char *format, ... )
 	va_end( argptr );
 
 	TV_Relay_Shutdown( relay, "%s", msg );
-	longjmp( relay_abortframe, -1 );
+	longjmp( relay->abortframe, -1 );
 }
 
 /*
@@ -216,13 +212,9 @@ void TV_Relay_Shutdown( relay_t *relay, const char *format, ... )
 
 		Q_snprintfz( cmd, sizeof( cmd ), "chr %i", i+1 );
 
-		for( i = 0, client = tvs.clients; i < tv_maxclients->integer; i++, client++ )
-		{
-			if( client->state != CS_SPAWNED )
-				continue;
-
-			TV_Downstream_AddGameCommand( client->relay, client, cmd );
-		}
+		// clients of other relays may be owned by other threads
+		if( !TV_RelayThreads_DeferGameCommand( relay, cmd ) )
+			TV_Downstream_BroadcastGameCommand( cmd );
 	}
 
 	if( relay->module_export )
@@ -327,14 +319,9 @@ void TV_Relay_NameNotify( relay_t *relay, client_t *client )
 	}
 	else
 	{
-		int i;
-
-		for( i = 0, client = tvs.clients; i < tv_maxclients->integer; i++, client++ )
-		{
-			if( client->state != CS_SPAWNED )
-				continue;
-			TV_Downstream_AddGameCommand( client->relay, client, cmd );
-		}
+		// clients of other relays may be owned by other threads
+		if( !TV_RelayThreads_DeferGameCommand( relay, cmd ) )
+			TV_Downstream_BroadcastGameCommand( cmd );
 	}
 }
 
@@ -389,7 +376,7 @@ void TV_Relay_Run( relay_t *relay, int msec )
 {
 	relay->realtime += msec;
 
-	if( setjmp( relay_abortframe ) )  // disconnect while running
+	if( setjmp( relay->abortframe ) )  // disconnect while running
 		return;
 
 	relay->serverTime = relay->realtime + relay->serverTimeDelta;
@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "tv_local.h"
 
+#include <setjmp.h>
+
 #define EDICT_NUM( u, n ) ( (edict_t *)( (uint8_t *)u->gi.edicts + u->gi.edict_size*( n ) ) )
 #define NUM_FOR_EDICT( u, e ) ( ( (uint8_t *)( e )-(uint8_t *)u->gi.edicts ) / u->gi.edict_size )
 
@@ -114,6 +116,17 @@ struct relay_s
 	unsigned map_checksum;
 	int sv_bitflags;
 	purelist_t *purelist;
+
+	// for jumping over relay handling when it's disconnected
+	jmp_buf abortframe;
+
+	// frame timing, reset by the relaystats command
+	struct {
+		unsigned int frames;
+		uint64_t time;              // microseconds
+		uint64_t maxtime;
+		uint64_t lasttime;
+	} stats;
 };
 
 void TV_Relay_Init( relay_t *relay, upstream_t *upstream, int delay );
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "tv_upstream.h"
 #include "tv_relay.h"
 #include "tv_downstream.h"
+#include "tv_relay_threads.h"
 
 typedef struct tv_module_s tv_module_t;
 
@@ -576,7 +577,7 @@ tv_module_t *TV_GetModule( const char *game )
 	iter->import.Cmd_AddCommand = Cmd_AddCommand;
 	iter->import.Cmd_RemoveCommand = Cmd_RemoveCommand;
 
-	iter->import.AddCommandString = Cbuf_AddText;
+	iter->import.AddCommandString = TV_RelayThreads_AddCommandString;
 
 	iter->import.DropClient = TV_Module_DropClient;
 	iter->import.GetClientState = TV_Module_GetClientState;
@@ -0,0 +1,547 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// tv_relay_threads.c -- runs upstreams and their relays on worker threads
+//
+// Every upstream is assigned to a worker by its number. Each frame the main
+// thread posts a run command to all workers and waits for them to finish
+// (the lobby, OOB packets and downstream reads stay on the main thread).
+// Anything a relay wants to do to clients of other relays, or to the command
+// buffer, is queued by the worker and executed by the main thread once all
+// workers are done. The main thread doesn't drain the queues while it waits,
+// so commands that don't fit go to a per-worker overflow list instead of
+// blocking. The command tokenizer, va() and the pmove state of the TV module
+// are thread-local, so relays can parse commands and run module frames at the
+// same time.
+
+#include "tv_local.h"
+
+#include "tv_relay_threads.h"
+
+#include "tv_upstream.h"
+#include "tv_downstream.h"
+
+#define TV_RELAYTHREAD_CMDS_BUFSIZE		0x1000
+#define TV_RELAYTHREAD_MAINCMDS_BUFSIZE	0x40000
+
+#define TV_RELAYTHREAD_WAIT_MSEC		1000
+
+#define MAX_RELAY_THREADS				32
+
+typedef unsigned (*relayThreadCmdHandler_t)( const void * );
+
+// a main thread command that didn't fit in the queue
+typedef struct tv_relaythread_overflow_s
+{
+	struct tv_relaythread_overflow_s *next;
+	uint8_t cmd[1];
+} tv_relaythread_overflow_t;
+
+typedef struct tv_relaythread_s
+{
+	int number;
+	qthread_t *thread;
+	qbufPipe_t *cmdQueue;           // main thread -> worker
+	qbufPipe_t *mainQueue;          // worker -> main thread, drained after each frame
+	tv_relaythread_overflow_t *overflow, *overflowTail;
+	unsigned int numOverflowed;
+
+	unsigned int frames;
+	uint64_t time;                  // microseconds spent running upstreams
+	uint64_t maxtime;
+} tv_relaythread_t;
+
+enum
+{
+	TV_RELAYTHREAD_CMD_RUN,
+	TV_RELAYTHREAD_CMD_SHUTDOWN,
+
+	TV_RELAYTHREAD_CMD_NUM_CMDS
+};
+
+typedef struct
+{
+	int id;
+	tv_relaythread_t *thread;
+	int msec;
+} relayThreadCmdRun_t;
+
+typedef struct
+{
+	int id;
+} relayThreadCmdShutdown_t;
+
+enum
+{
+	TV_RELAYTHREAD_MAINCMD_GAMECMD,
+	TV_RELAYTHREAD_MAINCMD_CBUF,
+	TV_RELAYTHREAD_MAINCMD_RESCAN,
+
+	TV_RELAYTHREAD_MAINCMD_NUM_CMDS
+};
+
+typedef struct
+{
+	int id;
+	char cmd[MAX_STRING_CHARS];
+} relayThreadMainCmdGameCmd_t;
+
+typedef struct
+{
+	int id;
+	char text[MAX_STRING_CHARS];
+} relayThreadMainCmdCbuf_t;
+
+typedef struct
+{
+	int id;
+} relayThreadMainCmdRescan_t;
+
+static int num_relaythreads;
+static tv_relaythread_t relaythreads[MAX_RELAY_THREADS];
+
+// the worker the calling thread is, NULL on the main thread
+static ATTRIBUTE_TLS tv_relaythread_t *relaythread_self;
+
+// a worker asked for a file system rescan, done once the frame is over
+static bool relaythreads_rescan;
+
+// set while the workers are running, the rest of the state is owned by them
+static volatile bool relaythreads_running;
+
+/*
+* TV_RelayThreads_RunUpstream
+*/
+static void TV_RelayThreads_RunUpstream( upstream_t *upstream, int msec )
+{
+	relay_t *relay = &upstream->relay;
+	uint64_t start, time;
+
+	start = Sys_Microseconds();
+
+	TV_Upstream_Run( upstream, msec );
+
+	time = Sys_Microseconds() - start;
+	relay->stats.frames++;
+	relay->stats.time += time;
+	relay->stats.lasttime = time;
+	if( time > relay->stats.maxtime )
+		relay->stats.maxtime = time;
+}
+
+/*
+* TV_RelayThread_HandleRunCmd
+*/
+static unsigned TV_RelayThread_HandleRunCmd( const relayThreadCmdRun_t *cmd )
+{
+	int i;
+	uint64_t start, time;
+	tv_relaythread_t *thread = cmd->thread;
+
+	start = Sys_Microseconds();
+
+	for( i = 0; i < tvs.numupstreams; i++ )
+	{
+		upstream_t *upstream = tvs.upstreams[i];
+
+		if( !upstream )
+			continue;
+		if( upstream->number % num_relaythreads != thread->number )
+			continue;
+
+		TV_RelayThreads_RunUpstream( upstream, cmd->msec );
+	}
+
+	time = Sys_Microseconds() - start;
+	thread->frames++;
+	thread->time += time;
+	if( time > thread->maxtime )
+		thread->maxtime = time;
+
+	return sizeof( *cmd );
+}
+
+/*
+* TV_RelayThread_HandleShutdownCmd
+*/
+static unsigned TV_RelayThread_HandleShutdownCmd( const relayThreadCmdShutdown_t *cmd )
+{
+	return 0;
+}
+
+static relayThreadCmdHandler_t relayThreadCmdHandlers[TV_RELAYTHREAD_CMD_NUM_CMDS] =
+{
+	/* TV_RELAYTHREAD_CMD_RUN */
+	(relayThreadCmdHandler_t)TV_RelayThread_HandleRunCmd,
+	/* TV_RELAYTHREAD_CMD_SHUTDOWN */
+	(relayThreadCmdHandler_t)TV_RelayThread_HandleShutdownCmd,
+};
+
+/*
+* TV_RelayThread_HandleGameCmd
+*/
+static unsigned TV_RelayThread_HandleGameCmd( const relayThreadMainCmdGameCmd_t *cmd )
+{
+	TV_Downstream_BroadcastGameCommand( cmd->cmd );
+	return sizeof( *cmd );
+}
+
+/*
+* TV_RelayThread_HandleCbufCmd
+*/
+static unsigned TV_RelayThread_HandleCbufCmd( const relayThreadMainCmdCbuf_t *cmd )
+{
+	Cbuf_AddText( cmd->text );
+	return sizeof( *cmd );
+}
+
+/*
+* TV_RelayThread_HandleRescanCmd
+*/
+static unsigned TV_RelayThread_HandleRescanCmd( const relayThreadMainCmdRescan_t *cmd )
+{
+	relaythreads_rescan = true;
+	return sizeof( *cmd );
+}
+
+static relayThreadCmdHandler_t relayThreadMainCmdHandlers[TV_RELAYTHREAD_MAINCMD_NUM_CMDS] =
+{
+	/* TV_RELAYTHREAD_MAINCMD_GAMECMD */
+	(relayThreadCmdHandler_t)TV_RelayThread_HandleGameCmd,
+	/* TV_RELAYTHREAD_MAINCMD_CBUF */
+	(relayThreadCmdHandler_t)TV_RelayThread_HandleCbufCmd,
+	/* TV_RELAYTHREAD_MAINCMD_RESCAN */
+	(relayThreadCmdHandler_t)TV_RelayThread_HandleRescanCmd,
+};
+
+/*
+* TV_RelayThread_WriteMainCmd
+* 
+* Queues a command for the main thread. The main thread only reads the queue once
+* all workers are done, so waiting for room would never end. Commands that don't
+* fit are kept in order on the overflow list.
+*/
+static void TV_RelayThread_WriteMainCmd( tv_relaythread_t *thread, const void *cmd, size_t cmd_size )
+{
+	tv_relaythread_overflow_t *overflow;
+
+	if( !thread->overflow && QBufPipe_TryWriteCmd( thread->mainQueue, cmd, cmd_size ) )
+		return;
+
+	overflow = Mem_Alloc( tv_mempool, sizeof( *overflow ) + cmd_size );
+	memcpy( overflow->cmd, cmd, cmd_size );
+	if( thread->overflowTail )
+		thread->overflowTail->next = overflow;
+	else
+		thread->overflow = overflow;
+	thread->overflowTail = overflow;
+	thread->numOverflowed++;
+}
+
+/*
+* TV_RelayThread_ReadMainCmds
+*/
+static void TV_RelayThread_ReadMainCmds( tv_relaythread_t *thread )
+{
+	tv_relaythread_overflow_t *overflow, *next;
+
+	QBufPipe_ReadCmds( thread->mainQueue, relayThreadMainCmdHandlers );
+
+	if( !thread->overflow )
+		return;
+
+	Com_DPrintf( "Relay thread %i: %u commands didn't fit in the queue\n", thread->number, thread->numOverflowed );
+
+	for( overflow = thread->overflow; overflow; overflow = next )
+	{
+		next = overflow->next;
+		relayThreadMainCmdHandlers[*(int *)overflow->cmd]( overflow->cmd );
+		Mem_Free( overflow );
+	}
+
+	thread->overflow = thread->overflowTail = NULL;
+	thread->numOverflowed = 0;
+}
+
+/*
+* TV_RelayThread_CmdsWaiter
+*/
+static int TV_RelayThread_CmdsWaiter( qbufPipe_t *queue, relayThreadCmdHandler_t *cmdHandlers, bool timeout )
+{
+	return QBufPipe_ReadCmds( queue, cmdHandlers );
+}
+
+/*
+* TV_RelayThread_Proc
+*/
+static void *TV_RelayThread_Proc( void *param )
+{
+	tv_relaythread_t *thread = param;
+
+	relaythread_self = thread;
+
+	QBufPipe_Wait( thread->cmdQueue, TV_RelayThread_CmdsWaiter, relayThreadCmdHandlers, TV_RELAYTHREAD_WAIT_MSEC );
+
+	Cmd_ThreadShutdown();
+
+	return NULL;
+}
+
+/*
+* TV_RelayThreads_DeferGameCommand
+* 
+* Queues a game command for all spawned clients when called from a worker,
+* returns false if the caller is free to broadcast it right away
+*/
+bool TV_RelayThreads_DeferGameCommand( relay_t *relay, const char *cmd )
+{
+	relayThreadMainCmdGameCmd_t gcmd;
+	tv_relaythread_t *thread;
+
+	assert( relay && relay->upstream );
+
+	if( !relaythreads_running )
+		return false;
+
+	thread = &relaythreads[relay->upstream->number % num_relaythreads];
+
+	gcmd.id = TV_RELAYTHREAD_MAINCMD_GAMECMD;
+	Q_strncpyz( gcmd.cmd, cmd, sizeof( gcmd.cmd ) );
+	TV_RelayThread_WriteMainCmd( thread, &gcmd, sizeof( gcmd ) );
+	return true;
+}
+
+/*
+* TV_RelayThreads_AddCommandString
+* 
+* The command buffer belongs to the main thread, workers queue the text for it
+*/
+void TV_RelayThreads_AddCommandString( const char *text )
+{
+	relayThreadMainCmdCbuf_t cmd;
+
+	if( !relaythread_self )
+	{
+		Cbuf_AddText( text );
+		return;
+	}
+
+	cmd.id = TV_RELAYTHREAD_MAINCMD_CBUF;
+	Q_strncpyz( cmd.text, text, sizeof( cmd.text ) );
+	TV_RelayThread_WriteMainCmd( relaythread_self, &cmd, sizeof( cmd ) );
+}
+
+/*
+* TV_RelayThreads_ExecuteCommandBuffer
+* 
+* Workers leave the command buffer to the main thread, which executes it every frame
+*/
+void TV_RelayThreads_ExecuteCommandBuffer( void )
+{
+	if( !relaythread_self )
+		Cbuf_Execute();
+}
+
+/*
+* TV_RelayThreads_Rescan
+* 
+* Other workers may be reading files, so they leave the rescan to the main thread
+* at the end of the frame. The upstream goes on with the paks it already has.
+*/
+void TV_RelayThreads_Rescan( void )
+{
+	relayThreadMainCmdRescan_t cmd;
+
+	if( !relaythread_self )
+	{
+		FS_Rescan();
+		return;
+	}
+
+	cmd.id = TV_RELAYTHREAD_MAINCMD_RESCAN;
+	TV_RelayThread_WriteMainCmd( relaythread_self, &cmd, sizeof( cmd ) );
+}
+
+/*
+* TV_RelayThreads_Run
+*/
+void TV_RelayThreads_Run( int msec )
+{
+	int i;
+	upstream_t *upstream;
+
+	for( i = 0; i < tvs.numupstreams; i++ )
+	{
+		if( tvs.upstreams[i] && userinfo_modified )
+			tvs.upstreams[i]->userinfo_modified = true;
+	}
+	userinfo_modified = false;
+
+	if( !num_relaythreads )
+	{
+		for( i = 0; i < tvs.numupstreams; i++ )
+		{
+			if( tvs.upstreams[i] )
+				TV_RelayThreads_RunUpstream( tvs.upstreams[i], msec );
+		}
+	}
+	else
+	{
+		relayThreadCmdRun_t cmd;
+
+		relaythreads_running = true;
+
+		cmd.id = TV_RELAYTHREAD_CMD_RUN;
+		cmd.msec = msec;
+		for( i = 0; i < num_relaythreads; i++ )
+		{
+			cmd.thread = &relaythreads[i];
+			QBufPipe_WriteCmd( relaythreads[i].cmdQueue, &cmd, sizeof( cmd ) );
+		}
+
+		for( i = 0; i < num_relaythreads; i++ )
+			QBufPipe_Finish( relaythreads[i].cmdQueue );
+
+		relaythreads_running = false;
+
+		for( i = 0; i < num_relaythreads; i++ )
+			TV_RelayThread_ReadMainCmds( &relaythreads[i] );
+
+		if( relaythreads_rescan )
+		{
+			FS_Rescan();
+			relaythreads_rescan = false;
+		}
+	}
+
+	// upstreams are removed from the main thread only
+	for( i = 0; i < tvs.numupstreams; i++ )
+	{
+		upstream = tvs.upstreams[i];
+		if( upstream && upstream->relay.state == CA_UNINITIALIZED )
+			TV_Upstream_Shutdown( upstream, "Relay was shutdown" );
+	}
+}
+
+/*
+* TV_RelayThreads_Stats_f
+*/
+void TV_RelayThreads_Stats_f( void )
+{
+	int i;
+	upstream_t *upstream;
+	relay_t *relay;
+
+	Com_Printf( "num thr frames   avg(us)  max(us) last(us) name\n" );
+	Com_Printf( "--- --- ------ -------- -------- -------- ---------------\n" );
+	for( i = 0; i < tvs.numupstreams; i++ )
+	{
+		upstream = tvs.upstreams[i];
+		if( !upstream )
+			continue;
+
+		relay = &upstream->relay;
+		Com_Printf( "%3i %3i %6u %8u %8u %8u %s\n", upstream->number + 1,
+			num_relaythreads ? upstream->number % num_relaythreads : 0, relay->stats.frames,
+			relay->stats.frames ? (unsigned)( relay->stats.time / relay->stats.frames ) : 0,
+			(unsigned)relay->stats.maxtime, (unsigned)relay->stats.lasttime, upstream->name );
+
+		relay->stats.frames = 0;
+		relay->stats.time = relay->stats.maxtime = 0;
+	}
+
+	if( !num_relaythreads )
+	{
+		Com_Printf( "All relays run on the main thread\n" );
+		return;
+	}
+
+	Com_Printf( "\nthr frames   avg(us)  max(us)\n" );
+	Com_Printf( "--- ------ -------- --------\n" );
+	for( i = 0; i < num_relaythreads; i++ )
+	{
+		tv_relaythread_t *thread = &relaythreads[i];
+
+		Com_Printf( "%3i %6u %8u %8u\n", i, thread->frames,
+			thread->frames ? (unsigned)( thread->time / thread->frames ) : 0, (unsigned)thread->maxtime );
+
+		thread->frames = 0;
+		thread->time = thread->maxtime = 0;
+	}
+}
+
+/*
+* TV_RelayThreads_Init
+*/
+void TV_RelayThreads_Init( void )
+{
+	int i;
+
+	num_relaythreads = bound( 0, tv_relaythreads->integer, MAX_RELAY_THREADS );
+	if( !num_relaythreads )
+		return;
+
+	for( i = 0; i < num_relaythreads; i++ )
+	{
+		tv_relaythread_t *thread = &relaythreads[i];
+
+		memset( thread, 0, sizeof( *thread ) );
+		thread->number = i;
+		thread->cmdQueue = QBufPipe_Create( TV_RELAYTHREAD_CMDS_BUFSIZE, 1 );
+		thread->mainQueue = QBufPipe_Create( TV_RELAYTHREAD_MAINCMDS_BUFSIZE, 0 );
+		thread->thread = QThread_Create( TV_RelayThread_Proc, thread );
+	}
+
+	Com_Printf( "Running relays on %i threads\n", num_relaythreads );
+}
+
+/*
+* TV_RelayThreads_Shutdown
+*/
+void TV_RelayThreads_Shutdown( void )
+{
+	int i;
+	relayThreadCmdShutdown_t cmd;
+
+	cmd.id = TV_RELAYTHREAD_CMD_SHUTDOWN;
+
+	for( i = 0; i < num_relaythreads; i++ )
+	{
+		tv_relaythread_t *thread = &relaythreads[i];
+
+		QBufPipe_WriteCmd( thread->cmdQueue, &cmd, sizeof( cmd ) );
+		QBufPipe_Finish( thread->cmdQueue );
+		QThread_Join( thread->thread );
+
+		while( thread->overflow )
+		{
+			tv_relaythread_overflow_t *next = thread->overflow->next;
+			Mem_Free( thread->overflow );
+			thread->overflow = next;
+		}
+
+		QBufPipe_Destroy( &thread->cmdQueue );
+		QBufPipe_Destroy( &thread->mainQueue );
+	}
+
+	relaythreads_rescan = false;
+
+	num_relaythreads = 0;
+}
@@ -0,0 +1,37 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef __TV_RELAY_THREADS_H
+#define __TV_RELAY_THREADS_H
+
+#include "tv_local.h"
+
+#include "tv_relay.h"
+
+void TV_RelayThreads_Init( void );
+void TV_RelayThreads_Shutdown( void );
+void TV_RelayThreads_Run( int msec );
+bool TV_RelayThreads_DeferGameCommand( relay_t *relay, const char *cmd );
+void TV_RelayThreads_AddCommandString( const char *text );
+void TV_RelayThreads_ExecuteCommandBuffer( void );
+void TV_RelayThreads_Rescan( void );
+void TV_RelayThreads_Stats_f( void );
+
+#endif // __TV_RELAY_THREADS_H
@@ -27,11 +27,6 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "tv_upstream_demos.h"
 #include "tv_downstream.h"
 
-#include <setjmp.h>
-
-// for jumping over upstream handling when it's disconnected
-jmp_buf upstream_abortframe;
-
 /*
 * TV_UpstreamForText
 * Finds relay upstream matching given text
@@ -433,9 +428,8 @@ static void TV_Upstream_FreePackets( upstream_t *upstream )
 */
 static void TV_Upstream_ReadDemoMessage( upstream_t *upstream, int timeBias )
 {
-	static uint8_t msgbuf[MAX_MSGLEN];
-	static msg_t demomsg;
-	bool init = true;
+	uint8_t msgbuf[MAX_MSGLEN];
+	msg_t demomsg;
 	int read;
 
 	if( !upstream->demo.filehandle )
@@ -450,11 +444,7 @@ static void TV_Upstream_ReadDemoMessage( upstream_t *upstream, int timeBias )
 		return;
 	}
 
-	if( init )
-	{
-		MSG_Init( &demomsg, msgbuf, sizeof( msgbuf ) );
-		init = false;
-	}
+	MSG_Init( &demomsg, msgbuf, sizeof( msgbuf ) );
 
 	read = SNAP_ReadDemoMessage( upstream->demo.filehandle, &demomsg );
 	if( read == -1 )
@@ -609,7 +599,7 @@ void TV_Upstream_Error( upstream_t *upstream, const char *format, ... )
 	va_end( argptr );
 
 	TV_Upstream_Disconnect( upstream, "%s", msg );
-	longjmp( upstream_abortframe, -1 );
+	longjmp( upstream->abortframe, -1 );
 }
 
 /*
@@ -798,7 +788,7 @@ void TV_Upstream_UpdateReliableCommandsToServer( upstream_t *upstream, msg_t *ms
 */
 void TV_Upstream_Run( upstream_t *upstream, int msec )
 {
-	if( setjmp( upstream_abortframe ) )  // disconnect while running
+	if( setjmp( upstream->abortframe ) )  // disconnect while running
 		return;
 
 	if( upstream->state > CA_DISCONNECTED )
@@ -835,8 +825,7 @@ void TV_Upstream_Run( upstream_t *upstream, int msec )
 		TV_Upstream_FreePackets( upstream );
 	}
 
-	if( upstream->relay.state == CA_UNINITIALIZED )
-		TV_Upstream_Shutdown( upstream, "Relay was shutdown" );
+	// upstreams without a relay are shutdown by TV_RelayThreads_Run
 }
 
 /*
@@ -94,6 +94,7 @@ struct upstream_s
 
 		bool playing;
 		int filehandle;
+		snap_demowriter_t *writer;  // writes the recorded messages on a separate thread
 		int filelen;
 		char *filename, *tempname;
 		bool random;
@@ -106,6 +107,9 @@ struct upstream_s
 
 	char *audiotrack;
 
+	// for jumping over upstream handling when it's disconnected
+	jmp_buf abortframe;
+
 	// relays
 	relay_t	relay;
 };
@@ -177,7 +177,12 @@ void TV_Upstream_WriteDemoMessage( upstream_t *upstream, msg_t *msg )
 	}
 
 	// the first eight bytes are just packet sequencing stuff
-	SNAP_RecordDemoMessage( upstream->demo.filehandle, msg, 8 );
+	if( !SNAP_WriteDemoMessage( upstream->demo.writer, msg, 8 ) )
+	{
+		Com_Printf( "Error: Failed to write the demo, stopping recording\n" );
+		TV_Upstream_StopDemoRecord( upstream, true, false );
+		upstream->demo.autorecording = false;
+	}
 }
 
 /*
@@ -248,6 +253,7 @@ void TV_Upstream_StartDemoRecord( upstream_t *upstream, const char *demoname, bo
 	if( !silent )
 		Com_Printf( "Recording demo: %s\n", upstream->demo.filename );
 
+	upstream->demo.writer = SNAP_CreateDemoWriter( upstream->demo.filehandle );
 	upstream->demo.recording = true;
 	upstream->demo.localtime = 0;
 	upstream->demo.basetime = upstream->demo.duration = 0;
@@ -273,7 +279,12 @@ void TV_Upstream_StopDemoRecord( upstream_t *upstream, bool silent, bool cancel
 		return;
 	}
 
-	// finish up
+	// finish up, an incomplete demo is not worth keeping
+	if( !SNAP_DestroyDemoWriter( &upstream->demo.writer ) && !cancel )
+	{
+		Com_Printf( "Error: Demo recording is incomplete, discarding it\n" );
+		cancel = true;
+	}
 	SNAP_StopDemoRecording( upstream->demo.filehandle );
 
 	FS_FCloseFile( upstream->demo.filehandle );
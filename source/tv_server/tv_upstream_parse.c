@@ -26,13 +26,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "tv_upstream_svcmd.h"
 #include "tv_upstream_demos.h"
 #include "tv_downstream_clcmd.h"
+#include "tv_relay_threads.h"
 
 /*
 * TV_Upstream_ParseFrame
 */
 static void TV_Upstream_ParseFrame( upstream_t *upstream, msg_t *msg )
 {
-	static snapshot_t snap;
+	static ATTRIBUTE_TLS snapshot_t snap;
 
 	SNAP_SkipFrame( msg, &snap );
 
@@ -187,9 +188,9 @@ void TV_Upstream_ParseServerMessage( upstream_t *upstream, msg_t *msg )
 		case svc_serverdata:
 			if( upstream->state == CA_HANDSHAKE )
 			{
-				Cbuf_Execute(); // make sure any stuffed commands are done
+				TV_RelayThreads_ExecuteCommandBuffer(); // make sure any stuffed commands are done
 
-				FS_Rescan();	// FIXME?
+				TV_RelayThreads_Rescan(); // pick up paks added since the last connect
 
 				TV_Upstream_ParseServerData( upstream, msg );
 			}
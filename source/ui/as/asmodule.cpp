@@ -6,6 +6,8 @@
 #include "as/asui_local.h"
 
 #include <list>
+#include <map>
+#include <vector>
 
 #define UI_AS_MODULE "UI_AS_MODULE"
 
@@ -135,6 +137,14 @@ class ASModule : public ASInterface
 	struct angelwrap_api_s *as_api;
 	asIObjectType *stringObjectType;
 
+	// script sections are kept until the module is built, so that the
+	// compiled module can be looked up in the bytecode cache first
+	typedef std::pair<std::string, std::string> ScriptSection;
+	typedef std::vector<ScriptSection> ScriptSectionList;
+	typedef std::map<asIScriptModule *, ScriptSectionList> PendingScriptsMap;
+
+	PendingScriptsMap pendingScripts;
+
 // private class, its ok to have everything as public :)
 public:
 	ASModule()
@@ -180,6 +190,8 @@ public:
 	{
 		//module = 0;
 
+		pendingScripts.clear();
+
 		if( as_api && engine != NULL )
 			as_api->asReleaseEngine( engine );
 
@@ -245,20 +257,70 @@ public:
 		if( !module ) {
 			return false;
 		}
-		return module->Build() >= 0;
+
+		PendingScriptsMap::iterator it = pendingScripts.find( module );
+		if( it == pendingScripts.end() ) {
+			return module->Build() >= 0;
+		}
+
+		ScriptSectionList sectionList;
+		sectionList.swap( it->second );
+		pendingScripts.erase( it );
+
+		unsigned int numSections = sectionList.size();
+		std::vector<const char *> names( numSections ), sections( numSections );
+		for( unsigned int i = 0; i < numSections; i++ ) {
+			names[i] = sectionList[i].first.c_str();
+			sections[i] = sectionList[i].second.c_str();
+		}
+
+		unsigned int loadTime = trap::Milliseconds();
+
+		// the module name is the document URL
+		std::string cacheName( "cache/ui/" );
+		cacheName += module->GetName();
+		cacheName += ".asb";
+		std::replace( cacheName.begin(), cacheName.end(), ':', '_' );
+
+		uint64_t cacheKey = as_api->asByteCodeKey( engine, numSections, 
+			numSections ? &names[0] : NULL, numSections ? &sections[0] : NULL );
+
+		if( as_api->asLoadByteCode( module, cacheName.c_str(), cacheKey ) ) {
+			if( UI_Main::Get()->debugOn() ) {
+				Com_Printf( "ASModule::finishBuilding: loaded cached %s in %u ms\n", module->GetName(), trap::Milliseconds() - loadTime );
+			}
+			return true;
+		}
+
+		for( unsigned int i = 0; i < numSections; i++ ) {
+			if( module->AddScriptSection( names[i], sections[i] ) < 0 ) {
+				return false;
+			}
+		}
+
+		if( module->Build() < 0 ) {
+			return false;
+		}
+
+		as_api->asSaveByteCode( module, cacheName.c_str(), cacheKey );
+
+		if( UI_Main::Get()->debugOn() ) {
+			Com_Printf( "ASModule::finishBuilding: compiled %s in %u ms\n", module->GetName(), trap::Milliseconds() - loadTime );
+		}
+		return true;
 	}
 
 	virtual bool addScript( asIScriptModule *module, const char *name, const char *code )
 	{
-		// TODO: precache SaveByteCode/LoadByteCode
-		// (this can be done on a global .rml level too)
 		// TODO: figure out if name can be NULL, or otherwise create
 		// temp name from NULL argument to differentiate <script> tags
 		// without source
 		if( !module )
 			return false;
 
-		return module->AddScriptSection( name, code ) >= 0;
+		// sections are added to the module in finishBuilding, unless it's found in the bytecode cache
+		pendingScripts[module].push_back( ScriptSection( name ? name : "", code ) );
+		return true;
 	}
 
 	virtual bool addFunction( asIScriptModule *module, const char *name, const char *code, asIScriptFunction **outFunction )
@@ -267,8 +329,6 @@ public:
 		return module ? (module->CompileFunction( name, code, 0, asCOMP_ADD_TO_MODULE, outFunction ) >= 0) : false;
 	}
 
-	// TODO: disk/mem-cache fully compiled set (use Binary*Stream)
-
 	// testing, dumpapi, note that path has to end with '/'
 	virtual void dumpAPI( const char *path )
 	{
@@ -423,6 +483,7 @@ public:
 	virtual void buildReset( asIScriptModule *module )
 	{
 		if( engine && module ) {
+			pendingScripts.erase( module );
 			module->Discard();
 		}
 		garbageCollectFullCycle();
@@ -48,6 +48,7 @@ public:
 
 	// adds a script either to module, or the following.
 	// If no name is provided, script_XXX is used
+	// Scripts are compiled or loaded from the bytecode cache in finishBuilding
 	virtual bool addScript( asIScriptModule *module, const char *name, const char *code ) = 0;
 
 	// adds a function to module, despite if finishBuilding has been called
@@ -75,13 +76,6 @@ public:
 
 	// creates a new dictionary object, which can be natively passed on to scripts
 	virtual CScriptDictionaryInterface *createDictionary( void ) = 0;
-
-	// caching, TODO!
-	// void *getBytecode(size_t &size);
-	// void setByteCode(void *bytecode, size_t size);
-
-	// void saveBytecode(const char *filename);
-	// void loadBytecode(const char *filename);
 };
 
 ASInterface * GetASModule( WSWUI::UI_Main *main );
@@ -766,10 +766,12 @@ void UI_Main::refreshScreen( unsigned int time, int clientState, int serverState
 	// TODO: handle the intervalled functions in AS somehow,
 	// taking care that they are not called when menu is hidden.
 	// i may need to make the interface public..
+	trap::Prof_Begin( "ui_script" );
 	BindFrame( asmodule );
 
 	// run incremental garbage collection
 	asmodule->garbageCollectOneStep();
+	trap::Prof_End();
 
 	for( i = 0; i < UI_NUM_CONTEXTS; i++ ) {
 		UI_Navigation &navigation = navigations[i];
@@ -326,6 +326,14 @@ namespace trap
 			return UI_IMPORT.Microseconds ();
 		}
 
+		inline void Prof_Begin( const char *name ) {
+			UI_IMPORT.Prof_Begin( name );
+		}
+
+		inline void Prof_End( void ) {
+			UI_IMPORT.Prof_End();
+		}
+
 		inline int FS_FOpenFile( const char *filename, int *filenum, int mode ) {
 			return UI_IMPORT.FS_FOpenFile( filename, filenum, mode );
 		}
@@ -21,7 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef __UI_PUBLIC_H__
 #define __UI_PUBLIC_H__
 
-#define	UI_API_VERSION	    65
+#define	UI_API_VERSION	    66
 
 typedef size_t (*ui_async_stream_read_cb_t)(const void *buf, size_t numb, float percentage, 
 	int status, const char *contentType, void *privatep);
@@ -157,6 +157,8 @@ typedef struct
 	void ( *GetConfigString )( int i, char *str, int size );
 	unsigned int ( *Milliseconds )( void );
 	uint64_t ( *Microseconds )( void );
+	void ( *Prof_Begin )( const char *name );
+	void ( *Prof_End )( void );
 
 	// files will be memory mapped read only
 	// the returned buffer may be part of a larger pak file,
@@ -29,6 +29,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 // TODO: add in_mouse?
 cvar_t *in_grabinconsole;
 
+extern cvar_t *vid_fullscreen;
+
 static bool focus = false;
 static bool minimized = false;
 
@@ -588,7 +590,7 @@ static void HandleEvents( void )
 			}
 			if( focus )
 			{
-				if ( Cvar_Value( "vid_fullscreen" ) ) {
+				if ( vid_fullscreen->integer ) {
 					XIconifyWindow( x11display.dpy, x11display.win, x11display.scr );
 				}
 				uninstall_grabs_keyboard();
@@ -754,7 +756,7 @@ void IN_Frame( void )
 	HandleEvents();
 
 	if( focus ) {
-		if( !Cvar_Value( "vid_fullscreen" ) && ( ( cls.key_dest == key_console ) && !in_grabinconsole->integer ) )
+		if( !vid_fullscreen->integer && ( ( cls.key_dest == key_console ) && !in_grabinconsole->integer ) )
 		{
 			m_active = false;
 		}